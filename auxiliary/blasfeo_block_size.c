@@ -0,0 +1,507 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2019 by Gianluca Frison.                                                          *
+* Developed at IMTEK (University of Freiburg) under the supervision of Moritz Diehl.              *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+
+// explicit memory allocation for the autotuning, allowed also with NO_INTERNAL_MALLOC
+#define BLASFEO_EXPLICIT_MALLOC
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#include <blasfeo_target.h>
+#include <blasfeo_block_size.h>
+#include <blasfeo_common.h>
+#include <blasfeo_stdlib.h>
+#include <blasfeo_memory.h>
+#if defined(EXT_DEP)
+#include <blasfeo_timing.h>
+#endif
+#if defined(BLAS_API)
+#include <blasfeo_d_blas_api.h>
+#else
+#include <blasfeo_d_aux.h>
+#include <blasfeo_d_blasfeo_api.h>
+#endif
+
+#if defined(TARGET_X64_INTEL_SKYLAKE_X) | defined(TARGET_X64_INTEL_HASWELL) | defined(TARGET_X64_INTEL_SANDY_BRIDGE) | defined(TARGET_X64_INTEL_CORE) | defined(TARGET_X64_AMD_BULLDOZER)
+#if defined(__GNUC__) || defined(__clang__)
+#include <cpuid.h>
+#define BLASFEO_CPUID_CACHE
+#endif
+#endif
+
+
+
+/*
+* Runtime cache sizes and double precision gemm cache blocking.
+* The target defaults in blasfeo_block_size.h are tuned for the cache sizes listed there:
+* at the first call the cache sizes of the processor are detected (sysfs on linux, else cpuid),
+* and KC, NC and MC are rescaled to keep the same occupancy of L1, L2 and LLC respectively.
+*/
+
+
+
+// the blocking is tied to the L1, L2 and LLC sizes in blasfeo_block_size.h; targets without them are not rescaled
+#if defined(L2_CACHE_SIZE)
+#define D_NC_SCALE 1
+#else
+#define D_NC_SCALE 0
+#define L2_CACHE_SIZE (8*L1_CACHE_SIZE)
+#endif
+#if defined(LLC_CACHE_SIZE)
+#define D_MC_SCALE 1
+#else
+#define D_MC_SCALE 0
+#define LLC_CACHE_SIZE (4*L2_CACHE_SIZE)
+#endif
+
+
+
+// the cache sizes and the blocking are shared by all threads: they are published with atomic
+// stores, so that a thread running a routine never sees a partially updated blocking
+#if defined(__GNUC__) || defined(__clang__)
+#define ATOMIC_LOAD(ptr) __atomic_load_n(ptr, __ATOMIC_ACQUIRE)
+#define ATOMIC_STORE(ptr, val) __atomic_store_n(ptr, val, __ATOMIC_RELEASE)
+#else
+#define ATOMIC_LOAD(ptr) (*(ptr))
+#define ATOMIC_STORE(ptr, val) (*(ptr) = (val))
+#endif
+
+static int cache_init = 0;
+static size_t l1_size = L1_CACHE_SIZE;
+static size_t l2_size = L2_CACHE_SIZE;
+static size_t llc_size = LLC_CACHE_SIZE;
+
+// kc, nc and mc packed in one word (21 bits each), 0 until the first use
+#define BLOCKING_BITS 21
+#define BLOCKING_MAX ((1<<BLOCKING_BITS)-1)
+static unsigned long long d_blocking = 0;
+
+
+
+#if defined(EXT_DEP) & defined(__linux__)
+// read the data caches of cpu0 from sysfs; return 0 if not available
+static int cache_size_sysfs(size_t *l1, size_t *l2, size_t *llc)
+	{
+	char path[128];
+	char type[32];
+	char unit;
+	int idx, level, size, found;
+	FILE *file;
+	found = 0;
+	for(idx=0; idx<16; idx++)
+		{
+		snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu0/cache/index%d/level", idx);
+		file = fopen(path, "r");
+		if(file==NULL)
+			break;
+		if(fscanf(file, "%d", &level)!=1)
+			level = 0;
+		fclose(file);
+		snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu0/cache/index%d/type", idx);
+		file = fopen(path, "r");
+		if(file==NULL)
+			continue;
+		if(fscanf(file, "%31s", type)!=1)
+			type[0] = 0;
+		fclose(file);
+		// skip instruction caches
+		if(type[0]=='I')
+			continue;
+		snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu0/cache/index%d/size", idx);
+		file = fopen(path, "r");
+		if(file==NULL)
+			continue;
+		unit = 0;
+		if(fscanf(file, "%d%c", &size, &unit)<1)
+			size = 0;
+		fclose(file);
+		if(size<=0)
+			continue;
+		if(unit=='K')
+			size *= 1024;
+		else if(unit=='M')
+			size *= 1024*1024;
+		if(level==1)
+			*l1 = size;
+		else if(level==2)
+			*l2 = size;
+		// last level
+		if(level>=2 & (size_t) size>*llc)
+			*llc = size;
+		found |= level==1;
+		}
+	return found;
+	}
+#endif
+
+
+
+#if defined(BLASFEO_CPUID_CACHE)
+// read the data caches from the deterministic cache parameters cpuid leaf (4 on Intel, 0x8000001D on AMD); return 0 if not available
+static int cache_size_cpuid(size_t *l1, size_t *l2, size_t *llc)
+	{
+	unsigned int reg_eax, reg_ebx, reg_ecx, reg_edx;
+	unsigned int leaf, type, level, idx;
+	size_t size;
+	int found = 0;
+	if(__get_cpuid(0, &reg_eax, &reg_ebx, &reg_ecx, &reg_edx)==0)
+		return 0;
+	// "AuthenticAMD"
+	if(reg_ebx==0x68747541)
+		leaf = 0x8000001D;
+	else if(reg_eax>=4)
+		leaf = 4;
+	else
+		return 0;
+	if(leaf==0x8000001D && __get_cpuid_max(0x80000000, NULL)<leaf)
+		return 0;
+	for(idx=0; idx<16; idx++)
+		{
+		__cpuid_count(leaf, idx, reg_eax, reg_ebx, reg_ecx, reg_edx);
+		type = reg_eax & 0x1f;
+		// no more caches
+		if(type==0)
+			break;
+		// skip instruction caches
+		if(type==2)
+			continue;
+		level = (reg_eax >> 5) & 0x7;
+		// ways * partitions * line size * sets
+		size = (size_t) (((reg_ebx >> 22) & 0x3ff) + 1) * (((reg_ebx >> 12) & 0x3ff) + 1) * ((reg_ebx & 0xfff) + 1) * (reg_ecx + 1);
+		if(level==1)
+			*l1 = size;
+		else if(level==2)
+			*l2 = size;
+		if(level>=2 & size>*llc)
+			*llc = size;
+		found |= level==1;
+		}
+	return found;
+	}
+#endif
+
+
+
+static void cache_size_detect()
+	{
+	if(ATOMIC_LOAD(&cache_init))
+		return;
+	size_t l1 = 0;
+	size_t l2 = 0;
+	size_t llc = 0;
+	int found = 0;
+#if defined(EXT_DEP) & defined(__linux__)
+	found = cache_size_sysfs(&l1, &l2, &llc);
+#endif
+#if defined(BLASFEO_CPUID_CACHE)
+	if(!found)
+		{
+		l1 = 0;
+		l2 = 0;
+		llc = 0;
+		found = cache_size_cpuid(&l1, &l2, &llc);
+		}
+#endif
+	if(found)
+		{
+		ATOMIC_STORE(&l1_size, l1);
+		if(l2>0)
+			ATOMIC_STORE(&l2_size, l2);
+		if(llc>0)
+			ATOMIC_STORE(&llc_size, llc);
+		}
+	ATOMIC_STORE(&cache_init, 1);
+	}
+
+
+
+size_t blasfeo_l1_cache_size()
+	{
+	cache_size_detect();
+	return ATOMIC_LOAD(&l1_size);
+	}
+
+
+
+size_t blasfeo_l2_cache_size()
+	{
+	cache_size_detect();
+	return ATOMIC_LOAD(&l2_size);
+	}
+
+
+
+size_t blasfeo_llc_cache_size()
+	{
+	cache_size_detect();
+	return ATOMIC_LOAD(&llc_size);
+	}
+
+
+
+// round x down to a multiple of q, and clip it to [lo, hi]
+static int round_clip(double x, int q, int lo, int hi)
+	{
+	int y = ((int) x) / q * q;
+	y = y<lo ? lo : y;
+	y = y>hi ? hi : y;
+	return y;
+	}
+
+
+
+static void d_blocking_model(int *kc, int *nc, int *mc)
+	{
+	cache_size_detect();
+	// KC sizes the micro-panels streamed from L1
+	*kc = round_clip((double) D_KC * l1_size / L1_CACHE_SIZE, 8, D_KC/2, 2*D_KC);
+	// the nc x kc packed block of B stays in L2
+	*nc = D_NC;
+	if(D_NC_SCALE)
+		*nc = round_clip((double) D_NC * D_KC / *kc * l2_size / L2_CACHE_SIZE, D_PS, D_PS, 4*D_NC);
+	// the mc x kc packed block of A stays in LLC
+	*mc = D_MC;
+	if(D_MC_SCALE)
+		*mc = round_clip((double) D_MC * D_KC / *kc * llc_size / LLC_CACHE_SIZE, D_M_KERNEL, D_M_KERNEL, 4*D_MC);
+	}
+
+
+
+void blasfeo_set_d_blocking(int kc, int nc, int mc)
+	{
+	int kc0, nc0, mc0;
+	d_blocking_model(&kc0, &nc0, &mc0);
+	kc = kc>0 ? kc : kc0;
+	nc = nc>0 ? nc : nc0;
+	mc = mc>0 ? mc : mc0;
+	kc = kc<BLOCKING_MAX ? kc : BLOCKING_MAX;
+	nc = nc<BLOCKING_MAX ? nc : BLOCKING_MAX;
+	mc = mc<BLOCKING_MAX ? mc : BLOCKING_MAX;
+	// the required packing buffer size grows before the larger blocking is visible
+	blasfeo_memsize_buffer_reserve(kc, nc, mc);
+	ATOMIC_STORE(&d_blocking, (unsigned long long) kc | (unsigned long long) nc<<BLOCKING_BITS | (unsigned long long) mc<<2*BLOCKING_BITS);
+	}
+
+
+
+void blasfeo_d_blocking(int *kc, int *nc, int *mc)
+	{
+	unsigned long long blocking = ATOMIC_LOAD(&d_blocking);
+	if(blocking==0)
+		{
+		blasfeo_set_d_blocking(0, 0, 0);
+		blocking = ATOMIC_LOAD(&d_blocking);
+		}
+	*kc = blocking & BLOCKING_MAX;
+	*nc = blocking>>BLOCKING_BITS & BLOCKING_MAX;
+	*mc = blocking>>2*BLOCKING_BITS & BLOCKING_MAX;
+	}
+
+
+
+int blasfeo_d_kc()
+	{
+	int kc, nc, mc;
+	blasfeo_d_blocking(&kc, &nc, &mc);
+	return kc;
+	}
+
+
+
+int blasfeo_d_nc()
+	{
+	int kc, nc, mc;
+	blasfeo_d_blocking(&kc, &nc, &mc);
+	return nc;
+	}
+
+
+
+int blasfeo_d_mc()
+	{
+	int kc, nc, mc;
+	blasfeo_d_blocking(&kc, &nc, &mc);
+	return mc;
+	}
+
+
+
+#if defined(EXT_DEP) & defined(EXT_DEP_MALLOC) & defined(LA_HIGH_PERFORMANCE) & ( defined(BLAS_API) | defined(MF_COLMAJ) )
+
+// matrix size of the timed gemm: large enough to run the cache blocking algorithm
+#define AUTOTUNE_N 1536
+
+
+
+static double autotune_time(int kc, int nc, int mc, double *A, double *B, double *C)
+	{
+	blasfeo_timer timer;
+	double time, time_min;
+	int rep;
+	int n = AUTOTUNE_N;
+	double alpha = 1.0;
+	double beta = 0.0;
+#if defined(BLAS_API)
+	char c_n = 'n';
+#else
+	struct blasfeo_dmat sA, sB, sC;
+	blasfeo_create_dmat(n, n, &sA, A);
+	blasfeo_create_dmat(n, n, &sB, B);
+	blasfeo_create_dmat(n, n, &sC, C);
+#endif
+	blasfeo_set_d_blocking(kc, nc, mc);
+	time_min = 1e30;
+	for(rep=0; rep<2; rep++)
+		{
+		blasfeo_tic(&timer);
+#if defined(BLAS_API)
+		blasfeo_blas_dgemm(&c_n, &c_n, &n, &n, &n, &alpha, A, &n, B, &n, &beta, C, &n);
+#else
+		blasfeo_dgemm_nn(n, n, n, alpha, &sA, 0, 0, &sB, 0, 0, beta, &sC, 0, 0, &sC, 0, 0);
+#endif
+		time = blasfeo_toc(&timer);
+		time_min = time<time_min ? time : time_min;
+		}
+	return time_min;
+	}
+
+
+
+int blasfeo_autotune_d_blocking(char *file_name)
+	{
+	int kc, nc, mc, kc0, nc0, mc0, ii, jj;
+	unsigned long l1, l2, llc;
+	double time, time_best;
+	FILE *file;
+
+	cache_size_detect();
+
+	// reuse a previous result on the same cache topology
+	if(file_name!=NULL)
+		{
+		file = fopen(file_name, "r");
+		if(file!=NULL)
+			{
+			ii = fscanf(file, "%lu %lu %lu %d %d %d", &l1, &l2, &llc, &kc, &nc, &mc);
+			fclose(file);
+			if(ii==6 & l1==l1_size & l2==l2_size & llc==llc_size & kc>0 & nc>0 & mc>0)
+				{
+				blasfeo_set_d_blocking(kc, nc, mc);
+				return 1;
+				}
+			}
+		}
+
+	int n = AUTOTUNE_N;
+	size_t size = (size_t) n*n*sizeof(double);
+	double *A, *B, *C;
+	blasfeo_malloc_align((void **) &A, size);
+	blasfeo_malloc_align((void **) &B, size);
+	blasfeo_malloc_align((void **) &C, size);
+	for(ii=0; ii<n*n; ii++)
+		{
+		A[ii] = 1.0 / (1 + ii%31);
+		B[ii] = 1.0 / (1 + ii%37);
+		C[ii] = 0.0;
+		}
+
+	// candidates around the cache model: first KC and NC, then MC
+	d_blocking_model(&kc0, &nc0, &mc0);
+	int kc_list[3] = {round_clip(0.75*kc0, 8, 8, 4*D_KC), kc0, round_clip(1.25*kc0, 8, 8, 4*D_KC)};
+	int nc_fact[3] = {2, 4, 6}; // quarters of the model NC at the same KC
+	int mc_fact[3] = {2, 4, 6}; // quarters of the model MC at the same KC
+	int nc_best = nc0;
+	int kc_best = kc0;
+	int mc_best = mc0;
+	time_best = autotune_time(kc0, nc0, mc0, A, B, C);
+	for(ii=0; ii<3; ii++)
+		{
+		kc = kc_list[ii];
+		for(jj=0; jj<3; jj++)
+			{
+			nc = round_clip((double) nc_fact[jj] * nc0 * kc0 / kc / 4, D_PS, D_PS, 8*D_NC);
+			mc = round_clip((double) mc0 * kc0 / kc, D_M_KERNEL, D_M_KERNEL, 8*D_MC);
+			time = autotune_time(kc, nc, mc, A, B, C);
+			if(time<time_best)
+				{
+				time_best = time;
+				kc_best = kc;
+				nc_best = nc;
+				mc_best = mc;
+				}
+			}
+		}
+	mc0 = mc_best;
+	for(jj=0; jj<3; jj++)
+		{
+		if(mc_fact[jj]==4)
+			continue;
+		mc = round_clip((double) mc_fact[jj] * mc0 / 4, D_M_KERNEL, D_M_KERNEL, 8*D_MC);
+		time = autotune_time(kc_best, nc_best, mc, A, B, C);
+		if(time<time_best)
+			{
+			time_best = time;
+			mc_best = mc;
+			}
+		}
+
+	blasfeo_free_align(A);
+	blasfeo_free_align(B);
+	blasfeo_free_align(C);
+
+	blasfeo_set_d_blocking(kc_best, nc_best, mc_best);
+
+	if(file_name!=NULL)
+		{
+		file = fopen(file_name, "w");
+		if(file!=NULL)
+			{
+			fprintf(file, "%lu %lu %lu %d %d %d\n", (unsigned long) l1_size, (unsigned long) l2_size, (unsigned long) llc_size, kc_best, nc_best, mc_best);
+			fclose(file);
+			}
+		}
+
+	return 1;
+	}
+
+#else
+
+int blasfeo_autotune_d_blocking(char *file_name)
+	{
+	return 0;
+	}
+
+#endif
@@ -36,7 +36,9 @@
 #include <blasfeo_processor_features.h>
 #include <blasfeo_target.h>
 
-#if defined(TARGET_X64_INTEL_HASWELL) \
+#if defined(TARGET_X64_INTEL_SKYLAKE_X) \
+    || defined(TARGET_X64_AMD_ZEN5) \
+    || defined(TARGET_X64_INTEL_HASWELL) \
     || defined(TARGET_X64_INTEL_SANDY_BRIDGE) \
     || defined(TARGET_X64_INTEL_CORE) \
     || defined(TARGET_X64_AMD_BULLDOZER) \
@@ -48,6 +50,16 @@
 #ifndef bit_AVX2
 #define bit_AVX2 (1 << 5)
 #endif
+#ifndef bit_AVX512F
+#define bit_AVX512F (1 << 16)
+#endif
+#ifndef bit_OSXSAVE
+#define bit_OSXSAVE (1 << 27)
+#endif
+#ifndef bit_F16C
+#define bit_F16C (1 << 29)
+#endif
+#define BLASFEO_X64_CPU
 #endif
 #endif
 
@@ -56,6 +68,8 @@
 #define BLASFEO_PROCESSOR_FEATURE_AVX2 0x0002    /// AVX2 instruction set
 #define BLASFEO_PROCESSOR_FEATURE_FMA  0x0004    /// FMA instruction set
 #define BLASFEO_PROCESSOR_FEATURE_SSE3 0x0008    /// SSE3 instruction set
+#define BLASFEO_PROCESSOR_FEATURE_AVX512F 0x0010 /// AVX-512 foundation instruction set
+#define BLASFEO_PROCESSOR_FEATURE_F16C 0x0020    /// half-precision conversion instructions
 
 // ARM CPU features
 #define BLASFEO_PROCESSOR_FEATURE_VFPv3  0x0100  /// VFPv3 instruction set
@@ -102,6 +116,27 @@ void blasfeo_processor_feature_string( int features, char* featureString )
         featureString[idx++] = '3';
     }
 
+    if( features & BLASFEO_PROCESSOR_FEATURE_AVX512F )
+    {
+        featureString[idx++] = ' ';
+        featureString[idx++] = 'A';
+        featureString[idx++] = 'V';
+        featureString[idx++] = 'X';
+        featureString[idx++] = '5';
+        featureString[idx++] = '1';
+        featureString[idx++] = '2';
+        featureString[idx++] = 'F';
+    }
+
+    if( features & BLASFEO_PROCESSOR_FEATURE_F16C )
+    {
+        featureString[idx++] = ' ';
+        featureString[idx++] = 'F';
+        featureString[idx++] = '1';
+        featureString[idx++] = '6';
+        featureString[idx++] = 'C';
+    }
+
     featureString[idx] = 0;
 }
 
@@ -133,14 +168,55 @@ void blasfeo_processor_library_features( int* features )
     #if defined(TARGET_NEED_FEATURE_SSE3)
     *features |= BLASFEO_PROCESSOR_FEATURE_SSE3;
     #endif
+
+    #if defined(TARGET_NEED_FEATURE_AVX512F)
+    *features |= BLASFEO_PROCESSOR_FEATURE_AVX512F;
+    #endif
+
+    #if defined(TARGET_NEED_FEATURE_F16C)
+    *features |= BLASFEO_PROCESSOR_FEATURE_F16C;
+    #endif
+}
+
+
+#if defined(BLASFEO_X64_CPU)
+// Check that the OS enabled the opmask and zmm registers state (XCR0 bits 1, 2, 5, 6, 7)
+static int blasfeo_processor_os_zmm_state( void )
+{
+    unsigned int reg_eax, reg_ebx, reg_ecx, reg_edx;
+
+    if( __get_cpuid( 1, &reg_eax, &reg_ebx, &reg_ecx, &reg_edx )==0 )
+        return 0;
+    if( !( reg_ecx & bit_OSXSAVE ) )
+        return 0;
+
+    __asm__ volatile( "xgetbv\n" : "=a" (reg_eax), "=d" (reg_edx) : "c" (0) );
+
+    return ( reg_eax & 0xe6 ) == 0xe6;
 }
 
 
+// Check that the processor vendor is AMD
+static int blasfeo_processor_is_amd( void )
+{
+    unsigned int reg_eax, reg_ebx, reg_ecx, reg_edx;
+
+    if( __get_cpuid( 0, &reg_eax, &reg_ebx, &reg_ecx, &reg_edx )==0 )
+        return 0;
+
+    // "AuthenticAMD"
+    return reg_ebx==0x68747541 && reg_edx==0x69746e65 && reg_ecx==0x444d4163;
+}
+#endif
+
+
 int blasfeo_processor_cpu_features( int* features )
 {
     *features = 0;
 
-#if defined(TARGET_X64_INTEL_HASWELL) \
+#if defined(TARGET_X64_INTEL_SKYLAKE_X) \
+    || defined(TARGET_X64_AMD_ZEN5) \
+    || defined(TARGET_X64_INTEL_HASWELL) \
     || defined(TARGET_X64_INTEL_SANDY_BRIDGE) \
     || defined(TARGET_X64_INTEL_CORE) \
     || defined(TARGET_X64_AMD_BULLDOZER) \
@@ -169,6 +245,10 @@ int blasfeo_processor_cpu_features( int* features )
     if( reg_ecx & bit_SSE3 )
         *features |= BLASFEO_PROCESSOR_FEATURE_SSE3;
 
+    // F16C is in the ECX register of leaf 1
+    if( reg_ecx & bit_F16C )
+        *features |= BLASFEO_PROCESSOR_FEATURE_F16C;
+
     // Test for extended features next in leaf 7 (subleaf 0)
 #if __GNUC__>5
     valid = __get_cpuid_count( 7, 0, &reg_eax, &reg_ebx, &reg_ecx, &reg_edx );
@@ -187,6 +267,10 @@ int blasfeo_processor_cpu_features( int* features )
     // AVX2 is in the EBX register of leaf 7
     if( reg_ebx & bit_AVX2 )
         *features |= BLASFEO_PROCESSOR_FEATURE_AVX2;
+
+    // AVX-512F is in the EBX register of leaf 7, and it is usable only if the OS saves the zmm state
+    if( ( reg_ebx & bit_AVX512F ) && blasfeo_processor_os_zmm_state() )
+        *features |= BLASFEO_PROCESSOR_FEATURE_AVX512F;
 #endif  // #if defined(__GNUC__) || defined(__clang__)
 
 #endif // x86 processors
@@ -197,3 +281,27 @@ int blasfeo_processor_cpu_features( int* features )
 
     return ( libraryFeatures == ( *features & libraryFeatures ) ) ? 1 : 0;
 }
+
+
+int blasfeo_processor_isa( void )
+{
+    int features = 0;
+    blasfeo_processor_cpu_features( &features );
+
+    if( features & BLASFEO_PROCESSOR_FEATURE_AVX512F )
+    {
+#if defined(BLASFEO_X64_CPU)
+        if( blasfeo_processor_is_amd() )
+            return BLASFEO_PROCESSOR_ISA_ZEN5;
+#endif
+        return BLASFEO_PROCESSOR_ISA_SKYLAKE_X;
+    }
+
+    if( ( features & BLASFEO_PROCESSOR_FEATURE_AVX2 ) && ( features & BLASFEO_PROCESSOR_FEATURE_FMA ) )
+        return BLASFEO_PROCESSOR_ISA_HASWELL;
+
+    if( features & BLASFEO_PROCESSOR_FEATURE_AVX )
+        return BLASFEO_PROCESSOR_ISA_SANDY_BRIDGE;
+
+    return BLASFEO_PROCESSOR_ISA_CORE;
+}
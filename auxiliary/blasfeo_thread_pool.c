@@ -0,0 +1,649 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2020 by Gianluca Frison.                                                          *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+
+#if defined(MULTITHREAD) & defined(__linux__)
+// needed for pthread_setaffinity_np
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#endif
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#if defined(MULTITHREAD)
+#include <stdint.h>
+#include <pthread.h>
+#include <unistd.h>
+#if defined(__linux__)
+#include <sched.h>
+#endif
+#if defined(__x86_64__) | defined(__i386__)
+#include <immintrin.h>
+#endif
+#endif
+
+#include <blasfeo_thread_pool.h>
+#include <blasfeo_memory.h>
+
+
+
+#if defined(MULTITHREAD)
+
+
+
+struct blasfeo_thread_pool_worker
+	{
+	pthread_t thread;
+	int tid;
+	unsigned int generation; // last job generation seen by the worker
+	int cpu; // cpu the worker is pinned to, or -1
+	int buffer; // 1 if the worker owns a packing buffer
+	void *work; // workspace of the worker (see blasfeo_set_thread_pool_workspace), or NULL
+	};
+
+
+
+// number of threads used by the multi-threaded routines
+static int num_threads_set = 1;
+
+// worker threads, with tid=1,...,num_workers (tid=0 is the calling thread)
+static struct blasfeo_thread_pool_worker workers[BLASFEO_MAX_NUM_THREADS];
+static int num_workers = 0;
+
+// job description, protected by pool_mutex
+static pthread_mutex_t pool_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t pool_cond_work = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t pool_cond_done = PTHREAD_COND_INITIALIZER;
+static void (*pool_fun)(int, int, void *) = NULL;
+static void *pool_arg = NULL;
+static int pool_num_threads = 0;
+static unsigned int pool_generation = 0;
+static int pool_pending = 0;
+
+// held by the thread currently owning the pool
+static pthread_mutex_t pool_busy = PTHREAD_MUTEX_INITIALIZER;
+
+// set in the threads executing a job
+static __thread int in_parallel = 0;
+
+// cpus the worker threads are pinned to (worker tid is pinned to pool_cpus[tid%pool_num_cpus]); no pinning if pool_num_cpus==0
+static int pool_cpus[BLASFEO_MAX_NUM_THREADS];
+static int pool_num_cpus = 0;
+
+// number of polling iterations before a waiting thread goes to sleep on a condition variable
+static int pool_spin = BLASFEO_THREAD_POOL_SPIN;
+
+// number of online cpus; spinning is disabled if the threads would be more than the cpus
+static int pool_num_online_cpus = 1;
+
+// workspaces of the workers 1,...,pool_ws_num, each of pool_ws_size bytes and for dimensions up to pool_ws_n_max
+static char *pool_ws = NULL;
+static size_t pool_ws_size = 0;
+static int pool_ws_n_max = 0;
+static int pool_ws_num = 0;
+
+// failures of the internal allocations in the workers during the current job, forwarded to the calling thread
+static int pool_ws_error = 0;
+
+// environment variables are read once, before the first use of the pool
+static pthread_once_t pool_env_once = PTHREAD_ONCE_INIT;
+
+
+
+static inline void blasfeo_thread_pool_cpu_relax()
+	{
+#if defined(__x86_64__) | defined(__i386__)
+	_mm_pause();
+#elif defined(__aarch64__) | defined(__arm__)
+	__asm__ __volatile__("yield");
+#endif
+	}
+
+
+
+// pin the calling thread to cpu; return 1 on success
+static int blasfeo_thread_pool_pin(int cpu)
+	{
+#if defined(__linux__)
+	cpu_set_t set;
+	if(cpu<0 | cpu>=CPU_SETSIZE)
+		return 0;
+	CPU_ZERO(&set);
+	CPU_SET(cpu, &set);
+	return pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &set)==0;
+#else
+	return 0;
+#endif
+	}
+
+
+
+// parse a cpu list as "0,2,4-7" into cpus; return the number of cpus, or 0 on error
+static int blasfeo_thread_pool_parse_cpus(const char *str, int *cpus)
+	{
+	int n = 0;
+	long c0, c1, ii;
+	char *end;
+	while(*str!='\0')
+		{
+		c0 = strtol(str, &end, 10);
+		if(end==str | c0<0)
+			return 0;
+		c1 = c0;
+		str = end;
+		if(*str=='-')
+			{
+			str++;
+			c1 = strtol(str, &end, 10);
+			if(end==str | c1<c0)
+				return 0;
+			str = end;
+			}
+		for(ii=c0; ii<=c1 & n<BLASFEO_MAX_NUM_THREADS; ii++)
+			{
+			cpus[n] = ii;
+			n++;
+			}
+		if(*str==',')
+			str++;
+		else if(*str!='\0')
+			return 0;
+		}
+	return n;
+	}
+
+
+
+// the cpus the calling thread can run on, in increasing order; return their number
+static int blasfeo_thread_pool_compact_cpus(int *cpus)
+	{
+	int n = 0;
+#if defined(__linux__)
+	cpu_set_t set;
+	int ii;
+	if(pthread_getaffinity_np(pthread_self(), sizeof(cpu_set_t), &set)!=0)
+		return 0;
+	for(ii=0; ii<CPU_SETSIZE & n<BLASFEO_MAX_NUM_THREADS; ii++)
+		{
+		if(CPU_ISSET(ii, &set))
+			{
+			cpus[n] = ii;
+			n++;
+			}
+		}
+#endif
+	return n;
+	}
+
+
+
+static void blasfeo_thread_pool_read_env()
+	{
+	char *env;
+	int n;
+
+	n = sysconf(_SC_NPROCESSORS_ONLN);
+	pool_num_online_cpus = n<1 ? 1 : n;
+
+	env = getenv("BLASFEO_NUM_THREADS");
+	if(env!=NULL)
+		{
+		n = atoi(env);
+		if(n<1)
+			n = 1;
+		if(n>BLASFEO_MAX_NUM_THREADS)
+			n = BLASFEO_MAX_NUM_THREADS;
+		num_threads_set = n;
+		}
+
+	env = getenv("BLASFEO_THREAD_AFFINITY");
+	if(env!=NULL)
+		{
+		if(strcmp(env, "compact")==0)
+			pool_num_cpus = blasfeo_thread_pool_compact_cpus(pool_cpus);
+		else
+			pool_num_cpus = blasfeo_thread_pool_parse_cpus(env, pool_cpus);
+		}
+
+	env = getenv("BLASFEO_THREAD_SPIN");
+	if(env!=NULL)
+		{
+		n = atoi(env);
+		pool_spin = n<0 ? 0 : n;
+		}
+
+	return;
+	}
+
+
+
+static void *blasfeo_thread_pool_worker_main(void *ptr)
+	{
+	struct blasfeo_thread_pool_worker *worker = ptr;
+	int tid = worker->tid;
+	void (*fun)(int, int, void *);
+	void *arg;
+	int nt;
+	int ii, spin;
+
+	in_parallel = 1;
+
+	// pin before allocating the packing buffer, so that its pages are first touched on the local NUMA node
+	if(worker->cpu>=0)
+		{
+		blasfeo_thread_pool_pin(worker->cpu);
+		}
+	if(worker->work!=NULL)
+		{
+		blasfeo_init_workspace(pool_ws_n_max, worker->work);
+		}
+	else if(worker->buffer)
+		{
+		blasfeo_init();
+		}
+
+	pthread_mutex_lock(&pool_mutex);
+	while(1)
+		{
+		spin = num_workers<pool_num_online_cpus ? __atomic_load_n(&pool_spin, __ATOMIC_RELAXED) : 0;
+		if(worker->generation==pool_generation & tid<=num_workers & spin>0)
+			{
+			// spin for a while before sleeping, to avoid the wake-up latency between consecutive jobs
+			pthread_mutex_unlock(&pool_mutex);
+			for(ii=0; ii<spin; ii++)
+				{
+				if(__atomic_load_n(&pool_generation, __ATOMIC_ACQUIRE)!=worker->generation | __atomic_load_n(&num_workers, __ATOMIC_ACQUIRE)<tid)
+					break;
+				blasfeo_thread_pool_cpu_relax();
+				}
+			pthread_mutex_lock(&pool_mutex);
+			}
+		while(worker->generation==pool_generation & tid<=num_workers)
+			{
+			pthread_cond_wait(&pool_cond_work, &pool_mutex);
+			}
+		if(tid>num_workers)
+			{
+			break;
+			}
+		worker->generation = pool_generation;
+		if(tid<pool_num_threads)
+			{
+			fun = pool_fun;
+			arg = pool_arg;
+			nt = pool_num_threads;
+			pthread_mutex_unlock(&pool_mutex);
+
+			fun(tid, nt, arg);
+
+			pthread_mutex_lock(&pool_mutex);
+			pool_ws_error |= blasfeo_get_workspace_error();
+			__atomic_store_n(&pool_pending, pool_pending-1, __ATOMIC_RELEASE);
+			if(pool_pending==0)
+				{
+				pthread_cond_signal(&pool_cond_done);
+				}
+			}
+		}
+	pthread_mutex_unlock(&pool_mutex);
+
+	if(worker->work!=NULL | worker->buffer)
+		{
+		blasfeo_quit();
+		}
+
+	return NULL;
+	}
+
+
+
+// resize the pool to nw worker threads; to be called holding pool_busy
+static void blasfeo_thread_pool_resize(int nw)
+	{
+	int ii;
+	int nw0 = num_workers;
+	if(nw>nw0)
+		{
+		pthread_mutex_lock(&pool_mutex);
+		for(ii=nw0+1; ii<=nw; ii++)
+			{
+			workers[ii].tid = ii;
+			workers[ii].generation = pool_generation;
+			workers[ii].cpu = pool_num_cpus>0 ? pool_cpus[ii%pool_num_cpus] : -1;
+			workers[ii].work = ii<=pool_ws_num ? pool_ws+(ii-1)*pool_ws_size : NULL;
+#if defined(NO_INTERNAL_MALLOC)
+			// no hidden allocation: without a workspace, the workers allocate nothing
+			workers[ii].buffer = 0;
+#else
+			// workers get their own packing buffer if the thread creating them uses one
+			workers[ii].buffer = blasfeo_is_init();
+#endif
+			}
+		__atomic_store_n(&num_workers, nw, __ATOMIC_RELEASE);
+		pthread_mutex_unlock(&pool_mutex);
+		for(ii=nw0+1; ii<=nw; ii++)
+			{
+			if(pthread_create(&workers[ii].thread, NULL, blasfeo_thread_pool_worker_main, &workers[ii])!=0)
+				{
+				// run with the threads created so far
+				pthread_mutex_lock(&pool_mutex);
+				__atomic_store_n(&num_workers, ii-1, __ATOMIC_RELEASE);
+				pthread_mutex_unlock(&pool_mutex);
+				break;
+				}
+			}
+		}
+	else if(nw<nw0)
+		{
+		pthread_mutex_lock(&pool_mutex);
+		__atomic_store_n(&num_workers, nw, __ATOMIC_RELEASE);
+		pthread_cond_broadcast(&pool_cond_work);
+		pthread_mutex_unlock(&pool_mutex);
+		for(ii=nw+1; ii<=nw0; ii++)
+			{
+			pthread_join(workers[ii].thread, NULL);
+			}
+		}
+	return;
+	}
+
+
+
+void blasfeo_set_num_threads(int num_threads)
+	{
+	if(num_threads<1)
+		num_threads = 1;
+	if(num_threads>BLASFEO_MAX_NUM_THREADS)
+		num_threads = BLASFEO_MAX_NUM_THREADS;
+	pthread_once(&pool_env_once, blasfeo_thread_pool_read_env);
+	pthread_mutex_lock(&pool_busy);
+	num_threads_set = num_threads;
+	// workers are created on demand, but released as soon as they are not needed any longer
+	if(num_workers>num_threads-1)
+		{
+		blasfeo_thread_pool_resize(num_threads-1);
+		}
+	pthread_mutex_unlock(&pool_busy);
+	return;
+	}
+
+
+
+int blasfeo_get_num_threads()
+	{
+	pthread_once(&pool_env_once, blasfeo_thread_pool_read_env);
+	return num_threads_set;
+	}
+
+
+
+int blasfeo_set_thread_affinity(int num_cpus, int *cpus)
+	{
+	int ii;
+	int ret = 1;
+	if(num_cpus<0)
+		num_cpus = 0;
+	if(num_cpus>BLASFEO_MAX_NUM_THREADS)
+		num_cpus = BLASFEO_MAX_NUM_THREADS;
+#if !defined(__linux__)
+	ret = num_cpus==0;
+	num_cpus = 0;
+#endif
+	pthread_once(&pool_env_once, blasfeo_thread_pool_read_env);
+	pthread_mutex_lock(&pool_busy);
+	for(ii=0; ii<num_cpus; ii++)
+		{
+		if(cpus[ii]<0)
+			{
+			num_cpus = 0;
+			ret = 0;
+			break;
+			}
+		pool_cpus[ii] = cpus[ii];
+		}
+	pool_num_cpus = num_cpus;
+	// release the workers, so that they are re-created (and their buffers re-allocated) on the new cpus
+	blasfeo_thread_pool_resize(0);
+	pthread_mutex_unlock(&pool_busy);
+	return ret;
+	}
+
+
+
+void blasfeo_set_thread_pool_spin(int spin)
+	{
+	pthread_once(&pool_env_once, blasfeo_thread_pool_read_env);
+	__atomic_store_n(&pool_spin, spin<0 ? 0 : spin, __ATOMIC_RELAXED);
+	return;
+	}
+
+
+
+// the workspace of each worker starts at a page boundary, so that it can be first touched on the worker NUMA node
+static size_t blasfeo_thread_pool_ws_size(int n_max)
+	{
+	return (blasfeo_memsize_workspace(n_max)+4096-1)/4096*4096;
+	}
+
+
+
+size_t blasfeo_memsize_thread_pool_workspace(int num_threads, int n_max)
+	{
+	if(num_threads>BLASFEO_MAX_NUM_THREADS)
+		num_threads = BLASFEO_MAX_NUM_THREADS;
+	if(num_threads<=1)
+		return 0;
+	return (num_threads-1)*blasfeo_thread_pool_ws_size(n_max) + 4096;
+	}
+
+
+
+void blasfeo_set_thread_pool_workspace(int num_threads, int n_max, void *work)
+	{
+	if(num_threads>BLASFEO_MAX_NUM_THREADS)
+		num_threads = BLASFEO_MAX_NUM_THREADS;
+	pthread_once(&pool_env_once, blasfeo_thread_pool_read_env);
+	pthread_mutex_lock(&pool_busy);
+	if(work==NULL | num_threads<=1)
+		{
+		pool_ws = NULL;
+		pool_ws_size = 0;
+		pool_ws_n_max = 0;
+		pool_ws_num = 0;
+		}
+	else
+		{
+		pool_ws = (char *) (((uintptr_t) work + 4096 - 1) / 4096 * 4096);
+		pool_ws_size = blasfeo_thread_pool_ws_size(n_max);
+		pool_ws_n_max = n_max;
+		pool_ws_num = num_threads-1;
+		}
+	// release the workers, so that they are re-created with the new workspaces
+	blasfeo_thread_pool_resize(0);
+	pthread_mutex_unlock(&pool_busy);
+	return;
+	}
+
+
+
+int blasfeo_thread_pool_in_parallel()
+	{
+	return in_parallel;
+	}
+
+
+
+void blasfeo_thread_pool_run(int num_threads, void (*fun)(int, int, void *), void *arg)
+	{
+	int tid;
+	int ii, spin;
+
+	if(num_threads>BLASFEO_MAX_NUM_THREADS)
+		num_threads = BLASFEO_MAX_NUM_THREADS;
+
+	if(num_threads>1 & in_parallel==0)
+		{
+		pthread_once(&pool_env_once, blasfeo_thread_pool_read_env);
+		if(pthread_mutex_trylock(&pool_busy)==0)
+			{
+			if(num_workers<num_threads-1)
+				{
+				blasfeo_thread_pool_resize(num_threads-1);
+				}
+			if(num_workers>=num_threads-1)
+				{
+				pthread_mutex_lock(&pool_mutex);
+				pool_fun = fun;
+				pool_arg = arg;
+				pool_num_threads = num_threads;
+				pool_pending = num_threads-1;
+				__atomic_store_n(&pool_generation, pool_generation+1, __ATOMIC_RELEASE);
+				pthread_cond_broadcast(&pool_cond_work);
+				pthread_mutex_unlock(&pool_mutex);
+
+				in_parallel = 1;
+				fun(0, num_threads, arg);
+				in_parallel = 0;
+
+				// spin for a while before sleeping, as the workers are likely about to finish
+				spin = num_threads<=pool_num_online_cpus ? __atomic_load_n(&pool_spin, __ATOMIC_RELAXED) : 0;
+				for(ii=0; ii<spin; ii++)
+					{
+					if(__atomic_load_n(&pool_pending, __ATOMIC_ACQUIRE)==0)
+						break;
+					blasfeo_thread_pool_cpu_relax();
+					}
+
+				pthread_mutex_lock(&pool_mutex);
+				while(pool_pending>0)
+					{
+					pthread_cond_wait(&pool_cond_done, &pool_mutex);
+					}
+				if(pool_ws_error!=0)
+					{
+					blasfeo_set_workspace_error(pool_ws_error);
+					pool_ws_error = 0;
+					}
+				pthread_mutex_unlock(&pool_mutex);
+
+				pthread_mutex_unlock(&pool_busy);
+				return;
+				}
+			pthread_mutex_unlock(&pool_busy);
+			}
+		}
+
+	// serial fallback
+	int in_parallel0 = in_parallel;
+	in_parallel = 1;
+	for(tid=0; tid<num_threads; tid++)
+		{
+		fun(tid, num_threads, arg);
+		}
+	in_parallel = in_parallel0;
+	return;
+	}
+
+
+
+#else // MULTITHREAD
+
+
+
+void blasfeo_set_num_threads(int num_threads)
+	{
+	return;
+	}
+
+
+
+int blasfeo_get_num_threads()
+	{
+	return 1;
+	}
+
+
+
+int blasfeo_set_thread_affinity(int num_cpus, int *cpus)
+	{
+	return num_cpus<=0;
+	}
+
+
+
+void blasfeo_set_thread_pool_spin(int spin)
+	{
+	return;
+	}
+
+
+
+size_t blasfeo_memsize_thread_pool_workspace(int num_threads, int n_max)
+	{
+	return 0;
+	}
+
+
+
+void blasfeo_set_thread_pool_workspace(int num_threads, int n_max, void *work)
+	{
+	return;
+	}
+
+
+
+int blasfeo_thread_pool_in_parallel()
+	{
+	return 0;
+	}
+
+
+
+void blasfeo_thread_pool_run(int num_threads, void (*fun)(int, int, void *), void *arg)
+	{
+	int tid;
+	for(tid=0; tid<num_threads; tid++)
+		{
+		fun(tid, num_threads, arg);
+		}
+	return;
+	}
+
+
+
+#endif // MULTITHREAD
@@ -53,7 +53,7 @@ size_t blasfeo_pm_memsize_dmat(int ps, int m, int n)
 	int pm = (m+ps-1)/ps*ps;
 	int cn = (n+nc-1)/nc*nc;
 	int tmp = m<n ? (m+al-1)/al*al : (n+al-1)/al*al; // al(min(m,n)) // XXX max ???
-	size_t memsize = (pm*cn+tmp)*sizeof(double);
+	size_t memsize = ((size_t) pm*cn+tmp)*sizeof(double);
 	return memsize;
 	}
 
@@ -74,11 +74,11 @@ void blasfeo_pm_create_dmat(int ps, int m, int n, struct blasfeo_pm_dmat *sA, vo
 	sA->cn = cn;
 	double *ptr = (double *) memory;
 	sA->pA = ptr;
-	ptr += pm*cn;
+	ptr += (size_t) pm*cn;
 	int tmp = m<n ? (m+al-1)/al*al : (n+al-1)/al*al; // al(min(m,n)) // XXX max ???
 	sA->dA = ptr;
 	ptr += tmp;
-	sA->memsize = (pm*cn+tmp)*sizeof(double);
+	sA->memsize = ((size_t) pm*cn+tmp)*sizeof(double);
 	sA->use_dA = 0; // invalidate stored inverse diagonal
 	return;
 	}
@@ -111,7 +111,7 @@ void blasfeo_pm_print_dmat(int m, int n, struct blasfeo_pm_dmat *sA, int ai, int
 size_t blasfeo_cm_memsize_dmat(int m, int n)
 	{
 	int tmp = m<n ? m : n; // al(min(m,n)) // XXX max ???
-	size_t memsize = (m*n+tmp)*sizeof(double);
+	size_t memsize = ((size_t) m*n+tmp)*sizeof(double);
 	return memsize;
 	}
 
@@ -126,15 +126,72 @@ void blasfeo_cm_create_dmat(int m, int n, struct blasfeo_pm_dmat *sA, void *memo
 	sA->use_dA = 0; // invalidate stored inverse diagonal
 	double *ptr = (double *) memory;
 	sA->pA = ptr;
-	ptr += m*n;
+	ptr += (size_t) m*n;
 	int tmp = m<n ? m : n; // al(min(m,n)) // XXX max ???
 	sA->dA = ptr;
 	ptr += tmp;
 	sA->use_dA = 0;
-	sA->memsize = (m*n+tmp)*sizeof(double);
+	sA->memsize = ((size_t) m*n+tmp)*sizeof(double);
 	return;
 	}
 
 
 
+/* Compact batch */
+
+// return the memory size (in bytes) needed for a cb_dmat
+size_t blasfeo_cb_memsize_dmat(int m, int n)
+	{
+	size_t memsize = (size_t) BLASFEO_CB_D_NL*m*n*sizeof(double);
+	memsize = (memsize+63)/64*64; // make multiple of typical cache line size
+	return memsize;
+	}
+
+
+
+// create a compact batch matrix structure for BLASFEO_CB_D_NL matrices of size m*n by using memory passed by a pointer
+void blasfeo_cb_create_dmat(int m, int n, struct blasfeo_cb_dmat *sA, void *memory)
+	{
+	sA->mem = memory;
+	sA->m = m;
+	sA->n = n;
+	sA->nl = BLASFEO_CB_D_NL;
+	sA->pA = (double *) memory;
+	sA->memsize = blasfeo_cb_memsize_dmat(m, n);
+	return;
+	}
+
+
+
+// copy the column-major matrix A into the lane ll of sB
+void blasfeo_cb_pack_dmat(int m, int n, double *A, int lda, struct blasfeo_cb_dmat *sB, int bi, int bj, int ll)
+	{
+	int ii, jj;
+	for(jj=0; jj<n; jj++)
+		{
+		for(ii=0; ii<m; ii++)
+			{
+			BLASFEO_CB_DMATEL(sB, ll, bi+ii, bj+jj) = A[ii+lda*jj];
+			}
+		}
+	return;
+	}
+
+
+
+// copy the lane ll of sA into the column-major matrix B
+void blasfeo_cb_unpack_dmat(int m, int n, struct blasfeo_cb_dmat *sA, int ai, int aj, double *B, int ldb, int ll)
+	{
+	int ii, jj;
+	for(jj=0; jj<n; jj++)
+		{
+		for(ii=0; ii<m; ii++)
+			{
+			B[ii+ldb*jj] = BLASFEO_CB_DMATEL(sA, ll, ai+ii, aj+jj);
+			}
+		}
+	return;
+	}
+
+
 
@@ -1524,7 +1524,7 @@ size_t blasfeo_memsize_dmat(int m, int n)
 	int pm = (m+bs-1)/bs*bs;
 	int cn = (n+nc-1)/nc*nc;
 	int tmp = m<n ? (m+al-1)/al*al : (n+al-1)/al*al; // al(min(m,n)) // XXX max ???
-	size_t memsize = (pm*cn+tmp)*sizeof(double);
+	size_t memsize = ((size_t) pm*cn+tmp)*sizeof(double);
 	memsize = (memsize + CACHE_LINE_SIZE - 1) / CACHE_LINE_SIZE * CACHE_LINE_SIZE;
 	return memsize;
 	}
@@ -1559,11 +1559,11 @@ void blasfeo_create_dmat(int m, int n, struct blasfeo_dmat *sA, void *memory)
 	sA->cn = cn;
 	double *ptr = (double *) memory;
 	sA->pA = ptr;
-	ptr += pm*cn;
+	ptr += (size_t) pm*cn;
 	int tmp = m<n ? (m+al-1)/al*al : (n+al-1)/al*al; // al(min(m,n)) // XXX max ???
 	sA->dA = ptr;
 	ptr += tmp;
-	size_t memsize = (pm*cn+tmp)*sizeof(double);
+	size_t memsize = ((size_t) pm*cn+tmp)*sizeof(double);
 	sA->memsize = (memsize + CACHE_LINE_SIZE - 1) / CACHE_LINE_SIZE * CACHE_LINE_SIZE;
 	sA->use_dA = 0; // invalidate stored inverse diagonal
 	return;
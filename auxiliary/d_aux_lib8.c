@@ -69,7 +69,7 @@ size_t blasfeo_memsize_dmat(int m, int n)
 	int pm = (m+bs-1)/bs*bs;
 	int cn = (n+nc-1)/nc*nc;
 	int tmp = m<n ? (m+al-1)/al*al : (n+al-1)/al*al; // al(min(m,n)) // XXX max ???
-	size_t memsize = (pm*cn+tmp)*sizeof(double);
+	size_t memsize = ((size_t) pm*cn+tmp)*sizeof(double);
 	memsize = (memsize + CACHE_LINE_SIZE - 1) / CACHE_LINE_SIZE * CACHE_LINE_SIZE;
 	return memsize;
 	}
@@ -104,11 +104,11 @@ void blasfeo_create_dmat(int m, int n, struct blasfeo_dmat *sA, void *memory)
 	sA->cn = cn;
 	double *ptr = (double *) memory;
 	sA->pA = ptr;
-	ptr += pm*cn;
+	ptr += (size_t) pm*cn;
 	int tmp = m<n ? (m+al-1)/al*al : (n+al-1)/al*al; // al(min(m,n)) // XXX max ???
 	sA->dA = ptr;
 	ptr += tmp;
-	size_t memsize = (pm*cn+tmp)*sizeof(double);
+	size_t memsize = ((size_t) pm*cn+tmp)*sizeof(double);
 	sA->memsize = (memsize + CACHE_LINE_SIZE - 1) / CACHE_LINE_SIZE * CACHE_LINE_SIZE;
 	sA->use_dA = 0; // invalidate stored inverse diagonal
 	return;
@@ -1113,7 +1113,7 @@ void blasfeo_dtrtr_l(int m, struct blasfeo_dmat *sA, int ai, int aj, struct blas
 	double *pA = sA->pA + aj*ps + (ai-air)*sda;
 	double *pB = sB->pA + bj*ps + (bi-bir)*sdb;
 
-	int ii, mmax;
+	int ii, jj, mmax;
 
 	int offsetA = (air+ps-bir) & (ps-1);
 
@@ -1121,7 +1121,10 @@ void blasfeo_dtrtr_l(int m, struct blasfeo_dmat *sA, int ai, int aj, struct blas
 	if(bir!=0)
 		{
 		mmax = m<ps-bir ? m : ps-bir;
-		kernel_dpacp_l_tn_8_vs_lib8(m-mmax, air, pA, sda, pB+bir, mmax);
+		// the kernel stores to aligned panels only
+		for(ii=0; ii<mmax; ii++)
+			for(jj=ii; jj<m; jj++)
+				BLASFEO_DMATEL(sB, bi+ii, bj+jj) = BLASFEO_DMATEL(sA, ai+jj, aj+ii);
 		pA += mmax*ps;
 		if(air>=bir)
 			pA += ps*sda;
@@ -1130,7 +1133,7 @@ void blasfeo_dtrtr_l(int m, struct blasfeo_dmat *sA, int ai, int aj, struct blas
 		}
 	ii = 0;	
 	// main loop
-	for(; ii<m-7; ii+=8)
+	for(; ii<m-8; ii+=8)
 		{
 		kernel_dpacp_l_tn_8_lib8(m-ii-8, offsetA, pA+ii*sda+ii*ps, sda, pB+ii*sdb+ii*ps);
 		}
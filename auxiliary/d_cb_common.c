@@ -0,0 +1,405 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2019 by Gianluca Frison.                                                          *
+* Developed at IMTEK (University of Freiburg) under the supervision of Moritz Diehl.              *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+
+#include <blasfeo_common.h>
+#include <blasfeo_stdlib.h>
+#include <blasfeo_align.h>
+#include <blasfeo_d_aux.h>
+#include <blasfeo_d_blasfeo_api.h>
+#include <blasfeo_thread_pool.h>
+
+
+
+#if defined(RUNTIME_DISPATCH)
+
+
+
+#include <blasfeo_d_kernel.h>
+#include <blasfeo_processor_features.h>
+
+
+
+/*
+* The compact batch routines are compiled once for each kernel set (d_cb_<isa>.c),
+* with its instruction set flags, and the table matching the processor is selected
+* at the first call. The selection is published with a single atomic pointer store,
+* so concurrent first calls are race-free (they all select the same table).
+* Only the compact batch kernels are dispatched: the panel-major kernels are fixed
+* at build time by TARGET.
+*/
+
+struct cb_selection
+	{
+	const struct blasfeo_cb_dkernels *kernels;
+	int isa;
+	};
+
+static const struct cb_selection cb_selection_list[] =
+	{
+	{&blasfeo_cb_dkernels_core, BLASFEO_PROCESSOR_ISA_CORE},
+	{&blasfeo_cb_dkernels_sandy_bridge, BLASFEO_PROCESSOR_ISA_SANDY_BRIDGE},
+	{&blasfeo_cb_dkernels_haswell, BLASFEO_PROCESSOR_ISA_HASWELL},
+	{&blasfeo_cb_dkernels_skylake_x, BLASFEO_PROCESSOR_ISA_SKYLAKE_X},
+	{&blasfeo_cb_dkernels_skylake_x, BLASFEO_PROCESSOR_ISA_ZEN5}, // Zen5 uses the same AVX-512 kernels
+	};
+
+static const struct cb_selection *cb_selection = NULL;
+
+
+
+// kernel sets sharing the same instruction set have the same level
+static int cb_isa_level(int isa)
+	{
+	switch(isa)
+		{
+		case BLASFEO_PROCESSOR_ISA_ZEN5:
+			return BLASFEO_PROCESSOR_ISA_SKYLAKE_X;
+		case BLASFEO_PROCESSOR_ISA_SKYLAKE_X:
+		case BLASFEO_PROCESSOR_ISA_HASWELL:
+		case BLASFEO_PROCESSOR_ISA_SANDY_BRIDGE:
+		case BLASFEO_PROCESSOR_ISA_CORE:
+			return isa;
+		default:
+			return 0;
+		}
+	}
+
+
+
+int blasfeo_cb_set_isa(int isa)
+	{
+	int isa_cpu = blasfeo_processor_isa();
+	if(isa==0)
+		isa = isa_cpu;
+	int level = cb_isa_level(isa);
+	if(level==0 | level>cb_isa_level(isa_cpu))
+		return 0;
+	// the ISA values are 1-based indices in the selection list
+	__atomic_store_n(&cb_selection, &cb_selection_list[isa-1], __ATOMIC_RELEASE);
+	return 1;
+	}
+
+
+
+static const struct cb_selection *cb_get_selection()
+	{
+	const struct cb_selection *sel = __atomic_load_n(&cb_selection, __ATOMIC_ACQUIRE);
+	if(sel==NULL)
+		{
+		blasfeo_cb_set_isa(0);
+		sel = __atomic_load_n(&cb_selection, __ATOMIC_ACQUIRE);
+		}
+	return sel;
+	}
+
+
+
+int blasfeo_cb_get_isa()
+	{
+	return cb_get_selection()->isa;
+	}
+
+
+
+static const struct blasfeo_cb_dkernels *cb_get_kernels()
+	{
+	return cb_get_selection()->kernels;
+	}
+
+
+
+void blasfeo_cb_dgemm_nn(int m, int n, int k, double alpha, struct blasfeo_cb_dmat *sA, int ai, int aj, struct blasfeo_cb_dmat *sB, int bi, int bj, double beta, struct blasfeo_cb_dmat *sC, int ci, int cj, struct blasfeo_cb_dmat *sD, int di, int dj)
+	{
+	cb_get_kernels()->dgemm_nn(m, n, k, alpha, sA, ai, aj, sB, bi, bj, beta, sC, ci, cj, sD, di, dj);
+	}
+
+
+
+void blasfeo_cb_dgemm_nt(int m, int n, int k, double alpha, struct blasfeo_cb_dmat *sA, int ai, int aj, struct blasfeo_cb_dmat *sB, int bi, int bj, double beta, struct blasfeo_cb_dmat *sC, int ci, int cj, struct blasfeo_cb_dmat *sD, int di, int dj)
+	{
+	cb_get_kernels()->dgemm_nt(m, n, k, alpha, sA, ai, aj, sB, bi, bj, beta, sC, ci, cj, sD, di, dj);
+	}
+
+
+
+void blasfeo_cb_dtrsm_rltn(int m, int n, double alpha, struct blasfeo_cb_dmat *sA, int ai, int aj, struct blasfeo_cb_dmat *sB, int bi, int bj, struct blasfeo_cb_dmat *sD, int di, int dj)
+	{
+	cb_get_kernels()->dtrsm_rltn(m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj);
+	}
+
+
+
+void blasfeo_cb_dpotrf_l(int m, struct blasfeo_cb_dmat *sC, int ci, int cj, struct blasfeo_cb_dmat *sD, int di, int dj)
+	{
+	cb_get_kernels()->dpotrf_l(m, sC, ci, cj, sD, di, dj);
+	}
+
+
+
+void blasfeo_cb_dgetrf_rp(int m, int n, struct blasfeo_cb_dmat *sC, int ci, int cj, struct blasfeo_cb_dmat *sD, int di, int dj, int *ipiv)
+	{
+	cb_get_kernels()->dgetrf_rp(m, n, sC, ci, cj, sD, di, dj, ipiv);
+	}
+
+
+
+void blasfeo_cb_dpotrs_l(int m, int n, struct blasfeo_cb_dmat *sA, int ai, int aj, struct blasfeo_cb_dmat *sB, int bi, int bj, struct blasfeo_cb_dmat *sD, int di, int dj)
+	{
+	cb_get_kernels()->dpotrs_l(m, n, sA, ai, aj, sB, bi, bj, sD, di, dj);
+	}
+
+
+
+#else // RUNTIME_DISPATCH
+
+
+
+#if defined(TARGET_X64_INTEL_SKYLAKE_X) || defined(TARGET_X64_AMD_ZEN5) || defined(TARGET_X64_INTEL_HASWELL) || defined(TARGET_X64_INTEL_SANDY_BRIDGE)
+#include <immintrin.h>
+#endif
+
+#if defined(TARGET_X64_INTEL_SKYLAKE_X) || defined(TARGET_X64_AMD_ZEN5)
+#define CB_ISA_AVX512F
+#elif defined(TARGET_X64_INTEL_HASWELL)
+#define CB_ISA_AVX2
+#elif defined(TARGET_X64_INTEL_SANDY_BRIDGE)
+#define CB_ISA_AVX
+#endif
+
+#define CB_GEMM_NN blasfeo_cb_dgemm_nn
+#define CB_GEMM_NT blasfeo_cb_dgemm_nt
+#define CB_TRSM_RLTN blasfeo_cb_dtrsm_rltn
+#define CB_POTRF_L blasfeo_cb_dpotrf_l
+#define CB_GETRF_RP blasfeo_cb_dgetrf_rp
+#define CB_POTRS_L blasfeo_cb_dpotrs_l
+
+#include "x_cb_common.c"
+
+
+
+#endif // RUNTIME_DISPATCH
+
+
+
+/*
+* Batched solve of small positive definite systems: the systems are gathered in groups of
+* BLASFEO_CB_D_NL into compact batch matrices, factorized and solved one per SIMD lane, and
+* the groups are split over the threads set by blasfeo_set_num_threads.
+* The compact batch matrices of systems up to POSV_BATCH_M_STACK are on the stack, larger
+* ones are taken from the workspace.
+*/
+
+// minimum number of flops (per thread) to use more than one thread
+#define POSV_BATCH_MT_MIN_FLOPS (32*32*32)
+// maximum size of the systems interleaved in a stack buffer
+#define POSV_BATCH_M_STACK 16
+
+
+
+struct d_posv_batch_arg
+	{
+	int nb;
+	int m;
+	struct blasfeo_dmat **sA;
+	struct blasfeo_dvec **sb;
+	struct blasfeo_dvec **sx;
+	int ai;
+	int aj;
+	int bi;
+	int xi;
+	int *info;
+	};
+
+
+
+static void d_posv_batch_work(int tid, int nt, void *ptr)
+	{
+	const int nl = BLASFEO_CB_D_NL;
+
+	struct d_posv_batch_arg *arg = ptr;
+	int nb = arg->nb;
+	int m = arg->m;
+	int ai = arg->ai;
+	int aj = arg->aj;
+	int bi = arg->bi;
+	int xi = arg->xi;
+
+	int ng = (nb+nl-1)/nl;
+	int gg0 = tid*ng/nt;
+	int gg1 = (tid+1)*ng/nt;
+	if(gg1<=gg0)
+		return;
+
+	int *info = arg->info;
+
+	struct blasfeo_dmat *sA;
+	struct blasfeo_dvec *sb, *sx;
+	struct blasfeo_cb_dmat cA, cb;
+	int gg, ll, ii, jj, idx, nl_gg;
+	double d_jj;
+
+	ALIGNED( double mem_stack[BLASFEO_CB_D_NL*POSV_BATCH_M_STACK*(POSV_BATCH_M_STACK+1)+8], 64 );
+
+	size_t memsize_A = blasfeo_cb_memsize_dmat(m, m);
+	size_t memsize_b = blasfeo_cb_memsize_dmat(m, 1);
+	void *mem = NULL;
+	char *mem_align;
+	if(m<=POSV_BATCH_M_STACK)
+		{
+		mem_align = (char *) mem_stack;
+		}
+	else
+		{
+		blasfeo_ws_malloc(&mem, memsize_A+memsize_b+64);
+		if(mem==NULL)
+			{
+			// BLASFEO_WS_ERR_ALLOC is flagged, and the systems of this thread are reported as not solved
+			for(ii=gg0*nl; ii<gg1*nl & ii<nb; ii++)
+				info[ii] = -1;
+			return;
+			}
+		blasfeo_align_64_byte(mem, (void **) &mem_align);
+		}
+	blasfeo_cb_create_dmat(m, m, &cA, mem_align);
+	blasfeo_cb_create_dmat(m, 1, &cb, mem_align+memsize_A);
+
+	for(gg=gg0; gg<gg1; gg++)
+		{
+		idx = gg*nl;
+		nl_gg = nb-idx<nl ? nb-idx : nl;
+		// gather the lower triangular of A and b
+		for(ll=0; ll<nl_gg; ll++)
+			{
+			sA = arg->sA[idx+ll];
+			sb = arg->sb[idx+ll];
+			for(jj=0; jj<m; jj++)
+				{
+				for(ii=jj; ii<m; ii++)
+					{
+					BLASFEO_CB_DMATEL(&cA, ll, ii, jj) = BLASFEO_DMATEL(sA, ai+ii, aj+jj);
+					}
+				BLASFEO_CB_DMATEL(&cb, ll, jj, 0) = BLASFEO_DVECEL(sb, bi+jj);
+				}
+			}
+		// the unused lanes of the last group solve an identity system
+		for(; ll<nl; ll++)
+			{
+			for(jj=0; jj<m; jj++)
+				{
+				for(ii=jj; ii<m; ii++)
+					{
+					BLASFEO_CB_DMATEL(&cA, ll, ii, jj) = ii==jj ? 1.0 : 0.0;
+					}
+				BLASFEO_CB_DMATEL(&cb, ll, jj, 0) = 0.0;
+				}
+			}
+		blasfeo_cb_dpotrf_l(m, &cA, 0, 0, &cA, 0, 0);
+		blasfeo_cb_dpotrs_l(m, 1, &cA, 0, 0, &cb, 0, 0, &cb, 0, 0);
+		// the factorization of a lane stores a zero (or NaN) diagonal element at the first non-positive pivot
+		for(ll=0; ll<nl_gg; ll++)
+			{
+			info[idx+ll] = 0;
+			for(jj=0; jj<m; jj++)
+				{
+				d_jj = BLASFEO_CB_DMATEL(&cA, ll, jj, jj);
+				if(!(d_jj>0.0))
+					{
+					info[idx+ll] = jj+1;
+					break;
+					}
+				}
+			}
+		// scatter x of the positive definite systems
+		for(ll=0; ll<nl_gg; ll++)
+			{
+			if(info[idx+ll]!=0)
+				continue;
+			sx = arg->sx[idx+ll];
+			for(ii=0; ii<m; ii++)
+				{
+				BLASFEO_DVECEL(sx, xi+ii) = BLASFEO_CB_DMATEL(&cb, ll, ii, 0);
+				}
+			}
+		}
+
+	if(mem!=NULL)
+		blasfeo_ws_free(mem);
+	return;
+	}
+
+
+
+void blasfeo_dposv_l_batch(int nb, int m, struct blasfeo_dmat **sA, int ai, int aj, struct blasfeo_dvec **sb, int bi, struct blasfeo_dvec **sx, int xi, int *info)
+	{
+	if(nb<=0 | m<=0)
+		return;
+
+	struct d_posv_batch_arg arg;
+	arg.nb = nb;
+	arg.m = m;
+	arg.sA = sA;
+	arg.sb = sb;
+	arg.sx = sx;
+	arg.ai = ai;
+	arg.aj = aj;
+	arg.bi = bi;
+	arg.xi = xi;
+	arg.info = info;
+
+	int ng = (nb+BLASFEO_CB_D_NL-1)/BLASFEO_CB_D_NL;
+	int nt = blasfeo_get_num_threads();
+	if(nt>1 && !blasfeo_thread_pool_in_parallel())
+		{
+		// at least POSV_BATCH_MT_MIN_FLOPS per thread
+		double flops = (1.0/3.0*m*m*m + 2.0*m*m) * nb;
+		double nt_max = flops/POSV_BATCH_MT_MIN_FLOPS;
+		nt = nt_max<nt ? (int) nt_max : nt;
+		nt = nt<ng ? nt : ng;
+		}
+	else
+		{
+		nt = 1;
+		}
+	if(nt>1)
+		blasfeo_thread_pool_run(nt, d_posv_batch_work, &arg);
+	else
+		d_posv_batch_work(0, 1, &arg);
+	return;
+	}
@@ -33,6 +33,9 @@
 *                                                                                                 *
 **************************************************************************************************/
 
+// explicit memory allocation, allowed also with NO_INTERNAL_MALLOC
+#define BLASFEO_EXPLICIT_MALLOC
+
 #include <stdlib.h>
 #include <stdio.h>
 
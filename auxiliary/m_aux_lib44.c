@@ -38,6 +38,7 @@
 #include <math.h>
 
 #include "../include/blasfeo_common.h"
+#include "../include/blasfeo_m_aux.h"
 
 
 
@@ -76,21 +77,26 @@ void blasfeo_cvt_s2d_vec(int m, struct blasfeo_svec *vs, int vsi, struct blasfeo
 
 void blasfeo_cvt_d2s_mat(int m, int n, struct blasfeo_dmat *Md, int mid, int nid, struct blasfeo_smat *Ms, int mis, int nis)
 	{
-	if(mid!=0 | mis!=0)
-		{
-#ifdef EXT_DEP
-		printf("\nblasfeo_cvt_d2s_mat: feature not implmeneted yet: mid=%d, mis=%d\n\n", mid, mis);
-#endif	
-		exit(1);
-		}
 	const int psd = 4;
 	const int pss = 4;
+	int ii, jj, ll;
+	if(mid%psd!=0 | mis%pss!=0)
+		{
+		// rows not aligned to the panels: convert element-wise
+		for(jj=0; jj<n; jj++)
+			{
+			for(ii=0; ii<m; ii++)
+				{
+				BLASFEO_SMATEL(Ms, mis+ii, nis+jj) = (float) BLASFEO_DMATEL(Md, mid+ii, nid+jj);
+				}
+			}
+		return;
+		}
 	const int sdd = Md->cn;
-	double *D0 = Md->pA + nid*psd;
+	double *D0 = Md->pA + mid/psd*psd*sdd + nid*psd;
 	double *D1;
 	const int sds = Ms->cn;
-	float *S = Ms->pA + nis*pss;
-	int ii, jj, ll;
+	float *S = Ms->pA + mis/pss*pss*sds + nis*pss;
 	for(ii=0; ii<m-3; ii+=4)
 		{
 		D1 = D0 + psd*sdd;
@@ -121,10 +127,49 @@ void blasfeo_cvt_d2s_mat(int m, int n, struct blasfeo_dmat *Md, int mid, int nid
 
 void blasfeo_cvt_s2d_mat(int m, int n, struct blasfeo_smat *Ms, int mis, int nis, struct blasfeo_dmat *Md, int mid, int nid)
 	{
-#ifdef EXT_DEP
-	printf("\nblasfeo_cvt_s2d_mat: feature not implmeneted yet\n\n");
-#endif	
-	exit(1);
+	const int psd = 4;
+	const int pss = 4;
+	int ii, jj, ll;
+	if(mid%psd!=0 | mis%pss!=0)
+		{
+		// rows not aligned to the panels: convert element-wise
+		for(jj=0; jj<n; jj++)
+			{
+			for(ii=0; ii<m; ii++)
+				{
+				BLASFEO_DMATEL(Md, mid+ii, nid+jj) = (double) BLASFEO_SMATEL(Ms, mis+ii, nis+jj);
+				}
+			}
+		return;
+		}
+	const int sdd = Md->cn;
+	double *D0 = Md->pA + mid/psd*psd*sdd + nid*psd;
+	double *D1;
+	const int sds = Ms->cn;
+	float *S = Ms->pA + mis/pss*pss*sds + nis*pss;
+	for(ii=0; ii<m-3; ii+=4)
+		{
+		D1 = D0 + psd*sdd;
+		for(jj=0; jj<n; jj++)
+			{
+			D0[0+jj*psd] = (double) S[0+jj*pss];
+			D0[1+jj*psd] = (double) S[1+jj*pss];
+			D0[2+jj*psd] = (double) S[2+jj*pss];
+			D0[3+jj*psd] = (double) S[3+jj*pss];
+			}
+		D0 += 4*sdd;
+		S  += 4*sds;
+		}
+	if(m-ii>0)
+		{
+		for(jj=0; jj<n; jj++)
+			{
+			for(ll=0; ll<m-ii; ll++)
+				{
+				D0[ll+jj*psd] = (double) S[ll+jj*pss];
+				}
+			}
+		}
 	return;
 	}
 
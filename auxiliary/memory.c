@@ -41,32 +41,72 @@
 #include <blasfeo_block_size.h>
 #include <blasfeo_d_aux.h>
 #include <blasfeo_s_aux.h>
+#include <blasfeo_memory.h>
 
 
 
-static int initialized = 0;
+// the packing buffer is private to each thread, so that threads calling the
+// BLAS API routines concurrently never share it
+#if defined(_MSC_VER)
+#define BLASFEO_THREAD_LOCAL __declspec(thread)
+#elif defined(__GNUC__) || defined(__clang__)
+#define BLASFEO_THREAD_LOCAL __thread
+#else
+#define BLASFEO_THREAD_LOCAL
+#endif
+
+static BLASFEO_THREAD_LOCAL int initialized = 0;
+
+static BLASFEO_THREAD_LOCAL void *mem = NULL;
+
+// 1 if mem has been allocated by blasfeo_init, 0 if it is provided by the caller
+static BLASFEO_THREAD_LOCAL int mem_owned = 0;
+
+// size of mem, fixed by the cache blocking at the time of blasfeo_init
+static BLASFEO_THREAD_LOCAL size_t mem_size = 0;
 
-static void *mem = NULL;
+// workspace for the other internal allocations (stack allocator, set by blasfeo_init_workspace)
+static BLASFEO_THREAD_LOCAL char *ws_mem = NULL;
+static BLASFEO_THREAD_LOCAL char *ws_top = NULL;
+static BLASFEO_THREAD_LOCAL char *ws_end = NULL;
+// most recent block of the workspace stack, the only one that can be released
+static BLASFEO_THREAD_LOCAL char *ws_last = NULL;
+
+// failures of the internal allocations of the calling thread (BLASFEO_WS_ERR_* flags), cleared when read
+static BLASFEO_THREAD_LOCAL int ws_error = 0;
+
+// each workspace block is preceded by a header holding the previous block, and takes a multiple of 64 bytes
+#define WS_HEADER 64
+
+
+
+// size of the packing buffer needed by the largest cache blocking set so far (shared by all threads):
+// it only grows, and it is updated by blasfeo_set_d_blocking before the new blocking is visible
+static size_t mem_size_req = 0;
 
 
 
 int blasfeo_is_init()
 	{
-	return initialized;
+	// the buffer is not used if the cache blocking has been enlarged after blasfeo_init
+#if defined(__GNUC__) || defined(__clang__)
+	return initialized && mem_size>=__atomic_load_n(&mem_size_req, __ATOMIC_ACQUIRE);
+#else
+	return initialized && mem_size>=mem_size_req;
+#endif
 	}
 
 
 
-void blasfeo_init()
+static size_t memsize_buffer_blocking(int d_kc, int d_nc, int d_mc)
 	{
-#ifdef EXT_DEP_MALLOC
 	size_t tmp0, tmp1;
 	// compute max needed memory
 	#ifdef DP_ROUTINES
-	size_t size_A_double = blasfeo_pm_memsize_dmat(D_PS, D_MC, D_KC); 
-	size_t size_B_double = blasfeo_pm_memsize_dmat(D_PS, D_NC, D_KC); 
-	tmp0 = blasfeo_pm_memsize_dmat(D_PS, D_KC, D_KC); 
-	tmp1 = blasfeo_pm_memsize_dmat(D_PS, D_NC, D_NC); 
+	size_t size_A_double = blasfeo_pm_memsize_dmat(D_PS, d_mc, d_kc); 
+	size_t size_B_double = blasfeo_pm_memsize_dmat(D_PS, d_nc, d_kc); 
+	tmp0 = blasfeo_pm_memsize_dmat(D_PS, d_kc, d_kc); 
+	tmp1 = blasfeo_pm_memsize_dmat(D_PS, d_nc, d_nc); 
 	size_t size_T_double = tmp0>tmp1 ? tmp0 : tmp1;
 	size_A_double = (size_A_double + 4096 - 1) / 4096 * 4096;
 	size_B_double = (size_B_double + 4096 - 1) / 4096 * 4096;
@@ -91,10 +131,61 @@ void blasfeo_init()
 	size_t size = size_double>=size_single ? size_double : size_single;
 	// alignment
 	size += 2*4096;
+	return size;
+	}
+
+
+
+void blasfeo_memsize_buffer_reserve(int d_kc, int d_nc, int d_mc)
+	{
+	size_t size = memsize_buffer_blocking(d_kc, d_nc, d_mc);
+#if defined(__GNUC__) || defined(__clang__)
+	size_t size_old = __atomic_load_n(&mem_size_req, __ATOMIC_RELAXED);
+	while(size_old<size && !__atomic_compare_exchange_n(&mem_size_req, &size_old, size, 0, __ATOMIC_RELEASE, __ATOMIC_RELAXED))
+		;
+#else
+	if(mem_size_req<size)
+		mem_size_req = size;
+#endif
+	}
+
+
+
+size_t blasfeo_memsize_buffer()
+	{
+	int d_kc, d_nc, d_mc;
+	// make sure the cache blocking is set, so that mem_size_req covers it
+	blasfeo_d_blocking(&d_kc, &d_nc, &d_mc);
+#if defined(__GNUC__) || defined(__clang__)
+	return __atomic_load_n(&mem_size_req, __ATOMIC_ACQUIRE);
+#else
+	return mem_size_req;
+#endif
+	}
+
+
+
+void blasfeo_init()
+	{
+	if(initialized)
+		return;
+#ifdef EXT_DEP_MALLOC
+	size_t ii;
+	size_t size = blasfeo_memsize_buffer();
 //	printf("\nsize %d\n", size);
 	// call malloc
 	mem = malloc(size);
-	initialized = 1;
+	mem_owned = 1;
+	mem_size = size;
+	initialized = mem!=NULL;
+	// first touch the pages from the calling thread, so that they are placed on its NUMA node
+	if(initialized)
+		{
+		for(ii=0; ii<size; ii+=4096)
+			{
+			((char *) mem)[ii] = 0;
+			}
+		}
 #else
 	mem = NULL;
 	initialized = 0;
@@ -103,12 +194,195 @@ void blasfeo_init()
 
 
 
+void blasfeo_init_buffer(void *buffer)
+	{
+	blasfeo_quit();
+	mem = buffer;
+	mem_owned = 0;
+	mem_size = blasfeo_memsize_buffer();
+	initialized = mem!=NULL;
+	}
+
+
+
 void blasfeo_quit()
 	{
 #ifdef EXT_DEP_MALLOC
-	free(mem);
+	if(mem_owned)
+		free(mem);
 #endif
+	mem = NULL;
+	mem_owned = 0;
+	mem_size = 0;
 	initialized = 0;
+	ws_mem = NULL;
+	ws_top = NULL;
+	ws_end = NULL;
+	ws_last = NULL;
+	}
+
+
+
+// size of the internal allocations of the routines with all dimensions up to n_max, excluding the packing buffer;
+// with the packing buffer in the workspace the routines never use blasfeo_ws_malloc for their cache blocks, and
+// the live blocks are at most:
+// - two strided vectors of length n, held by the BLAS API wrappers (dgemv, dger, dsymv, dtrsm, ...) around the backend call;
+// - one block of the backend routine: a M_KERNEL x n panel and up to two packed n x n matrices (trsm, trmm, syrk,
+//   getrf, potrf, sytrf and the factorization updates);
+// - below it, one block of the callees (dpotrf -> dtrsm/dsyrk, dtrsm_lutn -> dgemm_tn, dsytrf -> dsyrk): a M_KERNEL x kc
+//   panel of the k-blocked gemm/syrk, a 12 x n panel of the panel-major gemm/syrk, or two nested 12 x n panels of the
+//   dgetrf pivot kernels
+static size_t blasfeo_memsize_workspace_stack(int n_max)
+	{
+	size_t n1 = (n_max+128-1)/128*128;
+	size_t size = 0;
+	size_t size_double = 0;
+	size_t size_single = 0;
+	size_t tmp;
+	#ifdef DP_ROUTINES
+	size_t size_nest_double;
+	size_double = blasfeo_pm_memsize_dmat(D_PS, D_M_KERNEL, n1) + 2*blasfeo_pm_memsize_dmat(D_PS, n1, n1) + 2*4096 + WS_HEADER;
+	size_nest_double = D_M_KERNEL*blasfeo_d_kc()*sizeof(double) + 64 + WS_HEADER;
+	tmp = blasfeo_pm_memsize_dmat(D_PS, 12, n1) + 64 + WS_HEADER;
+	size_nest_double = tmp>size_nest_double ? tmp : size_nest_double;
+	tmp = 2*(12*n1*sizeof(double) + 64 + WS_HEADER);
+	size_nest_double = tmp>size_nest_double ? tmp : size_nest_double;
+	size_double += size_nest_double;
+	#endif
+	#ifdef SP_ROUTINES
+	size_t size_nest_single;
+	size_single = blasfeo_pm_memsize_smat(S_PS, S_M_KERNEL, n1) + 2*blasfeo_pm_memsize_smat(S_PS, n1, n1) + 2*4096 + WS_HEADER;
+	size_nest_single = S_M_KERNEL*S_KC*sizeof(float) + 64 + WS_HEADER;
+	tmp = blasfeo_pm_memsize_smat(S_PS, 16, n1) + 64 + WS_HEADER;
+	size_nest_single = tmp>size_nest_single ? tmp : size_nest_single;
+	size_single += size_nest_single;
+	#endif
+	size += size_double>=size_single ? size_double : size_single;
+	// strided or diagonal vectors of the BLAS API routines
+	size += 2*(n1*sizeof(double) + 64 + WS_HEADER);
+	return size;
+	}
+
+
+
+size_t blasfeo_memsize_workspace(int n_max)
+	{
+	if(n_max<0)
+		n_max = 0;
+	return blasfeo_memsize_buffer() + blasfeo_memsize_workspace_stack(n_max);
+	}
+
+
+
+void blasfeo_init_workspace(int n_max, void *work)
+	{
+	if(n_max<0)
+		n_max = 0;
+	blasfeo_init_buffer(work);
+	if(work!=NULL)
+		{
+		ws_mem = (char *) work + blasfeo_memsize_buffer();
+		ws_top = ws_mem;
+		ws_end = ws_mem + blasfeo_memsize_workspace_stack(n_max);
+		ws_last = NULL;
+		}
+	}
+
+
+
+void blasfeo_workspace_push(int n_max, void *work, struct blasfeo_workspace_state *state)
+	{
+	state->mem = mem;
+	state->mem_owned = mem_owned;
+	state->mem_size = mem_size;
+	state->initialized = initialized;
+	state->ws_mem = ws_mem;
+	state->ws_top = ws_top;
+	state->ws_end = ws_end;
+	state->ws_last = ws_last;
+	// the previous buffer is kept, and released by blasfeo_workspace_pop if owned
+	mem_owned = 0;
+	blasfeo_init_workspace(n_max, work);
+	}
+
+
+
+void blasfeo_workspace_pop(struct blasfeo_workspace_state *state)
+	{
+	mem = state->mem;
+	mem_owned = state->mem_owned;
+	mem_size = state->mem_size;
+	initialized = state->initialized;
+	ws_mem = state->ws_mem;
+	ws_top = state->ws_top;
+	ws_end = state->ws_end;
+	ws_last = state->ws_last;
+	}
+
+
+
+int blasfeo_get_workspace_error()
+	{
+	int err = ws_error;
+	ws_error = 0;
+	return err;
+	}
+
+
+
+void blasfeo_set_workspace_error(int err)
+	{
+	ws_error |= err;
+	}
+
+
+
+void blasfeo_ws_malloc(void **ptr, size_t size)
+	{
+	// 64-byte blocks, so that the next allocation stays aligned as the workspace
+	size_t size_64 = (size+64-1)/64*64 + WS_HEADER;
+	if(ws_top!=NULL && size_64<=(size_t) (ws_end-ws_top))
+		{
+		*((char **) ws_top) = ws_last;
+		ws_last = ws_top + WS_HEADER;
+		ws_top += size_64;
+		*ptr = ws_last;
+		return;
+		}
+#if defined(EXT_DEP_MALLOC) && !defined(NO_INTERNAL_MALLOC)
+	*ptr = malloc(size);
+	if(*ptr!=NULL)
+		return;
+#endif
+	// the caller returns without computing, and the failure is reported by blasfeo_get_workspace_error
+	*ptr = NULL;
+	ws_error |= BLASFEO_WS_ERR_ALLOC;
+	}
+
+
+
+void blasfeo_ws_free(void *ptr)
+	{
+	char *cptr = ptr;
+	if(ptr==NULL)
+		return;
+	if(ws_mem!=NULL && cptr>=ws_mem && cptr<ws_end)
+		{
+		// the workspace is a stack: only the most recent block can be released
+		if(cptr==ws_last)
+			{
+			ws_top = cptr - WS_HEADER;
+			ws_last = *((char **) ws_top);
+			}
+		else
+			{
+			ws_error |= BLASFEO_WS_ERR_FREE;
+			}
+		return;
+		}
+#if defined(EXT_DEP_MALLOC) && !defined(NO_INTERNAL_MALLOC)
+	free(ptr);
+#endif
 	}
 
 
@@ -53,7 +53,7 @@ size_t blasfeo_pm_memsize_smat(int ps, int m, int n)
 	int pm = (m+ps-1)/ps*ps;
 	int cn = (n+nc-1)/nc*nc;
 	int tmp = m<n ? (m+al-1)/al*al : (n+al-1)/al*al; // al(min(m,n)) // XXX max ???
-	size_t memsize = (pm*cn+tmp)*sizeof(float);
+	size_t memsize = ((size_t) pm*cn+tmp)*sizeof(float);
 	return memsize;
 	}
 
@@ -74,11 +74,11 @@ void blasfeo_pm_create_smat(int ps, int m, int n, struct blasfeo_pm_smat *sA, vo
 	sA->cn = cn;
 	float *ptr = (float *) memory;
 	sA->pA = ptr;
-	ptr += pm*cn;
+	ptr += (size_t) pm*cn;
 	int tmp = m<n ? (m+al-1)/al*al : (n+al-1)/al*al; // al(min(m,n)) // XXX max ???
 	sA->dA = ptr;
 	ptr += tmp;
-	sA->memsize = (pm*cn+tmp)*sizeof(float);
+	sA->memsize = ((size_t) pm*cn+tmp)*sizeof(float);
 	sA->use_dA = 0; // invalidate stored inverse diagonal
 	return;
 	}
@@ -91,7 +91,7 @@ void blasfeo_pm_create_smat(int ps, int m, int n, struct blasfeo_pm_smat *sA, vo
 size_t blasfeo_cm_memsize_smat(int m, int n)
 	{
 	int tmp = m<n ? m : n; // al(min(m,n)) // XXX max ???
-	size_t memsize = (m*n+tmp)*sizeof(float);
+	size_t memsize = ((size_t) m*n+tmp)*sizeof(float);
 	return memsize;
 	}
 
@@ -106,12 +106,12 @@ void blasfeo_cm_create_smat(int m, int n, struct blasfeo_pm_smat *sA, void *memo
 	sA->use_dA = 0; // invalidate stored inverse diagonal
 	float *ptr = (float *) memory;
 	sA->pA = ptr;
-	ptr += m*n;
+	ptr += (size_t) m*n;
 	int tmp = m<n ? m : n; // al(min(m,n)) // XXX max ???
 	sA->dA = ptr;
 	ptr += tmp;
 	sA->use_dA = 0;
-	sA->memsize = (m*n+tmp)*sizeof(float);
+	sA->memsize = ((size_t) m*n+tmp)*sizeof(float);
 	return;
 	}
 
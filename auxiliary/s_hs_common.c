@@ -0,0 +1,461 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2019 by Gianluca Frison.                                                          *
+* Developed at IMTEK (University of Freiburg) under the supervision of Moritz Diehl.              *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#if defined(TARGET_X64_INTEL_SKYLAKE_X) || defined(TARGET_X64_AMD_ZEN5) || defined(TARGET_X64_INTEL_HASWELL)
+#include <immintrin.h>
+#define HS_F16C
+#endif
+
+#include <blasfeo_common.h>
+#include <blasfeo_s_aux.h>
+#include <blasfeo_s_blasfeo_api.h>
+
+
+
+/*
+* Half-precision storage: the matrix is panel-major with panel size BLASFEO_HS_PS (8),
+* so that a panel column is 16 bytes and is converted to 8 floats by one F16C instruction.
+* Targets without F16C use the same layout with a software conversion.
+*/
+
+#define PS BLASFEO_HS_PS
+
+
+
+/* conversion */
+
+#if defined(HS_F16C)
+
+static inline float hs_h2s(unsigned short h)
+	{
+	return _cvtsh_ss(h);
+	}
+
+static inline unsigned short hs_s2h(float f)
+	{
+	return _cvtss_sh(f, 0); // round to nearest even
+	}
+
+#else
+
+union hs_f32
+	{
+	unsigned int i;
+	float f;
+	};
+
+static inline float hs_h2s(unsigned short h)
+	{
+	union hs_f32 u;
+	unsigned int sign = (unsigned int) (h&0x8000) << 16;
+	unsigned int e = (h>>10) & 0x1f;
+	unsigned int man = h & 0x3ff;
+	if(e==0x1f) // inf, nan
+		{
+		u.i = sign | 0x7f800000 | man<<13;
+		}
+	else if(e!=0) // normal
+		{
+		u.i = sign | (e+112)<<23 | man<<13;
+		}
+	else // zero, subnormal
+		{
+		u.f = man * 5.9604644775390625e-8f; // 2^-24
+		u.i |= sign;
+		}
+	return u.f;
+	}
+
+static inline unsigned short hs_s2h(float f)
+	{
+	union hs_f32 u;
+	u.f = f;
+	unsigned int sign = (u.i>>16) & 0x8000;
+	unsigned int a = u.i & 0x7fffffff;
+	unsigned int h;
+	if(a>=0x47800000) // overflow, inf, nan
+		{
+		h = a>0x7f800000 ? 0x7e00 : 0x7c00;
+		}
+	else if(a<0x38800000) // zero, subnormal: let the float addition round the mantissa
+		{
+		u.i = a;
+		u.f += 0.5f;
+		h = u.i - 0x3f000000;
+		}
+	else // normal: rebias the exponent and round to nearest even
+		{
+		h = (a + 0xc8000fff + ((a>>13)&1)) >> 13;
+		}
+	return (unsigned short) (sign | h);
+	}
+
+#endif
+
+
+
+/* aux */
+
+// return the memory size (in bytes) needed for a hs_smat
+size_t blasfeo_hs_memsize_smat(int m, int n)
+	{
+	int pm = (m+PS-1)/PS*PS;
+	size_t memsize = (size_t) pm*n*sizeof(unsigned short);
+	memsize = (memsize+63)/64*64; // make multiple of typical cache line size
+	return memsize;
+	}
+
+
+
+// create a hs_smat for a matrix of size m*n by using memory passed by a pointer
+void blasfeo_hs_create_smat(int m, int n, struct blasfeo_hs_smat *sA, void *memory)
+	{
+	sA->mem = memory;
+	sA->m = m;
+	sA->n = n;
+	sA->pm = (m+PS-1)/PS*PS;
+	sA->cn = n;
+	sA->pA = (unsigned short *) memory;
+	sA->memsize = blasfeo_hs_memsize_smat(m, n);
+	return;
+	}
+
+
+
+void blasfeo_hs_pack_smat(int m, int n, float *A, int lda, struct blasfeo_hs_smat *sB, int bi, int bj)
+	{
+	int ii, jj;
+	for(jj=0; jj<n; jj++)
+		{
+		for(ii=0; ii<m; ii++)
+			{
+			BLASFEO_HS_SMATEL(sB, bi+ii, bj+jj) = hs_s2h(A[ii+lda*jj]);
+			}
+		}
+	return;
+	}
+
+
+
+void blasfeo_hs_unpack_smat(int m, int n, struct blasfeo_hs_smat *sA, int ai, int aj, float *B, int ldb)
+	{
+	int ii, jj;
+	for(jj=0; jj<n; jj++)
+		{
+		for(ii=0; ii<m; ii++)
+			{
+			B[ii+ldb*jj] = hs_h2s(BLASFEO_HS_SMATEL(sA, ai+ii, aj+jj));
+			}
+		}
+	return;
+	}
+
+
+
+void blasfeo_hs_cvt_s2h_mat(int m, int n, struct blasfeo_smat *sA, int ai, int aj, struct blasfeo_hs_smat *sB, int bi, int bj)
+	{
+	int ii, jj;
+	for(jj=0; jj<n; jj++)
+		{
+		for(ii=0; ii<m; ii++)
+			{
+			BLASFEO_HS_SMATEL(sB, bi+ii, bj+jj) = hs_s2h(BLASFEO_SMATEL(sA, ai+ii, aj+jj));
+			}
+		}
+	return;
+	}
+
+
+
+void blasfeo_hs_cvt_h2s_mat(int m, int n, struct blasfeo_hs_smat *sA, int ai, int aj, struct blasfeo_smat *sB, int bi, int bj)
+	{
+	int ii, jj;
+	for(jj=0; jj<n; jj++)
+		{
+		for(ii=0; ii<m; ii++)
+			{
+			BLASFEO_SMATEL(sB, bi+ii, bj+jj) = hs_h2s(BLASFEO_HS_SMATEL(sA, ai+ii, aj+jj));
+			}
+		}
+	return;
+	}
+
+
+
+/* kernels */
+
+#if defined(HS_F16C)
+
+// mask of the first km lanes
+static inline __m256i hs_mask(int km)
+	{
+	return _mm256_cmpgt_epi32(_mm256_set1_epi32(km), _mm256_set_epi32(7, 6, 5, 4, 3, 2, 1, 0));
+	}
+
+static inline __m256 hs_load(unsigned short *pA)
+	{
+	return _mm256_cvtph_ps(_mm_loadu_si128((__m128i *) pA));
+	}
+
+static inline float hs_hsum(__m256 a)
+	{
+	__m128 b = _mm_add_ps(_mm256_castps256_ps128(a), _mm256_extractf128_ps(a, 1));
+	b = _mm_add_ps(b, _mm_movehl_ps(b, b));
+	b = _mm_add_ss(b, _mm_movehdup_ps(b));
+	return _mm_cvtss_f32(b);
+	}
+
+#endif
+
+
+
+// z[0:km] <= beta * y[0:km] + alpha * A * x, with A a single panel of n columns
+static void hs_kernel_sgemv_n_8(int n, float alpha, unsigned short *pA, float *x, float beta, float *y, float *z, int km)
+	{
+	int jj;
+#if defined(HS_F16C)
+	// the rows after km (panel padding) only affect lanes that are not stored
+	__m256 acc0 = _mm256_setzero_ps();
+	__m256 acc1 = _mm256_setzero_ps();
+	__m256 acc2 = _mm256_setzero_ps();
+	__m256 acc3 = _mm256_setzero_ps();
+	for(jj=0; jj<n-3; jj+=4)
+		{
+		acc0 = _mm256_fmadd_ps(hs_load(pA+0*PS), _mm256_broadcast_ss(x+jj+0), acc0);
+		acc1 = _mm256_fmadd_ps(hs_load(pA+1*PS), _mm256_broadcast_ss(x+jj+1), acc1);
+		acc2 = _mm256_fmadd_ps(hs_load(pA+2*PS), _mm256_broadcast_ss(x+jj+2), acc2);
+		acc3 = _mm256_fmadd_ps(hs_load(pA+3*PS), _mm256_broadcast_ss(x+jj+3), acc3);
+		pA += 4*PS;
+		}
+	for(; jj<n; jj++)
+		{
+		acc0 = _mm256_fmadd_ps(hs_load(pA), _mm256_broadcast_ss(x+jj), acc0);
+		pA += PS;
+		}
+	acc0 = _mm256_add_ps(_mm256_add_ps(acc0, acc1), _mm256_add_ps(acc2, acc3));
+	acc0 = _mm256_mul_ps(_mm256_set1_ps(alpha), acc0);
+	if(km>=PS)
+		{
+		if(beta!=0.0)
+			acc0 = _mm256_fmadd_ps(_mm256_set1_ps(beta), _mm256_loadu_ps(y), acc0);
+		_mm256_storeu_ps(z, acc0);
+		}
+	else
+		{
+		__m256i msk = hs_mask(km);
+		if(beta!=0.0)
+			acc0 = _mm256_fmadd_ps(_mm256_set1_ps(beta), _mm256_maskload_ps(y, msk), acc0);
+		_mm256_maskstore_ps(z, msk, acc0);
+		}
+#else
+	int ii;
+	float acc[PS] = {0.0};
+	km = km<PS ? km : PS;
+	for(jj=0; jj<n; jj++)
+		{
+		for(ii=0; ii<km; ii++)
+			{
+			acc[ii] += hs_h2s(pA[ii+PS*jj]) * x[jj];
+			}
+		}
+	for(ii=0; ii<km; ii++)
+		{
+		z[ii] = alpha*acc[ii];
+		if(beta!=0.0)
+			z[ii] += beta*y[ii];
+		}
+#endif
+	return;
+	}
+
+
+
+// z[0:kn] += alpha * A^T * x, with A the kn (at most 4) columns of m rows starting at a panel boundary
+static void hs_kernel_sgemv_t_4(int m, float alpha, unsigned short *pA, int sda, float *x, float *z, int kn)
+	{
+	int ii, jj;
+	float tmp[4] = {0.0, 0.0, 0.0, 0.0};
+	kn = kn<4 ? kn : 4;
+#if defined(HS_F16C)
+	__m256 acc[4], a, xv;
+	__m256i msk;
+	for(jj=0; jj<4; jj++)
+		acc[jj] = _mm256_setzero_ps();
+	if(kn>=4)
+		{
+		for(ii=0; ii<m-PS+1; ii+=PS)
+			{
+			xv = _mm256_loadu_ps(x+ii);
+			acc[0] = _mm256_fmadd_ps(hs_load(pA+0*PS), xv, acc[0]);
+			acc[1] = _mm256_fmadd_ps(hs_load(pA+1*PS), xv, acc[1]);
+			acc[2] = _mm256_fmadd_ps(hs_load(pA+2*PS), xv, acc[2]);
+			acc[3] = _mm256_fmadd_ps(hs_load(pA+3*PS), xv, acc[3]);
+			pA += (size_t) PS*sda;
+			}
+		}
+	else
+		{
+		for(ii=0; ii<m-PS+1; ii+=PS)
+			{
+			xv = _mm256_loadu_ps(x+ii);
+			for(jj=0; jj<kn; jj++)
+				acc[jj] = _mm256_fmadd_ps(hs_load(pA+jj*PS), xv, acc[jj]);
+			pA += (size_t) PS*sda;
+			}
+		}
+	if(ii<m)
+		{
+		// the panel padding may hold any bit pattern (also nan): mask it out
+		msk = hs_mask(m-ii);
+		xv = _mm256_maskload_ps(x+ii, msk);
+		for(jj=0; jj<kn; jj++)
+			{
+			a = _mm256_and_ps(hs_load(pA+jj*PS), _mm256_castsi256_ps(msk));
+			acc[jj] = _mm256_fmadd_ps(a, xv, acc[jj]);
+			}
+		}
+	for(jj=0; jj<kn; jj++)
+		tmp[jj] = hs_hsum(acc[jj]);
+#else
+	int ll, km;
+	for(ii=0; ii<m; ii+=PS)
+		{
+		km = m-ii<PS ? m-ii : PS;
+		for(jj=0; jj<kn; jj++)
+			{
+			for(ll=0; ll<km; ll++)
+				{
+				tmp[jj] += hs_h2s(pA[ll+PS*jj]) * x[ii+ll];
+				}
+			}
+		pA += (size_t) PS*sda;
+		}
+#endif
+	for(jj=0; jj<kn; jj++)
+		z[jj] += alpha*tmp[jj];
+	return;
+	}
+
+
+
+/* routines */
+
+void blasfeo_hs_sgemv_n(int m, int n, float alpha, struct blasfeo_hs_smat *sA, int ai, int aj, struct blasfeo_svec *sx, int xi, float beta, struct blasfeo_svec *sy, int yi, struct blasfeo_svec *sz, int zi)
+	{
+
+	if(m<=0)
+		return;
+
+	int ii, jj;
+	float tmp;
+
+	float *x = sx->pa + xi;
+	float *y = sy->pa + yi;
+	float *z = sz->pa + zi;
+
+	// rows before the first panel boundary
+	int m0 = (PS-(ai&(PS-1)))&(PS-1);
+	m0 = m<m0 ? m : m0;
+	for(ii=0; ii<m0; ii++)
+		{
+		tmp = 0.0;
+		for(jj=0; jj<n; jj++)
+			{
+			tmp += hs_h2s(BLASFEO_HS_SMATEL(sA, ai+ii, aj+jj)) * x[jj];
+			}
+		z[ii] = alpha*tmp;
+		if(beta!=0.0)
+			z[ii] += beta*y[ii];
+		}
+
+	int sda = sA->cn;
+	unsigned short *pA = sA->pA + (size_t) (ai+m0)*sda + aj*PS;
+	for(; ii<m; ii+=PS)
+		{
+		hs_kernel_sgemv_n_8(n, alpha, pA, x, beta, y+ii, z+ii, m-ii);
+		pA += (size_t) PS*sda;
+		}
+
+	return;
+
+	}
+
+
+
+void blasfeo_hs_sgemv_t(int m, int n, float alpha, struct blasfeo_hs_smat *sA, int ai, int aj, struct blasfeo_svec *sx, int xi, float beta, struct blasfeo_svec *sy, int yi, struct blasfeo_svec *sz, int zi)
+	{
+
+	if(n<=0)
+		return;
+
+	int ii, jj;
+	float tmp;
+
+	float *x = sx->pa + xi;
+	float *y = sy->pa + yi;
+	float *z = sz->pa + zi;
+
+	// rows before the first panel boundary, together with beta * y
+	int m0 = (PS-(ai&(PS-1)))&(PS-1);
+	m0 = m<m0 ? m : m0;
+	for(jj=0; jj<n; jj++)
+		{
+		tmp = 0.0;
+		for(ii=0; ii<m0; ii++)
+			{
+			tmp += hs_h2s(BLASFEO_HS_SMATEL(sA, ai+ii, aj+jj)) * x[ii];
+			}
+		z[jj] = alpha*tmp;
+		if(beta!=0.0)
+			z[jj] += beta*y[jj];
+		}
+
+	if(m<=m0)
+		return;
+
+	int sda = sA->cn;
+	unsigned short *pA = sA->pA + (size_t) (ai+m0)*sda + aj*PS;
+	for(jj=0; jj<n; jj+=4)
+		{
+		hs_kernel_sgemv_t_4(m-m0, alpha, pA+jj*PS, sda, x+m0, z+jj, n-jj);
+		}
+
+	return;
+
+	}
+
@@ -41,7 +41,7 @@ size_t REF_MEMSIZE_MAT(int m, int n)
 	{
 #if defined(MF_COLMAJ)
 	int tmp = m<n ? m : n; // al(min(m,n)) // XXX max ???
-	size_t memsize = (m*n+tmp)*sizeof(REAL);
+	size_t memsize = ((size_t) m*n+tmp)*sizeof(REAL);
 #else // MF_PANELMAJ
 	const int bs = PS;
 	const int nc = PLD;
@@ -49,7 +49,7 @@ size_t REF_MEMSIZE_MAT(int m, int n)
 	int pm = (m+bs-1)/bs*bs;
 	int cn = (n+nc-1)/nc*nc;
 	int tmp = m<n ? (m+al-1)/al*al : (n+al-1)/al*al; // al(min(m,n)) // XXX max ???
-	size_t memsize = (pm*cn+tmp)*sizeof(REAL);
+	size_t memsize = ((size_t) pm*cn+tmp)*sizeof(REAL);
 #endif
 	memsize = (memsize + CACHE_LINE_SIZE - 1) / CACHE_LINE_SIZE * CACHE_LINE_SIZE;
 	return memsize;
@@ -102,12 +102,12 @@ void REF_CREATE_MAT(int m, int n, struct MAT *sA, void *memory)
 #if defined(MF_COLMAJ)
 	REAL *ptr = (REAL *) memory;
 	sA->pA = ptr;
-	ptr += m*n;
+	ptr += (size_t) m*n;
 	int tmp = m<n ? m : n; // al(min(m,n)) // XXX max ???
 	sA->dA = ptr;
 	ptr += tmp;
 	sA->use_dA = 0;
-	size_t memsize = (m*n+tmp)*sizeof(REAL);
+	size_t memsize = ((size_t) m*n+tmp)*sizeof(REAL);
 #else // MF_PANELMAJ
 	const int bs = PS; // 4
 	const int nc = PLD;
@@ -118,11 +118,11 @@ void REF_CREATE_MAT(int m, int n, struct MAT *sA, void *memory)
 	sA->cn = cn;
 	REAL *ptr = (REAL *) memory;
 	sA->pA = ptr;
-	ptr += pm*cn;
+	ptr += (size_t) pm*cn;
 	int tmp = m<n ? (m+al-1)/al*al : (n+al-1)/al*al; // al(min(m,n)) // XXX max ???
 	sA->dA = ptr;
 	ptr += tmp;
-	size_t memsize = (pm*cn+tmp)*sizeof(REAL);
+	size_t memsize = ((size_t) pm*cn+tmp)*sizeof(REAL);
 #endif
 	sA->memsize = (memsize + CACHE_LINE_SIZE - 1) / CACHE_LINE_SIZE * CACHE_LINE_SIZE;
 	return;
@@ -0,0 +1,565 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2019 by Gianluca Frison.                                                          *
+* Developed at IMTEK (University of Freiburg) under the supervision of Moritz Diehl.              *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+
+
+/*
+* Compact batch routines: BLASFEO_CB_D_NL matrices are interleaved element-wise,
+* and each vector operation below acts on the same element of all of them at once.
+* Only the leading dimension and the lane count are needed to address an element,
+* so the same code is used in any LA and MF choice.
+* The instruction set is selected by the including file with one of CB_ISA_AVX512F,
+* CB_ISA_AVX2, CB_ISA_AVX (scalar code otherwise).
+*/
+
+
+
+#define NL BLASFEO_CB_D_NL
+
+// pointer to the element (ai,aj) of the first lane
+#define CB_PTR(sA, ai, aj) ((sA)->pA+((ai)+(aj)*(sA)->m)*NL)
+
+
+
+#if defined(CB_ISA_AVX512F)
+
+typedef __m512d v_dcb;
+
+static inline v_dcb v_load(double *ptr) { return _mm512_loadu_pd(ptr); }
+static inline void v_store(double *ptr, v_dcb a) { _mm512_storeu_pd(ptr, a); }
+static inline v_dcb v_set1(double a) { return _mm512_set1_pd(a); }
+static inline v_dcb v_mul(v_dcb a, v_dcb b) { return _mm512_mul_pd(a, b); }
+// c + a * b
+static inline v_dcb v_fmadd(v_dcb a, v_dcb b, v_dcb c) { return _mm512_fmadd_pd(a, b, c); }
+// c - a * b
+static inline v_dcb v_fnmadd(v_dcb a, v_dcb b, v_dcb c) { return _mm512_fnmadd_pd(a, b, c); }
+static inline v_dcb v_inv(v_dcb a) { return _mm512_div_pd(_mm512_set1_pd(1.0), a); }
+// a>0 ? 1/sqrt(a) : 0
+static inline v_dcb v_inv_sqrt_pos(v_dcb a)
+	{
+	__mmask8 msk = _mm512_cmp_pd_mask(a, _mm512_setzero_pd(), _CMP_GT_OQ);
+	return _mm512_maskz_div_pd(msk, _mm512_set1_pd(1.0), _mm512_sqrt_pd(a));
+	}
+// update running maximum of abs(a) and its row index
+static inline void v_iamax(v_dcb a, double idx, v_dcb *amax, v_dcb *imax)
+	{
+	a = _mm512_abs_pd(a);
+	__mmask8 msk = _mm512_cmp_pd_mask(a, *amax, _CMP_GT_OQ);
+	*amax = _mm512_mask_mov_pd(*amax, msk, a);
+	*imax = _mm512_mask_mov_pd(*imax, msk, _mm512_set1_pd(idx));
+	}
+
+#elif defined(CB_ISA_AVX2) || defined(CB_ISA_AVX)
+
+#if defined(CB_ISA_AVX2)
+// c + a * b
+static inline __m256d v4_fmadd(__m256d a, __m256d b, __m256d c) { return _mm256_fmadd_pd(a, b, c); }
+// c - a * b
+static inline __m256d v4_fnmadd(__m256d a, __m256d b, __m256d c) { return _mm256_fnmadd_pd(a, b, c); }
+#else
+// c + a * b
+static inline __m256d v4_fmadd(__m256d a, __m256d b, __m256d c) { return _mm256_add_pd(c, _mm256_mul_pd(a, b)); }
+// c - a * b
+static inline __m256d v4_fnmadd(__m256d a, __m256d b, __m256d c) { return _mm256_sub_pd(c, _mm256_mul_pd(a, b)); }
+#endif
+static inline __m256d v4_inv(__m256d a) { return _mm256_div_pd(_mm256_set1_pd(1.0), a); }
+// a>0 ? 1/sqrt(a) : 0
+static inline __m256d v4_inv_sqrt_pos(__m256d a)
+	{
+	__m256d msk = _mm256_cmp_pd(a, _mm256_setzero_pd(), _CMP_GT_OQ);
+	return _mm256_and_pd(msk, _mm256_div_pd(_mm256_set1_pd(1.0), _mm256_sqrt_pd(a)));
+	}
+// update running maximum of abs(a) and its row index
+static inline void v4_iamax(__m256d a, __m256d idx, __m256d *amax, __m256d *imax)
+	{
+	a = _mm256_andnot_pd(_mm256_set1_pd(-0.0), a);
+	__m256d msk = _mm256_cmp_pd(a, *amax, _CMP_GT_OQ);
+	*amax = _mm256_blendv_pd(*amax, a, msk);
+	*imax = _mm256_blendv_pd(*imax, idx, msk);
+	}
+
+#if BLASFEO_CB_D_NL==4
+
+typedef __m256d v_dcb;
+
+static inline v_dcb v_load(double *ptr) { return _mm256_loadu_pd(ptr); }
+static inline void v_store(double *ptr, v_dcb a) { _mm256_storeu_pd(ptr, a); }
+static inline v_dcb v_set1(double a) { return _mm256_set1_pd(a); }
+static inline v_dcb v_mul(v_dcb a, v_dcb b) { return _mm256_mul_pd(a, b); }
+static inline v_dcb v_fmadd(v_dcb a, v_dcb b, v_dcb c) { return v4_fmadd(a, b, c); }
+static inline v_dcb v_fnmadd(v_dcb a, v_dcb b, v_dcb c) { return v4_fnmadd(a, b, c); }
+static inline v_dcb v_inv(v_dcb a) { return v4_inv(a); }
+static inline v_dcb v_inv_sqrt_pos(v_dcb a) { return v4_inv_sqrt_pos(a); }
+static inline void v_iamax(v_dcb a, double idx, v_dcb *amax, v_dcb *imax) { v4_iamax(a, _mm256_set1_pd(idx), amax, imax); }
+
+#else // BLASFEO_CB_D_NL==8, two 256-bit halves
+
+typedef struct { __m256d l; __m256d h; } v_dcb;
+
+static inline v_dcb v_load(double *ptr) { v_dcb r; r.l = _mm256_loadu_pd(ptr); r.h = _mm256_loadu_pd(ptr+4); return r; }
+static inline void v_store(double *ptr, v_dcb a) { _mm256_storeu_pd(ptr, a.l); _mm256_storeu_pd(ptr+4, a.h); }
+static inline v_dcb v_set1(double a) { v_dcb r; r.l = _mm256_set1_pd(a); r.h = r.l; return r; }
+static inline v_dcb v_mul(v_dcb a, v_dcb b) { a.l = _mm256_mul_pd(a.l, b.l); a.h = _mm256_mul_pd(a.h, b.h); return a; }
+static inline v_dcb v_fmadd(v_dcb a, v_dcb b, v_dcb c) { c.l = v4_fmadd(a.l, b.l, c.l); c.h = v4_fmadd(a.h, b.h, c.h); return c; }
+static inline v_dcb v_fnmadd(v_dcb a, v_dcb b, v_dcb c) { c.l = v4_fnmadd(a.l, b.l, c.l); c.h = v4_fnmadd(a.h, b.h, c.h); return c; }
+static inline v_dcb v_inv(v_dcb a) { a.l = v4_inv(a.l); a.h = v4_inv(a.h); return a; }
+static inline v_dcb v_inv_sqrt_pos(v_dcb a) { a.l = v4_inv_sqrt_pos(a.l); a.h = v4_inv_sqrt_pos(a.h); return a; }
+static inline void v_iamax(v_dcb a, double idx, v_dcb *amax, v_dcb *imax)
+	{
+	__m256d v_idx = _mm256_set1_pd(idx);
+	v4_iamax(a.l, v_idx, &amax->l, &imax->l);
+	v4_iamax(a.h, v_idx, &amax->h, &imax->h);
+	}
+
+#endif
+
+#else
+
+typedef struct { double v[NL]; } v_dcb;
+
+static inline v_dcb v_load(double *ptr) { v_dcb r; int ll; for(ll=0; ll<NL; ll++) r.v[ll] = ptr[ll]; return r; }
+static inline void v_store(double *ptr, v_dcb a) { int ll; for(ll=0; ll<NL; ll++) ptr[ll] = a.v[ll]; }
+static inline v_dcb v_set1(double a) { v_dcb r; int ll; for(ll=0; ll<NL; ll++) r.v[ll] = a; return r; }
+static inline v_dcb v_mul(v_dcb a, v_dcb b) { int ll; for(ll=0; ll<NL; ll++) a.v[ll] *= b.v[ll]; return a; }
+// c + a * b
+static inline v_dcb v_fmadd(v_dcb a, v_dcb b, v_dcb c) { int ll; for(ll=0; ll<NL; ll++) c.v[ll] += a.v[ll] * b.v[ll]; return c; }
+// c - a * b
+static inline v_dcb v_fnmadd(v_dcb a, v_dcb b, v_dcb c) { int ll; for(ll=0; ll<NL; ll++) c.v[ll] -= a.v[ll] * b.v[ll]; return c; }
+static inline v_dcb v_inv(v_dcb a) { int ll; for(ll=0; ll<NL; ll++) a.v[ll] = 1.0 / a.v[ll]; return a; }
+// a>0 ? 1/sqrt(a) : 0
+static inline v_dcb v_inv_sqrt_pos(v_dcb a) { int ll; for(ll=0; ll<NL; ll++) a.v[ll] = a.v[ll]>0.0 ? 1.0/sqrt(a.v[ll]) : 0.0; return a; }
+// update running maximum of abs(a) and its row index
+static inline void v_iamax(v_dcb a, double idx, v_dcb *amax, v_dcb *imax)
+	{
+	int ll;
+	double tmp;
+	for(ll=0; ll<NL; ll++)
+		{
+		tmp = a.v[ll]>0.0 ? a.v[ll] : -a.v[ll];
+		if(tmp>amax->v[ll])
+			{
+			amax->v[ll] = tmp;
+			imax->v[ll] = idx;
+			}
+		}
+	}
+
+#endif
+
+
+
+// D <= beta * C + alpha * A * B
+void CB_GEMM_NN(int m, int n, int k, double alpha, struct blasfeo_cb_dmat *sA, int ai, int aj, struct blasfeo_cb_dmat *sB, int bi, int bj, double beta, struct blasfeo_cb_dmat *sC, int ci, int cj, struct blasfeo_cb_dmat *sD, int di, int dj)
+	{
+	if(m<=0 | n<=0)
+		return;
+	int ii, jj, kk;
+	int lda = sA->m*NL;
+	int ldb = sB->m*NL;
+	int ldc = sC->m*NL;
+	int ldd = sD->m*NL;
+	double *pA = CB_PTR(sA, ai, aj);
+	double *pB = CB_PTR(sB, bi, bj);
+	double *pC = CB_PTR(sC, ci, cj);
+	double *pD = CB_PTR(sD, di, dj);
+	v_dcb v_alpha = v_set1(alpha);
+	v_dcb v_beta = v_set1(beta);
+	v_dcb b, d0, d1, d2, d3;
+	for(jj=0; jj<n; jj++)
+		{
+		ii = 0;
+		for(; ii<m-3; ii+=4)
+			{
+			d0 = v_set1(0.0);
+			d1 = v_set1(0.0);
+			d2 = v_set1(0.0);
+			d3 = v_set1(0.0);
+			for(kk=0; kk<k; kk++)
+				{
+				b = v_load(pB+kk*NL+jj*ldb);
+				d0 = v_fmadd(v_load(pA+(ii+0)*NL+kk*lda), b, d0);
+				d1 = v_fmadd(v_load(pA+(ii+1)*NL+kk*lda), b, d1);
+				d2 = v_fmadd(v_load(pA+(ii+2)*NL+kk*lda), b, d2);
+				d3 = v_fmadd(v_load(pA+(ii+3)*NL+kk*lda), b, d3);
+				}
+			v_store(pD+(ii+0)*NL+jj*ldd, v_fmadd(v_beta, v_load(pC+(ii+0)*NL+jj*ldc), v_mul(v_alpha, d0)));
+			v_store(pD+(ii+1)*NL+jj*ldd, v_fmadd(v_beta, v_load(pC+(ii+1)*NL+jj*ldc), v_mul(v_alpha, d1)));
+			v_store(pD+(ii+2)*NL+jj*ldd, v_fmadd(v_beta, v_load(pC+(ii+2)*NL+jj*ldc), v_mul(v_alpha, d2)));
+			v_store(pD+(ii+3)*NL+jj*ldd, v_fmadd(v_beta, v_load(pC+(ii+3)*NL+jj*ldc), v_mul(v_alpha, d3)));
+			}
+		for(; ii<m; ii++)
+			{
+			d0 = v_set1(0.0);
+			for(kk=0; kk<k; kk++)
+				{
+				d0 = v_fmadd(v_load(pA+ii*NL+kk*lda), v_load(pB+kk*NL+jj*ldb), d0);
+				}
+			v_store(pD+ii*NL+jj*ldd, v_fmadd(v_beta, v_load(pC+ii*NL+jj*ldc), v_mul(v_alpha, d0)));
+			}
+		}
+	return;
+	}
+
+
+
+// D <= beta * C + alpha * A * B^T
+void CB_GEMM_NT(int m, int n, int k, double alpha, struct blasfeo_cb_dmat *sA, int ai, int aj, struct blasfeo_cb_dmat *sB, int bi, int bj, double beta, struct blasfeo_cb_dmat *sC, int ci, int cj, struct blasfeo_cb_dmat *sD, int di, int dj)
+	{
+	if(m<=0 | n<=0)
+		return;
+	int ii, jj, kk;
+	int lda = sA->m*NL;
+	int ldb = sB->m*NL;
+	int ldc = sC->m*NL;
+	int ldd = sD->m*NL;
+	double *pA = CB_PTR(sA, ai, aj);
+	double *pB = CB_PTR(sB, bi, bj);
+	double *pC = CB_PTR(sC, ci, cj);
+	double *pD = CB_PTR(sD, di, dj);
+	v_dcb v_alpha = v_set1(alpha);
+	v_dcb v_beta = v_set1(beta);
+	v_dcb b, d0, d1, d2, d3;
+	for(jj=0; jj<n; jj++)
+		{
+		ii = 0;
+		for(; ii<m-3; ii+=4)
+			{
+			d0 = v_set1(0.0);
+			d1 = v_set1(0.0);
+			d2 = v_set1(0.0);
+			d3 = v_set1(0.0);
+			for(kk=0; kk<k; kk++)
+				{
+				b = v_load(pB+jj*NL+kk*ldb);
+				d0 = v_fmadd(v_load(pA+(ii+0)*NL+kk*lda), b, d0);
+				d1 = v_fmadd(v_load(pA+(ii+1)*NL+kk*lda), b, d1);
+				d2 = v_fmadd(v_load(pA+(ii+2)*NL+kk*lda), b, d2);
+				d3 = v_fmadd(v_load(pA+(ii+3)*NL+kk*lda), b, d3);
+				}
+			v_store(pD+(ii+0)*NL+jj*ldd, v_fmadd(v_beta, v_load(pC+(ii+0)*NL+jj*ldc), v_mul(v_alpha, d0)));
+			v_store(pD+(ii+1)*NL+jj*ldd, v_fmadd(v_beta, v_load(pC+(ii+1)*NL+jj*ldc), v_mul(v_alpha, d1)));
+			v_store(pD+(ii+2)*NL+jj*ldd, v_fmadd(v_beta, v_load(pC+(ii+2)*NL+jj*ldc), v_mul(v_alpha, d2)));
+			v_store(pD+(ii+3)*NL+jj*ldd, v_fmadd(v_beta, v_load(pC+(ii+3)*NL+jj*ldc), v_mul(v_alpha, d3)));
+			}
+		for(; ii<m; ii++)
+			{
+			d0 = v_set1(0.0);
+			for(kk=0; kk<k; kk++)
+				{
+				d0 = v_fmadd(v_load(pA+ii*NL+kk*lda), v_load(pB+jj*NL+kk*ldb), d0);
+				}
+			v_store(pD+ii*NL+jj*ldd, v_fmadd(v_beta, v_load(pC+ii*NL+jj*ldc), v_mul(v_alpha, d0)));
+			}
+		}
+	return;
+	}
+
+
+
+// D <= alpha * B * A^{-T} , with A lower triangular
+void CB_TRSM_RLTN(int m, int n, double alpha, struct blasfeo_cb_dmat *sA, int ai, int aj, struct blasfeo_cb_dmat *sB, int bi, int bj, struct blasfeo_cb_dmat *sD, int di, int dj)
+	{
+	if(m<=0 | n<=0)
+		return;
+	int ii, jj, kk;
+	int lda = sA->m*NL;
+	int ldb = sB->m*NL;
+	int ldd = sD->m*NL;
+	double *pA = CB_PTR(sA, ai, aj);
+	double *pB = CB_PTR(sB, bi, bj);
+	double *pD = CB_PTR(sD, di, dj);
+	v_dcb v_alpha = v_set1(alpha);
+	v_dcb a, inv, d0, d1, d2, d3;
+	for(jj=0; jj<n; jj++)
+		{
+		inv = v_inv(v_load(pA+jj*NL+jj*lda));
+		ii = 0;
+		for(; ii<m-3; ii+=4)
+			{
+			d0 = v_mul(v_alpha, v_load(pB+(ii+0)*NL+jj*ldb));
+			d1 = v_mul(v_alpha, v_load(pB+(ii+1)*NL+jj*ldb));
+			d2 = v_mul(v_alpha, v_load(pB+(ii+2)*NL+jj*ldb));
+			d3 = v_mul(v_alpha, v_load(pB+(ii+3)*NL+jj*ldb));
+			for(kk=0; kk<jj; kk++)
+				{
+				a = v_load(pA+jj*NL+kk*lda);
+				d0 = v_fnmadd(v_load(pD+(ii+0)*NL+kk*ldd), a, d0);
+				d1 = v_fnmadd(v_load(pD+(ii+1)*NL+kk*ldd), a, d1);
+				d2 = v_fnmadd(v_load(pD+(ii+2)*NL+kk*ldd), a, d2);
+				d3 = v_fnmadd(v_load(pD+(ii+3)*NL+kk*ldd), a, d3);
+				}
+			v_store(pD+(ii+0)*NL+jj*ldd, v_mul(d0, inv));
+			v_store(pD+(ii+1)*NL+jj*ldd, v_mul(d1, inv));
+			v_store(pD+(ii+2)*NL+jj*ldd, v_mul(d2, inv));
+			v_store(pD+(ii+3)*NL+jj*ldd, v_mul(d3, inv));
+			}
+		for(; ii<m; ii++)
+			{
+			d0 = v_mul(v_alpha, v_load(pB+ii*NL+jj*ldb));
+			for(kk=0; kk<jj; kk++)
+				{
+				d0 = v_fnmadd(v_load(pD+ii*NL+kk*ldd), v_load(pA+jj*NL+kk*lda), d0);
+				}
+			v_store(pD+ii*NL+jj*ldd, v_mul(d0, inv));
+			}
+		}
+	return;
+	}
+
+
+
+// D <= chol( C ) ; C, D lower triangular
+void CB_POTRF_L(int m, struct blasfeo_cb_dmat *sC, int ci, int cj, struct blasfeo_cb_dmat *sD, int di, int dj)
+	{
+	if(m<=0)
+		return;
+	int ii, jj, kk;
+	int ldc = sC->m*NL;
+	int ldd = sD->m*NL;
+	double *pC = CB_PTR(sC, ci, cj);
+	double *pD = CB_PTR(sD, di, dj);
+	v_dcb d_jk, inv, d0, d1, d2, d3;
+	for(jj=0; jj<m; jj++)
+		{
+		// diagonal
+		d0 = v_load(pC+jj*NL+jj*ldc);
+		for(kk=0; kk<jj; kk++)
+			{
+			d_jk = v_load(pD+jj*NL+kk*ldd);
+			d0 = v_fnmadd(d_jk, d_jk, d0);
+			}
+		inv = v_inv_sqrt_pos(d0);
+		v_store(pD+jj*NL+jj*ldd, v_mul(d0, inv));
+		// below diagonal
+		ii = jj+1;
+		for(; ii<m-3; ii+=4)
+			{
+			d0 = v_load(pC+(ii+0)*NL+jj*ldc);
+			d1 = v_load(pC+(ii+1)*NL+jj*ldc);
+			d2 = v_load(pC+(ii+2)*NL+jj*ldc);
+			d3 = v_load(pC+(ii+3)*NL+jj*ldc);
+			for(kk=0; kk<jj; kk++)
+				{
+				d_jk = v_load(pD+jj*NL+kk*ldd);
+				d0 = v_fnmadd(v_load(pD+(ii+0)*NL+kk*ldd), d_jk, d0);
+				d1 = v_fnmadd(v_load(pD+(ii+1)*NL+kk*ldd), d_jk, d1);
+				d2 = v_fnmadd(v_load(pD+(ii+2)*NL+kk*ldd), d_jk, d2);
+				d3 = v_fnmadd(v_load(pD+(ii+3)*NL+kk*ldd), d_jk, d3);
+				}
+			v_store(pD+(ii+0)*NL+jj*ldd, v_mul(d0, inv));
+			v_store(pD+(ii+1)*NL+jj*ldd, v_mul(d1, inv));
+			v_store(pD+(ii+2)*NL+jj*ldd, v_mul(d2, inv));
+			v_store(pD+(ii+3)*NL+jj*ldd, v_mul(d3, inv));
+			}
+		for(; ii<m; ii++)
+			{
+			d0 = v_load(pC+ii*NL+jj*ldc);
+			for(kk=0; kk<jj; kk++)
+				{
+				d0 = v_fnmadd(v_load(pD+ii*NL+kk*ldd), v_load(pD+jj*NL+kk*ldd), d0);
+				}
+			v_store(pD+ii*NL+jj*ldd, v_mul(d0, inv));
+			}
+		}
+	return;
+	}
+
+
+
+// D <= A^{-T} * A^{-1} * B , with A lower triangular (Cholesky factor from CB_POTRF_L) ; D can alias B
+void CB_POTRS_L(int m, int n, struct blasfeo_cb_dmat *sA, int ai, int aj, struct blasfeo_cb_dmat *sB, int bi, int bj, struct blasfeo_cb_dmat *sD, int di, int dj)
+	{
+	if(m<=0 | n<=0)
+		return;
+	int ii, jj, kk;
+	int lda = sA->m*NL;
+	int ldb = sB->m*NL;
+	int ldd = sD->m*NL;
+	double *pA = CB_PTR(sA, ai, aj);
+	double *pB = CB_PTR(sB, bi, bj);
+	double *pD = CB_PTR(sD, di, dj);
+	v_dcb a, inv, d0, d1, d2, d3;
+	// forward substitution, row by row, so that the inverse of each diagonal element is computed once for all columns
+	for(ii=0; ii<m; ii++)
+		{
+		inv = v_inv(v_load(pA+ii*NL+ii*lda));
+		jj = 0;
+		for(; jj<n-3; jj+=4)
+			{
+			d0 = v_load(pB+ii*NL+(jj+0)*ldb);
+			d1 = v_load(pB+ii*NL+(jj+1)*ldb);
+			d2 = v_load(pB+ii*NL+(jj+2)*ldb);
+			d3 = v_load(pB+ii*NL+(jj+3)*ldb);
+			for(kk=0; kk<ii; kk++)
+				{
+				a = v_load(pA+ii*NL+kk*lda);
+				d0 = v_fnmadd(a, v_load(pD+kk*NL+(jj+0)*ldd), d0);
+				d1 = v_fnmadd(a, v_load(pD+kk*NL+(jj+1)*ldd), d1);
+				d2 = v_fnmadd(a, v_load(pD+kk*NL+(jj+2)*ldd), d2);
+				d3 = v_fnmadd(a, v_load(pD+kk*NL+(jj+3)*ldd), d3);
+				}
+			v_store(pD+ii*NL+(jj+0)*ldd, v_mul(d0, inv));
+			v_store(pD+ii*NL+(jj+1)*ldd, v_mul(d1, inv));
+			v_store(pD+ii*NL+(jj+2)*ldd, v_mul(d2, inv));
+			v_store(pD+ii*NL+(jj+3)*ldd, v_mul(d3, inv));
+			}
+		for(; jj<n; jj++)
+			{
+			d0 = v_load(pB+ii*NL+jj*ldb);
+			for(kk=0; kk<ii; kk++)
+				{
+				d0 = v_fnmadd(v_load(pA+ii*NL+kk*lda), v_load(pD+kk*NL+jj*ldd), d0);
+				}
+			v_store(pD+ii*NL+jj*ldd, v_mul(d0, inv));
+			}
+		}
+	// backward substitution with A^T
+	for(ii=m-1; ii>=0; ii--)
+		{
+		inv = v_inv(v_load(pA+ii*NL+ii*lda));
+		jj = 0;
+		for(; jj<n-3; jj+=4)
+			{
+			d0 = v_load(pD+ii*NL+(jj+0)*ldd);
+			d1 = v_load(pD+ii*NL+(jj+1)*ldd);
+			d2 = v_load(pD+ii*NL+(jj+2)*ldd);
+			d3 = v_load(pD+ii*NL+(jj+3)*ldd);
+			for(kk=ii+1; kk<m; kk++)
+				{
+				a = v_load(pA+kk*NL+ii*lda);
+				d0 = v_fnmadd(a, v_load(pD+kk*NL+(jj+0)*ldd), d0);
+				d1 = v_fnmadd(a, v_load(pD+kk*NL+(jj+1)*ldd), d1);
+				d2 = v_fnmadd(a, v_load(pD+kk*NL+(jj+2)*ldd), d2);
+				d3 = v_fnmadd(a, v_load(pD+kk*NL+(jj+3)*ldd), d3);
+				}
+			v_store(pD+ii*NL+(jj+0)*ldd, v_mul(d0, inv));
+			v_store(pD+ii*NL+(jj+1)*ldd, v_mul(d1, inv));
+			v_store(pD+ii*NL+(jj+2)*ldd, v_mul(d2, inv));
+			v_store(pD+ii*NL+(jj+3)*ldd, v_mul(d3, inv));
+			}
+		for(; jj<n; jj++)
+			{
+			d0 = v_load(pD+ii*NL+jj*ldd);
+			for(kk=ii+1; kk<m; kk++)
+				{
+				d0 = v_fnmadd(v_load(pA+kk*NL+ii*lda), v_load(pD+kk*NL+jj*ldd), d0);
+				}
+			v_store(pD+ii*NL+jj*ldd, v_mul(d0, inv));
+			}
+		}
+	return;
+	}
+
+
+
+// D <= lu( C ) ; row pivoting, the pivot of lane ll at row ii is stored in ipiv[ii*NL+ll]
+void CB_GETRF_RP(int m, int n, struct blasfeo_cb_dmat *sC, int ci, int cj, struct blasfeo_cb_dmat *sD, int di, int dj, int *ipiv)
+	{
+	if(m<=0 | n<=0)
+		return;
+	int ii, jj, kk, ll, ip;
+	int ldc = sC->m*NL;
+	int ldd = sD->m*NL;
+	double *pC = CB_PTR(sC, ci, cj);
+	double *pD = CB_PTR(sD, di, dj);
+	double tmp;
+	double imax_tmp[NL];
+	v_dcb amax, imax, inv, d_kj;
+	int p = m<n ? m : n;
+	// copy if needed
+	if(pC!=pD)
+		{
+		for(jj=0; jj<n; jj++)
+			for(ii=0; ii<m; ii++)
+				v_store(pD+ii*NL+jj*ldd, v_load(pC+ii*NL+jj*ldc));
+		}
+	// right-looking factorization, one pivot search per lane
+	for(kk=0; kk<p; kk++)
+		{
+		// look for pivot
+		amax = v_set1(-1.0);
+		imax = v_set1((double) kk);
+		for(ii=kk; ii<m; ii++)
+			{
+			v_iamax(v_load(pD+ii*NL+kk*ldd), (double) ii, &amax, &imax);
+			}
+		v_store(imax_tmp, imax);
+		// swap rows, independently in each lane
+		for(ll=0; ll<NL; ll++)
+			{
+			ip = (int) imax_tmp[ll];
+			ipiv[kk*NL+ll] = ip;
+			if(ip!=kk)
+				{
+				for(jj=0; jj<n; jj++)
+					{
+					tmp = pD[kk*NL+jj*ldd+ll];
+					pD[kk*NL+jj*ldd+ll] = pD[ip*NL+jj*ldd+ll];
+					pD[ip*NL+jj*ldd+ll] = tmp;
+					}
+				}
+			}
+		// scale pivot column
+		inv = v_inv(v_load(pD+kk*NL+kk*ldd));
+		for(ii=kk+1; ii<m; ii++)
+			{
+			v_store(pD+ii*NL+kk*ldd, v_mul(v_load(pD+ii*NL+kk*ldd), inv));
+			}
+		// update trailing matrix
+		for(jj=kk+1; jj<n; jj++)
+			{
+			d_kj = v_load(pD+kk*NL+jj*ldd);
+			for(ii=kk+1; ii<m; ii++)
+				{
+				v_store(pD+ii*NL+jj*ldd, v_fnmadd(v_load(pD+ii*NL+kk*ldd), d_kj, v_load(pD+ii*NL+jj*ldd)));
+				}
+			}
+		}
+	return;
+	}
+
+
+
+#if defined(CB_KERNELS)
+const struct blasfeo_cb_dkernels CB_KERNELS =
+	{
+	CB_GEMM_NN,
+	CB_GEMM_NT,
+	CB_TRSM_RLTN,
+	CB_POTRF_L,
+	CB_GETRF_RP,
+	CB_POTRS_L,
+	};
+#endif
@@ -0,0 +1,266 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2019 by Gianluca Frison.                                                          *
+* Developed at IMTEK (University of Freiburg) under the supervision of Moritz Diehl.              *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+/*
+ * auxiliary functions for double precision complex panel-major matrices (panel size Z_PS in all targets)
+ *
+ * auxiliary/z_aux_lib4.c
+ *
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#include <blasfeo_common.h>
+#include <blasfeo_block_size.h>
+#include <blasfeo_z_aux.h>
+
+
+
+#define ZMATEL_RE BLASFEO_ZMATEL_RE
+#define ZMATEL_IM BLASFEO_ZMATEL_IM
+#define ZVECEL_RE BLASFEO_ZVECEL_RE
+#define ZVECEL_IM BLASFEO_ZVECEL_IM
+
+
+
+// return the memory size (in bytes) needed for a zmat
+size_t blasfeo_memsize_zmat(int m, int n)
+	{
+	const int bs = Z_PS; // 4
+	int pm = (m+bs-1)/bs*bs;
+	int cn = (n+bs-1)/bs*bs;
+	size_t memsize = (size_t) pm*cn*Z_EL_SIZE;
+	memsize = (memsize + CACHE_LINE_SIZE - 1) / CACHE_LINE_SIZE * CACHE_LINE_SIZE;
+	return memsize;
+	}
+
+
+
+// create a zmat for a matrix of size m*n by using memory passed by a pointer
+void blasfeo_create_zmat(int m, int n, struct blasfeo_zmat *sA, void *memory)
+	{
+	sA->mem = memory;
+	const int bs = Z_PS; // 4
+	sA->m = m;
+	sA->n = n;
+	int pm = (m+bs-1)/bs*bs;
+	// the number of columns is padded too, so that kernels can read full 4x4 blocks
+	int cn = (n+bs-1)/bs*bs;
+	sA->pm = pm;
+	sA->cn = cn;
+	sA->pA = (double *) memory;
+	size_t memsize = (size_t) pm*cn*Z_EL_SIZE;
+	sA->memsize = (memsize + CACHE_LINE_SIZE - 1) / CACHE_LINE_SIZE * CACHE_LINE_SIZE;
+	return;
+	}
+
+
+
+// return the memory size (in bytes) needed for a zvec
+size_t blasfeo_memsize_zvec(int m)
+	{
+	const int bs = Z_PS; // 4
+	int pm = (m+bs-1)/bs*bs;
+	size_t memsize = (size_t) pm*Z_EL_SIZE;
+	return memsize;
+	}
+
+
+
+// create a zvec for a vector of size m by using memory passed by a pointer
+void blasfeo_create_zvec(int m, struct blasfeo_zvec *sa, void *memory)
+	{
+	sa->mem = memory;
+	const int bs = Z_PS; // 4
+	sa->m = m;
+	int pm = (m+bs-1)/bs*bs;
+	sa->pm = pm;
+	sa->pa = (double *) memory;
+	sa->memsize = (size_t) pm*Z_EL_SIZE;
+	return;
+	}
+
+
+
+// convert a column-major complex matrix into a matrix structure
+void blasfeo_pack_zmat(int m, int n, double *A, int lda, struct blasfeo_zmat *sB, int bi, int bj)
+	{
+	int ii, jj;
+	for(jj=0; jj<n; jj++)
+		{
+		for(ii=0; ii<m; ii++)
+			{
+			ZMATEL_RE(sB, bi+ii, bj+jj) = A[2*(ii+lda*jj)+0];
+			ZMATEL_IM(sB, bi+ii, bj+jj) = A[2*(ii+lda*jj)+1];
+			}
+		}
+	return;
+	}
+
+
+
+// convert a matrix structure into a column-major complex matrix
+void blasfeo_unpack_zmat(int m, int n, struct blasfeo_zmat *sA, int ai, int aj, double *B, int ldb)
+	{
+	int ii, jj;
+	for(jj=0; jj<n; jj++)
+		{
+		for(ii=0; ii<m; ii++)
+			{
+			B[2*(ii+ldb*jj)+0] = ZMATEL_RE(sA, ai+ii, aj+jj);
+			B[2*(ii+ldb*jj)+1] = ZMATEL_IM(sA, ai+ii, aj+jj);
+			}
+		}
+	return;
+	}
+
+
+
+// convert a complex vector into a vector structure
+void blasfeo_pack_zvec(int m, double *x, int incx, struct blasfeo_zvec *sy, int yi)
+	{
+	int ii;
+	for(ii=0; ii<m; ii++)
+		{
+		ZVECEL_RE(sy, yi+ii) = x[2*ii*incx+0];
+		ZVECEL_IM(sy, yi+ii) = x[2*ii*incx+1];
+		}
+	return;
+	}
+
+
+
+// convert a vector structure into a complex vector
+void blasfeo_unpack_zvec(int m, struct blasfeo_zvec *sx, int xi, double *y, int incy)
+	{
+	int ii;
+	for(ii=0; ii<m; ii++)
+		{
+		y[2*ii*incy+0] = ZVECEL_RE(sx, xi+ii);
+		y[2*ii*incy+1] = ZVECEL_IM(sx, xi+ii);
+		}
+	return;
+	}
+
+
+
+// copy a generic matrix into a generic matrix
+void blasfeo_zgecp(int m, int n, struct blasfeo_zmat *sA, int ai, int aj, struct blasfeo_zmat *sB, int bi, int bj)
+	{
+	const int bs = Z_PS; // 4
+	int ii, jj, ll;
+	double *pA, *pB;
+	if(m<=0 | n<=0)
+		return;
+	ii = 0;
+	if((ai&(bs-1))==0 & (bi&(bs-1))==0)
+		{
+		// aligned panels: copy whole panels, and the last partial panel by element
+		for(; ii<m-bs+1; ii+=bs)
+			{
+			pA = &ZMATEL_RE(sA, ai+ii, aj);
+			pB = &ZMATEL_RE(sB, bi+ii, bj);
+			for(ll=0; ll<2*bs*n; ll++)
+				pB[ll] = pA[ll];
+			}
+		}
+	for(jj=0; jj<n; jj++)
+		{
+		for(ll=ii; ll<m; ll++)
+			{
+			ZMATEL_RE(sB, bi+ll, bj+jj) = ZMATEL_RE(sA, ai+ll, aj+jj);
+			ZMATEL_IM(sB, bi+ll, bj+jj) = ZMATEL_IM(sA, ai+ll, aj+jj);
+			}
+		}
+	return;
+	}
+
+
+
+// swap two rows of a matrix struct
+static void zrowsw(int kmax, struct blasfeo_zmat *sA, int ai, int aj, struct blasfeo_zmat *sC, int ci, int cj)
+	{
+	int jj;
+	double tmp;
+	for(jj=0; jj<kmax; jj++)
+		{
+		tmp = ZMATEL_RE(sA, ai, aj+jj);
+		ZMATEL_RE(sA, ai, aj+jj) = ZMATEL_RE(sC, ci, cj+jj);
+		ZMATEL_RE(sC, ci, cj+jj) = tmp;
+		tmp = ZMATEL_IM(sA, ai, aj+jj);
+		ZMATEL_IM(sA, ai, aj+jj) = ZMATEL_IM(sC, ci, cj+jj);
+		ZMATEL_IM(sC, ci, cj+jj) = tmp;
+		}
+	return;
+	}
+
+
+
+// permute the rows of a matrix struct
+void blasfeo_zrowpe(int kmax, int *ipiv, struct blasfeo_zmat *sA)
+	{
+	int ii;
+	for(ii=0; ii<kmax; ii++)
+		{
+		if(ipiv[ii]!=ii)
+			zrowsw(sA->n, sA, ii, 0, sA, ipiv[ii], 0);
+		}
+	return;
+	}
+
+
+
+// permute elements of a vector struct
+void blasfeo_zvecpe(int kmax, int *ipiv, struct blasfeo_zvec *sx, int xi)
+	{
+	int ii;
+	double tmp;
+	double *x = sx->pa + 2*xi;
+	for(ii=0; ii<kmax; ii++)
+		{
+		if(ipiv[ii]!=ii)
+			{
+			tmp = x[2*ipiv[ii]+0];
+			x[2*ipiv[ii]+0] = x[2*ii+0];
+			x[2*ii+0] = tmp;
+			tmp = x[2*ipiv[ii]+1];
+			x[2*ipiv[ii]+1] = x[2*ii+1];
+			x[2*ii+1] = tmp;
+			}
+		}
+	return;
+	}
+
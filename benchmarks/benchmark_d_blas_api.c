@@ -85,7 +85,7 @@ openblas_set_num_threads(1);
 
 
 
-// initialize blasfeo (e.g. pre-allocate memory buffers) (optional, not thread safe)
+// initialize blasfeo (e.g. pre-allocate memory buffers) (optional, per thread)
 //blasfeo_init();
 
 
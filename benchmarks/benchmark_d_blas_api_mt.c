@@ -0,0 +1,205 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2019 by Gianluca Frison.                                                          *
+* Developed at IMTEK (University of Freiburg) under the supervision of Moritz Diehl.              *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+
+// concurrency stress benchmark: many threads call the BLAS API dgemm at the same time,
+// each on its own matrices and with its own packing buffer (see blasfeo_init);
+// the aggregate throughput should scale linearly with the number of threads
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#include <blasfeo.h>
+
+
+
+#define MAX_THREADS 64
+
+
+
+struct thread_arg
+	{
+	int n;
+	int nrep;
+	double time;
+	double *ref; // reference result, to check that concurrent calls do not interfere
+	int error;
+	};
+
+
+
+static void init_matrices(int n, double *A, double *B)
+	{
+	int ii;
+	for(ii=0; ii<n*n; ii++)
+		{
+		A[ii] = (ii%13)*0.1 - 0.6;
+		B[ii] = (ii%7)*0.2 - 0.5;
+		}
+	}
+
+
+
+static void *thread_main(void *ptr)
+	{
+	struct thread_arg *arg = ptr;
+	int n = arg->n;
+	int nrep = arg->nrep;
+	int rep;
+
+	double r_1 = 1.0;
+	double r_0 = 0.0;
+	char c_n = 'n';
+
+	// each thread has its own packing buffer
+	blasfeo_init();
+
+	double *A = malloc(n*n*sizeof(double));
+	double *B = malloc(n*n*sizeof(double));
+	double *C = malloc(n*n*sizeof(double));
+	init_matrices(n, A, B);
+
+	// warm up
+	blasfeo_blas_dgemm(&c_n, &c_n, &n, &n, &n, &r_1, A, &n, B, &n, &r_0, C, &n);
+
+	blasfeo_timer timer;
+	blasfeo_tic(&timer);
+	for(rep=0; rep<nrep; rep++)
+		{
+		blasfeo_blas_dgemm(&c_n, &c_n, &n, &n, &n, &r_1, A, &n, B, &n, &r_0, C, &n);
+		}
+	arg->time = blasfeo_toc(&timer);
+
+	arg->error = 0;
+	if(arg->ref!=NULL)
+		arg->error = memcmp(C, arg->ref, n*n*sizeof(double))!=0;
+
+	free(A);
+	free(B);
+	free(C);
+
+	blasfeo_quit();
+
+	return NULL;
+	}
+
+
+
+int main()
+	{
+
+#if !defined(BLAS_API)
+	printf("\nRecompile with BLAS_API=1 to run this benchmark!\n\n");
+	return 0;
+#else
+
+	int ii, jj, kk;
+
+	int max_threads = sysconf(_SC_NPROCESSORS_ONLN);
+	max_threads = max_threads<1 ? 1 : max_threads;
+	max_threads = max_threads>MAX_THREADS ? MAX_THREADS : max_threads;
+
+	int sizes[] = {32, 64, 128, 256, 512};
+	int n_sizes = sizeof(sizes)/sizeof(int);
+
+	pthread_t threads[MAX_THREADS];
+	struct thread_arg args[MAX_THREADS];
+
+	printf("\nBLASFEO concurrency stress benchmark - BLAS API dgemm_nn - double precision\n");
+	printf("\nup to %d threads\n\n", max_threads);
+	printf("n\tthreads\tGflops\tspeedup\tefficiency\n");
+
+	for(ii=0; ii<n_sizes; ii++)
+		{
+
+		int n = sizes[ii];
+		double flop = 2.0*n*n*n;
+		int nrep = 2e9/flop;
+		nrep = nrep<1 ? 1 : nrep;
+
+		// single-threaded reference result
+		double r_1 = 1.0;
+		double r_0 = 0.0;
+		char c_n = 'n';
+		double *A = malloc(n*n*sizeof(double));
+		double *B = malloc(n*n*sizeof(double));
+		double *ref = malloc(n*n*sizeof(double));
+		init_matrices(n, A, B);
+		blasfeo_blas_dgemm(&c_n, &c_n, &n, &n, &n, &r_1, A, &n, B, &n, &r_0, ref, &n);
+
+		double Gflops_1 = 0.0;
+
+		// powers of two, plus the max number of threads
+		for(jj=1; jj<=max_threads; jj=((jj<max_threads) & (2*jj>max_threads)) ? max_threads : 2*jj)
+			{
+			for(kk=0; kk<jj; kk++)
+				{
+				args[kk].n = n;
+				args[kk].nrep = nrep;
+				args[kk].ref = ref;
+				pthread_create(&threads[kk], NULL, thread_main, &args[kk]);
+				}
+			double time_max = 0.0;
+			int error = 0;
+			for(kk=0; kk<jj; kk++)
+				{
+				pthread_join(threads[kk], NULL);
+				time_max = args[kk].time>time_max ? args[kk].time : time_max;
+				error |= args[kk].error;
+				}
+
+			double Gflops = 1e-9*flop*nrep*jj/time_max;
+			if(jj==1)
+				Gflops_1 = Gflops;
+
+			printf("%d\t%d\t%9.3f\t%6.2f\t%6.2f%s\n", n, jj, Gflops, Gflops/Gflops_1, Gflops/Gflops_1/jj, error ? "\tERROR: wrong result" : "");
+			}
+
+		free(A);
+		free(B);
+		free(ref);
+
+		}
+
+	printf("\n");
+
+	return 0;
+
+#endif
+
+	}
@@ -482,7 +482,7 @@ int main()
 	{
 
 
-// initialize blasfeo (e.g. pre-allocate memory buffers) (optional, not thread safe)
+// initialize blasfeo (e.g. pre-allocate memory buffers) (optional, per thread)
 //blasfeo_init();
 
 
@@ -0,0 +1,163 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2019 by Gianluca Frison.                                                          *
+* Developed at IMTEK (University of Freiburg) under the supervision of Moritz Diehl.              *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+// batched solve benchmark: nb small positive definite systems A[ii] * x[ii] = b[ii] are solved
+// one at a time with dpotrf_l + dtrsv_lnn + dtrsv_ltn, and with the batched blasfeo_dposv_l_batch,
+// that interleaves BLASFEO_CB_D_NL systems and solves them in the SIMD lanes
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+
+#include <blasfeo.h>
+
+
+
+#define NB 4096
+
+
+
+int main()
+	{
+
+	int ii, jj, kk, rep;
+
+	int sizes[] = {2, 3, 4, 5, 6, 8, 10, 12, 16};
+	int n_sizes = sizeof(sizes)/sizeof(int);
+
+	int nb = NB;
+
+	printf("\nBLASFEO batched solve benchmark - dposv_l - double precision\n");
+	printf("\n%d systems, %d interleaved lanes\n\n", nb, BLASFEO_CB_D_NL);
+	printf("m\tloop [systems/s]\tbatch [systems/s]\tspeedup\tmax error\n");
+
+	struct blasfeo_dmat *sA = malloc(nb*sizeof(struct blasfeo_dmat));
+	struct blasfeo_dmat *sL = malloc(nb*sizeof(struct blasfeo_dmat));
+	struct blasfeo_dvec *sb = malloc(nb*sizeof(struct blasfeo_dvec));
+	struct blasfeo_dvec *sx = malloc(nb*sizeof(struct blasfeo_dvec));
+	struct blasfeo_dvec *sx_ref = malloc(nb*sizeof(struct blasfeo_dvec));
+	struct blasfeo_dmat **pA = malloc(nb*sizeof(struct blasfeo_dmat *));
+	struct blasfeo_dvec **pb = malloc(nb*sizeof(struct blasfeo_dvec *));
+	struct blasfeo_dvec **px = malloc(nb*sizeof(struct blasfeo_dvec *));
+	int *info = malloc(nb*sizeof(int));
+
+	blasfeo_timer timer;
+
+	for(kk=0; kk<n_sizes; kk++)
+		{
+
+		int m = sizes[kk];
+		int nrep = 2e8/(nb*(m*m*m/3.0+2.0*m*m));
+		nrep = nrep<1 ? 1 : nrep;
+
+		for(ii=0; ii<nb; ii++)
+			{
+			blasfeo_allocate_dmat(m, m, &sA[ii]);
+			blasfeo_allocate_dmat(m, m, &sL[ii]);
+			blasfeo_allocate_dvec(m, &sb[ii]);
+			blasfeo_allocate_dvec(m, &sx[ii]);
+			blasfeo_allocate_dvec(m, &sx_ref[ii]);
+			pA[ii] = &sA[ii];
+			pb[ii] = &sb[ii];
+			px[ii] = &sx[ii];
+			// diagonally dominant, hence positive definite
+			for(jj=0; jj<m*m; jj++)
+				BLASFEO_DMATEL(&sA[ii], jj%m, jj/m) = jj%m==jj/m ? m+1.0 : 1.0/(1.0+(ii+jj)%7);
+			for(jj=0; jj<m; jj++)
+				BLASFEO_DVECEL(&sb[ii], jj) = (ii+jj)%5-2.0;
+			}
+		// make A symmetric (upper from lower)
+		for(ii=0; ii<nb; ii++)
+			blasfeo_dtrtr_l(m, &sA[ii], 0, 0, &sA[ii], 0, 0);
+
+		// one system at a time
+		blasfeo_tic(&timer);
+		for(rep=0; rep<nrep; rep++)
+			{
+			for(ii=0; ii<nb; ii++)
+				{
+				blasfeo_dpotrf_l(m, &sA[ii], 0, 0, &sL[ii], 0, 0);
+				blasfeo_dtrsv_lnn(m, &sL[ii], 0, 0, &sb[ii], 0, &sx_ref[ii], 0);
+				blasfeo_dtrsv_ltn(m, &sL[ii], 0, 0, &sx_ref[ii], 0, &sx_ref[ii], 0);
+				}
+			}
+		double time_loop = blasfeo_toc(&timer) / nrep;
+
+		// batched
+		blasfeo_tic(&timer);
+		for(rep=0; rep<nrep; rep++)
+			{
+			blasfeo_dposv_l_batch(nb, m, pA, 0, 0, pb, 0, px, 0, info);
+			}
+		double time_batch = blasfeo_toc(&timer) / nrep;
+
+		double err, err_max = 0.0;
+		for(ii=0; ii<nb; ii++)
+			{
+			for(jj=0; jj<m; jj++)
+				{
+				err = fabs(BLASFEO_DVECEL(&sx[ii], jj) - BLASFEO_DVECEL(&sx_ref[ii], jj));
+				err_max = err>err_max ? err : err_max;
+				}
+			}
+
+		printf("%d\t%e\t\t%e\t\t%5.2f\t%e\n", m, nb/time_loop, nb/time_batch, time_loop/time_batch, err_max);
+
+		for(ii=0; ii<nb; ii++)
+			{
+			blasfeo_free_dmat(&sA[ii]);
+			blasfeo_free_dmat(&sL[ii]);
+			blasfeo_free_dvec(&sb[ii]);
+			blasfeo_free_dvec(&sx[ii]);
+			blasfeo_free_dvec(&sx_ref[ii]);
+			}
+
+		}
+
+	printf("\n");
+
+	free(sA);
+	free(sL);
+	free(sb);
+	free(sx);
+	free(sx_ref);
+	free(pA);
+	free(pb);
+	free(px);
+	free(info);
+
+	return 0;
+
+	}
@@ -0,0 +1,263 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2019 by Gianluca Frison.                                                          *
+* Developed at IMTEK (University of Freiburg) under the supervision of Moritz Diehl.              *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+// Riccati recursion benchmark: factorization (blasfeo_driccati_trf), solution (blasfeo_driccati_trs) and
+// fused factorization and solution (blasfeo_driccati_sv) of an optimal control problem with horizon N;
+// the KKT residual of the solutions is reported as a check
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#include <blasfeo.h>
+
+
+
+#define N_MAX 100
+
+
+
+// max KKT residual (dynamics and stationarity) of ux, pi
+static double kkt_residual(int N, int *nx, int *nu, struct blasfeo_dmat *BAbt, struct blasfeo_dmat *RSQrq, struct blasfeo_dvec *b, struct blasfeo_dvec *rq, struct blasfeo_dvec *ux, struct blasfeo_dvec *pi, struct blasfeo_dvec *res)
+	{
+	int nn;
+	double nrm, res_max = 0.0;
+	for(nn=0; nn<=N; nn++)
+		{
+		// stationarity
+		blasfeo_dsymv_l(nu[nn]+nx[nn], 1.0, &RSQrq[nn], 0, 0, &ux[nn], 0, 1.0, &rq[nn], 0, res, 0);
+		if(nn<N)
+			blasfeo_dgemv_n(nu[nn]+nx[nn], nx[nn+1], 1.0, &BAbt[nn], 0, 0, &pi[nn], 0, 1.0, res, 0, res, 0);
+		if(nn>0)
+			blasfeo_daxpy(nx[nn], -1.0, &pi[nn-1], 0, res, nu[nn], res, nu[nn]);
+		blasfeo_dvecnrm_inf(nu[nn]+nx[nn], res, 0, &nrm);
+		res_max = nrm>res_max ? nrm : res_max;
+		// dynamics
+		if(nn<N)
+			{
+			blasfeo_dgemv_t(nu[nn]+nx[nn], nx[nn+1], 1.0, &BAbt[nn], 0, 0, &ux[nn], 0, 1.0, &b[nn], 0, res, 0);
+			blasfeo_daxpy(nx[nn+1], -1.0, &ux[nn+1], nu[nn+1], res, 0, res, 0);
+			blasfeo_dvecnrm_inf(nx[nn+1], res, 0, &nrm);
+			res_max = nrm>res_max ? nrm : res_max;
+			}
+		}
+	return res_max;
+	}
+
+
+
+int main()
+	{
+
+	int ii, jj, nn, kk, rep;
+
+	int nx_list[] = {4, 8, 16};
+	int nu_list[] = {2, 3, 8};
+	int n_sizes = sizeof(nx_list)/sizeof(int);
+
+	int nx[N_MAX+1];
+	int nu[N_MAX+1];
+
+	struct blasfeo_dmat BAbt[N_MAX];
+	struct blasfeo_dmat RSQrq[N_MAX+1];
+	struct blasfeo_dvec b[N_MAX];
+	struct blasfeo_dvec rq[N_MAX+1];
+	struct blasfeo_dvec ux[N_MAX+1];
+	struct blasfeo_dvec pi[N_MAX];
+	struct blasfeo_dvec res;
+	struct blasfeo_dmat RSQrq_N, RSQrq_tmp;
+	struct blasfeo_dvec rq_N, rq_tmp;
+
+	struct blasfeo_driccati_ws ws;
+
+	blasfeo_timer timer;
+
+	printf("\nBLASFEO Riccati recursion benchmark - double precision\n\n");
+	printf("nx\tnu\tN\ttrf [us]\ttrf [Gflops]\texample [us]\texample unfused [us]\ttrs [us]\tsv [us]\t\tresidual trs\tresidual sv\n");
+
+	for(kk=0; kk<n_sizes; kk++)
+		{
+
+		int nx0 = nx_list[kk];
+		int nu0 = nu_list[kk];
+
+		// stage data for the longest horizon: stable dynamics, positive definite cost
+		for(nn=0; nn<=N_MAX; nn++)
+			{
+			nx[nn] = nx0;
+			nu[nn] = nu0;
+			}
+		for(nn=0; nn<N_MAX; nn++)
+			{
+			blasfeo_allocate_dmat(nu0+nx0+1, nx0, &BAbt[nn]);
+			blasfeo_allocate_dvec(nx0, &b[nn]);
+			blasfeo_allocate_dvec(nx0, &pi[nn]);
+			blasfeo_dgese(nu0+nx0+1, nx0, 0.0, &BAbt[nn], 0, 0);
+			for(jj=0; jj<nx0; jj++)
+				{
+				for(ii=0; ii<nu0; ii++)
+					BLASFEO_DMATEL(&BAbt[nn], ii, jj) = 0.1*((ii+2*jj)%5)-0.2;
+				for(ii=0; ii<nx0; ii++)
+					BLASFEO_DMATEL(&BAbt[nn], nu0+ii, jj) = ii==jj ? 0.9 : 0.05*((ii+jj+nn)%3)-0.05;
+				BLASFEO_DVECEL(&b[nn], jj) = 0.01*((jj+nn)%7);
+				}
+			blasfeo_drowin(nx0, 1.0, &b[nn], 0, &BAbt[nn], nu0+nx0, 0);
+			}
+		for(nn=0; nn<=N_MAX; nn++)
+			{
+			int nux = nu[nn]+nx[nn];
+			blasfeo_allocate_dmat(nux+1, nux, &RSQrq[nn]);
+			blasfeo_allocate_dvec(nux, &rq[nn]);
+			blasfeo_allocate_dvec(nux, &ux[nn]);
+			blasfeo_dgese(nux+1, nux, 0.0, &RSQrq[nn], 0, 0);
+			for(ii=0; ii<nux; ii++)
+				{
+				BLASFEO_DMATEL(&RSQrq[nn], ii, ii) = ii<nu[nn] ? 2.0 : 1.0;
+				BLASFEO_DVECEL(&rq[nn], ii) = 0.1*((ii+nn)%4)-0.1;
+				}
+			for(ii=nu[nn]; ii<nux; ii++)
+				for(jj=0; jj<nu[nn]; jj++)
+					BLASFEO_DMATEL(&RSQrq[nn], ii, jj) = 0.01*((ii+jj)%3);
+			blasfeo_drowin(nux, 1.0, &rq[nn], 0, &RSQrq[nn], nux, 0);
+			}
+		// last stage, without inputs
+		blasfeo_allocate_dmat(nx0+1, nx0, &RSQrq_N);
+		blasfeo_allocate_dvec(nx0, &rq_N);
+		blasfeo_dgecp(nx0+1, nx0, &RSQrq[0], nu0, nu0, &RSQrq_N, 0, 0);
+		blasfeo_dveccp(nx0, &rq[0], nu0, &rq_N, 0);
+		blasfeo_allocate_dvec(nu0+nx0, &res);
+
+		for(int N=10; N<=N_MAX; N+=10)
+			{
+
+			// no inputs at the last stage
+			nu[N] = 0;
+			RSQrq_tmp = RSQrq[N];
+			rq_tmp = rq[N];
+			RSQrq[N] = RSQrq_N;
+			rq[N] = rq_N;
+
+			void *ws_mem = malloc(blasfeo_memsize_driccati_ws(N, nx, nu));
+			blasfeo_create_driccati_ws(N, nx, nu, &ws, ws_mem);
+
+			double flop = 0.0;
+			for(nn=0; nn<N; nn++)
+				{
+				double nux = nu[nn]+nx[nn];
+				double nx1 = nx[nn+1];
+				flop += nux*nx1*nx1 + nux*nux*nx1 + nux*nux*nux/3.0;
+				}
+
+			int nrep = 1e8/(flop+1.0);
+			nrep = nrep<10 ? 10 : nrep;
+
+			// factorization
+			blasfeo_tic(&timer);
+			for(rep=0; rep<nrep; rep++)
+				blasfeo_driccati_trf(N, nx, nu, BAbt, RSQrq, &ws);
+			double time_trf = blasfeo_toc(&timer) / nrep;
+
+			// stage sequence of the Riccati example, with fused dsyrk_dpotrf_ln
+			blasfeo_tic(&timer);
+			for(rep=0; rep<nrep; rep++)
+				{
+				blasfeo_dpotrf_l(nu[N]+nx[N], &RSQrq[N], 0, 0, &ws.L[N], 0, 0);
+				for(nn=N-1; nn>=0; nn--)
+					{
+					blasfeo_dtrmm_rlnn(nu[nn]+nx[nn], nx[nn+1], 1.0, &ws.L[nn+1], nu[nn+1], nu[nn+1], &BAbt[nn], 0, 0, ws.AL, 0, 0);
+					blasfeo_dsyrk_dpotrf_ln(nu[nn]+nx[nn], nx[nn+1], ws.AL, 0, 0, ws.AL, 0, 0, &RSQrq[nn], 0, 0, &ws.L[nn], 0, 0);
+					}
+				}
+			double time_ex = blasfeo_toc(&timer) / nrep;
+
+			// stage sequence of the Riccati example, with separate dsyrk_ln and dpotrf_l
+			blasfeo_tic(&timer);
+			for(rep=0; rep<nrep; rep++)
+				{
+				blasfeo_dpotrf_l(nu[N]+nx[N], &RSQrq[N], 0, 0, &ws.L[N], 0, 0);
+				for(nn=N-1; nn>=0; nn--)
+					{
+					blasfeo_dtrmm_rlnn(nu[nn]+nx[nn], nx[nn+1], 1.0, &ws.L[nn+1], nu[nn+1], nu[nn+1], &BAbt[nn], 0, 0, ws.AL, 0, 0);
+					blasfeo_dsyrk_ln(nu[nn]+nx[nn], nx[nn+1], 1.0, ws.AL, 0, 0, ws.AL, 0, 0, 1.0, &RSQrq[nn], 0, 0, &ws.L[nn], 0, 0);
+					blasfeo_dpotrf_l(nu[nn]+nx[nn], &ws.L[nn], 0, 0, &ws.L[nn], 0, 0);
+					}
+				}
+			double time_ex_unf = blasfeo_toc(&timer) / nrep;
+
+			// solution
+			blasfeo_tic(&timer);
+			for(rep=0; rep<nrep; rep++)
+				blasfeo_driccati_trs(N, nx, nu, BAbt, b, rq, ux, pi, &ws);
+			double time_trs = blasfeo_toc(&timer) / nrep;
+			double res_trs = kkt_residual(N, nx, nu, BAbt, RSQrq, b, rq, ux, pi, &res);
+
+			// fused factorization and solution
+			blasfeo_tic(&timer);
+			for(rep=0; rep<nrep; rep++)
+				blasfeo_driccati_sv(N, nx, nu, BAbt, RSQrq, ux, pi, &ws);
+			double time_sv = blasfeo_toc(&timer) / nrep;
+			double res_sv = kkt_residual(N, nx, nu, BAbt, RSQrq, b, rq, ux, pi, &res);
+
+			printf("%d\t%d\t%d\t%e\t%e\t%e\t%e\t%e\t%e\t%e\t%e\n", nx0, nu0, N, 1e6*time_trf, 1e-9*flop/time_trf, 1e6*time_ex, 1e6*time_ex_unf, 1e6*time_trs, 1e6*time_sv, res_trs, res_sv);
+
+			free(ws_mem);
+			nu[N] = nu0;
+			RSQrq[N] = RSQrq_tmp;
+			rq[N] = rq_tmp;
+
+			}
+
+		for(nn=0; nn<N_MAX; nn++)
+			{
+			blasfeo_free_dmat(&BAbt[nn]);
+			blasfeo_free_dvec(&b[nn]);
+			blasfeo_free_dvec(&pi[nn]);
+			}
+		for(nn=0; nn<=N_MAX; nn++)
+			{
+			blasfeo_free_dmat(&RSQrq[nn]);
+			blasfeo_free_dvec(&rq[nn]);
+			blasfeo_free_dvec(&ux[nn]);
+			}
+		blasfeo_free_dmat(&RSQrq_N);
+		blasfeo_free_dvec(&rq_N);
+		blasfeo_free_dvec(&res);
+
+		printf("\n");
+
+		}
+
+	return 0;
+
+	}
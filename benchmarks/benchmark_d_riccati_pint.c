@@ -0,0 +1,262 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2019 by Gianluca Frison.                                                          *
+* Developed at IMTEK (University of Freiburg) under the supervision of Moritz Diehl.              *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+
+// Parallel-in-time Riccati recursion benchmark: blasfeo_driccati_pint_sv against the sequential blasfeo_driccati_sv
+// for long horizons N, on 1, 2, ..., 8, 16, ... threads up to the number set by BLASFEO_NUM_THREADS (with MULTITHREAD);
+// the crossover is the smallest number of threads for which pint_sv is faster than sv.
+// The KKT residual of the solution and the distance from the sequential one are reported as a check
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#include <blasfeo.h>
+
+
+
+#define N_MAX 2000
+
+
+
+// max KKT residual (dynamics and stationarity) of ux, pi
+static double kkt_residual(int N, int *nx, int *nu, struct blasfeo_dmat *BAbt, struct blasfeo_dmat *RSQrq, struct blasfeo_dvec *b, struct blasfeo_dvec *rq, struct blasfeo_dvec *ux, struct blasfeo_dvec *pi, struct blasfeo_dvec *res)
+	{
+	int nn;
+	double nrm, res_max = 0.0;
+	for(nn=0; nn<=N; nn++)
+		{
+		// stationarity
+		blasfeo_dsymv_l(nu[nn]+nx[nn], 1.0, &RSQrq[nn], 0, 0, &ux[nn], 0, 1.0, &rq[nn], 0, res, 0);
+		if(nn<N)
+			blasfeo_dgemv_n(nu[nn]+nx[nn], nx[nn+1], 1.0, &BAbt[nn], 0, 0, &pi[nn], 0, 1.0, res, 0, res, 0);
+		if(nn>0)
+			blasfeo_daxpy(nx[nn], -1.0, &pi[nn-1], 0, res, nu[nn], res, nu[nn]);
+		blasfeo_dvecnrm_inf(nu[nn]+nx[nn], res, 0, &nrm);
+		res_max = nrm>res_max ? nrm : res_max;
+		// dynamics
+		if(nn<N)
+			{
+			blasfeo_dgemv_t(nu[nn]+nx[nn], nx[nn+1], 1.0, &BAbt[nn], 0, 0, &ux[nn], 0, 1.0, &b[nn], 0, res, 0);
+			blasfeo_daxpy(nx[nn+1], -1.0, &ux[nn+1], nu[nn+1], res, 0, res, 0);
+			blasfeo_dvecnrm_inf(nx[nn+1], res, 0, &nrm);
+			res_max = nrm>res_max ? nrm : res_max;
+			}
+		}
+	return res_max;
+	}
+
+
+
+int main()
+	{
+
+	int ii, jj, nn, kk, rep, nt;
+
+	int nx_list[] = {4, 8, 16};
+	int nu_list[] = {2, 3, 8};
+	int n_sizes = sizeof(nx_list)/sizeof(int);
+	int N_list[] = {100, 500, 2000};
+	int n_N = sizeof(N_list)/sizeof(int);
+
+	int nt_max = blasfeo_get_num_threads();
+
+	int nx[N_MAX+1];
+	int nu[N_MAX+1];
+
+	struct blasfeo_dmat BAbt[N_MAX];
+	struct blasfeo_dmat RSQrq[N_MAX+1];
+	struct blasfeo_dvec b[N_MAX];
+	struct blasfeo_dvec rq[N_MAX+1];
+	struct blasfeo_dvec ux[N_MAX+1];
+	struct blasfeo_dvec ux_seq[N_MAX+1];
+	struct blasfeo_dvec pi[N_MAX];
+	struct blasfeo_dvec res;
+	struct blasfeo_dmat RSQrq_N, RSQrq_tmp;
+	struct blasfeo_dvec rq_N, rq_tmp;
+
+	struct blasfeo_driccati_ws ws;
+	struct blasfeo_driccati_pint_ws pint_ws;
+
+	blasfeo_timer timer;
+
+	printf("\nBLASFEO parallel-in-time Riccati recursion benchmark - double precision\n\n");
+	printf("nx\tnu\tN\tthreads\tsv [us]\t\tpint_sv [us]\tspeedup\t\tresidual\tdistance\n");
+
+	for(kk=0; kk<n_sizes; kk++)
+		{
+
+		int nx0 = nx_list[kk];
+		int nu0 = nu_list[kk];
+
+		// stage data for the longest horizon: stable dynamics, positive definite cost
+		for(nn=0; nn<=N_MAX; nn++)
+			{
+			nx[nn] = nx0;
+			nu[nn] = nu0;
+			}
+		for(nn=0; nn<N_MAX; nn++)
+			{
+			blasfeo_allocate_dmat(nu0+nx0+1, nx0, &BAbt[nn]);
+			blasfeo_allocate_dvec(nx0, &b[nn]);
+			blasfeo_allocate_dvec(nx0, &pi[nn]);
+			blasfeo_dgese(nu0+nx0+1, nx0, 0.0, &BAbt[nn], 0, 0);
+			for(jj=0; jj<nx0; jj++)
+				{
+				for(ii=0; ii<nu0; ii++)
+					BLASFEO_DMATEL(&BAbt[nn], ii, jj) = 0.1*((ii+2*jj)%5)-0.2;
+				for(ii=0; ii<nx0; ii++)
+					BLASFEO_DMATEL(&BAbt[nn], nu0+ii, jj) = ii==jj ? 0.9 : 0.05*((ii+jj+nn)%3)-0.05;
+				BLASFEO_DVECEL(&b[nn], jj) = 0.01*((jj+nn)%7);
+				}
+			blasfeo_drowin(nx0, 1.0, &b[nn], 0, &BAbt[nn], nu0+nx0, 0);
+			}
+		for(nn=0; nn<=N_MAX; nn++)
+			{
+			int nux = nu[nn]+nx[nn];
+			blasfeo_allocate_dmat(nux+1, nux, &RSQrq[nn]);
+			blasfeo_allocate_dvec(nux, &rq[nn]);
+			blasfeo_allocate_dvec(nux, &ux[nn]);
+			blasfeo_allocate_dvec(nux, &ux_seq[nn]);
+			blasfeo_dgese(nux+1, nux, 0.0, &RSQrq[nn], 0, 0);
+			for(ii=0; ii<nux; ii++)
+				{
+				BLASFEO_DMATEL(&RSQrq[nn], ii, ii) = ii<nu[nn] ? 2.0 : 1.0;
+				BLASFEO_DVECEL(&rq[nn], ii) = 0.1*((ii+nn)%4)-0.1;
+				}
+			for(ii=nu[nn]; ii<nux; ii++)
+				for(jj=0; jj<nu[nn]; jj++)
+					BLASFEO_DMATEL(&RSQrq[nn], ii, jj) = 0.01*((ii+jj)%3);
+			blasfeo_drowin(nux, 1.0, &rq[nn], 0, &RSQrq[nn], nux, 0);
+			}
+		// last stage, without inputs
+		blasfeo_allocate_dmat(nx0+1, nx0, &RSQrq_N);
+		blasfeo_allocate_dvec(nx0, &rq_N);
+		blasfeo_dgecp(nx0+1, nx0, &RSQrq[0], nu0, nu0, &RSQrq_N, 0, 0);
+		blasfeo_dveccp(nx0, &rq[0], nu0, &rq_N, 0);
+		blasfeo_allocate_dvec(nu0+nx0, &res);
+
+		for(int iN=0; iN<n_N; iN++)
+			{
+
+			int N = N_list[iN];
+
+			// no inputs at the last stage
+			nu[N] = 0;
+			RSQrq_tmp = RSQrq[N];
+			rq_tmp = rq[N];
+			RSQrq[N] = RSQrq_N;
+			rq[N] = rq_N;
+
+			void *ws_mem = malloc(blasfeo_memsize_driccati_ws(N, nx, nu));
+			blasfeo_create_driccati_ws(N, nx, nu, &ws, ws_mem);
+			void *pint_ws_mem = malloc(blasfeo_memsize_driccati_pint_ws(N, nx, nu));
+			blasfeo_create_driccati_pint_ws(N, nx, nu, &pint_ws, pint_ws_mem);
+
+			double flop = 0.0;
+			for(nn=0; nn<N; nn++)
+				{
+				double nux = nu[nn]+nx[nn];
+				double nx1 = nx[nn+1];
+				flop += nux*nx1*nx1 + nux*nux*nx1 + nux*nux*nux/3.0;
+				}
+
+			int nrep = 1e8/(flop+1.0);
+			nrep = nrep<5 ? 5 : nrep;
+
+			// sequential recursion
+			blasfeo_tic(&timer);
+			for(rep=0; rep<nrep; rep++)
+				blasfeo_driccati_sv(N, nx, nu, BAbt, RSQrq, ux_seq, pi, &ws);
+			double time_sv = blasfeo_toc(&timer) / nrep;
+
+			// parallel-in-time recursion
+			int nt_cross = 0;
+			for(nt=1; nt<=nt_max; nt+=(nt<8 ? 1 : nt))
+				{
+				blasfeo_set_num_threads(nt);
+				blasfeo_tic(&timer);
+				for(rep=0; rep<nrep; rep++)
+					blasfeo_driccati_pint_sv(N, nx, nu, BAbt, RSQrq, ux, pi, &pint_ws);
+				double time_pint = blasfeo_toc(&timer) / nrep;
+				double res_pint = kkt_residual(N, nx, nu, BAbt, RSQrq, b, rq, ux, pi, &res);
+				double dist = 0.0, nrm;
+				for(nn=0; nn<=N; nn++)
+					{
+					blasfeo_daxpy(nu[nn]+nx[nn], -1.0, &ux_seq[nn], 0, &ux[nn], 0, &res, 0);
+					blasfeo_dvecnrm_inf(nu[nn]+nx[nn], &res, 0, &nrm);
+					dist = nrm>dist ? nrm : dist;
+					}
+				printf("%d\t%d\t%d\t%d\t%e\t%e\t%e\t%e\t%e\n", nx0, nu0, N, nt, 1e6*time_sv, 1e6*time_pint, time_sv/time_pint, res_pint, dist);
+				if(nt_cross==0 && time_pint<time_sv)
+					nt_cross = nt;
+				}
+			if(nt_cross>0)
+				printf("crossover at %d threads\n", nt_cross);
+			else
+				printf("no crossover up to %d threads\n", nt_max);
+			blasfeo_set_num_threads(nt_max);
+
+			free(ws_mem);
+			free(pint_ws_mem);
+			nu[N] = nu0;
+			RSQrq[N] = RSQrq_tmp;
+			rq[N] = rq_tmp;
+
+			}
+
+		for(nn=0; nn<N_MAX; nn++)
+			{
+			blasfeo_free_dmat(&BAbt[nn]);
+			blasfeo_free_dvec(&b[nn]);
+			blasfeo_free_dvec(&pi[nn]);
+			}
+		for(nn=0; nn<=N_MAX; nn++)
+			{
+			blasfeo_free_dmat(&RSQrq[nn]);
+			blasfeo_free_dvec(&rq[nn]);
+			blasfeo_free_dvec(&ux[nn]);
+			blasfeo_free_dvec(&ux_seq[nn]);
+			}
+		blasfeo_free_dmat(&RSQrq_N);
+		blasfeo_free_dvec(&rq_N);
+		blasfeo_free_dvec(&res);
+
+		printf("\n");
+
+		}
+
+	return 0;
+
+	}
@@ -0,0 +1,250 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2019 by Gianluca Frison.                                                          *
+* Developed at IMTEK (University of Freiburg) under the supervision of Moritz Diehl.              *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+
+// Tree Riccati recursion benchmark: factorization (blasfeo_driccati_tree_trf) and solution (blasfeo_driccati_tree_trs)
+// of the scenario tree of robust MPC, with branching factor nr for the first Nr stages and horizon N, on 1, 2, 4, ...
+// threads up to the number set by BLASFEO_NUM_THREADS (with MULTITHREAD); the KKT residual of the solution is reported
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#include <blasfeo.h>
+
+
+
+#define NN_MAX 4000
+
+
+
+// scenario tree: each node branches into nr children up to depth Nr, then each scenario goes on as a chain up to depth N
+static int scenario_tree(int N, int Nr, int nr, int *parent, int *depth)
+	{
+	int ii, jj, Nn = 1, n0 = 0, n1;
+	parent[0] = -1;
+	depth[0] = 0;
+	while(1)
+		{
+		n1 = Nn;
+		for(ii=n0; ii<n1; ii++)
+			{
+			if(depth[ii]==N)
+				continue;
+			int nkids = depth[ii]<Nr ? nr : 1;
+			for(jj=0; jj<nkids; jj++)
+				{
+				parent[Nn] = ii;
+				depth[Nn] = depth[ii]+1;
+				Nn++;
+				}
+			}
+		if(Nn==n1)
+			break;
+		n0 = n1;
+		}
+	return Nn;
+	}
+
+
+
+// max KKT residual (dynamics and stationarity) of ux, pi
+static double kkt_residual(int Nn, int *parent, int *nx, int *nu, struct blasfeo_dmat *BAbt, struct blasfeo_dmat *RSQrq, struct blasfeo_dvec *b, struct blasfeo_dvec *rq, struct blasfeo_dvec *ux, struct blasfeo_dvec *pi, struct blasfeo_dvec *res, struct blasfeo_dvec *res_p)
+	{
+	int ii, p;
+	double nrm, res_max = 0.0;
+	// stationarity, accumulated into res_p of each node
+	for(ii=0; ii<Nn; ii++)
+		{
+		blasfeo_dsymv_l(nu[ii]+nx[ii], 1.0, &RSQrq[ii], 0, 0, &ux[ii], 0, 1.0, &rq[ii], 0, &res_p[ii], 0);
+		if(parent[ii]>=0)
+			blasfeo_daxpy(nx[ii], -1.0, &pi[ii], 0, &res_p[ii], nu[ii], &res_p[ii], nu[ii]);
+		}
+	for(ii=0; ii<Nn; ii++)
+		{
+		p = parent[ii];
+		if(p<0)
+			continue;
+		blasfeo_dgemv_n(nu[p]+nx[p], nx[ii], 1.0, &BAbt[ii], 0, 0, &pi[ii], 0, 1.0, &res_p[p], 0, &res_p[p], 0);
+		// dynamics
+		blasfeo_dgemv_t(nu[p]+nx[p], nx[ii], 1.0, &BAbt[ii], 0, 0, &ux[p], 0, 1.0, &b[ii], 0, res, 0);
+		blasfeo_daxpy(nx[ii], -1.0, &ux[ii], nu[ii], res, 0, res, 0);
+		blasfeo_dvecnrm_inf(nx[ii], res, 0, &nrm);
+		res_max = nrm>res_max ? nrm : res_max;
+		}
+	for(ii=0; ii<Nn; ii++)
+		{
+		blasfeo_dvecnrm_inf(nu[ii]+nx[ii], &res_p[ii], 0, &nrm);
+		res_max = nrm>res_max ? nrm : res_max;
+		}
+	return res_max;
+	}
+
+
+
+int main()
+	{
+
+	int ii, jj, kk, it, rep, nt;
+
+	int nx0 = 8;
+	int nu0 = 3;
+	int N = 20;
+	int Nr = 3;
+	int nr_list[] = {1, 2, 3, 4, 6};
+	int n_nr = sizeof(nr_list)/sizeof(int);
+
+	int nt_max = blasfeo_get_num_threads();
+
+	static int parent[NN_MAX], depth[NN_MAX], nx[NN_MAX], nu[NN_MAX];
+	static struct blasfeo_dmat BAbt[NN_MAX], RSQrq[NN_MAX];
+	static struct blasfeo_dvec b[NN_MAX], rq[NN_MAX], ux[NN_MAX], pi[NN_MAX], res_p[NN_MAX];
+	struct blasfeo_dvec res;
+	struct blasfeo_driccati_tree_ws ws;
+
+	blasfeo_timer timer;
+
+	blasfeo_allocate_dvec(nx0, &res);
+
+	printf("\nBLASFEO tree Riccati recursion benchmark - double precision\n\n");
+	printf("nx %d, nu %d, horizon %d, robust horizon %d\n\n", nx0, nu0, N, Nr);
+	printf("nr\tnodes\tthreads\ttrf [us]\ttrs [us]\ttrf speedup\tresidual\n");
+
+	for(it=0; it<n_nr; it++)
+		{
+
+		int nr = nr_list[it];
+		int Nn = scenario_tree(N, Nr, nr, parent, depth);
+
+		for(ii=0; ii<Nn; ii++)
+			{
+			nx[ii] = nx0;
+			nu[ii] = depth[ii]==N ? 0 : nu0;
+			}
+
+		// stable dynamics, positive definite cost
+		for(ii=0; ii<Nn; ii++)
+			{
+			int nux = nu[ii]+nx[ii];
+			blasfeo_allocate_dmat(nux+1, nux, &RSQrq[ii]);
+			blasfeo_allocate_dvec(nux, &rq[ii]);
+			blasfeo_allocate_dvec(nux, &ux[ii]);
+			blasfeo_allocate_dvec(nux, &res_p[ii]);
+			blasfeo_dgese(nux+1, nux, 0.0, &RSQrq[ii], 0, 0);
+			for(jj=0; jj<nux; jj++)
+				{
+				BLASFEO_DMATEL(&RSQrq[ii], jj, jj) = jj<nu[ii] ? 2.0 : 1.0;
+				BLASFEO_DVECEL(&rq[ii], jj) = 0.1*((jj+ii)%4)-0.1;
+				}
+			int p = parent[ii];
+			if(p<0)
+				continue;
+			blasfeo_allocate_dmat(nu[p]+nx[p]+1, nx[ii], &BAbt[ii]);
+			blasfeo_allocate_dvec(nx[ii], &b[ii]);
+			blasfeo_allocate_dvec(nx[ii], &pi[ii]);
+			blasfeo_dgese(nu[p]+nx[p]+1, nx[ii], 0.0, &BAbt[ii], 0, 0);
+			for(jj=0; jj<nx[ii]; jj++)
+				{
+				// each scenario has its own input matrix
+				for(kk=0; kk<nu[p]; kk++)
+					BLASFEO_DMATEL(&BAbt[ii], kk, jj) = 0.1*((kk+2*jj+ii)%5)-0.2;
+				for(kk=0; kk<nx[p]; kk++)
+					BLASFEO_DMATEL(&BAbt[ii], nu[p]+kk, jj) = kk==jj ? 0.9 : 0.05*((kk+jj)%3)-0.05;
+				BLASFEO_DVECEL(&b[ii], jj) = 0.01*((jj+ii)%7);
+				}
+			}
+
+		void *ws_mem = malloc(blasfeo_memsize_driccati_tree_ws(Nn, nx, nu));
+		blasfeo_create_driccati_tree_ws(Nn, parent, nx, nu, &ws, ws_mem);
+
+		double flop = 0.0;
+		for(ii=0; ii<Nn; ii++)
+			{
+			int p = parent[ii];
+			double nux = nu[ii]+nx[ii];
+			flop += nux*nux*nux/3.0;
+			if(p>=0)
+				flop += (nu[p]+nx[p])*(double)nx[ii]*nx[ii] + (nu[p]+nx[p])*(double)(nu[p]+nx[p])*nx[ii];
+			}
+
+		int nrep = 1e8/(flop+1.0);
+		nrep = nrep<10 ? 10 : nrep;
+
+		double time_trf_1 = 0.0;
+		for(nt=1; nt<=nt_max; nt*=2)
+			{
+			blasfeo_set_num_threads(nt);
+
+			blasfeo_tic(&timer);
+			for(rep=0; rep<nrep; rep++)
+				blasfeo_driccati_tree_trf(Nn, nx, nu, BAbt, RSQrq, &ws);
+			double time_trf = blasfeo_toc(&timer) / nrep;
+			if(nt==1)
+				time_trf_1 = time_trf;
+
+			blasfeo_tic(&timer);
+			for(rep=0; rep<nrep; rep++)
+				blasfeo_driccati_tree_trs(Nn, nx, nu, BAbt, b, rq, ux, pi, &ws);
+			double time_trs = blasfeo_toc(&timer) / nrep;
+
+			double res_trs = kkt_residual(Nn, parent, nx, nu, BAbt, RSQrq, b, rq, ux, pi, &res, res_p);
+
+			printf("%d\t%d\t%d\t%e\t%e\t%e\t%e\n", nr, Nn, nt, 1e6*time_trf, 1e6*time_trs, time_trf_1/time_trf, res_trs);
+			}
+		blasfeo_set_num_threads(nt_max);
+
+		free(ws_mem);
+		for(ii=0; ii<Nn; ii++)
+			{
+			blasfeo_free_dmat(&RSQrq[ii]);
+			blasfeo_free_dvec(&rq[ii]);
+			blasfeo_free_dvec(&ux[ii]);
+			blasfeo_free_dvec(&res_p[ii]);
+			if(parent[ii]>=0)
+				{
+				blasfeo_free_dmat(&BAbt[ii]);
+				blasfeo_free_dvec(&b[ii]);
+				blasfeo_free_dvec(&pi[ii]);
+				}
+			}
+
+		printf("\n");
+
+		}
+
+	blasfeo_free_dvec(&res);
+
+	return 0;
+
+	}
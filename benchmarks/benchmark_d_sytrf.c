@@ -0,0 +1,169 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2019 by Gianluca Frison.                                                          *
+* Developed at IMTEK (University of Freiburg) under the supervision of Moritz Diehl.              *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+
+// symmetric indefinite factorization benchmark: LDL^T with Bunch-Kaufman pivoting (blasfeo_dsytrf_l)
+// and without pivoting (blasfeo_dsytrf_l_nopiv) against LU with row pivoting (blasfeo_dgetrf_rp)
+// on KKT matrices [H A^T; A -delta*I] of size n, and against Cholesky (blasfeo_dpotrf_l) on a
+// positive definite matrix of the same size; the residuals of the solutions computed by
+// blasfeo_dsytrs_l and blasfeo_dsytrs_l_nopiv are reported as a check
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#include <blasfeo.h>
+
+
+
+int main()
+	{
+
+	int ii, jj, rep;
+
+	int n_list[] = {50, 100, 200, 300, 400, 600, 800, 1000, 1200, 1600, 2000};
+	int n_sizes = sizeof(n_list)/sizeof(int);
+
+	blasfeo_timer timer;
+
+	printf("\nBLASFEO symmetric indefinite factorization benchmark - double precision\n\n");
+	printf("n\tsytrf [us]\tsytrf [Gflops]\tgetrf [us]\tgetrf [Gflops]\tspeedup\t\tnopiv [us]\tnopiv [Gflops]\tpotrf [us]\tpotrf [Gflops]\tresidual sytrs\tresidual nopiv\n");
+
+	for(int kk=0; kk<n_sizes; kk++)
+		{
+
+		int n = n_list[kk];
+		// primal and dual variables
+		int nv = 2*n/3;
+		int ne = n-nv;
+
+		struct blasfeo_dmat K, P, LD, LU;
+		struct blasfeo_dvec b, x, res;
+		blasfeo_allocate_dmat(n, n, &K);
+		blasfeo_allocate_dmat(n, n, &P);
+		blasfeo_allocate_dmat(n, n, &LD);
+		blasfeo_allocate_dmat(n, n, &LU);
+		blasfeo_allocate_dvec(n, &b);
+		blasfeo_allocate_dvec(n, &x);
+		blasfeo_allocate_dvec(n, &res);
+		int *ipiv = malloc(n*sizeof(int));
+
+		// KKT matrix: positive definite Hessian, full row rank constraint Jacobian, small regularization
+		blasfeo_dgese(n, n, 0.0, &K, 0, 0);
+		for(jj=0; jj<nv; jj++)
+			{
+			for(ii=jj; ii<nv; ii++)
+				BLASFEO_DMATEL(&K, ii, jj) = ii==jj ? 2.0+0.01*(ii%7) : 0.1*((ii+2*jj)%5)/(1.0+ii-jj);
+			for(ii=0; ii<ne; ii++)
+				BLASFEO_DMATEL(&K, nv+ii, jj) = (ii==jj%ne ? 1.0 : 0.0) + 0.05*((3*ii+jj)%7)-0.15;
+			}
+		for(ii=0; ii<ne; ii++)
+			BLASFEO_DMATEL(&K, nv+ii, nv+ii) = -1e-8;
+		// full matrix for the LU factorization
+		blasfeo_dtrtr_l(n, &K, 0, 0, &K, 0, 0);
+		for(ii=0; ii<n; ii++)
+			BLASFEO_DVECEL(&b, ii) = 0.1*(ii%4)-0.1;
+		// diagonally dominant matrix for the Cholesky factorization
+		blasfeo_dgecp(n, n, &K, 0, 0, &P, 0, 0);
+		for(ii=0; ii<n; ii++)
+			BLASFEO_DMATEL(&P, ii, ii) = n;
+
+		double flop_sytrf = 1.0/3.0*n*n*n;
+		double flop_getrf = 2.0/3.0*n*n*n;
+
+		int nrep = 1e9/(flop_getrf+1.0);
+		nrep = nrep<3 ? 3 : nrep;
+
+		// LDL^T
+		blasfeo_tic(&timer);
+		for(rep=0; rep<nrep; rep++)
+			blasfeo_dsytrf_l(n, &K, 0, 0, &LD, 0, 0, ipiv);
+		double time_sytrf = blasfeo_toc(&timer) / nrep;
+
+		// LU
+		blasfeo_tic(&timer);
+		for(rep=0; rep<nrep; rep++)
+			blasfeo_dgetrf_rp(n, n, &K, 0, 0, &LU, 0, 0, ipiv);
+		double time_getrf = blasfeo_toc(&timer) / nrep;
+
+		// LDL^T without pivoting
+		blasfeo_tic(&timer);
+		for(rep=0; rep<nrep; rep++)
+			blasfeo_dsytrf_l_nopiv(n, &K, 0, 0, &LD, 0, 0);
+		double time_nopiv = blasfeo_toc(&timer) / nrep;
+
+		// Cholesky
+		blasfeo_tic(&timer);
+		for(rep=0; rep<nrep; rep++)
+			blasfeo_dpotrf_l(n, &P, 0, 0, &LU, 0, 0);
+		double time_potrf = blasfeo_toc(&timer) / nrep;
+
+		// solution with the LDL^T factorization without pivoting, and its residual
+		blasfeo_dsytrf_l_nopiv(n, &K, 0, 0, &LD, 0, 0);
+		for(ii=0; ii<n; ii++)
+			BLASFEO_DMATEL(&LU, ii, 0) = BLASFEO_DVECEL(&b, ii);
+		blasfeo_dsytrs_l_nopiv(n, 1, &LD, 0, 0, &LU, 0, 0, &LU, 0, 0);
+		blasfeo_dcolex(n, &LU, 0, 0, &x, 0);
+		blasfeo_dgemv_n(n, n, 1.0, &K, 0, 0, &x, 0, -1.0, &b, 0, &res, 0);
+		double res_nopiv;
+		blasfeo_dvecnrm_inf(n, &res, 0, &res_nopiv);
+
+		// solution with the LDL^T factorization, and its residual
+		blasfeo_dsytrf_l(n, &K, 0, 0, &LD, 0, 0, ipiv);
+		for(ii=0; ii<n; ii++)
+			BLASFEO_DMATEL(&LU, ii, 0) = BLASFEO_DVECEL(&b, ii);
+		blasfeo_dsytrs_l(n, 1, &LD, 0, 0, ipiv, &LU, 0, 0, &LU, 0, 0);
+		blasfeo_dcolex(n, &LU, 0, 0, &x, 0);
+		blasfeo_dgemv_n(n, n, 1.0, &K, 0, 0, &x, 0, -1.0, &b, 0, &res, 0);
+		double res_sytrs;
+		blasfeo_dvecnrm_inf(n, &res, 0, &res_sytrs);
+
+		printf("%d\t%e\t%e\t%e\t%e\t%e\t%e\t%e\t%e\t%e\t%e\t%e\n", n, 1e6*time_sytrf, 1e-9*flop_sytrf/time_sytrf, 1e6*time_getrf, 1e-9*flop_getrf/time_getrf, time_getrf/time_sytrf, 1e6*time_nopiv, 1e-9*flop_sytrf/time_nopiv, 1e6*time_potrf, 1e-9*flop_sytrf/time_potrf, res_sytrs, res_nopiv);
+
+		blasfeo_free_dmat(&K);
+		blasfeo_free_dmat(&P);
+		blasfeo_free_dmat(&LD);
+		blasfeo_free_dmat(&LU);
+		blasfeo_free_dvec(&b);
+		blasfeo_free_dvec(&x);
+		blasfeo_free_dvec(&res);
+		free(ipiv);
+
+		}
+
+	printf("\n");
+
+	return 0;
+
+	}
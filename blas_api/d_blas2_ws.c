@@ -0,0 +1,119 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2019 by Gianluca Frison.                                                          *
+* Developed at IMTEK (University of Freiburg) under the supervision of Moritz Diehl.              *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+#include <stdlib.h>
+#include <stdio.h>
+
+
+#include <blasfeo_target.h>
+#include <blasfeo_common.h>
+#include <blasfeo_memory.h>
+#include <blasfeo_d_blas.h>
+
+
+
+#if defined(FORTRAN_BLAS_API)
+#define blasfeo_blas_dgemv dgemv_
+#define blasfeo_blas_dsymv dsymv_
+#define blasfeo_blas_dger dger_
+#define blasfeo_blas_dgemv_worksize dgemv_worksize_
+#define blasfeo_blas_dgemv_ws dgemv_ws_
+#define blasfeo_blas_dsymv_worksize dsymv_worksize_
+#define blasfeo_blas_dsymv_ws dsymv_ws_
+#define blasfeo_blas_dger_worksize dger_worksize_
+#define blasfeo_blas_dger_ws dger_ws_
+#endif
+
+
+
+// workspace-argument variants, see d_blas_ws.c
+
+
+
+static int d_ws_max(int a, int b)
+	{
+	return a>b ? a : b;
+	}
+
+
+
+size_t blasfeo_blas_dgemv_worksize(int *m, int *n)
+	{
+	return blasfeo_memsize_workspace(d_ws_max(*m, *n));
+	}
+
+
+
+void blasfeo_blas_dgemv_ws(char *trans, int *m, int *n, double *alpha, double *A, int *lda, double *x, int *incx, double *beta, double *y, int *incy, void *work)
+	{
+	struct blasfeo_workspace_state state;
+	blasfeo_workspace_push(d_ws_max(*m, *n), work, &state);
+	blasfeo_blas_dgemv(trans, m, n, alpha, A, lda, x, incx, beta, y, incy);
+	blasfeo_workspace_pop(&state);
+	}
+
+
+
+size_t blasfeo_blas_dsymv_worksize(int *n)
+	{
+	return blasfeo_memsize_workspace(*n);
+	}
+
+
+
+void blasfeo_blas_dsymv_ws(char *uplo, int *n, double *alpha, double *A, int *lda, double *x, int *incx, double *beta, double *y, int *incy, void *work)
+	{
+	struct blasfeo_workspace_state state;
+	blasfeo_workspace_push(*n, work, &state);
+	blasfeo_blas_dsymv(uplo, n, alpha, A, lda, x, incx, beta, y, incy);
+	blasfeo_workspace_pop(&state);
+	}
+
+
+
+size_t blasfeo_blas_dger_worksize(int *m, int *n)
+	{
+	return blasfeo_memsize_workspace(d_ws_max(*m, *n));
+	}
+
+
+
+void blasfeo_blas_dger_ws(int *m, int *n, double *alpha, double *x, int *incx, double *y, int *incy, double *A, int *lda, void *work)
+	{
+	struct blasfeo_workspace_state state;
+	blasfeo_workspace_push(d_ws_max(*m, *n), work, &state);
+	blasfeo_blas_dger(m, n, alpha, x, incx, y, incy, A, lda);
+	blasfeo_workspace_pop(&state);
+	}
@@ -0,0 +1,265 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2019 by Gianluca Frison.                                                          *
+* Developed at IMTEK (University of Freiburg) under the supervision of Moritz Diehl.              *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+#include <stdlib.h>
+#include <stdio.h>
+
+
+#include <blasfeo_target.h>
+#include <blasfeo_common.h>
+#include <blasfeo_memory.h>
+#include <blasfeo_d_blas.h>
+
+
+
+#if defined(FORTRAN_BLAS_API)
+#define blasfeo_blas_dgemm dgemm_
+#define blasfeo_blas_dsyrk dsyrk_
+#define blasfeo_blas_dtrmm dtrmm_
+#define blasfeo_blas_dtrsm dtrsm_
+#define blasfeo_blas_dsyr2k dsyr2k_
+#define blasfeo_blas_dsymm dsymm_
+#define blasfeo_lapack_dgesv dgesv_
+#define blasfeo_lapack_dgetrf dgetrf_
+#define blasfeo_lapack_dposv dposv_
+#define blasfeo_lapack_dpotrf dpotrf_
+#define blasfeo_blas_dgemm_worksize dgemm_worksize_
+#define blasfeo_blas_dgemm_ws dgemm_ws_
+#define blasfeo_blas_dsyrk_worksize dsyrk_worksize_
+#define blasfeo_blas_dsyrk_ws dsyrk_ws_
+#define blasfeo_blas_dtrmm_worksize dtrmm_worksize_
+#define blasfeo_blas_dtrmm_ws dtrmm_ws_
+#define blasfeo_blas_dtrsm_worksize dtrsm_worksize_
+#define blasfeo_blas_dtrsm_ws dtrsm_ws_
+#define blasfeo_blas_dsyr2k_worksize dsyr2k_worksize_
+#define blasfeo_blas_dsyr2k_ws dsyr2k_ws_
+#define blasfeo_blas_dsymm_worksize dsymm_worksize_
+#define blasfeo_blas_dsymm_ws dsymm_ws_
+#define blasfeo_lapack_dgesv_worksize dgesv_worksize_
+#define blasfeo_lapack_dgesv_ws dgesv_ws_
+#define blasfeo_lapack_dgetrf_worksize dgetrf_worksize_
+#define blasfeo_lapack_dgetrf_ws dgetrf_ws_
+#define blasfeo_lapack_dposv_worksize dposv_worksize_
+#define blasfeo_lapack_dposv_ws dposv_ws_
+#define blasfeo_lapack_dpotrf_worksize dpotrf_worksize_
+#define blasfeo_lapack_dpotrf_ws dpotrf_ws_
+#endif
+
+
+
+// workspace-argument variants (BLAS 2 ones in d_blas2_ws.c): the routine runs in the caller-provided work (of size given by the matching _worksize),
+// bound to the calling thread for the duration of the call only, and does not allocate memory;
+// the previous binding of the calling thread (buffer or workspace) is restored on return
+
+
+
+static int d_ws_max(int a, int b)
+	{
+	return a>b ? a : b;
+	}
+
+
+
+// BLAS 3
+
+size_t blasfeo_blas_dgemm_worksize(int *m, int *n, int *k)
+	{
+	return blasfeo_memsize_workspace(d_ws_max(*m, d_ws_max(*n, *k)));
+	}
+
+
+
+void blasfeo_blas_dgemm_ws(char *ta, char *tb, int *m, int *n, int *k, double *alpha, double *A, int *lda, double *B, int *ldb, double *beta, double *C, int *ldc, void *work)
+	{
+	struct blasfeo_workspace_state state;
+	blasfeo_workspace_push(d_ws_max(*m, d_ws_max(*n, *k)), work, &state);
+	blasfeo_blas_dgemm(ta, tb, m, n, k, alpha, A, lda, B, ldb, beta, C, ldc);
+	blasfeo_workspace_pop(&state);
+	}
+
+
+
+size_t blasfeo_blas_dsyrk_worksize(int *m, int *k)
+	{
+	return blasfeo_memsize_workspace(d_ws_max(*m, *k));
+	}
+
+
+
+void blasfeo_blas_dsyrk_ws(char *uplo, char *ta, int *m, int *k, double *alpha, double *A, int *lda, double *beta, double *C, int *ldc, void *work)
+	{
+	struct blasfeo_workspace_state state;
+	blasfeo_workspace_push(d_ws_max(*m, *k), work, &state);
+	blasfeo_blas_dsyrk(uplo, ta, m, k, alpha, A, lda, beta, C, ldc);
+	blasfeo_workspace_pop(&state);
+	}
+
+
+
+size_t blasfeo_blas_dtrmm_worksize(int *m, int *n)
+	{
+	return blasfeo_memsize_workspace(d_ws_max(*m, *n));
+	}
+
+
+
+void blasfeo_blas_dtrmm_ws(char *side, char *uplo, char *transa, char *diag, int *m, int *n, double *alpha, double *A, int *lda, double *B, int *ldb, void *work)
+	{
+	struct blasfeo_workspace_state state;
+	blasfeo_workspace_push(d_ws_max(*m, *n), work, &state);
+	blasfeo_blas_dtrmm(side, uplo, transa, diag, m, n, alpha, A, lda, B, ldb);
+	blasfeo_workspace_pop(&state);
+	}
+
+
+
+size_t blasfeo_blas_dtrsm_worksize(int *m, int *n)
+	{
+	return blasfeo_memsize_workspace(d_ws_max(*m, *n));
+	}
+
+
+
+void blasfeo_blas_dtrsm_ws(char *side, char *uplo, char *transa, char *diag, int *m, int *n, double *alpha, double *A, int *lda, double *B, int *ldb, void *work)
+	{
+	struct blasfeo_workspace_state state;
+	blasfeo_workspace_push(d_ws_max(*m, *n), work, &state);
+	blasfeo_blas_dtrsm(side, uplo, transa, diag, m, n, alpha, A, lda, B, ldb);
+	blasfeo_workspace_pop(&state);
+	}
+
+
+
+size_t blasfeo_blas_dsyr2k_worksize(int *m, int *k)
+	{
+	return blasfeo_memsize_workspace(d_ws_max(*m, *k));
+	}
+
+
+
+void blasfeo_blas_dsyr2k_ws(char *uplo, char *ta, int *m, int *k, double *alpha, double *A, int *lda, double *B, int *ldb, double *beta, double *C, int *ldc, void *work)
+	{
+	struct blasfeo_workspace_state state;
+	blasfeo_workspace_push(d_ws_max(*m, *k), work, &state);
+	blasfeo_blas_dsyr2k(uplo, ta, m, k, alpha, A, lda, B, ldb, beta, C, ldc);
+	blasfeo_workspace_pop(&state);
+	}
+
+
+
+size_t blasfeo_blas_dsymm_worksize(int *m, int *n)
+	{
+	return blasfeo_memsize_workspace(d_ws_max(*m, *n));
+	}
+
+
+
+void blasfeo_blas_dsymm_ws(char *side, char *uplo, int *m, int *n, double *alpha, double *A, int *lda, double *B, int *ldb, double *beta, double *C, int *ldc, void *work)
+	{
+	struct blasfeo_workspace_state state;
+	blasfeo_workspace_push(d_ws_max(*m, *n), work, &state);
+	blasfeo_blas_dsymm(side, uplo, m, n, alpha, A, lda, B, ldb, beta, C, ldc);
+	blasfeo_workspace_pop(&state);
+	}
+
+
+
+// LAPACK
+
+size_t blasfeo_lapack_dgesv_worksize(int *m, int *n)
+	{
+	return blasfeo_memsize_workspace(d_ws_max(*m, *n));
+	}
+
+
+
+void blasfeo_lapack_dgesv_ws(int *m, int *n, double *A, int *lda, int *ipiv, double *B, int *ldb, int *info, void *work)
+	{
+	struct blasfeo_workspace_state state;
+	blasfeo_workspace_push(d_ws_max(*m, *n), work, &state);
+	blasfeo_lapack_dgesv(m, n, A, lda, ipiv, B, ldb, info);
+	blasfeo_workspace_pop(&state);
+	}
+
+
+
+size_t blasfeo_lapack_dgetrf_worksize(int *m, int *n)
+	{
+	return blasfeo_memsize_workspace(d_ws_max(*m, *n));
+	}
+
+
+
+void blasfeo_lapack_dgetrf_ws(int *m, int *n, double *A, int *lda, int *ipiv, int *info, void *work)
+	{
+	struct blasfeo_workspace_state state;
+	blasfeo_workspace_push(d_ws_max(*m, *n), work, &state);
+	blasfeo_lapack_dgetrf(m, n, A, lda, ipiv, info);
+	blasfeo_workspace_pop(&state);
+	}
+
+
+
+size_t blasfeo_lapack_dposv_worksize(int *m, int *n)
+	{
+	return blasfeo_memsize_workspace(d_ws_max(*m, *n));
+	}
+
+
+
+void blasfeo_lapack_dposv_ws(char *uplo, int *m, int *n, double *A, int *lda, double *B, int *ldb, int *info, void *work)
+	{
+	struct blasfeo_workspace_state state;
+	blasfeo_workspace_push(d_ws_max(*m, *n), work, &state);
+	blasfeo_lapack_dposv(uplo, m, n, A, lda, B, ldb, info);
+	blasfeo_workspace_pop(&state);
+	}
+
+
+
+size_t blasfeo_lapack_dpotrf_worksize(int *m)
+	{
+	return blasfeo_memsize_workspace(*m);
+	}
+
+
+
+void blasfeo_lapack_dpotrf_ws(char *uplo, int *m, double *A, int *lda, int *info, void *work)
+	{
+	struct blasfeo_workspace_state state;
+	blasfeo_workspace_push(*m, work, &state);
+	blasfeo_lapack_dpotrf(uplo, m, A, lda, info);
+	blasfeo_workspace_pop(&state);
+	}
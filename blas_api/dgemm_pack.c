@@ -0,0 +1,210 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2019 by Gianluca Frison.                                                          *
+* Developed at IMTEK (University of Freiburg) under the supervision of Moritz Diehl.              *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+
+#include <stdlib.h>
+#include <stdio.h>
+
+
+#include <blasfeo_target.h>
+#include <blasfeo_common.h>
+#include <blasfeo_align.h>
+#include <blasfeo_d_aux.h>
+#include <blasfeo_d_kernel.h>
+#include <blasfeo_d_blas.h>
+#if defined(LA_HIGH_PERFORMANCE)
+#include <blasfeo_d_blasfeo_hp_api.h>
+#endif
+
+
+
+#if defined(FORTRAN_BLAS_API)
+#define blasfeo_blas_dgemm dgemm_
+#define blasfeo_blas_dgemm_pack_get_size dgemm_pack_get_size_
+#define blasfeo_blas_dgemm_pack dgemm_pack_
+#define blasfeo_blas_dgemm_compute dgemm_compute_
+#endif
+
+
+
+// the packed operand is a 64-byte header holding the sizes of op(A), followed by op(A) itself:
+// panel-major in the high-performance backend, column-major (with leading dimension m) otherwise
+
+
+
+size_t blasfeo_blas_dgemm_pack_get_size(int *pm, int *pk)
+	{
+
+	int m = *pm;
+	int k = *pk;
+
+	if(m<0) m = 0;
+	if(k<0) k = 0;
+
+	size_t size;
+#if defined(LA_HIGH_PERFORMANCE)
+	size = blasfeo_hp_dgemm_pack_memsize(m, k);
+#else
+	size = (size_t) m * k * sizeof(double);
+#endif
+
+	return 64 + 64 + size; // header and alignment
+
+	}
+
+
+
+void blasfeo_blas_dgemm_pack(char *ta, int *pm, int *pk, double *A, int *plda, void *pA)
+	{
+
+#if defined(PRINT_NAME)
+#ifdef EXT_DEP
+	printf("\nblasfeo_blas_dgemm_pack %c %d %d %p %d %p\n", *ta, *pm, *pk, A, *plda, pA);
+#endif
+#endif
+
+	int m = *pm;
+	int k = *pk;
+	int lda = *plda;
+
+	if(m<0) m = 0;
+	if(k<0) k = 0;
+
+	int *header;
+	blasfeo_align_64_byte(pA, (void **) &header);
+	double *pA_data = (double *) (((char *) header) + 64);
+
+	header[0] = m;
+	header[1] = k;
+
+#if defined(LA_HIGH_PERFORMANCE)
+
+	if(*ta=='n' | *ta=='N')
+		{
+		blasfeo_hp_dgemm_pack_n(m, k, A, lda, pA_data);
+		}
+	else if(*ta=='t' | *ta=='T' | *ta=='c' | *ta=='C')
+		{
+		blasfeo_hp_dgemm_pack_t(m, k, A, lda, pA_data);
+		}
+	else
+		{
+#ifdef EXT_DEP
+		printf("\nBLASFEO: dgemm_pack: wrong value for ta\n");
+#endif
+		return;
+		}
+
+#else
+
+	int ii, jj;
+	size_t lda_s = lda;
+	size_t m_s = m;
+
+	if(*ta=='n' | *ta=='N')
+		{
+		for(jj=0; jj<k; jj++)
+			for(ii=0; ii<m; ii++)
+				pA_data[ii+jj*m_s] = A[ii+jj*lda_s];
+		}
+	else if(*ta=='t' | *ta=='T' | *ta=='c' | *ta=='C')
+		{
+		for(jj=0; jj<k; jj++)
+			for(ii=0; ii<m; ii++)
+				pA_data[ii+jj*m_s] = A[jj+ii*lda_s];
+		}
+	else
+		{
+#ifdef EXT_DEP
+		printf("\nBLASFEO: dgemm_pack: wrong value for ta\n");
+#endif
+		return;
+		}
+
+#endif
+
+	return;
+
+	}
+
+
+
+void blasfeo_blas_dgemm_compute(char *tb, int *pn, double *alpha, void *pA, double *B, int *pldb, double *beta, double *C, int *pldc)
+	{
+
+#if defined(PRINT_NAME)
+#ifdef EXT_DEP
+	printf("\nblasfeo_blas_dgemm_compute %c %d %f %p %p %d %f %p %d\n", *tb, *pn, *alpha, pA, B, *pldb, *beta, C, *pldc);
+#endif
+#endif
+
+	int *header;
+	blasfeo_align_64_byte(pA, (void **) &header);
+	double *pA_data = (double *) (((char *) header) + 64);
+
+	int m = header[0];
+	int k = header[1];
+	int n = *pn;
+
+#if defined(LA_HIGH_PERFORMANCE)
+
+	if(*tb=='n' | *tb=='N')
+		{
+		blasfeo_hp_dgemm_packed_nn(m, n, k, *alpha, pA_data, B, *pldb, *beta, C, *pldc, C, *pldc);
+		}
+	else if(*tb=='t' | *tb=='T' | *tb=='c' | *tb=='C')
+		{
+		blasfeo_hp_dgemm_packed_nt(m, n, k, *alpha, pA_data, B, *pldb, *beta, C, *pldc, C, *pldc);
+		}
+	else
+		{
+#ifdef EXT_DEP
+		printf("\nBLASFEO: dgemm_compute: wrong value for tb\n");
+#endif
+		return;
+		}
+
+#else
+
+	char cn = 'n';
+	int ld = m>1 ? m : 1;
+	blasfeo_blas_dgemm(&cn, tb, &m, &n, &k, alpha, pA_data, &ld, B, pldb, beta, C, pldc);
+
+#endif
+
+	return;
+
+	}
+
@@ -0,0 +1,119 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2019 by Gianluca Frison.                                                          *
+* Developed at IMTEK (University of Freiburg) under the supervision of Moritz Diehl.              *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+#include <stdlib.h>
+#include <stdio.h>
+
+
+#include <blasfeo_target.h>
+#include <blasfeo_common.h>
+#include <blasfeo_memory.h>
+#include <blasfeo_s_blas.h>
+
+
+
+#if defined(FORTRAN_BLAS_API)
+#define blasfeo_blas_sgemm sgemm_
+#define blasfeo_blas_strsm strsm_
+#define blasfeo_lapack_spotrf spotrf_
+#define blasfeo_blas_sgemm_worksize sgemm_worksize_
+#define blasfeo_blas_sgemm_ws sgemm_ws_
+#define blasfeo_blas_strsm_worksize strsm_worksize_
+#define blasfeo_blas_strsm_ws strsm_ws_
+#define blasfeo_lapack_spotrf_worksize spotrf_worksize_
+#define blasfeo_lapack_spotrf_ws spotrf_ws_
+#endif
+
+
+
+// workspace-argument variants, see d_blas_ws.c
+
+
+
+static int s_ws_max(int a, int b)
+	{
+	return a>b ? a : b;
+	}
+
+
+
+size_t blasfeo_blas_sgemm_worksize(int *m, int *n, int *k)
+	{
+	return blasfeo_memsize_workspace(s_ws_max(*m, s_ws_max(*n, *k)));
+	}
+
+
+
+void blasfeo_blas_sgemm_ws(char *ta, char *tb, int *m, int *n, int *k, float *alpha, float *A, int *lda, float *B, int *ldb, float *beta, float *C, int *ldc, void *work)
+	{
+	struct blasfeo_workspace_state state;
+	blasfeo_workspace_push(s_ws_max(*m, s_ws_max(*n, *k)), work, &state);
+	blasfeo_blas_sgemm(ta, tb, m, n, k, alpha, A, lda, B, ldb, beta, C, ldc);
+	blasfeo_workspace_pop(&state);
+	}
+
+
+
+size_t blasfeo_blas_strsm_worksize(int *m, int *n)
+	{
+	return blasfeo_memsize_workspace(s_ws_max(*m, *n));
+	}
+
+
+
+void blasfeo_blas_strsm_ws(char *side, char *uplo, char *transa, char *diag, int *m, int *n, float *alpha, float *A, int *lda, float *B, int *ldb, void *work)
+	{
+	struct blasfeo_workspace_state state;
+	blasfeo_workspace_push(s_ws_max(*m, *n), work, &state);
+	blasfeo_blas_strsm(side, uplo, transa, diag, m, n, alpha, A, lda, B, ldb);
+	blasfeo_workspace_pop(&state);
+	}
+
+
+
+size_t blasfeo_lapack_spotrf_worksize(int *m)
+	{
+	return blasfeo_memsize_workspace(*m);
+	}
+
+
+
+void blasfeo_lapack_spotrf_ws(char *uplo, int *m, float *A, int *lda, int *info, void *work)
+	{
+	struct blasfeo_workspace_state state;
+	blasfeo_workspace_push(*m, work, &state);
+	blasfeo_lapack_spotrf(uplo, m, A, lda, info);
+	blasfeo_workspace_pop(&state);
+	}
@@ -37,6 +37,7 @@
 #include <stdio.h>
 
 #include <blasfeo_common.h>
+#include <blasfeo_stdlib.h>
 #include <blasfeo_s_blasfeo_api.h>
 
 
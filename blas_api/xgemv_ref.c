@@ -103,12 +103,9 @@ void GEMV(char *trans, int *pm, int *pn, REAL *alpha, REAL *A, int *plda, REAL *
 		{
 		if(lx>K_MAX_STACK)
 			{
-#ifdef EXT_DEP
-			x = malloc(lx*sizeof(REAL));
-#else
-			// not enough static memory, can't allocate dynamic memory
-			exit(1);
-#endif
+			blasfeo_ws_malloc((void **) &x, lx*sizeof(REAL));
+			if(x==NULL)
+				return;
 			}
 		else
 			{
@@ -132,12 +129,13 @@ void GEMV(char *trans, int *pm, int *pn, REAL *alpha, REAL *A, int *plda, REAL *
 		{
 		if(ly>K_MAX_STACK)
 			{
-#ifdef EXT_DEP
-			y = malloc(ly*sizeof(REAL));
-#else
-			// not enough static memory, can't allocate dynamic memory
-			exit(1);
-#endif
+			blasfeo_ws_malloc((void **) &y, ly*sizeof(REAL));
+			if(y==NULL)
+				{
+				if(incx!=1 & lx>K_MAX_STACK)
+					blasfeo_ws_free(x);
+				return;
+				}
 			}
 		else
 			{
@@ -172,17 +170,6 @@ void GEMV(char *trans, int *pm, int *pn, REAL *alpha, REAL *A, int *plda, REAL *
 		GEMV_T(m, n, *alpha, &sA, 0, 0, &sx, 0, *beta, &sy, 0, &sy, 0);
 		}
 
-	if(incx!=1)
-		{
-		if(lx>K_MAX_STACK)
-			{
-#ifdef EXT_DEP
-			free(x);
-#else
-#endif
-			}
-		}
-
 	if(incy!=1)
 		{
 		for(ii=0; ii<ly; ii++)
@@ -190,10 +177,15 @@ void GEMV(char *trans, int *pm, int *pn, REAL *alpha, REAL *A, int *plda, REAL *
 
 		if(ly>K_MAX_STACK)
 			{
-#ifdef EXT_DEP
-			free(y);
-#else
-#endif
+			blasfeo_ws_free(y);
+			}
+		}
+
+	if(incx!=1)
+		{
+		if(lx>K_MAX_STACK)
+			{
+			blasfeo_ws_free(x);
 			}
 		}
 
@@ -88,12 +88,9 @@ void BLAS_GER(int *pm, int *pn, REAL *alpha, REAL *x0, int *pincx, REAL *y0, int
 		{
 		if(lx>K_MAX_STACK)
 			{
-#ifdef EXT_DEP
-			x = malloc(lx*sizeof(REAL));
-#else
-			// not enough static memory, can't allocate dynamic memory
-			exit(1);
-#endif
+			blasfeo_ws_malloc((void **) &x, lx*sizeof(REAL));
+			if(x==NULL)
+				return;
 			}
 		else
 			{
@@ -117,12 +114,13 @@ void BLAS_GER(int *pm, int *pn, REAL *alpha, REAL *x0, int *pincx, REAL *y0, int
 		{
 		if(ly>K_MAX_STACK)
 			{
-#ifdef EXT_DEP
-			y = malloc(ly*sizeof(REAL));
-#else
-			// not enough static memory, can't allocate dynamic memory
-			exit(1);
-#endif
+			blasfeo_ws_malloc((void **) &y, ly*sizeof(REAL));
+			if(y==NULL)
+				{
+				if(incx!=1 & lx>K_MAX_STACK)
+					blasfeo_ws_free(x);
+				return;
+				}
 			}
 		else
 			{
@@ -150,25 +148,19 @@ void BLAS_GER(int *pm, int *pn, REAL *alpha, REAL *x0, int *pincx, REAL *y0, int
 
 	GER(m, n, *alpha, &sx, 0, &sy, 0, &sA, 0, 0, &sA, 0, 0);
 
-	if(incx!=1)
+	if(incy!=1)
 		{
-		if(lx>K_MAX_STACK)
+		if(ly>K_MAX_STACK)
 			{
-#ifdef EXT_DEP
-			free(x);
-#else
-#endif
+			blasfeo_ws_free(y);
 			}
 		}
 
-	if(incy!=1)
+	if(incx!=1)
 		{
-		if(ly>K_MAX_STACK)
+		if(lx>K_MAX_STACK)
 			{
-#ifdef EXT_DEP
-			free(y);
-#else
-#endif
+			blasfeo_ws_free(x);
 			}
 		}
 
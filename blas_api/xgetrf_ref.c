@@ -67,12 +67,9 @@ void GETRF(int *pm, int *pn, REAL *C, int *pldc, int *ipiv, int *info)
 	REAL *dC;
 	if(p>K_MAX_STACK)
 		{
-#ifdef EXT_DEP
-		dC = (REAL *) malloc(p*sizeof(REAL));
-#else
-		// not enough static memory, can't allocate dynamic memory
-		exit(1);
-#endif
+		blasfeo_ws_malloc((void **) &dC, p*sizeof(REAL));
+		if(dC==NULL)
+			return;
 		}
 	else
 		{
@@ -92,10 +89,7 @@ void GETRF(int *pm, int *pn, REAL *C, int *pldc, int *ipiv, int *info)
 
 	if(p>K_MAX_STACK)
 		{
-#ifdef EXT_DEP
-		free(dC);
-#else
-#endif
+		blasfeo_ws_free(dC);
 		}
 
 	// from 0-based to 1-based
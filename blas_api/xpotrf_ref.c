@@ -67,12 +67,9 @@ void POTRF(char *uplo, int *pm, REAL *C, int *pldc, int *info)
 	REAL *dC;
 	if(*pm>K_MAX_STACK)
 		{
-#ifdef EXT_DEP
-		dC = (REAL *) malloc(*pm*sizeof(REAL));
-#else
-		// not enough static memory, can't allocate dynamic memory
-		exit(1);
-#endif
+		blasfeo_ws_malloc((void **) &dC, *pm*sizeof(REAL));
+		if(dC==NULL)
+			return;
 		}
 	else
 		{
@@ -99,10 +96,7 @@ void POTRF(char *uplo, int *pm, REAL *C, int *pldc, int *info)
 
 	if(*pm>K_MAX_STACK)
 		{
-#ifdef EXT_DEP
-		free(dC);
-#else
-#endif
+		blasfeo_ws_free(dC);
 		}
 
 	*info = 0;
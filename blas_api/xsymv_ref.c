@@ -90,12 +90,9 @@ void SYMV(char *uplo, int *pn, REAL *alpha, REAL *A, int *plda, REAL *x0, int *p
 		{
 		if(n>K_MAX_STACK)
 			{
-#ifdef EXT_DEP
-			x = malloc(n*sizeof(REAL));
-#else
-			// not enough static memory, can't allocate dynamic memory
-			exit(1);
-#endif
+			blasfeo_ws_malloc((void **) &x, n*sizeof(REAL));
+			if(x==NULL)
+				return;
 			}
 		else
 			{
@@ -119,12 +116,13 @@ void SYMV(char *uplo, int *pn, REAL *alpha, REAL *A, int *plda, REAL *x0, int *p
 		{
 		if(n>K_MAX_STACK)
 			{
-#ifdef EXT_DEP
-			y = malloc(n*sizeof(REAL));
-#else
-			// not enough static memory, can't allocate dynamic memory
-			exit(1);
-#endif
+			blasfeo_ws_malloc((void **) &y, n*sizeof(REAL));
+			if(y==NULL)
+				{
+				if(incx!=1 & n>K_MAX_STACK)
+					blasfeo_ws_free(x);
+				return;
+				}
 			}
 		else
 			{
@@ -159,28 +157,22 @@ void SYMV(char *uplo, int *pn, REAL *alpha, REAL *A, int *plda, REAL *x0, int *p
 		SYMV_U(n, *alpha, &sA, 0, 0, &sx, 0, *beta, &sy, 0, &sy, 0);
 		}
 
-	if(incx!=1)
+	if(incy!=1)
 		{
+		for(ii=0; ii<n; ii++)
+			y0[ky + ii*incy] = y[ii];
+
 		if(n>K_MAX_STACK)
 			{
-#ifdef EXT_DEP
-			free(x);
-#else
-#endif
+			blasfeo_ws_free(y);
 			}
 		}
 
-	if(incy!=1)
+	if(incx!=1)
 		{
-		for(ii=0; ii<n; ii++)
-			y0[ky + ii*incy] = y[ii];
-
 		if(n>K_MAX_STACK)
 			{
-#ifdef EXT_DEP
-			free(y);
-#else
-#endif
+			blasfeo_ws_free(x);
 			}
 		}
 
@@ -94,12 +94,9 @@ void TRSM(char *side, char *uplo, char *transa, char *diag, int *pm, int *pn, RE
 	REAL *dA;
 	if(p>K_MAX_STACK)
 		{
-#ifdef EXT_DEP
-		dA = (REAL *) malloc(p*sizeof(REAL));
-#else
-		// not enough static memory, can't allocate dynamic memory
-		exit(1);
-#endif
+		blasfeo_ws_malloc((void **) &dA, p*sizeof(REAL));
+		if(dA==NULL)
+			return;
 		}
 	else
 		{
@@ -225,10 +222,7 @@ void TRSM(char *side, char *uplo, char *transa, char *diag, int *pm, int *pn, RE
 
 	if(p>K_MAX_STACK)
 		{
-#ifdef EXT_DEP
-		free(dA);
-#else
-#endif
+		blasfeo_ws_free(dA);
 		}
 
 #ifdef TIME_INT
@@ -88,13 +88,14 @@
 
 #define CACHE_LINE_EL D_CACHE_LINE_EL
 #define L1_CACHE_EL D_L1_CACHE_EL
-#define L2_CACHE_EL D_L2_CACHE_EL
-#define LLC_CACHE_EL D_LLC_CACHE_EL
+#define L2_CACHE_EL (blasfeo_l2_cache_size()/D_EL_SIZE)
+#define LLC_CACHE_EL (blasfeo_llc_cache_size()/D_EL_SIZE)
 #define PS D_PS
 #define M_KERNEL D_M_KERNEL
-#define KC D_KC
-#define NC D_NC
-#define MC D_MC
+// runtime cache blocking, read once at routine entry (blasfeo_d_blocking) into d_kc, d_nc, d_mc
+#define KC d_kc
+#define NC d_nc
+#define MC d_mc
 
 
 
@@ -586,6 +587,7 @@ nt_n2_return:
 
 
 
+// A==NULL: pU (of leading dimension sdu) holds the whole A, pre-packed by blasfeo_hp_dgemm_pack_n/t
 static void blasfeo_hp_dgemm_nn_m1(int m, int n, int k, double alpha, double *A, int lda, double *B, int ldb, double beta, double *C, int ldc, double *D, int ldd, double *pU, int sdu)
 	{
 
@@ -595,19 +597,25 @@ static void blasfeo_hp_dgemm_nn_m1(int m, int n, int k, double alpha, double *A,
 	size_t ldb_s = ldb;
 	size_t ldc_s = ldc;
 	size_t ldd_s = ldd;
+	size_t sdu_s = sdu;
+
+	// row panel of A in use: packed into pU, or the matching panel of a pre-packed A (A==NULL)
+	double *pP;
 
 	ii = 0;
 #if defined(TARGET_X64_INTEL_SKYLAKE_X)
 	for(; ii<m-23; ii+=24)
 		{
-		kernel_dpack_nn_24_lib8(k, A+ii+0, lda, pU, sdu);
+		if(A!=NULL)
+			kernel_dpack_nn_24_lib8(k, A+ii+0, lda, pU, sdu);
+		pP = A!=NULL ? pU : pU+ii*sdu_s;
 		for(jj=0; jj<n-7; jj+=8)
 			{
-			kernel_dgemm_nn_24x8_lib8ccc(k, &alpha, pU, sdu, B+jj*ldb_s, ldb, &beta, C+ii+jj*ldc_s, ldc, D+ii+jj*ldd_s, ldd);
+			kernel_dgemm_nn_24x8_lib8ccc(k, &alpha, pP, sdu, B+jj*ldb_s, ldb, &beta, C+ii+jj*ldc_s, ldc, D+ii+jj*ldd_s, ldd);
 			}
 		if(jj<n)
 			{
-			kernel_dgemm_nn_24x8_vs_lib8ccc(k, &alpha, pU, sdu, B+jj*ldb_s, ldb, &beta, C+ii+jj*ldc_s, ldc, D+ii+jj*ldd_s, ldd, m-ii, n-jj);
+			kernel_dgemm_nn_24x8_vs_lib8ccc(k, &alpha, pP, sdu, B+jj*ldb_s, ldb, &beta, C+ii+jj*ldc_s, ldc, D+ii+jj*ldd_s, ldd, m-ii, n-jj);
 			}
 		}
 	if(ii<m)
@@ -628,14 +636,16 @@ static void blasfeo_hp_dgemm_nn_m1(int m, int n, int k, double alpha, double *A,
 #elif 0 //defined(TARGET_X64_INTEL_SKYLAKE_X)
 	for(; ii<m-15; ii+=16)
 		{
-		kernel_dpack_nn_16_lib8(k, A+ii+0, lda, pU, sdu);
+		if(A!=NULL)
+			kernel_dpack_nn_16_lib8(k, A+ii+0, lda, pU, sdu);
+		pP = A!=NULL ? pU : pU+ii*sdu_s;
 		for(jj=0; jj<n-7; jj+=8)
 			{
-			kernel_dgemm_nn_16x8_lib8ccc(k, &alpha, pU, sdu, B+jj*ldb_s, ldb, &beta, C+ii+jj*ldc_s, ldc, D+ii+jj*ldd_s, ldd);
+			kernel_dgemm_nn_16x8_lib8ccc(k, &alpha, pP, sdu, B+jj*ldb_s, ldb, &beta, C+ii+jj*ldc_s, ldc, D+ii+jj*ldd_s, ldd);
 			}
 		if(jj<n)
 			{
-			kernel_dgemm_nn_16x8_vs_lib8ccc(k, &alpha, pU, sdu, B+jj*ldb_s, ldb, &beta, C+ii+jj*ldc_s, ldc, D+ii+jj*ldd_s, ldd, m-ii, n-jj);
+			kernel_dgemm_nn_16x8_vs_lib8ccc(k, &alpha, pP, sdu, B+jj*ldb_s, ldb, &beta, C+ii+jj*ldc_s, ldc, D+ii+jj*ldd_s, ldd, m-ii, n-jj);
 			}
 		}
 	if(ii<m)
@@ -652,14 +662,16 @@ static void blasfeo_hp_dgemm_nn_m1(int m, int n, int k, double alpha, double *A,
 #elif 0 //defined(TARGET_X64_INTEL_SKYLAKE_X)
 	for(; ii<m-7; ii+=8)
 		{
-		kernel_dpack_nn_8_lib8(k, A+ii, lda, pU);
+		if(A!=NULL)
+			kernel_dpack_nn_8_lib8(k, A+ii, lda, pU);
+		pP = A!=NULL ? pU : pU+ii*sdu_s;
 		for(jj=0; jj<n-7; jj+=8)
 			{
-			kernel_dgemm_nn_8x8_lib8ccc(k, &alpha, pU, B+jj*ldb_s, ldb, &beta, C+ii+jj*ldc_s, ldc, D+ii+jj*ldd_s, ldd);
+			kernel_dgemm_nn_8x8_lib8ccc(k, &alpha, pP, B+jj*ldb_s, ldb, &beta, C+ii+jj*ldc_s, ldc, D+ii+jj*ldd_s, ldd);
 			}
 		if(jj<n)
 			{
-			kernel_dgemm_nn_8x8_vs_lib8ccc(k, &alpha, pU, B+jj*ldb_s, ldb, &beta, C+ii+jj*ldc_s, ldc, D+ii+jj*ldd_s, ldd, m-ii, n-jj);
+			kernel_dgemm_nn_8x8_vs_lib8ccc(k, &alpha, pP, B+jj*ldb_s, ldb, &beta, C+ii+jj*ldc_s, ldc, D+ii+jj*ldd_s, ldd, m-ii, n-jj);
 			}
 		}
 	if(ii<m)
@@ -669,14 +681,16 @@ static void blasfeo_hp_dgemm_nn_m1(int m, int n, int k, double alpha, double *A,
 #elif defined(TARGET_X64_INTEL_HASWELL) | defined(TARGET_ARMV8A_ARM_CORTEX_A53)
 	for(; ii<m-11; ii+=12)
 		{
-		kernel_dpack_nn_12_lib4(k, A+ii+0, lda, pU, sdu);
+		if(A!=NULL)
+			kernel_dpack_nn_12_lib4(k, A+ii+0, lda, pU, sdu);
+		pP = A!=NULL ? pU : pU+ii*sdu_s;
 		for(jj=0; jj<n-3; jj+=4)
 			{
-			kernel_dgemm_nn_12x4_lib4ccc(k, &alpha, pU, sdu, B+jj*ldb_s, ldb, &beta, C+ii+jj*ldc_s, ldc, D+ii+jj*ldd_s, ldd);
+			kernel_dgemm_nn_12x4_lib4ccc(k, &alpha, pP, sdu, B+jj*ldb_s, ldb, &beta, C+ii+jj*ldc_s, ldc, D+ii+jj*ldd_s, ldd);
 			}
 		if(jj<n)
 			{
-			kernel_dgemm_nn_12x4_vs_lib4ccc(k, &alpha, pU, sdu, B+jj*ldb_s, ldb, &beta, C+ii+jj*ldc_s, ldc, D+ii+jj*ldd_s, ldd, m-ii, n-jj);
+			kernel_dgemm_nn_12x4_vs_lib4ccc(k, &alpha, pP, sdu, B+jj*ldb_s, ldb, &beta, C+ii+jj*ldc_s, ldc, D+ii+jj*ldd_s, ldd, m-ii, n-jj);
 			}
 		}
 	if(ii<m)
@@ -697,14 +711,16 @@ static void blasfeo_hp_dgemm_nn_m1(int m, int n, int k, double alpha, double *A,
 #elif defined(TARGET_X64_INTEL_SANDY_BRIDGE) | defined(TARGET_ARMV8A_ARM_CORTEX_A57)
 	for(; ii<m-7; ii+=8)
 		{
-		kernel_dpack_nn_8_lib4(k, A+ii+0, lda, pU, sdu);
+		if(A!=NULL)
+			kernel_dpack_nn_8_lib4(k, A+ii+0, lda, pU, sdu);
+		pP = A!=NULL ? pU : pU+ii*sdu_s;
 		for(jj=0; jj<n-3; jj+=4)
 			{
-			kernel_dgemm_nn_8x4_lib4ccc(k, &alpha, pU, sdu, B+jj*ldb_s, ldb, &beta, C+ii+jj*ldc_s, ldc, D+ii+jj*ldd_s, ldd);
+			kernel_dgemm_nn_8x4_lib4ccc(k, &alpha, pP, sdu, B+jj*ldb_s, ldb, &beta, C+ii+jj*ldc_s, ldc, D+ii+jj*ldd_s, ldd);
 			}
 		if(jj<n)
 			{
-			kernel_dgemm_nn_8x4_vs_lib4ccc(k, &alpha, pU, sdu, B+jj*ldb_s, ldb, &beta, C+ii+jj*ldc_s, ldc, D+ii+jj*ldd_s, ldd, m-ii, n-jj);
+			kernel_dgemm_nn_8x4_vs_lib4ccc(k, &alpha, pP, sdu, B+jj*ldb_s, ldb, &beta, C+ii+jj*ldc_s, ldc, D+ii+jj*ldd_s, ldd, m-ii, n-jj);
 			}
 		}
 	if(ii<m)
@@ -721,14 +737,16 @@ static void blasfeo_hp_dgemm_nn_m1(int m, int n, int k, double alpha, double *A,
 #else
 	for(; ii<m-3; ii+=4)
 		{
-		kernel_dpack_nn_4_lib4(k, A+ii, lda, pU);
+		if(A!=NULL)
+			kernel_dpack_nn_4_lib4(k, A+ii, lda, pU);
+		pP = A!=NULL ? pU : pU+ii*sdu_s;
 		for(jj=0; jj<n-3; jj+=4)
 			{
-			kernel_dgemm_nn_4x4_lib4ccc(k, &alpha, pU, B+jj*ldb_s, ldb, &beta, C+ii+jj*ldc_s, ldc, D+ii+jj*ldd_s, ldd);
+			kernel_dgemm_nn_4x4_lib4ccc(k, &alpha, pP, B+jj*ldb_s, ldb, &beta, C+ii+jj*ldc_s, ldc, D+ii+jj*ldd_s, ldd);
 			}
 		if(jj<n)
 			{
-			kernel_dgemm_nn_4x4_vs_lib4ccc(k, &alpha, pU, B+jj*ldb_s, ldb, &beta, C+ii+jj*ldc_s, ldc, D+ii+jj*ldd_s, ldd, m-ii, n-jj);
+			kernel_dgemm_nn_4x4_vs_lib4ccc(k, &alpha, pP, B+jj*ldb_s, ldb, &beta, C+ii+jj*ldc_s, ldc, D+ii+jj*ldd_s, ldd, m-ii, n-jj);
 			}
 		}
 	if(ii<m)
@@ -740,80 +758,92 @@ static void blasfeo_hp_dgemm_nn_m1(int m, int n, int k, double alpha, double *A,
 
 #if defined(TARGET_X64_INTEL_SKYLAKE_X)
 nn_m1_left_24:
-	kernel_dpack_nn_24_vs_lib8(k, A+ii, lda, pU, sdu, m-ii);
+	if(A!=NULL)
+		kernel_dpack_nn_24_vs_lib8(k, A+ii, lda, pU, sdu, m-ii);
+	pP = A!=NULL ? pU : pU+ii*sdu_s;
 	for(jj=0; jj<n; jj+=8)
 		{
-		kernel_dgemm_nn_24x8_vs_lib8ccc(k, &alpha, pU, sdu, B+jj*ldb_s, ldb, &beta, C+ii+jj*ldc_s, ldc, D+ii+jj*ldd_s, ldd, m-ii, n-jj);
+		kernel_dgemm_nn_24x8_vs_lib8ccc(k, &alpha, pP, sdu, B+jj*ldb_s, ldb, &beta, C+ii+jj*ldc_s, ldc, D+ii+jj*ldd_s, ldd, m-ii, n-jj);
 		}
 	goto nn_m1_return;
 #endif
 
 #if defined(TARGET_X64_INTEL_SKYLAKE_X)
 nn_m1_left_16:
-	kernel_dpack_nn_16_vs_lib8(k, A+ii, lda, pU, sdu, m-ii);
+	if(A!=NULL)
+		kernel_dpack_nn_16_vs_lib8(k, A+ii, lda, pU, sdu, m-ii);
+	pP = A!=NULL ? pU : pU+ii*sdu_s;
 	for(jj=0; jj<n; jj+=8)
 		{
-		kernel_dgemm_nn_16x8_vs_lib8ccc(k, &alpha, pU, sdu, B+jj*ldb_s, ldb, &beta, C+ii+jj*ldc_s, ldc, D+ii+jj*ldd_s, ldd, m-ii, n-jj);
+		kernel_dgemm_nn_16x8_vs_lib8ccc(k, &alpha, pP, sdu, B+jj*ldb_s, ldb, &beta, C+ii+jj*ldc_s, ldc, D+ii+jj*ldd_s, ldd, m-ii, n-jj);
 		}
 	goto nn_m1_return;
 #endif
 
 #if defined(TARGET_X64_INTEL_HASWELL) | defined(TARGET_ARMV8A_ARM_CORTEX_A53)
 nn_m1_left_12:
-	kernel_dpack_nn_12_vs_lib4(k, A+ii, lda, pU, sdu, m-ii);
+	if(A!=NULL)
+		kernel_dpack_nn_12_vs_lib4(k, A+ii, lda, pU, sdu, m-ii);
+	pP = A!=NULL ? pU : pU+ii*sdu_s;
 	for(jj=0; jj<n; jj+=4)
 		{
-		kernel_dgemm_nn_12x4_vs_lib4ccc(k, &alpha, pU, sdu, B+jj*ldb_s, ldb, &beta, C+ii+jj*ldc_s, ldc, D+ii+jj*ldd_s, ldd, m-ii, n-jj);
+		kernel_dgemm_nn_12x4_vs_lib4ccc(k, &alpha, pP, sdu, B+jj*ldb_s, ldb, &beta, C+ii+jj*ldc_s, ldc, D+ii+jj*ldd_s, ldd, m-ii, n-jj);
 		}
 	goto nn_m1_return;
 #endif
 
 #if defined(TARGET_X64_INTEL_SKYLAKE_X)
 nn_m1_left_8:
-	kernel_dpack_nn_8_vs_lib8(k, A+ii, lda, pU, m-ii);
+	if(A!=NULL)
+		kernel_dpack_nn_8_vs_lib8(k, A+ii, lda, pU, m-ii);
+	pP = A!=NULL ? pU : pU+ii*sdu_s;
 	for(jj=0; jj<n; jj+=8)
 		{
-		kernel_dgemm_nn_8x8_vs_lib8ccc(k, &alpha, pU, B+jj*ldb_s, ldb, &beta, C+ii+jj*ldc_s, ldc, D+ii+jj*ldd_s, ldd, m-ii, n-jj);
+		kernel_dgemm_nn_8x8_vs_lib8ccc(k, &alpha, pP, B+jj*ldb_s, ldb, &beta, C+ii+jj*ldc_s, ldc, D+ii+jj*ldd_s, ldd, m-ii, n-jj);
 		}
 	goto nn_m1_return;
 #elif defined(TARGET_X64_INTEL_HASWELL) | defined(TARGET_X64_INTEL_SANDY_BRIDGE) | defined(TARGET_ARMV8A_ARM_CORTEX_A57) | defined(TARGET_ARMV8A_ARM_CORTEX_A53)
 nn_m1_left_8:
-	kernel_dpack_nn_8_vs_lib4(k, A+ii, lda, pU, sdu, m-ii);
+	if(A!=NULL)
+		kernel_dpack_nn_8_vs_lib4(k, A+ii, lda, pU, sdu, m-ii);
+	pP = A!=NULL ? pU : pU+ii*sdu_s;
 	for(jj=0; jj<n; jj+=4)
 		{
-		kernel_dgemm_nn_8x4_vs_lib4ccc(k, &alpha, pU, sdu, B+jj*ldb_s, ldb, &beta, C+ii+jj*ldc_s, ldc, D+ii+jj*ldd_s, ldd, m-ii, n-jj);
+		kernel_dgemm_nn_8x4_vs_lib4ccc(k, &alpha, pP, sdu, B+jj*ldb_s, ldb, &beta, C+ii+jj*ldc_s, ldc, D+ii+jj*ldd_s, ldd, m-ii, n-jj);
 		}
 	goto nn_m1_return;
 #endif
 
 nn_m1_left_4:
-	kernel_dpack_nn_4_vs_lib4(k, A+ii, lda, pU, m-ii);
+	if(A!=NULL)
+		kernel_dpack_nn_4_vs_lib4(k, A+ii, lda, pU, m-ii);
+	pP = A!=NULL ? pU : pU+ii*sdu_s;
 #if defined(TARGET_X64_INTEL_HASWELL)
 	for(jj=0; jj<n-8; jj+=12)
 		{
-		kernel_dgemm_nn_4x12_vs_lib4ccc(k, &alpha, pU, B+jj*ldb_s, ldb, &beta, C+ii+jj*ldc_s, ldc, D+ii+jj*ldd_s, ldd, m-ii, n-jj);
+		kernel_dgemm_nn_4x12_vs_lib4ccc(k, &alpha, pP, B+jj*ldb_s, ldb, &beta, C+ii+jj*ldc_s, ldc, D+ii+jj*ldd_s, ldd, m-ii, n-jj);
 		}
 	if(jj<n-4)
 		{
-		kernel_dgemm_nn_4x8_vs_lib4ccc(k, &alpha, pU, B+jj*ldb_s, ldb, &beta, C+ii+jj*ldc_s, ldc, D+ii+jj*ldd_s, ldd, m-ii, n-jj);
+		kernel_dgemm_nn_4x8_vs_lib4ccc(k, &alpha, pP, B+jj*ldb_s, ldb, &beta, C+ii+jj*ldc_s, ldc, D+ii+jj*ldd_s, ldd, m-ii, n-jj);
 		}
 	else if(jj<n)
 		{
-		kernel_dgemm_nn_4x4_vs_lib4ccc(k, &alpha, pU, B+jj*ldb_s, ldb, &beta, C+ii+jj*ldc_s, ldc, D+ii+jj*ldd_s, ldd, m-ii, n-jj);
+		kernel_dgemm_nn_4x4_vs_lib4ccc(k, &alpha, pP, B+jj*ldb_s, ldb, &beta, C+ii+jj*ldc_s, ldc, D+ii+jj*ldd_s, ldd, m-ii, n-jj);
 		}
 #elif defined(TARGET_ARMV8A_ARM_CORTEX_A57) | defined(TARGET_ARMV8A_ARM_CORTEX_A53)
 	for(jj=0; jj<n-4; jj+=8)
 		{
-		kernel_dgemm_nn_4x8_vs_lib4ccc(k, &alpha, pU, B+jj*ldb_s, ldb, &beta, C+ii+jj*ldc_s, ldc, D+ii+jj*ldd_s, ldd, m-ii, n-jj);
+		kernel_dgemm_nn_4x8_vs_lib4ccc(k, &alpha, pP, B+jj*ldb_s, ldb, &beta, C+ii+jj*ldc_s, ldc, D+ii+jj*ldd_s, ldd, m-ii, n-jj);
 		}
 	if(jj<n)
 		{
-		kernel_dgemm_nn_4x4_vs_lib4ccc(k, &alpha, pU, B+jj*ldb_s, ldb, &beta, C+ii+jj*ldc_s, ldc, D+ii+jj*ldd_s, ldd, m-ii, n-jj);
+		kernel_dgemm_nn_4x4_vs_lib4ccc(k, &alpha, pP, B+jj*ldb_s, ldb, &beta, C+ii+jj*ldc_s, ldc, D+ii+jj*ldd_s, ldd, m-ii, n-jj);
 		}
 #else
 	for(jj=0; jj<n; jj+=4)
 		{
-		kernel_dgemm_nn_4x4_vs_lib4ccc(k, &alpha, pU, B+jj*ldb_s, ldb, &beta, C+ii+jj*ldc_s, ldc, D+ii+jj*ldd_s, ldd, m-ii, n-jj);
+		kernel_dgemm_nn_4x4_vs_lib4ccc(k, &alpha, pP, B+jj*ldb_s, ldb, &beta, C+ii+jj*ldc_s, ldc, D+ii+jj*ldd_s, ldd, m-ii, n-jj);
 		}
 #endif
 	goto nn_m1_return;
@@ -1089,6 +1119,7 @@ nn_n1_return:
 
 
 
+// A==NULL: pU (of leading dimension sdu) holds the whole A, pre-packed by blasfeo_hp_dgemm_pack_n/t
 static void blasfeo_hp_dgemm_nt_m1(int m, int n, int k, double alpha, double *A, int lda, double *B, int ldb, double beta, double *C, int ldc, double *D, int ldd, double *pU, int sdu)
 	{
 
@@ -1098,19 +1129,25 @@ static void blasfeo_hp_dgemm_nt_m1(int m, int n, int k, double alpha, double *A,
 	size_t ldb_s = ldb;
 	size_t ldc_s = ldc;
 	size_t ldd_s = ldd;
+	size_t sdu_s = sdu;
+
+	// row panel of A in use: packed into pU, or the matching panel of a pre-packed A (A==NULL)
+	double *pP;
 
 	ii = 0;
 #if defined(TARGET_X64_INTEL_SKYLAKE_X)
 	for(; ii<m-23; ii+=24)
 		{
-		kernel_dpack_nn_24_lib8(k, A+ii+0, lda, pU, sdu);
+		if(A!=NULL)
+			kernel_dpack_nn_24_lib8(k, A+ii+0, lda, pU, sdu);
+		pP = A!=NULL ? pU : pU+ii*sdu_s;
 		for(jj=0; jj<n-7; jj+=8)
 			{
-			kernel_dgemm_nt_24x8_lib8ccc(k, &alpha, pU, sdu, B+jj, ldb, &beta, C+ii+jj*ldc_s, ldc, D+ii+jj*ldd_s, ldd);
+			kernel_dgemm_nt_24x8_lib8ccc(k, &alpha, pP, sdu, B+jj, ldb, &beta, C+ii+jj*ldc_s, ldc, D+ii+jj*ldd_s, ldd);
 			}
 		if(jj<n)
 			{
-			kernel_dgemm_nt_24x8_vs_lib8ccc(k, &alpha, pU, sdu, B+jj, ldb, &beta, C+ii+jj*ldc_s, ldc, D+ii+jj*ldd_s, ldd, m-ii, n-jj);
+			kernel_dgemm_nt_24x8_vs_lib8ccc(k, &alpha, pP, sdu, B+jj, ldb, &beta, C+ii+jj*ldc_s, ldc, D+ii+jj*ldd_s, ldd, m-ii, n-jj);
 			}
 		}
 	if(ii<m)
@@ -1131,14 +1168,16 @@ static void blasfeo_hp_dgemm_nt_m1(int m, int n, int k, double alpha, double *A,
 #elif 0 //defined(TARGET_X64_INTEL_SKYLAKE_X)
 	for(; ii<m-15; ii+=16)
 		{
-		kernel_dpack_nn_16_lib8(k, A+ii+0, lda, pU, sdu);
+		if(A!=NULL)
+			kernel_dpack_nn_16_lib8(k, A+ii+0, lda, pU, sdu);
+		pP = A!=NULL ? pU : pU+ii*sdu_s;
 		for(jj=0; jj<n-7; jj+=8)
 			{
-			kernel_dgemm_nt_16x8_lib8ccc(k, &alpha, pU, sdu, B+jj, ldb, &beta, C+ii+jj*ldc_s, ldc, D+ii+jj*ldd_s, ldd);
+			kernel_dgemm_nt_16x8_lib8ccc(k, &alpha, pP, sdu, B+jj, ldb, &beta, C+ii+jj*ldc_s, ldc, D+ii+jj*ldd_s, ldd);
 			}
 		if(jj<n)
 			{
-			kernel_dgemm_nt_16x8_vs_lib8ccc(k, &alpha, pU, sdu, B+jj, ldb, &beta, C+ii+jj*ldc_s, ldc, D+ii+jj*ldd_s, ldd, m-ii, n-jj);
+			kernel_dgemm_nt_16x8_vs_lib8ccc(k, &alpha, pP, sdu, B+jj, ldb, &beta, C+ii+jj*ldc_s, ldc, D+ii+jj*ldd_s, ldd, m-ii, n-jj);
 			}
 		}
 	if(ii<m)
@@ -1155,14 +1194,16 @@ static void blasfeo_hp_dgemm_nt_m1(int m, int n, int k, double alpha, double *A,
 #elif 0 //defined(TARGET_X64_INTEL_SKYLAKE_X)
 	for(; ii<m-7; ii+=8)
 		{
-		kernel_dpack_nn_8_lib8(k, A+ii, lda, pU);
+		if(A!=NULL)
+			kernel_dpack_nn_8_lib8(k, A+ii, lda, pU);
+		pP = A!=NULL ? pU : pU+ii*sdu_s;
 		for(jj=0; jj<n-7; jj+=8)
 			{
-			kernel_dgemm_nt_8x8_lib8ccc(k, &alpha, pU, B+jj, ldb, &beta, C+ii+jj*ldc_s, ldc, D+ii+jj*ldd_s, ldd);
+			kernel_dgemm_nt_8x8_lib8ccc(k, &alpha, pP, B+jj, ldb, &beta, C+ii+jj*ldc_s, ldc, D+ii+jj*ldd_s, ldd);
 			}
 		if(jj<n)
 			{
-			kernel_dgemm_nt_8x8_vs_lib8ccc(k, &alpha, pU, B+jj, ldb, &beta, C+ii+jj*ldc_s, ldc, D+ii+jj*ldd_s, ldd, m-ii, n-jj);
+			kernel_dgemm_nt_8x8_vs_lib8ccc(k, &alpha, pP, B+jj, ldb, &beta, C+ii+jj*ldc_s, ldc, D+ii+jj*ldd_s, ldd, m-ii, n-jj);
 			}
 		}
 	if(ii<m)
@@ -1172,14 +1213,16 @@ static void blasfeo_hp_dgemm_nt_m1(int m, int n, int k, double alpha, double *A,
 #elif defined(TARGET_X64_INTEL_HASWELL)
 	for(; ii<m-11; ii+=12)
 		{
-		kernel_dpack_nn_12_lib4(k, A+ii+0, lda, pU, sdu);
+		if(A!=NULL)
+			kernel_dpack_nn_12_lib4(k, A+ii+0, lda, pU, sdu);
+		pP = A!=NULL ? pU : pU+ii*sdu_s;
 		for(jj=0; jj<n-3; jj+=4)
 			{
-			kernel_dgemm_nt_12x4_lib4ccc(k, &alpha, pU, sdu, B+jj, ldb, &beta, C+ii+jj*ldc_s, ldc, D+ii+jj*ldd_s, ldd);
+			kernel_dgemm_nt_12x4_lib4ccc(k, &alpha, pP, sdu, B+jj, ldb, &beta, C+ii+jj*ldc_s, ldc, D+ii+jj*ldd_s, ldd);
 			}
 		if(jj<n)
 			{
-			kernel_dgemm_nt_12x4_vs_lib4ccc(k, &alpha, pU, sdu, B+jj, ldb, &beta, C+ii+jj*ldc_s, ldc, D+ii+jj*ldd_s, ldd, m-ii, n-jj);
+			kernel_dgemm_nt_12x4_vs_lib4ccc(k, &alpha, pP, sdu, B+jj, ldb, &beta, C+ii+jj*ldc_s, ldc, D+ii+jj*ldd_s, ldd, m-ii, n-jj);
 			}
 		}
 	if(ii<m)
@@ -1200,14 +1243,16 @@ static void blasfeo_hp_dgemm_nt_m1(int m, int n, int k, double alpha, double *A,
 #elif defined(TARGET_X64_INTEL_SANDY_BRIDGE) | defined(TARGET_ARMV8A_ARM_CORTEX_A57) | defined(TARGET_ARMV8A_ARM_CORTEX_A53)
 	for(; ii<m-7; ii+=8)
 		{
-		kernel_dpack_nn_8_lib4(k, A+ii+0, lda, pU, sdu);
+		if(A!=NULL)
+			kernel_dpack_nn_8_lib4(k, A+ii+0, lda, pU, sdu);
+		pP = A!=NULL ? pU : pU+ii*sdu_s;
 		for(jj=0; jj<n-3; jj+=4)
 			{
-			kernel_dgemm_nt_8x4_lib4ccc(k, &alpha, pU, sdu, B+jj, ldb, &beta, C+ii+jj*ldc_s, ldc, D+ii+jj*ldd_s, ldd);
+			kernel_dgemm_nt_8x4_lib4ccc(k, &alpha, pP, sdu, B+jj, ldb, &beta, C+ii+jj*ldc_s, ldc, D+ii+jj*ldd_s, ldd);
 			}
 		if(jj<n)
 			{
-			kernel_dgemm_nt_8x4_vs_lib4ccc(k, &alpha, pU, sdu, B+jj, ldb, &beta, C+ii+jj*ldc_s, ldc, D+ii+jj*ldd_s, ldd, m-ii, n-jj);
+			kernel_dgemm_nt_8x4_vs_lib4ccc(k, &alpha, pP, sdu, B+jj, ldb, &beta, C+ii+jj*ldc_s, ldc, D+ii+jj*ldd_s, ldd, m-ii, n-jj);
 			}
 		}
 	if(ii<m)
@@ -1224,14 +1269,16 @@ static void blasfeo_hp_dgemm_nt_m1(int m, int n, int k, double alpha, double *A,
 #else
 	for(; ii<m-3; ii+=4)
 		{
-		kernel_dpack_nn_4_lib4(k, A+ii, lda, pU);
+		if(A!=NULL)
+			kernel_dpack_nn_4_lib4(k, A+ii, lda, pU);
+		pP = A!=NULL ? pU : pU+ii*sdu_s;
 		for(jj=0; jj<n-3; jj+=4)
 			{
-			kernel_dgemm_nt_4x4_lib4ccc(k, &alpha, pU, B+jj, ldb, &beta, C+ii+jj*ldc_s, ldc, D+ii+jj*ldd_s, ldd);
+			kernel_dgemm_nt_4x4_lib4ccc(k, &alpha, pP, B+jj, ldb, &beta, C+ii+jj*ldc_s, ldc, D+ii+jj*ldd_s, ldd);
 			}
 		if(jj<n)
 			{
-			kernel_dgemm_nt_4x4_vs_lib4ccc(k, &alpha, pU, B+jj, ldb, &beta, C+ii+jj*ldc_s, ldc, D+ii+jj*ldd_s, ldd, m-ii, n-jj);
+			kernel_dgemm_nt_4x4_vs_lib4ccc(k, &alpha, pP, B+jj, ldb, &beta, C+ii+jj*ldc_s, ldc, D+ii+jj*ldd_s, ldd, m-ii, n-jj);
 			}
 		}
 	if(ii<m)
@@ -1243,80 +1290,92 @@ static void blasfeo_hp_dgemm_nt_m1(int m, int n, int k, double alpha, double *A,
 
 #if defined(TARGET_X64_INTEL_SKYLAKE_X)
 nt_m1_left_24:
-	kernel_dpack_nn_24_vs_lib8(k, A+ii+0, lda, pU, sdu, m-ii);
+	if(A!=NULL)
+		kernel_dpack_nn_24_vs_lib8(k, A+ii+0, lda, pU, sdu, m-ii);
+	pP = A!=NULL ? pU : pU+ii*sdu_s;
 	for(jj=0; jj<n; jj+=8)
 		{
-		kernel_dgemm_nt_24x8_vs_lib8ccc(k, &alpha, pU, sdu, B+jj, ldb, &beta, C+ii+jj*ldc_s, ldc, D+ii+jj*ldd_s, ldd, m-ii, n-jj);
+		kernel_dgemm_nt_24x8_vs_lib8ccc(k, &alpha, pP, sdu, B+jj, ldb, &beta, C+ii+jj*ldc_s, ldc, D+ii+jj*ldd_s, ldd, m-ii, n-jj);
 		}
 	goto nt_m1_return;
 #endif
 
 #if defined(TARGET_X64_INTEL_SKYLAKE_X)
 nt_m1_left_16:
-	kernel_dpack_nn_16_vs_lib8(k, A+ii+0, lda, pU, sdu, m-ii);
+	if(A!=NULL)
+		kernel_dpack_nn_16_vs_lib8(k, A+ii+0, lda, pU, sdu, m-ii);
+	pP = A!=NULL ? pU : pU+ii*sdu_s;
 	for(jj=0; jj<n; jj+=8)
 		{
-		kernel_dgemm_nt_16x8_vs_lib8ccc(k, &alpha, pU, sdu, B+jj, ldb, &beta, C+ii+jj*ldc_s, ldc, D+ii+jj*ldd_s, ldd, m-ii, n-jj);
+		kernel_dgemm_nt_16x8_vs_lib8ccc(k, &alpha, pP, sdu, B+jj, ldb, &beta, C+ii+jj*ldc_s, ldc, D+ii+jj*ldd_s, ldd, m-ii, n-jj);
 		}
 	goto nt_m1_return;
 #endif
 
 #if defined(TARGET_X64_INTEL_HASWELL)
 nt_m1_left_12:
-	kernel_dpack_nn_12_vs_lib4(k, A+ii+0, lda, pU, sdu, m-ii);
+	if(A!=NULL)
+		kernel_dpack_nn_12_vs_lib4(k, A+ii+0, lda, pU, sdu, m-ii);
+	pP = A!=NULL ? pU : pU+ii*sdu_s;
 	for(jj=0; jj<n; jj+=4)
 		{
-		kernel_dgemm_nt_12x4_vs_lib4ccc(k, &alpha, pU, sdu, B+jj, ldb, &beta, C+ii+jj*ldc_s, ldc, D+ii+jj*ldd_s, ldd, m-ii, n-jj);
+		kernel_dgemm_nt_12x4_vs_lib4ccc(k, &alpha, pP, sdu, B+jj, ldb, &beta, C+ii+jj*ldc_s, ldc, D+ii+jj*ldd_s, ldd, m-ii, n-jj);
 		}
 	goto nt_m1_return;
 #endif
 
 #if defined(TARGET_X64_INTEL_SKYLAKE_X)
 nt_m1_left_8:
-	kernel_dpack_nn_8_vs_lib8(k, A+ii, lda, pU, m-ii);
+	if(A!=NULL)
+		kernel_dpack_nn_8_vs_lib8(k, A+ii, lda, pU, m-ii);
+	pP = A!=NULL ? pU : pU+ii*sdu_s;
 	for(jj=0; jj<n; jj+=8)
 		{
-		kernel_dgemm_nt_8x8_vs_lib8ccc(k, &alpha, pU, B+jj, ldb, &beta, C+ii+jj*ldc_s, ldc, D+ii+jj*ldd_s, ldd, m-ii, n-jj);
+		kernel_dgemm_nt_8x8_vs_lib8ccc(k, &alpha, pP, B+jj, ldb, &beta, C+ii+jj*ldc_s, ldc, D+ii+jj*ldd_s, ldd, m-ii, n-jj);
 		}
 	goto nt_m1_return;
 #elif defined(TARGET_X64_INTEL_HASWELL) | defined(TARGET_X64_INTEL_SANDY_BRIDGE) | defined(TARGET_ARMV8A_ARM_CORTEX_A57) | defined(TARGET_ARMV8A_ARM_CORTEX_A53)
 nt_m1_left_8:
-	kernel_dpack_nn_8_vs_lib4(k, A+ii+0, lda, pU, sdu, m-ii);
+	if(A!=NULL)
+		kernel_dpack_nn_8_vs_lib4(k, A+ii+0, lda, pU, sdu, m-ii);
+	pP = A!=NULL ? pU : pU+ii*sdu_s;
 	for(jj=0; jj<n; jj+=4)
 		{
-		kernel_dgemm_nt_8x4_vs_lib4ccc(k, &alpha, pU, sdu, B+jj, ldb, &beta, C+ii+jj*ldc_s, ldc, D+ii+jj*ldd_s, ldd, m-ii, n-jj);
+		kernel_dgemm_nt_8x4_vs_lib4ccc(k, &alpha, pP, sdu, B+jj, ldb, &beta, C+ii+jj*ldc_s, ldc, D+ii+jj*ldd_s, ldd, m-ii, n-jj);
 		}
 	goto nt_m1_return;
 #endif
 
 nt_m1_left_4:
-	kernel_dpack_nn_4_vs_lib4(k, A+ii, lda, pU, m-ii);
+	if(A!=NULL)
+		kernel_dpack_nn_4_vs_lib4(k, A+ii, lda, pU, m-ii);
+	pP = A!=NULL ? pU : pU+ii*sdu_s;
 #if defined(TARGET_X64_INTEL_HASWELL)
 	for(jj=0; jj<n-8; jj+=12)
 		{
-		kernel_dgemm_nt_4x12_vs_lib4ccc(k, &alpha, pU, B+jj, ldb, &beta, C+ii+jj*ldc_s, ldc, D+ii+jj*ldd_s, ldd, m-ii, n-jj);
+		kernel_dgemm_nt_4x12_vs_lib4ccc(k, &alpha, pP, B+jj, ldb, &beta, C+ii+jj*ldc_s, ldc, D+ii+jj*ldd_s, ldd, m-ii, n-jj);
 		}
 	if(jj<n-4)
 		{
-		kernel_dgemm_nt_4x8_vs_lib4ccc(k, &alpha, pU, B+jj, ldb, &beta, C+ii+jj*ldc_s, ldc, D+ii+jj*ldd_s, ldd, m-ii, n-jj);
+		kernel_dgemm_nt_4x8_vs_lib4ccc(k, &alpha, pP, B+jj, ldb, &beta, C+ii+jj*ldc_s, ldc, D+ii+jj*ldd_s, ldd, m-ii, n-jj);
 		}
 	else if(jj<n)
 		{
-		kernel_dgemm_nt_4x4_vs_lib4ccc(k, &alpha, pU, B+jj, ldb, &beta, C+ii+jj*ldc_s, ldc, D+ii+jj*ldd_s, ldd, m-ii, n-jj);
+		kernel_dgemm_nt_4x4_vs_lib4ccc(k, &alpha, pP, B+jj, ldb, &beta, C+ii+jj*ldc_s, ldc, D+ii+jj*ldd_s, ldd, m-ii, n-jj);
 		}
 #elif defined(TARGET_ARMV8A_ARM_CORTEX_A57) | defined(TARGET_ARMV8A_ARM_CORTEX_A53)
 	for(jj=0; jj<n-4; jj+=8)
 		{
-		kernel_dgemm_nt_4x8_vs_lib4ccc(k, &alpha, pU, B+jj, ldb, &beta, C+ii+jj*ldc_s, ldc, D+ii+jj*ldd_s, ldd, m-ii, n-jj);
+		kernel_dgemm_nt_4x8_vs_lib4ccc(k, &alpha, pP, B+jj, ldb, &beta, C+ii+jj*ldc_s, ldc, D+ii+jj*ldd_s, ldd, m-ii, n-jj);
 		}
 	if(jj<n)
 		{
-		kernel_dgemm_nt_4x4_vs_lib4ccc(k, &alpha, pU, B+jj, ldb, &beta, C+ii+jj*ldc_s, ldc, D+ii+jj*ldd_s, ldd, m-ii, n-jj);
+		kernel_dgemm_nt_4x4_vs_lib4ccc(k, &alpha, pP, B+jj, ldb, &beta, C+ii+jj*ldc_s, ldc, D+ii+jj*ldd_s, ldd, m-ii, n-jj);
 		}
 #else
 	for(jj=0; jj<n; jj+=4)
 		{
-		kernel_dgemm_nt_4x4_vs_lib4ccc(k, &alpha, pU, B+jj, ldb, &beta, C+ii+jj*ldc_s, ldc, D+ii+jj*ldd_s, ldd, m-ii, n-jj);
+		kernel_dgemm_nt_4x4_vs_lib4ccc(k, &alpha, pP, B+jj, ldb, &beta, C+ii+jj*ldc_s, ldc, D+ii+jj*ldd_s, ldd, m-ii, n-jj);
 		}
 #endif
 	goto nt_m1_return;
@@ -2618,6 +2677,9 @@ tt_n1_return:
 void blasfeo_hp_dgemm_nn(int m, int n, int k, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj)
 	{
 
+	int d_kc, d_nc, d_mc;
+	blasfeo_d_blocking(&d_kc, &d_nc, &d_mc);
+
 #if defined(PRINT_NAME)
 #ifdef EXT_DEP
 	printf("\nblasfeo_hp_dgemm_nn (cm) %d %d %d %f %p %d %d %p %d %d %f %p %d %d %p %d %d\n", m, n, k, alpha, sA, ai, aj, sB, bi, bj, beta, sC, ci, cj, sD, di, dj);
@@ -2829,7 +2891,9 @@ nn_m1:
 	if(k>K_MAX_STACK && KC>K_MAX_STACK)
 		{
 		pU_size = M_KERNEL*KC*sizeof(double);
-		blasfeo_malloc(&mem, pU_size+64);
+		blasfeo_ws_malloc(&mem, pU_size+64);
+		if(mem==NULL)
+			return;
 		blasfeo_align_64_byte(mem, (void **) &mem_align);
 		pU = (double *) mem_align;
 		sdu = KC;
@@ -2899,7 +2963,7 @@ nn_m1:
 #ifdef EXT_DEP_MALLOC
 	if(k>K_MAX_STACK && KC>K_MAX_STACK)
 		{
-		blasfeo_free(mem);
+		blasfeo_ws_free(mem);
 		}
 #endif
 
@@ -2923,7 +2987,9 @@ nn_n1:
 	if(k>K_MAX_STACK && KC>K_MAX_STACK)
 		{
 		pU_size = M_KERNEL*KC*sizeof(double);
-		blasfeo_malloc(&mem, pU_size+64);
+		blasfeo_ws_malloc(&mem, pU_size+64);
+		if(mem==NULL)
+			return;
 		blasfeo_align_64_byte(mem, (void **) &mem_align);
 		pU = (double *) mem_align;
 		sdu = KC;
@@ -2973,7 +3039,7 @@ nn_n1:
 #ifdef EXT_DEP_MALLOC
 	if(k>K_MAX_STACK && KC>K_MAX_STACK)
 		{
-		blasfeo_free(mem);
+		blasfeo_ws_free(mem);
 		}
 #endif
 
@@ -3010,7 +3076,9 @@ nn_2:
 #if 1
 	if(blasfeo_is_init()==0)
 		{
-		blasfeo_malloc(&mem, tA_size+tB_size+2*4096);
+		blasfeo_ws_malloc(&mem, tA_size+tB_size+2*4096);
+		if(mem==NULL)
+			return;
 		}
 	else
 		{
@@ -3027,7 +3095,9 @@ nn_2:
 //	error = posix_memalign( &mem, 4*1024, tA_size+tB_size+2*4096 );
 //	error = posix_memalign( &mem, 2*1024*1024, mem_size );
 //	error = madvise( mem, tA_size+tB_size+2*4096, MADV_HUGEPAGE );
-	mem = malloc(mem_size);
+	blasfeo_ws_malloc((void **) &mem, mem_size);
+	if(mem==NULL)
+		return;
 	blasfeo_align_2MB(mem, (void **) &mem_align);
 //	blasfeo_align_4096_byte(mem, (void **) &mem_align);
 	error = madvise( mem_align, tA_size+tB_size+4096+2*1024*1024, MADV_HUGEPAGE );
@@ -3181,7 +3251,7 @@ if (thp_count.pages_available) {
 //	printf("\ntime: pack_A %e, pack_B %e, kernel %e, kernel2 %e, kernel3 %e\n", time_pack_A, time_pack_B, time_kernel, time_kernel2, time_kernel3); 
 	if(blasfeo_is_init()==0)
 		{
-		blasfeo_free(mem);
+		blasfeo_ws_free(mem);
 		}
 //	blas_memory_free(mem);
 //	blas_memory_free_nolock(mem);
@@ -3216,7 +3286,9 @@ if (thp_count.pages_available) {
 	tB_size = (tB_size + 4096 - 1) / 4096 * 4096;
 	if(blasfeo_is_init()==0)
 		{
-		blasfeo_malloc(&mem, tA_size+tB_size+2*4096);
+		blasfeo_ws_malloc(&mem, tA_size+tB_size+2*4096);
+		if(mem==NULL)
+			return;
 		}
 	else
 		{
@@ -3313,7 +3385,10 @@ if (thp_count.pages_available) {
 		}
 
 //	printf("\ntime: pack_A %e, pack_B %e, kernel %e, kernel2 %e, kernel3 %e\n", time_pack_A, time_pack_B, time_kernel, time_kernel2, time_kernel3); 
-	blasfeo_free(mem);
+	if(blasfeo_is_init()==0)
+		{
+		blasfeo_ws_free(mem);
+		}
 
 	return;
 
@@ -3344,7 +3419,9 @@ if (thp_count.pages_available) {
 	tB_size = blasfeo_pm_memsize_dmat(ps, nc0, kc0);
 	tA_size = (tA_size + 4096 - 1) / 4096 * 4096;
 	tB_size = (tB_size + 4096 - 1) / 4096 * 4096;
-	blasfeo_malloc(&mem, tA_size+tB_size+2*4096);
+	blasfeo_ws_malloc(&mem, tA_size+tB_size+2*4096);
+	if(mem==NULL)
+		return;
 	blasfeo_align_4096_byte(mem, (void **) &mem_align);
 
 	blasfeo_pm_create_dmat(ps, mc0, oc0, &tA, (void *) mem_align);
@@ -3433,7 +3510,7 @@ if (thp_count.pages_available) {
 		}
 
 //	printf("\ntime: pack_A %e, pack_B %e, kernel %e, kernel2 %e, kernel3 %e\n", time_pack_A, time_pack_B, time_kernel, time_kernel2, time_kernel3); 
-	blasfeo_free(mem);
+	blasfeo_ws_free(mem);
 
 	return;
 
@@ -3449,7 +3526,9 @@ if (thp_count.pages_available) {
 	tB_size = blasfeo_pm_memsize_dmat(ps, n1, k1);
 //	blasfeo_malloc(&mem, tA_size+tB_size+64);
 //	blasfeo_align_64_byte(mem, (void **) &mem_align);
-	blasfeo_malloc(&mem, tA_size+tB_size+4096);
+	blasfeo_ws_malloc(&mem, tA_size+tB_size+4096);
+	if(mem==NULL)
+		return;
 	blasfeo_align_4096_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_dmat(ps, m_kernel, k, &tA, (void *) mem_align);
 	blasfeo_pm_create_dmat(ps, n, k, &tB, (void *) (mem_align+tA_size));
@@ -3585,7 +3664,7 @@ nn_2_left_4:
 	goto nn_2_return;
 
 nn_2_return:
-	blasfeo_free(mem);
+	blasfeo_ws_free(mem);
 	return;
 
 #endif
@@ -3751,6 +3830,9 @@ nn_0_return:
 void blasfeo_hp_dgemm_nt(int m, int n, int k, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj)
 	{
 
+	int d_kc, d_nc, d_mc;
+	blasfeo_d_blocking(&d_kc, &d_nc, &d_mc);
+
 #if defined(PRINT_NAME)
 #ifdef EXT_DEP
 	printf("\nblasfeo_hp_dgemm_nt (cm) %d %d %d %f %p %d %d %p %d %d %f %p %d %d %p %d %d\n", m, n, k, alpha, sA, ai, aj, sB, bi, bj, beta, sC, ci, cj, sD, di, dj);
@@ -3947,7 +4029,9 @@ nt_m1:
 	if(k>K_MAX_STACK && KC>K_MAX_STACK)
 		{
 		pU_size = M_KERNEL*KC*sizeof(double);
-		blasfeo_malloc(&mem, pU_size+64);
+		blasfeo_ws_malloc(&mem, pU_size+64);
+		if(mem==NULL)
+			return;
 		blasfeo_align_64_byte(mem, (void **) &mem_align);
 		pU = (double *) mem_align;
 		sdu = KC;
@@ -3997,7 +4081,7 @@ nt_m1:
 #ifdef EXT_DEP_MALLOC
 	if(k>K_MAX_STACK && KC>K_MAX_STACK)
 		{
-		blasfeo_free(mem);
+		blasfeo_ws_free(mem);
 		}
 #endif
 
@@ -4021,7 +4105,9 @@ nt_n1:
 	if(k>K_MAX_STACK && KC>K_MAX_STACK)
 		{
 		pU_size = M_KERNEL*KC*sizeof(double);
-		blasfeo_malloc(&mem, pU_size+64);
+		blasfeo_ws_malloc(&mem, pU_size+64);
+		if(mem==NULL)
+			return;
 		blasfeo_align_64_byte(mem, (void **) &mem_align);
 		pU = (double *) mem_align;
 		sdu = KC;
@@ -4071,7 +4157,7 @@ nt_n1:
 #ifdef EXT_DEP_MALLOC
 	if(k>K_MAX_STACK && KC>K_MAX_STACK)
 		{
-		blasfeo_free(mem);
+		blasfeo_ws_free(mem);
 		}
 #endif
 
@@ -4109,7 +4195,9 @@ nt_2:
 	tB_size = (tB_size + 4096 - 1) / 4096 * 4096;
 	if(blasfeo_is_init()==0)
 		{
-		blasfeo_malloc(&mem, tA_size+tB_size+2*4096);
+		blasfeo_ws_malloc(&mem, tA_size+tB_size+2*4096);
+		if(mem==NULL)
+			return;
 		}
 	else
 		{
@@ -4213,7 +4301,7 @@ nt_2:
 
 	if(blasfeo_is_init()==0)
 		{
-		blasfeo_free(mem);
+		blasfeo_ws_free(mem);
 		}
 
 	return;
@@ -4226,7 +4314,9 @@ nt_2:
 	tB_size = blasfeo_pm_memsize_dmat(ps, n1, k1);
 //	blasfeo_malloc(&mem, tA_size+tB_size+64);
 //	blasfeo_align_64_byte(mem, (void **) &mem_align);
-	blasfeo_malloc(&mem, tA_size+tB_size+4096);
+	blasfeo_ws_malloc(&mem, tA_size+tB_size+4096);
+	if(mem==NULL)
+		return;
 	blasfeo_align_4096_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_dmat(ps, m_kernel, k, &tA, (void *) mem_align);
 	blasfeo_pm_create_dmat(ps, n, k, &tB, (void *) (mem_align+tA_size));
@@ -4341,7 +4431,7 @@ nt_2_left_4:
 	goto nt_2_return;
 
 nt_2_return:
-	blasfeo_free(mem);
+	blasfeo_ws_free(mem);
 	return;
 
 #endif
@@ -4509,6 +4599,9 @@ nt_0_return:
 void blasfeo_hp_dgemm_tn(int m, int n, int k, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj)
 	{
 
+	int d_kc, d_nc, d_mc;
+	blasfeo_d_blocking(&d_kc, &d_nc, &d_mc);
+
 #if defined(PRINT_NAME)
 #ifdef EXT_DEP
 	printf("\nblasfeo_hp_dgemm_tn (cm) %d %d %d %f %p %d %d %p %d %d %f %p %d %d %p %d %d\n", m, n, k, alpha, sA, ai, aj, sB, bi, bj, beta, sC, ci, cj, sD, di, dj);
@@ -4675,7 +4768,9 @@ tn_m1:
 	if(k>K_MAX_STACK && KC>K_MAX_STACK)
 		{
 		pU_size = M_KERNEL*KC*sizeof(double);
-		blasfeo_malloc(&mem, pU_size+64);
+		blasfeo_ws_malloc(&mem, pU_size+64);
+		if(mem==NULL)
+			return;
 		blasfeo_align_64_byte(mem, (void **) &mem_align);
 		pU = (double *) mem_align;
 		sdu = KC;
@@ -4726,7 +4821,7 @@ tn_m1:
 #ifdef EXT_DEP_MALLOC
 	if(k>K_MAX_STACK && KC>K_MAX_STACK)
 		{
-		blasfeo_free(mem);
+		blasfeo_ws_free(mem);
 		}
 #endif
 
@@ -4753,7 +4848,9 @@ tn_n1:
 	if(k>K_MAX_STACK && KC>K_MAX_STACK)
 		{
 		pU_size = M_KERNEL*KC*sizeof(double);
-		blasfeo_malloc(&mem, pU_size+64);
+		blasfeo_ws_malloc(&mem, pU_size+64);
+		if(mem==NULL)
+			return;
 		blasfeo_align_64_byte(mem, (void **) &mem_align);
 		pU = (double *) mem_align;
 		sdu = KC;
@@ -4804,7 +4901,7 @@ tn_n1:
 //	if(k>KC)
 	if(k>K_MAX_STACK && KC>K_MAX_STACK)
 		{
-		blasfeo_free(mem);
+		blasfeo_ws_free(mem);
 		}
 #endif
 
@@ -4841,7 +4938,9 @@ tn_2:
 	tB_size = (tB_size + 4096 - 1) / 4096 * 4096;
 	if(blasfeo_is_init()==0)
 		{
-		blasfeo_malloc(&mem, tA_size+tB_size+2*4096);
+		blasfeo_ws_malloc(&mem, tA_size+tB_size+2*4096);
+		if(mem==NULL)
+			return;
 		}
 	else
 		{
@@ -4940,7 +5039,7 @@ tn_2:
 
 	if(blasfeo_is_init()==0)
 		{
-		blasfeo_free(mem);
+		blasfeo_ws_free(mem);
 		}
 
 	return;
@@ -4953,7 +5052,9 @@ tn_2:
 	tB_size = blasfeo_pm_memsize_dmat(ps, n1, k1);
 //	blasfeo_malloc(&mem, tA_size+tB_size+64);
 //	blasfeo_align_64_byte(mem, (void **) &mem_align);
-	blasfeo_malloc(&mem, tA_size+tB_size+4096);
+	blasfeo_ws_malloc(&mem, tA_size+tB_size+4096);
+	if(mem==NULL)
+		return;
 	blasfeo_align_4096_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_dmat(ps, m_kernel, k, &tA, (void *) mem_align);
 	blasfeo_pm_create_dmat(ps, n, k, &tB, (void *) (mem_align+tA_size));
@@ -5095,7 +5196,7 @@ tn_2_left_4:
 	goto tn_2_return;
 
 tn_2_return:
-blasfeo_free(mem);
+blasfeo_ws_free(mem);
 	return;
 
 #endif
@@ -5136,6 +5237,9 @@ blasfeo_free(mem);
 void blasfeo_hp_dgemm_tt(int m, int n, int k, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj)
 	{
 
+	int d_kc, d_nc, d_mc;
+	blasfeo_d_blocking(&d_kc, &d_nc, &d_mc);
+
 #if defined(PRINT_NAME)
 #ifdef EXT_DEP
 	printf("\nblasfeo_hp_dgemm_tt (cm) %d %d %d %f %p %d %d %p %d %d %f %p %d %d %p %d %d\n", m, n, k, alpha, sA, ai, aj, sB, bi, bj, beta, sC, ci, cj, sD, di, dj);
@@ -5334,7 +5438,9 @@ tt_m1:
 	if(k>K_MAX_STACK && KC>K_MAX_STACK)
 		{
 		pU_size = M_KERNEL*KC*sizeof(double);
-		blasfeo_malloc(&mem, pU_size+64);
+		blasfeo_ws_malloc(&mem, pU_size+64);
+		if(mem==NULL)
+			return;
 		blasfeo_align_64_byte(mem, (void **) &mem_align);
 		pU = (double *) mem_align;
 		sdu = KC;
@@ -5384,7 +5490,7 @@ tt_m1:
 #ifdef EXT_DEP_MALLOC
 	if(k>K_MAX_STACK && KC>K_MAX_STACK)
 		{
-		blasfeo_free(mem);
+		blasfeo_ws_free(mem);
 		}
 #endif
 
@@ -5408,7 +5514,9 @@ tt_n1:
 	if(k>K_MAX_STACK && KC>K_MAX_STACK)
 		{
 		pU_size = M_KERNEL*KC*sizeof(double);
-		blasfeo_malloc(&mem, pU_size+64);
+		blasfeo_ws_malloc(&mem, pU_size+64);
+		if(mem==NULL)
+			return;
 		blasfeo_align_64_byte(mem, (void **) &mem_align);
 		pU = (double *) mem_align;
 		sdu = KC;
@@ -5458,7 +5566,7 @@ tt_n1:
 #ifdef EXT_DEP_MALLOC
 	if(k>K_MAX_STACK && KC>K_MAX_STACK)
 		{
-		blasfeo_free(mem);
+		blasfeo_ws_free(mem);
 		}
 #endif
 
@@ -5495,7 +5603,9 @@ tt_2:
 	tB_size = (tB_size + 4096 - 1) / 4096 * 4096;
 	if(blasfeo_is_init()==0)
 		{
-		blasfeo_malloc(&mem, tA_size+tB_size+2*4096);
+		blasfeo_ws_malloc(&mem, tA_size+tB_size+2*4096);
+		if(mem==NULL)
+			return;
 		}
 	else
 		{
@@ -5599,7 +5709,7 @@ tt_2:
 
 	if(blasfeo_is_init()==0)
 		{
-		blasfeo_free(mem);
+		blasfeo_ws_free(mem);
 		}
 
 	return;
@@ -5612,7 +5722,9 @@ tt_2:
 	tB_size = blasfeo_pm_memsize_dmat(ps, n1, k1);
 //	blasfeo_malloc(&mem, tA_size+tB_size+64);
 //	blasfeo_align_64_byte(mem, (void **) &mem_align);
-	blasfeo_malloc(&mem, tA_size+tB_size+4096);
+	blasfeo_ws_malloc(&mem, tA_size+tB_size+4096);
+	if(mem==NULL)
+		return;
 	blasfeo_align_4096_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_dmat(ps, m_kernel, k, &tA, (void *) mem_align);
 	blasfeo_pm_create_dmat(ps, n, k, &tB, (void *) (mem_align+tA_size));
@@ -5733,7 +5845,7 @@ tt_2_left_4:
 	goto tt_2_return;
 
 tt_2_return:
-	free(mem);
+	blasfeo_ws_free(mem);
 	return;
 
 #endif
@@ -5880,6 +5992,188 @@ tt_0_return:
 
 
 
+// packed A operand: A (or A^T) is stored once in panel-major format and reused by many products
+
+size_t blasfeo_hp_dgemm_pack_memsize(int m, int k)
+	{
+	const int ps = PS;
+	size_t pm = (m+ps-1)/ps*ps;
+	size_t sda = (k+4-1)/4*4;
+	return pm*sda*sizeof(double);
+	}
+
+
+
+// pA <= A ; pA is 64-byte aligned and of size blasfeo_hp_dgemm_pack_memsize(m, k)
+void blasfeo_hp_dgemm_pack_n(int m, int k, double *A, int lda, double *pA)
+	{
+
+	if(m<=0)
+		return;
+
+	const int ps = PS;
+	size_t sda_s = (k+4-1)/4*4;
+
+	int ii;
+
+	for(ii=0; ii<m-ps+1; ii+=ps)
+		{
+#if defined(TARGET_X64_INTEL_SKYLAKE_X)
+		kernel_dpack_nn_8_lib8(k, A+ii, lda, pA+ii*sda_s);
+#else
+		kernel_dpack_nn_4_lib4(k, A+ii, lda, pA+ii*sda_s);
+#endif
+		}
+	if(ii<m)
+		{
+#if defined(TARGET_X64_INTEL_SKYLAKE_X)
+		kernel_dpack_nn_8_vs_lib8(k, A+ii, lda, pA+ii*sda_s, m-ii);
+#else
+		kernel_dpack_nn_4_vs_lib4(k, A+ii, lda, pA+ii*sda_s, m-ii);
+#endif
+		}
+
+	return;
+
+	}
+
+
+
+// pA <= A^T ; pA is 64-byte aligned and of size blasfeo_hp_dgemm_pack_memsize(m, k)
+void blasfeo_hp_dgemm_pack_t(int m, int k, double *A, int lda, double *pA)
+	{
+
+	if(m<=0)
+		return;
+
+	const int ps = PS;
+	size_t lda_s = lda;
+	size_t sda_s = (k+4-1)/4*4;
+
+	int ii;
+
+	for(ii=0; ii<m-ps+1; ii+=ps)
+		{
+#if defined(TARGET_X64_INTEL_SKYLAKE_X)
+		kernel_dpack_tn_8_lib8(k, A+ii*lda_s, lda, pA+ii*sda_s);
+#else
+		kernel_dpack_tn_4_lib4(k, A+ii*lda_s, lda, pA+ii*sda_s);
+#endif
+		}
+	if(ii<m)
+		{
+#if defined(TARGET_X64_INTEL_SKYLAKE_X)
+		kernel_dpack_tn_8_vs_lib8(k, A+ii*lda_s, lda, pA+ii*sda_s, m-ii);
+#else
+		kernel_dpack_tn_4_vs_lib4(k, A+ii*lda_s, lda, pA+ii*sda_s, m-ii);
+#endif
+		}
+
+	return;
+
+	}
+
+
+
+// D <= beta * C + alpha * A * B ; A packed by blasfeo_hp_dgemm_pack_n or blasfeo_hp_dgemm_pack_t
+void blasfeo_hp_dgemm_packed_nn(int m, int n, int k, double alpha, double *pA, double *B, int ldb, double beta, double *C, int ldc, double *D, int ldd)
+	{
+
+	int d_kc, d_nc, d_mc;
+	blasfeo_d_blocking(&d_kc, &d_nc, &d_mc);
+
+#if defined(PRINT_NAME)
+#ifdef EXT_DEP
+	printf("\nblasfeo_hp_dgemm_packed_nn (cm) %d %d %d %f %p %p %d %f %p %d %p %d\n", m, n, k, alpha, pA, B, ldb, beta, C, ldc, D, ldd);
+#endif
+#endif
+
+	if(m<=0 | n<=0)
+		return;
+
+	const int ps = PS;
+	int sda = (k+4-1)/4*4;
+
+	int ll, kc, kleft, ldc1;
+	double beta1;
+	double *C1;
+
+	// the packed panels are blocked only along k, to keep the B panel in cache
+	kc = KC;
+
+	if(k<=kc)
+		{
+		blasfeo_hp_dgemm_nn_m1(m, n, k, alpha, NULL, 0, B, ldb, beta, C, ldc, D, ldd, pA, sda);
+		return;
+		}
+
+	for(ll=0; ll<k; ll+=kleft)
+		{
+		kleft = k-ll<kc ? k-ll : kc;
+
+		beta1 = ll==0 ? beta : 1.0;
+		C1 = ll==0 ? C : D;
+		ldc1 = ll==0 ? ldc : ldd;
+
+		blasfeo_hp_dgemm_nn_m1(m, n, kleft, alpha, NULL, 0, B+ll, ldb, beta1, C1, ldc1, D, ldd, pA+ll*ps, sda);
+		}
+
+	return;
+
+	}
+
+
+
+// D <= beta * C + alpha * A * B^T ; A packed by blasfeo_hp_dgemm_pack_n or blasfeo_hp_dgemm_pack_t
+void blasfeo_hp_dgemm_packed_nt(int m, int n, int k, double alpha, double *pA, double *B, int ldb, double beta, double *C, int ldc, double *D, int ldd)
+	{
+
+	int d_kc, d_nc, d_mc;
+	blasfeo_d_blocking(&d_kc, &d_nc, &d_mc);
+
+#if defined(PRINT_NAME)
+#ifdef EXT_DEP
+	printf("\nblasfeo_hp_dgemm_packed_nt (cm) %d %d %d %f %p %p %d %f %p %d %p %d\n", m, n, k, alpha, pA, B, ldb, beta, C, ldc, D, ldd);
+#endif
+#endif
+
+	if(m<=0 | n<=0)
+		return;
+
+	const int ps = PS;
+	int sda = (k+4-1)/4*4;
+	size_t ldb_s = ldb;
+
+	int ll, kc, kleft, ldc1;
+	double beta1;
+	double *C1;
+
+	// the packed panels are blocked only along k, to keep the B panel in cache
+	kc = KC;
+
+	if(k<=kc)
+		{
+		blasfeo_hp_dgemm_nt_m1(m, n, k, alpha, NULL, 0, B, ldb, beta, C, ldc, D, ldd, pA, sda);
+		return;
+		}
+
+	for(ll=0; ll<k; ll+=kleft)
+		{
+		kleft = k-ll<kc ? k-ll : kc;
+
+		beta1 = ll==0 ? beta : 1.0;
+		C1 = ll==0 ? C : D;
+		ldc1 = ll==0 ? ldc : ldd;
+
+		blasfeo_hp_dgemm_nt_m1(m, n, kleft, alpha, NULL, 0, B+ll*ldb_s, ldb, beta1, C1, ldc1, D, ldd, pA+ll*ps, sda);
+		}
+
+	return;
+
+	}
+
+
+
 #if defined(LA_HIGH_PERFORMANCE)
 //#ifndef HP_BLAS
 
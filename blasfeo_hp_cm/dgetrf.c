@@ -658,7 +658,9 @@ alg2:
 	n1 = (n+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_dmat(ps, m_kernel, m1);
 	tB_size = blasfeo_pm_memsize_dmat(ps, m1, n1);
-	blasfeo_malloc(&mem, tA_size+tB_size+64);
+	blasfeo_ws_malloc(&mem, tA_size+tB_size+64);
+	if(mem==NULL)
+		return;
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 
 	blasfeo_pm_create_dmat(ps, m_kernel, m, &tA, mem_align);
@@ -1271,7 +1273,7 @@ end_2:
 	// TODO clean loops
 
 end_m_2:
-	blasfeo_free(mem);
+	blasfeo_ws_free(mem);
 	// from 0-index to 1-index
 	// TODO move to BLAS_API !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
 //	for(ii=0; ii<p; ii++)
@@ -70,14 +70,15 @@
 
 #define CACHE_LINE_EL D_CACHE_LINE_EL
 #define L1_CACHE_EL D_L1_CACHE_EL
-#define L2_CACHE_EL D_L2_CACHE_EL
-#define LLC_CACHE_EL D_LLC_CACHE_EL
+#define L2_CACHE_EL (blasfeo_l2_cache_size()/D_EL_SIZE)
+#define LLC_CACHE_EL (blasfeo_llc_cache_size()/D_EL_SIZE)
 #define PS D_PS
 #define M_KERNEL D_M_KERNEL
 #define N_KERNEL D_N_KERNEL
-#define KC D_KC
-#define NC D_NC
-#define MC D_MC
+// runtime cache blocking, read once at routine entry (blasfeo_d_blocking) into d_kc, d_nc, d_mc
+#define KC d_kc
+#define NC d_nc
+#define MC d_mc
 
 
 
@@ -564,6 +565,9 @@ lx_2_return:
 void blasfeo_hp_dpotrf_l(int m, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj)
 	{
 
+	int d_kc, d_nc, d_mc;
+	blasfeo_d_blocking(&d_kc, &d_nc, &d_mc);
+
 #if defined(PRINT_NAME)
 #ifdef EXT_DEP
 	printf("\nblasfeo_hp_dpotrf_l (cm) %d %p %d %d %p %d %d\n", m, sC, ci, cj, sD, di, dj);
@@ -808,7 +812,9 @@ l_2:
 	tB_size = (tB_size + 4096 - 1) / 4096 * 4096;
 	if(blasfeo_is_init()==0)
 		{
-		blasfeo_malloc(&mem, tA_size+tB_size+2*4096);
+		blasfeo_ws_malloc(&mem, tA_size+tB_size+2*4096);
+		if(mem==NULL)
+			return;
 		}
 	else
 		{
@@ -863,7 +869,7 @@ l_2:
 
 	if(blasfeo_is_init()==0)
 		{
-		free(mem);
+		blasfeo_ws_free(mem);
 		}
 
 	return;
@@ -872,7 +878,9 @@ l_2:
 
 	m1 = (m+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_dmat(ps, m1, m1);
-	mem = malloc(tA_size+64);
+	blasfeo_ws_malloc((void **) &mem, tA_size+64);
+	if(mem==NULL)
+		return;
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_dmat(ps, m, m, &tA, (void *) mem_align);
 
@@ -1008,7 +1016,7 @@ l_2_left_4:
 	goto l_2_return;
 
 l_2_return:
-	free(mem);
+	blasfeo_ws_free(mem);
 	return;
 
 #endif
@@ -1332,7 +1340,9 @@ u_2:
 	m1 = (m+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_dmat(ps, m1, m1);
 //	tA_size = blasfeo_memsize_dmat(m, m);
-	mem = malloc(tA_size+64);
+	blasfeo_ws_malloc((void **) &mem, tA_size+64);
+	if(mem==NULL)
+		return;
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_dmat(ps, m, m, &tA, (void *) mem_align);
 
@@ -1516,7 +1526,7 @@ u_2_left_4:
 	goto u_2_return;
 
 u_2_return:
-	free(mem);
+	blasfeo_ws_free(mem);
 	return;
 
 #else // EXT_DEP_MALLOC
@@ -1874,7 +1884,9 @@ l_2:
 	m1 = (m+128-1)/128*128;
 	n1 = (n+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_dmat(ps, m1, n1);
-	blasfeo_malloc(&mem, tA_size+64);
+	blasfeo_ws_malloc(&mem, tA_size+64);
+	if(mem==NULL)
+		return;
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_dmat(ps, m, n, &tA, (void *) mem_align);
 
@@ -1884,7 +1896,7 @@ l_2:
 
 	blasfeo_hp_dpotrf_l_mn_m2(m, n, C, ldc, D, ldd, tA.pA, dA, sda);
 
-	blasfeo_free(mem);
+	blasfeo_ws_free(mem);
 	return;
 
 #else // EXT_DEP_MALLOC
@@ -0,0 +1,383 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS for embedded optimization.                                                      *
+* Copyright (C) 2019 by Gianluca Frison.                                                          *
+* Developed at IMTEK (University of Freiburg) under the supervision of Moritz Diehl.              *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#include <blasfeo_target.h>
+#include <blasfeo_block_size.h>
+#include <blasfeo_common.h>
+#include <blasfeo_stdlib.h>
+#include <blasfeo_d_aux.h>
+#include <blasfeo_d_kernel.h>
+#include <blasfeo_memory.h>
+#include <blasfeo_d_blasfeo_api.h>
+
+
+
+#if ( defined(BLAS_API) & defined(MF_PANELMAJ) )
+#define blasfeo_dmat blasfeo_cm_dmat
+#define blasfeo_hp_dsymm_ll blasfeo_hp_cm_dsymm_ll
+#define blasfeo_hp_dsymm_lu blasfeo_hp_cm_dsymm_lu
+#define blasfeo_hp_dsymm_rl blasfeo_hp_cm_dsymm_rl
+#define blasfeo_hp_dsymm_ru blasfeo_hp_cm_dsymm_ru
+#define blasfeo_dsymm_ll blasfeo_cm_dsymm_ll
+#define blasfeo_dsymm_lu blasfeo_cm_dsymm_lu
+#define blasfeo_dsymm_rl blasfeo_cm_dsymm_rl
+#define blasfeo_dsymm_ru blasfeo_cm_dsymm_ru
+#endif
+
+
+
+#define PS D_PS
+// runtime cache blocking, read once at routine entry (blasfeo_d_blocking) into d_kc, d_nc, d_mc
+#define KC d_kc
+#define NC d_nc
+#define MC d_mc
+
+
+
+// pack the m x n block at (ii,jj) of the symmetric matrix stored in the lower (upper==0) or upper (upper==1) triangle of A
+static void blasfeo_hp_dsymm_pack(int upper, int m, int n, int ii, int jj, double *A, int lda, double *pA, int sda)
+	{
+#if defined(TARGET_X64_INTEL_SKYLAKE_X)
+	if(upper)
+		kernel_dpack_buffer_su_lib8(m, n, ii, jj, A, lda, pA, sda);
+	else
+		kernel_dpack_buffer_sl_lib8(m, n, ii, jj, A, lda, pA, sda);
+#else
+	if(upper)
+		kernel_dpack_buffer_su(m, n, ii, jj, A, lda, pA, sda);
+	else
+		kernel_dpack_buffer_sl(m, n, ii, jj, A, lda, pA, sda);
+#endif
+	return;
+	}
+
+
+
+// D <= beta * C + alpha * A * B (side==0) or D <= beta * C + alpha * B * A (side==1), with A symmetric
+static void blasfeo_hp_dsymm_blk(int side, int upper, int m, int n, double alpha, double *A, int lda, double *B, int ldb, double beta, double *C, int ldc, double *D, int ldd)
+	{
+
+	int d_kc, d_nc, d_mc;
+	blasfeo_d_blocking(&d_kc, &d_nc, &d_mc);
+
+	size_t lda_s = lda;
+	size_t ldb_s = ldb;
+	size_t ldc_s = ldc;
+	size_t ldd_s = ldd;
+
+	int ii, jj, ll;
+	int iii;
+	int mc, nc, kc;
+	int mleft, nleft, kleft;
+	int mc0, nc0, kc0;
+	int ldc1;
+	size_t ldc1_s;
+	double beta1;
+	double *pA, *pB, *C1;
+
+	const int ps = PS;
+
+	struct blasfeo_pm_dmat tA, tB;
+	int sda, sdb;
+	size_t sda_s, sdb_s;
+	size_t tA_size, tB_size;
+	void *mem;
+	char *mem_align;
+
+	// inner dimension of the product
+	int k = side==0 ? m : n;
+
+	// cache blocking alg
+
+	mc0 = MC;
+	nc0 = NC;
+	kc0 = KC;
+
+	mc = m<mc0 ? m : mc0;
+	nc = n<nc0 ? n : nc0;
+	kc = k<kc0 ? k : kc0;
+
+	tA_size = blasfeo_pm_memsize_dmat(ps, mc0, kc0);
+	tB_size = blasfeo_pm_memsize_dmat(ps, nc0, kc0);
+	tA_size = (tA_size + 4096 - 1) / 4096 * 4096;
+	tB_size = (tB_size + 4096 - 1) / 4096 * 4096;
+	if(blasfeo_is_init()==0)
+		{
+		blasfeo_ws_malloc(&mem, tA_size+tB_size+2*4096);
+		if(mem==NULL)
+			return;
+		}
+	else
+		{
+		mem = blasfeo_get_buffer();
+		}
+	blasfeo_align_4096_byte(mem, (void **) &mem_align);
+
+	blasfeo_pm_create_dmat(ps, mc0, kc0, &tA, (void *) mem_align);
+	mem_align += tA_size;
+
+	mem_align += 4096-4*128;
+	blasfeo_pm_create_dmat(ps, nc0, kc0, &tB, (void *) mem_align);
+	mem_align += tB_size;
+
+	pA = tA.pA;
+	pB = tB.pA;
+
+	for(ll=0; ll<k; ll+=kleft)
+		{
+
+		if(k-ll<2*kc0)
+			{
+			if(k-ll<=kc0) // last
+				{
+				kleft = k-ll;
+				}
+			else // second last
+				{
+				kleft = (k-ll+1)/2;
+				kleft = (kleft+4-1)/4*4;
+				}
+			}
+		else
+			{
+			kleft = kc;
+			}
+
+		sda = (kleft+4-1)/4*4;
+		sdb = (kleft+4-1)/4*4;
+		sda_s = sda;
+		sdb_s = sdb;
+
+		beta1 = ll==0 ? beta : 1.0;
+		C1 = ll==0 ? C : D;
+		ldc1 = ll==0 ? ldc : ldd;
+		ldc1_s = ldc1;
+
+		for(ii=0; ii<m; ii+=mleft)
+			{
+
+			mleft = m-ii<mc ? m-ii : mc;
+
+			// pack A (left) or B (right)
+			if(side==0)
+				{
+				blasfeo_hp_dsymm_pack(upper, mleft, kleft, ii, ll, A, lda, pA, sda);
+				}
+			else
+				{
+#if defined(TARGET_X64_INTEL_SKYLAKE_X)
+				for(iii=0; iii<kleft-3; iii+=4)
+					{
+					kernel_dpack_tt_4_lib8(mleft, B+ii+(ll+iii)*ldb_s, ldb, pA+iii*ps, sda);
+					}
+				if(iii<kleft)
+					{
+					kernel_dpack_tt_4_vs_lib8(mleft, B+ii+(ll+iii)*ldb_s, ldb, pA+iii*ps, sda, kleft-iii);
+					}
+#else
+				kernel_dpack_buffer_fn(mleft, kleft, B+ii+ll*ldb_s, ldb, pA, sda);
+#endif
+				}
+
+			for(jj=0; jj<n; jj+=nleft)
+				{
+
+				nleft = n-jj<nc ? n-jj : nc;
+
+				// pack and tran B (left), pack A as its own transposed (right)
+				if(side==0)
+					{
+#if defined(TARGET_X64_INTEL_SKYLAKE_X)
+					for(iii=0; iii<nleft-7; iii+=8)
+						{
+						kernel_dpack_tn_8_lib8(kleft, B+ll+(jj+iii)*ldb_s, ldb, pB+iii*sdb_s);
+						}
+					if(iii<nleft)
+						{
+						kernel_dpack_tn_8_vs_lib8(kleft, B+ll+(jj+iii)*ldb_s, ldb, pB+iii*sdb_s, nleft-iii);
+						}
+#else
+					kernel_dpack_buffer_ft(kleft, nleft, B+ll+jj*ldb_s, ldb, pB, sdb);
+#endif
+					}
+				else
+					{
+					blasfeo_hp_dsymm_pack(upper, nleft, kleft, jj, ll, A, lda, pB, sdb);
+					}
+
+				blasfeo_hp_dgemm_nt_m2(mleft, nleft, kleft, alpha, pA, sda, pB, sdb, beta1, C1+ii+jj*ldc1_s, ldc1, D+ii+jj*ldd_s, ldd);
+
+				}
+
+			}
+
+		}
+
+	if(blasfeo_is_init()==0)
+		{
+		blasfeo_ws_free(mem);
+		}
+
+	return;
+
+	}
+
+
+
+// dsymm left lower
+void blasfeo_hp_dsymm_ll(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj)
+	{
+	if(m<=0 | n<=0)
+		return;
+
+	// extract pointer to column-major matrices from structures
+	int lda = sA->m;
+	int ldb = sB->m;
+	int ldc = sC->m;
+	int ldd = sD->m;
+	double *A = sA->pA + ai + aj*((size_t) lda);
+	double *B = sB->pA + bi + bj*((size_t) ldb);
+	double *C = sC->pA + ci + cj*((size_t) ldc);
+	double *D = sD->pA + di + dj*((size_t) ldd);
+
+	blasfeo_hp_dsymm_blk(0, 0, m, n, alpha, A, lda, B, ldb, beta, C, ldc, D, ldd);
+	return;
+	}
+
+
+
+// dsymm left upper
+void blasfeo_hp_dsymm_lu(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj)
+	{
+	if(m<=0 | n<=0)
+		return;
+
+	// extract pointer to column-major matrices from structures
+	int lda = sA->m;
+	int ldb = sB->m;
+	int ldc = sC->m;
+	int ldd = sD->m;
+	double *A = sA->pA + ai + aj*((size_t) lda);
+	double *B = sB->pA + bi + bj*((size_t) ldb);
+	double *C = sC->pA + ci + cj*((size_t) ldc);
+	double *D = sD->pA + di + dj*((size_t) ldd);
+
+	blasfeo_hp_dsymm_blk(0, 1, m, n, alpha, A, lda, B, ldb, beta, C, ldc, D, ldd);
+	return;
+	}
+
+
+
+// dsymm right lower
+void blasfeo_hp_dsymm_rl(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj)
+	{
+	if(m<=0 | n<=0)
+		return;
+
+	// extract pointer to column-major matrices from structures
+	int lda = sA->m;
+	int ldb = sB->m;
+	int ldc = sC->m;
+	int ldd = sD->m;
+	double *A = sA->pA + ai + aj*((size_t) lda);
+	double *B = sB->pA + bi + bj*((size_t) ldb);
+	double *C = sC->pA + ci + cj*((size_t) ldc);
+	double *D = sD->pA + di + dj*((size_t) ldd);
+
+	blasfeo_hp_dsymm_blk(1, 0, m, n, alpha, A, lda, B, ldb, beta, C, ldc, D, ldd);
+	return;
+	}
+
+
+
+// dsymm right upper
+void blasfeo_hp_dsymm_ru(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj)
+	{
+	if(m<=0 | n<=0)
+		return;
+
+	// extract pointer to column-major matrices from structures
+	int lda = sA->m;
+	int ldb = sB->m;
+	int ldc = sC->m;
+	int ldd = sD->m;
+	double *A = sA->pA + ai + aj*((size_t) lda);
+	double *B = sB->pA + bi + bj*((size_t) ldb);
+	double *C = sC->pA + ci + cj*((size_t) ldc);
+	double *D = sD->pA + di + dj*((size_t) ldd);
+
+	blasfeo_hp_dsymm_blk(1, 1, m, n, alpha, A, lda, B, ldb, beta, C, ldc, D, ldd);
+	return;
+	}
+
+
+
+#if defined(LA_HIGH_PERFORMANCE)
+
+
+
+void blasfeo_dsymm_ll(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj)
+	{
+	blasfeo_hp_dsymm_ll(m, n, alpha, sA, ai, aj, sB, bi, bj, beta, sC, ci, cj, sD, di, dj);
+	}
+
+
+
+void blasfeo_dsymm_lu(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj)
+	{
+	blasfeo_hp_dsymm_lu(m, n, alpha, sA, ai, aj, sB, bi, bj, beta, sC, ci, cj, sD, di, dj);
+	}
+
+
+
+void blasfeo_dsymm_rl(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj)
+	{
+	blasfeo_hp_dsymm_rl(m, n, alpha, sA, ai, aj, sB, bi, bj, beta, sC, ci, cj, sD, di, dj);
+	}
+
+
+
+void blasfeo_dsymm_ru(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj)
+	{
+	blasfeo_hp_dsymm_ru(m, n, alpha, sA, ai, aj, sB, bi, bj, beta, sC, ci, cj, sD, di, dj);
+	}
+
+
+
+#endif
@@ -77,13 +77,14 @@ void blasfeo_cm_dsyrk_ut(int m, int k, double alpha, struct blasfeo_dmat *sA, in
 
 #define CACHE_LINE_EL D_CACHE_LINE_EL
 #define L1_CACHE_EL D_L1_CACHE_EL
-#define L2_CACHE_EL D_L2_CACHE_EL
-#define LLC_CACHE_EL D_LLC_CACHE_EL
+#define L2_CACHE_EL (blasfeo_l2_cache_size()/D_EL_SIZE)
+#define LLC_CACHE_EL (blasfeo_llc_cache_size()/D_EL_SIZE)
 #define PS D_PS
 #define M_KERNEL D_M_KERNEL
-#define KC D_KC
-#define NC D_NC
-#define MC D_MC
+// runtime cache blocking, read once at routine entry (blasfeo_d_blocking) into d_kc, d_nc, d_mc
+#define KC d_kc
+#define NC d_nc
+#define MC d_mc
 
 
 
@@ -472,6 +473,9 @@ ln_1_return:
 void blasfeo_hp_dsyr2k_ln(int m, int k, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj)
 	{
 
+	int d_kc, d_nc, d_mc;
+	blasfeo_d_blocking(&d_kc, &d_nc, &d_mc);
+
 //	double dd_1 = 1.0;
 //	blasfeo_dsyrk_ln(m, k, alpha, sA, ai, aj, sB, bi, bj, beta, sC, ci, cj, sD, di, dj);
 //	blasfeo_dsyrk_ln(m, k, alpha, sB, bi, bj, sA, ai, aj, dd_1, sD, di, dj, sD, di, dj);
@@ -614,7 +618,9 @@ ln_1:
 	if(2*k>K_MAX_STACK && KC>K_MAX_STACK)
 		{
 		pU_size = M_KERNEL*KC*sizeof(double);
-		blasfeo_malloc(&mem, pU_size+64);
+		blasfeo_ws_malloc(&mem, pU_size+64);
+		if(mem==NULL)
+			return;
 		blasfeo_align_64_byte(mem, (void **) &mem_align);
 		pU = (double *) mem_align;
 		sdu = KC;
@@ -687,7 +693,7 @@ ln_1:
 #ifdef EXT_DEP_MALLOC
 	if(2*k>K_MAX_STACK && KC>K_MAX_STACK)
 		{
-		blasfeo_free(mem);
+		blasfeo_ws_free(mem);
 		}
 #endif
 
@@ -733,7 +739,9 @@ ln_2:
 	tB_size = (tB_size + 4096 - 1) / 4096 * 4096;
 	if(blasfeo_is_init()==0)
 		{
-		blasfeo_malloc(&mem, tA_size+tB_size+2*4096);
+		blasfeo_ws_malloc(&mem, tA_size+tB_size+2*4096);
+		if(mem==NULL)
+			return;
 		}
 	else
 		{
@@ -855,7 +863,7 @@ ln_2:
 
 	if(blasfeo_is_init()==0)
 		{
-		blasfeo_free(mem);
+		blasfeo_ws_free(mem);
 		}
 
 	return;
@@ -865,7 +873,9 @@ ln_2:
 	k1 = (2*k+128-1)/128*128;
 	m1 = (m+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_dmat(ps, m1, k1);
-	mem = malloc(tA_size+64);
+	blasfeo_ws_malloc((void **) &mem, tA_size+64);
+	if(mem==NULL)
+		return;
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_dmat(ps, m, 2*k, &tA, (void *) mem_align);
 
@@ -881,7 +891,7 @@ ln_2:
 
 	blasfeo_hp_dsyr2k_ln_m2(m, k, alpha, pU, sdu, pU+k*ps, sdu, beta, C, ldc, D, ldd);
 
-	free(mem);
+	blasfeo_ws_free(mem);
 	return;
 
 #endif
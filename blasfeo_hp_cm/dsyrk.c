@@ -76,13 +76,14 @@
 
 #define CACHE_LINE_EL D_CACHE_LINE_EL
 #define L1_CACHE_EL D_L1_CACHE_EL
-#define L2_CACHE_EL D_L2_CACHE_EL
-#define LLC_CACHE_EL D_LLC_CACHE_EL
+#define L2_CACHE_EL (blasfeo_l2_cache_size()/D_EL_SIZE)
+#define LLC_CACHE_EL (blasfeo_llc_cache_size()/D_EL_SIZE)
 #define PS D_PS
 #define M_KERNEL D_M_KERNEL
-#define KC D_KC
-#define NC D_NC
-#define MC D_MC
+// runtime cache blocking, read once at routine entry (blasfeo_d_blocking) into d_kc, d_nc, d_mc
+#define KC d_kc
+#define NC d_nc
+#define MC d_mc
 
 
 
@@ -859,6 +860,9 @@ ut_1_return:
 void blasfeo_hp_dsyrk3_ln(int m, int k, double alpha, struct blasfeo_dmat *sA, int ai, int aj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj)
 	{
 
+	int d_kc, d_nc, d_mc;
+	blasfeo_d_blocking(&d_kc, &d_nc, &d_mc);
+
 #if defined(PRINT_NAME)
 #ifdef EXT_DEP
 	printf("\nblasfeo_hp_dsyrk3_ln (cm) %d %d %f %p %d %d %f %p %d %d %p %d %d\n", m, k, alpha, sA, ai, aj, beta, sC, ci, cj, sD, di, dj);
@@ -991,7 +995,9 @@ ln_1:
 	if(k>K_MAX_STACK && KC>K_MAX_STACK)
 		{
 		pU_size = M_KERNEL*KC*sizeof(double);
-		blasfeo_malloc(&mem, pU_size+64);
+		blasfeo_ws_malloc(&mem, pU_size+64);
+		if(mem==NULL)
+			return;
 		blasfeo_align_64_byte(mem, (void **) &mem_align);
 		pU = (double *) mem_align;
 		sdu = KC;
@@ -1060,7 +1066,7 @@ ln_1:
 #ifdef EXT_DEP_MALLOC
 	if(k>K_MAX_STACK && KC>K_MAX_STACK)
 		{
-		blasfeo_free(mem);
+		blasfeo_ws_free(mem);
 		}
 #endif
 
@@ -1094,7 +1100,9 @@ ln_2:
 	tB_size = (tB_size + 4096 - 1) / 4096 * 4096;
 	if(blasfeo_is_init()==0)
 		{
-		blasfeo_malloc(&mem, tA_size+tB_size+2*4096);
+		blasfeo_ws_malloc(&mem, tA_size+tB_size+2*4096);
+		if(mem==NULL)
+			return;
 		}
 	else
 		{
@@ -1207,7 +1215,7 @@ ln_2:
 
 	if(blasfeo_is_init()==0)
 		{
-		blasfeo_free(mem);
+		blasfeo_ws_free(mem);
 		}
 
 	return;
@@ -1217,7 +1225,9 @@ ln_2:
 	k1 = (k+128-1)/128*128;
 	m1 = (m+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_dmat(ps, m1, k1);
-	blasfeo_malloc(&mem, tA_size+64);
+	blasfeo_ws_malloc(&mem, tA_size+64);
+	if(mem==NULL)
+		return;
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_dmat(ps, m, k, &tA, (void *) mem_align);
 
@@ -1232,7 +1242,7 @@ ln_2:
 
 	blasfeo_hp_dsyrk3_ln_m2(m, k, alpha, pU, sdu, beta, C, ldc, D, ldd);
 
-	blasfeo_free(mem);
+	blasfeo_ws_free(mem);
 	return;
 
 #endif
@@ -1253,6 +1263,9 @@ ln_2:
 void blasfeo_hp_dsyrk3_lt(int m, int k, double alpha, struct blasfeo_dmat *sA, int ai, int aj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj)
 	{
 
+	int d_kc, d_nc, d_mc;
+	blasfeo_d_blocking(&d_kc, &d_nc, &d_mc);
+
 #if defined(PRINT_NAME)
 #ifdef EXT_DEP
 	printf("\nblasfeo_hp_dsyrk3_lt (cm) %d %d %f %p %d %d %f %p %d %d %p %d %d\n", m, k, alpha, sA, ai, aj, beta, sC, ci, cj, sD, di, dj);
@@ -1380,7 +1393,9 @@ lt_1:
 	if(k>K_MAX_STACK && KC>K_MAX_STACK)
 		{
 		pU_size = M_KERNEL*KC*sizeof(double);
-		blasfeo_malloc(&mem, pU_size+64);
+		blasfeo_ws_malloc(&mem, pU_size+64);
+		if(mem==NULL)
+			return;
 		blasfeo_align_64_byte(mem, (void **) &mem_align);
 		pU = (double *) mem_align;
 		sdu = KC;
@@ -1449,7 +1464,7 @@ lt_1:
 #ifdef EXT_DEP_MALLOC
 	if(k>K_MAX_STACK && KC>K_MAX_STACK)
 		{
-		blasfeo_free(mem);
+		blasfeo_ws_free(mem);
 		}
 #endif
 
@@ -1483,7 +1498,9 @@ lt_2:
 	tB_size = (tB_size + 4096 - 1) / 4096 * 4096;
 	if(blasfeo_is_init()==0)
 		{
-		blasfeo_malloc(&mem, tA_size+tB_size+2*4096);
+		blasfeo_ws_malloc(&mem, tA_size+tB_size+2*4096);
+		if(mem==NULL)
+			return;
 		}
 	else
 		{
@@ -1596,7 +1613,7 @@ lt_2:
 
 	if(blasfeo_is_init()==0)
 		{
-		blasfeo_free(mem);
+		blasfeo_ws_free(mem);
 		}
 
 	return;
@@ -1606,7 +1623,9 @@ lt_2:
 	k1 = (k+128-1)/128*128;
 	m1 = (m+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_dmat(ps, m1, k1);
-	blasfeo_malloc(&mem, tA_size+64);
+	blasfeo_ws_malloc(&mem, tA_size+64);
+	if(mem==NULL)
+		return;
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_dmat(ps, m, k, &tA, (void *) mem_align);
 
@@ -1626,7 +1645,7 @@ lt_2:
 
 	blasfeo_hp_dsyrk3_ln_m2(m, k, alpha, pU, sdu, beta, C, ldc, D, ldd);
 
-	blasfeo_free(mem);
+	blasfeo_ws_free(mem);
 	return;
 
 #endif
@@ -1647,6 +1666,9 @@ lt_2:
 void blasfeo_hp_dsyrk3_un(int m, int k, double alpha, struct blasfeo_dmat *sA, int ai, int aj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj)
 	{
 
+	int d_kc, d_nc, d_mc;
+	blasfeo_d_blocking(&d_kc, &d_nc, &d_mc);
+
 #if defined(PRINT_NAME)
 #ifdef EXT_DEP
 	printf("\nblasfeo_hp_dsyrk3_un (cm) %d %d %f %p %d %d %f %p %d %d %p %d %d\n", m, k, alpha, sA, ai, aj, beta, sC, ci, cj, sD, di, dj);
@@ -1777,7 +1799,9 @@ un_1:
 	if(k>K_MAX_STACK && KC>K_MAX_STACK)
 		{
 		pU_size = M_KERNEL*KC*sizeof(double);
-		blasfeo_malloc(&mem, pU_size+64);
+		blasfeo_ws_malloc(&mem, pU_size+64);
+		if(mem==NULL)
+			return;
 		blasfeo_align_64_byte(mem, (void **) &mem_align);
 		pU = (double *) mem_align;
 		sdu = KC;
@@ -1846,7 +1870,7 @@ un_1:
 #ifdef EXT_DEP_MALLOC
 	if(k>K_MAX_STACK && KC>K_MAX_STACK)
 		{
-		blasfeo_free(mem);
+		blasfeo_ws_free(mem);
 		}
 #endif
 
@@ -1880,7 +1904,9 @@ un_2:
 	tB_size = (tB_size + 4096 - 1) / 4096 * 4096;
 	if(blasfeo_is_init()==0)
 		{
-		blasfeo_malloc(&mem, tA_size+tB_size+2*4096);
+		blasfeo_ws_malloc(&mem, tA_size+tB_size+2*4096);
+		if(mem==NULL)
+			return;
 		}
 	else
 		{
@@ -1993,7 +2019,7 @@ un_2:
 
 	if(blasfeo_is_init()==0)
 		{
-		blasfeo_free(mem);
+		blasfeo_ws_free(mem);
 		}
 
 	return;
@@ -2003,7 +2029,9 @@ un_2:
 	k1 = (k+128-1)/128*128;
 	m1 = (m+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_dmat(ps, m1, k1);
-	blasfeo_malloc(&mem, tA_size+64);
+	blasfeo_ws_malloc(&mem, tA_size+64);
+	if(mem==NULL)
+		return;
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_dmat(ps, m, k, &tA, (void *) mem_align);
 
@@ -2021,7 +2049,7 @@ un_2:
 
 	blasfeo_hp_dsyrk3_un_m2(m, k, alpha, pU, sdu, beta, C, ldc, D, ldd);
 
-	blasfeo_free(mem);
+	blasfeo_ws_free(mem);
 	return;
 
 #endif
@@ -2042,6 +2070,9 @@ un_2:
 void blasfeo_hp_dsyrk3_ut(int m, int k, double alpha, struct blasfeo_dmat *sA, int ai, int aj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj)
 	{
 
+	int d_kc, d_nc, d_mc;
+	blasfeo_d_blocking(&d_kc, &d_nc, &d_mc);
+
 #if defined(PRINT_NAME)
 #ifdef EXT_DEP
 	printf("\nblasfeo_hp_dsyrk3_ut (cm) %d %d %f %p %d %d %f %p %d %d %p %d %d\n", m, k, alpha, sA, ai, aj, beta, sC, ci, cj, sD, di, dj);
@@ -2164,7 +2195,9 @@ ut_1:
 	if(k>K_MAX_STACK && KC>K_MAX_STACK)
 		{
 		pU_size = M_KERNEL*KC*sizeof(double);
-		blasfeo_malloc(&mem, pU_size+64);
+		blasfeo_ws_malloc(&mem, pU_size+64);
+		if(mem==NULL)
+			return;
 		blasfeo_align_64_byte(mem, (void **) &mem_align);
 		pU = (double *) mem_align;
 		sdu = KC;
@@ -2233,7 +2266,7 @@ ut_1:
 #ifdef EXT_DEP_MALLOC
 	if(k>K_MAX_STACK && KC>K_MAX_STACK)
 		{
-		blasfeo_free(mem);
+		blasfeo_ws_free(mem);
 		}
 #endif
 
@@ -2267,7 +2300,9 @@ ut_2:
 	tB_size = (tB_size + 4096 - 1) / 4096 * 4096;
 	if(blasfeo_is_init()==0)
 		{
-		blasfeo_malloc(&mem, tA_size+tB_size+2*4096);
+		blasfeo_ws_malloc(&mem, tA_size+tB_size+2*4096);
+		if(mem==NULL)
+			return;
 		}
 	else
 		{
@@ -2380,7 +2415,7 @@ ut_2:
 
 	if(blasfeo_is_init()==0)
 		{
-		blasfeo_free(mem);
+		blasfeo_ws_free(mem);
 		}
 
 	return;
@@ -2390,7 +2425,9 @@ ut_2:
 	k1 = (k+128-1)/128*128;
 	m1 = (m+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_dmat(ps, m1, k1);
-	blasfeo_malloc(&mem, tA_size+64);
+	blasfeo_ws_malloc(&mem, tA_size+64);
+	if(mem==NULL)
+		return;
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_dmat(ps, m, k, &tA, (void *) mem_align);
 
@@ -2409,7 +2446,7 @@ ut_2:
 
 	blasfeo_hp_dsyrk3_un_m2(m, k, alpha, pU, sdu, beta, C, ldc, D, ldd);
 
-	blasfeo_free(mem);
+	blasfeo_ws_free(mem);
 	return;
 
 #endif
@@ -2652,7 +2689,9 @@ lx_2:
 	m1 = (m+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_dmat(ps, m_kernel, k1);
 	tB_size = blasfeo_pm_memsize_dmat(ps, m1, k1);
-	blasfeo_malloc(&mem, tA_size+tB_size+64);
+	blasfeo_ws_malloc(&mem, tA_size+tB_size+64);
+	if(mem==NULL)
+		return;
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_dmat(ps, m_kernel, k, &tA, (void *) mem_align);
 	blasfeo_pm_create_dmat(ps, m, k, &tB, (void *) (mem_align+tA_size));
@@ -2786,7 +2825,7 @@ lx_2_left_4:
 	goto lx_2_return;
 
 lx_2_return:
-	blasfeo_free(mem);
+	blasfeo_ws_free(mem);
 	return;
 
 #else // EXT_DEP_MALLOC
@@ -3106,7 +3145,9 @@ lx_2:
 	m1 = (m+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_dmat(ps, m_kernel, k1);
 	tB_size = blasfeo_pm_memsize_dmat(ps, m1, k1);
-	blasfeo_malloc(&mem, tA_size+tB_size+64);
+	blasfeo_ws_malloc(&mem, tA_size+tB_size+64);
+	if(mem==NULL)
+		return;
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_dmat(ps, m_kernel, k, &tA, (void *) mem_align);
 	blasfeo_pm_create_dmat(ps, m, k, &tB, (void *) (mem_align+tA_size));
@@ -3312,7 +3353,7 @@ lx_2_left_4:
 	goto lx_2_return;
 
 lx_2_return:
-	blasfeo_free(mem);
+	blasfeo_ws_free(mem);
 	return;
 
 #else // EXT_DEP_MALLOC
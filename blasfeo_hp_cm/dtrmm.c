@@ -88,13 +88,14 @@
 
 #define CACHE_LINE_EL D_CACHE_LINE_EL
 #define L1_CACHE_EL D_L1_CACHE_EL
-#define L2_CACHE_EL D_L2_CACHE_EL
-#define LLC_CACHE_EL D_LLC_CACHE_EL
+#define L2_CACHE_EL (blasfeo_l2_cache_size()/D_EL_SIZE)
+#define LLC_CACHE_EL (blasfeo_llc_cache_size()/D_EL_SIZE)
 #define PS D_PS
 #define M_KERNEL D_M_KERNEL
-#define KC D_KC
-#define NC D_NC
-#define MC D_MC
+// runtime cache blocking, read once at routine entry (blasfeo_d_blocking) into d_kc, d_nc, d_mc
+#define KC d_kc
+#define NC d_nc
+#define MC d_mc
 
 
 
@@ -475,6 +476,9 @@ rutn_2_return:
 void blasfeo_hp_dtrmm_llnn(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj)
 	{
 
+	int d_kc, d_nc, d_mc;
+	blasfeo_d_blocking(&d_kc, &d_nc, &d_mc);
+
 #if defined(PRINT_NAME)
 #ifdef EXT_DEP
 	printf("\nblasfeo_hp_dtrmm_llnn (cm) %d %d %f %p %d %d %p %d %d %p %d %d\n", m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj);
@@ -729,7 +733,9 @@ llnn_2:
 	tT_size = (tT_size + 4096 - 1) / 4096 * 4096;
 	if(blasfeo_is_init()==0)
 		{
-		blasfeo_malloc(&mem, tA_size+tB_size+tT_size+2*4096);
+		blasfeo_ws_malloc(&mem, tA_size+tB_size+tT_size+2*4096);
+		if(mem==NULL)
+			return;
 		}
 	else
 		{
@@ -838,7 +844,7 @@ llnn_2:
 
 	if(blasfeo_is_init()==0)
 		{
-		blasfeo_free(mem);
+		blasfeo_ws_free(mem);
 		}
 
 	return;
@@ -849,7 +855,9 @@ llnn_2:
 	n1 = (n+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_dmat(ps, m1, m1);
 	tB_size = blasfeo_pm_memsize_dmat(ps, n1, m1);
-	blasfeo_malloc(&mem, tA_size+tB_size+64);
+	blasfeo_ws_malloc(&mem, tA_size+tB_size+64);
+	if(mem==NULL)
+		return;
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_dmat(ps, m, m, &tA, (void *) mem_align);
 	blasfeo_pm_create_dmat(ps, n, m, &tB, (void *) (mem_align+tA_size));
@@ -869,7 +877,7 @@ llnn_2:
 
 	blasfeo_hp_dtrmm_llnn_m2(m, n, alpha, pA, sda, pB, sdb, D, ldd);
 
-	blasfeo_free(mem);
+	blasfeo_ws_free(mem);
 	return;
 
 #endif
@@ -1104,7 +1112,9 @@ llnu_2:
 	m1 = (m+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_dmat(ps, m_kernel, m1);
 	tB_size = blasfeo_pm_memsize_dmat(ps, m1, m1);
-	blasfeo_malloc(&mem, tA_size+tB_size+64);
+	blasfeo_ws_malloc(&mem, tA_size+tB_size+64);
+	if(mem==NULL)
+		return;
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_dmat(ps, m_kernel, m, &tA, (void *) mem_align);
 	blasfeo_pm_create_dmat(ps, m, m, &tB, (void *) (mem_align+tA_size));
@@ -1234,7 +1244,7 @@ llnu_2_left_4:
 goto llnu_2_return;
 
 llnu_2_return:
-	blasfeo_free(mem);
+	blasfeo_ws_free(mem);
 	return;
 
 #else // EXT_DEP_MALLOC
@@ -1252,6 +1262,9 @@ llnu_2_return:
 void blasfeo_hp_dtrmm_lltn(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj)
 	{
 
+	int d_kc, d_nc, d_mc;
+	blasfeo_d_blocking(&d_kc, &d_nc, &d_mc);
+
 #if defined(PRINT_NAME)
 #ifdef EXT_DEP
 	printf("\nblasfeo_hp_dtrmm_lltn (cm) %d %d %f %p %d %d %p %d %d %p %d %d\n", m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj);
@@ -1505,7 +1518,9 @@ lunn_2:
 	tT_size = (tT_size + 4096 - 1) / 4096 * 4096;
 	if(blasfeo_is_init()==0)
 		{
-		blasfeo_malloc(&mem, tA_size+tB_size+tT_size+2*4096);
+		blasfeo_ws_malloc(&mem, tA_size+tB_size+tT_size+2*4096);
+		if(mem==NULL)
+			return;
 		}
 	else
 		{
@@ -1613,7 +1628,7 @@ lunn_2:
 
 	if(blasfeo_is_init()==0)
 		{
-		blasfeo_free(mem);
+		blasfeo_ws_free(mem);
 		}
 
 	return;
@@ -1623,7 +1638,9 @@ lunn_2:
 	n1 = (n+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_dmat(ps, m1, m1);
 	tB_size = blasfeo_pm_memsize_dmat(ps, n1, m1);
-	blasfeo_malloc(&mem, tA_size+tB_size+64);
+	blasfeo_ws_malloc(&mem, tA_size+tB_size+64);
+	if(mem==NULL)
+		return;
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_dmat(ps, m, m, &tA, (void *) mem_align);
 	blasfeo_pm_create_dmat(ps, n, m, &tB, (void *) (mem_align+tA_size));
@@ -1643,7 +1660,7 @@ lunn_2:
 
 	blasfeo_hp_dtrmm_lunn_m2(m, n, alpha, pA, sda, pB, sdb, D, ldd);
 
-	blasfeo_free(mem);
+	blasfeo_ws_free(mem);
 	return;
 
 #endif
@@ -1876,7 +1893,9 @@ lunu_2:
 	m1 = (m+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_dmat(ps, m_kernel, m1);
 	tB_size = blasfeo_pm_memsize_dmat(ps, m1, m1);
-	blasfeo_malloc(&mem, tA_size+tB_size+64);
+	blasfeo_ws_malloc(&mem, tA_size+tB_size+64);
+	if(mem==NULL)
+		return;
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_dmat(ps, m_kernel, m, &tA, (void *) mem_align);
 	blasfeo_pm_create_dmat(ps, m, m, &tB, (void *) (mem_align+tA_size));
@@ -2006,7 +2025,7 @@ lunu_2_left_4:
 goto lunu_2_return;
 
 lunu_2_return:
-	blasfeo_free(mem);
+	blasfeo_ws_free(mem);
 	return;
 
 #else // EXT_DEP_MALLOC
@@ -2238,7 +2257,9 @@ lunn_2:
 	m1 = (m+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_dmat(ps, m_kernel, m1);
 	tB_size = blasfeo_pm_memsize_dmat(ps, m1, m1);
-	blasfeo_malloc(&mem, tA_size+tB_size+64);
+	blasfeo_ws_malloc(&mem, tA_size+tB_size+64);
+	if(mem==NULL)
+		return;
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_dmat(ps, m_kernel, m, &tA, (void *) mem_align);
 	blasfeo_pm_create_dmat(ps, m, m, &tB, (void *) (mem_align+tA_size));
@@ -2368,7 +2389,7 @@ lunn_2_left_4:
 goto lunn_2_return;
 
 lunn_2_return:
-	blasfeo_free(mem);
+	blasfeo_ws_free(mem);
 	return;
 
 #else // EXT_DEP_MALLOC
@@ -2600,7 +2621,9 @@ lunu_2:
 	m1 = (m+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_dmat(ps, m_kernel, m1);
 	tB_size = blasfeo_pm_memsize_dmat(ps, m1, m1);
-	blasfeo_malloc(&mem, tA_size+tB_size+64);
+	blasfeo_ws_malloc(&mem, tA_size+tB_size+64);
+	if(mem==NULL)
+		return;
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_dmat(ps, m_kernel, m, &tA, (void *) mem_align);
 	blasfeo_pm_create_dmat(ps, m, m, &tB, (void *) (mem_align+tA_size));
@@ -2730,7 +2753,7 @@ lunu_2_left_4:
 goto lunu_2_return;
 
 lunu_2_return:
-	blasfeo_free(mem);
+	blasfeo_ws_free(mem);
 	return;
 
 #else // EXT_DEP_MALLOC
@@ -2961,7 +2984,9 @@ llnn_2:
 	m1 = (m+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_dmat(ps, m_kernel, m1);
 	tB_size = blasfeo_pm_memsize_dmat(ps, m1, m1);
-	blasfeo_malloc(&mem, tA_size+tB_size+64);
+	blasfeo_ws_malloc(&mem, tA_size+tB_size+64);
+	if(mem==NULL)
+		return;
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_dmat(ps, m_kernel, m, &tA, (void *) mem_align);
 	blasfeo_pm_create_dmat(ps, m, m, &tB, (void *) (mem_align+tA_size));
@@ -3091,7 +3116,7 @@ llnn_2_left_4:
 goto llnn_2_return;
 
 llnn_2_return:
-	blasfeo_free(mem);
+	blasfeo_ws_free(mem);
 	return;
 
 #else // EXT_DEP_MALLOC
@@ -3322,7 +3347,9 @@ llnu_2:
 	m1 = (m+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_dmat(ps, m_kernel, m1);
 	tB_size = blasfeo_pm_memsize_dmat(ps, m1, m1);
-	blasfeo_malloc(&mem, tA_size+tB_size+64);
+	blasfeo_ws_malloc(&mem, tA_size+tB_size+64);
+	if(mem==NULL)
+		return;
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_dmat(ps, m_kernel, m, &tA, (void *) mem_align);
 	blasfeo_pm_create_dmat(ps, m, m, &tB, (void *) (mem_align+tA_size));
@@ -3452,7 +3479,7 @@ llnu_2_left_4:
 goto llnu_2_return;
 
 llnu_2_return:
-	blasfeo_free(mem);
+	blasfeo_ws_free(mem);
 	return;
 
 #else // EXT_DEP_MALLOC
@@ -3470,6 +3497,9 @@ llnu_2_return:
 void blasfeo_hp_dtrmm_rlnn(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj)
 	{
 
+	int d_kc, d_nc, d_mc;
+	blasfeo_d_blocking(&d_kc, &d_nc, &d_mc);
+
 #if defined(PRINT_NAME)
 #ifdef EXT_DEP
 	printf("\nblasfeo_hp_dtrmm_rlnn (cm) %d %d %f %p %d %d %p %d %d %p %d %d\n", m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj);
@@ -3716,7 +3746,9 @@ rutn_2:
 	tT_size = (tT_size + 4096 - 1) / 4096 * 4096;
 	if(blasfeo_is_init()==0)
 		{
-		blasfeo_malloc(&mem, tA_size+tB_size+tT_size+2*4096);
+		blasfeo_ws_malloc(&mem, tA_size+tB_size+tT_size+2*4096);
+		if(mem==NULL)
+			return;
 		}
 	else
 		{
@@ -3820,7 +3852,7 @@ rutn_2:
 
 	if(blasfeo_is_init()==0)
 		{
-		blasfeo_free(mem);
+		blasfeo_ws_free(mem);
 		}
 
 	return;
@@ -3851,7 +3883,9 @@ rutn_2:
 	tT_size = (tT_size + 4096 - 1) / 4096 * 4096;
 	if(blasfeo_is_init()==0)
 		{
-		blasfeo_malloc(&mem, tA_size+tB_size+tT_size+2*4096);
+		blasfeo_ws_malloc(&mem, tA_size+tB_size+tT_size+2*4096);
+		if(mem==NULL)
+			return;
 		}
 	else
 		{
@@ -3940,7 +3974,7 @@ rutn_2:
 
 	if(blasfeo_is_init()==0)
 		{
-		blasfeo_free(mem);
+		blasfeo_ws_free(mem);
 		}
 
 	return;
@@ -3953,7 +3987,9 @@ rutn_2:
 	n1 = (n+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_dmat(ps, n1, n1);
 	tB_size = blasfeo_pm_memsize_dmat(ps, m1, n1);
-	blasfeo_malloc(&mem, tA_size+tB_size+64);
+	blasfeo_ws_malloc(&mem, tA_size+tB_size+64);
+	if(mem==NULL)
+		return;
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_dmat(ps, n, n, &tA, (void *) mem_align);
 	blasfeo_pm_create_dmat(ps, m, n, &tB, (void *) (mem_align+tA_size));
@@ -3973,7 +4009,7 @@ rutn_2:
 
 	blasfeo_hp_dtrmm_rutn_m2(m, n, alpha, pA, sda, pB, sdb, D, ldd);
 
-	blasfeo_free(mem);
+	blasfeo_ws_free(mem);
 	return;
 
 #endif
@@ -4201,7 +4237,9 @@ rutu_2:
 	n1 = (n+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_dmat(ps, m_kernel, n1);
 	tB_size = blasfeo_pm_memsize_dmat(ps, n1, n1);
-	blasfeo_malloc(&mem, tA_size+tB_size+64);
+	blasfeo_ws_malloc(&mem, tA_size+tB_size+64);
+	if(mem==NULL)
+		return;
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_dmat(ps, m_kernel, n, &tA, (void *) mem_align);
 	blasfeo_pm_create_dmat(ps, n, n, &tB, (void *) (mem_align+tA_size));
@@ -4325,7 +4363,7 @@ rutu_2_left_4:
 goto rutu_2_return;
 
 rutu_2_return:
-	blasfeo_free(mem);
+	blasfeo_ws_free(mem);
 	return;
 
 #else // EXT_DEP_MALLOC
@@ -4551,7 +4589,9 @@ rltn_2:
 	n1 = (n+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_dmat(ps, m_kernel, n1);
 	tB_size = blasfeo_pm_memsize_dmat(ps, n1, n1);
-	blasfeo_malloc(&mem, tA_size+tB_size+64);
+	blasfeo_ws_malloc(&mem, tA_size+tB_size+64);
+	if(mem==NULL)
+		return;
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_dmat(ps, m_kernel, n, &tA, (void *) mem_align);
 	blasfeo_pm_create_dmat(ps, n, n, &tB, (void *) (mem_align+tA_size));
@@ -4683,7 +4723,7 @@ rltn_2_left_4:
 goto rltn_2_return;
 
 rltn_2_return:
-	blasfeo_free(mem);
+	blasfeo_ws_free(mem);
 	return;
 
 #else // EXT_DEP_MALLOC
@@ -4910,7 +4950,9 @@ rltu_2:
 	n1 = (n+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_dmat(ps, m_kernel, n1);
 	tB_size = blasfeo_pm_memsize_dmat(ps, n1, n1);
-	blasfeo_malloc(&mem, tA_size+tB_size+64);
+	blasfeo_ws_malloc(&mem, tA_size+tB_size+64);
+	if(mem==NULL)
+		return;
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_dmat(ps, m_kernel, n, &tA, (void *) mem_align);
 	blasfeo_pm_create_dmat(ps, n, n, &tB, (void *) (mem_align+tA_size));
@@ -5042,7 +5084,7 @@ rltu_2_left_4:
 goto rltu_2_return;
 
 rltu_2_return:
-	blasfeo_free(mem);
+	blasfeo_ws_free(mem);
 	return;
 
 #else // EXT_DEP_MALLOC
@@ -5268,7 +5310,9 @@ rltn_2:
 	n1 = (n+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_dmat(ps, m_kernel, n1);
 	tB_size = blasfeo_pm_memsize_dmat(ps, n1, n1);
-	blasfeo_malloc(&mem, tA_size+tB_size+64);
+	blasfeo_ws_malloc(&mem, tA_size+tB_size+64);
+	if(mem==NULL)
+		return;
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_dmat(ps, m_kernel, n, &tA, (void *) mem_align);
 	blasfeo_pm_create_dmat(ps, n, n, &tB, (void *) (mem_align+tA_size));
@@ -5392,7 +5436,7 @@ rltn_2_left_4:
 goto rltn_2_return;
 
 rltn_2_return:
-	blasfeo_free(mem);
+	blasfeo_ws_free(mem);
 	return;
 
 #else // EXT_DEP_MALLOC
@@ -5618,7 +5662,9 @@ rltu_2:
 	n1 = (n+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_dmat(ps, m_kernel, n1);
 	tB_size = blasfeo_pm_memsize_dmat(ps, n1, n1);
-	blasfeo_malloc(&mem, tA_size+tB_size+64);
+	blasfeo_ws_malloc(&mem, tA_size+tB_size+64);
+	if(mem==NULL)
+		return;
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_dmat(ps, m_kernel, n, &tA, (void *) mem_align);
 	blasfeo_pm_create_dmat(ps, n, n, &tB, (void *) (mem_align+tA_size));
@@ -5742,7 +5788,7 @@ rltu_2_left_4:
 goto rltu_2_return;
 
 rltu_2_return:
-	blasfeo_free(mem);
+	blasfeo_ws_free(mem);
 	return;
 
 #else // EXT_DEP_MALLOC
@@ -5969,7 +6015,9 @@ rutn_2:
 	n1 = (n+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_dmat(ps, m_kernel, n1);
 	tB_size = blasfeo_pm_memsize_dmat(ps, n1, n1);
-	blasfeo_malloc(&mem, tA_size+tB_size+64);
+	blasfeo_ws_malloc(&mem, tA_size+tB_size+64);
+	if(mem==NULL)
+		return;
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_dmat(ps, m_kernel, n, &tA, (void *) mem_align);
 	blasfeo_pm_create_dmat(ps, n, n, &tB, (void *) (mem_align+tA_size));
@@ -6104,7 +6152,7 @@ rutn_2_left_4:
 goto rutn_2_return;
 
 rutn_2_return:
-	blasfeo_free(mem);
+	blasfeo_ws_free(mem);
 	return;
 
 #else // EXT_DEP_MALLOC
@@ -6331,7 +6379,9 @@ rutu_2:
 	n1 = (n+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_dmat(ps, m_kernel, n1);
 	tB_size = blasfeo_pm_memsize_dmat(ps, n1, n1);
-	blasfeo_malloc(&mem, tA_size+tB_size+64);
+	blasfeo_ws_malloc(&mem, tA_size+tB_size+64);
+	if(mem==NULL)
+		return;
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_dmat(ps, m_kernel, n, &tA, (void *) mem_align);
 	blasfeo_pm_create_dmat(ps, n, n, &tB, (void *) (mem_align+tA_size));
@@ -6465,7 +6515,7 @@ rutu_2_left_4:
 goto rutu_2_return;
 
 rutu_2_return:
-	blasfeo_free(mem);
+	blasfeo_ws_free(mem);
 	return;
 
 #else // EXT_DEP_MALLOC
@@ -95,13 +95,14 @@
 
 #define CACHE_LINE_EL D_CACHE_LINE_EL
 #define L1_CACHE_EL D_L1_CACHE_EL
-#define L2_CACHE_EL D_L2_CACHE_EL
-#define LLC_CACHE_EL D_LLC_CACHE_EL
+#define L2_CACHE_EL (blasfeo_l2_cache_size()/D_EL_SIZE)
+#define LLC_CACHE_EL (blasfeo_llc_cache_size()/D_EL_SIZE)
 #define PS D_PS
 #define M_KERNEL D_M_KERNEL
-#define KC D_KC
-#define NC D_NC
-#define MC D_MC
+// runtime cache blocking, read once at routine entry (blasfeo_d_blocking) into d_kc, d_nc, d_mc
+#define KC d_kc
+#define NC d_nc
+#define MC d_mc
 
 
 
@@ -1038,7 +1039,9 @@ llnn_2:
 	m1 = (m+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_dmat(ps, m_kernel, m1);
 	tB_size = blasfeo_pm_memsize_dmat(ps, m1, m1);
-	blasfeo_malloc(&mem, tA_size+tB_size+64);
+	blasfeo_ws_malloc(&mem, tA_size+tB_size+64);
+	if(mem==NULL)
+		return;
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_dmat(ps, m_kernel, m, &tA, (void *) mem_align);
 	blasfeo_pm_create_dmat(ps, m, m, &tB, (void *) (mem_align+tA_size));
@@ -1184,7 +1187,7 @@ llnn_2_left_4:
 goto llnn_2_return;
 
 llnn_2_return:
-	blasfeo_free(mem);
+	blasfeo_ws_free(mem);
 	return;
 
 #else // EXT_DEP_MALLOC
@@ -1435,7 +1438,9 @@ llnu_2:
 	m1 = (m+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_dmat(ps, m_kernel, m1);
 	tB_size = blasfeo_pm_memsize_dmat(ps, m1, m1);
-	blasfeo_malloc(&mem, tA_size+tB_size+64);
+	blasfeo_ws_malloc(&mem, tA_size+tB_size+64);
+	if(mem==NULL)
+		return;
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_dmat(ps, m_kernel, m, &tA, (void *) mem_align);
 	blasfeo_pm_create_dmat(ps, m, m, &tB, (void *) (mem_align+tA_size));
@@ -1578,7 +1583,7 @@ llnu_2_left_4:
 goto llnu_2_return;
 
 llnu_2_return:
-	blasfeo_free(mem);
+	blasfeo_ws_free(mem);
 	return;
 
 #else // EXT_DEP_MALLOC
@@ -1862,7 +1867,9 @@ lunn_2:
 	m1 = (m+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_dmat(ps, m_kernel, m1);
 	tB_size = blasfeo_pm_memsize_dmat(ps, m1, m1);
-	blasfeo_malloc(&mem, tA_size+tB_size+64);
+	blasfeo_ws_malloc(&mem, tA_size+tB_size+64);
+	if(mem==NULL)
+		return;
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_dmat(ps, m_kernel, m, &tA, (void *) mem_align);
 	blasfeo_pm_create_dmat(ps, m, m, &tB, (void *) (mem_align+tA_size));
@@ -2035,7 +2042,7 @@ lunn_2_left_4:
 	goto lunn_2_return;
 
 lunn_2_return:
-	blasfeo_free(mem);
+	blasfeo_ws_free(mem);
 	return;
 
 #else // EXT_DEP_MALLOC
@@ -2312,7 +2319,9 @@ lunu_2:
 	m1 = (m+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_dmat(ps, m_kernel, m1);
 	tB_size = blasfeo_pm_memsize_dmat(ps, m1, m1);
-	blasfeo_malloc(&mem, tA_size+tB_size+64);
+	blasfeo_ws_malloc(&mem, tA_size+tB_size+64);
+	if(mem==NULL)
+		return;
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_dmat(ps, m_kernel, m, &tA, (void *) mem_align);
 	blasfeo_pm_create_dmat(ps, m, m, &tB, (void *) (mem_align+tA_size));
@@ -2482,7 +2491,7 @@ lunu_2_left_4:
 	goto lunu_2_return;
 
 lunu_2_return:
-	blasfeo_free(mem);
+	blasfeo_ws_free(mem);
 	return;
 
 #else // EXT_DEP_MALLOC
@@ -2762,7 +2771,9 @@ lunn_2:
 	m1 = (m+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_dmat(ps, m_kernel, m1);
 	tB_size = blasfeo_pm_memsize_dmat(ps, m1, m1);
-	blasfeo_malloc(&mem, tA_size+tB_size+64);
+	blasfeo_ws_malloc(&mem, tA_size+tB_size+64);
+	if(mem==NULL)
+		return;
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_dmat(ps, m_kernel, m, &tA, (void *) mem_align);
 	blasfeo_pm_create_dmat(ps, m, m, &tB, (void *) (mem_align+tA_size));
@@ -2935,7 +2946,7 @@ lunn_2_left_4:
 	goto lunn_2_return;
 
 lunn_2_return:
-	blasfeo_free(mem);
+	blasfeo_ws_free(mem);
 	return;
 
 #else // EXT_DEP_MALLOC
@@ -3208,7 +3219,9 @@ lunu_2:
 	m1 = (m+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_dmat(ps, m_kernel, m1);
 	tB_size = blasfeo_pm_memsize_dmat(ps, m1, m1);
-	blasfeo_malloc(&mem, tA_size+tB_size+64);
+	blasfeo_ws_malloc(&mem, tA_size+tB_size+64);
+	if(mem==NULL)
+		return;
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_dmat(ps, m_kernel, m, &tA, (void *) mem_align);
 	blasfeo_pm_create_dmat(ps, m, m, &tB, (void *) (mem_align+tA_size));
@@ -3378,7 +3391,7 @@ lunu_2_left_4:
 	goto lunu_2_return;
 
 lunu_2_return:
-	blasfeo_free(mem);
+	blasfeo_ws_free(mem);
 	return;
 
 #else // EXT_DEP_MALLOC
@@ -3396,6 +3409,9 @@ lunu_2_return:
 void blasfeo_hp_dtrsm_lutn(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj)
 	{
 
+	int d_kc, d_nc, d_mc;
+	blasfeo_d_blocking(&d_kc, &d_nc, &d_mc);
+
 #if defined(PRINT_NAME)
 #ifdef EXT_DEP
 	printf("\nblasfeo_hp_dtrsm_lutn (cm) %d %d %f %p %d %d %p %d %d %p %d %d\n", m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj);
@@ -3697,7 +3713,9 @@ llnn_2:
 	tT_size = (tT_size + 4096 - 1) / 4096 * 4096;
 	if(blasfeo_is_init()==0)
 		{
-		blasfeo_malloc(&mem, tA_size+tB_size+tT_size+2*4096);
+		blasfeo_ws_malloc(&mem, tA_size+tB_size+tT_size+2*4096);
+		if(mem==NULL)
+			return;
 		}
 	else
 		{
@@ -3820,7 +3838,7 @@ llnn_2:
 	
 	if(blasfeo_is_init()==0)
 		{
-		blasfeo_free(mem);
+		blasfeo_ws_free(mem);
 		}
 
 	return;
@@ -3851,7 +3869,9 @@ llnn_2:
 	tT_size = (tT_size + 4096 - 1) / 4096 * 4096;
 	if(blasfeo_is_init()==0)
 		{
-		blasfeo_malloc(&mem, tA_size+tB_size+tT_size+2*4096);
+		blasfeo_ws_malloc(&mem, tA_size+tB_size+tT_size+2*4096);
+		if(mem==NULL)
+			return;
 		}
 	else
 		{
@@ -3940,7 +3960,7 @@ llnn_2:
 
 	if(blasfeo_is_init()==0)
 		{
-		blasfeo_free(mem);
+		blasfeo_ws_free(mem);
 		}
 
 	return;
@@ -3953,7 +3973,9 @@ llnn_2:
 	n1 = (n+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_dmat(ps, m1, m1);
 	tB_size = blasfeo_pm_memsize_dmat(ps, m1, n1);
-	blasfeo_malloc(&mem, tA_size+tB_size+64);
+	blasfeo_ws_malloc(&mem, tA_size+tB_size+64);
+	if(mem==NULL)
+		return;
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_dmat(ps, m, m, &tA, (void *) mem_align);
 	blasfeo_pm_create_dmat(ps, m, n, &tB, (void *) (mem_align+tA_size));
@@ -3973,7 +3995,7 @@ llnn_2:
 
 	blasfeo_hp_dtrsm_llnn_m2(m, n, alpha, pA, sda, dA, B, ldb, D, ldd, pB, sdb);
 
-	blasfeo_free(mem);
+	blasfeo_ws_free(mem);
 	return;
 
 #endif
@@ -4224,7 +4246,9 @@ llnu_2:
 	m1 = (m+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_dmat(ps, m_kernel, m1);
 	tB_size = blasfeo_pm_memsize_dmat(ps, m1, m1);
-	blasfeo_malloc(&mem, tA_size+tB_size+64);
+	blasfeo_ws_malloc(&mem, tA_size+tB_size+64);
+	if(mem==NULL)
+		return;
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_dmat(ps, m_kernel, m, &tA, (void *) mem_align);
 	blasfeo_pm_create_dmat(ps, m, m, &tB, (void *) (mem_align+tA_size));
@@ -4367,7 +4391,7 @@ llnu_2_left_4:
 goto llnu_2_return;
 
 llnu_2_return:
-	blasfeo_free(mem);
+	blasfeo_ws_free(mem);
 	return;
 
 #else // EXT_DEP_MALLOC
@@ -4386,6 +4410,9 @@ llnu_2_return:
 void blasfeo_hp_dtrsm_rlnn(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj)
 	{
 
+	int d_kc, d_nc, d_mc;
+	blasfeo_d_blocking(&d_kc, &d_nc, &d_mc);
+
 #if defined(PRINT_NAME)
 #ifdef EXT_DEP
 	printf("\nblasfeo_hp_dtrsm_rlnn (cm) %d %d %f %p %d %d %p %d %d %p %d %d\n", m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj);
@@ -4675,7 +4702,9 @@ rutn_2:
 	tT_size = (tT_size + 4096 - 1) / 4096 * 4096;
 	if(blasfeo_is_init()==0)
 		{
-		blasfeo_malloc(&mem, tA_size+tB_size+tT_size+2*4096);
+		blasfeo_ws_malloc(&mem, tA_size+tB_size+tT_size+2*4096);
+		if(mem==NULL)
+			return;
 		}
 	else
 		{
@@ -4768,7 +4797,7 @@ rutn_2:
 	
 	if(blasfeo_is_init()==0)
 		{
-		blasfeo_free(mem);
+		blasfeo_ws_free(mem);
 		}
 
 	return;
@@ -4779,7 +4808,9 @@ rutn_2:
 	n1 = (n+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_dmat(ps, n1, n1);
 	tB_size = blasfeo_pm_memsize_dmat(ps, m1, n1);
-	blasfeo_malloc(&mem, tA_size+tB_size+64);
+	blasfeo_ws_malloc(&mem, tA_size+tB_size+64);
+	if(mem==NULL)
+		return;
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_dmat(ps, n, n, &tA, (void *) mem_align);
 	blasfeo_pm_create_dmat(ps, m, n, &tB, (void *) (mem_align+tA_size));
@@ -4801,7 +4832,7 @@ rutn_2:
 
 	blasfeo_hp_dtrsm_rutn_m2(m, n, alpha, pA, sda, dA, B, ldb, D, ldd, pB, sdb);
 
-	blasfeo_free(mem);
+	blasfeo_ws_free(mem);
 	return;
 
 #endif
@@ -5069,7 +5100,9 @@ rutu_2:
 	n1 = (n+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_dmat(ps, m_kernel, n1);
 	tB_size = blasfeo_pm_memsize_dmat(ps, n1, n1);
-	blasfeo_malloc(&mem, tA_size+tB_size+64);
+	blasfeo_ws_malloc(&mem, tA_size+tB_size+64);
+	if(mem==NULL)
+		return;
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_dmat(ps, m_kernel, n, &tA, (void *) mem_align);
 	blasfeo_pm_create_dmat(ps, n, n, &tB, (void *) (mem_align+tA_size));
@@ -5227,7 +5260,7 @@ rutu_2_left_4:
 	goto rutu_2_return;
 
 rutu_2_return:
-	blasfeo_free(mem);
+	blasfeo_ws_free(mem);
 	return;
 
 #else // EXT_DEP_MALLOC
@@ -5245,6 +5278,9 @@ rutu_2_return:
 void blasfeo_hp_dtrsm_rltn(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj)
 	{
 
+	int d_kc, d_nc, d_mc;
+	blasfeo_d_blocking(&d_kc, &d_nc, &d_mc);
+
 #if defined(PRINT_NAME)
 #ifdef EXT_DEP
 	printf("\nblasfeo_hp_dtrsm_rltn (cm) %d %d %f %p %d %d %p %d %d %p %d %d\n", m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj);
@@ -5506,7 +5542,9 @@ rltn_2:
 	tT_size = (tT_size + 4096 - 1) / 4096 * 4096;
 	if(blasfeo_is_init()==0)
 		{
-		blasfeo_malloc(&mem, tA_size+tB_size+tT_size+2*4096);
+		blasfeo_ws_malloc(&mem, tA_size+tB_size+tT_size+2*4096);
+		if(mem==NULL)
+			return;
 		}
 	else
 		{
@@ -5596,7 +5634,7 @@ rltn_2:
 	
 	if(blasfeo_is_init()==0)
 		{
-		blasfeo_free(mem);
+		blasfeo_ws_free(mem);
 		}
 
 	return;
@@ -5607,7 +5645,9 @@ rltn_2:
 	n1 = (n+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_dmat(ps, n1, n1);
 	tB_size = blasfeo_pm_memsize_dmat(ps, m1, n1);
-	blasfeo_malloc(&mem, tA_size+tB_size+64);
+	blasfeo_ws_malloc(&mem, tA_size+tB_size+64);
+	if(mem==NULL)
+		return;
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_dmat(ps, n, n, &tA, (void *) mem_align);
 	blasfeo_pm_create_dmat(ps, m, n, &tB, (void *) (mem_align+tA_size));
@@ -5629,7 +5669,7 @@ rltn_2:
 
 	blasfeo_hp_dtrsm_rltn_m2(m, n, alpha, pA, sda, dA, B, ldb, D, ldd, pB, sdb);
 
-	blasfeo_free(mem);
+	blasfeo_ws_free(mem);
 	return;
 
 #endif
@@ -5868,7 +5908,9 @@ rltu_2:
 	n1 = (n+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_dmat(ps, m_kernel, n1);
 	tB_size = blasfeo_pm_memsize_dmat(ps, n1, n1);
-	blasfeo_malloc(&mem, tA_size+tB_size+64);
+	blasfeo_ws_malloc(&mem, tA_size+tB_size+64);
+	if(mem==NULL)
+		return;
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_dmat(ps, m_kernel, n, &tA, (void *) mem_align);
 	blasfeo_pm_create_dmat(ps, n, n, &tB, (void *) (mem_align+tA_size));
@@ -6031,7 +6073,7 @@ rltu_2_left_4:
 goto rltu_2_return;
 
 rltu_2_return:
-	blasfeo_free(mem);
+	blasfeo_ws_free(mem);
 	return;
 
 #else // EXT_DEP_MALLOC
@@ -6271,7 +6313,9 @@ rltn_2:
 	n1 = (n+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_dmat(ps, m_kernel, n1);
 	tB_size = blasfeo_pm_memsize_dmat(ps, n1, n1);
-	blasfeo_malloc(&mem, tA_size+tB_size+64);
+	blasfeo_ws_malloc(&mem, tA_size+tB_size+64);
+	if(mem==NULL)
+		return;
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_dmat(ps, m_kernel, n, &tA, (void *) mem_align);
 	blasfeo_pm_create_dmat(ps, n, n, &tB, (void *) (mem_align+tA_size));
@@ -6415,7 +6459,7 @@ rltn_2_left_4:
 goto rltn_2_return;
 
 rltn_2_return:
-	blasfeo_free(mem);
+	blasfeo_ws_free(mem);
 	return;
 
 #else // EXT_DEP_MALLOC
@@ -6650,7 +6694,9 @@ rltu_2:
 	n1 = (n+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_dmat(ps, m_kernel, n1);
 	tB_size = blasfeo_pm_memsize_dmat(ps, n1, n1);
-	blasfeo_malloc(&mem, tA_size+tB_size+64);
+	blasfeo_ws_malloc(&mem, tA_size+tB_size+64);
+	if(mem==NULL)
+		return;
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_dmat(ps, m_kernel, n, &tA, (void *) mem_align);
 	blasfeo_pm_create_dmat(ps, n, n, &tB, (void *) (mem_align+tA_size));
@@ -6791,7 +6837,7 @@ rltu_2_left_4:
 goto rltu_2_return;
 
 rltu_2_return:
-	blasfeo_free(mem);
+	blasfeo_ws_free(mem);
 	return;
 
 #else // EXT_DEP_MALLOC
@@ -7059,7 +7105,9 @@ rutn_2:
 	n1 = (n+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_dmat(ps, m_kernel, n1);
 	tB_size = blasfeo_pm_memsize_dmat(ps, n1, n1);
-	blasfeo_malloc(&mem, tA_size+tB_size+64);
+	blasfeo_ws_malloc(&mem, tA_size+tB_size+64);
+	if(mem==NULL)
+		return;
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_dmat(ps, m_kernel, n, &tA, (void *) mem_align);
 	blasfeo_pm_create_dmat(ps, n, n, &tB, (void *) (mem_align+tA_size));
@@ -7231,7 +7279,7 @@ rutn_2_left_4:
 	goto rutn_2_return;
 
 rutn_2_return:
-	blasfeo_free(mem);
+	blasfeo_ws_free(mem);
 	return;
 
 #else // EXT_DEP_MALLOC
@@ -7497,7 +7545,9 @@ rutu_2:
 	n1 = (n+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_dmat(ps, m_kernel, n1);
 	tB_size = blasfeo_pm_memsize_dmat(ps, n1, n1);
-	blasfeo_malloc(&mem, tA_size+tB_size+64);
+	blasfeo_ws_malloc(&mem, tA_size+tB_size+64);
+	if(mem==NULL)
+		return;
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_dmat(ps, m_kernel, n, &tA, (void *) mem_align);
 	blasfeo_pm_create_dmat(ps, n, n, &tB, (void *) (mem_align+tA_size));
@@ -7665,7 +7715,7 @@ rutu_2_left_4:
 	goto rutu_2_return;
 
 rutu_2_return:
-	blasfeo_free(mem);
+	blasfeo_ws_free(mem);
 	return;
 
 #else // EXT_DEP_MALLOC
@@ -2218,7 +2218,9 @@ nn_2:
 #if 1
 	if(blasfeo_is_init()==0)
 		{
-		blasfeo_malloc(&mem, tA_size+tB_size+2*4096);
+		blasfeo_ws_malloc(&mem, tA_size+tB_size+2*4096);
+		if(mem==NULL)
+			return;
 		}
 	else
 		{
@@ -2364,7 +2366,7 @@ nn_2:
 //	printf("\ntime: pack_A %e, pack_B %e, kernel %e, kernel2 %e, kernel3 %e\n", time_pack_A, time_pack_B, time_kernel, time_kernel2, time_kernel3); 
 	if(blasfeo_is_init()==0)
 		{
-		blasfeo_free(mem);
+		blasfeo_ws_free(mem);
 		}
 
 	return;
@@ -2377,7 +2379,9 @@ nn_2:
 	n1 = (n+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_smat(ps, m_kernel, k1);
 	tB_size = blasfeo_pm_memsize_smat(ps, n1, k1);
-	mem = malloc(tA_size+tB_size+64);
+	blasfeo_ws_malloc((void **) &mem, tA_size+tB_size+64);
+	if(mem==NULL)
+		return;
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_smat(ps, m_kernel, k, &tA, (void *) mem_align);
 	blasfeo_pm_create_smat(ps, n, k, &tB, (void *) (mem_align+tA_size));
@@ -2659,7 +2663,7 @@ nn_2_left_4:
 	goto nn_2_return;
 
 nn_2_return:
-	free(mem);
+	blasfeo_ws_free(mem);
 	return;
 
 
@@ -3035,7 +3039,9 @@ nt_2:
 #if 1
 	if(blasfeo_is_init()==0)
 		{
-		blasfeo_malloc(&mem, tA_size+tB_size+2*4096);
+		blasfeo_ws_malloc(&mem, tA_size+tB_size+2*4096);
+		if(mem==NULL)
+			return;
 		}
 	else
 		{
@@ -3181,7 +3187,7 @@ nt_2:
 //	printf("\ntime: pack_A %e, pack_B %e, kernel %e, kernel2 %e, kernel3 %e\n", time_pack_A, time_pack_B, time_kernel, time_kernel2, time_kernel3); 
 	if(blasfeo_is_init()==0)
 		{
-		blasfeo_free(mem);
+		blasfeo_ws_free(mem);
 		}
 
 	return;
@@ -3194,7 +3200,9 @@ nt_2:
 	n1 = (n+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_smat(ps, m_kernel, k1);
 	tB_size = blasfeo_pm_memsize_smat(ps, n1, k1);
-	mem = malloc(tA_size+tB_size+64);
+	blasfeo_ws_malloc((void **) &mem, tA_size+tB_size+64);
+	if(mem==NULL)
+		return;
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_smat(ps, m_kernel, k, &tA, (void *) mem_align);
 	blasfeo_pm_create_smat(ps, n, k, &tB, (void *) (mem_align+tA_size));
@@ -3447,7 +3455,7 @@ nt_2_left_4:
 	goto nt_2_return;
 
 nt_2_return:
-	free(mem);
+	blasfeo_ws_free(mem);
 	return;
 
 
@@ -3772,7 +3780,9 @@ tn_2:
 #if 1
 	if(blasfeo_is_init()==0)
 		{
-		blasfeo_malloc(&mem, tA_size+tB_size+2*4096);
+		blasfeo_ws_malloc(&mem, tA_size+tB_size+2*4096);
+		if(mem==NULL)
+			return;
 		}
 	else
 		{
@@ -3918,7 +3928,7 @@ tn_2:
 //	printf("\ntime: pack_A %e, pack_B %e, kernel %e, kernel2 %e, kernel3 %e\n", time_pack_A, time_pack_B, time_kernel, time_kernel2, time_kernel3); 
 	if(blasfeo_is_init()==0)
 		{
-		blasfeo_free(mem);
+		blasfeo_ws_free(mem);
 		}
 
 	return;
@@ -3931,7 +3941,9 @@ tn_2:
 	n1 = (n+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_smat(ps, m_kernel, k1);
 	tB_size = blasfeo_pm_memsize_smat(ps, n1, k1);
-	mem = malloc(tA_size+tB_size+64);
+	blasfeo_ws_malloc((void **) &mem, tA_size+tB_size+64);
+	if(mem==NULL)
+		return;
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_smat(ps, m_kernel, k, &tA, (void *) mem_align);
 	blasfeo_pm_create_smat(ps, n, k, &tB, (void *) (mem_align+tA_size));
@@ -4220,7 +4232,7 @@ tn_2_left_4:
 	goto tn_2_return;
 
 tn_2_return:
-free(mem);
+blasfeo_ws_free(mem);
 	return;
 
 
@@ -4560,7 +4572,9 @@ tt_2:
 #if 1
 	if(blasfeo_is_init()==0)
 		{
-		blasfeo_malloc(&mem, tA_size+tB_size+2*4096);
+		blasfeo_ws_malloc(&mem, tA_size+tB_size+2*4096);
+		if(mem==NULL)
+			return;
 		}
 	else
 		{
@@ -4706,7 +4720,7 @@ tt_2:
 //	printf("\ntime: pack_A %e, pack_B %e, kernel %e, kernel2 %e, kernel3 %e\n", time_pack_A, time_pack_B, time_kernel, time_kernel2, time_kernel3); 
 	if(blasfeo_is_init()==0)
 		{
-		blasfeo_free(mem);
+		blasfeo_ws_free(mem);
 		}
 
 	return;
@@ -4719,7 +4733,9 @@ tt_2:
 	n1 = (n+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_smat(ps, m_kernel, k1);
 	tB_size = blasfeo_pm_memsize_smat(ps, n1, k1);
-	mem = malloc(tA_size+tB_size+64);
+	blasfeo_ws_malloc((void **) &mem, tA_size+tB_size+64);
+	if(mem==NULL)
+		return;
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_smat(ps, m_kernel, k, &tA, (void *) mem_align);
 	blasfeo_pm_create_smat(ps, n, k, &tB, (void *) (mem_align+tA_size));
@@ -4980,7 +4996,7 @@ tt_2_left_4:
 	goto tt_2_return;
 
 tt_2_return:
-	free(mem);
+	blasfeo_ws_free(mem);
 	return;
 
 
@@ -292,7 +292,9 @@ l_2:
 
 	m1 = (m+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_smat(ps0, m1, m1);
-	blasfeo_malloc(&mem, tA_size+64);
+	blasfeo_ws_malloc(&mem, tA_size+64);
+	if(mem==NULL)
+		return;
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_smat(ps0, m, m, &tA, (void *) mem_align);
 
@@ -501,7 +503,7 @@ l_2_left_4:
 #endif
 
 l_2_return:
-	blasfeo_free(mem);
+	blasfeo_ws_free(mem);
 	return;
 
 #else // EXT_DEP_MALLOC
@@ -823,7 +825,9 @@ u_1:
 	m1 = (m+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_smat(ps, m1, m1);
 //	tA_size = blasfeo_memsize_smat(m, m);
-	blasfeo_malloc(&mem, tA_size+64);
+	blasfeo_ws_malloc(&mem, tA_size+64);
+	if(mem==NULL)
+		return;
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_smat(ps, m, m, &tA, (void *) mem_align);
 
@@ -1007,7 +1011,7 @@ u_1_left_4:
 	goto u_1_return;
 
 u_1_return:
-	blasfeo_free(mem);
+	blasfeo_ws_free(mem);
 	return;
 
 #else // EXT_DEP_MALLOC
@@ -1365,7 +1369,9 @@ l_2:
 	m1 = (m+128-1)/128*128;
 	n1 = (n+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_smat(ps, m1, n1);
-	blasfeo_malloc(&mem, tA_size+64);
+	blasfeo_ws_malloc(&mem, tA_size+64);
+	if(mem==NULL)
+		return;
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_smat(ps, m, n, &tA, (void *) mem_align);
 
@@ -1624,7 +1630,7 @@ l_2_left_4:
 	goto l_2_return;
 
 l_2_return:
-	free(mem);
+	blasfeo_ws_free(mem);
 	return;
 
 #else // EXT_DEP_MALLOC
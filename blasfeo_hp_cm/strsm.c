@@ -252,7 +252,9 @@ llnn_2:
 	m1 = (m+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_smat(ps0, m_kernel, m1);
 	tB_size = blasfeo_pm_memsize_smat(ps0, m1, m1);
-	blasfeo_malloc(&mem, tA_size+tB_size+64);
+	blasfeo_ws_malloc(&mem, tA_size+tB_size+64);
+	if(mem==NULL)
+		return;
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_smat(ps0, m_kernel, m, &tA, (void *) mem_align);
 	blasfeo_pm_create_smat(ps0, m, m, &tB, (void *) (mem_align+tA_size));
@@ -308,7 +310,7 @@ llnn_2_left_4:
 goto llnn_2_return;
 
 llnn_2_return:
-	blasfeo_free(mem);
+	blasfeo_ws_free(mem);
 	return;
 
 #else // EXT_DEP_MALLOC
@@ -468,7 +470,9 @@ llnu_2:
 	m1 = (m+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_smat(ps0, m_kernel, m1);
 	tB_size = blasfeo_pm_memsize_smat(ps0, m1, m1);
-	blasfeo_malloc(&mem, tA_size+tB_size+64);
+	blasfeo_ws_malloc(&mem, tA_size+tB_size+64);
+	if(mem==NULL)
+		return;
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_smat(ps0, m_kernel, m, &tA, (void *) mem_align);
 	blasfeo_pm_create_smat(ps0, m, m, &tB, (void *) (mem_align+tA_size));
@@ -521,7 +525,7 @@ llnu_2_left_4:
 goto llnu_2_return;
 
 llnu_2_return:
-	free(mem);
+	blasfeo_ws_free(mem);
 	return;
 
 #else // EXT_DEP_MALLOC
@@ -698,7 +702,9 @@ lunn_2:
 	m1 = (m+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_smat(ps0, m_kernel, m1);
 	tB_size = blasfeo_pm_memsize_smat(ps0, m1, m1);
-	blasfeo_malloc(&mem, tA_size+tB_size+64);
+	blasfeo_ws_malloc(&mem, tA_size+tB_size+64);
+	if(mem==NULL)
+		return;
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_smat(ps0, m_kernel, m, &tA, (void *) mem_align);
 	blasfeo_pm_create_smat(ps0, m, m, &tB, (void *) (mem_align+tA_size));
@@ -766,7 +772,7 @@ lunn_2_left_4:
 	goto lunn_2_return;
 
 lunn_2_return:
-	blasfeo_free(mem);
+	blasfeo_ws_free(mem);
 	return;
 
 #else // EXT_DEP_MALLOC
@@ -939,7 +945,9 @@ lunu_2:
 	m1 = (m+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_smat(ps0, m_kernel, m1);
 	tB_size = blasfeo_pm_memsize_smat(ps0, m1, m1);
-	blasfeo_malloc(&mem, tA_size+tB_size+64);
+	blasfeo_ws_malloc(&mem, tA_size+tB_size+64);
+	if(mem==NULL)
+		return;
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_smat(ps0, m_kernel, m, &tA, (void *) mem_align);
 	blasfeo_pm_create_smat(ps0, m, m, &tB, (void *) (mem_align+tA_size));
@@ -1004,7 +1012,7 @@ lunu_2_left_4:
 	goto lunu_2_return;
 
 lunu_2_return:
-	blasfeo_free(mem);
+	blasfeo_ws_free(mem);
 	return;
 
 #else // EXT_DEP_MALLOC
@@ -1181,7 +1189,9 @@ lunn_2:
 	m1 = (m+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_smat(ps0, m_kernel, m1);
 	tB_size = blasfeo_pm_memsize_smat(ps0, m1, m1);
-	blasfeo_malloc(&mem, tA_size+tB_size+64);
+	blasfeo_ws_malloc(&mem, tA_size+tB_size+64);
+	if(mem==NULL)
+		return;
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_smat(ps0, m_kernel, m, &tA, (void *) mem_align);
 	blasfeo_pm_create_smat(ps0, m, m, &tB, (void *) (mem_align+tA_size));
@@ -1249,7 +1259,7 @@ lunn_2_left_4:
 	goto lunn_2_return;
 
 lunn_2_return:
-	blasfeo_free(mem);
+	blasfeo_ws_free(mem);
 	return;
 
 #else // EXT_DEP_MALLOC
@@ -1422,7 +1432,9 @@ lunu_2:
 	m1 = (m+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_smat(ps0, m_kernel, m1);
 	tB_size = blasfeo_pm_memsize_smat(ps0, m1, m1);
-	blasfeo_malloc(&mem, tA_size+tB_size+64);
+	blasfeo_ws_malloc(&mem, tA_size+tB_size+64);
+	if(mem==NULL)
+		return;
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_smat(ps0, m_kernel, m, &tA, (void *) mem_align);
 	blasfeo_pm_create_smat(ps0, m, m, &tB, (void *) (mem_align+tA_size));
@@ -1487,7 +1499,7 @@ lunu_2_left_4:
 	goto lunu_2_return;
 
 lunu_2_return:
-	blasfeo_free(mem);
+	blasfeo_ws_free(mem);
 	return;
 
 #else // EXT_DEP_MALLOC
@@ -1652,7 +1664,9 @@ llnn_2:
 	m1 = (m+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_smat(ps0, m_kernel, m1);
 	tB_size = blasfeo_pm_memsize_smat(ps0, m1, m1);
-	blasfeo_malloc(&mem, tA_size+tB_size+64);
+	blasfeo_ws_malloc(&mem, tA_size+tB_size+64);
+	if(mem==NULL)
+		return;
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_smat(ps0, m_kernel, m, &tA, (void *) mem_align);
 	blasfeo_pm_create_smat(ps0, m, m, &tB, (void *) (mem_align+tA_size));
@@ -1708,7 +1722,7 @@ llnn_2_left_4:
 goto llnn_2_return;
 
 llnn_2_return:
-	blasfeo_free(mem);
+	blasfeo_ws_free(mem);
 	return;
 
 #else // EXT_DEP_MALLOC
@@ -1869,7 +1883,9 @@ llnu_2:
 	m1 = (m+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_smat(ps0, m_kernel, m1);
 	tB_size = blasfeo_pm_memsize_smat(ps0, m1, m1);
-	blasfeo_malloc(&mem, tA_size+tB_size+64);
+	blasfeo_ws_malloc(&mem, tA_size+tB_size+64);
+	if(mem==NULL)
+		return;
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_smat(ps0, m_kernel, m, &tA, (void *) mem_align);
 	blasfeo_pm_create_smat(ps0, m, m, &tB, (void *) (mem_align+tA_size));
@@ -1925,7 +1941,7 @@ llnu_2_left_4:
 goto llnu_2_return;
 
 llnu_2_return:
-	blasfeo_free(mem);
+	blasfeo_ws_free(mem);
 	return;
 
 #else // EXT_DEP_MALLOC
@@ -2103,7 +2119,9 @@ rutn_2:
 	n1 = (n+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_smat(ps0, m_kernel, n1);
 	tB_size = blasfeo_pm_memsize_smat(ps0, n1, n1);
-	blasfeo_malloc(&mem, tA_size+tB_size+64);
+	blasfeo_ws_malloc(&mem, tA_size+tB_size+64);
+	if(mem==NULL)
+		return;
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_smat(ps0, m_kernel, n, &tA, (void *) mem_align);
 	blasfeo_pm_create_smat(ps0, n, n, &tB, (void *) (mem_align+tA_size));
@@ -2171,7 +2189,7 @@ rutn_2_left_4:
 	goto rutn_2_return;
 
 rutn_2_return:
-	blasfeo_free(mem);
+	blasfeo_ws_free(mem);
 	return;
 
 #else // EXT_DEP_MALLOC
@@ -2345,7 +2363,9 @@ rutu_2:
 	n1 = (n+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_smat(ps0, m_kernel, n1);
 	tB_size = blasfeo_pm_memsize_smat(ps0, n1, n1);
-	blasfeo_malloc(&mem, tA_size+tB_size+64);
+	blasfeo_ws_malloc(&mem, tA_size+tB_size+64);
+	if(mem==NULL)
+		return;
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_smat(ps0, m_kernel, n, &tA, (void *) mem_align);
 	blasfeo_pm_create_smat(ps0, n, n, &tB, (void *) (mem_align+tA_size));
@@ -2410,7 +2430,7 @@ rutu_2_left_4:
 	goto rutu_2_return;
 
 rutu_2_return:
-	blasfeo_free(mem);
+	blasfeo_ws_free(mem);
 	return;
 
 #else // EXT_DEP_MALLOC
@@ -2575,7 +2595,9 @@ rltn_2:
 	n1 = (n+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_smat(ps0, m_kernel, n1);
 	tB_size = blasfeo_pm_memsize_smat(ps0, n1, n1);
-	blasfeo_malloc(&mem, tA_size+tB_size+64);
+	blasfeo_ws_malloc(&mem, tA_size+tB_size+64);
+	if(mem==NULL)
+		return;
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_smat(ps0, m_kernel, n, &tA, (void *) mem_align);
 	blasfeo_pm_create_smat(ps0, n, n, &tB, (void *) (mem_align+tA_size));
@@ -2630,7 +2652,7 @@ rltn_2_left_4:
 goto rltn_2_return;
 
 rltn_2_return:
-	blasfeo_free(mem);
+	blasfeo_ws_free(mem);
 	return;
 
 #else // EXT_DEP_MALLOC
@@ -2791,7 +2813,9 @@ rltu_2:
 	n1 = (n+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_smat(ps0, m_kernel, n1);
 	tB_size = blasfeo_pm_memsize_smat(ps0, n1, n1);
-	blasfeo_malloc(&mem, tA_size+tB_size+64);
+	blasfeo_ws_malloc(&mem, tA_size+tB_size+64);
+	if(mem==NULL)
+		return;
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_smat(ps0, m_kernel, n, &tA, (void *) mem_align);
 	blasfeo_pm_create_smat(ps0, n, n, &tB, (void *) (mem_align+tA_size));
@@ -2843,7 +2867,7 @@ rltu_2_left_4:
 goto rltu_2_return;
 
 rltu_2_return:
-	blasfeo_free(mem);
+	blasfeo_ws_free(mem);
 	return;
 
 #else // EXT_DEP_MALLOC
@@ -3008,7 +3032,9 @@ rltn_2:
 	n1 = (n+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_smat(ps0, m_kernel, n1);
 	tB_size = blasfeo_pm_memsize_smat(ps0, n1, n1);
-	blasfeo_malloc(&mem, tA_size+tB_size+64);
+	blasfeo_ws_malloc(&mem, tA_size+tB_size+64);
+	if(mem==NULL)
+		return;
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_smat(ps0, m_kernel, n, &tA, (void *) mem_align);
 	blasfeo_pm_create_smat(ps0, n, n, &tB, (void *) (mem_align+tA_size));
@@ -3063,7 +3089,7 @@ rltn_2_left_4:
 goto rltn_2_return;
 
 rltn_2_return:
-	blasfeo_free(mem);
+	blasfeo_ws_free(mem);
 	return;
 
 #else // EXT_DEP_MALLOC
@@ -3224,7 +3250,9 @@ rltu_2:
 	n1 = (n+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_smat(ps0, m_kernel, n1);
 	tB_size = blasfeo_pm_memsize_smat(ps0, n1, n1);
-	blasfeo_malloc(&mem, tA_size+tB_size+64);
+	blasfeo_ws_malloc(&mem, tA_size+tB_size+64);
+	if(mem==NULL)
+		return;
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_smat(ps0, m_kernel, n, &tA, (void *) mem_align);
 	blasfeo_pm_create_smat(ps0, n, n, &tB, (void *) (mem_align+tA_size));
@@ -3276,7 +3304,7 @@ rltu_2_left_4:
 goto rltu_2_return;
 
 rltu_2_return:
-	blasfeo_free(mem);
+	blasfeo_ws_free(mem);
 	return;
 
 #else // EXT_DEP_MALLOC
@@ -3454,7 +3482,9 @@ rutn_2:
 	n1 = (n+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_smat(ps0, m_kernel, n1);
 	tB_size = blasfeo_pm_memsize_smat(ps0, n1, n1);
-	blasfeo_malloc(&mem, tA_size+tB_size+64);
+	blasfeo_ws_malloc(&mem, tA_size+tB_size+64);
+	if(mem==NULL)
+		return;
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_smat(ps0, m_kernel, n, &tA, (void *) mem_align);
 	blasfeo_pm_create_smat(ps0, n, n, &tB, (void *) (mem_align+tA_size));
@@ -3522,7 +3552,7 @@ rutn_2_left_4:
 	goto rutn_2_return;
 
 rutn_2_return:
-	blasfeo_free(mem);
+	blasfeo_ws_free(mem);
 	return;
 
 #else // EXT_DEP_MALLOC
@@ -3696,7 +3726,9 @@ rutu_2:
 	n1 = (n+128-1)/128*128;
 	tA_size = blasfeo_pm_memsize_smat(ps0, m_kernel, n1);
 	tB_size = blasfeo_pm_memsize_smat(ps0, n1, n1);
-	blasfeo_malloc(&mem, tA_size+tB_size+64);
+	blasfeo_ws_malloc(&mem, tA_size+tB_size+64);
+	if(mem==NULL)
+		return;
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_pm_create_smat(ps0, m_kernel, n, &tA, (void *) mem_align);
 	blasfeo_pm_create_smat(ps0, n, n, &tB, (void *) (mem_align+tA_size));
@@ -3761,7 +3793,7 @@ rutu_2_left_4:
 	goto rutu_2_return;
 
 rutu_2_return:
-	blasfeo_free(mem);
+	blasfeo_ws_free(mem);
 	return;
 
 #else // EXT_DEP_MALLOC
@@ -0,0 +1,617 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS for embedded optimization.                                                      *
+* Copyright (C) 2019 by Gianluca Frison.                                                          *
+* Developed at IMTEK (University of Freiburg) under the supervision of Moritz Diehl.              *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#include <blasfeo_common.h>
+#include <blasfeo_block_size.h>
+#include <blasfeo_d_kernel.h>
+#include <blasfeo_d_aux.h>
+#include <blasfeo_d_blasfeo_api.h>
+#include <blasfeo_d_blasfeo_hp_api.h>
+#include <blasfeo_thread_pool.h>
+
+
+
+// Batched routines: the same operation, with the same sizes and offsets, is applied to
+// each matrix of the batch. The size and alignment dispatch is done once per batch, and
+// the batch is split in contiguous chunks over the threads set by blasfeo_set_num_threads.
+
+
+
+// minimum number of flops (per thread) to use more than one thread
+#define BATCH_MT_MIN_FLOPS (32*32*32)
+
+
+
+struct d_batch_arg
+	{
+	void (*fun)(int, int, struct d_batch_arg *);
+	int nb;
+	int m;
+	int n;
+	int k;
+	double alpha;
+	double beta;
+	struct blasfeo_dmat **sA;
+	struct blasfeo_dmat **sB;
+	struct blasfeo_dmat **sC;
+	struct blasfeo_dmat **sD;
+	int ai;
+	int aj;
+	int bi;
+	int bj;
+	int ci;
+	int cj;
+	int di;
+	int dj;
+	};
+
+
+
+static void d_batch_work(int tid, int nt, void *ptr)
+	{
+	struct d_batch_arg *arg = ptr;
+	int ii0 = tid*arg->nb/nt;
+	int ii1 = (tid+1)*arg->nb/nt;
+	if(ii1>ii0)
+		arg->fun(ii0, ii1, arg);
+	return;
+	}
+
+
+
+static void d_batch_run(struct d_batch_arg *arg, double flops)
+	{
+	int nt = blasfeo_get_num_threads();
+	if(nt>1 && !blasfeo_thread_pool_in_parallel())
+		{
+		// at least BATCH_MT_MIN_FLOPS per thread
+		double nt_max = flops*arg->nb/BATCH_MT_MIN_FLOPS;
+		nt = nt_max<nt ? (int) nt_max : nt;
+		nt = nt<arg->nb ? nt : arg->nb;
+		}
+	else
+		{
+		nt = 1;
+		}
+	if(nt>1)
+		blasfeo_thread_pool_run(nt, d_batch_work, arg);
+	else
+		arg->fun(0, arg->nb, arg);
+	return;
+	}
+
+
+
+// dgemm nt, all operands aligned to the panel boundaries
+static void d_gemm_nt_batch_aligned(int ii0, int ii1, struct d_batch_arg *arg)
+	{
+	const int ps = D_PS;
+
+	int m = arg->m;
+	int n = arg->n;
+	int k = arg->k;
+	double alpha = arg->alpha;
+	double beta = arg->beta;
+
+	struct blasfeo_dmat *sA, *sB, *sC, *sD;
+	int sda, sdb, sdc, sdd;
+	double *pA, *pB, *pC, *pD;
+
+	int ii, i, j;
+
+	for(ii=ii0; ii<ii1; ii++)
+		{
+
+		sA = arg->sA[ii];
+		sB = arg->sB[ii];
+		sC = arg->sC[ii];
+		sD = arg->sD[ii];
+
+		// invalidate stored inverse diagonal of result matrix
+		sD->use_dA = 0;
+
+		sda = sA->cn;
+		sdb = sB->cn;
+		sdc = sC->cn;
+		sdd = sD->cn;
+		pA = sA->pA + arg->aj*ps + arg->ai*sda;
+		pB = sB->pA + arg->bj*ps + arg->bi*sdb;
+		pC = sC->pA + arg->cj*ps + arg->ci*sdc;
+		pD = sD->pA + arg->dj*ps + arg->di*sdd;
+
+		i = 0;
+#if defined(TARGET_X64_INTEL_SKYLAKE_X) || defined(TARGET_X64_AMD_ZEN5)
+		for(; i<m-8; i+=16)
+			{
+			for(j=0; j<n; j+=8)
+				{
+				kernel_dgemm_nt_16x8_vs_lib8(k, &alpha, &pA[i*sda], sda, &pB[j*sdb], &beta, &pC[j*ps+i*sdc], sdc, &pD[j*ps+i*sdd], sdd, m-i, n-j);
+				}
+			}
+		if(i<m)
+			{
+			for(j=0; j<n; j+=8)
+				{
+				kernel_dgemm_nt_8x8_vs_lib8(k, &alpha, &pA[i*sda], &pB[j*sdb], &beta, &pC[j*ps+i*sdc], &pD[j*ps+i*sdd], m-i, n-j);
+				}
+			}
+#elif defined(TARGET_X64_INTEL_HASWELL) || defined(TARGET_ARMV8A_ARM_CORTEX_A53)
+		for(; i<m-8; i+=12)
+			{
+			for(j=0; j<n; j+=4)
+				{
+				kernel_dgemm_nt_12x4_vs_lib4(k, &alpha, &pA[i*sda], sda, &pB[j*sdb], &beta, &pC[j*ps+i*sdc], sdc, &pD[j*ps+i*sdd], sdd, m-i, n-j);
+				}
+			}
+		if(i<m-4)
+			{
+			for(j=0; j<n; j+=4)
+				{
+				kernel_dgemm_nt_8x4_vs_lib4(k, &alpha, &pA[i*sda], sda, &pB[j*sdb], &beta, &pC[j*ps+i*sdc], sdc, &pD[j*ps+i*sdd], sdd, m-i, n-j);
+				}
+			}
+		else if(i<m)
+			{
+			for(j=0; j<n; j+=4)
+				{
+				kernel_dgemm_nt_4x4_vs_lib4(k, &alpha, &pA[i*sda], &pB[j*sdb], &beta, &pC[j*ps+i*sdc], &pD[j*ps+i*sdd], m-i, n-j);
+				}
+			}
+#elif defined(TARGET_X64_INTEL_SANDY_BRIDGE) || defined(TARGET_ARMV8A_ARM_CORTEX_A57)
+		for(; i<m-4; i+=8)
+			{
+			for(j=0; j<n; j+=4)
+				{
+				kernel_dgemm_nt_8x4_vs_lib4(k, &alpha, &pA[i*sda], sda, &pB[j*sdb], &beta, &pC[j*ps+i*sdc], sdc, &pD[j*ps+i*sdd], sdd, m-i, n-j);
+				}
+			}
+		if(i<m)
+			{
+			for(j=0; j<n; j+=4)
+				{
+				kernel_dgemm_nt_4x4_vs_lib4(k, &alpha, &pA[i*sda], &pB[j*sdb], &beta, &pC[j*ps+i*sdc], &pD[j*ps+i*sdd], m-i, n-j);
+				}
+			}
+#else
+		for(; i<m; i+=4)
+			{
+			for(j=0; j<n; j+=4)
+				{
+				kernel_dgemm_nt_4x4_vs_lib4(k, &alpha, &pA[i*sda], &pB[j*sdb], &beta, &pC[j*ps+i*sdc], &pD[j*ps+i*sdd], m-i, n-j);
+				}
+			}
+#endif
+
+		}
+
+	return;
+	}
+
+
+
+// dgemm nt, generic offsets
+static void d_gemm_nt_batch_gen(int ii0, int ii1, struct d_batch_arg *arg)
+	{
+	int ii;
+	for(ii=ii0; ii<ii1; ii++)
+		{
+		blasfeo_hp_dgemm_nt(arg->m, arg->n, arg->k, arg->alpha, arg->sA[ii], arg->ai, arg->aj, arg->sB[ii], arg->bi, arg->bj, arg->beta, arg->sC[ii], arg->ci, arg->cj, arg->sD[ii], arg->di, arg->dj);
+		}
+	return;
+	}
+
+
+
+void blasfeo_hp_dgemm_nt_batch(int nb, int m, int n, int k, double alpha, struct blasfeo_dmat **sA, int ai, int aj, struct blasfeo_dmat **sB, int bi, int bj, double beta, struct blasfeo_dmat **sC, int ci, int cj, struct blasfeo_dmat **sD, int di, int dj)
+	{
+	if(nb<=0 | m<=0 | n<=0)
+		return;
+
+	const int ps = D_PS;
+
+	struct d_batch_arg arg;
+	arg.nb = nb;
+	arg.m = m;
+	arg.n = n;
+	arg.k = k;
+	arg.alpha = alpha;
+	arg.beta = beta;
+	arg.sA = sA;
+	arg.sB = sB;
+	arg.sC = sC;
+	arg.sD = sD;
+	arg.ai = ai;
+	arg.aj = aj;
+	arg.bi = bi;
+	arg.bj = bj;
+	arg.ci = ci;
+	arg.cj = cj;
+	arg.di = di;
+	arg.dj = dj;
+
+	if(((ai | bi | ci | di) & (ps-1))==0)
+		arg.fun = &d_gemm_nt_batch_aligned;
+	else
+		arg.fun = &d_gemm_nt_batch_gen;
+
+	d_batch_run(&arg, 2.0*m*n*k);
+
+	return;
+	}
+
+
+
+// dtrsm rltn, B and D aligned to the panel boundaries, A at the top of a panel, unit alpha
+static void d_trsm_rltn_batch_aligned(int ii0, int ii1, struct d_batch_arg *arg)
+	{
+	const int ps = D_PS;
+
+	int m = arg->m;
+	int n = arg->n;
+	double alpha = 1.0;
+
+	struct blasfeo_dmat *sA, *sB, *sD;
+	struct blasfeo_dvec sdA;
+	int sda, sdb, sdd;
+	double *pA, *pB, *pD, *dA;
+
+	int ii, i, j;
+
+	for(ii=ii0; ii<ii1; ii++)
+		{
+
+		sA = arg->sA[ii];
+		sB = arg->sB[ii];
+		sD = arg->sD[ii];
+
+		// invalidate stored inverse diagonal of result matrix
+		sD->use_dA = 0;
+
+		sda = sA->cn;
+		sdb = sB->cn;
+		sdd = sD->cn;
+		pA = sA->pA + arg->aj*ps;
+		pB = sB->pA + arg->bj*ps + arg->bi*sdb;
+		pD = sD->pA + arg->dj*ps + arg->di*sdd;
+		dA = sA->dA;
+
+		// inverse diagonal of A, stored in A as in blasfeo_hp_dtrsm_rltn
+		if(arg->aj!=0 | sA->use_dA<n)
+			{
+			sdA.pa = dA;
+			blasfeo_ddiaex(n, 1.0, sA, 0, arg->aj, &sdA, 0);
+			for(i=0; i<n; i++)
+				dA[i] = 1.0 / dA[i];
+			sA->use_dA = arg->aj==0 ? n : 0;
+			}
+
+		i = 0;
+#if defined(TARGET_X64_INTEL_SKYLAKE_X) || defined(TARGET_X64_AMD_ZEN5)
+		for(; i<m-8; i+=16)
+			{
+			for(j=0; j<n; j+=8)
+				{
+				kernel_dtrsm_nt_rl_inv_16x8_vs_lib8(j, &pD[i*sdd], sdd, &pA[j*sda], &alpha, &pB[j*ps+i*sdb], sdb, &pD[j*ps+i*sdd], sdd, &pA[j*ps+j*sda], &dA[j], m-i, n-j);
+				}
+			}
+		if(i<m)
+			{
+			for(j=0; j<n; j+=8)
+				{
+				kernel_dtrsm_nt_rl_inv_8x8_vs_lib8(j, &pD[i*sdd], &pA[j*sda], &alpha, &pB[j*ps+i*sdb], &pD[j*ps+i*sdd], &pA[j*ps+j*sda], &dA[j], m-i, n-j);
+				}
+			}
+#elif defined(TARGET_X64_INTEL_HASWELL) || defined(TARGET_ARMV8A_ARM_CORTEX_A53)
+		for(; i<m-8; i+=12)
+			{
+			for(j=0; j<n; j+=4)
+				{
+				kernel_dtrsm_nt_rl_inv_12x4_vs_lib4(j, &pD[i*sdd], sdd, &pA[j*sda], &alpha, &pB[j*ps+i*sdb], sdb, &pD[j*ps+i*sdd], sdd, &pA[j*ps+j*sda], &dA[j], m-i, n-j);
+				}
+			}
+		if(i<m-4)
+			{
+			for(j=0; j<n; j+=4)
+				{
+				kernel_dtrsm_nt_rl_inv_8x4_vs_lib4(j, &pD[i*sdd], sdd, &pA[j*sda], &alpha, &pB[j*ps+i*sdb], sdb, &pD[j*ps+i*sdd], sdd, &pA[j*ps+j*sda], &dA[j], m-i, n-j);
+				}
+			}
+		else if(i<m)
+			{
+			for(j=0; j<n; j+=4)
+				{
+				kernel_dtrsm_nt_rl_inv_4x4_vs_lib4(j, &pD[i*sdd], &pA[j*sda], &alpha, &pB[j*ps+i*sdb], &pD[j*ps+i*sdd], &pA[j*ps+j*sda], &dA[j], m-i, n-j);
+				}
+			}
+#elif defined(TARGET_X64_INTEL_SANDY_BRIDGE) || defined(TARGET_ARMV8A_ARM_CORTEX_A57)
+		for(; i<m-4; i+=8)
+			{
+			for(j=0; j<n; j+=4)
+				{
+				kernel_dtrsm_nt_rl_inv_8x4_vs_lib4(j, &pD[i*sdd], sdd, &pA[j*sda], &alpha, &pB[j*ps+i*sdb], sdb, &pD[j*ps+i*sdd], sdd, &pA[j*ps+j*sda], &dA[j], m-i, n-j);
+				}
+			}
+		if(i<m)
+			{
+			for(j=0; j<n; j+=4)
+				{
+				kernel_dtrsm_nt_rl_inv_4x4_vs_lib4(j, &pD[i*sdd], &pA[j*sda], &alpha, &pB[j*ps+i*sdb], &pD[j*ps+i*sdd], &pA[j*ps+j*sda], &dA[j], m-i, n-j);
+				}
+			}
+#else
+		for(; i<m; i+=4)
+			{
+			for(j=0; j<n; j+=4)
+				{
+				kernel_dtrsm_nt_rl_inv_4x4_vs_lib4(j, &pD[i*sdd], &pA[j*sda], &alpha, &pB[j*ps+i*sdb], &pD[j*ps+i*sdd], &pA[j*ps+j*sda], &dA[j], m-i, n-j);
+				}
+			}
+#endif
+
+		}
+
+	return;
+	}
+
+
+
+// dtrsm rltn, generic offsets
+static void d_trsm_rltn_batch_gen(int ii0, int ii1, struct d_batch_arg *arg)
+	{
+	int ii;
+	for(ii=ii0; ii<ii1; ii++)
+		{
+		blasfeo_hp_dtrsm_rltn(arg->m, arg->n, arg->alpha, arg->sA[ii], arg->ai, arg->aj, arg->sB[ii], arg->bi, arg->bj, arg->sD[ii], arg->di, arg->dj);
+		}
+	return;
+	}
+
+
+
+void blasfeo_hp_dtrsm_rltn_batch(int nb, int m, int n, double alpha, struct blasfeo_dmat **sA, int ai, int aj, struct blasfeo_dmat **sB, int bi, int bj, struct blasfeo_dmat **sD, int di, int dj)
+	{
+	if(nb<=0 | m<=0 | n<=0)
+		return;
+
+	const int ps = D_PS;
+
+	struct d_batch_arg arg;
+	arg.nb = nb;
+	arg.m = m;
+	arg.n = n;
+	arg.alpha = alpha;
+	arg.sA = sA;
+	arg.sB = sB;
+	arg.sD = sD;
+	arg.ai = ai;
+	arg.aj = aj;
+	arg.bi = bi;
+	arg.bj = bj;
+	arg.di = di;
+	arg.dj = dj;
+
+	if(ai==0 & ((bi | di) & (ps-1))==0 & alpha==1.0)
+		arg.fun = &d_trsm_rltn_batch_aligned;
+	else
+		arg.fun = &d_trsm_rltn_batch_gen;
+
+	d_batch_run(&arg, 1.0*m*n*n);
+
+	return;
+	}
+
+
+
+// dpotrf l, C and D at the top of a panel
+static void d_potrf_l_batch_aligned(int ii0, int ii1, struct d_batch_arg *arg)
+	{
+	const int ps = D_PS;
+
+	int m = arg->m;
+	double alpha = 1.0;
+
+	struct blasfeo_dmat *sC, *sD;
+	int sdc, sdd;
+	double *pC, *pD, *dD;
+
+	int ii, i, j;
+
+	for(ii=ii0; ii<ii1; ii++)
+		{
+
+		sC = arg->sC[ii];
+		sD = arg->sD[ii];
+
+		sdc = sC->cn;
+		sdd = sD->cn;
+		pC = sC->pA + arg->cj*ps;
+		pD = sD->pA + arg->dj*ps;
+		dD = sD->dA;
+
+		sD->use_dA = arg->dj==0 ? m : 0;
+
+		i = 0;
+#if defined(TARGET_X64_INTEL_SKYLAKE_X) || defined(TARGET_X64_AMD_ZEN5)
+		for(; i<m-8; i+=16)
+			{
+			for(j=0; j<i; j+=8)
+				{
+				kernel_dtrsm_nt_rl_inv_16x8_vs_lib8(j, &pD[i*sdd], sdd, &pD[j*sdd], &alpha, &pC[j*ps+i*sdc], sdc, &pD[j*ps+i*sdd], sdd, &pD[j*ps+j*sdd], &dD[j], m-i, m-j);
+				}
+			kernel_dpotrf_nt_l_16x8_vs_lib8(j, &pD[i*sdd], sdd, &pD[j*sdd], &pC[j*ps+j*sdc], sdc, &pD[j*ps+j*sdd], sdd, &dD[j], m-i, m-j);
+			kernel_dpotrf_nt_l_8x8_vs_lib8(j+8, &pD[(i+8)*sdd], &pD[(j+8)*sdd], &pC[(j+8)*ps+(i+8)*sdc], &pD[(j+8)*ps+(i+8)*sdd], &dD[j+8], m-i-8, m-j-8);
+			}
+		if(i<m)
+			{
+			for(j=0; j<i; j+=8)
+				{
+				kernel_dtrsm_nt_rl_inv_8x8_vs_lib8(j, &pD[i*sdd], &pD[j*sdd], &alpha, &pC[j*ps+i*sdc], &pD[j*ps+i*sdd], &pD[j*ps+j*sdd], &dD[j], m-i, m-j);
+				}
+			kernel_dpotrf_nt_l_8x8_vs_lib8(j, &pD[i*sdd], &pD[j*sdd], &pC[j*ps+j*sdc], &pD[j*ps+j*sdd], &dD[j], m-i, m-j);
+			}
+#elif defined(TARGET_X64_INTEL_HASWELL) || defined(TARGET_ARMV8A_ARM_CORTEX_A53)
+		for(; i<m-8; i+=12)
+			{
+			for(j=0; j<i; j+=4)
+				{
+				kernel_dtrsm_nt_rl_inv_12x4_vs_lib4(j, &pD[i*sdd], sdd, &pD[j*sdd], &alpha, &pC[j*ps+i*sdc], sdc, &pD[j*ps+i*sdd], sdd, &pD[j*ps+j*sdd], &dD[j], m-i, m-j);
+				}
+			kernel_dpotrf_nt_l_12x4_vs_lib4(j, &pD[i*sdd], sdd, &pD[j*sdd], &pC[j*ps+j*sdc], sdc, &pD[j*ps+j*sdd], sdd, &dD[j], m-i, m-j);
+			kernel_dpotrf_nt_l_8x4_vs_lib4(j+4, &pD[(i+4)*sdd], sdd, &pD[(j+4)*sdd], &pC[(j+4)*ps+(i+4)*sdc], sdc, &pD[(j+4)*ps+(i+4)*sdd], sdd, &dD[j+4], m-i-4, m-j-4);
+			kernel_dpotrf_nt_l_4x4_vs_lib4(j+8, &pD[(i+8)*sdd], &pD[(j+8)*sdd], &pC[(j+8)*ps+(i+8)*sdc], &pD[(j+8)*ps+(i+8)*sdd], &dD[j+8], m-i-8, m-j-8);
+			}
+		if(i<m-4)
+			{
+			for(j=0; j<i; j+=4)
+				{
+				kernel_dtrsm_nt_rl_inv_8x4_vs_lib4(j, &pD[i*sdd], sdd, &pD[j*sdd], &alpha, &pC[j*ps+i*sdc], sdc, &pD[j*ps+i*sdd], sdd, &pD[j*ps+j*sdd], &dD[j], m-i, m-j);
+				}
+			kernel_dpotrf_nt_l_8x4_vs_lib4(j, &pD[i*sdd], sdd, &pD[j*sdd], &pC[j*ps+j*sdc], sdc, &pD[j*ps+j*sdd], sdd, &dD[j], m-i, m-j);
+			kernel_dpotrf_nt_l_4x4_vs_lib4(j+4, &pD[(i+4)*sdd], &pD[(j+4)*sdd], &pC[(j+4)*ps+(i+4)*sdc], &pD[(j+4)*ps+(i+4)*sdd], &dD[j+4], m-i-4, m-j-4);
+			}
+		else if(i<m)
+			{
+			for(j=0; j<i; j+=4)
+				{
+				kernel_dtrsm_nt_rl_inv_4x4_vs_lib4(j, &pD[i*sdd], &pD[j*sdd], &alpha, &pC[j*ps+i*sdc], &pD[j*ps+i*sdd], &pD[j*ps+j*sdd], &dD[j], m-i, m-j);
+				}
+			kernel_dpotrf_nt_l_4x4_vs_lib4(j, &pD[i*sdd], &pD[j*sdd], &pC[j*ps+j*sdc], &pD[j*ps+j*sdd], &dD[j], m-i, m-j);
+			}
+#elif defined(TARGET_X64_INTEL_SANDY_BRIDGE) || defined(TARGET_ARMV8A_ARM_CORTEX_A57)
+		for(; i<m-4; i+=8)
+			{
+			for(j=0; j<i; j+=4)
+				{
+				kernel_dtrsm_nt_rl_inv_8x4_vs_lib4(j, &pD[i*sdd], sdd, &pD[j*sdd], &alpha, &pC[j*ps+i*sdc], sdc, &pD[j*ps+i*sdd], sdd, &pD[j*ps+j*sdd], &dD[j], m-i, m-j);
+				}
+			kernel_dpotrf_nt_l_8x4_vs_lib4(j, &pD[i*sdd], sdd, &pD[j*sdd], &pC[j*ps+j*sdc], sdc, &pD[j*ps+j*sdd], sdd, &dD[j], m-i, m-j);
+			kernel_dpotrf_nt_l_4x4_vs_lib4(j+4, &pD[(i+4)*sdd], &pD[(j+4)*sdd], &pC[(j+4)*ps+(i+4)*sdc], &pD[(j+4)*ps+(i+4)*sdd], &dD[j+4], m-i-4, m-j-4);
+			}
+		if(i<m)
+			{
+			for(j=0; j<i; j+=4)
+				{
+				kernel_dtrsm_nt_rl_inv_4x4_vs_lib4(j, &pD[i*sdd], &pD[j*sdd], &alpha, &pC[j*ps+i*sdc], &pD[j*ps+i*sdd], &pD[j*ps+j*sdd], &dD[j], m-i, m-j);
+				}
+			kernel_dpotrf_nt_l_4x4_vs_lib4(j, &pD[i*sdd], &pD[j*sdd], &pC[j*ps+j*sdc], &pD[j*ps+j*sdd], &dD[j], m-i, m-j);
+			}
+#else
+		for(; i<m; i+=4)
+			{
+			for(j=0; j<i; j+=4)
+				{
+				kernel_dtrsm_nt_rl_inv_4x4_vs_lib4(j, &pD[i*sdd], &pD[j*sdd], &alpha, &pC[j*ps+i*sdc], &pD[j*ps+i*sdd], &pD[j*ps+j*sdd], &dD[j], m-i, m-j);
+				}
+			kernel_dpotrf_nt_l_4x4_vs_lib4(j, &pD[i*sdd], &pD[j*sdd], &pC[j*ps+j*sdc], &pD[j*ps+j*sdd], &dD[j], m-i, m-j);
+			}
+#endif
+
+		}
+
+	return;
+	}
+
+
+
+// dpotrf l, generic offsets
+static void d_potrf_l_batch_gen(int ii0, int ii1, struct d_batch_arg *arg)
+	{
+	int ii;
+	for(ii=ii0; ii<ii1; ii++)
+		{
+		blasfeo_hp_dpotrf_l(arg->m, arg->sC[ii], arg->ci, arg->cj, arg->sD[ii], arg->di, arg->dj);
+		}
+	return;
+	}
+
+
+
+void blasfeo_hp_dpotrf_l_batch(int nb, int m, struct blasfeo_dmat **sC, int ci, int cj, struct blasfeo_dmat **sD, int di, int dj)
+	{
+	if(nb<=0 | m<=0)
+		return;
+
+	struct d_batch_arg arg;
+	arg.nb = nb;
+	arg.m = m;
+	arg.sC = sC;
+	arg.sD = sD;
+	arg.ci = ci;
+	arg.cj = cj;
+	arg.di = di;
+	arg.dj = dj;
+
+	if(ci==0 & di==0)
+		arg.fun = &d_potrf_l_batch_aligned;
+	else
+		arg.fun = &d_potrf_l_batch_gen;
+
+	d_batch_run(&arg, 1.0/3.0*m*m*m);
+
+	return;
+	}
+
+
+
+#if defined(LA_HIGH_PERFORMANCE)
+
+
+
+void blasfeo_dgemm_nt_batch(int nb, int m, int n, int k, double alpha, struct blasfeo_dmat **sA, int ai, int aj, struct blasfeo_dmat **sB, int bi, int bj, double beta, struct blasfeo_dmat **sC, int ci, int cj, struct blasfeo_dmat **sD, int di, int dj)
+	{
+	blasfeo_hp_dgemm_nt_batch(nb, m, n, k, alpha, sA, ai, aj, sB, bi, bj, beta, sC, ci, cj, sD, di, dj);
+	}
+
+
+
+void blasfeo_dtrsm_rltn_batch(int nb, int m, int n, double alpha, struct blasfeo_dmat **sA, int ai, int aj, struct blasfeo_dmat **sB, int bi, int bj, struct blasfeo_dmat **sD, int di, int dj)
+	{
+	blasfeo_hp_dtrsm_rltn_batch(nb, m, n, alpha, sA, ai, aj, sB, bi, bj, sD, di, dj);
+	}
+
+
+
+void blasfeo_dpotrf_l_batch(int nb, int m, struct blasfeo_dmat **sC, int ci, int cj, struct blasfeo_dmat **sD, int di, int dj)
+	{
+	blasfeo_hp_dpotrf_l_batch(nb, m, sC, ci, cj, sD, di, dj);
+	}
+
+
+
+#endif
@@ -44,6 +44,7 @@
 #include <blasfeo_d_blasfeo_ref_api.h>
 #endif
 #include <blasfeo_stdlib.h>
+#include <blasfeo_thread_pool.h>
 
 
 
@@ -311,12 +312,45 @@ void dlauum_blk_nt_l_lib(int m, int n, int nv, int *rv, int *cv, double *pA, int
 
 
 
+#if defined(MULTITHREAD)
+
+#define REAL double
+#define XMAT blasfeo_dmat
+#define PS 4
+
+#if defined(TARGET_X64_INTEL_HASWELL)
+#define GEMM_MT_M_FIRST 12
+#elif defined(TARGET_X64_INTEL_SANDY_BRIDGE)
+#define GEMM_MT_M_FIRST 8
+#else
+#define GEMM_MT_M_FIRST 4
+#endif
+#define GEMM_MT_M_GRAIN 24
+#define GEMM_MT_N_GRAIN 24
+
+#define GEMM_MT_ARG d_gemm_mt_arg
+#define GEMM_MT_UNITS d_gemm_mt_units
+#define GEMM_MT_OFFSET d_gemm_mt_offset
+#define GEMM_MT_WORK d_gemm_mt_work
+#define GEMM_MT d_gemm_mt
+
+#include "x_blas3_mt_lib.c"
+
+#endif
+
+
+
 // dgemm nn
 void blasfeo_hp_dgemm_nn(int m, int n, int k, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj)
 	{
 	if(m<=0 || n<=0)
 		return;
 
+#if defined(MULTITHREAD)
+	if(d_gemm_mt(0, &blasfeo_hp_dgemm_nn, m, n, k, alpha, sA, ai, aj, sB, bi, bj, beta, sC, ci, cj, sD, di, dj))
+		return;
+#endif
+
 	// invalidate stored inverse diagonal of result matrix
 	sD->use_dA = 0;
 
@@ -729,6 +763,11 @@ void blasfeo_hp_dgemm_nt(int m, int n, int k, double alpha, struct blasfeo_dmat
 	if(m<=0 | n<=0)
 		return;
 
+#if defined(MULTITHREAD)
+	if(d_gemm_mt(1, &blasfeo_hp_dgemm_nt, m, n, k, alpha, sA, ai, aj, sB, bi, bj, beta, sC, ci, cj, sD, di, dj))
+		return;
+#endif
+
 	// invalidate stored inverse diagonal of result matrix
 	sD->use_dA = 0;
 
@@ -1435,7 +1474,9 @@ void blasfeo_hp_dgemm_tn(int m, int n, int k, double alpha, struct blasfeo_dmat
 		{
 #ifdef EXT_DEP_MALLOC
 		sAt_size = blasfeo_memsize_dmat(12, k);
-		blasfeo_malloc(&mem, sAt_size+64);
+		blasfeo_ws_malloc(&mem, sAt_size+64);
+		if(mem==NULL)
+			return;
 		blasfeo_align_64_byte(mem, (void **) &mem_align);
 		blasfeo_create_dmat(12, k, &sAt, (void *) mem_align);
 		pU = sAt.pA;
@@ -1857,7 +1898,7 @@ tn_return:
 	if(k>K_MAX_STACK)
 		{
 #ifdef EXT_DEP_MALLOC
-		blasfeo_free(mem);
+		blasfeo_ws_free(mem);
 #else // EXT_DEP_MALLOC
 #endif // EXT_DEP_MALLOC
 		}
@@ -2915,7 +2956,9 @@ loop_00_1:
 #ifdef EXT_DEP_MALLOC
 
 	sAt_size = blasfeo_memsize_dmat(12, k);
-	blasfeo_malloc(&mem, sAt_size+64);
+	blasfeo_ws_malloc(&mem, sAt_size+64);
+	if(mem==NULL)
+		return;
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_create_dmat(12, k, &sAt, (void *) mem_align);
 	pAt = sAt.pA;
@@ -3120,7 +3163,9 @@ loop_CD_1:
 #ifdef EXT_DEP_MALLOC
 
 	sAt_size = blasfeo_memsize_dmat(12, k);
-	blasfeo_malloc(&mem, sAt_size+64);
+	blasfeo_ws_malloc(&mem, sAt_size+64);
+	if(mem==NULL)
+		return;
 	blasfeo_align_64_byte(mem, (void **) &mem_align);
 	blasfeo_create_dmat(12, k, &sAt, (void *) mem_align);
 	pAt = sAt.pA;
@@ -3463,7 +3508,7 @@ left_4_1_g:
 
 
 tt_1_return:
-	blasfeo_free(mem);
+	blasfeo_ws_free(mem);
 	return;
 
 #else // EXT_DEP_MALLOC
@@ -5472,7 +5517,9 @@ void blasfeo_hp_dsyrk_ln(int m, int k, double alpha, struct blasfeo_dmat *sA, in
 			{
 #ifdef EXT_DEP_MALLOC
 			sAt_size = blasfeo_memsize_dmat(12, k);
-			blasfeo_malloc(&mem, sAt_size+64);
+			blasfeo_ws_malloc(&mem, sAt_size+64);
+			if(mem==NULL)
+				return;
 			blasfeo_align_64_byte(mem, (void **) &mem_align);
 			blasfeo_create_dmat(12, k, &sAt, (void *) mem_align);
 			pU = sAt.pA;
@@ -5563,13 +5610,13 @@ loop_000:
 		// main loop
 		for(; j<i; j+=4)
 			{
-			kernel_dgemm_nt_12x4_lib4(k, &alpha, pA2, sda, &pB[j*sdb], &beta, &pC[j*ps+i*sdc], sdc, &pD[j*ps+i*sdd], sdd);
+			kernel_dgemm_nt_12x4_lib4(k, &alpha, pA2, sda2, &pB[j*sdb], &beta, &pC[j*ps+i*sdc], sdc, &pD[j*ps+i*sdd], sdd);
 			}
-		kernel_dsyrk_nt_l_12x4_lib4(k, &alpha, pA2, sda, &pB[j*sdb], &beta, &pC[j*ps+i*sdc], sdc, &pD[j*ps+i*sdd], sdd);
+		kernel_dsyrk_nt_l_12x4_lib4(k, &alpha, pA2, sda2, &pB[j*sdb], &beta, &pC[j*ps+i*sdc], sdc, &pD[j*ps+i*sdd], sdd);
 #if defined(TARGET_X64_INTEL_HASWELL)
-		kernel_dsyrk_nt_l_8x8_lib4(k, &alpha, pA2+4*sda2, sda, &pB[(j+4)*sdb], sdb, &beta, &pC[(j+4)*ps+(i+4)*sdc], sdc, &pD[(j+4)*ps+(i+4)*sdd], sdd);
+		kernel_dsyrk_nt_l_8x8_lib4(k, &alpha, pA2+4*sda2, sda2, &pB[(j+4)*sdb], sdb, &beta, &pC[(j+4)*ps+(i+4)*sdc], sdc, &pD[(j+4)*ps+(i+4)*sdd], sdd);
 #else
-		kernel_dsyrk_nt_l_8x4_lib4(k, &alpha, pA2+4*sda2, sda, &pB[(j+4)*sdb], &beta, &pC[(j+4)*ps+(i+4)*sdc], sdc, &pD[(j+4)*ps+(i+4)*sdd], sdd);
+		kernel_dsyrk_nt_l_8x4_lib4(k, &alpha, pA2+4*sda2, sda2, &pB[(j+4)*sdb], &beta, &pC[(j+4)*ps+(i+4)*sdc], sdc, &pD[(j+4)*ps+(i+4)*sdd], sdd);
 		kernel_dsyrk_nt_l_4x4_lib4(k, &alpha, pA2+8*sda2, &pB[(j+8)*sdb], &beta, &pC[(j+8)*ps+(i+8)*sdc], &pD[(j+8)*ps+(i+8)*sdd]);
 #endif
 		}
@@ -5611,9 +5658,9 @@ loop_000:
 		// main loop
 		for(; j<i; j+=4)
 			{
-			kernel_dgemm_nt_8x4_lib4(k, &alpha, pA2, sda, &pB[j*sdb], &beta, &pC[j*ps+i*sdc], sdc, &pD[j*ps+i*sdd], sdd);
+			kernel_dgemm_nt_8x4_lib4(k, &alpha, pA2, sda2, &pB[j*sdb], &beta, &pC[j*ps+i*sdc], sdc, &pD[j*ps+i*sdd], sdd);
 			}
-		kernel_dsyrk_nt_l_8x4_lib4(k, &alpha, pA2, sda, &pB[j*sdb], &beta, &pC[j*ps+i*sdc], sdc, &pD[j*ps+i*sdd], sdd);
+		kernel_dsyrk_nt_l_8x4_lib4(k, &alpha, pA2, sda2, &pB[j*sdb], &beta, &pC[j*ps+i*sdc], sdc, &pD[j*ps+i*sdd], sdd);
 		kernel_dsyrk_nt_l_4x4_lib4(k, &alpha, pA2+4*sda2, &pB[(j+4)*sdb], &beta, &pC[(j+4)*ps+(i+4)*sdc], &pD[(j+4)*ps+(i+4)*sdd]);
 		}
 	if(m>i)
@@ -5769,10 +5816,10 @@ loop_0CD:
 		// main loop
 		for(; j<i; j+=4)
 			{
-			kernel_dgemm_nt_12x4_gen_lib4(k, &alpha, pA2, sda, &pB[j*sdb], &beta, offsetC, &pC[j*ps+i*sdc], sdc, offsetD, &pD[j*ps+i*sdd], sdd, 0, m-i, 0, m-j);
+			kernel_dgemm_nt_12x4_gen_lib4(k, &alpha, pA2, sda2, &pB[j*sdb], &beta, offsetC, &pC[j*ps+i*sdc], sdc, offsetD, &pD[j*ps+i*sdd], sdd, 0, m-i, 0, m-j);
 			}
-		kernel_dsyrk_nt_l_12x4_gen_lib4(k, &alpha, pA2, sda, &pB[j*sdb], &beta, offsetC, &pC[j*ps+i*sdc], sdc, offsetD, &pD[j*ps+i*sdd], sdd, 0, m-i, 0, m-j);
-		kernel_dsyrk_nt_l_8x8_gen_lib4(k, &alpha, pA2+4*sda2, sda, &pB[(j+4)*sdb], sdb, &beta, offsetC, &pC[(j+4)*ps+(i+4)*sdc], sdc, offsetD, &pD[(j+4)*ps+(i+4)*sdd], sdd, 0, m-i-4, 0, m-j-4);
+		kernel_dsyrk_nt_l_12x4_gen_lib4(k, &alpha, pA2, sda2, &pB[j*sdb], &beta, offsetC, &pC[j*ps+i*sdc], sdc, offsetD, &pD[j*ps+i*sdd], sdd, 0, m-i, 0, m-j);
+		kernel_dsyrk_nt_l_8x8_gen_lib4(k, &alpha, pA2+4*sda2, sda2, &pB[(j+4)*sdb], sdb, &beta, offsetC, &pC[(j+4)*ps+(i+4)*sdc], sdc, offsetD, &pD[(j+4)*ps+(i+4)*sdd], sdd, 0, m-i-4, 0, m-j-4);
 		}
 	if(m>i)
 		{
@@ -5943,13 +5990,13 @@ loop_BCD:
 	// main loop
 	for(; j<i; j+=4)
 		{
-		kernel_dgemm_nt_12x4_vs_lib4(k, &alpha, pA2, sda, &pB[j*sdb], &beta, &pC[j*ps+i*sdc], sdc, &pD[j*ps+i*sdd], sdd, m-i, m-j);
+		kernel_dgemm_nt_12x4_vs_lib4(k, &alpha, pA2, sda2, &pB[j*sdb], &beta, &pC[j*ps+i*sdc], sdc, &pD[j*ps+i*sdd], sdd, m-i, m-j);
 		}
-	kernel_dsyrk_nt_l_12x4_vs_lib4(k, &alpha, pA2, sda, &pB[j*sdb], &beta, &pC[j*ps+i*sdc], sdc, &pD[j*ps+i*sdd], sdd, m-i, m-j);
+	kernel_dsyrk_nt_l_12x4_vs_lib4(k, &alpha, pA2, sda2, &pB[j*sdb], &beta, &pC[j*ps+i*sdc], sdc, &pD[j*ps+i*sdd], sdd, m-i, m-j);
 #if defined(TARGET_X64_INTEL_HASWELL)
-	kernel_dsyrk_nt_l_8x8_vs_lib4(k, &alpha, pA2+4*sda2, sda, &pB[(j+4)*sdb], sdb, &beta, &pC[(j+4)*ps+(i+4)*sdc], sdc, &pD[(j+4)*ps+(i+4)*sdd], sdd, m-i-4, m-j-4);
+	kernel_dsyrk_nt_l_8x8_vs_lib4(k, &alpha, pA2+4*sda2, sda2, &pB[(j+4)*sdb], sdb, &beta, &pC[(j+4)*ps+(i+4)*sdc], sdc, &pD[(j+4)*ps+(i+4)*sdd], sdd, m-i-4, m-j-4);
 #else
-	kernel_dsyrk_nt_l_8x4_vs_lib4(k, &alpha, pA2+4*sda2, sda, &pB[(j+4)*sdb], &beta, &pC[(j+4)*ps+(i+4)*sdc], sdc, &pD[(j+4)*ps+(i+4)*sdd], sdd, m-i-4, m-j-4);
+	kernel_dsyrk_nt_l_8x4_vs_lib4(k, &alpha, pA2+4*sda2, sda2, &pB[(j+4)*sdb], &beta, &pC[(j+4)*ps+(i+4)*sdc], sdc, &pD[(j+4)*ps+(i+4)*sdd], sdd, m-i-4, m-j-4);
 	kernel_dsyrk_nt_l_4x4_vs_lib4(k, &alpha, pA2+8*sda2, &pB[(j+8)*sdb], &beta, &pC[(j+8)*ps+(i+8)*sdc], &pD[(j+8)*ps+(i+8)*sdd], m-i-8, m-j-8);
 #endif
 	goto end;
@@ -5974,21 +6021,21 @@ loop_BCD:
 	// main loop
 	for(; j<i-8; j+=12)
 		{
-		kernel_dgemm_nt_8x8l_vs_lib4(k, &alpha, pA2, sda, &pB[j*sdb], sdb, &beta, &pC[j*ps+i*sdc], sdc, &pD[j*ps+i*sdd], sdd, m-i, m-j);
-		kernel_dgemm_nt_8x8u_vs_lib4(k, &alpha, pA2, sda, &pB[(j+4)*sdb], sdb, &beta, &pC[(j+4)*ps+i*sdc], sdc, &pD[(j+4)*ps+i*sdd], sdd, m-i, m-(j+4));
+		kernel_dgemm_nt_8x8l_vs_lib4(k, &alpha, pA2, sda2, &pB[j*sdb], sdb, &beta, &pC[j*ps+i*sdc], sdc, &pD[j*ps+i*sdd], sdd, m-i, m-j);
+		kernel_dgemm_nt_8x8u_vs_lib4(k, &alpha, pA2, sda2, &pB[(j+4)*sdb], sdb, &beta, &pC[(j+4)*ps+i*sdc], sdc, &pD[(j+4)*ps+i*sdd], sdd, m-i, m-(j+4));
 		}
 	if(j<i-4)
 		{
-		kernel_dgemm_nt_8x8l_vs_lib4(k, &alpha, pA2, sda, &pB[j*sdb], sdb, &beta, &pC[j*ps+i*sdc], sdc, &pD[j*ps+i*sdd], sdd, m-i, m-j);
+		kernel_dgemm_nt_8x8l_vs_lib4(k, &alpha, pA2, sda2, &pB[j*sdb], sdb, &beta, &pC[j*ps+i*sdc], sdc, &pD[j*ps+i*sdd], sdd, m-i, m-j);
 		kernel_dgemm_nt_4x4_vs_lib4(k, &alpha, pA2, &pB[(j+4)*sdb], &beta, &pC[(j+4)*ps+i*sdc], &pD[(j+4)*ps+i*sdd], m-i, m-(j+4));
 		j += 8;
 		}
 	else if(j<i)
 		{
-		kernel_dgemm_nt_8x4_vs_lib4(k, &alpha, pA2, sda, &pB[j*sdb], &beta, &pC[j*ps+i*sdc], sdc, &pD[j*ps+i*sdd], sdd, m-i, m-j);
+		kernel_dgemm_nt_8x4_vs_lib4(k, &alpha, pA2, sda2, &pB[j*sdb], &beta, &pC[j*ps+i*sdc], sdc, &pD[j*ps+i*sdd], sdd, m-i, m-j);
 		j += 4;
 		}
-	kernel_dsyrk_nt_l_8x8_vs_lib4(k, &alpha, pA2, sda, &pB[j*sdb], sdb, &beta, &pC[j*ps+i*sdc], sdc, &pD[j*ps+i*sdd], sdd, m-i, m-j);
+	kernel_dsyrk_nt_l_8x8_vs_lib4(k, &alpha, pA2, sda2, &pB[j*sdb], sdb, &beta, &pC[j*ps+i*sdc], sdc, &pD[j*ps+i*sdd], sdd, m-i, m-j);
 	goto end;
 #elif defined(TARGET_X64_INTEL_SANDY_BRIDGE)
 	left_8:
@@ -6007,9 +6054,9 @@ loop_BCD:
 	// main loop
 	for(; j<i; j+=4)
 		{
-		kernel_dgemm_nt_8x4_vs_lib4(k, &alpha, pA2, sda, &pB[j*sdb], &beta, &pC[j*ps+i*sdc], sdc, &pD[j*ps+i*sdd], sdd, m-i, m-j);
+		kernel_dgemm_nt_8x4_vs_lib4(k, &alpha, pA2, sda2, &pB[j*sdb], &beta, &pC[j*ps+i*sdc], sdc, &pD[j*ps+i*sdd], sdd, m-i, m-j);
 		}
-	kernel_dsyrk_nt_l_8x4_vs_lib4(k, &alpha, pA2, sda, &pB[j*sdb], &beta, &pC[j*ps+i*sdc], sdc, &pD[j*ps+i*sdd], sdd, m-i, m-j);
+	kernel_dsyrk_nt_l_8x4_vs_lib4(k, &alpha, pA2, sda2, &pB[j*sdb], &beta, &pC[j*ps+i*sdc], sdc, &pD[j*ps+i*sdd], sdd, m-i, m-j);
 	kernel_dsyrk_nt_l_4x4_vs_lib4(k, &alpha, pA2+4*sda2, &pB[(j+4)*sdb], &beta, &pC[(j+4)*ps+(i+4)*sdc], &pD[(j+4)*ps+(i+4)*sdd], m-i-4, m-j-4);
 	goto end;
 #elif defined(TARGET_ARMV8A_ARM_CORTEX_A57) || defined(TARGET_ARMV8A_ARM_CORTEX_A53)
@@ -6030,9 +6077,9 @@ loop_BCD:
 	// main loop
 	for(; j<i; j+=4)
 		{
-		kernel_dgemm_nt_8x4_vs_lib4(k, &alpha, pA2, sda, &pB[j*sdb], &beta, &pC[j*ps+i*sdc], sdc, &pD[j*ps+i*sdd], sdd, m-i, m-j);
+		kernel_dgemm_nt_8x4_vs_lib4(k, &alpha, pA2, sda2, &pB[j*sdb], &beta, &pC[j*ps+i*sdc], sdc, &pD[j*ps+i*sdd], sdd, m-i, m-j);
 		}
-	kernel_dsyrk_nt_l_8x4_vs_lib4(k, &alpha, pA2, sda, &pB[j*sdb], &beta, &pC[j*ps+i*sdc], sdc, &pD[j*ps+i*sdd], sdd, m-i, m-j);
+	kernel_dsyrk_nt_l_8x4_vs_lib4(k, &alpha, pA2, sda2, &pB[j*sdb], &beta, &pC[j*ps+i*sdc], sdc, &pD[j*ps+i*sdd], sdd, m-i, m-j);
 	kernel_dsyrk_nt_l_4x4_vs_lib4(k, &alpha, pA2+4*sda2, &pB[(j+4)*sdb], &beta, &pC[(j+4)*ps+(i+4)*sdc], &pD[(j+4)*ps+(i+4)*sdd], m-i-4, m-j-4);
 	goto end;
 #endif
@@ -6208,7 +6255,7 @@ end:
 		if(air!=0)
 			{
 #ifdef EXT_DEP_MALLOC
-			blasfeo_free(mem);
+			blasfeo_ws_free(mem);
 #else // EXT_DEP_MALLOC
 #endif // EXT_DEP_MALLOC
 			}
@@ -6973,7 +7020,9 @@ void blasfeo_hp_dsyrk_ut(int m, int k, double alpha, struct blasfeo_dmat *sA, in
 		{
 #ifdef EXT_DEP_MALLOC
 		sdu = (k+ps-1)/ps*ps;
-		blasfeo_malloc(&mem, 12*sdu*sizeof(double)+63);
+		blasfeo_ws_malloc(&mem, 12*sdu*sizeof(double)+63);
+		if(mem==NULL)
+			return;
 		blasfeo_align_64_byte(mem, (void **) &pU);
 #else // EXT_DEP_MALLOC
 		// not enought static memory, can't allocate dynamic memory
@@ -7151,7 +7200,7 @@ end:
 	if(k>K_MAX_STACK)
 		{
 #ifdef EXT_DEP_MALLOC
-		blasfeo_free(mem);
+		blasfeo_ws_free(mem);
 #else // EXT_DEP_MALLOC
 #endif // EXT_DEP_MALLOC
 		}
@@ -7201,6 +7250,168 @@ void blasfeo_hp_dsyr2k_ut(int m, int k, double alpha, struct blasfeo_dmat *sA, i
 
 
 
+// D <= beta * C + alpha * A * B, with A symmetric and only its lower triangle accessed
+void blasfeo_hp_dsymm_ll(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj)
+	{
+	if(m<=0 || n<=0)
+		return;
+
+	const int ps = 4;
+	// rows of A packed at once
+	const int nb = 16*ps;
+
+	int sda = sA->cn;
+	double *pA = sA->pA + aj*ps;
+
+	struct blasfeo_dmat tU;
+	void *mem;
+	char *mem_align;
+	int tU_size = blasfeo_memsize_dmat(nb, m);
+	blasfeo_ws_malloc(&mem, tU_size+64);
+	if(mem==NULL)
+		return;
+	blasfeo_align_64_byte(mem, (void **) &mem_align);
+	blasfeo_create_dmat(nb, m, &tU, (void *) mem_align);
+	// the padding rows of the last strip go through the gemm kernels too
+	blasfeo_zero_memset(tU_size, tU.pA);
+
+	int ii, mb;
+	for(ii=0; ii<m; ii+=mb)
+		{
+		// the first strip aligns the rows of D to the panels
+		mb = ii==0 & (di&(ps-1))!=0 ? ps-(di&(ps-1)) : nb;
+		mb = m-ii<mb ? m-ii : mb;
+		kernel_dpacp_buffer_sl(mb, m, ii, 0, ai, pA, sda, tU.pA, tU.cn);
+		blasfeo_hp_dgemm_nn(mb, n, m, alpha, &tU, 0, 0, sB, bi, bj, beta, sC, ci+ii, cj, sD, di+ii, dj);
+		}
+
+	blasfeo_ws_free(mem);
+	return;
+	}
+
+
+
+// D <= beta * C + alpha * A * B, with A symmetric and only its upper triangle accessed
+void blasfeo_hp_dsymm_lu(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj)
+	{
+	if(m<=0 || n<=0)
+		return;
+
+	const int ps = 4;
+	// rows of A packed at once
+	const int nb = 16*ps;
+
+	int sda = sA->cn;
+	double *pA = sA->pA + aj*ps;
+
+	struct blasfeo_dmat tU;
+	void *mem;
+	char *mem_align;
+	int tU_size = blasfeo_memsize_dmat(nb, m);
+	blasfeo_ws_malloc(&mem, tU_size+64);
+	if(mem==NULL)
+		return;
+	blasfeo_align_64_byte(mem, (void **) &mem_align);
+	blasfeo_create_dmat(nb, m, &tU, (void *) mem_align);
+	// the padding rows of the last strip go through the gemm kernels too
+	blasfeo_zero_memset(tU_size, tU.pA);
+
+	int ii, mb;
+	for(ii=0; ii<m; ii+=mb)
+		{
+		// the first strip aligns the rows of D to the panels
+		mb = ii==0 & (di&(ps-1))!=0 ? ps-(di&(ps-1)) : nb;
+		mb = m-ii<mb ? m-ii : mb;
+		kernel_dpacp_buffer_su(mb, m, ii, 0, ai, pA, sda, tU.pA, tU.cn);
+		blasfeo_hp_dgemm_nn(mb, n, m, alpha, &tU, 0, 0, sB, bi, bj, beta, sC, ci+ii, cj, sD, di+ii, dj);
+		}
+
+	blasfeo_ws_free(mem);
+	return;
+	}
+
+
+
+// D <= beta * C + alpha * B * A, with A symmetric and only its lower triangle accessed
+void blasfeo_hp_dsymm_rl(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj)
+	{
+	if(m<=0 || n<=0)
+		return;
+
+	const int ps = 4;
+	// rows of A packed at once
+	const int nb = 16*ps;
+
+	int sda = sA->cn;
+	double *pA = sA->pA + aj*ps;
+
+	struct blasfeo_dmat tU;
+	void *mem;
+	char *mem_align;
+	int tU_size = blasfeo_memsize_dmat(nb, n);
+	blasfeo_ws_malloc(&mem, tU_size+64);
+	if(mem==NULL)
+		return;
+	blasfeo_align_64_byte(mem, (void **) &mem_align);
+	blasfeo_create_dmat(nb, n, &tU, (void *) mem_align);
+	// the padding rows of the last strip go through the gemm kernels too
+	blasfeo_zero_memset(tU_size, tU.pA);
+
+	// columns jj:jj+nb of A are the transposed of its rows jj:jj+nb
+	int jj, nbl;
+	for(jj=0; jj<n; jj+=nbl)
+		{
+		nbl = n-jj<nb ? n-jj : nb;
+		kernel_dpacp_buffer_sl(nbl, n, jj, 0, ai, pA, sda, tU.pA, tU.cn);
+		blasfeo_hp_dgemm_nt(m, nbl, n, alpha, sB, bi, bj, &tU, 0, 0, beta, sC, ci, cj+jj, sD, di, dj+jj);
+		}
+
+	blasfeo_ws_free(mem);
+	return;
+	}
+
+
+
+// D <= beta * C + alpha * B * A, with A symmetric and only its upper triangle accessed
+void blasfeo_hp_dsymm_ru(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj)
+	{
+	if(m<=0 || n<=0)
+		return;
+
+	const int ps = 4;
+	// rows of A packed at once
+	const int nb = 16*ps;
+
+	int sda = sA->cn;
+	double *pA = sA->pA + aj*ps;
+
+	struct blasfeo_dmat tU;
+	void *mem;
+	char *mem_align;
+	int tU_size = blasfeo_memsize_dmat(nb, n);
+	blasfeo_ws_malloc(&mem, tU_size+64);
+	if(mem==NULL)
+		return;
+	blasfeo_align_64_byte(mem, (void **) &mem_align);
+	blasfeo_create_dmat(nb, n, &tU, (void *) mem_align);
+	// the padding rows of the last strip go through the gemm kernels too
+	blasfeo_zero_memset(tU_size, tU.pA);
+
+	// columns jj:jj+nb of A are the transposed of its rows jj:jj+nb
+	int jj, nbl;
+	for(jj=0; jj<n; jj+=nbl)
+		{
+		nbl = n-jj<nb ? n-jj : nb;
+		kernel_dpacp_buffer_su(nbl, n, jj, 0, ai, pA, sda, tU.pA, tU.cn);
+		blasfeo_hp_dgemm_nt(m, nbl, n, alpha, sB, bi, bj, &tU, 0, 0, beta, sC, ci, cj+jj, sD, di, dj+jj);
+		}
+
+	blasfeo_ws_free(mem);
+	return;
+	}
+
+
+
 #if defined(LA_HIGH_PERFORMANCE)
 
 
@@ -7520,6 +7731,34 @@ void blasfeo_dsyr2k_ut(int m, int k, double alpha, struct blasfeo_dmat *sA, int
 
 
 
+void blasfeo_dsymm_ll(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj)
+	{
+	blasfeo_hp_dsymm_ll(m, n, alpha, sA, ai, aj, sB, bi, bj, beta, sC, ci, cj, sD, di, dj);
+	}
+
+
+
+void blasfeo_dsymm_lu(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj)
+	{
+	blasfeo_hp_dsymm_lu(m, n, alpha, sA, ai, aj, sB, bi, bj, beta, sC, ci, cj, sD, di, dj);
+	}
+
+
+
+void blasfeo_dsymm_rl(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj)
+	{
+	blasfeo_hp_dsymm_rl(m, n, alpha, sA, ai, aj, sB, bi, bj, beta, sC, ci, cj, sD, di, dj);
+	}
+
+
+
+void blasfeo_dsymm_ru(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj)
+	{
+	blasfeo_hp_dsymm_ru(m, n, alpha, sA, ai, aj, sB, bi, bj, beta, sC, ci, cj, sD, di, dj);
+	}
+
+
+
 #endif
 
 
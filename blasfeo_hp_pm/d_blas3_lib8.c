@@ -40,18 +40,47 @@
 #include <blasfeo_d_kernel.h>
 #include <blasfeo_d_aux.h>
 #include <blasfeo_d_blasfeo_api.h>
+#include <blasfeo_stdlib.h>
+#include <blasfeo_thread_pool.h>
 #if defined(BLASFEO_REF_API)
 #include <blasfeo_d_blasfeo_ref_api.h>
 #endif
 
 
 
+#if defined(MULTITHREAD)
+
+#define REAL double
+#define XMAT blasfeo_dmat
+#define PS 8
+
+#define GEMM_MT_M_FIRST 16
+#define GEMM_MT_M_GRAIN 48
+#define GEMM_MT_N_GRAIN 16
+
+#define GEMM_MT_ARG d_gemm_mt_arg
+#define GEMM_MT_UNITS d_gemm_mt_units
+#define GEMM_MT_OFFSET d_gemm_mt_offset
+#define GEMM_MT_WORK d_gemm_mt_work
+#define GEMM_MT d_gemm_mt
+
+#include "x_blas3_mt_lib.c"
+
+#endif
+
+
+
 // dgemm nn
 void blasfeo_hp_dgemm_nn(int m, int n, int k, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj)
 	{
 	if(m<=0 || n<=0)
 		return;
 
+#if defined(MULTITHREAD)
+	if(d_gemm_mt(0, &blasfeo_hp_dgemm_nn, m, n, k, alpha, sA, ai, aj, sB, bi, bj, beta, sC, ci, cj, sD, di, dj))
+		return;
+#endif
+
 	// invalidate stored inverse diagonal of result matrix
 	sD->use_dA = 0;
 
@@ -280,6 +309,11 @@ void blasfeo_hp_dgemm_nt(int m, int n, int k, double alpha, struct blasfeo_dmat
 	if(m<=0 | n<=0)
 		return;
 
+#if defined(MULTITHREAD)
+	if(d_gemm_mt(1, &blasfeo_hp_dgemm_nt, m, n, k, alpha, sA, ai, aj, sB, bi, bj, beta, sC, ci, cj, sD, di, dj))
+		return;
+#endif
+
 	// invalidate stored inverse diagonal of result matrix
 	sD->use_dA = 0;
 
@@ -719,7 +753,9 @@ void blasfeo_hp_dgemm_tn(int m, int n, int k, double alpha, struct blasfeo_dmat
 		{
 		sAt_size = blasfeo_memsize_dmat(16, k);
 //		sAt_size = blasfeo_memsize_dmat(8, k);
-		mem = malloc(sAt_size+64);
+		blasfeo_ws_malloc((void **) &mem, sAt_size+64);
+		if(mem==NULL)
+			return;
 		blasfeo_align_64_byte(mem, (void **) &mem_align);
 		blasfeo_create_dmat(16, k, &sAt, (void *) mem_align);
 //		blasfeo_create_dmat(8, k, &sAt, (void *) mem_align);
@@ -942,7 +978,7 @@ left_8_n0:
 tn_return:
 	if(k>K_MAX_STACK)
 		{
-		free(mem);
+		blasfeo_ws_free(mem);
 		}
 	return;
 
@@ -2102,7 +2138,9 @@ void blasfeo_hp_dsyrk_ln(int m, int k, double alpha, struct blasfeo_dmat *sA, in
 		{
 		sAt_size = blasfeo_memsize_dmat(16, k);
 //		sAt_size = blasfeo_memsize_dmat(8, k);
-		mem = malloc(sAt_size+64);
+		blasfeo_ws_malloc((void **) &mem, sAt_size+64);
+		if(mem==NULL)
+			return;
 		blasfeo_align_64_byte(mem, (void **) &mem_align);
 		blasfeo_create_dmat(16, k, &sAt, (void *) mem_align);
 //		blasfeo_create_dmat(8, k, &sAt, (void *) mem_align);
@@ -2372,7 +2410,7 @@ loop_0CD:
 end:
 	if(k>K_MAX_STACK)
 		{
-		free(mem);
+		blasfeo_ws_free(mem);
 		}
 	return;
 
@@ -2705,6 +2743,168 @@ void blasfeo_hp_dsyr2k_ut(int m, int k, double alpha, struct blasfeo_dmat *sA, i
 
 
 
+// D <= beta * C + alpha * A * B, with A symmetric and only its lower triangle accessed
+void blasfeo_hp_dsymm_ll(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj)
+	{
+	if(m<=0 || n<=0)
+		return;
+
+	const int ps = 8;
+	// rows of A packed at once
+	const int nb = 16*ps;
+
+	int sda = sA->cn;
+	double *pA = sA->pA + aj*ps;
+
+	struct blasfeo_dmat tU;
+	void *mem;
+	char *mem_align;
+	int tU_size = blasfeo_memsize_dmat(nb, m);
+	blasfeo_ws_malloc(&mem, tU_size+64);
+	if(mem==NULL)
+		return;
+	blasfeo_align_64_byte(mem, (void **) &mem_align);
+	blasfeo_create_dmat(nb, m, &tU, (void *) mem_align);
+	// the padding rows of the last strip go through the gemm kernels too
+	blasfeo_zero_memset(tU_size, tU.pA);
+
+	int ii, mb;
+	for(ii=0; ii<m; ii+=mb)
+		{
+		// the first strip aligns the rows of D to the panels
+		mb = ii==0 & (di&(ps-1))!=0 ? ps-(di&(ps-1)) : nb;
+		mb = m-ii<mb ? m-ii : mb;
+		kernel_dpacp_buffer_sl_lib8(mb, m, ii, 0, ai, pA, sda, tU.pA, tU.cn);
+		blasfeo_hp_dgemm_nn(mb, n, m, alpha, &tU, 0, 0, sB, bi, bj, beta, sC, ci+ii, cj, sD, di+ii, dj);
+		}
+
+	blasfeo_ws_free(mem);
+	return;
+	}
+
+
+
+// D <= beta * C + alpha * A * B, with A symmetric and only its upper triangle accessed
+void blasfeo_hp_dsymm_lu(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj)
+	{
+	if(m<=0 || n<=0)
+		return;
+
+	const int ps = 8;
+	// rows of A packed at once
+	const int nb = 16*ps;
+
+	int sda = sA->cn;
+	double *pA = sA->pA + aj*ps;
+
+	struct blasfeo_dmat tU;
+	void *mem;
+	char *mem_align;
+	int tU_size = blasfeo_memsize_dmat(nb, m);
+	blasfeo_ws_malloc(&mem, tU_size+64);
+	if(mem==NULL)
+		return;
+	blasfeo_align_64_byte(mem, (void **) &mem_align);
+	blasfeo_create_dmat(nb, m, &tU, (void *) mem_align);
+	// the padding rows of the last strip go through the gemm kernels too
+	blasfeo_zero_memset(tU_size, tU.pA);
+
+	int ii, mb;
+	for(ii=0; ii<m; ii+=mb)
+		{
+		// the first strip aligns the rows of D to the panels
+		mb = ii==0 & (di&(ps-1))!=0 ? ps-(di&(ps-1)) : nb;
+		mb = m-ii<mb ? m-ii : mb;
+		kernel_dpacp_buffer_su_lib8(mb, m, ii, 0, ai, pA, sda, tU.pA, tU.cn);
+		blasfeo_hp_dgemm_nn(mb, n, m, alpha, &tU, 0, 0, sB, bi, bj, beta, sC, ci+ii, cj, sD, di+ii, dj);
+		}
+
+	blasfeo_ws_free(mem);
+	return;
+	}
+
+
+
+// D <= beta * C + alpha * B * A, with A symmetric and only its lower triangle accessed
+void blasfeo_hp_dsymm_rl(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj)
+	{
+	if(m<=0 || n<=0)
+		return;
+
+	const int ps = 8;
+	// rows of A packed at once
+	const int nb = 16*ps;
+
+	int sda = sA->cn;
+	double *pA = sA->pA + aj*ps;
+
+	struct blasfeo_dmat tU;
+	void *mem;
+	char *mem_align;
+	int tU_size = blasfeo_memsize_dmat(nb, n);
+	blasfeo_ws_malloc(&mem, tU_size+64);
+	if(mem==NULL)
+		return;
+	blasfeo_align_64_byte(mem, (void **) &mem_align);
+	blasfeo_create_dmat(nb, n, &tU, (void *) mem_align);
+	// the padding rows of the last strip go through the gemm kernels too
+	blasfeo_zero_memset(tU_size, tU.pA);
+
+	// columns jj:jj+nb of A are the transposed of its rows jj:jj+nb
+	int jj, nbl;
+	for(jj=0; jj<n; jj+=nbl)
+		{
+		nbl = n-jj<nb ? n-jj : nb;
+		kernel_dpacp_buffer_sl_lib8(nbl, n, jj, 0, ai, pA, sda, tU.pA, tU.cn);
+		blasfeo_hp_dgemm_nt(m, nbl, n, alpha, sB, bi, bj, &tU, 0, 0, beta, sC, ci, cj+jj, sD, di, dj+jj);
+		}
+
+	blasfeo_ws_free(mem);
+	return;
+	}
+
+
+
+// D <= beta * C + alpha * B * A, with A symmetric and only its upper triangle accessed
+void blasfeo_hp_dsymm_ru(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj)
+	{
+	if(m<=0 || n<=0)
+		return;
+
+	const int ps = 8;
+	// rows of A packed at once
+	const int nb = 16*ps;
+
+	int sda = sA->cn;
+	double *pA = sA->pA + aj*ps;
+
+	struct blasfeo_dmat tU;
+	void *mem;
+	char *mem_align;
+	int tU_size = blasfeo_memsize_dmat(nb, n);
+	blasfeo_ws_malloc(&mem, tU_size+64);
+	if(mem==NULL)
+		return;
+	blasfeo_align_64_byte(mem, (void **) &mem_align);
+	blasfeo_create_dmat(nb, n, &tU, (void *) mem_align);
+	// the padding rows of the last strip go through the gemm kernels too
+	blasfeo_zero_memset(tU_size, tU.pA);
+
+	// columns jj:jj+nb of A are the transposed of its rows jj:jj+nb
+	int jj, nbl;
+	for(jj=0; jj<n; jj+=nbl)
+		{
+		nbl = n-jj<nb ? n-jj : nb;
+		kernel_dpacp_buffer_su_lib8(nbl, n, jj, 0, ai, pA, sda, tU.pA, tU.cn);
+		blasfeo_hp_dgemm_nt(m, nbl, n, alpha, sB, bi, bj, &tU, 0, 0, beta, sC, ci, cj+jj, sD, di, dj+jj);
+		}
+
+	blasfeo_ws_free(mem);
+	return;
+	}
+
+
+
 #if defined(LA_HIGH_PERFORMANCE)
 
 
@@ -3024,6 +3224,34 @@ void blasfeo_dsyr2k_ut(int m, int k, double alpha, struct blasfeo_dmat *sA, int
 
 
 
+void blasfeo_dsymm_ll(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj)
+	{
+	blasfeo_hp_dsymm_ll(m, n, alpha, sA, ai, aj, sB, bi, bj, beta, sC, ci, cj, sD, di, dj);
+	}
+
+
+
+void blasfeo_dsymm_lu(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj)
+	{
+	blasfeo_hp_dsymm_lu(m, n, alpha, sA, ai, aj, sB, bi, bj, beta, sC, ci, cj, sD, di, dj);
+	}
+
+
+
+void blasfeo_dsymm_rl(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj)
+	{
+	blasfeo_hp_dsymm_rl(m, n, alpha, sA, ai, aj, sB, bi, bj, beta, sC, ci, cj, sD, di, dj);
+	}
+
+
+
+void blasfeo_dsymm_ru(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj)
+	{
+	blasfeo_hp_dsymm_ru(m, n, alpha, sA, ai, aj, sB, bi, bj, beta, sC, ci, cj, sD, di, dj);
+	}
+
+
+
 #endif
 
 
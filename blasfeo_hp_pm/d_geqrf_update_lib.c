@@ -0,0 +1,131 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2019 by Gianluca Frison.                                                          *
+* Developed at IMTEK (University of Freiburg) under the supervision of Moritz Diehl.              *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#include <blasfeo_common.h>
+#include <blasfeo_stdlib.h>
+#include <blasfeo_align.h>
+#include <blasfeo_d_aux.h>
+#include <blasfeo_d_blasfeo_api.h>
+
+
+
+// the R factor is updated in transposed form, as the lower factor L = R^T: in the (m x m) work matrix L and in the (m x k) work matrix W = A^T
+// return 0 if the work matrices can not be allocated
+static int d_geqrf_update_ws(int m, int k, int worksize, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sL, struct blasfeo_dmat *sW, void **work, void **mem)
+	{
+	size_t memsize_L = blasfeo_memsize_dmat(m, m);
+	size_t memsize_W = blasfeo_memsize_dmat(m, k);
+	char *mem_align;
+	blasfeo_ws_malloc(mem, memsize_L+memsize_W+worksize+64);
+	if(*mem==NULL)
+		return 0;
+	blasfeo_align_64_byte(*mem, (void **) &mem_align);
+	blasfeo_create_dmat(m, m, sL, mem_align);
+	mem_align += memsize_L;
+	blasfeo_create_dmat(m, k, sW, mem_align);
+	mem_align += memsize_W;
+	*work = (void *) mem_align;
+	// the kernels operate on whole panels: clean the upper part of L
+	blasfeo_dgese(m, m, 0.0, sL, 0, 0);
+	blasfeo_dtrtr_u(m, sC, ci, cj, sL, 0, 0);
+	// the R factor from dgeqrf can have negative diagonal elements: change sign to the corresponding rows
+	int jj;
+	for(jj=0; jj<m; jj++)
+		{
+		if(BLASFEO_DMATEL(sL, jj, jj)<0.0)
+			blasfeo_dgesc(m-jj, 1, -1.0, sL, jj, jj);
+		}
+	blasfeo_dgetr(k, m, sA, ai, aj, sW, 0, 0);
+	return 1;
+	}
+
+
+
+void blasfeo_dgeqrf_update_u(int m, int k, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj)
+	{
+
+	if(m<=0)
+		return;
+
+	// invalidate stored inverse diagonal of result matrix
+	sD->use_dA = 0;
+
+	struct blasfeo_dmat sL, sW;
+	void *work, *mem;
+	if(!d_geqrf_update_ws(m, k, blasfeo_dgelqf_worksize(m, m+k), sA, ai, aj, sC, ci, cj, &sL, &sW, &work, &mem))
+		return;
+
+	// [L, A^T] <= lq( [L, A^T] ), with Householder reflections
+	if(k>0)
+		blasfeo_dgelqf_pd_la(m, k, &sL, 0, 0, &sW, 0, 0, work);
+
+	blasfeo_dtrtr_l(m, &sL, 0, 0, sD, di, dj);
+
+	blasfeo_ws_free(mem);
+
+	return;
+
+	}
+
+
+
+void blasfeo_dgeqrf_downdate_u(int m, int k, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj)
+	{
+
+	if(m<=0)
+		return;
+
+	// invalidate stored inverse diagonal of result matrix
+	sD->use_dA = 0;
+
+	struct blasfeo_dmat sL, sW;
+	void *work, *mem;
+	if(!d_geqrf_update_ws(m, k, 0, sA, ai, aj, sC, ci, cj, &sL, &sW, &work, &mem))
+		return;
+
+	// L * L^T <= L * L^T - A^T * A , with hyperbolic rotations
+	blasfeo_dpotrf_downdate_l(m, k, &sW, 0, 0, &sL, 0, 0, &sL, 0, 0);
+
+	blasfeo_dtrtr_l(m, &sL, 0, 0, sD, di, dj);
+
+	blasfeo_ws_free(mem);
+
+	return;
+
+	}
@@ -41,9 +41,15 @@
 #include <blasfeo_d_aux.h>
 #include <blasfeo_d_kernel.h>
 #include <blasfeo_d_blasfeo_api.h>
+#include <blasfeo_stdlib.h>
 #if defined(BLASFEO_REF_API)
 #include <blasfeo_d_blasfeo_ref_api.h>
 #endif
+#if defined(MULTITHREAD)
+#include <pthread.h>
+#include <blasfeo_d_blasfeo_hp_api.h>
+#include <blasfeo_thread_pool.h>
+#endif
 
 
 
@@ -103,7 +109,9 @@ void blasfeo_dgetrf_rp_test(int m, int n, struct blasfeo_dmat *sC, int ci, int c
 	if(n>K_MAX_STACK)
 		{
 		sdu = (n+ps-1)/ps*ps;
-		mem = malloc(12*sdu*sizeof(double)+64);
+		blasfeo_ws_malloc((void **) &mem, 12*sdu*sizeof(double)+64);
+		if(mem==NULL)
+			return;
 		blasfeo_align_64_byte(mem, (void **) &pU);
 		}
 	else
@@ -506,7 +514,7 @@ left_4:
 end:
 	if(n>K_MAX_STACK)
 		{
-		free(mem);
+		blasfeo_ws_free(mem);
 		}
 	return;
 
@@ -567,7 +575,9 @@ void blasfeo_dgetrf_np_test(int m, int n, struct blasfeo_dmat *sC, int ci, int c
 	if(n>K_MAX_STACK)
 		{
 		sdu = (n+ps-1)/ps*ps;
-		mem = malloc(12*sdu*sizeof(double)+63);
+		blasfeo_ws_malloc((void **) &mem, 12*sdu*sizeof(double)+63);
+		if(mem==NULL)
+			return;
 		blasfeo_align_64_byte(mem, (void **) &pU);
 		}
 	else
@@ -668,7 +678,7 @@ void blasfeo_dgetrf_np_test(int m, int n, struct blasfeo_dmat *sC, int ci, int c
 end:
 	if(n>K_MAX_STACK)
 		{
-		free(mem);
+		blasfeo_ws_free(mem);
 		}
 	return;
 
@@ -914,6 +924,51 @@ void dlauum_dpotrf_blk_nt_l_lib(int m, int n, int nv, int *rv, int *cv, double *
 
 
 
+#if defined(MULTITHREAD)
+
+#define REAL double
+#define XMAT blasfeo_dmat
+#define PS 4
+
+#define POTRF_L_MT_NB 192
+
+#define POTRF_L_MT_ARG d_potrf_l_mt_arg
+#define POTRF_L_MT_VIEW d_potrf_l_mt_view
+#define POTRF_L_MT_PUSH d_potrf_l_mt_push
+#define POTRF_L_MT_REMOVE d_potrf_l_mt_remove
+#define POTRF_L_MT_TASK d_potrf_l_mt_task
+#define POTRF_L_MT_RELEASE d_potrf_l_mt_release
+#define POTRF_L_MT_WORK d_potrf_l_mt_work
+#define POTRF_L_MT d_potrf_l_mt
+
+#define HP_GEMM_NT blasfeo_hp_dgemm_nt
+#define HP_SYRK_LN blasfeo_hp_dsyrk_ln
+#define HP_TRSM_RLTN blasfeo_hp_dtrsm_rltn
+#define HP_POTRF_L blasfeo_hp_dpotrf_l
+
+#define GETRF_RP_MT_NB 96
+#define GETRF_RP_MT_N_GRAIN 24
+
+#define GETRF_RP_MT_ARG d_getrf_rp_mt_arg
+#define GETRF_RP_MT_VIEW d_getrf_rp_mt_view
+#define GETRF_RP_MT_PANEL d_getrf_rp_mt_panel
+#define GETRF_RP_MT_UPDATE d_getrf_rp_mt_update
+#define GETRF_RP_MT_WORK d_getrf_rp_mt_work
+#define GETRF_RP_MT_SWAP_WORK d_getrf_rp_mt_swap_work
+#define GETRF_RP_MT d_getrf_rp_mt
+
+#define HP_GEMM_NN blasfeo_hp_dgemm_nn
+#define HP_TRSM_LLNU blasfeo_hp_dtrsm_llnu
+#define HP_GETRF_RP blasfeo_hp_dgetrf_rp
+#define ROWSW blasfeo_drowsw
+#define GECP blasfeo_dgecp
+
+#include "x_lapack_mt_lib.c"
+
+#endif
+
+
+
 // dpotrf
 void blasfeo_hp_dpotrf_l(int m, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj)
 	{
@@ -934,6 +989,11 @@ void blasfeo_hp_dpotrf_l(int m, struct blasfeo_dmat *sC, int ci, int cj, struct
 #endif
 		}
 
+#if defined(MULTITHREAD)
+	if(d_potrf_l_mt(m, sC, cj, sD, dj))
+		return;
+#endif
+
 	const int ps = 4;
 
 	double alpha = 1.0;
@@ -2409,6 +2469,11 @@ void blasfeo_hp_dgetrf_rp(int m, int n, struct blasfeo_dmat *sC, int ci, int cj,
 #endif
 		}
 
+#if defined(MULTITHREAD)
+	if(d_getrf_rp_mt(m, n, sC, cj, sD, dj, ipiv))
+		return;
+#endif
+
 	const int ps = 4;
 
 	int sdc = sC->cn;
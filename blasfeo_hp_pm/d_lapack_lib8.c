@@ -44,6 +44,39 @@
 #if defined(BLASFEO_REF_API)
 #include <blasfeo_d_blasfeo_ref_api.h>
 #endif
+#if defined(MULTITHREAD)
+#include <pthread.h>
+#include <blasfeo_d_blasfeo_hp_api.h>
+#include <blasfeo_thread_pool.h>
+#endif
+
+
+
+#if defined(MULTITHREAD)
+
+#define REAL double
+#define XMAT blasfeo_dmat
+#define PS 8
+
+#define POTRF_L_MT_NB 192
+
+#define POTRF_L_MT_ARG d_potrf_l_mt_arg
+#define POTRF_L_MT_VIEW d_potrf_l_mt_view
+#define POTRF_L_MT_PUSH d_potrf_l_mt_push
+#define POTRF_L_MT_REMOVE d_potrf_l_mt_remove
+#define POTRF_L_MT_TASK d_potrf_l_mt_task
+#define POTRF_L_MT_RELEASE d_potrf_l_mt_release
+#define POTRF_L_MT_WORK d_potrf_l_mt_work
+#define POTRF_L_MT d_potrf_l_mt
+
+#define HP_GEMM_NT blasfeo_hp_dgemm_nt
+#define HP_SYRK_LN blasfeo_hp_dsyrk_ln
+#define HP_TRSM_RLTN blasfeo_hp_dtrsm_rltn
+#define HP_POTRF_L blasfeo_hp_dpotrf_l
+
+#include "x_lapack_mt_lib.c"
+
+#endif
 
 
 
@@ -67,6 +100,11 @@ void blasfeo_hp_dpotrf_l(int m, struct blasfeo_dmat *sC, int ci, int cj, struct
 #endif
 		}
 
+#if defined(MULTITHREAD)
+	if(d_potrf_l_mt(m, sC, cj, sD, dj))
+		return;
+#endif
+
 	const int ps = 8;
 
 	double alpha = 1.0;
@@ -0,0 +1,165 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2019 by Gianluca Frison.                                                          *
+* Developed at IMTEK (University of Freiburg) under the supervision of Moritz Diehl.              *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+
+#include <blasfeo_common.h>
+#include <blasfeo_stdlib.h>
+#include <blasfeo_align.h>
+#include <blasfeo_d_aux.h>
+#include <blasfeo_d_blasfeo_api.h>
+
+
+
+// create the (m x (k+1)) work matrix W, holding one column of the factor and a copy of A in the other k columns
+// return 0 if the work matrix can not be allocated
+static int d_potrf_update_ws(int m, int k, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sW, void **mem)
+	{
+	size_t memsize_W = blasfeo_memsize_dmat(m, k+1);
+	char *mem_align;
+	blasfeo_ws_malloc(mem, memsize_W+64);
+	if(*mem==NULL)
+		return 0;
+	blasfeo_align_64_byte(*mem, (void **) &mem_align);
+	blasfeo_create_dmat(m, k+1, sW, mem_align);
+	blasfeo_dgecp(m, k, sA, ai, aj, sW, 0, 1);
+	return 1;
+	}
+
+
+
+void blasfeo_dpotrf_update_l(int m, int k, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj)
+	{
+
+	if(m<=0)
+		return;
+
+	// invalidate stored inverse diagonal of result matrix
+	sD->use_dA = 0;
+
+	if(sC!=sD | ci!=di | cj!=dj)
+		blasfeo_dtrcp_l(m, sC, ci, cj, sD, di, dj);
+
+	if(k<=0)
+		return;
+
+	struct blasfeo_dmat sW;
+	void *mem;
+	if(!d_potrf_update_ws(m, k, sA, ai, aj, &sW, &mem))
+		return;
+
+	int jj, ll;
+	double c, s;
+
+	for(jj=0; jj<m; jj++)
+		{
+		// column jj of the factor is rotated against all the columns of A, to annihilate their row jj
+		blasfeo_dgecp(m-jj, 1, sD, di+jj, dj+jj, &sW, jj, 0);
+		for(ll=1; ll<=k; ll++)
+			{
+			blasfeo_drotg(BLASFEO_DMATEL(&sW, jj, 0), BLASFEO_DMATEL(&sW, jj, ll), &c, &s);
+			blasfeo_dcolrot(m-jj, &sW, jj, 0, ll, c, s);
+			}
+		// positive diagonal
+		if(BLASFEO_DMATEL(&sW, jj, 0)<0.0)
+			blasfeo_dgesc(m-jj, 1, -1.0, &sW, jj, 0);
+		blasfeo_dgecp(m-jj, 1, &sW, jj, 0, sD, di+jj, dj+jj);
+		}
+
+	blasfeo_ws_free(mem);
+
+	return;
+
+	}
+
+
+
+void blasfeo_dpotrf_downdate_l(int m, int k, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj)
+	{
+
+	if(m<=0)
+		return;
+
+	// invalidate stored inverse diagonal of result matrix
+	sD->use_dA = 0;
+
+	if(sC!=sD | ci!=di | cj!=dj)
+		blasfeo_dtrcp_l(m, sC, ci, cj, sD, di, dj);
+
+	if(k<=0)
+		return;
+
+	struct blasfeo_dmat sW;
+	void *mem;
+	if(!d_potrf_update_ws(m, k, sA, ai, aj, &sW, &mem))
+		return;
+
+	int jj, ll;
+	double c, s, l, a, r2;
+
+	for(jj=0; jj<m; jj++)
+		{
+		// column jj of the factor is rotated against all the columns of A, to annihilate their row jj
+		blasfeo_dgecp(m-jj, 1, sD, di+jj, dj+jj, &sW, jj, 0);
+		for(ll=1; ll<=k; ll++)
+			{
+			l = BLASFEO_DMATEL(&sW, jj, 0);
+			a = BLASFEO_DMATEL(&sW, jj, ll);
+			r2 = (l-a)*(l+a);
+			if(l<=0.0 | r2<=0.0)
+				{
+				// not positive definite: zero column, as in dpotrf
+				blasfeo_dgese(m-jj, 1, 0.0, &sW, jj, 0);
+				break;
+				}
+			// hyperbolic rotation, in the mixed form: x <= (x - s*y) / c , y <= c*y - s*x
+			c = sqrt(r2)/l;
+			s = a/l;
+			blasfeo_dgesc(m-jj, 1, 1.0/c, &sW, jj, 0);
+			blasfeo_dgead(m-jj, 1, -s/c, &sW, jj, ll, &sW, jj, 0);
+			blasfeo_dgesc(m-jj, 1, c, &sW, jj, ll);
+			blasfeo_dgead(m-jj, 1, -s, &sW, jj, 0, &sW, jj, ll);
+			}
+		blasfeo_dgecp(m-jj, 1, &sW, jj, 0, sD, di+jj, dj+jj);
+		}
+
+	blasfeo_ws_free(mem);
+
+	return;
+
+	}
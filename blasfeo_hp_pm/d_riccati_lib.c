@@ -0,0 +1,1094 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2019 by Gianluca Frison.                                                          *
+* Developed at IMTEK (University of Freiburg) under the supervision of Moritz Diehl.              *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#include <blasfeo_common.h>
+#include <blasfeo_stdlib.h>
+#include <blasfeo_align.h>
+#include <blasfeo_thread_pool.h>
+#include <blasfeo_d_aux.h>
+#include <blasfeo_d_blasfeo_api.h>
+#include <blasfeo_d_riccati.h>
+
+
+
+// round up to the typical cache line size
+static size_t d_ric_align_64(size_t size)
+	{
+	return (size+63)/64*64;
+	}
+
+
+
+size_t blasfeo_memsize_driccati_ws(int N, int *nx, int *nu)
+	{
+	int nn;
+	int nuxm = 0;
+	int nxm = 0;
+	for(nn=0; nn<=N; nn++)
+		{
+		nuxm = nu[nn]+nx[nn]>nuxm ? nu[nn]+nx[nn] : nuxm;
+		nxm = nx[nn]>nxm ? nx[nn] : nxm;
+		}
+	size_t size = 0;
+	size += (N+2)*sizeof(struct blasfeo_dmat); // L, AL
+	size += (N+1)*sizeof(struct blasfeo_dvec); // Pb, tmp
+	size = d_ric_align_64(size);
+	for(nn=0; nn<=N; nn++)
+		size += d_ric_align_64(blasfeo_memsize_dmat(nu[nn]+nx[nn]+1, nu[nn]+nx[nn]));
+	size += d_ric_align_64(blasfeo_memsize_dmat(nuxm+1, nxm));
+	for(nn=0; nn<N; nn++)
+		size += d_ric_align_64(blasfeo_memsize_dvec(nx[nn+1]));
+	size += d_ric_align_64(blasfeo_memsize_dvec(nxm));
+	size += 64; // align to cache line
+	return size;
+	}
+
+
+
+void blasfeo_create_driccati_ws(int N, int *nx, int *nu, struct blasfeo_driccati_ws *ws, void *memory)
+	{
+	int nn;
+	int nuxm = 0;
+	int nxm = 0;
+	for(nn=0; nn<=N; nn++)
+		{
+		nuxm = nu[nn]+nx[nn]>nuxm ? nu[nn]+nx[nn] : nuxm;
+		nxm = nx[nn]>nxm ? nx[nn] : nxm;
+		}
+
+	ws->N = N;
+	ws->memsize = blasfeo_memsize_driccati_ws(N, nx, nu);
+
+	// structures
+	char *c_ptr = memory;
+	ws->L = (struct blasfeo_dmat *) c_ptr;
+	c_ptr += (N+1)*sizeof(struct blasfeo_dmat);
+	ws->AL = (struct blasfeo_dmat *) c_ptr;
+	c_ptr += sizeof(struct blasfeo_dmat);
+	ws->Pb = (struct blasfeo_dvec *) c_ptr;
+	c_ptr += N*sizeof(struct blasfeo_dvec);
+	ws->tmp = (struct blasfeo_dvec *) c_ptr;
+	c_ptr += sizeof(struct blasfeo_dvec);
+
+	// matrices and vectors, one after the other in the order they are accessed by the backward recursion
+	blasfeo_align_64_byte(c_ptr, (void **) &c_ptr);
+	for(nn=N; nn>=0; nn--)
+		{
+		blasfeo_create_dmat(nu[nn]+nx[nn]+1, nu[nn]+nx[nn], ws->L+nn, c_ptr);
+		c_ptr += d_ric_align_64(ws->L[nn].memsize);
+		}
+	blasfeo_create_dmat(nuxm+1, nxm, ws->AL, c_ptr);
+	c_ptr += d_ric_align_64(ws->AL->memsize);
+	for(nn=N-1; nn>=0; nn--)
+		{
+		blasfeo_create_dvec(nx[nn+1], ws->Pb+nn, c_ptr);
+		c_ptr += d_ric_align_64(ws->Pb[nn].memsize);
+		}
+	blasfeo_create_dvec(nxm, ws->tmp, c_ptr);
+	c_ptr += d_ric_align_64(ws->tmp->memsize);
+
+	return;
+	}
+
+
+
+void blasfeo_driccati_trf(int N, int *nx, int *nu, struct blasfeo_dmat *BAbt, struct blasfeo_dmat *RSQrq, struct blasfeo_driccati_ws *ws)
+	{
+
+	struct blasfeo_dmat *L = ws->L;
+	struct blasfeo_dmat *AL = ws->AL;
+
+	int nn, nux, nu1, nx1;
+
+	// last stage
+	blasfeo_dpotrf_l(nu[N]+nx[N], &RSQrq[N], 0, 0, &L[N], 0, 0);
+
+	// middle stages: L[nn] = chol( RSQ[nn] + BA[nn] * P[nn+1] * BA[nn]^T ) , with P[nn+1] = Lxx[nn+1] * Lxx[nn+1]^T
+	for(nn=N-1; nn>=0; nn--)
+		{
+		nux = nu[nn]+nx[nn];
+		nu1 = nu[nn+1];
+		nx1 = nx[nn+1];
+		blasfeo_dtrmm_rlnn(nux, nx1, 1.0, &L[nn+1], nu1, nu1, &BAbt[nn], 0, 0, AL, 0, 0);
+		blasfeo_dsyrk_dpotrf_ln(nux, nx1, AL, 0, 0, AL, 0, 0, &RSQrq[nn], 0, 0, &L[nn], 0, 0);
+		}
+
+	return;
+
+	}
+
+
+
+void blasfeo_driccati_trs(int N, int *nx, int *nu, struct blasfeo_dmat *BAbt, struct blasfeo_dvec *b, struct blasfeo_dvec *rq, struct blasfeo_dvec *ux, struct blasfeo_dvec *pi, struct blasfeo_driccati_ws *ws)
+	{
+
+	struct blasfeo_dmat *L = ws->L;
+	struct blasfeo_dvec *Pb = ws->Pb;
+	struct blasfeo_dvec *tmp = ws->tmp;
+
+	int nn, nux, nu0, nu1, nx1;
+
+	// backward substitution: the x part of ux[nn] holds the linear term of the cost-to-go
+	// (the first stage is solved for both u and x)
+
+	// last stage
+	nux = nu[N]+nx[N];
+	nu0 = N==0 ? nux : nu[N];
+	blasfeo_dveccp(nux, &rq[N], 0, &ux[N], 0);
+	if(nu0>0)
+		blasfeo_dtrsv_lnn_mn(nux, nu0, &L[N], 0, 0, &ux[N], 0, &ux[N], 0);
+
+	// middle stages
+	for(nn=N-1; nn>=0; nn--)
+		{
+		nux = nu[nn]+nx[nn];
+		nu0 = nn==0 ? nux : nu[nn];
+		nu1 = nu[nn+1];
+		nx1 = nx[nn+1];
+		// Pb = P[nn+1] * b[nn]
+		blasfeo_dtrmv_ltn(nx1, &L[nn+1], nu1, nu1, &b[nn], 0, &Pb[nn], 0);
+		blasfeo_dtrmv_lnn(nx1, &L[nn+1], nu1, nu1, &Pb[nn], 0, &Pb[nn], 0);
+		blasfeo_daxpy(nx1, 1.0, &ux[nn+1], nu1, &Pb[nn], 0, tmp, 0);
+		blasfeo_dgemv_n(nux, nx1, 1.0, &BAbt[nn], 0, 0, tmp, 0, 1.0, &rq[nn], 0, &ux[nn], 0);
+		if(nu0>0)
+			blasfeo_dtrsv_lnn_mn(nux, nu0, &L[nn], 0, 0, &ux[nn], 0, &ux[nn], 0);
+		}
+
+	// forward substitution
+
+	for(nn=0; nn<N; nn++)
+		{
+		nux = nu[nn]+nx[nn];
+		nu0 = nn==0 ? nux : nu[nn];
+		nu1 = nu[nn+1];
+		nx1 = nx[nn+1];
+		blasfeo_dveccp(nx1, &ux[nn+1], nu1, &pi[nn], 0);
+		if(nu0>0)
+			{
+			blasfeo_dvecsc(nu0, -1.0, &ux[nn], 0);
+			blasfeo_dtrsv_ltn_mn(nux, nu0, &L[nn], 0, 0, &ux[nn], 0, &ux[nn], 0);
+			}
+		blasfeo_dgemv_t(nux, nx1, 1.0, &BAbt[nn], 0, 0, &ux[nn], 0, 1.0, &b[nn], 0, &ux[nn+1], nu1);
+		// pi = P[nn+1] * x[nn+1] + p[nn+1]
+		blasfeo_dtrmv_ltn(nx1, &L[nn+1], nu1, nu1, &ux[nn+1], nu1, tmp, 0);
+		blasfeo_dtrmv_lnn(nx1, &L[nn+1], nu1, nu1, tmp, 0, tmp, 0);
+		blasfeo_daxpy(nx1, 1.0, tmp, 0, &pi[nn], 0, &pi[nn], 0);
+		}
+
+	// last stage
+	nux = nu[N]+nx[N];
+	nu0 = N==0 ? nux : nu[N];
+	if(nu0>0)
+		{
+		blasfeo_dvecsc(nu0, -1.0, &ux[N], 0);
+		blasfeo_dtrsv_ltn_mn(nux, nu0, &L[N], 0, 0, &ux[N], 0, &ux[N], 0);
+		}
+
+	return;
+
+	}
+
+
+
+// forward substitution, for the factors with the vectors in the last row
+static void d_ric_sv_forward(int N, int *nx, int *nu, struct blasfeo_dmat *BAbt, struct blasfeo_dvec *ux, struct blasfeo_dvec *pi, struct blasfeo_dmat *L, struct blasfeo_dvec *tmp)
+	{
+
+	int nn, nux, nu0, nu1, nx1;
+
+	for(nn=0; nn<N; nn++)
+		{
+		nux = nu[nn]+nx[nn];
+		nu0 = nn==0 ? nux : nu[nn];
+		nu1 = nu[nn+1];
+		nx1 = nx[nn+1];
+		if(nu0>0)
+			{
+			blasfeo_drowex(nu0, -1.0, &L[nn], nux, 0, &ux[nn], 0);
+			blasfeo_dtrsv_ltn_mn(nux, nu0, &L[nn], 0, 0, &ux[nn], 0, &ux[nn], 0);
+			}
+		blasfeo_drowex(nx1, 1.0, &BAbt[nn], nux, 0, &ux[nn+1], nu1);
+		blasfeo_dgemv_t(nux, nx1, 1.0, &BAbt[nn], 0, 0, &ux[nn], 0, 1.0, &ux[nn+1], nu1, &ux[nn+1], nu1);
+		// pi = Lxx[nn+1] * ( Lxx[nn+1]^T * x[nn+1] + l[nn+1] )
+		blasfeo_drowex(nx1, 1.0, &L[nn+1], nu1+nx1, nu1, tmp, 0);
+		blasfeo_dtrmv_ltn(nx1, &L[nn+1], nu1, nu1, &ux[nn+1], nu1, &pi[nn], 0);
+		blasfeo_daxpy(nx1, 1.0, tmp, 0, &pi[nn], 0, &pi[nn], 0);
+		blasfeo_dtrmv_lnn(nx1, &L[nn+1], nu1, nu1, &pi[nn], 0, &pi[nn], 0);
+		}
+
+	// last stage
+	nux = nu[N]+nx[N];
+	nu0 = N==0 ? nux : nu[N];
+	if(nu0>0)
+		{
+		blasfeo_drowex(nu0, -1.0, &L[N], nux, 0, &ux[N], 0);
+		blasfeo_dtrsv_ltn_mn(nux, nu0, &L[N], 0, 0, &ux[N], 0, &ux[N], 0);
+		}
+
+	return;
+
+	}
+
+
+
+void blasfeo_driccati_sv(int N, int *nx, int *nu, struct blasfeo_dmat *BAbt, struct blasfeo_dmat *RSQrq, struct blasfeo_dvec *ux, struct blasfeo_dvec *pi, struct blasfeo_driccati_ws *ws)
+	{
+
+	struct blasfeo_dmat *L = ws->L;
+	struct blasfeo_dmat *AL = ws->AL;
+	struct blasfeo_dvec *tmp = ws->tmp;
+
+	int nn, nux, nu1, nx1;
+
+	// factorization and backward substitution: the vectors are carried in the last row of the factors
+
+	// last stage
+	nux = nu[N]+nx[N];
+	blasfeo_dpotrf_l_mn(nux+1, nux, &RSQrq[N], 0, 0, &L[N], 0, 0);
+
+	// middle stages
+	for(nn=N-1; nn>=0; nn--)
+		{
+		nux = nu[nn]+nx[nn];
+		nu1 = nu[nn+1];
+		nx1 = nx[nn+1];
+		blasfeo_dtrmm_rlnn(nux+1, nx1, 1.0, &L[nn+1], nu1, nu1, &BAbt[nn], 0, 0, AL, 0, 0);
+		blasfeo_dgead(1, nx1, 1.0, &L[nn+1], nu1+nx1, nu1, AL, nux, 0);
+		blasfeo_dsyrk_dpotrf_ln_mn(nux+1, nux, nx1, AL, 0, 0, AL, 0, 0, &RSQrq[nn], 0, 0, &L[nn], 0, 0);
+		}
+
+	// forward substitution
+	d_ric_sv_forward(N, nx, nu, BAbt, ux, pi, L, tmp);
+
+	return;
+
+	}
+
+
+
+/*
+* Tree Riccati recursion: a node depends on all its children in the backward recursion.
+* The leaves are handed out to the threads through a shared counter, and the number of children
+* still pending is kept for each node: the thread that completes the last child of a node goes
+* on with the node itself (that has its children data still in cache), so that the funnel nodes
+* are scheduled without any waiting, and the threads are busy as long as there are leaves left.
+*/
+
+
+
+#if defined(MULTITHREAD)
+static int d_ric_fetch_add(int *ptr, int val)
+	{
+	return __atomic_fetch_add(ptr, val, __ATOMIC_ACQ_REL);
+	}
+#else
+// the thread pool runs serially
+static int d_ric_fetch_add(int *ptr, int val)
+	{
+	int old = *ptr;
+	*ptr += val;
+	return old;
+	}
+#endif
+
+
+
+size_t blasfeo_memsize_driccati_tree_ws(int Nn, int *nx, int *nu)
+	{
+	int ii;
+	int nxm = 0;
+	for(ii=0; ii<Nn; ii++)
+		nxm = nx[ii]>nxm ? nx[ii] : nxm;
+	size_t size = 0;
+	size += Nn*sizeof(struct blasfeo_dmat); // L
+	size += (Nn+1)*sizeof(struct blasfeo_dvec); // Pb, tmp
+	size += (6*Nn+1)*sizeof(int); // parent, kids_idx, kids, order, leaves, pending
+	size = d_ric_align_64(size);
+	for(ii=0; ii<Nn; ii++)
+		size += d_ric_align_64(blasfeo_memsize_dmat(nu[ii]+nx[ii]+1, nu[ii]+nx[ii]));
+	for(ii=0; ii<Nn; ii++)
+		size += d_ric_align_64(blasfeo_memsize_dvec(nx[ii]));
+	size += d_ric_align_64(blasfeo_memsize_dvec(nxm));
+	size += 64; // align to cache line
+	return size;
+	}
+
+
+
+void blasfeo_create_driccati_tree_ws(int Nn, int *parent, int *nx, int *nu, struct blasfeo_driccati_tree_ws *ws, void *memory)
+	{
+	int ii, jj, kk, nn;
+
+	ws->Nn = Nn;
+	ws->memsize = blasfeo_memsize_driccati_tree_ws(Nn, nx, nu);
+
+	// structures
+	char *c_ptr = memory;
+	ws->L = (struct blasfeo_dmat *) c_ptr;
+	c_ptr += Nn*sizeof(struct blasfeo_dmat);
+	ws->Pb = (struct blasfeo_dvec *) c_ptr;
+	c_ptr += Nn*sizeof(struct blasfeo_dvec);
+	ws->tmp = (struct blasfeo_dvec *) c_ptr;
+	c_ptr += sizeof(struct blasfeo_dvec);
+	ws->parent = (int *) c_ptr;
+	c_ptr += Nn*sizeof(int);
+	ws->kids_idx = (int *) c_ptr;
+	c_ptr += (Nn+1)*sizeof(int);
+	ws->kids = (int *) c_ptr;
+	c_ptr += Nn*sizeof(int);
+	ws->order = (int *) c_ptr;
+	c_ptr += Nn*sizeof(int);
+	ws->leaves = (int *) c_ptr;
+	c_ptr += Nn*sizeof(int);
+	ws->pending = (int *) c_ptr;
+	c_ptr += Nn*sizeof(int);
+
+	// tree structure
+	ws->root = -1;
+	ws->nuxm = 0;
+	ws->nxm = 0;
+	for(ii=0; ii<Nn; ii++)
+		{
+		ws->parent[ii] = parent[ii];
+		if(parent[ii]<0)
+			ws->root = ii;
+		ws->nuxm = nu[ii]+nx[ii]>ws->nuxm ? nu[ii]+nx[ii] : ws->nuxm;
+		ws->nxm = nx[ii]>ws->nxm ? nx[ii] : ws->nxm;
+		}
+	// children, in compressed form (pending is used as counter)
+	for(ii=0; ii<=Nn; ii++)
+		ws->kids_idx[ii] = 0;
+	for(ii=0; ii<Nn; ii++)
+		if(parent[ii]>=0)
+			ws->kids_idx[parent[ii]+1]++;
+	for(ii=0; ii<Nn; ii++)
+		{
+		ws->kids_idx[ii+1] += ws->kids_idx[ii];
+		ws->pending[ii] = 0;
+		}
+	for(ii=0; ii<Nn; ii++)
+		{
+		if(parent[ii]>=0)
+			{
+			ws->kids[ws->kids_idx[parent[ii]]+ws->pending[parent[ii]]] = ii;
+			ws->pending[parent[ii]]++;
+			}
+		}
+	// breadth-first order
+	nn = 0;
+	if(ws->root>=0)
+		ws->order[nn++] = ws->root;
+	for(ii=0; ii<nn; ii++)
+		{
+		kk = ws->order[ii];
+		for(jj=ws->kids_idx[kk]; jj<ws->kids_idx[kk+1]; jj++)
+			ws->order[nn++] = ws->kids[jj];
+		}
+	// leaves, the deepest first: they are the last in breadth-first order
+	ws->nleaves = 0;
+	for(ii=nn-1; ii>=0; ii--)
+		{
+		kk = ws->order[ii];
+		if(ws->kids_idx[kk+1]==ws->kids_idx[kk])
+			ws->leaves[ws->nleaves++] = kk;
+		}
+
+	// matrices and vectors
+	blasfeo_align_64_byte(c_ptr, (void **) &c_ptr);
+	for(ii=0; ii<Nn; ii++)
+		{
+		blasfeo_create_dmat(nu[ii]+nx[ii]+1, nu[ii]+nx[ii], ws->L+ii, c_ptr);
+		c_ptr += d_ric_align_64(ws->L[ii].memsize);
+		}
+	for(ii=0; ii<Nn; ii++)
+		{
+		blasfeo_create_dvec(nx[ii], ws->Pb+ii, c_ptr);
+		c_ptr += d_ric_align_64(ws->Pb[ii].memsize);
+		}
+	blasfeo_create_dvec(ws->nxm, ws->tmp, c_ptr);
+	c_ptr += d_ric_align_64(ws->tmp->memsize);
+
+	return;
+	}
+
+
+
+struct d_ric_tree_arg
+	{
+	void (*fun)(int, struct d_ric_tree_arg *, struct blasfeo_dmat *);
+	int *nx;
+	int *nu;
+	struct blasfeo_dmat *BAbt;
+	struct blasfeo_dmat *RSQrq;
+	struct blasfeo_dvec *b;
+	struct blasfeo_dvec *rq;
+	struct blasfeo_dvec *ux;
+	struct blasfeo_driccati_tree_ws *ws;
+	int use_work; // the node routine needs the work matrix
+	};
+
+
+
+static void d_ric_tree_work(int tid, int nt, void *ptr)
+	{
+	struct d_ric_tree_arg *arg = ptr;
+	struct blasfeo_driccati_tree_ws *ws = arg->ws;
+
+	int idx, node, parent;
+
+	// private work matrix
+	struct blasfeo_dmat AL;
+	void *mem = NULL;
+	void *mem_align;
+	if(arg->use_work)
+		{
+		blasfeo_ws_malloc(&mem, blasfeo_memsize_dmat(ws->nuxm+1, ws->nxm)+64);
+		if(mem==NULL)
+			return;
+		blasfeo_align_64_byte(mem, &mem_align);
+		blasfeo_create_dmat(ws->nuxm+1, ws->nxm, &AL, mem_align);
+		}
+
+	while((idx=d_ric_fetch_add(&ws->next_leaf, 1))<ws->nleaves)
+		{
+		node = ws->leaves[idx];
+		while(1)
+			{
+			arg->fun(node, arg, &AL);
+			parent = ws->parent[node];
+			// only the last child to complete goes on with the parent
+			if(parent<0 || d_ric_fetch_add(&ws->pending[parent], -1)!=1)
+				break;
+			node = parent;
+			}
+		}
+
+	if(arg->use_work)
+		blasfeo_ws_free(mem);
+	return;
+	}
+
+
+
+// process all nodes from the leaves to the root
+static void d_ric_tree_run(struct d_ric_tree_arg *arg)
+	{
+	struct blasfeo_driccati_tree_ws *ws = arg->ws;
+	int ii;
+	for(ii=0; ii<ws->Nn; ii++)
+		ws->pending[ii] = ws->kids_idx[ii+1]-ws->kids_idx[ii];
+	ws->next_leaf = 0;
+	int nt = blasfeo_get_num_threads();
+	nt = nt<ws->nleaves ? nt : ws->nleaves;
+	if(nt>1 && !blasfeo_thread_pool_in_parallel())
+		blasfeo_thread_pool_run(nt, d_ric_tree_work, arg);
+	else
+		d_ric_tree_work(0, 1, arg);
+	return;
+	}
+
+
+
+// L[node] = chol( RSQ[node] + sum_kids BA[kid] * P[kid] * BA[kid]^T )
+static void d_ric_tree_trf_node(int node, struct d_ric_tree_arg *arg, struct blasfeo_dmat *AL)
+	{
+	struct blasfeo_driccati_tree_ws *ws = arg->ws;
+	int *nx = arg->nx;
+	int *nu = arg->nu;
+	struct blasfeo_dmat *L = ws->L;
+	struct blasfeo_dmat *BAbt = arg->BAbt;
+	struct blasfeo_dmat *C = arg->RSQrq+node;
+
+	int jj, kid;
+	int nux = nu[node]+nx[node];
+	int jj0 = ws->kids_idx[node];
+	int jj1 = ws->kids_idx[node+1];
+
+	if(jj1==jj0)
+		{
+		blasfeo_dpotrf_l(nux, C, 0, 0, &L[node], 0, 0);
+		return;
+		}
+	// accumulate all kids but the last
+	for(jj=jj0; jj<jj1-1; jj++)
+		{
+		kid = ws->kids[jj];
+		blasfeo_dtrmm_rlnn(nux, nx[kid], 1.0, &L[kid], nu[kid], nu[kid], &BAbt[kid], 0, 0, AL, 0, 0);
+		blasfeo_dsyrk_ln(nux, nx[kid], 1.0, AL, 0, 0, AL, 0, 0, 1.0, C, 0, 0, &L[node], 0, 0);
+		C = &L[node];
+		}
+	// last kid, fused with the factorization
+	kid = ws->kids[jj1-1];
+	blasfeo_dtrmm_rlnn(nux, nx[kid], 1.0, &L[kid], nu[kid], nu[kid], &BAbt[kid], 0, 0, AL, 0, 0);
+	blasfeo_dsyrk_dpotrf_ln(nux, nx[kid], AL, 0, 0, AL, 0, 0, C, 0, 0, &L[node], 0, 0);
+	return;
+	}
+
+
+
+// backward substitution: ux[node] = L[node]^{-1} ( rq[node] + sum_kids BA[kid] * ( P[kid] * b[kid] + p[kid] ) )
+static void d_ric_tree_trs_node(int node, struct d_ric_tree_arg *arg, struct blasfeo_dmat *AL)
+	{
+	struct blasfeo_driccati_tree_ws *ws = arg->ws;
+	int *nx = arg->nx;
+	int *nu = arg->nu;
+	struct blasfeo_dmat *L = ws->L;
+	struct blasfeo_dvec *Pb = ws->Pb;
+	struct blasfeo_dmat *BAbt = arg->BAbt;
+	struct blasfeo_dvec *b = arg->b;
+	struct blasfeo_dvec *ux = arg->ux;
+
+	int jj, kid;
+	int nux = nu[node]+nx[node];
+	int nu0 = node==ws->root ? nux : nu[node];
+
+	blasfeo_dveccp(nux, &arg->rq[node], 0, &ux[node], 0);
+	for(jj=ws->kids_idx[node]; jj<ws->kids_idx[node+1]; jj++)
+		{
+		kid = ws->kids[jj];
+		blasfeo_dtrmv_ltn(nx[kid], &L[kid], nu[kid], nu[kid], &b[kid], 0, &Pb[kid], 0);
+		blasfeo_dtrmv_lnn(nx[kid], &L[kid], nu[kid], nu[kid], &Pb[kid], 0, &Pb[kid], 0);
+		blasfeo_daxpy(nx[kid], 1.0, &ux[kid], nu[kid], &Pb[kid], 0, &Pb[kid], 0);
+		blasfeo_dgemv_n(nux, nx[kid], 1.0, &BAbt[kid], 0, 0, &Pb[kid], 0, 1.0, &ux[node], 0, &ux[node], 0);
+		}
+	if(nu0>0)
+		blasfeo_dtrsv_lnn_mn(nux, nu0, &L[node], 0, 0, &ux[node], 0, &ux[node], 0);
+	return;
+	}
+
+
+
+void blasfeo_driccati_tree_trf(int Nn, int *nx, int *nu, struct blasfeo_dmat *BAbt, struct blasfeo_dmat *RSQrq, struct blasfeo_driccati_tree_ws *ws)
+	{
+	if(Nn<=0)
+		return;
+	struct d_ric_tree_arg arg;
+	arg.fun = d_ric_tree_trf_node;
+	arg.nx = nx;
+	arg.nu = nu;
+	arg.BAbt = BAbt;
+	arg.RSQrq = RSQrq;
+	arg.ws = ws;
+	arg.use_work = 1;
+	d_ric_tree_run(&arg);
+	return;
+	}
+
+
+
+void blasfeo_driccati_tree_trs(int Nn, int *nx, int *nu, struct blasfeo_dmat *BAbt, struct blasfeo_dvec *b, struct blasfeo_dvec *rq, struct blasfeo_dvec *ux, struct blasfeo_dvec *pi, struct blasfeo_driccati_tree_ws *ws)
+	{
+	if(Nn<=0)
+		return;
+
+	struct blasfeo_dmat *L = ws->L;
+	struct blasfeo_dvec *tmp = ws->tmp;
+
+	int ii, node, p, nux, nu0;
+
+	// backward substitution
+	struct d_ric_tree_arg arg;
+	arg.fun = d_ric_tree_trs_node;
+	arg.nx = nx;
+	arg.nu = nu;
+	arg.BAbt = BAbt;
+	arg.b = b;
+	arg.rq = rq;
+	arg.ux = ux;
+	arg.ws = ws;
+	arg.use_work = 0;
+	d_ric_tree_run(&arg);
+
+	// forward substitution, each node after its parent
+	for(ii=0; ii<Nn; ii++)
+		{
+		node = ws->order[ii];
+		p = ws->parent[node];
+		nux = nu[node]+nx[node];
+		nu0 = p<0 ? nux : nu[node];
+		if(p>=0)
+			{
+			// pi = P[node] * x[node] + p[node]
+			blasfeo_dveccp(nx[node], &ux[node], nu[node], &pi[node], 0);
+			blasfeo_dgemv_t(nu[p]+nx[p], nx[node], 1.0, &BAbt[node], 0, 0, &ux[p], 0, 1.0, &b[node], 0, &ux[node], nu[node]);
+			blasfeo_dtrmv_ltn(nx[node], &L[node], nu[node], nu[node], &ux[node], nu[node], tmp, 0);
+			blasfeo_dtrmv_lnn(nx[node], &L[node], nu[node], nu[node], tmp, 0, tmp, 0);
+			blasfeo_daxpy(nx[node], 1.0, tmp, 0, &pi[node], 0, &pi[node], 0);
+			}
+		if(nu0>0)
+			{
+			blasfeo_dvecsc(nu0, -1.0, &ux[node], 0);
+			blasfeo_dtrsv_ltn_mn(nux, nu0, &L[node], 0, 0, &ux[node], 0, &ux[node], 0);
+			}
+		}
+
+	return;
+	}
+
+
+
+/*
+* Parallel-in-time Riccati recursion: the element of stage n is the conditional cost-to-go from x_n to y=x_{n+1}
+*   V(x, y) = max_l  1/2 x^T J x + p^T x - 1/2 l^T C l + l^T ( y - A x - b )
+* stored as At=[A^T; b^T], C (full) and Jp=[J; p^T] (J full). Eliminating the state in between, the element
+* from stage i to j and the one from stage j to k give the element from stage i to k
+*   A = A2 (I + C1 J2)^{-1} A1
+*   b = A2 (I + C1 J2)^{-1} (b1 - C1 p2) + b2
+*   C = A2 (I + C1 J2)^{-1} C1 A2^T + C2
+*   J = A1^T J2 (I + C1 J2)^{-1} A1 + J1
+*   p = A1^T (I + J2 C1)^{-1} (p2 + J2 b1) + p1
+* where, with J2 = Lj Lj^T and I + Lj^T C1 Lj = Ln Ln^T, it is J2 (I + C1 J2)^{-1} = W W^T for W = Lj Ln^{-T},
+* and (I + C1 J2)^{-1} = I - C1 W W^T: only Cholesky factorizations of positive definite matrices are needed.
+*/
+
+
+
+// per-thread work matrices
+struct d_ric_pint_work
+	{
+	struct blasfeo_dmat Lj;
+	struct blasfeo_dmat M;
+	struct blasfeo_dmat Ln;
+	struct blasfeo_dmat W;
+	struct blasfeo_dmat A2;
+	struct blasfeo_dmat Yt;
+	struct blasfeo_dmat T1;
+	struct blasfeo_dmat R;
+	struct blasfeo_dmat Lr;
+	struct blasfeo_dmat U;
+	struct blasfeo_dmat AL;
+	void *mem;
+	};
+
+
+
+// return 0 if the work memory can not be allocated
+static int d_ric_pint_work_create(struct blasfeo_driccati_pint_ws *ws, struct d_ric_pint_work *work)
+	{
+	int nxm = ws->nxm;
+	int nuxm = ws->nuxm;
+	int num = ws->num;
+	size_t size = 64;
+	size += 5*d_ric_align_64(blasfeo_memsize_dmat(nxm, nxm)); // Lj, M, Ln, W, A2
+	size += 2*d_ric_align_64(blasfeo_memsize_dmat(nxm+1, nxm)); // Yt, T1
+	size += d_ric_align_64(blasfeo_memsize_dmat(2, nxm)); // R
+	size += d_ric_align_64(blasfeo_memsize_dmat(nuxm+1, num)); // Lr
+	size += d_ric_align_64(blasfeo_memsize_dmat(nxm, num)); // U
+	size += d_ric_align_64(blasfeo_memsize_dmat(nuxm+1, nxm)); // AL
+	blasfeo_ws_malloc(&work->mem, size);
+	if(work->mem==NULL)
+		return 0;
+	// zero also the padding of the panels, where the repeated in-place updates could otherwise produce denormals
+	blasfeo_zero_memset(size, work->mem);
+	char *c_ptr;
+	blasfeo_align_64_byte(work->mem, (void **) &c_ptr);
+	blasfeo_create_dmat(nxm, nxm, &work->Lj, c_ptr);
+	c_ptr += d_ric_align_64(work->Lj.memsize);
+	blasfeo_create_dmat(nxm, nxm, &work->M, c_ptr);
+	c_ptr += d_ric_align_64(work->M.memsize);
+	blasfeo_create_dmat(nxm, nxm, &work->Ln, c_ptr);
+	c_ptr += d_ric_align_64(work->Ln.memsize);
+	blasfeo_create_dmat(nxm, nxm, &work->W, c_ptr);
+	c_ptr += d_ric_align_64(work->W.memsize);
+	blasfeo_create_dmat(nxm, nxm, &work->A2, c_ptr);
+	c_ptr += d_ric_align_64(work->A2.memsize);
+	blasfeo_create_dmat(nxm+1, nxm, &work->Yt, c_ptr);
+	c_ptr += d_ric_align_64(work->Yt.memsize);
+	blasfeo_create_dmat(nxm+1, nxm, &work->T1, c_ptr);
+	c_ptr += d_ric_align_64(work->T1.memsize);
+	blasfeo_create_dmat(2, nxm, &work->R, c_ptr);
+	c_ptr += d_ric_align_64(work->R.memsize);
+	blasfeo_create_dmat(nuxm+1, num, &work->Lr, c_ptr);
+	c_ptr += d_ric_align_64(work->Lr.memsize);
+	blasfeo_create_dmat(nxm, num, &work->U, c_ptr);
+	c_ptr += d_ric_align_64(work->U.memsize);
+	blasfeo_create_dmat(nuxm+1, nxm, &work->AL, c_ptr);
+	c_ptr += d_ric_align_64(work->AL.memsize);
+	return 1;
+	}
+
+
+
+size_t blasfeo_memsize_driccati_pint_ws(int N, int *nx, int *nu)
+	{
+	int nn;
+	int nxm = 0;
+	for(nn=0; nn<=N; nn++)
+		nxm = nx[nn]>nxm ? nx[nn] : nxm;
+	size_t size = 0;
+	size += 4*(N+1)*sizeof(struct blasfeo_dmat); // L, At, C, Jp
+	size += sizeof(struct blasfeo_dvec); // tmp
+	size += (N+1)*sizeof(int); // nx1
+	size = d_ric_align_64(size);
+	for(nn=0; nn<=N; nn++)
+		{
+		size += d_ric_align_64(blasfeo_memsize_dmat(nu[nn]+nx[nn]+1, nu[nn]+nx[nn]));
+		size += d_ric_align_64(blasfeo_memsize_dmat(nx[nn]+1, nxm));
+		size += d_ric_align_64(blasfeo_memsize_dmat(nxm, nxm));
+		size += d_ric_align_64(blasfeo_memsize_dmat(nx[nn]+1, nx[nn]));
+		}
+	size += d_ric_align_64(blasfeo_memsize_dvec(nxm));
+	size += 64; // align to cache line
+	return size;
+	}
+
+
+
+void blasfeo_create_driccati_pint_ws(int N, int *nx, int *nu, struct blasfeo_driccati_pint_ws *ws, void *memory)
+	{
+	int nn;
+
+	ws->N = N;
+	ws->memsize = blasfeo_memsize_driccati_pint_ws(N, nx, nu);
+	ws->nuxm = 0;
+	ws->nxm = 0;
+	ws->num = 0;
+	for(nn=0; nn<=N; nn++)
+		{
+		ws->nuxm = nu[nn]+nx[nn]>ws->nuxm ? nu[nn]+nx[nn] : ws->nuxm;
+		ws->nxm = nx[nn]>ws->nxm ? nx[nn] : ws->nxm;
+		ws->num = nu[nn]>ws->num ? nu[nn] : ws->num;
+		}
+
+	// structures
+	char *c_ptr = memory;
+	ws->L = (struct blasfeo_dmat *) c_ptr;
+	c_ptr += (N+1)*sizeof(struct blasfeo_dmat);
+	ws->At = (struct blasfeo_dmat *) c_ptr;
+	c_ptr += (N+1)*sizeof(struct blasfeo_dmat);
+	ws->C = (struct blasfeo_dmat *) c_ptr;
+	c_ptr += (N+1)*sizeof(struct blasfeo_dmat);
+	ws->Jp = (struct blasfeo_dmat *) c_ptr;
+	c_ptr += (N+1)*sizeof(struct blasfeo_dmat);
+	ws->tmp = (struct blasfeo_dvec *) c_ptr;
+	c_ptr += sizeof(struct blasfeo_dvec);
+	ws->nx1 = (int *) c_ptr;
+	c_ptr += (N+1)*sizeof(int);
+
+	// matrices and vectors, the data of each stage together
+	blasfeo_align_64_byte(c_ptr, (void **) &c_ptr);
+	for(nn=0; nn<=N; nn++)
+		{
+		blasfeo_create_dmat(nu[nn]+nx[nn]+1, nu[nn]+nx[nn], ws->L+nn, c_ptr);
+		c_ptr += d_ric_align_64(ws->L[nn].memsize);
+		blasfeo_create_dmat(nx[nn]+1, ws->nxm, ws->At+nn, c_ptr);
+		c_ptr += d_ric_align_64(ws->At[nn].memsize);
+		blasfeo_create_dmat(ws->nxm, ws->nxm, ws->C+nn, c_ptr);
+		c_ptr += d_ric_align_64(ws->C[nn].memsize);
+		blasfeo_create_dmat(nx[nn]+1, nx[nn], ws->Jp+nn, c_ptr);
+		c_ptr += d_ric_align_64(ws->Jp[nn].memsize);
+		}
+	blasfeo_create_dvec(ws->nxm, ws->tmp, c_ptr);
+	c_ptr += d_ric_align_64(ws->tmp->memsize);
+
+	return;
+	}
+
+
+
+// element of stage nn, eliminating the inputs u = -R^{-1} ( S x + r + B^T l )
+static void d_ric_pint_stage(int nn, int *nx, int *nu, struct blasfeo_dmat *BAbt, struct blasfeo_dmat *RSQrq, struct blasfeo_driccati_pint_ws *ws, struct d_ric_pint_work *work)
+	{
+	struct blasfeo_dmat *At = ws->At+nn;
+	struct blasfeo_dmat *C = ws->C+nn;
+	struct blasfeo_dmat *Jp = ws->Jp+nn;
+	struct blasfeo_dmat *Lr = &work->Lr;
+	struct blasfeo_dmat *U = &work->U;
+
+	int nu0 = nu[nn];
+	int nx0 = nx[nn];
+	int nx1 = nn<ws->N ? nx[nn+1] : 0;
+	ws->nx1[nn] = nx1;
+
+	if(nu0>0)
+		{
+		// [Lr; Ls; lr^T] = [R; S^T; r^T] * Lr^{-T} , with R = Lr Lr^T
+		blasfeo_dpotrf_l_mn(nu0+nx0+1, nu0, &RSQrq[nn], 0, 0, Lr, 0, 0);
+		// [J; p^T] = [Q; q^T] - [Ls; lr^T] * Ls^T
+		blasfeo_dsyrk_ln_mn(nx0+1, nx0, nu0, -1.0, Lr, nu0, 0, Lr, nu0, 0, 1.0, &RSQrq[nn], nu0, nu0, Jp, 0, 0);
+		if(nx1>0)
+			{
+			// U = B * Lr^{-T} , C = U * U^T
+			blasfeo_dgetr(nu0, nx1, &BAbt[nn], 0, 0, U, 0, 0);
+			blasfeo_dtrsm_rltn(nx1, nu0, 1.0, Lr, 0, 0, U, 0, 0, U, 0, 0);
+			blasfeo_dgese(nx1, nx1, 0.0, C, 0, 0);
+			blasfeo_dsyrk_ln(nx1, nu0, 1.0, U, 0, 0, U, 0, 0, 0.0, C, 0, 0, C, 0, 0);
+			blasfeo_dtrtr_l(nx1, C, 0, 0, C, 0, 0);
+			// [A^T; b^T] = [A^T; b^T] - [Ls; lr^T] * U^T
+			blasfeo_dgemm_nt(nx0+1, nx1, nu0, -1.0, Lr, nu0, 0, U, 0, 0, 1.0, &BAbt[nn], nu0, 0, At, 0, 0);
+			}
+		}
+	else
+		{
+		blasfeo_dgecp(nx0+1, nx0, &RSQrq[nn], 0, 0, Jp, 0, 0);
+		if(nx1>0)
+			{
+			blasfeo_dgese(nx1, nx1, 0.0, C, 0, 0);
+			blasfeo_dgecp(nx0+1, nx1, &BAbt[nn], 0, 0, At, 0, 0);
+			}
+		}
+	blasfeo_dtrtr_l(nx0, Jp, 0, 0, Jp, 0, 0);
+
+	return;
+	}
+
+
+
+// element ii <= element ii combined with element jj, that starts where element ii ends
+static void d_ric_pint_combine(int ii, int jj, int *nx, struct blasfeo_driccati_pint_ws *ws, struct d_ric_pint_work *work)
+	{
+	struct blasfeo_dmat *At1 = ws->At+ii;
+	struct blasfeo_dmat *C1 = ws->C+ii;
+	struct blasfeo_dmat *Jp1 = ws->Jp+ii;
+	struct blasfeo_dmat *At2 = ws->At+jj;
+	struct blasfeo_dmat *C2 = ws->C+jj;
+	struct blasfeo_dmat *Jp2 = ws->Jp+jj;
+	struct blasfeo_dmat *Lj = &work->Lj;
+	struct blasfeo_dmat *M = &work->M;
+	struct blasfeo_dmat *Ln = &work->Ln;
+	struct blasfeo_dmat *W = &work->W;
+	struct blasfeo_dmat *A2 = &work->A2;
+	struct blasfeo_dmat *Yt = &work->Yt;
+	struct blasfeo_dmat *T1 = &work->T1;
+	struct blasfeo_dmat *R = &work->R;
+
+	int n0 = nx[ii];
+	int nj = nx[jj];
+	int n2 = ws->nx1[jj];
+	ws->nx1[ii] = n2;
+
+	if(nj==0)
+		{
+		// no state in between: A = 0 , b = b2 , C = C2
+		if(n2>0)
+			{
+			blasfeo_dgese(n0, n2, 0.0, At1, 0, 0);
+			blasfeo_dgecp(1, n2, At2, 0, 0, At1, n0, 0);
+			blasfeo_dgecp(n2, n2, C2, 0, 0, C1, 0, 0);
+			}
+		return;
+		}
+
+	// J2 = Lj * Lj^T , with the upper part of Lj set to zero
+	blasfeo_dgese(nj, nj, 0.0, Lj, 0, 0);
+	blasfeo_dpotrf_l(nj, Jp2, 0, 0, Lj, 0, 0);
+	// I + Lj^T * C1 * Lj = Ln * Ln^T
+	blasfeo_dgemm_nn(nj, nj, nj, 1.0, C1, 0, 0, Lj, 0, 0, 0.0, M, 0, 0, M, 0, 0);
+	blasfeo_dgese(nj, nj, 0.0, Ln, 0, 0);
+	blasfeo_ddiare(nj, 1.0, Ln, 0, 0);
+	blasfeo_dgemm_tn(nj, nj, nj, 1.0, Lj, 0, 0, M, 0, 0, 1.0, Ln, 0, 0, Ln, 0, 0);
+	blasfeo_dpotrf_l(nj, Ln, 0, 0, Ln, 0, 0);
+	// W = Lj * Ln^{-T} , G = C1 * W (in M)
+	blasfeo_dtrsm_rltn(nj, nj, 1.0, Ln, 0, 0, Lj, 0, 0, W, 0, 0);
+	blasfeo_dgemm_nn(nj, nj, nj, 1.0, C1, 0, 0, W, 0, 0, 0.0, M, 0, 0, M, 0, 0);
+
+	// Yt = [A1^T; b1^T - p2^T * C1] , T1 = Yt * W
+	blasfeo_dgecp(n0+1, nj, At1, 0, 0, Yt, 0, 0);
+	blasfeo_dgemm_nn(1, nj, nj, -1.0, Jp2, nj, 0, C1, 0, 0, 1.0, Yt, n0, 0, Yt, n0, 0);
+	blasfeo_dgemm_nn(n0+1, nj, nj, 1.0, Yt, 0, 0, W, 0, 0, 0.0, T1, 0, 0, T1, 0, 0);
+	// Yt <= Yt * (I + C1 * J2)^{-T} = Yt - T1 * G^T
+	if(n2>0)
+		blasfeo_dgemm_nt(n0+1, nj, nj, -1.0, T1, 0, 0, M, 0, 0, 1.0, Yt, 0, 0, Yt, 0, 0);
+	// g^T = p2^T * G , q^T = p2^T - g^T * W^T , in the rows of R
+	blasfeo_dgemm_nn(1, nj, nj, 1.0, Jp2, nj, 0, M, 0, 0, 0.0, R, 0, 0, R, 0, 0);
+	blasfeo_dgecp(1, nj, Jp2, nj, 0, R, 1, 0);
+	blasfeo_dgemm_nt(1, nj, nj, -1.0, R, 0, 0, W, 0, 0, 1.0, R, 1, 0, R, 1, 0);
+	// T1 <= [A1^T; b1^T] * W
+	blasfeo_dgead(1, nj, 1.0, R, 0, 0, T1, n0, 0);
+	// [J; p^T] = [J1; p1^T] + T1 * (A1^T * W)^T + [0; q^T * A1]
+	blasfeo_dsyrk_ln_mn(n0+1, n0, nj, 1.0, T1, 0, 0, T1, 0, 0, 1.0, Jp1, 0, 0, Jp1, 0, 0);
+	blasfeo_dgemm_nt(1, n0, nj, 1.0, R, 1, 0, At1, 0, 0, 1.0, Jp1, n0, 0, Jp1, n0, 0);
+	blasfeo_dtrtr_l(n0, Jp1, 0, 0, Jp1, 0, 0);
+
+	if(n2>0)
+		{
+		blasfeo_dgetr(nj, n2, At2, 0, 0, A2, 0, 0);
+		// H = (I + C1 * J2)^{-1} * C1 = C1 - G * G^T (in Lj)
+		blasfeo_dsyrk_ln(nj, nj, -1.0, M, 0, 0, M, 0, 0, 1.0, C1, 0, 0, Lj, 0, 0);
+		blasfeo_dtrtr_l(nj, Lj, 0, 0, Lj, 0, 0);
+		// C = A2 * H * A2^T + C2
+		blasfeo_dgemm_nn(n2, nj, nj, 1.0, A2, 0, 0, Lj, 0, 0, 0.0, Ln, 0, 0, Ln, 0, 0);
+		blasfeo_dsyrk_ln(n2, nj, 1.0, Ln, 0, 0, A2, 0, 0, 1.0, C2, 0, 0, C1, 0, 0);
+		blasfeo_dtrtr_l(n2, C1, 0, 0, C1, 0, 0);
+		// [A^T; b^T] = Yt * A2^T + [0; b2^T]
+		blasfeo_dgemm_nt(n0+1, n2, nj, 1.0, Yt, 0, 0, A2, 0, 0, 0.0, At1, 0, 0, At1, 0, 0);
+		blasfeo_dgead(1, n2, 1.0, At2, nj, 0, At1, n0, 0);
+		}
+
+	return;
+	}
+
+
+
+// factor of stage nn, from the cost-to-go of stage nn+1 (in the form of blasfeo_driccati_sv)
+static void d_ric_pint_factor(int nn, int *nx, int *nu, struct blasfeo_dmat *BAbt, struct blasfeo_dmat *RSQrq, struct blasfeo_driccati_pint_ws *ws, struct d_ric_pint_work *work)
+	{
+	struct blasfeo_dmat *L = ws->L;
+	struct blasfeo_dmat *AL = &work->AL;
+	struct blasfeo_dmat *Lp = &work->Yt;
+
+	int nux = nu[nn]+nx[nn];
+
+	if(nn==ws->N)
+		{
+		blasfeo_dpotrf_l_mn(nux+1, nux, &RSQrq[nn], 0, 0, &L[nn], 0, 0);
+		return;
+		}
+	int nx1 = nx[nn+1];
+	// [Lp; l^T] = [J; p^T] * Lp^{-T} , with J = Lp * Lp^T
+	blasfeo_dpotrf_l_mn(nx1+1, nx1, &ws->Jp[nn+1], 0, 0, Lp, 0, 0);
+	blasfeo_dtrmm_rlnn(nux+1, nx1, 1.0, Lp, 0, 0, &BAbt[nn], 0, 0, AL, 0, 0);
+	blasfeo_dgead(1, nx1, 1.0, Lp, nx1, 0, AL, nux, 0);
+	blasfeo_dsyrk_dpotrf_ln_mn(nux+1, nux, nx1, AL, 0, 0, AL, 0, 0, &RSQrq[nn], 0, 0, &L[nn], 0, 0);
+	return;
+	}
+
+
+
+struct d_ric_pint_arg
+	{
+	int *nx;
+	int *nu;
+	struct blasfeo_dmat *BAbt;
+	struct blasfeo_dmat *RSQrq;
+	struct blasfeo_driccati_pint_ws *ws;
+	int nt; // number of chunks
+	};
+
+
+
+// first stage of chunk ii
+static int d_ric_pint_chunk(int ii, struct d_ric_pint_arg *arg)
+	{
+	return (int) ((long long) ii*(arg->ws->N+1)/arg->nt);
+	}
+
+
+
+// elements of the chunk, and scan inside the chunk
+static void d_ric_pint_work_scan(int tid, int nt, void *ptr)
+	{
+	struct d_ric_pint_arg *arg = ptr;
+	struct d_ric_pint_work work;
+	int nn;
+	int n0 = d_ric_pint_chunk(tid, arg);
+	int n1 = d_ric_pint_chunk(tid+1, arg);
+	if(!d_ric_pint_work_create(arg->ws, &work))
+		return;
+	for(nn=n1-1; nn>=n0; nn--)
+		{
+		d_ric_pint_stage(nn, arg->nx, arg->nu, arg->BAbt, arg->RSQrq, arg->ws, &work);
+		if(nn<n1-1)
+			d_ric_pint_combine(nn, nn+1, arg->nx, arg->ws, &work);
+		}
+	blasfeo_ws_free(work.mem);
+	return;
+	}
+
+
+
+// propagate the cost-to-go at the start of the next chunk into the chunk, and compute the factors
+static void d_ric_pint_work_factor(int tid, int nt, void *ptr)
+	{
+	struct d_ric_pint_arg *arg = ptr;
+	struct d_ric_pint_work work;
+	int nn;
+	int n0 = d_ric_pint_chunk(tid, arg);
+	int n1 = d_ric_pint_chunk(tid+1, arg);
+	if(!d_ric_pint_work_create(arg->ws, &work))
+		return;
+	if(tid<nt-1)
+		{
+		for(nn=n1-1; nn>n0; nn--)
+			d_ric_pint_combine(nn, n1, arg->nx, arg->ws, &work);
+		}
+	for(nn=n1-1; nn>=n0; nn--)
+		d_ric_pint_factor(nn, arg->nx, arg->nu, arg->BAbt, arg->RSQrq, arg->ws, &work);
+	blasfeo_ws_free(work.mem);
+	return;
+	}
+
+
+
+void blasfeo_driccati_pint_sv(int N, int *nx, int *nu, struct blasfeo_dmat *BAbt, struct blasfeo_dmat *RSQrq, struct blasfeo_dvec *ux, struct blasfeo_dvec *pi, struct blasfeo_driccati_pint_ws *ws)
+	{
+
+	int ii;
+
+	struct d_ric_pint_arg arg;
+	arg.nx = nx;
+	arg.nu = nu;
+	arg.BAbt = BAbt;
+	arg.RSQrq = RSQrq;
+	arg.ws = ws;
+
+	// one chunk of at least two stages per thread
+	int nt = blasfeo_get_num_threads();
+	nt = nt<(N+1)/2 ? nt : (N+1)/2;
+	nt = nt>1 && !blasfeo_thread_pool_in_parallel() ? nt : 1;
+	arg.nt = nt;
+
+	// scan inside each chunk
+	if(nt>1)
+		blasfeo_thread_pool_run(nt, d_ric_pint_work_scan, &arg);
+	else
+		d_ric_pint_work_scan(0, 1, &arg);
+
+	// scan of the chunk results, from the last chunk
+	if(nt>1)
+		{
+		struct d_ric_pint_work work;
+		if(!d_ric_pint_work_create(ws, &work))
+			return;
+		for(ii=nt-2; ii>=0; ii--)
+			d_ric_pint_combine(d_ric_pint_chunk(ii, &arg), d_ric_pint_chunk(ii+1, &arg), nx, ws, &work);
+		blasfeo_ws_free(work.mem);
+		}
+
+	// cost-to-go inside each chunk, and factorization
+	if(nt>1)
+		blasfeo_thread_pool_run(nt, d_ric_pint_work_factor, &arg);
+	else
+		d_ric_pint_work_factor(0, 1, &arg);
+
+	// forward substitution
+	d_ric_sv_forward(N, nx, nu, BAbt, ux, pi, ws->L, ws->tmp);
+
+	return;
+
+	}
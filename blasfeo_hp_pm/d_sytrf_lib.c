@@ -0,0 +1,621 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2019 by Gianluca Frison.                                                          *
+* Developed at IMTEK (University of Freiburg) under the supervision of Moritz Diehl.              *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+
+#include <blasfeo_common.h>
+#include <blasfeo_block_size.h>
+#include <blasfeo_stdlib.h>
+#include <blasfeo_align.h>
+#include <blasfeo_d_aux.h>
+#include <blasfeo_d_kernel.h>
+#include <blasfeo_d_blasfeo_api.h>
+
+
+
+// panel width of the blocked factorization
+#define D_SYTRF_NB 32
+// block size of the factorization without pivoting, smaller for small matrices where the unblocked part dominates
+#define D_SYTRF_NOPIV_NB 32
+#define D_SYTRF_NOPIV_NB_SMALL 16
+#define D_SYTRF_NOPIV_M_SMALL 256
+
+
+
+// symmetric interchange of rows and columns r<p of the lower triangular of the m x m matrix A;
+// the rows are swapped over all the columns on their left, to keep the computed part of L in standard form
+static void d_sytrf_symsw(int m, struct blasfeo_dmat *sA, int ai, int aj, int r, int p)
+	{
+	int ii;
+	double tmp;
+	blasfeo_drowsw(r, sA, ai+r, aj, sA, ai+p, aj);
+	for(ii=r+1; ii<p; ii++)
+		{
+		tmp = BLASFEO_DMATEL(sA, ai+ii, aj+r);
+		BLASFEO_DMATEL(sA, ai+ii, aj+r) = BLASFEO_DMATEL(sA, ai+p, aj+ii);
+		BLASFEO_DMATEL(sA, ai+p, aj+ii) = tmp;
+		}
+	tmp = BLASFEO_DMATEL(sA, ai+r, aj+r);
+	BLASFEO_DMATEL(sA, ai+r, aj+r) = BLASFEO_DMATEL(sA, ai+p, aj+p);
+	BLASFEO_DMATEL(sA, ai+p, aj+p) = tmp;
+	if(p<m-1)
+		blasfeo_dcolsw(m-p-1, sA, ai+p+1, aj+r, sA, ai+p+1, aj+p);
+	return;
+	}
+
+
+
+// factorize the panel of A starting at column k0, using W as work space for L*D of the panel columns;
+// the updated columns are formed by dgemv_n in the work vectors w0, w1, from the row of W in x;
+// in blocked mode (blk!=0) the panel stops after nb-1 or nb columns, otherwise it extends to the last column;
+// returns the number of factorized columns
+static int d_sytrf_panel(int m, int k0, int nb, int blk, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sW, struct blasfeo_dvec *sw0, struct blasfeo_dvec *sw1, struct blasfeo_dvec *sx, int *ipiv)
+	{
+
+	const double alpha = (1.0+sqrt(17.0))/8.0;
+
+	int ii, k, kw, kstep, kp, kk, imax;
+	double absakk, colmax, rowmax, tmp, d11, d21, d22, t;
+
+	double *w0 = sw0->pa;
+	double *w1 = sw1->pa;
+
+	k = k0;
+	kw = 0;
+	while(k<m & (blk==0 | kw<nb-1))
+		{
+
+		// updated column k
+		blasfeo_dcolex(m-k, sA, ai+k, aj+k, sw0, 0);
+		if(kw>0)
+			{
+			blasfeo_drowex(kw, 1.0, sW, k-k0, 0, sx, 0);
+			blasfeo_dgemv_n(m-k, kw, -1.0, sA, ai+k, aj+k0, sx, 0, 1.0, sw0, 0, sw0, 0);
+			}
+
+		// largest off-diagonal element in the column
+		kstep = 1;
+		absakk = fabs(w0[0]);
+		imax = k;
+		colmax = 0.0;
+		for(ii=1; ii<m-k; ii++)
+			{
+			tmp = fabs(w0[ii]);
+			if(tmp>colmax)
+				{
+				colmax = tmp;
+				imax = k+ii;
+				}
+			}
+
+		if(absakk==0.0 & colmax==0.0)
+			{
+			// zero column: 1x1 zero pivot, the factorization is singular
+			kp = k;
+			}
+		else if(absakk>=alpha*colmax)
+			{
+			// no interchange, 1x1 pivot
+			kp = k;
+			}
+		else
+			{
+			// updated column imax
+			blasfeo_drowex(imax-k, 1.0, sA, ai+imax, aj+k, sw1, 0);
+			blasfeo_dcolex(m-imax, sA, ai+imax, aj+imax, sw1, imax-k);
+			if(kw>0)
+				{
+				blasfeo_drowex(kw, 1.0, sW, imax-k0, 0, sx, 0);
+				blasfeo_dgemv_n(m-k, kw, -1.0, sA, ai+k, aj+k0, sx, 0, 1.0, sw1, 0, sw1, 0);
+				}
+			// largest off-diagonal element in the row imax
+			rowmax = 0.0;
+			for(ii=0; ii<m-k; ii++)
+				{
+				tmp = fabs(w1[ii]);
+				if(ii!=imax-k & tmp>rowmax)
+					rowmax = tmp;
+				}
+			if(absakk>=alpha*colmax*(colmax/rowmax))
+				{
+				// no interchange, 1x1 pivot
+				kp = k;
+				}
+			else if(fabs(w1[imax-k])>=alpha*rowmax)
+				{
+				// interchange rows and columns k and imax, 1x1 pivot
+				kp = imax;
+				blasfeo_dveccp(m-k, sw1, 0, sw0, 0);
+				}
+			else
+				{
+				// interchange rows and columns k+1 and imax, 2x2 pivot
+				kp = imax;
+				kstep = 2;
+				}
+			}
+
+		blasfeo_dcolin(m-k, sw0, 0, sW, k-k0, kw);
+		if(kstep==2)
+			blasfeo_dcolin(m-k, sw1, 0, sW, k-k0, kw+1);
+
+		kk = k+kstep-1;
+		if(kp!=kk)
+			{
+			d_sytrf_symsw(m, sA, ai, aj, kk, kp);
+			blasfeo_drowsw(kw+kstep, sW, kk-k0, 0, sW, kp-k0, 0);
+			tmp = w0[kk-k];
+			w0[kk-k] = w0[kp-k];
+			w0[kp-k] = tmp;
+			if(kstep==2)
+				{
+				tmp = w1[kk-k];
+				w1[kk-k] = w1[kp-k];
+				w1[kp-k] = tmp;
+				}
+			}
+
+		if(kstep==1)
+			{
+			// D(k) = W(k,k), L(k+1:m,k) = W(k+1:m,k) / D(k)
+			d11 = w0[0];
+			t = d11!=0.0 ? 1.0/d11 : 1.0;
+			for(ii=1; ii<m-k; ii++)
+				w0[ii] *= t;
+			blasfeo_dcolin(m-k, sw0, 0, sA, ai+k, aj+k);
+			ipiv[k] = kp;
+			}
+		else
+			{
+			// D(k:k+2,k:k+2) from W, with the off-diagonal element in the upper triangular of A;
+			// L(k+2:m,k:k+2) = W(k+2:m,k:k+2) * D(k:k+2,k:k+2)^{-1}
+			d11 = w0[0];
+			d21 = w0[1];
+			d22 = w1[1];
+			tmp = d11/d21;
+			d11 = d22/d21;
+			d22 = tmp;
+			t = 1.0/(d11*d22-1.0);
+			d21 = t/d21;
+			for(ii=2; ii<m-k; ii++)
+				{
+				tmp = w0[ii];
+				w0[ii] = d21*(d11*tmp-w1[ii]);
+				w1[ii] = d21*(d22*w1[ii]-tmp);
+				}
+			w0[1] = 0.0;
+			blasfeo_dcolin(m-k, sw0, 0, sA, ai+k, aj+k);
+			blasfeo_dcolin(m-k-1, sw1, 1, sA, ai+k+1, aj+k+1);
+			BLASFEO_DMATEL(sA, ai+k, aj+k+1) = BLASFEO_DMATEL(sW, k+1-k0, kw);
+			ipiv[k] = -kp-1;
+			ipiv[k+1] = -kp-1;
+			}
+
+		k += kstep;
+		kw += kstep;
+
+		}
+
+	return kw;
+
+	}
+
+
+
+void blasfeo_dsytrf_l(int m, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj, int *ipiv)
+	{
+
+	if(m<=0)
+		return;
+
+	// invalidate stored inverse diagonal of result matrix
+	sD->use_dA = 0;
+
+	if(sC!=sD | ci!=di | cj!=dj)
+		blasfeo_dtrcp_l(m, sC, ci, cj, sD, di, dj);
+
+	int nb = m<D_SYTRF_NB ? m : D_SYTRF_NB;
+
+	struct blasfeo_dmat sW;
+	struct blasfeo_dvec sw0, sw1, sx;
+	size_t memsize_W = blasfeo_memsize_dmat(m, nb);
+	size_t memsize_w = blasfeo_memsize_dvec(m);
+	size_t memsize_x = blasfeo_memsize_dvec(nb);
+	void *mem;
+	char *mem_align;
+	blasfeo_ws_malloc(&mem, memsize_W+2*memsize_w+memsize_x+64);
+	if(mem==NULL)
+		return;
+	blasfeo_align_64_byte(mem, (void **) &mem_align);
+	blasfeo_create_dmat(m, nb, &sW, mem_align);
+	mem_align += memsize_W;
+	blasfeo_create_dvec(m, &sw0, mem_align);
+	mem_align += memsize_w;
+	blasfeo_create_dvec(m, &sw1, mem_align);
+	mem_align += memsize_w;
+	blasfeo_create_dvec(nb, &sx, mem_align);
+
+	int k, kb;
+
+	k = 0;
+	while(k<m)
+		{
+		if(m-k>nb)
+			{
+			// left-looking factorization of the panel, then right-looking update of the trailing matrix
+			kb = d_sytrf_panel(m, k, nb, 1, sD, di, dj, &sW, &sw0, &sw1, &sx, ipiv);
+			blasfeo_dsyrk_ln(m-k-kb, kb, -1.0, sD, di+k+kb, dj+k, &sW, kb, 0, 1.0, sD, di+k+kb, dj+k+kb, sD, di+k+kb, dj+k+kb);
+			}
+		else
+			{
+			kb = d_sytrf_panel(m, k, nb, 0, sD, di, dj, &sW, &sw0, &sw1, &sx, ipiv);
+			}
+		k += kb;
+		}
+
+	blasfeo_ws_free(mem);
+
+	return;
+
+	}
+
+
+
+void blasfeo_dsytrs_l(int m, int n, struct blasfeo_dmat *sA, int ai, int aj, int *ipiv, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj)
+	{
+
+	if(m<=0 | n<=0)
+		return;
+
+	int ii, jj, kp;
+	double d11, d21, d22, t, b1, b2;
+
+	if(sB!=sD | bi!=di | bj!=dj)
+		blasfeo_dgecp(m, n, sB, bi, bj, sD, di, dj);
+
+	// D <= P * D
+	for(ii=0; ii<m; ii++)
+		{
+		if(ipiv[ii]>=0)
+			{
+			if(ipiv[ii]!=ii)
+				blasfeo_drowsw(n, sD, di+ii, dj, sD, di+ipiv[ii], dj);
+			}
+		else
+			{
+			kp = -ipiv[ii]-1;
+			ii++;
+			if(kp!=ii)
+				blasfeo_drowsw(n, sD, di+ii, dj, sD, di+kp, dj);
+			}
+		}
+
+	// D <= L^{-1} * D
+	blasfeo_dtrsm_llnu(m, n, 1.0, sA, ai, aj, sD, di, dj, sD, di, dj);
+
+	// D <= D^{-1} * D, with D block diagonal
+	for(ii=0; ii<m; ii++)
+		{
+		if(ipiv[ii]>=0)
+			{
+			blasfeo_dgesc(1, n, 1.0/BLASFEO_DMATEL(sA, ai+ii, aj+ii), sD, di+ii, dj);
+			}
+		else
+			{
+			d21 = BLASFEO_DMATEL(sA, ai+ii, aj+ii+1);
+			d11 = BLASFEO_DMATEL(sA, ai+ii, aj+ii)/d21;
+			d22 = BLASFEO_DMATEL(sA, ai+ii+1, aj+ii+1)/d21;
+			t = 1.0/(d11*d22-1.0);
+			for(jj=0; jj<n; jj++)
+				{
+				b1 = BLASFEO_DMATEL(sD, di+ii, dj+jj)/d21;
+				b2 = BLASFEO_DMATEL(sD, di+ii+1, dj+jj)/d21;
+				BLASFEO_DMATEL(sD, di+ii, dj+jj) = t*(d22*b1-b2);
+				BLASFEO_DMATEL(sD, di+ii+1, dj+jj) = t*(d11*b2-b1);
+				}
+			ii++;
+			}
+		}
+
+	// D <= L^{-T} * D
+	blasfeo_dtrsm_lltu(m, n, 1.0, sA, ai, aj, sD, di, dj, sD, di, dj);
+
+	// D <= P^T * D
+	for(ii=m-1; ii>=0; ii--)
+		{
+		if(ipiv[ii]>=0)
+			{
+			if(ipiv[ii]!=ii)
+				blasfeo_drowsw(n, sD, di+ii, dj, sD, di+ipiv[ii], dj);
+			}
+		else
+			{
+			kp = -ipiv[ii]-1;
+			if(kp!=ii)
+				blasfeo_drowsw(n, sD, di+ii, dj, sD, di+kp, dj);
+			ii--;
+			}
+		}
+
+	return;
+
+	}
+
+
+
+// unblocked factorization of the m x m diagonal block of A at (ai, aj), without pivoting;
+// the block is factorized in the column-major work space w of size m x m
+static void d_sytrf_nopiv_unb(int m, struct blasfeo_dmat *sA, int ai, int aj, double *w)
+	{
+	int ii, jj, kk;
+	double d, t, wkj;
+	for(jj=0; jj<m; jj++)
+		for(ii=jj; ii<m; ii++)
+			w[ii+m*jj] = BLASFEO_DMATEL(sA, ai+ii, aj+jj);
+	for(jj=0; jj<m; jj++)
+		{
+		d = w[jj+m*jj];
+		t = d!=0.0 ? 1.0/d : 0.0;
+		for(kk=jj+1; kk<m; kk++)
+			{
+			wkj = t*w[kk+m*jj];
+			for(ii=kk; ii<m; ii++)
+				w[ii+m*kk] -= w[ii+m*jj]*wkj;
+			}
+		for(ii=jj+1; ii<m; ii++)
+			w[ii+m*jj] *= t;
+		}
+	for(jj=0; jj<m; jj++)
+		for(ii=jj; ii<m; ii++)
+			BLASFEO_DMATEL(sA, ai+ii, aj+jj) = w[ii+m*jj];
+	return;
+	}
+
+
+
+#if defined(LA_HIGH_PERFORMANCE) & defined(MF_PANELMAJ) & (D_PS==4)
+// W <= D * diag(E), for the 4 x 4 blocks of the m rows of D and W at zero row offset, with the diagonal in the 4 x 4 block E;
+// the rows in the padding of the last panel are scaled too
+static void d_sytrf_nopiv_scale_lib4(int m, double *E, double *pD, int sdd, double *pW, int sdw)
+	{
+	const int ps = 4;
+	int ii, jj;
+	double d0 = E[0+ps*0];
+	double d1 = E[1+ps*1];
+	double d2 = E[2+ps*2];
+	double d3 = E[3+ps*3];
+	for(ii=0; ii<m; ii+=ps)
+		{
+		for(jj=0; jj<ps; jj++)
+			{
+			pW[jj+ps*0] = d0 * pD[jj+ps*0];
+			pW[jj+ps*1] = d1 * pD[jj+ps*1];
+			pW[jj+ps*2] = d2 * pD[jj+ps*2];
+			pW[jj+ps*3] = d3 * pD[jj+ps*3];
+			}
+		pD += ps*sdd;
+		pW += ps*sdw;
+		}
+	return;
+	}
+
+
+
+// factorization without pivoting at zero row offset, with the loops of blasfeo_hp_dpotrf_l and signed-diagonal kernels;
+// the lower triangular of W holds L * diag(D), that is the right factor of the updates C - L * (L * diag(D))^T,
+// and the triangular of the dtrsm kernels, with the inverse of the diagonal in dW
+static void d_sytrf_nopiv_lib4(int m, double *pC, int sdc, double *pD, int sdd, double *pW, int sdw, double *dW)
+	{
+
+	const int ps = 4;
+
+	double alpha = 1.0;
+
+	int i, j;
+
+	i = 0;
+#if defined(TARGET_X64_INTEL_HASWELL)
+	for(; i<m-11; i+=12)
+		{
+		j = 0;
+		for(; j<i; j+=4)
+			{
+			kernel_dtrsm_nt_rl_inv_12x4_lib4(j, &pD[i*sdd], sdd, &pW[j*sdw], &alpha, &pC[j*ps+i*sdc], sdc, &pD[j*ps+i*sdd], sdd, &pW[j*ps+j*sdw], &dW[j]);
+			d_sytrf_nopiv_scale_lib4(12, &pW[j*ps+j*sdw], &pD[j*ps+i*sdd], sdd, &pW[j*ps+i*sdw], sdw);
+			}
+		kernel_dsytrf_nt_l_12x4_lib4(j, &pD[i*sdd], sdd, &pW[j*sdw], &pC[j*ps+j*sdc], sdc, &pD[j*ps+j*sdd], sdd, &pW[j*ps+j*sdw], sdw, &dW[j]);
+		kernel_dsytrf_nt_l_4x4_lib4(j+4, &pD[(i+4)*sdd], &pW[(j+4)*sdw], &pC[(j+4)*ps+(i+4)*sdc], &pD[(j+4)*ps+(i+4)*sdd], &pW[(j+4)*ps+(i+4)*sdw], &dW[j+4]);
+		kernel_dtrsm_nt_rl_inv_4x4_lib4(j+4, &pD[(i+8)*sdd], &pW[(j+4)*sdw], &alpha, &pC[(j+4)*ps+(i+8)*sdc], &pD[(j+4)*ps+(i+8)*sdd], &pW[(j+4)*ps+(j+4)*sdw], &dW[j+4]);
+		d_sytrf_nopiv_scale_lib4(4, &pW[(j+4)*ps+(j+4)*sdw], &pD[(j+4)*ps+(i+8)*sdd], sdd, &pW[(j+4)*ps+(i+8)*sdw], sdw);
+		kernel_dsytrf_nt_l_4x4_lib4(j+8, &pD[(i+8)*sdd], &pW[(j+8)*sdw], &pC[(j+8)*ps+(i+8)*sdc], &pD[(j+8)*ps+(i+8)*sdd], &pW[(j+8)*ps+(i+8)*sdw], &dW[j+8]);
+		}
+	if(m-i>8)
+		{
+		j = 0;
+		for(; j<i; j+=4)
+			{
+			kernel_dtrsm_nt_rl_inv_12x4_vs_lib4(j, &pD[i*sdd], sdd, &pW[j*sdw], &alpha, &pC[j*ps+i*sdc], sdc, &pD[j*ps+i*sdd], sdd, &pW[j*ps+j*sdw], &dW[j], m-i, 4);
+			d_sytrf_nopiv_scale_lib4(m-i, &pW[j*ps+j*sdw], &pD[j*ps+i*sdd], sdd, &pW[j*ps+i*sdw], sdw);
+			}
+		kernel_dsytrf_nt_l_12x4_vs_lib4(j, &pD[i*sdd], sdd, &pW[j*sdw], &pC[j*ps+j*sdc], sdc, &pD[j*ps+j*sdd], sdd, &pW[j*ps+j*sdw], sdw, &dW[j], m-i, 4);
+		kernel_dsytrf_nt_l_4x4_lib4(j+4, &pD[(i+4)*sdd], &pW[(j+4)*sdw], &pC[(j+4)*ps+(i+4)*sdc], &pD[(j+4)*ps+(i+4)*sdd], &pW[(j+4)*ps+(i+4)*sdw], &dW[j+4]);
+		kernel_dtrsm_nt_rl_inv_4x4_vs_lib4(j+4, &pD[(i+8)*sdd], &pW[(j+4)*sdw], &alpha, &pC[(j+4)*ps+(i+8)*sdc], &pD[(j+4)*ps+(i+8)*sdd], &pW[(j+4)*ps+(j+4)*sdw], &dW[j+4], m-i-8, 4);
+		d_sytrf_nopiv_scale_lib4(m-i-8, &pW[(j+4)*ps+(j+4)*sdw], &pD[(j+4)*ps+(i+8)*sdd], sdd, &pW[(j+4)*ps+(i+8)*sdw], sdw);
+		kernel_dsytrf_nt_l_4x4_vs_lib4(j+8, &pD[(i+8)*sdd], &pW[(j+8)*sdw], &pC[(j+8)*ps+(i+8)*sdc], &pD[(j+8)*ps+(i+8)*sdd], &pW[(j+8)*ps+(i+8)*sdw], &dW[j+8], m-i-8, m-i-8);
+		return;
+		}
+#endif
+	for(; i<m-3; i+=4)
+		{
+		j = 0;
+		for(; j<i; j+=4)
+			{
+			kernel_dtrsm_nt_rl_inv_4x4_lib4(j, &pD[i*sdd], &pW[j*sdw], &alpha, &pC[j*ps+i*sdc], &pD[j*ps+i*sdd], &pW[j*ps+j*sdw], &dW[j]);
+			d_sytrf_nopiv_scale_lib4(4, &pW[j*ps+j*sdw], &pD[j*ps+i*sdd], sdd, &pW[j*ps+i*sdw], sdw);
+			}
+		kernel_dsytrf_nt_l_4x4_lib4(j, &pD[i*sdd], &pW[j*sdw], &pC[j*ps+j*sdc], &pD[j*ps+j*sdd], &pW[j*ps+j*sdw], &dW[j]);
+		}
+	if(m>i)
+		{
+		j = 0;
+		for(; j<i; j+=4)
+			{
+			kernel_dtrsm_nt_rl_inv_4x4_vs_lib4(j, &pD[i*sdd], &pW[j*sdw], &alpha, &pC[j*ps+i*sdc], &pD[j*ps+i*sdd], &pW[j*ps+j*sdw], &dW[j], m-i, 4);
+			d_sytrf_nopiv_scale_lib4(m-i, &pW[j*ps+j*sdw], &pD[j*ps+i*sdd], sdd, &pW[j*ps+i*sdw], sdw);
+			}
+		kernel_dsytrf_nt_l_4x4_vs_lib4(j, &pD[i*sdd], &pW[j*sdw], &pC[j*ps+j*sdc], &pD[j*ps+j*sdd], &pW[j*ps+j*sdw], &dW[j], m-i, m-i);
+		}
+
+	return;
+
+	}
+#endif
+
+
+
+void blasfeo_dsytrf_l_nopiv(int m, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj)
+	{
+
+	if(m<=0)
+		return;
+
+	// invalidate stored inverse diagonal of result matrix
+	sD->use_dA = 0;
+
+#if defined(LA_HIGH_PERFORMANCE) & defined(MF_PANELMAJ) & (D_PS==4)
+	if(ci==0 & di==0)
+		{
+		struct blasfeo_dmat sW;
+		void *mem_W;
+		char *mem_W_align;
+		blasfeo_ws_malloc(&mem_W, blasfeo_memsize_dmat(m, m)+64);
+		if(mem_W==NULL)
+			return;
+		blasfeo_align_64_byte(mem_W, (void **) &mem_W_align);
+		blasfeo_create_dmat(m, m, &sW, mem_W_align);
+		d_sytrf_nopiv_lib4(m, sC->pA+cj*D_PS, sC->cn, sD->pA+dj*D_PS, sD->cn, sW.pA, sW.cn, sW.dA);
+		blasfeo_ws_free(mem_W);
+		return;
+		}
+#endif
+
+	if(sC!=sD | ci!=di | cj!=dj)
+		blasfeo_dtrcp_l(m, sC, ci, cj, sD, di, dj);
+
+	int nb = m<=D_SYTRF_NOPIV_M_SMALL ? D_SYTRF_NOPIV_NB_SMALL : D_SYTRF_NOPIV_NB;
+	nb = m<nb ? m : nb;
+
+	// column-major diagonal block; L11 with unit diagonal, and L21*D1 at zero offset, for the high-performance dtrsm_rltn
+	struct blasfeo_dmat sE, sT;
+	size_t memsize_w = (nb*nb*sizeof(double)+63)/64*64;
+	size_t memsize_E = blasfeo_memsize_dmat(nb, nb);
+	size_t memsize_T = m>nb ? blasfeo_memsize_dmat(m-nb, nb) : 0;
+	void *mem;
+	char *mem_align;
+	blasfeo_ws_malloc(&mem, memsize_w+memsize_E+memsize_T+64);
+	if(mem==NULL)
+		return;
+	blasfeo_align_64_byte(mem, (void **) &mem_align);
+	double *w = (double *) mem_align;
+	mem_align += memsize_w;
+	if(m>nb)
+		{
+		blasfeo_create_dmat(nb, nb, &sE, mem_align);
+		blasfeo_create_dmat(m-nb, nb, &sT, mem_align+memsize_E);
+		}
+
+	int ii, jj, k, kb, m2;
+	double d;
+
+	for(k=0; k<m; k+=kb)
+		{
+		kb = m-k<nb ? m-k : nb;
+		m2 = m-k-kb;
+		d_sytrf_nopiv_unb(kb, sD, di+k, dj+k, w);
+		if(m2>0)
+			{
+			// L21*D1 = C21 * L11^{-T}
+			blasfeo_dtrcp_l(kb, sD, di+k, dj+k, &sE, 0, 0);
+			for(ii=0; ii<kb; ii++)
+				BLASFEO_DMATEL(&sE, ii, ii) = 1.0;
+			sE.use_dA = 0;
+			blasfeo_dgecp(m2, kb, sD, di+k+kb, dj+k, &sT, 0, 0);
+			blasfeo_dtrsm_rltn(m2, kb, 1.0, &sE, 0, 0, &sT, 0, 0, &sT, 0, 0);
+			// L21 = (L21*D1) * D1^{-1}
+			for(jj=0; jj<kb; jj++)
+				{
+				d = BLASFEO_DMATEL(sD, di+k+jj, dj+k+jj);
+				blasfeo_dgecpsc(m2, 1, d!=0.0 ? 1.0/d : 0.0, &sT, 0, jj, sD, di+k+kb, dj+k+jj);
+				}
+			// C22 -= L21 * (L21*D1)^T
+			blasfeo_dsyrk_ln(m2, kb, -1.0, sD, di+k+kb, dj+k, &sT, 0, 0, 1.0, sD, di+k+kb, dj+k+kb, sD, di+k+kb, dj+k+kb);
+			}
+		}
+
+	blasfeo_ws_free(mem);
+
+	return;
+
+	}
+
+
+
+void blasfeo_dsytrs_l_nopiv(int m, int n, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj)
+	{
+
+	if(m<=0 | n<=0)
+		return;
+
+	int ii;
+
+	if(sB!=sD | bi!=di | bj!=dj)
+		blasfeo_dgecp(m, n, sB, bi, bj, sD, di, dj);
+
+	// D <= L^{-1} * D
+	blasfeo_dtrsm_llnu(m, n, 1.0, sA, ai, aj, sD, di, dj, sD, di, dj);
+
+	// D <= D^{-1} * D
+	for(ii=0; ii<m; ii++)
+		blasfeo_dgesc(1, n, 1.0/BLASFEO_DMATEL(sA, ai+ii, aj+ii), sD, di+ii, dj);
+
+	// D <= L^{-T} * D
+	blasfeo_dtrsm_lltu(m, n, 1.0, sA, ai, aj, sD, di, dj, sD, di, dj);
+
+	return;
+
+	}
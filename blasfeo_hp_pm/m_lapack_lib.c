@@ -0,0 +1,495 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2019 by Gianluca Frison.                                                          *
+* Developed at IMTEK (University of Freiburg) under the supervision of Moritz Diehl.              *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+#include <float.h>
+
+#include <blasfeo_common.h>
+#include <blasfeo_align.h>
+#include <blasfeo_d_aux.h>
+#include <blasfeo_s_aux.h>
+#include <blasfeo_m_aux.h>
+#include <blasfeo_d_blasfeo_api.h>
+#include <blasfeo_s_blasfeo_api.h>
+#include <blasfeo_m_blasfeo_api.h>
+
+
+
+// max number of refinement steps
+#define GESV_MIXED_ITER_MAX 30
+#define POSV_MIXED_ITER_MAX 30
+
+// min size for which the single-precision factorization (plus refinement) is faster than the double-precision one;
+// targets without optimized lib8 single-precision factorizations always use the double-precision ones
+#if defined(TARGET_X64_INTEL_HASWELL) | defined(TARGET_X64_INTEL_SANDY_BRIDGE)
+#define GESV_MIXED_N_MIN 192
+#define POSV_MIXED_N_MIN 256
+#endif
+
+
+
+size_t blasfeo_dgesv_mixed_worksize(int n)
+	{
+	return blasfeo_memsize_smat(n, n) + blasfeo_memsize_svec(n) + blasfeo_memsize_dvec(n) + 64;
+	}
+
+
+
+// row sums of the absolute values of the m x n matrix A, walking A in memory order
+static void d_mixed_rowsum_abs(int m, int n, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dvec *sr)
+	{
+	int ii, jj, ll;
+	double *r = sr->pa;
+	blasfeo_dvecse(m, 0.0, sr, 0);
+#if ( defined(LA_HIGH_PERFORMANCE) & defined(MF_PANELMAJ) ) | ( defined(LA_REFERENCE) & defined(MF_PANELMAJ) )
+	const int ps = D_PS;
+	double *pA;
+	double acc[D_PS];
+	// rows up to the first panel boundary
+	ii = (ps-ai%ps)%ps;
+	ii = m<ii ? m : ii;
+	for(jj=0; jj<n; jj++)
+		{
+		for(ll=0; ll<ii; ll++)
+			{
+			r[ll] += fabs(BLASFEO_DMATEL(sA, ai+ll, aj+jj));
+			}
+		}
+	// full panels
+	for(; ii<m-ps+1; ii+=ps)
+		{
+		pA = &BLASFEO_DMATEL(sA, ai+ii, aj);
+		for(ll=0; ll<ps; ll++)
+			acc[ll] = 0.0;
+		for(jj=0; jj<n; jj++)
+			{
+			for(ll=0; ll<ps; ll++)
+				{
+				acc[ll] += fabs(pA[ll+jj*ps]);
+				}
+			}
+		for(ll=0; ll<ps; ll++)
+			r[ii+ll] = acc[ll];
+		}
+	if(ii<m)
+		{
+		pA = &BLASFEO_DMATEL(sA, ai+ii, aj);
+		for(jj=0; jj<n; jj++)
+			{
+			for(ll=0; ll<m-ii; ll++)
+				{
+				r[ii+ll] += fabs(pA[ll+jj*ps]);
+				}
+			}
+		}
+#else
+	int lda = sA->m;
+	double *pA = sA->pA + ai + aj*lda;
+	for(jj=0; jj<n; jj++)
+		{
+		for(ii=0; ii<m; ii++)
+			{
+			r[ii] += fabs(pA[ii+jj*lda]);
+			}
+		}
+#endif
+	return;
+	}
+
+
+
+// infinity norm of the n x n matrix A
+static double dgesv_mixed_nrm_inf(int n, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dvec *sr)
+	{
+	double nrm;
+	d_mixed_rowsum_abs(n, n, sA, ai, aj, sr);
+	blasfeo_dvecnrm_inf(n, sr, 0, &nrm);
+	return nrm;
+	}
+
+
+
+// r_s <= r in single precision, returns || r ||_inf
+static double d_mixed_cvt_nrm(int n, struct blasfeo_dvec *sr, struct blasfeo_svec *sr_s)
+	{
+	int ii;
+	double tmp, nrm = 0.0;
+	double *r = sr->pa;
+	float *r_s = sr_s->pa;
+	for(ii=0; ii<n; ii++)
+		{
+		tmp = fabs(r[ii]);
+		// also catches NaN
+		nrm = tmp<=nrm ? nrm : tmp;
+		r_s[ii] = (float) r[ii];
+		}
+	return nrm;
+	}
+
+
+
+// x += d_s in double precision, returns || x ||_inf
+static double d_mixed_update_nrm(int n, struct blasfeo_svec *sd_s, struct blasfeo_dvec *sx, int xi)
+	{
+	int ii;
+	double tmp, nrm = 0.0;
+	float *d_s = sd_s->pa;
+	double *x = sx->pa + xi;
+	for(ii=0; ii<n; ii++)
+		{
+		x[ii] += (double) d_s[ii];
+		tmp = fabs(x[ii]);
+		nrm = tmp<=nrm ? nrm : tmp;
+		}
+	return nrm;
+	}
+
+
+
+void blasfeo_dgesv_mixed(int n, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dvec *sb, int bi, struct blasfeo_dvec *sx, int xi, int *ipiv, int *iter, int *info, void *work)
+	{
+
+	*iter = 0;
+	*info = 0;
+
+	if(n<=0)
+		return;
+
+	int ii;
+
+#if defined(GESV_MIXED_N_MIN)
+	if(n<GESV_MIXED_N_MIN)
+#endif
+		{
+		*info = 1;
+		goto double_lu;
+		}
+
+	// partition work space
+	char *c_ptr;
+	blasfeo_align_64_byte(work, (void **) &c_ptr);
+	struct blasfeo_smat sLU;
+	blasfeo_create_smat(n, n, &sLU, c_ptr);
+	c_ptr += sLU.memsize;
+	struct blasfeo_svec sr_s;
+	blasfeo_create_svec(n, &sr_s, c_ptr);
+	c_ptr += sr_s.memsize;
+	struct blasfeo_dvec sr;
+	blasfeo_create_dvec(n, &sr, c_ptr);
+
+	// stopping criterion as in LAPACK dsgesv: || b - A x ||_inf <= || x ||_inf || A ||_inf eps sqrt(n)
+	double a_nrm = dgesv_mixed_nrm_inf(n, sA, ai, aj, &sr);
+	double tol = a_nrm * 0.5*DBL_EPSILON * sqrt((double) n);
+	double r_nrm, r_nrm_old, x_nrm;
+
+	// the conversion to single precision would overflow
+	if(!(a_nrm<=FLT_MAX))
+		{
+		*info = 1;
+		goto double_lu;
+		}
+
+	// single-precision LU
+	blasfeo_cvt_d2s_mat(n, n, sA, ai, aj, &sLU, 0, 0);
+	blasfeo_sgetrf_rp(n, n, &sLU, 0, 0, &sLU, 0, 0, ipiv);
+	for(ii=0; ii<n; ii++)
+		{
+		if(!(fabs(BLASFEO_SMATEL(&sLU, ii, ii))>0.0 & fabs(BLASFEO_SMATEL(&sLU, ii, ii))<=FLT_MAX))
+			{
+			*info = 1;
+			goto double_lu;
+			}
+		}
+
+	// initial solution
+	blasfeo_dveccp(n, sb, bi, &sr, 0);
+	blasfeo_dvecpe(n, ipiv, &sr, 0);
+	d_mixed_cvt_nrm(n, &sr, &sr_s);
+	blasfeo_strsv_lnu(n, &sLU, 0, 0, &sr_s, 0, &sr_s, 0);
+	blasfeo_strsv_unn(n, &sLU, 0, 0, &sr_s, 0, &sr_s, 0);
+	blasfeo_dvecse(n, 0.0, sx, xi);
+	x_nrm = d_mixed_update_nrm(n, &sr_s, sx, xi);
+
+	// iterative refinement
+	r_nrm_old = INFINITY;
+	for(ii=0; ii<=GESV_MIXED_ITER_MAX; ii++)
+		{
+		// r = b - A x
+		blasfeo_dgemv_n(n, n, -1.0, sA, ai, aj, sx, xi, 1.0, sb, bi, &sr, 0);
+		blasfeo_dvecpe(n, ipiv, &sr, 0);
+		r_nrm = d_mixed_cvt_nrm(n, &sr, &sr_s);
+		*iter = ii;
+		if(r_nrm<=x_nrm*tol)
+			return;
+		// each step has to (at least) halve the residual, else single precision is not accurate enough for this matrix
+		if(ii==GESV_MIXED_ITER_MAX | !(r_nrm<=0.5*r_nrm_old))
+			{
+			*info = 2;
+			goto double_lu;
+			}
+		r_nrm_old = r_nrm;
+		// x += A^{-1} r
+		blasfeo_strsv_lnu(n, &sLU, 0, 0, &sr_s, 0, &sr_s, 0);
+		blasfeo_strsv_unn(n, &sLU, 0, 0, &sr_s, 0, &sr_s, 0);
+		x_nrm = d_mixed_update_nrm(n, &sr_s, sx, xi);
+		}
+
+double_lu:
+
+	// fall back to double-precision LU
+	blasfeo_dgetrf_rp(n, n, sA, ai, aj, sA, ai, aj, ipiv);
+	blasfeo_dveccp(n, sb, bi, sx, xi);
+	blasfeo_dvecpe(n, ipiv, sx, xi);
+	blasfeo_dtrsv_lnu(n, sA, ai, aj, sx, xi, sx, xi);
+	blasfeo_dtrsv_unn(n, sA, ai, aj, sx, xi, sx, xi);
+
+	return;
+
+	}
+
+
+
+size_t blasfeo_dposv_mixed_worksize(int n)
+	{
+	return blasfeo_memsize_smat(n, n) + blasfeo_memsize_svec(n) + blasfeo_memsize_dvec(n) + 64;
+	}
+
+
+
+// infinity norm of the n x n symmetric matrix A, stored in the lower triangular part, walking A in memory order
+static double dposv_mixed_nrm_inf(int n, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dvec *sr)
+	{
+	int ii, jj, ll;
+	double nrm, tmp, col;
+	double *r = sr->pa;
+	blasfeo_dvecse(n, 0.0, sr, 0);
+#if ( defined(LA_HIGH_PERFORMANCE) & defined(MF_PANELMAJ) ) | ( defined(LA_REFERENCE) & defined(MF_PANELMAJ) )
+	const int ps = D_PS;
+	int mb;
+	double *pA;
+	double acc[D_PS];
+	// rows up to the first panel boundary
+	ii = (ps-ai%ps)%ps;
+	ii = n<ii ? n : ii;
+	for(ll=0; ll<ii; ll++)
+		{
+		for(jj=0; jj<ll; jj++)
+			{
+			tmp = fabs(BLASFEO_DMATEL(sA, ai+ll, aj+jj));
+			r[ll] += tmp;
+			r[jj] += tmp;
+			}
+		r[ll] += fabs(BLASFEO_DMATEL(sA, ai+ll, aj+ll));
+		}
+	// row panels
+	for(; ii<n; ii+=ps)
+		{
+		mb = n-ii<ps ? n-ii : ps;
+		pA = &BLASFEO_DMATEL(sA, ai+ii, aj);
+		for(ll=0; ll<ps; ll++)
+			acc[ll] = 0.0;
+		// left of the diagonal block: the column sums go to the rows of the upper triangle
+		if(mb==ps)
+			{
+			for(jj=0; jj<ii; jj++)
+				{
+				col = 0.0;
+				for(ll=0; ll<ps; ll++)
+					{
+					tmp = fabs(pA[ll+jj*ps]);
+					acc[ll] += tmp;
+					col += tmp;
+					}
+				r[jj] += col;
+				}
+			}
+		else
+			{
+			for(jj=0; jj<ii; jj++)
+				{
+				col = 0.0;
+				for(ll=0; ll<mb; ll++)
+					{
+					tmp = fabs(pA[ll+jj*ps]);
+					acc[ll] += tmp;
+					col += tmp;
+					}
+				r[jj] += col;
+				}
+			}
+		// diagonal block
+		for(ll=0; ll<mb; ll++)
+			{
+			for(jj=0; jj<ll; jj++)
+				{
+				tmp = fabs(pA[ll+(ii+jj)*ps]);
+				acc[ll] += tmp;
+				acc[jj] += tmp;
+				}
+			acc[ll] += fabs(pA[ll+(ii+ll)*ps]);
+			}
+		for(ll=0; ll<mb; ll++)
+			r[ii+ll] += acc[ll];
+		}
+#else
+	int lda = sA->m;
+	double *pA = sA->pA + ai + aj*lda;
+	for(jj=0; jj<n; jj++)
+		{
+		col = fabs(pA[jj+jj*lda]);
+		for(ii=jj+1; ii<n; ii++)
+			{
+			tmp = fabs(pA[ii+jj*lda]);
+			r[ii] += tmp;
+			col += tmp;
+			}
+		r[jj] += col;
+		}
+#endif
+	blasfeo_dvecnrm_inf(n, sr, 0, &nrm);
+	return nrm;
+	}
+
+
+
+void blasfeo_dposv_mixed(int n, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dvec *sb, int bi, struct blasfeo_dvec *sx, int xi, int *iter, int *info, void *work)
+	{
+
+	*iter = 0;
+	*info = 0;
+
+	if(n<=0)
+		return;
+
+	int ii, mb;
+
+#if defined(POSV_MIXED_N_MIN)
+	if(n<POSV_MIXED_N_MIN)
+#endif
+		{
+		*info = 1;
+		goto double_chol;
+		}
+
+	// partition work space
+	char *c_ptr;
+	blasfeo_align_64_byte(work, (void **) &c_ptr);
+	struct blasfeo_smat sL;
+	blasfeo_create_smat(n, n, &sL, c_ptr);
+	c_ptr += sL.memsize;
+	struct blasfeo_svec sr_s;
+	blasfeo_create_svec(n, &sr_s, c_ptr);
+	c_ptr += sr_s.memsize;
+	struct blasfeo_dvec sr;
+	blasfeo_create_dvec(n, &sr, c_ptr);
+
+	// same stopping criterion as in blasfeo_dgesv_mixed
+	double a_nrm = dposv_mixed_nrm_inf(n, sA, ai, aj, &sr);
+	double tol = a_nrm * 0.5*DBL_EPSILON * sqrt((double) n);
+	double r_nrm, r_nrm_old, x_nrm;
+
+	// the conversion to single precision would overflow
+	if(!(a_nrm<=FLT_MAX))
+		{
+		*info = 1;
+		goto double_chol;
+		}
+
+	// single-precision Cholesky (the matrix may be positive definite in double but not in single precision);
+	// only the lower triangle is converted, one single-precision row panel at a time (S_PS is a multiple of D_PS)
+#if ( defined(LA_HIGH_PERFORMANCE) & defined(MF_PANELMAJ) ) | ( defined(LA_REFERENCE) & defined(MF_PANELMAJ) )
+	const int ps = S_PS;
+#else
+	const int ps = 8;
+#endif
+	for(ii=0; ii<n; ii+=ps)
+		{
+		mb = n-ii<ps ? n-ii : ps;
+		blasfeo_cvt_d2s_mat(mb, ii+mb, sA, ai+ii, aj, &sL, ii, 0);
+		}
+	blasfeo_spotrf_l(n, &sL, 0, 0, &sL, 0, 0);
+	for(ii=0; ii<n; ii++)
+		{
+		if(!(BLASFEO_SMATEL(&sL, ii, ii)>0.0 & BLASFEO_SMATEL(&sL, ii, ii)<=FLT_MAX))
+			{
+			*info = 1;
+			goto double_chol;
+			}
+		}
+
+	// initial solution
+	blasfeo_dveccp(n, sb, bi, &sr, 0);
+	d_mixed_cvt_nrm(n, &sr, &sr_s);
+	blasfeo_strsv_lnn(n, &sL, 0, 0, &sr_s, 0, &sr_s, 0);
+	blasfeo_strsv_ltn(n, &sL, 0, 0, &sr_s, 0, &sr_s, 0);
+	blasfeo_dvecse(n, 0.0, sx, xi);
+	x_nrm = d_mixed_update_nrm(n, &sr_s, sx, xi);
+
+	// iterative refinement
+	r_nrm_old = INFINITY;
+	for(ii=0; ii<=POSV_MIXED_ITER_MAX; ii++)
+		{
+		// r = b - A x
+		blasfeo_dsymv_l(n, -1.0, sA, ai, aj, sx, xi, 1.0, sb, bi, &sr, 0);
+		r_nrm = d_mixed_cvt_nrm(n, &sr, &sr_s);
+		*iter = ii;
+		if(r_nrm<=x_nrm*tol)
+			return;
+		if(ii==POSV_MIXED_ITER_MAX | !(r_nrm<=0.5*r_nrm_old))
+			{
+			*info = 2;
+			goto double_chol;
+			}
+		r_nrm_old = r_nrm;
+		// x += A^{-1} r
+		blasfeo_strsv_lnn(n, &sL, 0, 0, &sr_s, 0, &sr_s, 0);
+		blasfeo_strsv_ltn(n, &sL, 0, 0, &sr_s, 0, &sr_s, 0);
+		x_nrm = d_mixed_update_nrm(n, &sr_s, sx, xi);
+		}
+
+double_chol:
+
+	// fall back to double-precision Cholesky
+	blasfeo_dpotrf_l(n, sA, ai, aj, sA, ai, aj);
+	blasfeo_dveccp(n, sb, bi, sx, xi);
+	blasfeo_dtrsv_lnn(n, sA, ai, aj, sx, xi, sx, xi);
+	blasfeo_dtrsv_ltn(n, sA, ai, aj, sx, xi, sx, xi);
+
+	return;
+
+	}
@@ -743,6 +743,84 @@ void blasfeo_hp_strsv_lnn_mn(int m, int n, struct blasfeo_smat *sA, int ai, int
 
 
 
+void blasfeo_hp_strsv_lnu(int m, struct blasfeo_smat *sA, int ai, int aj, struct blasfeo_svec *sx, int xi, struct blasfeo_svec *sz, int zi)
+	{
+
+	if(m==0)
+		return;
+
+#if defined(DIM_CHECK)
+#ifdef EXT_DEP
+	// non-negative size
+	if(m<0) printf("\n****** blasfeo_strsv_lnu : m<0 : %d<0 *****\n", m);
+	// non-negative offset
+	if(ai<0) printf("\n****** blasfeo_strsv_lnu : ai<0 : %d<0 *****\n", ai);
+	if(aj<0) printf("\n****** blasfeo_strsv_lnu : aj<0 : %d<0 *****\n", aj);
+	if(xi<0) printf("\n****** blasfeo_strsv_lnu : xi<0 : %d<0 *****\n", xi);
+	if(zi<0) printf("\n****** blasfeo_strsv_lnu : zi<0 : %d<0 *****\n", zi);
+	// inside matrix
+	// A: m x k
+	if(ai+m > sA->m) printf("\n***** blasfeo_strsv_lnu : ai+m > row(A) : %d+%d > %d *****\n", ai, m, sA->m);
+	if(aj+m > sA->n) printf("\n***** blasfeo_strsv_lnu : aj+m > col(A) : %d+%d > %d *****\n", aj, m, sA->n);
+	// x: m
+	if(xi+m > sx->m) printf("\n***** blasfeo_strsv_lnu : xi+m > size(x) : %d+%d > %d *****\n", xi, m, sx->m);
+	// z: m
+	if(zi+m > sz->m) printf("\n***** blasfeo_strsv_lnu : zi+m > size(z) : %d+%d > %d *****\n", zi, m, sz->m);
+#endif
+#endif
+
+	if(ai!=0)
+		{
+#if defined(BLASFEO_REF_API)
+		blasfeo_ref_strsv_lnu(m, sA, ai, aj, sx, xi, sz, zi);
+		return;
+#else
+#ifdef EXT_DEP
+		printf("\nblasfeo_strsv_lnu: feature not implemented yet: ai=%d\n", ai);
+#endif	
+		exit(1);
+#endif
+		}
+
+	const int bs = 8;
+
+	int sda = sA->cn;
+	float *pA = sA->pA + aj*bs; // TODO ai
+	float *x = sx->pa + xi;
+	float *z = sz->pa + zi;
+
+	float s1 = 1.0;
+	float sm1 = -1.0;
+
+	int i, ii, jj, km;
+
+	if(x!=z)
+		{
+		for(i=0; i<m; i++)
+			z[i] = x[i];
+		}
+
+	for(i=0; i<m; i+=8)
+		{
+		km = m-i<8 ? m-i : 8;
+		// correct with the already solved part
+		kernel_sgemv_n_8_vs_lib8(i, &sm1, &pA[i*sda], z, &s1, &z[i], &z[i], km);
+		// solve with the unit diagonal block
+		for(jj=0; jj<km; jj++)
+			{
+			for(ii=jj+1; ii<km; ii++)
+				{
+				z[i+ii] -= pA[ii+(i+jj)*bs+i*sda] * z[i+jj];
+				}
+			}
+		}
+
+	return;
+
+	}
+
+
+
 void blasfeo_hp_strsv_ltn(int m, struct blasfeo_smat *sA, int ai, int aj, struct blasfeo_svec *sx, int xi, struct blasfeo_svec *sz, int zi)
 	{
 
@@ -929,6 +1007,105 @@ void blasfeo_hp_strsv_ltn_mn(int m, int n, struct blasfeo_smat *sA, int ai, int
 
 
 
+void blasfeo_hp_strsv_unn(int m, struct blasfeo_smat *sA, int ai, int aj, struct blasfeo_svec *sx, int xi, struct blasfeo_svec *sz, int zi)
+	{
+
+	if(m==0)
+		return;
+
+#if defined(DIM_CHECK)
+#ifdef EXT_DEP
+	// non-negative size
+	if(m<0) printf("\n****** blasfeo_strsv_unn : m<0 : %d<0 *****\n", m);
+	// non-negative offset
+	if(ai<0) printf("\n****** blasfeo_strsv_unn : ai<0 : %d<0 *****\n", ai);
+	if(aj<0) printf("\n****** blasfeo_strsv_unn : aj<0 : %d<0 *****\n", aj);
+	if(xi<0) printf("\n****** blasfeo_strsv_unn : xi<0 : %d<0 *****\n", xi);
+	if(zi<0) printf("\n****** blasfeo_strsv_unn : zi<0 : %d<0 *****\n", zi);
+	// inside matrix
+	// A: m x k
+	if(ai+m > sA->m) printf("\n***** blasfeo_strsv_unn : ai+m > row(A) : %d+%d > %d *****\n", ai, m, sA->m);
+	if(aj+m > sA->n) printf("\n***** blasfeo_strsv_unn : aj+m > col(A) : %d+%d > %d *****\n", aj, m, sA->n);
+	// x: m
+	if(xi+m > sx->m) printf("\n***** blasfeo_strsv_unn : xi+m > size(x) : %d+%d > %d *****\n", xi, m, sx->m);
+	// z: m
+	if(zi+m > sz->m) printf("\n***** blasfeo_strsv_unn : zi+m > size(z) : %d+%d > %d *****\n", zi, m, sz->m);
+#endif
+#endif
+
+	if(ai!=0)
+		{
+#if defined(BLASFEO_REF_API)
+		blasfeo_ref_strsv_unn(m, sA, ai, aj, sx, xi, sz, zi);
+		return;
+#else
+#ifdef EXT_DEP
+		printf("\nblasfeo_strsv_unn: feature not implemented yet: ai=%d\n", ai);
+#endif	
+		exit(1);
+#endif
+		}
+
+	const int bs = 8;
+
+	int sda = sA->cn;
+	float *pA = sA->pA + aj*bs; // TODO ai
+	float *dA = sA->dA;
+	float *x = sx->pa + xi;
+	float *z = sz->pa + zi;
+
+	float s1 = 1.0;
+	float sm1 = -1.0;
+
+	int i, ii, jj, km;
+
+	if(ai==0 & aj==0)
+		{
+		if(sA->use_dA!=1)
+			{
+			sdiaex_lib(m, 1.0, ai, pA, sda, dA);
+			for(ii=0; ii<m; ii++)
+				dA[ii] = 1.0 / dA[ii];
+			sA->use_dA = 1;
+			}
+		}
+	else
+		{
+		sdiaex_lib(m, 1.0, ai, pA, sda, dA);
+		for(ii=0; ii<m; ii++)
+			dA[ii] = 1.0 / dA[ii];
+		sA->use_dA = 0;
+		}
+
+	if(x!=z)
+		{
+		for(i=0; i<m; i++)
+			z[i] = x[i];
+		}
+
+	for(i=(m-1)/bs*bs; i>=0; i-=8)
+		{
+		km = m-i<8 ? m-i : 8;
+		// correct with the already solved part
+		if(m-i>8)
+			kernel_sgemv_n_8_lib8(m-i-8, &sm1, &pA[(i+8)*bs+i*sda], &z[i+8], &s1, &z[i], &z[i]);
+		// solve with the diagonal block
+		for(jj=km-1; jj>=0; jj--)
+			{
+			z[i+jj] *= dA[i+jj];
+			for(ii=0; ii<jj; ii++)
+				{
+				z[i+ii] -= pA[ii+(i+jj)*bs+i*sda] * z[i+jj];
+				}
+			}
+		}
+
+	return;
+
+	}
+
+
+
 void blasfeo_hp_sgemv_nt(int m, int n, float alpha_n, float alpha_t, struct blasfeo_smat *sA, int ai, int aj, struct blasfeo_svec *sx_n, int xi_n, struct blasfeo_svec *sx_t, int xi_t, float beta_n, float beta_t, struct blasfeo_svec *sy_n, int yi_n, struct blasfeo_svec *sy_t, int yi_t, struct blasfeo_svec *sz_n, int zi_n, struct blasfeo_svec *sz_t, int zi_t)
 	{
 
@@ -1299,10 +1476,10 @@ void blasfeo_strsv_lnn(int m, struct blasfeo_smat *sA, int ai, int aj, struct bl
 
 
 
-//void blasfeo_strsv_lnu(int m, struct blasfeo_smat *sA, int ai, int aj, struct blasfeo_svec *sx, int xi, struct blasfeo_svec *sz, int zi)
-//	{
-//	blasfeo_hp_strsv_lnu(m, sA, ai, aj, sx, xi, sz, zi);
-//	}
+void blasfeo_strsv_lnu(int m, struct blasfeo_smat *sA, int ai, int aj, struct blasfeo_svec *sx, int xi, struct blasfeo_svec *sz, int zi)
+	{
+	blasfeo_hp_strsv_lnu(m, sA, ai, aj, sx, xi, sz, zi);
+	}
 
 
 
@@ -1327,10 +1504,10 @@ void blasfeo_strsv_ltn(int m, struct blasfeo_smat *sA, int ai, int aj, struct bl
 
 
 
-//void blasfeo_strsv_unn(int m, struct blasfeo_smat *sA, int ai, int aj, struct blasfeo_svec *sx, int xi, struct blasfeo_svec *sz, int zi)
-//	{
-//	blasfeo_hp_strsv_unn(m, sA, ai, aj, sx, xi, sz, zi);
-//	}
+void blasfeo_strsv_unn(int m, struct blasfeo_smat *sA, int ai, int aj, struct blasfeo_svec *sx, int xi, struct blasfeo_svec *sz, int zi)
+	{
+	blasfeo_hp_strsv_unn(m, sA, ai, aj, sx, xi, sz, zi);
+	}
 
 
 
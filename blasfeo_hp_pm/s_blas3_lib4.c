@@ -38,6 +38,7 @@
 
 #include <blasfeo_common.h>
 #include <blasfeo_s_kernel.h>
+#include <blasfeo_stdlib.h>
 #include <blasfeo_s_aux.h>
 #if defined(BLASFEO_REF_API)
 #include <blasfeo_s_blasfeo_ref_api.h>
@@ -1906,7 +1907,9 @@ void blasfeo_hp_ssyrk_ln(int m, int k, float alpha, struct blasfeo_smat *sA, int
 	if(k>K_MAX_STACK)
 		{
 		sdu = (k+ps-1)/ps*ps;
-		mem = malloc(8*sdu*sizeof(float)+63); // TODO update when bigger kernels are used !!!!!!!!!!!!!!!!
+		blasfeo_ws_malloc((void **) &mem, 8*sdu*sizeof(float)+63); // TODO update when bigger kernels are used !!!!!!!!!!!!!!!!
+		if(mem==NULL)
+			return;
 		blasfeo_align_64_byte(mem, (void **) &pU);
 		}
 	else
@@ -2256,7 +2259,7 @@ loop_BCD:
 end:
 	if(k>K_MAX_STACK)
 		{
-		free(mem);
+		blasfeo_ws_free(mem);
 		}
 	return;
 
@@ -930,16 +930,107 @@ void blasfeo_hp_sgetrf_np(int m, int n, struct blasfeo_smat *sC, int ci, int cj,
 // dgetrf row pivoting
 void blasfeo_hp_sgetrf_rp(int m, int n, struct blasfeo_smat *sC, int ci, int cj, struct blasfeo_smat *sD, int di, int dj, int *ipiv)
 	{
+
+	if(ci!=0 | di!=0)
+		{
 #if defined(BLASFEO_REF_API)
-	blasfeo_ref_sgetrf_rp(m, n, sC, ci, cj, sD, di, dj, ipiv);
-	return;
+		blasfeo_ref_sgetrf_rp(m, n, sC, ci, cj, sD, di, dj, ipiv);
+		return;
 #else
 #ifdef EXT_DEP
-	printf("\nblasfeo_sgetrf_rp: feature not implemented yet\n");
+		printf("\nblasfeo_sgetrf_rp: feature not implemented yet: ci=%d, di=%d\n", ci, di);
 #endif	
-	exit(1);
+		exit(1);
+#endif
+		}
+
+	const int bs = 8;
+
+	int sdd = sD->cn;
+	float *pC = sC->pA + cj*bs;
+	float *pD = sD->pA + dj*bs;
+	float *dD = sD->dA; // XXX what to do if di and dj are not zero
+
+	if(di==0 && dj==0)
+		sD->use_dA = 1;
+	else
+		sD->use_dA = 0;
+
+	if(m<=0 | n<=0)
+		return;
+
+	int ii, jj, kk, jb, pb;
+
+	float d1 = 1.0;
+	float dm1 = -1.0;
+
+	// needs to perform row-excanges on the yet-to-be-factorized matrix too
+	if(pC!=pD)
+		blasfeo_sgecp(m, n, sC, ci, cj, sD, di, dj);
+
+	// left-looking, one panel-aligned block of 8 columns at a time
+	for(jj=0; jj<n; jj+=8)
+		{
+		jb = n-jj<8 ? n-jj : 8;
+
+		// correct & solve upper, rows [0,jj)
+		ii = 0;
+		for(; ii<jj & ii<m; ii+=8)
+			{
+			if(jb>4)
+				kernel_sgemm_nn_8x8_vs_lib8(ii, &dm1, pD+ii*sdd, 0, pD+jj*bs, sdd, &d1, pD+jj*bs+ii*sdd, pD+jj*bs+ii*sdd, m-ii, jb);
+			else
+				kernel_sgemm_nn_8x4_vs_lib8(ii, &dm1, pD+ii*sdd, 0, pD+jj*bs, sdd, &d1, pD+jj*bs+ii*sdd, pD+jj*bs+ii*sdd, m-ii, jb);
+			kernel_strsm_nn_ll_one_8x8_vs_lib8(pD+ii*bs+ii*sdd, pD+jj*bs+ii*sdd, m-ii, jb);
+			}
+
+		// correct lower, rows [jj,m)
+		if(jj>0)
+			{
+#if defined(TARGET_X64_INTEL_HASWELL)
+			for(; ii<m-16; ii+=24)
+				{
+				kernel_sgemm_nn_24x4_vs_lib8(jj, &dm1, pD+ii*sdd, sdd, 0, pD+jj*bs, sdd, &d1, pD+jj*bs+ii*sdd, sdd, pD+jj*bs+ii*sdd, sdd, m-ii, jb);
+				if(jb>4)
+					kernel_sgemm_nn_24x4_vs_lib8(jj, &dm1, pD+ii*sdd, sdd, 0, pD+(jj+4)*bs, sdd, &d1, pD+(jj+4)*bs+ii*sdd, sdd, pD+(jj+4)*bs+ii*sdd, sdd, m-ii, jb-4);
+				}
 #endif
+			for(; ii<m-8; ii+=16)
+				{
+				kernel_sgemm_nn_16x4_vs_lib8(jj, &dm1, pD+ii*sdd, sdd, 0, pD+jj*bs, sdd, &d1, pD+jj*bs+ii*sdd, sdd, pD+jj*bs+ii*sdd, sdd, m-ii, jb);
+				if(jb>4)
+					kernel_sgemm_nn_16x4_vs_lib8(jj, &dm1, pD+ii*sdd, sdd, 0, pD+(jj+4)*bs, sdd, &d1, pD+(jj+4)*bs+ii*sdd, sdd, pD+(jj+4)*bs+ii*sdd, sdd, m-ii, jb-4);
+				}
+			if(ii<m)
+				{
+				if(jb>4)
+					kernel_sgemm_nn_8x8_vs_lib8(jj, &dm1, pD+ii*sdd, 0, pD+jj*bs, sdd, &d1, pD+jj*bs+ii*sdd, pD+jj*bs+ii*sdd, m-ii, jb);
+				else
+					kernel_sgemm_nn_8x4_vs_lib8(jj, &dm1, pD+ii*sdd, 0, pD+jj*bs, sdd, &d1, pD+jj*bs+ii*sdd, pD+jj*bs+ii*sdd, m-ii, jb);
+				}
+			}
+
+		if(jj>=m)
+			continue;
+
+		// factorize & find pivot
+		kernel_sgetrf_pivot_8_vs_lib8(m-jj, jb, pD+jj*bs+jj*sdd, sdd, &dD[jj], &ipiv[jj]);
+
+		// apply pivot
+		pb = m-jj<jb ? m-jj : jb;
+		for(kk=0; kk<pb; kk++)
+			{
+			ipiv[jj+kk] += jj;
+			if(ipiv[jj+kk]!=jj+kk)
+				{
+				srowsw_lib(jj, pD+(jj+kk)/bs*bs*sdd+(jj+kk)%bs, pD+(ipiv[jj+kk])/bs*bs*sdd+(ipiv[jj+kk])%bs);
+				srowsw_lib(n-jj-jb, pD+(jj+kk)/bs*bs*sdd+(jj+kk)%bs+(jj+jb)*bs, pD+(ipiv[jj+kk])/bs*bs*sdd+(ipiv[jj+kk])%bs+(jj+jb)*bs);
+				}
+			}
+		}
+
 	return;
+
 	}
 
 
@@ -0,0 +1,210 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2019 by Gianluca Frison.                                                          *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+
+
+// Multi-threaded gemm driver: the m x n iteration space is partitioned into a grid of
+// sub-blocks, and each thread calls the serial routine on its own sub-block.
+// The sub-block boundaries are placed at multiples of the row and column steps of the
+// macro-loops of the serial routine (taking into account the initial clean-up loops
+// for unaligned A and B), and the last sub-block along each direction is at least one
+// step long, so that every entry of D is computed by the same kernel and in the same
+// order as in the serial case, giving bit-identical results.
+
+
+
+// minimum number of flops (m*n*k) to use more than one thread
+#ifndef GEMM_MT_MIN_MNK
+#define GEMM_MT_MIN_MNK (64*64*64)
+#endif
+
+
+
+struct GEMM_MT_ARG
+	{
+	void (*gemm)(int, int, int, REAL, struct XMAT *, int, int, struct XMAT *, int, int, REAL, struct XMAT *, int, int, struct XMAT *, int, int);
+	struct XMAT *sA;
+	struct XMAT *sB;
+	struct XMAT *sC;
+	struct XMAT *sD;
+	REAL alpha;
+	REAL beta;
+	int m;
+	int n;
+	int k;
+	int ai;
+	int aj;
+	int bi;
+	int bj;
+	int ci;
+	int cj;
+	int di;
+	int dj;
+	int tran_b; // B^T: the column partition moves along the rows of B
+	int m_first; // length of the first row unit (0 if no clean-up is needed)
+	int n_first; // length of the first column unit (0 if no clean-up is needed)
+	int m_units;
+	int n_units;
+	int tm; // number of threads along the rows
+	int tn; // number of threads along the columns
+	};
+
+
+
+// number of units an interval of length size is divided into
+static int GEMM_MT_UNITS(int first, int grain, int size)
+	{
+	if(first>0)
+		{
+		return size-first>=grain ? 1+(size-first)/grain : 1;
+		}
+	return size>=2*grain ? size/grain : 1;
+	}
+
+
+
+// offset of the beginning of unit u; the last unit extends until size
+static int GEMM_MT_OFFSET(int u, int units, int first, int grain, int size)
+	{
+	if(u>=units)
+		return size;
+	if(first>0)
+		return u==0 ? 0 : first+(u-1)*grain;
+	return u*grain;
+	}
+
+
+
+static void GEMM_MT_WORK(int tid, int nt, void *ptr)
+	{
+	struct GEMM_MT_ARG *arg = ptr;
+
+	int im = tid / arg->tn;
+	int in = tid % arg->tn;
+	if(im>=arg->tm)
+		return;
+
+	int u0, u1;
+
+	u0 = im*arg->m_units/arg->tm;
+	u1 = (im+1)*arg->m_units/arg->tm;
+	int i0 = GEMM_MT_OFFSET(u0, arg->m_units, arg->m_first, GEMM_MT_M_GRAIN, arg->m);
+	int i1 = GEMM_MT_OFFSET(u1, arg->m_units, arg->m_first, GEMM_MT_M_GRAIN, arg->m);
+
+	u0 = in*arg->n_units/arg->tn;
+	u1 = (in+1)*arg->n_units/arg->tn;
+	int j0 = GEMM_MT_OFFSET(u0, arg->n_units, arg->n_first, GEMM_MT_N_GRAIN, arg->n);
+	int j1 = GEMM_MT_OFFSET(u1, arg->n_units, arg->n_first, GEMM_MT_N_GRAIN, arg->n);
+
+	if(i1<=i0 | j1<=j0)
+		return;
+
+	if(arg->tran_b)
+		{
+		arg->gemm(i1-i0, j1-j0, arg->k, arg->alpha, arg->sA, arg->ai+i0, arg->aj, arg->sB, arg->bi+j0, arg->bj, arg->beta, arg->sC, arg->ci+i0, arg->cj+j0, arg->sD, arg->di+i0, arg->dj+j0);
+		}
+	else
+		{
+		arg->gemm(i1-i0, j1-j0, arg->k, arg->alpha, arg->sA, arg->ai+i0, arg->aj, arg->sB, arg->bi, arg->bj+j0, arg->beta, arg->sC, arg->ci+i0, arg->cj+j0, arg->sD, arg->di+i0, arg->dj+j0);
+		}
+
+	return;
+	}
+
+
+
+// return 1 if the gemm has been computed by the thread pool, 0 if it has to be computed serially by the caller
+static int GEMM_MT(int tran_b, void (*gemm)(int, int, int, REAL, struct XMAT *, int, int, struct XMAT *, int, int, REAL, struct XMAT *, int, int, struct XMAT *, int, int), int m, int n, int k, REAL alpha, struct XMAT *sA, int ai, int aj, struct XMAT *sB, int bi, int bj, REAL beta, struct XMAT *sC, int ci, int cj, struct XMAT *sD, int di, int dj)
+	{
+	int nt = blasfeo_get_num_threads();
+	if(nt<=1 || blasfeo_thread_pool_in_parallel())
+		return 0;
+	if((double) m * n * k < (double) GEMM_MT_MIN_MNK)
+		return 0;
+
+	struct GEMM_MT_ARG arg;
+
+	int air = ai & (PS-1);
+	int bir = bi & (PS-1);
+
+	arg.m_first = air==0 ? 0 : GEMM_MT_M_FIRST-air;
+	arg.n_first = tran_b ? (PS-bir) & (PS-1) : 0;
+	arg.m_units = GEMM_MT_UNITS(arg.m_first, GEMM_MT_M_GRAIN, m);
+	arg.n_units = GEMM_MT_UNITS(arg.n_first, GEMM_MT_N_GRAIN, n);
+
+	// thread grid: maximize the number of busy threads, preferring column partitions
+	int tm, tn;
+	arg.tm = 1;
+	arg.tn = 1;
+	for(tn=(nt<arg.n_units ? nt : arg.n_units); tn>=1; tn--)
+		{
+		tm = nt/tn;
+		tm = tm<arg.m_units ? tm : arg.m_units;
+		if(tm*tn>arg.tm*arg.tn)
+			{
+			arg.tm = tm;
+			arg.tn = tn;
+			}
+		}
+	if(arg.tm*arg.tn<=1)
+		return 0;
+
+	arg.gemm = gemm;
+	arg.tran_b = tran_b;
+	arg.m = m;
+	arg.n = n;
+	arg.k = k;
+	arg.alpha = alpha;
+	arg.beta = beta;
+	arg.sA = sA;
+	arg.ai = ai;
+	arg.aj = aj;
+	arg.sB = sB;
+	arg.bi = bi;
+	arg.bj = bj;
+	arg.sC = sC;
+	arg.ci = ci;
+	arg.cj = cj;
+	arg.sD = sD;
+	arg.di = di;
+	arg.dj = dj;
+
+	// invalidate stored inverse diagonal of result matrix
+	sD->use_dA = 0;
+
+	blasfeo_thread_pool_run(arg.tm*arg.tn, GEMM_MT_WORK, &arg);
+
+	return 1;
+	}
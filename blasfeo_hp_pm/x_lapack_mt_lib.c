@@ -0,0 +1,582 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2019 by Gianluca Frison.                                                          *
+* Developed at IMTEK (University of Freiburg) under the supervision of Moritz Diehl.              *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+
+#if defined(POTRF_L_MT)
+
+
+
+// Multi-threaded tiled Cholesky factorization: the matrix is partitioned into square tiles,
+// and the tasks of the right-looking tiled algorithm (potrf of a diagonal tile, trsm of the
+// tiles below it, syrk/gemm updates of the trailing tiles) are executed as soon as their
+// dependencies are resolved. Each thread keeps its own list of ready tasks: the tasks released
+// by a thread are queued in its own list and executed in LIFO order (for data locality), while
+// an idle thread steals the oldest ready task from the list of another thread.
+// Each task calls the serial hp routine on a view of its tiles, hence the panel-major kernels.
+// At any time each tile has at most one ready or running task, so the dependencies are tracked
+// per tile and the ready lists are linked lists of tiles.
+
+
+
+// min matrix size to use more than one thread
+#ifndef POTRF_L_MT_MIN_M
+#define POTRF_L_MT_MIN_M (2*POTRF_L_MT_NB)
+#endif
+
+// max number of tiles along each dimension; larger matrices use larger tiles
+#define POTRF_L_MT_MAX_NT 64
+
+
+
+struct POTRF_L_MT_ARG
+	{
+	struct XMAT *sC;
+	struct XMAT *sD;
+	int cj;
+	int dj;
+	int m;
+	int nb; // tile size
+	int nt; // number of tiles along each dimension
+	int num_tasks;
+	int num_done;
+	int num_waiting;
+	pthread_mutex_t mutex;
+	pthread_cond_t cond;
+	int upd[POTRF_L_MT_MAX_NT*POTRF_L_MT_MAX_NT]; // number of updates applied to tile (ii,jj)
+	char fact[POTRF_L_MT_MAX_NT*POTRF_L_MT_MAX_NT]; // tile (ii,jj) is factorized
+	short next[POTRF_L_MT_MAX_NT*POTRF_L_MT_MAX_NT]; // ready lists
+	short prev[POTRF_L_MT_MAX_NT*POTRF_L_MT_MAX_NT];
+	short head[BLASFEO_MAX_NUM_THREADS]; // oldest ready tile
+	short tail[BLASFEO_MAX_NUM_THREADS]; // newest ready tile
+	};
+
+
+
+// view of the sub-matrix of sA starting at (ai,aj), with ai multiple of PS
+static void POTRF_L_MT_VIEW(struct XMAT *sA, int ai, int aj, struct XMAT *sV)
+	{
+	sV->mem = sA->mem;
+	sV->pA = sA->pA + ai*sA->cn + aj*PS;
+	sV->dA = sA->dA + ai;
+	sV->m = sA->m - ai;
+	sV->n = sA->n - aj;
+	sV->pm = sA->pm - ai;
+	sV->cn = sA->cn;
+	sV->use_dA = 0;
+	sV->memsize = 0;
+	return;
+	}
+
+
+
+// append tile t to the ready list of thread tid; to be called holding the mutex
+static void POTRF_L_MT_PUSH(struct POTRF_L_MT_ARG *arg, int tid, int t)
+	{
+	arg->next[t] = -1;
+	arg->prev[t] = arg->tail[tid];
+	if(arg->tail[tid]>=0)
+		arg->next[arg->tail[tid]] = t;
+	else
+		arg->head[tid] = t;
+	arg->tail[tid] = t;
+	return;
+	}
+
+
+
+// remove tile t from the ready list of thread tid; to be called holding the mutex
+static void POTRF_L_MT_REMOVE(struct POTRF_L_MT_ARG *arg, int tid, int t)
+	{
+	if(arg->prev[t]>=0)
+		arg->next[arg->prev[t]] = arg->next[t];
+	else
+		arg->head[tid] = arg->next[t];
+	if(arg->next[t]>=0)
+		arg->prev[arg->next[t]] = arg->prev[t];
+	else
+		arg->tail[tid] = arg->prev[t];
+	return;
+	}
+
+
+
+// execute the next task of tile (ii,jj)
+static void POTRF_L_MT_TASK(struct POTRF_L_MT_ARG *arg, int ii, int jj, int kk)
+	{
+	int nb = arg->nb;
+	int m = arg->m;
+	int i0 = ii*nb;
+	int j0 = jj*nb;
+	int k0 = kk*nb;
+	int mi = m-i0<nb ? m-i0 : nb;
+	int mj = m-j0<nb ? m-j0 : nb;
+	int mk = m-k0<nb ? m-k0 : nb;
+	struct XMAT sA, sB, sC, sD;
+
+	// the first task of each tile reads from C, the others update D in place
+	if(kk==0)
+		POTRF_L_MT_VIEW(arg->sC, i0, arg->cj+j0, &sC);
+	else
+		POTRF_L_MT_VIEW(arg->sD, i0, arg->dj+j0, &sC);
+	POTRF_L_MT_VIEW(arg->sD, i0, arg->dj+j0, &sD);
+
+	if(kk<jj)
+		{
+		// update with the factorized tiles (ii,kk) and (jj,kk)
+		POTRF_L_MT_VIEW(arg->sD, i0, arg->dj+k0, &sA);
+		if(ii==jj)
+			{
+			HP_SYRK_LN(mi, mk, -1.0, &sA, 0, 0, &sA, 0, 0, 1.0, &sC, 0, 0, &sD, 0, 0);
+			}
+		else
+			{
+			POTRF_L_MT_VIEW(arg->sD, j0, arg->dj+k0, &sB);
+			HP_GEMM_NT(mi, mj, mk, -1.0, &sA, 0, 0, &sB, 0, 0, 1.0, &sC, 0, 0, &sD, 0, 0);
+			}
+		}
+	else if(ii==jj)
+		{
+		HP_POTRF_L(mi, &sC, 0, 0, &sD, 0, 0);
+		}
+	else
+		{
+		// the inverse of the diagonal of tile (jj,jj) has been stored by its potrf
+		POTRF_L_MT_VIEW(arg->sD, j0, arg->dj+j0, &sA);
+		sA.use_dA = mj;
+		HP_TRSM_RLTN(mi, mj, 1.0, &sA, 0, 0, &sC, 0, 0, &sD, 0, 0);
+		}
+	return;
+	}
+
+
+
+// update the dependencies after the task kk of tile (ii,jj) is completed, and queue the released tiles to thread tid; to be called holding the mutex
+static int POTRF_L_MT_RELEASE(struct POTRF_L_MT_ARG *arg, int tid, int ii, int jj, int kk)
+	{
+	int nt = arg->nt;
+	int t = ii*nt+jj;
+	int i2, j2, t2;
+	int num_released = 0;
+	if(kk<jj)
+		{
+		// update
+		arg->upd[t] = kk+1;
+		if(kk+1<jj)
+			{
+			if(arg->fact[ii*nt+kk+1] & arg->fact[jj*nt+kk+1])
+				{
+				POTRF_L_MT_PUSH(arg, tid, t);
+				num_released++;
+				}
+			}
+		else if(ii==jj | arg->fact[jj*nt+jj])
+			{
+			POTRF_L_MT_PUSH(arg, tid, t);
+			num_released++;
+			}
+		}
+	else if(ii==jj)
+		{
+		// potrf: release the trsm of the tiles below
+		arg->fact[t] = 1;
+		for(i2=ii+1; i2<nt; i2++)
+			{
+			t2 = i2*nt+jj;
+			if(arg->upd[t2]==jj)
+				{
+				POTRF_L_MT_PUSH(arg, tid, t2);
+				num_released++;
+				}
+			}
+		}
+	else
+		{
+		// trsm: release the updates of the tiles in block row ii and block column ii
+		arg->fact[t] = 1;
+		for(j2=jj+1; j2<=ii; j2++)
+			{
+			t2 = ii*nt+j2;
+			if(arg->upd[t2]==jj & arg->fact[j2*nt+jj])
+				{
+				POTRF_L_MT_PUSH(arg, tid, t2);
+				num_released++;
+				}
+			}
+		for(i2=ii+1; i2<nt; i2++)
+			{
+			t2 = i2*nt+ii;
+			if(arg->upd[t2]==jj & arg->fact[i2*nt+jj])
+				{
+				POTRF_L_MT_PUSH(arg, tid, t2);
+				num_released++;
+				}
+			}
+		}
+	return num_released;
+	}
+
+
+
+static void POTRF_L_MT_WORK(int tid, int num_threads, void *ptr)
+	{
+	struct POTRF_L_MT_ARG *arg = ptr;
+	int nt = arg->nt;
+	int ii, jj, kk, t, tid2;
+
+	pthread_mutex_lock(&arg->mutex);
+	while(arg->num_done<arg->num_tasks)
+		{
+		// newest task from own list, or oldest task from the lists of the other threads
+		t = arg->tail[tid];
+		if(t>=0)
+			{
+			POTRF_L_MT_REMOVE(arg, tid, t);
+			}
+		else
+			{
+			for(tid2=(tid+1)%num_threads; tid2!=tid; tid2=(tid2+1)%num_threads)
+				{
+				t = arg->head[tid2];
+				if(t>=0)
+					{
+					POTRF_L_MT_REMOVE(arg, tid2, t);
+					break;
+					}
+				}
+			}
+		if(t<0)
+			{
+			arg->num_waiting++;
+			pthread_cond_wait(&arg->cond, &arg->mutex);
+			arg->num_waiting--;
+			continue;
+			}
+		ii = t/nt;
+		jj = t%nt;
+		kk = arg->upd[t];
+		pthread_mutex_unlock(&arg->mutex);
+
+		POTRF_L_MT_TASK(arg, ii, jj, kk);
+
+		pthread_mutex_lock(&arg->mutex);
+		arg->num_done++;
+		if(POTRF_L_MT_RELEASE(arg, tid, ii, jj, kk)>0 | arg->num_done==arg->num_tasks)
+			{
+			if(arg->num_waiting>0)
+				pthread_cond_broadcast(&arg->cond);
+			}
+		}
+	pthread_mutex_unlock(&arg->mutex);
+
+	return;
+	}
+
+
+
+// return 1 if the factorization has been computed by the thread pool, 0 if it has to be computed serially by the caller
+static int POTRF_L_MT(int m, struct XMAT *sC, int cj, struct XMAT *sD, int dj)
+	{
+	int num_threads = blasfeo_get_num_threads();
+	if(num_threads<=1 || blasfeo_thread_pool_in_parallel())
+		return 0;
+	if(m<POTRF_L_MT_MIN_M)
+		return 0;
+
+	struct POTRF_L_MT_ARG arg;
+	int ii;
+
+	int nb = POTRF_L_MT_NB;
+	if((m+nb-1)/nb>POTRF_L_MT_MAX_NT)
+		{
+		nb = (m+POTRF_L_MT_MAX_NT-1)/POTRF_L_MT_MAX_NT;
+		nb = (nb+POTRF_L_MT_NB-1)/POTRF_L_MT_NB*POTRF_L_MT_NB;
+		}
+	int nt = (m+nb-1)/nb;
+
+	arg.sC = sC;
+	arg.sD = sD;
+	arg.cj = cj;
+	arg.dj = dj;
+	arg.m = m;
+	arg.nb = nb;
+	arg.nt = nt;
+	// tile (ii,jj) has jj updates and one potrf or trsm
+	arg.num_tasks = nt*(nt+1)*(nt+2)/6;
+	arg.num_done = 0;
+	arg.num_waiting = 0;
+	for(ii=0; ii<nt*nt; ii++)
+		{
+		arg.upd[ii] = 0;
+		arg.fact[ii] = 0;
+		}
+	if(num_threads>nt*(nt+1)/2)
+		num_threads = nt*(nt+1)/2;
+	for(ii=0; ii<num_threads; ii++)
+		{
+		arg.head[ii] = -1;
+		arg.tail[ii] = -1;
+		}
+	pthread_mutex_init(&arg.mutex, NULL);
+	pthread_cond_init(&arg.cond, NULL);
+
+	// the only initially ready task is the potrf of the first diagonal tile
+	POTRF_L_MT_PUSH(&arg, 0, 0);
+
+	blasfeo_thread_pool_run(num_threads, POTRF_L_MT_WORK, &arg);
+
+	pthread_mutex_destroy(&arg.mutex);
+	pthread_cond_destroy(&arg.cond);
+
+	if(dj==0)
+		sD->use_dA = m;
+	else
+		sD->use_dA = 0;
+
+	return 1;
+	}
+
+
+
+#endif // POTRF_L_MT
+
+
+
+#if defined(GETRF_RP_MT)
+
+
+
+// Multi-threaded LU factorization with row pivoting: blocked right-looking algorithm with
+// panels of GETRF_RP_MT_NB columns and depth-1 lookahead. While the panel factorization of
+// block-column k+1 (latency bound) is performed by thread 0 right after updating that
+// block-column with panel k, the other threads apply panel k (row swaps, trsm and gemm) to
+// the rest of the trailing matrix. The row swaps of each panel are applied to the block-columns
+// on its left at the end of the factorization.
+// The panel factorization and the updates call the serial hp routines on panel-aligned views.
+
+
+
+// min matrix size to use more than one thread
+#ifndef GETRF_RP_MT_MIN_MN
+#define GETRF_RP_MT_MIN_MN (2*GETRF_RP_MT_NB)
+#endif
+
+
+
+struct GETRF_RP_MT_ARG
+	{
+	struct XMAT *sD;
+	int *ipiv;
+	int dj;
+	int m;
+	int n;
+	int p; // min(m,n)
+	int nb; // panel size
+	int k0; // first column of the factorized panel
+	int k1; // end of the factorized panel
+	int n1; // end of the lookahead panel (starting at k1)
+	int units; // number of column units in the rest of the trailing matrix (starting at n1)
+	};
+
+
+
+// view of the sub-matrix of sA starting at (ai,aj), with ai multiple of PS
+static void GETRF_RP_MT_VIEW(struct XMAT *sA, int ai, int aj, struct XMAT *sV)
+	{
+	sV->mem = sA->mem;
+	sV->pA = sA->pA + ai*sA->cn + aj*PS;
+	sV->dA = sA->dA + ai;
+	sV->m = sA->m - ai;
+	sV->n = sA->n - aj;
+	sV->pm = sA->pm - ai;
+	sV->cn = sA->cn;
+	sV->use_dA = 0;
+	sV->memsize = 0;
+	return;
+	}
+
+
+
+// factorize the panel of columns [k0,k1)
+static void GETRF_RP_MT_PANEL(struct GETRF_RP_MT_ARG *arg, int k0, int k1)
+	{
+	struct XMAT sP;
+	int ii;
+	GETRF_RP_MT_VIEW(arg->sD, k0, arg->dj+k0, &sP);
+	HP_GETRF_RP(arg->m-k0, k1-k0, &sP, 0, 0, &sP, 0, 0, arg->ipiv+k0);
+	for(ii=k0; ii<k1; ii++)
+		arg->ipiv[ii] += k0;
+	return;
+	}
+
+
+
+// apply the factorized panel [k0,k1) to the columns [j0,j1) of the trailing matrix
+static void GETRF_RP_MT_UPDATE(struct GETRF_RP_MT_ARG *arg, int j0, int j1)
+	{
+	if(j1<=j0)
+		return;
+	struct XMAT *sD = arg->sD;
+	int *ipiv = arg->ipiv;
+	int dj = arg->dj;
+	int m = arg->m;
+	int k0 = arg->k0;
+	int k1 = arg->k1;
+	struct XMAT sV, sL, sU, sA, sB;
+	int ii;
+	// row swaps
+	GETRF_RP_MT_VIEW(sD, 0, dj+j0, &sV);
+	for(ii=k0; ii<k1; ii++)
+		{
+		if(ipiv[ii]!=ii)
+			ROWSW(j1-j0, &sV, ii, 0, &sV, ipiv[ii], 0);
+		}
+	// U_12 <= L_11^{-1} A_12
+	GETRF_RP_MT_VIEW(sD, k0, dj+k0, &sL);
+	GETRF_RP_MT_VIEW(sD, k0, dj+j0, &sU);
+	HP_TRSM_LLNU(k1-k0, j1-j0, 1.0, &sL, 0, 0, &sU, 0, 0, &sU, 0, 0);
+	// A_22 <= A_22 - L_21 U_12
+	if(m>k1)
+		{
+		GETRF_RP_MT_VIEW(sD, k1, dj+k0, &sA);
+		GETRF_RP_MT_VIEW(sD, k1, dj+j0, &sB);
+		HP_GEMM_NN(m-k1, j1-j0, k1-k0, -1.0, &sA, 0, 0, &sU, 0, 0, 1.0, &sB, 0, 0, &sB, 0, 0);
+		}
+	return;
+	}
+
+
+
+static void GETRF_RP_MT_WORK(int tid, int num_threads, void *ptr)
+	{
+	struct GETRF_RP_MT_ARG *arg = ptr;
+	int j0, j1;
+	if(tid==0)
+		{
+		// lookahead: update and factorize the next panel
+		GETRF_RP_MT_UPDATE(arg, arg->k1, arg->n1);
+		if(arg->n1>arg->k1 & arg->k1<arg->p)
+			GETRF_RP_MT_PANEL(arg, arg->k1, arg->n1);
+		}
+	else
+		{
+		// update the rest of the trailing matrix
+		j0 = arg->n1 + (tid-1)*arg->units/(num_threads-1)*GETRF_RP_MT_N_GRAIN;
+		j1 = arg->n1 + tid*arg->units/(num_threads-1)*GETRF_RP_MT_N_GRAIN;
+		j1 = j1<arg->n ? j1 : arg->n;
+		GETRF_RP_MT_UPDATE(arg, j0, j1);
+		}
+	return;
+	}
+
+
+
+// apply the row swaps of the following panels to the panels on their left
+static void GETRF_RP_MT_SWAP_WORK(int tid, int num_threads, void *ptr)
+	{
+	struct GETRF_RP_MT_ARG *arg = ptr;
+	int nb = arg->nb;
+	struct XMAT sV;
+	int jj, j1, ii;
+	for(jj=tid*nb; jj<arg->p; jj+=num_threads*nb)
+		{
+		j1 = jj+nb<arg->p ? jj+nb : arg->p;
+		GETRF_RP_MT_VIEW(arg->sD, 0, arg->dj+jj, &sV);
+		for(ii=j1; ii<arg->p; ii++)
+			{
+			if(arg->ipiv[ii]!=ii)
+				ROWSW(j1-jj, &sV, ii, 0, &sV, arg->ipiv[ii], 0);
+			}
+		}
+	return;
+	}
+
+
+
+// return 1 if the factorization has been computed by the thread pool, 0 if it has to be computed serially by the caller
+static int GETRF_RP_MT(int m, int n, struct XMAT *sC, int cj, struct XMAT *sD, int dj, int *ipiv)
+	{
+	int num_threads = blasfeo_get_num_threads();
+	if(num_threads<=1 || blasfeo_thread_pool_in_parallel())
+		return 0;
+	if(m<GETRF_RP_MT_MIN_MN | n<GETRF_RP_MT_MIN_MN)
+		return 0;
+
+	struct GETRF_RP_MT_ARG arg;
+	int nt, num_panels;
+
+	int nb = GETRF_RP_MT_NB;
+	int p = m<n ? m : n;
+
+	// needs to perform row exchanges on the yet-to-be-factorized matrix too
+	if(sC!=sD | cj!=dj)
+		GECP(m, n, sC, 0, cj, sD, 0, dj);
+
+	arg.sD = sD;
+	arg.ipiv = ipiv;
+	arg.dj = dj;
+	arg.m = m;
+	arg.n = n;
+	arg.p = p;
+	arg.nb = nb;
+
+	GETRF_RP_MT_PANEL(&arg, 0, nb);
+
+	for(arg.k0=0; arg.k0<p; arg.k0=arg.k1)
+		{
+		arg.k1 = arg.k0+nb<p ? arg.k0+nb : p;
+		if(arg.k1>=n)
+			break;
+		arg.n1 = arg.k1+nb<p ? arg.k1+nb : p;
+		arg.n1 = arg.n1>arg.k1 ? arg.n1 : arg.k1;
+		arg.units = (n-arg.n1+GETRF_RP_MT_N_GRAIN-1)/GETRF_RP_MT_N_GRAIN;
+		nt = num_threads<1+arg.units ? num_threads : 1+arg.units;
+		blasfeo_thread_pool_run(nt, GETRF_RP_MT_WORK, &arg);
+		}
+
+	num_panels = (p+nb-1)/nb;
+	nt = num_threads<num_panels ? num_threads : num_panels;
+	blasfeo_thread_pool_run(nt, GETRF_RP_MT_SWAP_WORK, &arg);
+
+	if(dj==0)
+		sD->use_dA = 1;
+	else
+		sD->use_dA = 0;
+
+	return 1;
+	}
+
+
+
+#endif // GETRF_RP_MT
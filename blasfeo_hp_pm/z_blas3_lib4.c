@@ -0,0 +1,344 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2019 by Gianluca Frison.                                                          *
+* Developed at IMTEK (University of Freiburg) under the supervision of Moritz Diehl.              *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#include <blasfeo_common.h>
+#include <blasfeo_block_size.h>
+#include <blasfeo_align.h>
+#include <blasfeo_stdlib.h>
+#include <blasfeo_z_aux.h>
+#include <blasfeo_z_kernel.h>
+#include <blasfeo_z_blasfeo_api.h>
+
+
+
+#define ZMATEL_RE BLASFEO_ZMATEL_RE
+#define ZMATEL_IM BLASFEO_ZMATEL_IM
+
+
+
+// transposition of B in zgemm
+#define ZGEMM_N 0
+#define ZGEMM_T 1
+#define ZGEMM_C 2
+
+
+
+// D <= beta * C + alpha * A * op(B)
+static void zgemm_lib4(int tran, int m, int n, int k, double *alpha, struct blasfeo_zmat *sA, int ai, int aj, struct blasfeo_zmat *sB, int bi, int bj, double *beta, struct blasfeo_zmat *sC, int ci, int cj, struct blasfeo_zmat *sD, int di, int dj)
+	{
+
+	if(m<=0 | n<=0)
+		return;
+
+	const int ps = Z_PS; // 4
+
+	int ii, jj, ll, rr, m1, n1;
+	double tr, ti;
+
+	ALIGNED( double tmp[2*Z_PS*Z_PS], 64 );
+	double zero[2] = {0.0, 0.0};
+
+	// the kernels need A, and B^T in nt and nc, aligned to the top of a panel, and full 4-column blocks of B in nn
+	// (i.e. B aligned to the first column of a panel block): else pack them
+	struct blasfeo_zmat sAt, sBt;
+	void *mem = NULL;
+	char *mem_align;
+	int pack_A = (ai&(ps-1))!=0 & k>0;
+	int pack_B = (tran==ZGEMM_N ? (bj&(ps-1))!=0 : (bi&(ps-1))!=0) & k>0;
+	if(pack_A | pack_B)
+		{
+		size_t mem_size = (pack_A ? blasfeo_memsize_zmat(m, k) : 0) + (pack_B ? blasfeo_memsize_zmat(n, k) : 0);
+		blasfeo_ws_malloc(&mem, mem_size+64);
+		if(mem==NULL)
+			return;
+		blasfeo_align_64_byte(mem, (void **) &mem_align);
+		if(pack_A)
+			{
+			blasfeo_create_zmat(m, k, &sAt, (void *) mem_align);
+			mem_align += sAt.memsize;
+			blasfeo_zgecp(m, k, sA, ai, aj, &sAt, 0, 0);
+			sA = &sAt;
+			ai = 0;
+			aj = 0;
+			}
+		if(pack_B & tran==ZGEMM_N)
+			{
+			blasfeo_create_zmat(k, n, &sBt, (void *) mem_align);
+			blasfeo_zgecp(k, n, sB, bi, bj, &sBt, 0, 0);
+			sB = &sBt;
+			bi = 0;
+			bj = 0;
+			}
+		else if(pack_B)
+			{
+			blasfeo_create_zmat(n, k, &sBt, (void *) mem_align);
+			blasfeo_zgecp(n, k, sB, bi, bj, &sBt, 0, 0);
+			sB = &sBt;
+			bi = 0;
+			bj = 0;
+			}
+		}
+
+	int offB = bi&(ps-1);
+	int sdb = sB->cn;
+	double *pB;
+	// C and D in the same position in their panel: the kernels read C and write D directly
+	int direct = (ci&(ps-1))==0 & (di&(ps-1))==0;
+
+	for(ii=0; ii<m; ii+=ps)
+		{
+		m1 = m-ii<ps ? m-ii : ps;
+		for(jj=0; jj<n; jj+=ps)
+			{
+			n1 = n-jj<ps ? n-jj : ps;
+			if(tran==ZGEMM_N)
+				pB = &ZMATEL_RE(sB, bi-offB, bj+jj);
+			else // the rows of B are the columns of the result
+				pB = &ZMATEL_RE(sB, bi+jj, bj);
+			if(direct)
+				{
+				if(m1==ps & n1==ps)
+					{
+					if(tran==ZGEMM_N)
+						kernel_zgemm_nn_4x4_lib4(k, alpha, &ZMATEL_RE(sA, ai+ii, aj), offB, pB, sdb, beta, &ZMATEL_RE(sC, ci+ii, cj+jj), &ZMATEL_RE(sD, di+ii, dj+jj));
+					else if(tran==ZGEMM_T)
+						kernel_zgemm_nt_4x4_lib4(k, alpha, &ZMATEL_RE(sA, ai+ii, aj), pB, beta, &ZMATEL_RE(sC, ci+ii, cj+jj), &ZMATEL_RE(sD, di+ii, dj+jj));
+					else
+						kernel_zgemm_nc_4x4_lib4(k, alpha, &ZMATEL_RE(sA, ai+ii, aj), pB, beta, &ZMATEL_RE(sC, ci+ii, cj+jj), &ZMATEL_RE(sD, di+ii, dj+jj));
+					}
+				else
+					{
+					if(tran==ZGEMM_N)
+						kernel_zgemm_nn_4x4_vs_lib4(k, alpha, &ZMATEL_RE(sA, ai+ii, aj), offB, pB, sdb, beta, &ZMATEL_RE(sC, ci+ii, cj+jj), &ZMATEL_RE(sD, di+ii, dj+jj), m1, n1);
+					else if(tran==ZGEMM_T)
+						kernel_zgemm_nt_4x4_vs_lib4(k, alpha, &ZMATEL_RE(sA, ai+ii, aj), pB, beta, &ZMATEL_RE(sC, ci+ii, cj+jj), &ZMATEL_RE(sD, di+ii, dj+jj), m1, n1);
+					else
+						kernel_zgemm_nc_4x4_vs_lib4(k, alpha, &ZMATEL_RE(sA, ai+ii, aj), pB, beta, &ZMATEL_RE(sC, ci+ii, cj+jj), &ZMATEL_RE(sD, di+ii, dj+jj), m1, n1);
+					}
+				}
+			else
+				{
+				// alpha * A * op(B) in a local block, then add beta * C by element
+				if(tran==ZGEMM_N)
+					kernel_zgemm_nn_4x4_lib4(k, alpha, &ZMATEL_RE(sA, ai+ii, aj), offB, pB, sdb, zero, tmp, tmp);
+				else if(tran==ZGEMM_T)
+					kernel_zgemm_nt_4x4_lib4(k, alpha, &ZMATEL_RE(sA, ai+ii, aj), pB, zero, tmp, tmp);
+				else
+					kernel_zgemm_nc_4x4_lib4(k, alpha, &ZMATEL_RE(sA, ai+ii, aj), pB, zero, tmp, tmp);
+				for(ll=0; ll<n1; ll++)
+					{
+					for(rr=0; rr<m1; rr++)
+						{
+						tr = tmp[2*rr+0+2*ps*ll];
+						ti = tmp[2*rr+1+2*ps*ll];
+						if(beta[0]!=0.0 | beta[1]!=0.0)
+							{
+							tr += beta[0]*ZMATEL_RE(sC, ci+ii+rr, cj+jj+ll) - beta[1]*ZMATEL_IM(sC, ci+ii+rr, cj+jj+ll);
+							ti += beta[0]*ZMATEL_IM(sC, ci+ii+rr, cj+jj+ll) + beta[1]*ZMATEL_RE(sC, ci+ii+rr, cj+jj+ll);
+							}
+						ZMATEL_RE(sD, di+ii+rr, dj+jj+ll) = tr;
+						ZMATEL_IM(sD, di+ii+rr, dj+jj+ll) = ti;
+						}
+					}
+				}
+			}
+		}
+
+	if(mem!=NULL)
+		blasfeo_ws_free(mem);
+
+	return;
+
+	}
+
+
+
+void blasfeo_zgemm_nn(int m, int n, int k, double *alpha, struct blasfeo_zmat *sA, int ai, int aj, struct blasfeo_zmat *sB, int bi, int bj, double *beta, struct blasfeo_zmat *sC, int ci, int cj, struct blasfeo_zmat *sD, int di, int dj)
+	{
+	zgemm_lib4(ZGEMM_N, m, n, k, alpha, sA, ai, aj, sB, bi, bj, beta, sC, ci, cj, sD, di, dj);
+	return;
+	}
+
+
+
+void blasfeo_zgemm_nt(int m, int n, int k, double *alpha, struct blasfeo_zmat *sA, int ai, int aj, struct blasfeo_zmat *sB, int bi, int bj, double *beta, struct blasfeo_zmat *sC, int ci, int cj, struct blasfeo_zmat *sD, int di, int dj)
+	{
+	zgemm_lib4(ZGEMM_T, m, n, k, alpha, sA, ai, aj, sB, bi, bj, beta, sC, ci, cj, sD, di, dj);
+	return;
+	}
+
+
+
+void blasfeo_zgemm_nc(int m, int n, int k, double *alpha, struct blasfeo_zmat *sA, int ai, int aj, struct blasfeo_zmat *sB, int bi, int bj, double *beta, struct blasfeo_zmat *sC, int ci, int cj, struct blasfeo_zmat *sD, int di, int dj)
+	{
+	zgemm_lib4(ZGEMM_C, m, n, k, alpha, sA, ai, aj, sB, bi, bj, beta, sC, ci, cj, sD, di, dj);
+	return;
+	}
+
+
+
+// triangular solves by element: D can be the same as B
+
+// D <= A^{-1} * B , with A lower triangular with unit diagonal
+void blasfeo_ztrsm_llnu(int m, int n, struct blasfeo_zmat *sA, int ai, int aj, struct blasfeo_zmat *sB, int bi, int bj, struct blasfeo_zmat *sD, int di, int dj)
+	{
+	int ii, jj, ll;
+	double ar, aa, xr, xi;
+	if(sB!=sD | bi!=di | bj!=dj)
+		blasfeo_zgecp(m, n, sB, bi, bj, sD, di, dj);
+	for(jj=0; jj<n; jj++)
+		{
+		for(ll=0; ll<m; ll++)
+			{
+			xr = ZMATEL_RE(sD, di+ll, dj+jj);
+			xi = ZMATEL_IM(sD, di+ll, dj+jj);
+			for(ii=ll+1; ii<m; ii++)
+				{
+				ar = ZMATEL_RE(sA, ai+ii, aj+ll);
+				aa = ZMATEL_IM(sA, ai+ii, aj+ll);
+				ZMATEL_RE(sD, di+ii, dj+jj) -= ar*xr - aa*xi;
+				ZMATEL_IM(sD, di+ii, dj+jj) -= ar*xi + aa*xr;
+				}
+			}
+		}
+	return;
+	}
+
+
+
+// D <= A^{-1} * B , with A lower triangular
+void blasfeo_ztrsm_llnn(int m, int n, struct blasfeo_zmat *sA, int ai, int aj, struct blasfeo_zmat *sB, int bi, int bj, struct blasfeo_zmat *sD, int di, int dj)
+	{
+	int ii, jj, ll;
+	double ar, aa, xr, xi, dd;
+	if(sB!=sD | bi!=di | bj!=dj)
+		blasfeo_zgecp(m, n, sB, bi, bj, sD, di, dj);
+	for(jj=0; jj<n; jj++)
+		{
+		for(ll=0; ll<m; ll++)
+			{
+			// x <= x / a_ll
+			ar = ZMATEL_RE(sA, ai+ll, aj+ll);
+			aa = ZMATEL_IM(sA, ai+ll, aj+ll);
+			dd = 1.0 / (ar*ar + aa*aa);
+			xr = ZMATEL_RE(sD, di+ll, dj+jj);
+			xi = ZMATEL_IM(sD, di+ll, dj+jj);
+			ZMATEL_RE(sD, di+ll, dj+jj) = (xr*ar + xi*aa) * dd;
+			ZMATEL_IM(sD, di+ll, dj+jj) = (xi*ar - xr*aa) * dd;
+			xr = ZMATEL_RE(sD, di+ll, dj+jj);
+			xi = ZMATEL_IM(sD, di+ll, dj+jj);
+			for(ii=ll+1; ii<m; ii++)
+				{
+				ar = ZMATEL_RE(sA, ai+ii, aj+ll);
+				aa = ZMATEL_IM(sA, ai+ii, aj+ll);
+				ZMATEL_RE(sD, di+ii, dj+jj) -= ar*xr - aa*xi;
+				ZMATEL_IM(sD, di+ii, dj+jj) -= ar*xi + aa*xr;
+				}
+			}
+		}
+	return;
+	}
+
+
+
+// D <= A^{-1} * B , with A upper triangular
+void blasfeo_ztrsm_lunn(int m, int n, struct blasfeo_zmat *sA, int ai, int aj, struct blasfeo_zmat *sB, int bi, int bj, struct blasfeo_zmat *sD, int di, int dj)
+	{
+	int ii, jj, ll;
+	double ar, aa, xr, xi, dd;
+	if(sB!=sD | bi!=di | bj!=dj)
+		blasfeo_zgecp(m, n, sB, bi, bj, sD, di, dj);
+	for(jj=0; jj<n; jj++)
+		{
+		for(ll=m-1; ll>=0; ll--)
+			{
+			// x <= x / a_ll
+			ar = ZMATEL_RE(sA, ai+ll, aj+ll);
+			aa = ZMATEL_IM(sA, ai+ll, aj+ll);
+			dd = 1.0 / (ar*ar + aa*aa);
+			xr = ZMATEL_RE(sD, di+ll, dj+jj);
+			xi = ZMATEL_IM(sD, di+ll, dj+jj);
+			ZMATEL_RE(sD, di+ll, dj+jj) = (xr*ar + xi*aa) * dd;
+			ZMATEL_IM(sD, di+ll, dj+jj) = (xi*ar - xr*aa) * dd;
+			xr = ZMATEL_RE(sD, di+ll, dj+jj);
+			xi = ZMATEL_IM(sD, di+ll, dj+jj);
+			for(ii=0; ii<ll; ii++)
+				{
+				ar = ZMATEL_RE(sA, ai+ii, aj+ll);
+				aa = ZMATEL_IM(sA, ai+ii, aj+ll);
+				ZMATEL_RE(sD, di+ii, dj+jj) -= ar*xr - aa*xi;
+				ZMATEL_IM(sD, di+ii, dj+jj) -= ar*xi + aa*xr;
+				}
+			}
+		}
+	return;
+	}
+
+
+
+// D <= A^{-H} * B , with A lower triangular
+void blasfeo_ztrsm_llcn(int m, int n, struct blasfeo_zmat *sA, int ai, int aj, struct blasfeo_zmat *sB, int bi, int bj, struct blasfeo_zmat *sD, int di, int dj)
+	{
+	int ii, jj, ll;
+	double ar, aa, xr, xi, dd;
+	if(sB!=sD | bi!=di | bj!=dj)
+		blasfeo_zgecp(m, n, sB, bi, bj, sD, di, dj);
+	for(jj=0; jj<n; jj++)
+		{
+		for(ll=m-1; ll>=0; ll--)
+			{
+			// x_l <= (x_l - sum_{i>l} conj(a_il) * x_i) / conj(a_ll)
+			xr = ZMATEL_RE(sD, di+ll, dj+jj);
+			xi = ZMATEL_IM(sD, di+ll, dj+jj);
+			for(ii=ll+1; ii<m; ii++)
+				{
+				ar = ZMATEL_RE(sA, ai+ii, aj+ll);
+				aa = ZMATEL_IM(sA, ai+ii, aj+ll);
+				xr -= ar*ZMATEL_RE(sD, di+ii, dj+jj) + aa*ZMATEL_IM(sD, di+ii, dj+jj);
+				xi -= ar*ZMATEL_IM(sD, di+ii, dj+jj) - aa*ZMATEL_RE(sD, di+ii, dj+jj);
+				}
+			ar = ZMATEL_RE(sA, ai+ll, aj+ll);
+			aa = - ZMATEL_IM(sA, ai+ll, aj+ll);
+			dd = 1.0 / (ar*ar + aa*aa);
+			ZMATEL_RE(sD, di+ll, dj+jj) = (xr*ar + xi*aa) * dd;
+			ZMATEL_IM(sD, di+ll, dj+jj) = (xi*ar - xr*aa) * dd;
+			}
+		}
+	return;
+	}
+
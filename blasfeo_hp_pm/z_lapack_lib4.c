@@ -0,0 +1,215 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2019 by Gianluca Frison.                                                          *
+* Developed at IMTEK (University of Freiburg) under the supervision of Moritz Diehl.              *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+
+#include <blasfeo_common.h>
+#include <blasfeo_block_size.h>
+#include <blasfeo_align.h>
+#include <blasfeo_stdlib.h>
+#include <blasfeo_z_aux.h>
+#include <blasfeo_z_kernel.h>
+#include <blasfeo_z_blasfeo_api.h>
+
+
+
+#define ZMATEL_RE BLASFEO_ZMATEL_RE
+#define ZMATEL_IM BLASFEO_ZMATEL_IM
+
+
+
+// cholesky factorization, left-looking by blocks of 4 columns, fused with the zgemm kernel
+void blasfeo_zpotrf_l(int m, struct blasfeo_zmat *sC, int ci, int cj, struct blasfeo_zmat *sD, int di, int dj)
+	{
+
+	if(m<=0)
+		return;
+
+	const int ps = Z_PS; // 4
+
+	int ii, jj, n1;
+
+	double inv_diag_D[Z_PS];
+
+	// the kernels need C and D aligned to the top of a panel: else factorize an aligned copy
+	struct blasfeo_zmat sT, *sDo = sD;
+	void *mem = NULL;
+	char *mem_align;
+	int dio = di, djo = dj;
+	if((ci&(ps-1))!=0 | (di&(ps-1))!=0)
+		{
+		blasfeo_ws_malloc(&mem, blasfeo_memsize_zmat(m, m)+64);
+		if(mem==NULL)
+			return;
+		blasfeo_align_64_byte(mem, (void **) &mem_align);
+		blasfeo_create_zmat(m, m, &sT, (void *) mem_align);
+		for(jj=0; jj<m; jj++)
+			blasfeo_zgecp(m-jj, 1, sC, ci+jj, cj+jj, &sT, jj, jj);
+		sC = &sT;
+		ci = 0;
+		cj = 0;
+		sD = &sT;
+		di = 0;
+		dj = 0;
+		}
+
+	for(jj=0; jj<m; jj+=ps)
+		{
+		n1 = m-jj<ps ? m-jj : ps;
+		// diagonal block
+		if(n1==ps)
+			kernel_zpotrf_nc_l_4x4_lib4(jj, &ZMATEL_RE(sD, di+jj, dj), &ZMATEL_RE(sD, di+jj, dj), &ZMATEL_RE(sC, ci+jj, cj+jj), &ZMATEL_RE(sD, di+jj, dj+jj), inv_diag_D);
+		else
+			kernel_zpotrf_nc_l_4x4_vs_lib4(jj, &ZMATEL_RE(sD, di+jj, dj), &ZMATEL_RE(sD, di+jj, dj), &ZMATEL_RE(sC, ci+jj, cj+jj), &ZMATEL_RE(sD, di+jj, dj+jj), inv_diag_D, n1, n1);
+		// sub-diagonal blocks
+		for(ii=jj+ps; ii<m-ps+1; ii+=ps)
+			{
+			kernel_ztrsm_nc_rl_inv_4x4_lib4(jj, &ZMATEL_RE(sD, di+ii, dj), &ZMATEL_RE(sD, di+jj, dj), &ZMATEL_RE(sC, ci+ii, cj+jj), &ZMATEL_RE(sD, di+ii, dj+jj), &ZMATEL_RE(sD, di+jj, dj+jj), inv_diag_D);
+			}
+		if(ii<m)
+			{
+			kernel_ztrsm_nc_rl_inv_4x4_vs_lib4(jj, &ZMATEL_RE(sD, di+ii, dj), &ZMATEL_RE(sD, di+jj, dj), &ZMATEL_RE(sC, ci+ii, cj+jj), &ZMATEL_RE(sD, di+ii, dj+jj), &ZMATEL_RE(sD, di+jj, dj+jj), inv_diag_D, m-ii, n1);
+			}
+		}
+
+	if(mem!=NULL)
+		{
+		for(jj=0; jj<m; jj++)
+			blasfeo_zgecp(m-jj, 1, &sT, jj, jj, sDo, dio+jj, djo+jj);
+		blasfeo_ws_free(mem);
+		}
+
+	return;
+
+	}
+
+
+
+// LU factorization with row pivoting, left-looking by blocks of 4 columns, fused with the zgemm kernel
+void blasfeo_zgetrf_rp(int m, int n, struct blasfeo_zmat *sC, int ci, int cj, struct blasfeo_zmat *sD, int di, int dj, int *ipiv)
+	{
+
+	if(m<=0 | n<=0)
+		return;
+
+	const int ps = Z_PS; // 4
+
+	int ii, jj, ll, m1, n1, kk, p;
+	double *pD;
+
+	double inv_diag_D[2*Z_PS];
+
+	double alpha[2] = {-1.0, 0.0};
+	double beta[2] = {1.0, 0.0};
+
+	// the kernels need D aligned to the top of a panel and to the first column of a 4-column block: else factorize an aligned copy
+	struct blasfeo_zmat sT, *sDo = sD;
+	void *mem = NULL;
+	char *mem_align;
+	int dio = di, djo = dj;
+	if((di&(ps-1))!=0 | (dj&(ps-1))!=0)
+		{
+		blasfeo_ws_malloc(&mem, blasfeo_memsize_zmat(m, n)+64);
+		if(mem==NULL)
+			return;
+		blasfeo_align_64_byte(mem, (void **) &mem_align);
+		blasfeo_create_zmat(m, n, &sT, (void *) mem_align);
+		sD = &sT;
+		di = 0;
+		dj = 0;
+		}
+	if(sC!=sD | ci!=di | cj!=dj)
+		blasfeo_zgecp(m, n, sC, ci, cj, sD, di, dj);
+
+	int sdd = sD->cn;
+	pD = &ZMATEL_RE(sD, di, dj);
+
+	// minimum matrix size
+	p = n<m ? n : m;
+
+	for(jj=0; jj<n; jj+=ps)
+		{
+		n1 = n-jj<ps ? n-jj : ps;
+		kk = jj<m ? jj : m;
+
+		// upper part: solve with the unit lower triangular factor computed so far
+		for(ii=0; ii<kk; ii+=ps)
+			{
+			m1 = kk-ii<ps ? kk-ii : ps;
+			if(m1==ps & n1==ps)
+				kernel_ztrsm_nn_ll_one_4x4_lib4(ii, pD+2*ii*sdd, pD+2*jj*ps, sdd, pD+2*jj*ps+2*ii*sdd, pD+2*jj*ps+2*ii*sdd, pD+2*ii*ps+2*ii*sdd);
+			else
+				kernel_ztrsm_nn_ll_one_4x4_vs_lib4(ii, pD+2*ii*sdd, pD+2*jj*ps, sdd, pD+2*jj*ps+2*ii*sdd, pD+2*jj*ps+2*ii*sdd, pD+2*ii*ps+2*ii*sdd, m1, n1);
+			}
+
+		if(jj>=m)
+			continue;
+
+		// lower part: update
+		for(ii=jj; ii<m; ii+=ps)
+			{
+			m1 = m-ii<ps ? m-ii : ps;
+			if(m1==ps & n1==ps)
+				kernel_zgemm_nn_4x4_lib4(jj, alpha, pD+2*ii*sdd, 0, pD+2*jj*ps, sdd, beta, pD+2*jj*ps+2*ii*sdd, pD+2*jj*ps+2*ii*sdd);
+			else
+				kernel_zgemm_nn_4x4_vs_lib4(jj, alpha, pD+2*ii*sdd, 0, pD+2*jj*ps, sdd, beta, pD+2*jj*ps+2*ii*sdd, pD+2*jj*ps+2*ii*sdd, m1, n1);
+			}
+
+		// lower part: factorize the block column, and apply its row swaps to the other columns
+		kernel_zgetrf_pivot_4_vs_lib4(m-jj, pD+2*jj*ps+2*jj*sdd, sdd, inv_diag_D, ipiv+jj, n1);
+		for(ll=0; ll<n1 & jj+ll<p; ll++)
+			{
+			ipiv[jj+ll] += jj;
+			if(ipiv[jj+ll]!=jj+ll)
+				{
+				ii = ipiv[jj+ll];
+				kernel_zrowsw_lib4(jj, pD+2*((jj+ll)-((jj+ll)&(ps-1)))*sdd+2*((jj+ll)&(ps-1)), pD+2*(ii-(ii&(ps-1)))*sdd+2*(ii&(ps-1)));
+				kernel_zrowsw_lib4(n-jj-n1, pD+2*((jj+ll)-((jj+ll)&(ps-1)))*sdd+2*((jj+ll)&(ps-1))+2*(jj+n1)*ps, pD+2*(ii-(ii&(ps-1)))*sdd+2*(ii&(ps-1))+2*(jj+n1)*ps);
+				}
+			}
+		}
+
+	if(mem!=NULL)
+		{
+		blasfeo_zgecp(m, n, &sT, 0, 0, sDo, dio, djo);
+		blasfeo_ws_free(mem);
+		}
+
+	return;
+
+	}
+
@@ -60,6 +60,7 @@
 
 #define REAL double
 #define XMAT blasfeo_dmat
+#define XMATEL BLASFEO_DMATEL
 #define XVEC blasfeo_dvec
 
 
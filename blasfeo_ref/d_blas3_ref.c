@@ -118,6 +118,11 @@
 #define REF_SYR2K_LT blasfeo_ref_dsyr2k_lt
 #define REF_SYR2K_UN blasfeo_ref_dsyr2k_un
 #define REF_SYR2K_UT blasfeo_ref_dsyr2k_ut
+// symm
+#define REF_SYMM_LL blasfeo_ref_dsymm_ll
+#define REF_SYMM_LU blasfeo_ref_dsymm_lu
+#define REF_SYMM_RL blasfeo_ref_dsymm_rl
+#define REF_SYMM_RU blasfeo_ref_dsymm_ru
 
 // gemm
 #define GEMM_NN blasfeo_dgemm_nn
@@ -169,6 +174,11 @@
 #define SYR2K_LT blasfeo_dsyr2k_lt
 #define SYR2K_UN blasfeo_dsyr2k_un
 #define SYR2K_UT blasfeo_dsyr2k_ut
+// symm
+#define SYMM_LL blasfeo_dsymm_ll
+#define SYMM_LU blasfeo_dsymm_lu
+#define SYMM_RL blasfeo_dsymm_rl
+#define SYMM_RU blasfeo_dsymm_ru
 
 
 
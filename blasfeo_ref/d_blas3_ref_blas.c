@@ -110,6 +110,11 @@
 #define REF_SYR2K_LT blasfeo_hp_cm_dsyr2k_lt
 #define REF_SYR2K_UN blasfeo_hp_cm_dsyr2k_un
 #define REF_SYR2K_UT blasfeo_hp_cm_dsyr2k_ut
+// symm
+#define REF_SYMM_LL blasfeo_hp_cm_dsymm_ll
+#define REF_SYMM_LU blasfeo_hp_cm_dsymm_lu
+#define REF_SYMM_RL blasfeo_hp_cm_dsymm_rl
+#define REF_SYMM_RU blasfeo_hp_cm_dsymm_ru
 
 
 // gemm
@@ -162,6 +167,11 @@
 #define SYR2K_LT blasfeo_cm_dsyr2k_lt
 #define SYR2K_UN blasfeo_cm_dsyr2k_un
 #define SYR2K_UT blasfeo_cm_dsyr2k_ut
+// symm
+#define SYMM_LL blasfeo_cm_dsymm_ll
+#define SYMM_LU blasfeo_cm_dsymm_lu
+#define SYMM_RL blasfeo_cm_dsymm_rl
+#define SYMM_RU blasfeo_cm_dsymm_ru
 
 
 
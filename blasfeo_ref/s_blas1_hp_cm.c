@@ -60,6 +60,7 @@
 
 #define REAL float
 #define XMAT blasfeo_smat
+#define XMATEL BLASFEO_SMATEL
 #define XVEC blasfeo_svec
 
 
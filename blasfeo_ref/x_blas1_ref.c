@@ -218,17 +218,26 @@ void REF_ROTG(REAL a, REAL b, REAL *c, REAL *s)
 // apply plane rotation to the aj0 and aj1 columns of A at row index ai
 void REF_COLROT(int m, struct XMAT *sA, int ai, int aj0, int aj1, REAL c, REAL s)
 	{
+	int ii;
+	REAL d_tmp;
+#if defined(MF_COLMAJ)
 	int lda = sA->m;
 	REAL *px = sA->pA + ai + aj0*lda;
 	REAL *py = sA->pA + ai + aj1*lda;
-	int ii;
-	REAL d_tmp;
 	for(ii=0; ii<m; ii++)
 		{
 		d_tmp  = c*px[ii] + s*py[ii];
 		py[ii] = c*py[ii] - s*px[ii];
 		px[ii] = d_tmp;
 		}
+#else // MF_PANELMAJ
+	for(ii=0; ii<m; ii++)
+		{
+		d_tmp  = c*XMATEL(sA, ai+ii, aj0) + s*XMATEL(sA, ai+ii, aj1);
+		XMATEL(sA, ai+ii, aj1) = c*XMATEL(sA, ai+ii, aj1) - s*XMATEL(sA, ai+ii, aj0);
+		XMATEL(sA, ai+ii, aj0) = d_tmp;
+		}
+#endif
 	return;
 	}
 
@@ -237,17 +246,26 @@ void REF_COLROT(int m, struct XMAT *sA, int ai, int aj0, int aj1, REAL c, REAL s
 // apply plane rotation to the ai0 and ai1 rows of A at column index aj
 void REF_ROWROT(int m, struct XMAT *sA, int ai0, int ai1, int aj, REAL c, REAL s)
 	{
+	int ii;
+	REAL d_tmp;
+#if defined(MF_COLMAJ)
 	int lda = sA->m;
 	REAL *px = sA->pA + ai0 + aj*lda;
 	REAL *py = sA->pA + ai1 + aj*lda;
-	int ii;
-	REAL d_tmp;
 	for(ii=0; ii<m; ii++)
 		{
 		d_tmp  = c*px[ii*lda] + s*py[ii*lda];
 		py[ii*lda] = c*py[ii*lda] - s*px[ii*lda];
 		px[ii*lda] = d_tmp;
 		}
+#else // MF_PANELMAJ
+	for(ii=0; ii<m; ii++)
+		{
+		d_tmp  = c*XMATEL(sA, ai0, aj+ii) + s*XMATEL(sA, ai1, aj+ii);
+		XMATEL(sA, ai1, aj+ii) = c*XMATEL(sA, ai1, aj+ii) - s*XMATEL(sA, ai0, aj+ii);
+		XMATEL(sA, ai0, aj+ii) = d_tmp;
+		}
+#endif
 	return;
 	}
 
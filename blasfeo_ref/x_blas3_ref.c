@@ -4706,6 +4706,218 @@ void REF_SYR2K_UT(int m, int k, REAL alpha, struct XMAT *sA, int ai, int aj, str
 
 
 
+#if defined(REF_SYMM_LL)
+// dsymm left lower
+void REF_SYMM_LL(int m, int n, REAL alpha, struct XMAT *sA, int ai, int aj, struct XMAT *sB, int bi, int bj, REAL beta, struct XMAT *sC, int ci, int cj, struct XMAT *sD, int di, int dj)
+	{
+	if(m<=0 | n<=0)
+		return;
+
+	// invalidate stored inverse diagonal of result matrix
+	sD->use_dA = 0;
+
+	int ii, jj, kk;
+	REAL c_00;
+#if defined(MF_COLMAJ) | defined(REF_BLAS)
+	int lda = sA->m;
+	int ldb = sB->m;
+	int ldc = sC->m;
+	int ldd = sD->m;
+	REAL *pA = sA->pA + ai + aj*lda;
+	REAL *pB = sB->pA + bi + bj*ldb;
+	REAL *pC = sC->pA + ci + cj*ldc;
+	REAL *pD = sD->pA + di + dj*ldd;
+	const int aai=0; const int aaj=0;
+	const int bbi=0; const int bbj=0;
+	const int cci=0; const int ccj=0;
+	const int ddi=0; const int ddj=0;
+#else
+	int aai=ai; int aaj=aj;
+	int bbi=bi; int bbj=bj;
+	int cci=ci; int ccj=cj;
+	int ddi=di; int ddj=dj;
+#endif
+	for(jj=0; jj<n; jj++)
+		{
+		for(ii=0; ii<m; ii++)
+			{
+			c_00 = 0.0;
+			for(kk=0; kk<ii; kk++)
+				{
+				c_00 += XMATEL_A(aai+ii, aaj+kk) * XMATEL_B(bbi+kk, bbj+jj);
+				}
+			for(; kk<m; kk++)
+				{
+				c_00 += XMATEL_A(aai+kk, aaj+ii) * XMATEL_B(bbi+kk, bbj+jj);
+				}
+			XMATEL_D(ddi+ii, ddj+jj) = beta * XMATEL_C(cci+ii, ccj+jj) + alpha * c_00;
+			}
+		}
+	return;
+	}
+#endif
+
+
+
+#if defined(REF_SYMM_LU)
+// dsymm left upper
+void REF_SYMM_LU(int m, int n, REAL alpha, struct XMAT *sA, int ai, int aj, struct XMAT *sB, int bi, int bj, REAL beta, struct XMAT *sC, int ci, int cj, struct XMAT *sD, int di, int dj)
+	{
+	if(m<=0 | n<=0)
+		return;
+
+	// invalidate stored inverse diagonal of result matrix
+	sD->use_dA = 0;
+
+	int ii, jj, kk;
+	REAL c_00;
+#if defined(MF_COLMAJ) | defined(REF_BLAS)
+	int lda = sA->m;
+	int ldb = sB->m;
+	int ldc = sC->m;
+	int ldd = sD->m;
+	REAL *pA = sA->pA + ai + aj*lda;
+	REAL *pB = sB->pA + bi + bj*ldb;
+	REAL *pC = sC->pA + ci + cj*ldc;
+	REAL *pD = sD->pA + di + dj*ldd;
+	const int aai=0; const int aaj=0;
+	const int bbi=0; const int bbj=0;
+	const int cci=0; const int ccj=0;
+	const int ddi=0; const int ddj=0;
+#else
+	int aai=ai; int aaj=aj;
+	int bbi=bi; int bbj=bj;
+	int cci=ci; int ccj=cj;
+	int ddi=di; int ddj=dj;
+#endif
+	for(jj=0; jj<n; jj++)
+		{
+		for(ii=0; ii<m; ii++)
+			{
+			c_00 = 0.0;
+			for(kk=0; kk<ii; kk++)
+				{
+				c_00 += XMATEL_A(aai+kk, aaj+ii) * XMATEL_B(bbi+kk, bbj+jj);
+				}
+			for(; kk<m; kk++)
+				{
+				c_00 += XMATEL_A(aai+ii, aaj+kk) * XMATEL_B(bbi+kk, bbj+jj);
+				}
+			XMATEL_D(ddi+ii, ddj+jj) = beta * XMATEL_C(cci+ii, ccj+jj) + alpha * c_00;
+			}
+		}
+	return;
+	}
+#endif
+
+
+
+#if defined(REF_SYMM_RL)
+// dsymm right lower
+void REF_SYMM_RL(int m, int n, REAL alpha, struct XMAT *sA, int ai, int aj, struct XMAT *sB, int bi, int bj, REAL beta, struct XMAT *sC, int ci, int cj, struct XMAT *sD, int di, int dj)
+	{
+	if(m<=0 | n<=0)
+		return;
+
+	// invalidate stored inverse diagonal of result matrix
+	sD->use_dA = 0;
+
+	int ii, jj, kk;
+	REAL c_00;
+#if defined(MF_COLMAJ) | defined(REF_BLAS)
+	int lda = sA->m;
+	int ldb = sB->m;
+	int ldc = sC->m;
+	int ldd = sD->m;
+	REAL *pA = sA->pA + ai + aj*lda;
+	REAL *pB = sB->pA + bi + bj*ldb;
+	REAL *pC = sC->pA + ci + cj*ldc;
+	REAL *pD = sD->pA + di + dj*ldd;
+	const int aai=0; const int aaj=0;
+	const int bbi=0; const int bbj=0;
+	const int cci=0; const int ccj=0;
+	const int ddi=0; const int ddj=0;
+#else
+	int aai=ai; int aaj=aj;
+	int bbi=bi; int bbj=bj;
+	int cci=ci; int ccj=cj;
+	int ddi=di; int ddj=dj;
+#endif
+	for(jj=0; jj<n; jj++)
+		{
+		for(ii=0; ii<m; ii++)
+			{
+			c_00 = 0.0;
+			for(kk=0; kk<jj; kk++)
+				{
+				c_00 += XMATEL_B(bbi+ii, bbj+kk) * XMATEL_A(aai+jj, aaj+kk);
+				}
+			for(; kk<n; kk++)
+				{
+				c_00 += XMATEL_B(bbi+ii, bbj+kk) * XMATEL_A(aai+kk, aaj+jj);
+				}
+			XMATEL_D(ddi+ii, ddj+jj) = beta * XMATEL_C(cci+ii, ccj+jj) + alpha * c_00;
+			}
+		}
+	return;
+	}
+#endif
+
+
+
+#if defined(REF_SYMM_RU)
+// dsymm right upper
+void REF_SYMM_RU(int m, int n, REAL alpha, struct XMAT *sA, int ai, int aj, struct XMAT *sB, int bi, int bj, REAL beta, struct XMAT *sC, int ci, int cj, struct XMAT *sD, int di, int dj)
+	{
+	if(m<=0 | n<=0)
+		return;
+
+	// invalidate stored inverse diagonal of result matrix
+	sD->use_dA = 0;
+
+	int ii, jj, kk;
+	REAL c_00;
+#if defined(MF_COLMAJ) | defined(REF_BLAS)
+	int lda = sA->m;
+	int ldb = sB->m;
+	int ldc = sC->m;
+	int ldd = sD->m;
+	REAL *pA = sA->pA + ai + aj*lda;
+	REAL *pB = sB->pA + bi + bj*ldb;
+	REAL *pC = sC->pA + ci + cj*ldc;
+	REAL *pD = sD->pA + di + dj*ldd;
+	const int aai=0; const int aaj=0;
+	const int bbi=0; const int bbj=0;
+	const int cci=0; const int ccj=0;
+	const int ddi=0; const int ddj=0;
+#else
+	int aai=ai; int aaj=aj;
+	int bbi=bi; int bbj=bj;
+	int cci=ci; int ccj=cj;
+	int ddi=di; int ddj=dj;
+#endif
+	for(jj=0; jj<n; jj++)
+		{
+		for(ii=0; ii<m; ii++)
+			{
+			c_00 = 0.0;
+			for(kk=0; kk<jj; kk++)
+				{
+				c_00 += XMATEL_B(bbi+ii, bbj+kk) * XMATEL_A(aai+kk, aaj+jj);
+				}
+			for(; kk<n; kk++)
+				{
+				c_00 += XMATEL_B(bbi+ii, bbj+kk) * XMATEL_A(aai+jj, aaj+kk);
+				}
+			XMATEL_D(ddi+ii, ddj+jj) = beta * XMATEL_C(cci+ii, ccj+jj) + alpha * c_00;
+			}
+		}
+	return;
+	}
+#endif
+
+
+
 #if (defined(LA_REFERENCE) & defined(REF)) | (defined(LA_HIGH_PERFORMANCE) & defined(HP_CM)) | (defined(REF_BLAS))
 
 
@@ -5133,4 +5345,40 @@ void SYR2K_UT(int m, int k, REAL alpha, struct XMAT *sA, int ai, int aj, struct
 	}
 #endif
 
+
+
+#if defined(SYMM_LL)
+void SYMM_LL(int m, int n, REAL alpha, struct XMAT *sA, int ai, int aj, struct XMAT *sB, int bi, int bj, REAL beta, struct XMAT *sC, int ci, int cj, struct XMAT *sD, int di, int dj)
+	{
+	REF_SYMM_LL(m, n, alpha, sA, ai, aj, sB, bi, bj, beta, sC, ci, cj, sD, di, dj);
+	}
+#endif
+
+
+
+#if defined(SYMM_LU)
+void SYMM_LU(int m, int n, REAL alpha, struct XMAT *sA, int ai, int aj, struct XMAT *sB, int bi, int bj, REAL beta, struct XMAT *sC, int ci, int cj, struct XMAT *sD, int di, int dj)
+	{
+	REF_SYMM_LU(m, n, alpha, sA, ai, aj, sB, bi, bj, beta, sC, ci, cj, sD, di, dj);
+	}
+#endif
+
+
+
+#if defined(SYMM_RL)
+void SYMM_RL(int m, int n, REAL alpha, struct XMAT *sA, int ai, int aj, struct XMAT *sB, int bi, int bj, REAL beta, struct XMAT *sC, int ci, int cj, struct XMAT *sD, int di, int dj)
+	{
+	REF_SYMM_RL(m, n, alpha, sA, ai, aj, sB, bi, bj, beta, sC, ci, cj, sD, di, dj);
+	}
+#endif
+
+
+
+#if defined(SYMM_RU)
+void SYMM_RU(int m, int n, REAL alpha, struct XMAT *sA, int ai, int aj, struct XMAT *sB, int bi, int bj, REAL beta, struct XMAT *sC, int ci, int cj, struct XMAT *sD, int di, int dj)
+	{
+	REF_SYMM_RU(m, n, alpha, sA, ai, aj, sB, bi, bj, beta, sC, ci, cj, sD, di, dj);
+	}
+#endif
+
 #endif
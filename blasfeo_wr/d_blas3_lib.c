@@ -89,6 +89,10 @@
 #define SYR2K_LT blasfeo_dsyr2k_lt
 #define SYR2K_UN blasfeo_dsyr2k_un
 #define SYR2K_UT blasfeo_dsyr2k_ut
+#define SYMM_LL blasfeo_dsymm_ll
+#define SYMM_LU blasfeo_dsymm_lu
+#define SYMM_RL blasfeo_dsymm_rl
+#define SYMM_RU blasfeo_dsymm_ru
 
 #define COPY dcopy_
 #define GEMM dgemm_
@@ -96,6 +100,7 @@
 #define TRMM dtrmm_
 #define TRSM dtrsm_
 #define SYR2K dsyr2k_
+#define SYMM dsymm_
 
 
 
@@ -0,0 +1,83 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS for embedded optimization.                                                      *
+* Copyright (C) 2019 by Gianluca Frison.                                                          *
+* Developed at IMTEK (University of Freiburg) under the supervision of Moritz Diehl.              *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+
+
+
+// batched routines: the same operation, with the same sizes and offsets, is applied to each matrix of the batch
+
+
+
+#if defined(LA_EXTERNAL_BLAS_WRAPPER)
+
+
+
+void GEMM_NT_BATCH(int nb, int m, int n, int k, REAL alpha, struct XMAT **sA, int ai, int aj, struct XMAT **sB, int bi, int bj, REAL beta, struct XMAT **sC, int ci, int cj, struct XMAT **sD, int di, int dj)
+	{
+	int ii;
+	for(ii=0; ii<nb; ii++)
+		{
+		GEMM_NT(m, n, k, alpha, sA[ii], ai, aj, sB[ii], bi, bj, beta, sC[ii], ci, cj, sD[ii], di, dj);
+		}
+	return;
+	}
+
+
+
+void TRSM_RLTN_BATCH(int nb, int m, int n, REAL alpha, struct XMAT **sA, int ai, int aj, struct XMAT **sB, int bi, int bj, struct XMAT **sD, int di, int dj)
+	{
+	int ii;
+	for(ii=0; ii<nb; ii++)
+		{
+		TRSM_RLTN(m, n, alpha, sA[ii], ai, aj, sB[ii], bi, bj, sD[ii], di, dj);
+		}
+	return;
+	}
+
+
+
+void POTRF_L_BATCH(int nb, int m, struct XMAT **sC, int ci, int cj, struct XMAT **sD, int di, int dj)
+	{
+	int ii;
+	for(ii=0; ii<nb; ii++)
+		{
+		POTRF_L(m, sC[ii], ci, cj, sD[ii], di, dj);
+		}
+	return;
+	}
+
+
+
+#endif
@@ -37,6 +37,7 @@
 #include "blasfeo_target.h"
 #include "blasfeo_block_size.h"
 #include "blasfeo_stdlib.h"
+#include "blasfeo_thread_pool.h"
 #include "blasfeo_common.h"
 #include "blasfeo_d_aux.h"
 #include "blasfeo_d_aux_ext_dep.h"
@@ -46,6 +47,12 @@
 #include "blasfeo_s_aux_ext_dep.h"
 #include "blasfeo_s_kernel.h"
 #include "blasfeo_s_blas.h"
+#include "blasfeo_m_aux.h"
+#include "blasfeo_m_blasfeo_api.h"
+#include "blasfeo_z_aux.h"
+#include "blasfeo_z_kernel.h"
+#include "blasfeo_z_blasfeo_api.h"
+#include "blasfeo_d_riccati.h"
 #include "blasfeo_i_aux_ext_dep.h"
 #include "blasfeo_v_aux_ext_dep.h"
 #include "blasfeo_timing.h"
@@ -40,6 +40,10 @@
 
 #define D_EL_SIZE 8 // double precision
 #define S_EL_SIZE 4 // single precision
+#define Z_EL_SIZE 16 // double precision complex
+
+// double precision complex: same panel size in all targets (a panel column is 64 bytes)
+#define Z_PS 4 // panel size
 
 
 
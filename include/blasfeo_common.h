@@ -255,6 +255,63 @@ struct blasfeo_cm_svec
 	int memsize; // size of needed memory
 	};
 
+// Compact batch matrix structure: element (i,j) of BLASFEO_CB_D_NL matrices
+// of the same size is stored contiguously, so that each SIMD lane holds one matrix
+#if defined(TARGET_X64_INTEL_SKYLAKE_X) | defined(TARGET_X64_AMD_ZEN5)
+#define BLASFEO_CB_D_NL 8 // AVX-512
+#elif defined(RUNTIME_DISPATCH)
+#define BLASFEO_CB_D_NL 8 // fits the widest kernel set selectable at runtime
+#else
+#define BLASFEO_CB_D_NL 4 // AVX2, or scalar fallback
+#endif
+
+struct blasfeo_cb_dmat
+	{
+	double *mem; // pointer to passed chunk of memory
+	double *pA; // pointer to a nl*m*n array of doubles, the first is aligned to cache line size
+	int m; // rows
+	int n; // cols
+	int nl; // number of interleaved matrices
+	int memsize; // size of needed memory
+	};
+
+// Double precision complex matrix structure: panel-major with panel size Z_PS,
+// with real and imaginary part of each element stored next to each other
+struct blasfeo_zmat
+	{
+	double *mem; // pointer to passed chunk of memory
+	double *pA; // pointer to a 2*pm*cn array of doubles, the first is aligned to cache line size
+	int m; // rows
+	int n; // cols
+	int pm; // packed number or rows
+	int cn; // packed number or cols
+	int memsize; // size of needed memory
+	};
+
+struct blasfeo_zvec
+	{
+	double *mem; // pointer to passed chunk of memory
+	double *pa; // pointer to a 2*pm array of doubles, the first is aligned to cache line size
+	int m; // size
+	int pm; // packed size
+	int memsize; // size of needed memory
+	};
+
+// Half-precision storage matrix structure: panel-major with panel size BLASFEO_HS_PS,
+// elements stored as IEEE binary16 and converted to float for computation
+#define BLASFEO_HS_PS 8
+
+struct blasfeo_hs_smat
+	{
+	unsigned short *mem; // pointer to passed chunk of memory
+	unsigned short *pA; // pointer to a pm*cn array of halfs, the first is aligned to cache line size
+	int m; // rows
+	int n; // cols
+	int pm; // packed number or rows
+	int cn; // packed number or cols
+	int memsize; // size of needed memory
+	};
+
 
 #define BLASFEO_PM_DMATEL(sA,ai,aj) ((sA)->pA[((ai)-((ai)&((sA)->ps-1)))*(sA)->cn+(aj)*((sA)->ps)+((ai)&((sA)->ps-1))])
 #define BLASFEO_PM_SMATEL(sA,ai,aj) ((sA)->pA[((ai)-((ai)&((sA)->ps-1)))*(sA)->cn+(aj)*((sA)->ps)+((ai)&((sA)->ps-1))])
@@ -264,6 +321,13 @@ struct blasfeo_cm_svec
 #define BLASFEO_CM_SMATEL(sA,ai,aj) ((sA)->pA[(ai)+(aj)*(sA)->m])
 #define BLASFEO_CM_DVECEL(sa,ai) ((sa)->pa[ai])
 #define BLASFEO_CM_SVECEL(sa,ai) ((sa)->pa[ai])
+#define BLASFEO_CB_DMATEL(sA,ll,ai,aj) ((sA)->pA[((ai)+(aj)*(sA)->m)*(sA)->nl+(ll)])
+#define BLASFEO_ZMATEL_RE(sA,ai,aj) ((sA)->pA[2*(((ai)-((ai)&(Z_PS-1)))*(sA)->cn+(aj)*Z_PS+((ai)&(Z_PS-1)))])
+#define BLASFEO_ZMATEL_IM(sA,ai,aj) ((sA)->pA[2*(((ai)-((ai)&(Z_PS-1)))*(sA)->cn+(aj)*Z_PS+((ai)&(Z_PS-1)))+1])
+#define BLASFEO_ZVECEL_RE(sa,ai) ((sa)->pa[2*(ai)])
+#define BLASFEO_ZVECEL_IM(sa,ai) ((sa)->pa[2*(ai)+1])
+// binary16 bits of the element (ai,aj)
+#define BLASFEO_HS_SMATEL(sA,ai,aj) ((sA)->pA[((ai)-((ai)&(BLASFEO_HS_PS-1)))*(sA)->cn+(aj)*BLASFEO_HS_PS+((ai)&(BLASFEO_HS_PS-1))])
 
 
 
@@ -238,6 +238,21 @@ void blasfeo_cm_create_dmat(int m, int n, struct blasfeo_pm_dmat *sA, void *memo
 
 
 
+/*
+* Compact batch matrix format
+*/
+
+// returns the memory size (in bytes) needed for a cb_dmat
+size_t blasfeo_cb_memsize_dmat(int m, int n);
+// create a cb_dmat for BLASFEO_CB_D_NL matrices of size m*n by using memory passed by a pointer (pointer is not updated)
+void blasfeo_cb_create_dmat(int m, int n, struct blasfeo_cb_dmat *sA, void *memory);
+// copy the column-major matrix A into the lane ll of sB
+void blasfeo_cb_pack_dmat(int m, int n, double *A, int lda, struct blasfeo_cb_dmat *sB, int bi, int bj, int ll);
+// copy the lane ll of sA into the column-major matrix B
+void blasfeo_cb_unpack_dmat(int m, int n, struct blasfeo_cb_dmat *sA, int ai, int aj, double *B, int ldb, int ll);
+
+
+
 //
 // BLAS API helper functions
 //
@@ -40,6 +40,8 @@
 
 
 
+#include <stdlib.h>
+
 #include "blasfeo_target.h"
 
 
@@ -111,6 +113,14 @@ void dtrmm_(char *side, char *uplo, char *transa, char *diag, int *m, int *n, do
 void dtrsm_(char *side, char *uplo, char *transa, char *diag, int *m, int *n, double *alpha, double *A, int *lda, double *B, int *ldb);
 //
 void dsyr2k_(char *uplo, char *ta, int *m, int *k, double *alpha, double *A, int *lda, double *B, int *ldb, double *beta, double *C, int *ldc);
+//
+void dsymm_(char *side, char *uplo, int *m, int *n, double *alpha, double *A, int *lda, double *B, int *ldb, double *beta, double *C, int *ldc);
+//
+size_t dgemm_pack_get_size_(int *m, int *k);
+//
+void dgemm_pack_(char *ta, int *m, int *k, double *A, int *lda, void *pA);
+//
+void dgemm_compute_(char *tb, int *n, double *alpha, void *pA, double *B, int *ldb, double *beta, double *C, int *ldc);
 #ifdef HASWELL_WITH_ZEN5
 //
 void zen5_dgemm_(char *ta, char *tb, int *m, int *n, int *k, double *alpha, double *A, int *lda, double *B, int *ldb, double *beta, double *C, int *ldc);
@@ -138,6 +148,60 @@ void dpotrs_(char *uplo, int *m, int *n, double *A, int *lda, double *B, int *ld
 //
 void dtrtrs_(char *uplo, char *trans, char *diag, int *m, int *n, double *A, int *lda, double *B, int *ldb, int *info);
 
+// workspace-argument variants: the routine runs in the caller-provided work (of the size returned by the matching _worksize, in bytes) and does not allocate memory
+//
+size_t dgemv_worksize_(int *m, int *n);
+//
+void dgemv_ws_(char *trans, int *m, int *n, double *alpha, double *A, int *lda, double *x, int *incx, double *beta, double *y, int *incy, void *work);
+//
+size_t dsymv_worksize_(int *n);
+//
+void dsymv_ws_(char *uplo, int *n, double *alpha, double *A, int *lda, double *x, int *incx, double *beta, double *y, int *incy, void *work);
+//
+size_t dger_worksize_(int *m, int *n);
+//
+void dger_ws_(int *m, int *n, double *alpha, double *x, int *incx, double *y, int *incy, double *A, int *lda, void *work);
+//
+size_t dgemm_worksize_(int *m, int *n, int *k);
+//
+void dgemm_ws_(char *ta, char *tb, int *m, int *n, int *k, double *alpha, double *A, int *lda, double *B, int *ldb, double *beta, double *C, int *ldc, void *work);
+//
+size_t dsyrk_worksize_(int *m, int *k);
+//
+void dsyrk_ws_(char *uplo, char *ta, int *m, int *k, double *alpha, double *A, int *lda, double *beta, double *C, int *ldc, void *work);
+//
+size_t dtrmm_worksize_(int *m, int *n);
+//
+void dtrmm_ws_(char *side, char *uplo, char *transa, char *diag, int *m, int *n, double *alpha, double *A, int *lda, double *B, int *ldb, void *work);
+//
+size_t dtrsm_worksize_(int *m, int *n);
+//
+void dtrsm_ws_(char *side, char *uplo, char *transa, char *diag, int *m, int *n, double *alpha, double *A, int *lda, double *B, int *ldb, void *work);
+//
+size_t dsyr2k_worksize_(int *m, int *k);
+//
+void dsyr2k_ws_(char *uplo, char *ta, int *m, int *k, double *alpha, double *A, int *lda, double *B, int *ldb, double *beta, double *C, int *ldc, void *work);
+//
+size_t dsymm_worksize_(int *m, int *n);
+//
+void dsymm_ws_(char *side, char *uplo, int *m, int *n, double *alpha, double *A, int *lda, double *B, int *ldb, double *beta, double *C, int *ldc, void *work);
+//
+size_t dgesv_worksize_(int *m, int *n);
+//
+void dgesv_ws_(int *m, int *n, double *A, int *lda, int *ipiv, double *B, int *ldb, int *info, void *work);
+//
+size_t dgetrf_worksize_(int *m, int *n);
+//
+void dgetrf_ws_(int *m, int *n, double *A, int *lda, int *ipiv, int *info, void *work);
+//
+size_t dposv_worksize_(int *m, int *n);
+//
+void dposv_ws_(char *uplo, int *m, int *n, double *A, int *lda, double *B, int *ldb, int *info, void *work);
+//
+size_t dpotrf_worksize_(int *m);
+//
+void dpotrf_ws_(char *uplo, int *m, double *A, int *lda, int *info, void *work);
+
 
 
 // aux
@@ -212,6 +276,15 @@ void blasfeo_blas_dtrmm(char *side, char *uplo, char *transa, char *diag, int *m
 void blasfeo_blas_dtrsm(char *side, char *uplo, char *transa, char *diag, int *m, int *n, double *alpha, double *A, int *lda, double *B, int *ldb);
 //
 void blasfeo_blas_dsyr2k(char *uplo, char *ta, int *m, int *k, double *alpha, double *A, int *lda, double *B, int *ldb, double *beta, double *C, int *ldc);
+//
+void blasfeo_blas_dsymm(char *side, char *uplo, int *m, int *n, double *alpha, double *A, int *lda, double *B, int *ldb, double *beta, double *C, int *ldc);
+// packed operand: op(A) is packed once in pA (of size blasfeo_blas_dgemm_pack_get_size bytes) and reused by many products C <= beta * C + alpha * op(A) * op(B)
+//
+size_t blasfeo_blas_dgemm_pack_get_size(int *m, int *k);
+//
+void blasfeo_blas_dgemm_pack(char *ta, int *m, int *k, double *A, int *lda, void *pA);
+//
+void blasfeo_blas_dgemm_compute(char *tb, int *n, double *alpha, void *pA, double *B, int *ldb, double *beta, double *C, int *ldc);
 #ifdef HASWELL_WITH_ZEN5
 //
 void blasfeo_blas_zen5_dgemm(char *ta, char *tb, int *m, int *n, int *k, double *alpha, double *A, int *lda, double *B, int *ldb, double *beta, double *C, int *ldc);
@@ -239,6 +312,60 @@ void blasfeo_lapack_dpotrs(char *uplo, int *m, int *n, double *A, int *lda, doub
 //
 void blasfeo_lapack_dtrtrs(char *uplo, char *trans, char *diag, int *m, int *n, double *A, int *lda, double *B, int *ldb, int *info);
 
+// workspace-argument variants: the routine runs in the caller-provided work (of the size returned by the matching _worksize, in bytes) and does not allocate memory
+//
+size_t blasfeo_blas_dgemv_worksize(int *m, int *n);
+//
+void blasfeo_blas_dgemv_ws(char *trans, int *m, int *n, double *alpha, double *A, int *lda, double *x, int *incx, double *beta, double *y, int *incy, void *work);
+//
+size_t blasfeo_blas_dsymv_worksize(int *n);
+//
+void blasfeo_blas_dsymv_ws(char *uplo, int *n, double *alpha, double *A, int *lda, double *x, int *incx, double *beta, double *y, int *incy, void *work);
+//
+size_t blasfeo_blas_dger_worksize(int *m, int *n);
+//
+void blasfeo_blas_dger_ws(int *m, int *n, double *alpha, double *x, int *incx, double *y, int *incy, double *A, int *lda, void *work);
+//
+size_t blasfeo_blas_dgemm_worksize(int *m, int *n, int *k);
+//
+void blasfeo_blas_dgemm_ws(char *ta, char *tb, int *m, int *n, int *k, double *alpha, double *A, int *lda, double *B, int *ldb, double *beta, double *C, int *ldc, void *work);
+//
+size_t blasfeo_blas_dsyrk_worksize(int *m, int *k);
+//
+void blasfeo_blas_dsyrk_ws(char *uplo, char *ta, int *m, int *k, double *alpha, double *A, int *lda, double *beta, double *C, int *ldc, void *work);
+//
+size_t blasfeo_blas_dtrmm_worksize(int *m, int *n);
+//
+void blasfeo_blas_dtrmm_ws(char *side, char *uplo, char *transa, char *diag, int *m, int *n, double *alpha, double *A, int *lda, double *B, int *ldb, void *work);
+//
+size_t blasfeo_blas_dtrsm_worksize(int *m, int *n);
+//
+void blasfeo_blas_dtrsm_ws(char *side, char *uplo, char *transa, char *diag, int *m, int *n, double *alpha, double *A, int *lda, double *B, int *ldb, void *work);
+//
+size_t blasfeo_blas_dsyr2k_worksize(int *m, int *k);
+//
+void blasfeo_blas_dsyr2k_ws(char *uplo, char *ta, int *m, int *k, double *alpha, double *A, int *lda, double *B, int *ldb, double *beta, double *C, int *ldc, void *work);
+//
+size_t blasfeo_blas_dsymm_worksize(int *m, int *n);
+//
+void blasfeo_blas_dsymm_ws(char *side, char *uplo, int *m, int *n, double *alpha, double *A, int *lda, double *B, int *ldb, double *beta, double *C, int *ldc, void *work);
+//
+size_t blasfeo_lapack_dgesv_worksize(int *m, int *n);
+//
+void blasfeo_lapack_dgesv_ws(int *m, int *n, double *A, int *lda, int *ipiv, double *B, int *ldb, int *info, void *work);
+//
+size_t blasfeo_lapack_dgetrf_worksize(int *m, int *n);
+//
+void blasfeo_lapack_dgetrf_ws(int *m, int *n, double *A, int *lda, int *ipiv, int *info, void *work);
+//
+size_t blasfeo_lapack_dposv_worksize(int *m, int *n);
+//
+void blasfeo_lapack_dposv_ws(char *uplo, int *m, int *n, double *A, int *lda, double *B, int *ldb, int *info, void *work);
+//
+size_t blasfeo_lapack_dpotrf_worksize(int *m);
+//
+void blasfeo_lapack_dpotrf_ws(char *uplo, int *m, double *A, int *lda, int *info, void *work);
+
 
 
 // aux
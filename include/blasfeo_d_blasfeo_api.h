@@ -238,6 +238,14 @@ void blasfeo_dsyr2k_lt(int m, int k, double alpha, struct blasfeo_dmat *sA, int
 void blasfeo_dsyr2k_un(int m, int k, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj);
 // D <= beta * C + alpha * A^T * B + alpha * B^T * A; C, D upper triangular
 void blasfeo_dsyr2k_ut(int m, int k, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj);
+// D <= beta * C + alpha * A * B, with A symmetric and only its lower triangle accessed
+void blasfeo_dsymm_ll(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj);
+// D <= beta * C + alpha * A * B, with A symmetric and only its upper triangle accessed
+void blasfeo_dsymm_lu(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj);
+// D <= beta * C + alpha * B * A, with A symmetric and only its lower triangle accessed
+void blasfeo_dsymm_rl(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj);
+// D <= beta * C + alpha * B * A, with A symmetric and only its upper triangle accessed
+void blasfeo_dsymm_ru(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj);
 #ifdef HASWELL_WITH_ZEN5
 void blasfeo_zen5_dgemm_nn(int m, int n, int k, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj);
 void blasfeo_zen5_dgemm_nt(int m, int n, int k, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj);
@@ -268,10 +276,28 @@ void blasfeo_dpotrf_u(int m, struct blasfeo_dmat *sC, int ci, int cj, struct bla
 // D <= chol( C + A * B^T ) ; C, D lower triangular
 void blasfeo_dsyrk_dpotrf_ln(int m, int k, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj);
 void blasfeo_dsyrk_dpotrf_ln_mn(int m, int n, int k, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj);
+// D <= chol( C * C^T + A * A^T ) ; C, D lower triangular Cholesky factors, A of size m x k ; Givens rotations, O(m^2 k)
+void blasfeo_dpotrf_update_l(int m, int k, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj);
+// D <= chol( C * C^T - A * A^T ) ; C, D lower triangular Cholesky factors, A of size m x k ; hyperbolic rotations, O(m^2 k)
+// the columns of D where the downdated matrix is found not positive definite are set to zero
+void blasfeo_dpotrf_downdate_l(int m, int k, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj);
 // D <= lu( C ) ; no pivoting
 void blasfeo_dgetrf_np(int m, int n, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj);
 // D <= lu( C ) ; row pivoting
 void blasfeo_dgetrf_rp(int m, int n, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj, int *ipiv);
+// D <= ldl( C ) ; Bunch-Kaufman symmetric pivoting ; C, D lower triangular
+// P * C * P^T = L * D * L^T, with L unit lower triangular and D block diagonal with 1x1 and 2x2 blocks;
+// ipiv[k]>=0 for a 1x1 block at k, interchanged with row/column ipiv[k] ;
+// ipiv[k]=ipiv[k+1]=-p-1 for a 2x2 block at k, with row/column k+1 interchanged with p ;
+// the off-diagonal element of a 2x2 block is stored in the upper triangular of D at (k, k+1)
+void blasfeo_dsytrf_l(int m, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj, int *ipiv);
+// D <= A^{-1} * B , with A factorized by blasfeo_dsytrf_l
+void blasfeo_dsytrs_l(int m, int n, struct blasfeo_dmat *sA, int ai, int aj, int *ipiv, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj);
+// D <= ldl( C ) ; no pivoting ; C, D lower triangular
+// C = L * D * L^T, with L unit lower triangular and D diagonal, of any sign; stable for quasi-definite C ; a zero pivot gives a zero column of L
+void blasfeo_dsytrf_l_nopiv(int m, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj);
+// D <= A^{-1} * B , with A factorized by blasfeo_dsytrf_l_nopiv
+void blasfeo_dsytrs_l_nopiv(int m, int n, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj);
 // D <= qr( C )
 int blasfeo_dgeqrf_worksize(int m, int n); // in bytes
 void blasfeo_dgeqrf(int m, int n, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj, void *work);
@@ -291,6 +317,54 @@ void blasfeo_dgelqf_pd_la(int m, int n1, struct blasfeo_dmat *sL, int li, int lj
 // L lower triangular, of size (m)x(m)
 // A full, of size (m)x(n1)
 void blasfeo_dgelqf_pd_lla(int m, int n1, struct blasfeo_dmat *sL0, int l0i, int l0j, struct blasfeo_dmat *sL1, int l1i, int l1j, struct blasfeo_dmat *sA, int ai, int aj, void *work);
+// D <= R factor of qr( [C; A] ), positive diagonal elements ; C, D upper triangular R factors of size m x m, A of size k x m ; rows appended to the factorized matrix, Householder reflections, O(m^2 k)
+void blasfeo_dgeqrf_update_u(int m, int k, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj);
+// D^T * D <= C^T * C - A^T * A, positive diagonal elements ; C, D upper triangular R factors of size m x m, A of size k x m ; rows removed from the factorized matrix, hyperbolic rotations, O(m^2 k)
+// the rows of D where the downdated matrix is found not positive definite are set to zero
+void blasfeo_dgeqrf_downdate_u(int m, int k, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj);
+
+
+
+//
+// batched routines: the same operation, with the same sizes and offsets, is applied to the nb matrices sX[0], ..., sX[nb-1]
+//
+
+// D[ii] <= beta * C[ii] + alpha * A[ii] * B[ii]^T
+void blasfeo_dgemm_nt_batch(int nb, int m, int n, int k, double alpha, struct blasfeo_dmat **sA, int ai, int aj, struct blasfeo_dmat **sB, int bi, int bj, double beta, struct blasfeo_dmat **sC, int ci, int cj, struct blasfeo_dmat **sD, int di, int dj);
+// D[ii] <= alpha * B[ii] * A[ii]^{-T} , with A[ii] lower triangular
+void blasfeo_dtrsm_rltn_batch(int nb, int m, int n, double alpha, struct blasfeo_dmat **sA, int ai, int aj, struct blasfeo_dmat **sB, int bi, int bj, struct blasfeo_dmat **sD, int di, int dj);
+// D[ii] <= chol( C[ii] ) ; C[ii], D[ii] lower triangular
+void blasfeo_dpotrf_l_batch(int nb, int m, struct blasfeo_dmat **sC, int ci, int cj, struct blasfeo_dmat **sD, int di, int dj);
+// x[ii] <= A[ii]^{-1} * b[ii] , with A[ii] symmetric positive definite (only the lower triangular is accessed, A[ii] is not modified) ;
+// groups of BLASFEO_CB_D_NL systems are interleaved and factorized and solved with the compact batch routines ;
+// info[ii] = 0 if solved, k>0 if the leading minor of order k of A[ii] is not positive definite, -1 if the workspace allocation failed
+// (only for m>16, flagging BLASFEO_WS_ERR_ALLOC) ; x[ii] is not modified if info[ii]!=0
+void blasfeo_dposv_l_batch(int nb, int m, struct blasfeo_dmat **sA, int ai, int aj, struct blasfeo_dvec **sb, int bi, struct blasfeo_dvec **sx, int xi, int *info);
+
+
+
+//
+// compact batch routines: each of the BLASFEO_CB_D_NL interleaved matrices is processed in its own SIMD lane
+//
+
+// D <= beta * C + alpha * A * B
+void blasfeo_cb_dgemm_nn(int m, int n, int k, double alpha, struct blasfeo_cb_dmat *sA, int ai, int aj, struct blasfeo_cb_dmat *sB, int bi, int bj, double beta, struct blasfeo_cb_dmat *sC, int ci, int cj, struct blasfeo_cb_dmat *sD, int di, int dj);
+// D <= beta * C + alpha * A * B^T
+void blasfeo_cb_dgemm_nt(int m, int n, int k, double alpha, struct blasfeo_cb_dmat *sA, int ai, int aj, struct blasfeo_cb_dmat *sB, int bi, int bj, double beta, struct blasfeo_cb_dmat *sC, int ci, int cj, struct blasfeo_cb_dmat *sD, int di, int dj);
+// D <= alpha * B * A^{-T} , with A lower triangular
+void blasfeo_cb_dtrsm_rltn(int m, int n, double alpha, struct blasfeo_cb_dmat *sA, int ai, int aj, struct blasfeo_cb_dmat *sB, int bi, int bj, struct blasfeo_cb_dmat *sD, int di, int dj);
+// D <= chol( C ) ; C, D lower triangular
+void blasfeo_cb_dpotrf_l(int m, struct blasfeo_cb_dmat *sC, int ci, int cj, struct blasfeo_cb_dmat *sD, int di, int dj);
+// D <= lu( C ) ; row pivoting, the pivot of lane ll at row ii is stored in ipiv[ii*BLASFEO_CB_D_NL+ll]
+void blasfeo_cb_dgetrf_rp(int m, int n, struct blasfeo_cb_dmat *sC, int ci, int cj, struct blasfeo_cb_dmat *sD, int di, int dj, int *ipiv);
+// D <= A^{-T} * A^{-1} * B , with A lower triangular (e.g. from blasfeo_cb_dpotrf_l) ; D can alias B
+void blasfeo_cb_dpotrs_l(int m, int n, struct blasfeo_cb_dmat *sA, int ai, int aj, struct blasfeo_cb_dmat *sB, int bi, int bj, struct blasfeo_cb_dmat *sD, int di, int dj);
+#if defined(RUNTIME_DISPATCH)
+// select the kernel set (BLASFEO_PROCESSOR_ISA_*, or 0 for the best one) used by the compact batch routines; return 0 if not supported by the processor
+int blasfeo_cb_set_isa(int isa);
+// return the kernel set used by the compact batch routines
+int blasfeo_cb_get_isa();
+#endif
 
 
 
@@ -348,6 +422,10 @@ void blasfeo_cm_dsyr2k_ln(int m, int k, double alpha, struct blasfeo_cm_dmat *sA
 void blasfeo_cm_dsyr2k_lt(int m, int k, double alpha, struct blasfeo_cm_dmat *sA, int ai, int aj, struct blasfeo_cm_dmat *sB, int bi, int bj, double beta, struct blasfeo_cm_dmat *sC, int ci, int cj, struct blasfeo_cm_dmat *sD, int di, int dj);
 void blasfeo_cm_dsyr2k_un(int m, int k, double alpha, struct blasfeo_cm_dmat *sA, int ai, int aj, struct blasfeo_cm_dmat *sB, int bi, int bj, double beta, struct blasfeo_cm_dmat *sC, int ci, int cj, struct blasfeo_cm_dmat *sD, int di, int dj);
 void blasfeo_cm_dsyr2k_ut(int m, int k, double alpha, struct blasfeo_cm_dmat *sA, int ai, int aj, struct blasfeo_cm_dmat *sB, int bi, int bj, double beta, struct blasfeo_cm_dmat *sC, int ci, int cj, struct blasfeo_cm_dmat *sD, int di, int dj);
+void blasfeo_cm_dsymm_ll(int m, int n, double alpha, struct blasfeo_cm_dmat *sA, int ai, int aj, struct blasfeo_cm_dmat *sB, int bi, int bj, double beta, struct blasfeo_cm_dmat *sC, int ci, int cj, struct blasfeo_cm_dmat *sD, int di, int dj);
+void blasfeo_cm_dsymm_lu(int m, int n, double alpha, struct blasfeo_cm_dmat *sA, int ai, int aj, struct blasfeo_cm_dmat *sB, int bi, int bj, double beta, struct blasfeo_cm_dmat *sC, int ci, int cj, struct blasfeo_cm_dmat *sD, int di, int dj);
+void blasfeo_cm_dsymm_rl(int m, int n, double alpha, struct blasfeo_cm_dmat *sA, int ai, int aj, struct blasfeo_cm_dmat *sB, int bi, int bj, double beta, struct blasfeo_cm_dmat *sC, int ci, int cj, struct blasfeo_cm_dmat *sD, int di, int dj);
+void blasfeo_cm_dsymm_ru(int m, int n, double alpha, struct blasfeo_cm_dmat *sA, int ai, int aj, struct blasfeo_cm_dmat *sB, int bi, int bj, double beta, struct blasfeo_cm_dmat *sC, int ci, int cj, struct blasfeo_cm_dmat *sD, int di, int dj);
 #ifdef HASWELL_WITH_ZEN5
 void blasfeo_cm_zen5_dgemm_nn(int m, int n, int k, double alpha, struct blasfeo_cm_dmat *sA, int ai, int aj, struct blasfeo_cm_dmat *sB, int bi, int bj, double beta, struct blasfeo_cm_dmat *sC, int ci, int cj, struct blasfeo_cm_dmat *sD, int di, int dj);
 void blasfeo_cm_zen5_dgemm_nt(int m, int n, int k, double alpha, struct blasfeo_cm_dmat *sA, int ai, int aj, struct blasfeo_cm_dmat *sB, int bi, int bj, double beta, struct blasfeo_cm_dmat *sC, int ci, int cj, struct blasfeo_cm_dmat *sD, int di, int dj);
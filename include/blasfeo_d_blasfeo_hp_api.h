@@ -38,6 +38,8 @@
 
 
 
+#include <stdlib.h>
+
 #include "blasfeo_common.h"
 
 
@@ -55,12 +57,26 @@ extern "C" {
 // dense
 
 
+// D <= beta * C + alpha * A * B
+void blasfeo_hp_dgemm_nn(int m, int n, int k, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj);
+// D <= beta * C + alpha * A * B^T
+void blasfeo_hp_dgemm_nt(int m, int n, int k, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj);
 // D <= beta * C + alpha * A^T * B
 void blasfeo_hp_dgemm_tn(int m, int n, int k, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj);
 // D <= beta * C + alpha * A * B^T; C, D lower triangular
 void blasfeo_hp_dsyrk_ln(int m, int k, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj);
 // D <= beta * C + alpha * A * A^T ; C, D lower triangular
 void blasfeo_hp_dsyrk3_ln(int m, int k, double alpha, struct blasfeo_dmat *sA, int ai, int aj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj);
+// D <= beta * C + alpha * A * B, with A symmetric stored in the lower triangle
+void blasfeo_hp_dsymm_ll(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj);
+// D <= beta * C + alpha * A * B, with A symmetric stored in the upper triangle
+void blasfeo_hp_dsymm_lu(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj);
+// D <= beta * C + alpha * B * A, with A symmetric stored in the lower triangle
+void blasfeo_hp_dsymm_rl(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj);
+// D <= beta * C + alpha * B * A, with A symmetric stored in the upper triangle
+void blasfeo_hp_dsymm_ru(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj);
+// D <= alpha * A^{-1} * B , with A lower triangular with unit diagonal
+void blasfeo_hp_dtrsm_llnu(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj);
 // D <= alpha * B * A^{-T} , with A lower triangular
 void blasfeo_hp_dtrsm_rltn(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, struct blasfeo_dmat *sD, int di, int dj);
 
@@ -75,6 +91,48 @@ void blasfeo_hp_dtrsm_rltn(int m, int n, double alpha, struct blasfeo_dmat *sA,
 void blasfeo_hp_dgemv_n(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dvec *sx, int xi, double beta, struct blasfeo_dvec *sy, int yi, struct blasfeo_dvec *sz, int zi);
 
 
+//
+// LAPACK
+//
+
+// D <= chol( C ) ; C, D lower triangular
+void blasfeo_hp_dpotrf_l(int m, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj);
+// D <= lu( C ) ; row pivoting
+void blasfeo_hp_dgetrf_rp(int m, int n, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj, int *ipiv);
+
+
+
+//
+// packed operand routines (column-major backend): A is packed once and reused by many products
+//
+
+#if ( defined(BLAS_API) | defined(MF_COLMAJ) )
+// size in bytes of the packed operand of a m x k matrix A
+size_t blasfeo_hp_dgemm_pack_memsize(int m, int k);
+// pA <= A ; pA 64-byte aligned
+void blasfeo_hp_dgemm_pack_n(int m, int k, double *A, int lda, double *pA);
+// pA <= A^T ; pA 64-byte aligned
+void blasfeo_hp_dgemm_pack_t(int m, int k, double *A, int lda, double *pA);
+// D <= beta * C + alpha * A * B ; A packed
+void blasfeo_hp_dgemm_packed_nn(int m, int n, int k, double alpha, double *pA, double *B, int ldb, double beta, double *C, int ldc, double *D, int ldd);
+// D <= beta * C + alpha * A * B^T ; A packed
+void blasfeo_hp_dgemm_packed_nt(int m, int n, int k, double alpha, double *pA, double *B, int ldb, double beta, double *C, int ldc, double *D, int ldd);
+#endif
+
+
+
+//
+// batched routines: the same operation, with the same sizes and offsets, is applied to the nb matrices sX[0], ..., sX[nb-1]
+//
+
+// D[ii] <= beta * C[ii] + alpha * A[ii] * B[ii]^T
+void blasfeo_hp_dgemm_nt_batch(int nb, int m, int n, int k, double alpha, struct blasfeo_dmat **sA, int ai, int aj, struct blasfeo_dmat **sB, int bi, int bj, double beta, struct blasfeo_dmat **sC, int ci, int cj, struct blasfeo_dmat **sD, int di, int dj);
+// D[ii] <= alpha * B[ii] * A[ii]^{-T} , with A[ii] lower triangular
+void blasfeo_hp_dtrsm_rltn_batch(int nb, int m, int n, double alpha, struct blasfeo_dmat **sA, int ai, int aj, struct blasfeo_dmat **sB, int bi, int bj, struct blasfeo_dmat **sD, int di, int dj);
+// D[ii] <= chol( C[ii] ) ; C[ii], D[ii] lower triangular
+void blasfeo_hp_dpotrf_l_batch(int nb, int m, struct blasfeo_dmat **sC, int ci, int cj, struct blasfeo_dmat **sD, int di, int dj);
+
+
 
 #ifdef __cplusplus
 }
@@ -226,6 +226,14 @@ void blasfeo_ref_dsyr2k_lt(int m, int k, double alpha, struct blasfeo_dmat *sA,
 void blasfeo_ref_dsyr2k_un(int m, int k, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj);
 // D <= beta * C + alpha * A^T * B + alpha * B^T * A ; C, D upper triangular
 void blasfeo_ref_dsyr2k_ut(int m, int k, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj);
+// D <= beta * C + alpha * A * B, with A symmetric and only its lower triangle accessed
+void blasfeo_ref_dsymm_ll(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj);
+// D <= beta * C + alpha * A * B, with A symmetric and only its upper triangle accessed
+void blasfeo_ref_dsymm_lu(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj);
+// D <= beta * C + alpha * B * A, with A symmetric and only its lower triangle accessed
+void blasfeo_ref_dsymm_rl(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj);
+// D <= beta * C + alpha * B * A, with A symmetric and only its upper triangle accessed
+void blasfeo_ref_dsymm_ru(int m, int n, double alpha, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj, double beta, struct blasfeo_dmat *sC, int ci, int cj, struct blasfeo_dmat *sD, int di, int dj);
 
 // diagonal
 
@@ -275,6 +283,19 @@ void blasfeo_ref_dgelqf_pd_lla(int m, int n1, struct blasfeo_dmat *sL0, int l0i,
 
 
 
+//
+// batched routines: the same operation, with the same sizes and offsets, is applied to the nb matrices sX[0], ..., sX[nb-1]
+//
+
+// D[ii] <= beta * C[ii] + alpha * A[ii] * B[ii]^T
+void blasfeo_ref_dgemm_nt_batch(int nb, int m, int n, int k, double alpha, struct blasfeo_dmat **sA, int ai, int aj, struct blasfeo_dmat **sB, int bi, int bj, double beta, struct blasfeo_dmat **sC, int ci, int cj, struct blasfeo_dmat **sD, int di, int dj);
+// D[ii] <= alpha * B[ii] * A[ii]^{-T} , with A[ii] lower triangular
+void blasfeo_ref_dtrsm_rltn_batch(int nb, int m, int n, double alpha, struct blasfeo_dmat **sA, int ai, int aj, struct blasfeo_dmat **sB, int bi, int bj, struct blasfeo_dmat **sD, int di, int dj);
+// D[ii] <= chol( C[ii] ) ; C[ii], D[ii] lower triangular
+void blasfeo_ref_dpotrf_l_batch(int nb, int m, struct blasfeo_dmat **sC, int ci, int cj, struct blasfeo_dmat **sD, int di, int dj);
+
+
+
 #ifdef __cplusplus
 }
 #endif
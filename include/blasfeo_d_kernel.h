@@ -450,6 +450,8 @@ void kernel_dger4_sub_4r_vs_lib4(int n, double *A, double *B, double *C, int km)
 // 12x4
 void kernel_dpotrf_nt_l_12x4_lib4(int k, double *A, int sda, double *B, double *C, int sdc, double *D, int sdd, double *inv_diag_D);
 void kernel_dpotrf_nt_l_12x4_vs_lib4(int k, double *A, int sda, double *B, double *C, int sdc, double *D, int sdd, double *inv_diag_D, int km, int kn);
+void kernel_dsytrf_nt_l_12x4_lib4(int k, double *A, int sda, double *B, double *C, int sdc, double *D, int sdd, double *W, int sdw, double *inv_diag_D);
+void kernel_dsytrf_nt_l_12x4_vs_lib4(int k, double *A, int sda, double *B, double *C, int sdc, double *D, int sdd, double *W, int sdw, double *inv_diag_D, int km, int kn);
 void kernel_dgetrf_nn_l_12x4_lib4(int k, double *A, int sda, double *B, int sdb, double *C, int sdc, double *D, int sdd, double *inv_diag_D);
 void kernel_dgetrf_nn_l_12x4_vs_lib4(int k, double *A, int sda, double *B, int sdb, double *C, int sdc, double *D, int sdd, double *inv_diag_D, int km, int kn);
 void kernel_dgetrf_nn_m_12x4_lib4(int k, double *A, int sda, double *B, int sdb, double *C, int sdc, double *D, int sdd, double *inv_diag_D);
@@ -479,6 +481,8 @@ void kernel_dgetrf_nt_r_8x4_vs_lib4(int k, double *A, int sda, double *B, double
 // 4x4
 void kernel_dpotrf_nt_l_4x4_lib4(int k, double *A, double *B, double *C, double *D, double *inv_diag_D);
 void kernel_dpotrf_nt_l_4x4_vs_lib4(int k, double *A, double *B, double *C, double *D, double *inv_diag_D, int km, int kn);
+void kernel_dsytrf_nt_l_4x4_lib4(int k, double *A, double *B, double *C, double *D, double *W, double *inv_diag_D);
+void kernel_dsytrf_nt_l_4x4_vs_lib4(int k, double *A, double *B, double *C, double *D, double *W, double *inv_diag_D, int km, int kn);
 #if defined(TARGET_X64_INTEL_SANDY_BRIDGE)
 void kernel_dlauum_nt_4x4_lib4(int k, double *alpha, double *A, double *B, double *beta, double *C, double *D); //
 void kernel_dlauum_nt_4x4_vs_lib4(int k, double *alpha, double *A, double *B, double *beta, double *C, double *D, int km, int kn); //
@@ -1306,6 +1310,32 @@ void kernel_dpack_buffer_ft(int m, int n, double *A, int lda, double *pA, int sd
 void kernel_dpack_buffer_ln(int m, double *A, int lda, double *pA, int sda);
 void kernel_dpack_buffer_lt(int m, double *A, int lda, double *pA, int sda);
 void kernel_dpack_buffer_ut(int m, double *A, int lda, double *pA, int sda);
+void kernel_dpack_buffer_sl(int m, int n, int ii, int jj, double *A, int lda, double *pA, int sda);
+void kernel_dpack_buffer_su(int m, int n, int ii, int jj, double *A, int lda, double *pA, int sda);
+void kernel_dpacp_buffer_sl(int m, int n, int ii, int jj, int offA, double *A, int sda, double *pB, int sdb);
+void kernel_dpacp_buffer_su(int m, int n, int ii, int jj, int offA, double *A, int sda, double *pB, int sdb);
+void kernel_dpack_buffer_sl_lib8(int m, int n, int ii, int jj, double *A, int lda, double *pA, int sda);
+void kernel_dpack_buffer_su_lib8(int m, int n, int ii, int jj, double *A, int lda, double *pA, int sda);
+void kernel_dpacp_buffer_sl_lib8(int m, int n, int ii, int jj, int offA, double *A, int sda, double *pB, int sdb);
+void kernel_dpacp_buffer_su_lib8(int m, int n, int ii, int jj, int offA, double *A, int sda, double *pB, int sdb);
+
+
+
+// compact batch kernel sets selected at runtime (RUNTIME_DISPATCH)
+struct blasfeo_cb_dmat;
+struct blasfeo_cb_dkernels
+	{
+	void (*dgemm_nn)(int m, int n, int k, double alpha, struct blasfeo_cb_dmat *sA, int ai, int aj, struct blasfeo_cb_dmat *sB, int bi, int bj, double beta, struct blasfeo_cb_dmat *sC, int ci, int cj, struct blasfeo_cb_dmat *sD, int di, int dj);
+	void (*dgemm_nt)(int m, int n, int k, double alpha, struct blasfeo_cb_dmat *sA, int ai, int aj, struct blasfeo_cb_dmat *sB, int bi, int bj, double beta, struct blasfeo_cb_dmat *sC, int ci, int cj, struct blasfeo_cb_dmat *sD, int di, int dj);
+	void (*dtrsm_rltn)(int m, int n, double alpha, struct blasfeo_cb_dmat *sA, int ai, int aj, struct blasfeo_cb_dmat *sB, int bi, int bj, struct blasfeo_cb_dmat *sD, int di, int dj);
+	void (*dpotrf_l)(int m, struct blasfeo_cb_dmat *sC, int ci, int cj, struct blasfeo_cb_dmat *sD, int di, int dj);
+	void (*dgetrf_rp)(int m, int n, struct blasfeo_cb_dmat *sC, int ci, int cj, struct blasfeo_cb_dmat *sD, int di, int dj, int *ipiv);
+	void (*dpotrs_l)(int m, int n, struct blasfeo_cb_dmat *sA, int ai, int aj, struct blasfeo_cb_dmat *sB, int bi, int bj, struct blasfeo_cb_dmat *sD, int di, int dj);
+	};
+extern const struct blasfeo_cb_dkernels blasfeo_cb_dkernels_core;
+extern const struct blasfeo_cb_dkernels blasfeo_cb_dkernels_sandy_bridge;
+extern const struct blasfeo_cb_dkernels blasfeo_cb_dkernels_haswell;
+extern const struct blasfeo_cb_dkernels blasfeo_cb_dkernels_skylake_x;
 
 
 
@@ -0,0 +1,197 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2019 by Gianluca Frison.                                                          *
+* Developed at IMTEK (University of Freiburg) under the supervision of Moritz Diehl.              *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+#ifndef BLASFEO_D_RICCATI_H_
+#define BLASFEO_D_RICCATI_H_
+
+
+
+#include "blasfeo_common.h"
+
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+
+//
+// Riccati recursion for the equality-constrained optimal control problem with N stages
+//
+//   min   sum_{n=0}^{N} 1/2 [u_n; x_n]^T RSQ_n [u_n; x_n] + [r_n; q_n]^T [u_n; x_n]
+//   s.t.  x_{n+1} = B_n u_n + A_n x_n + b_n ,  n = 0, ..., N-1
+//
+// with nu[n] inputs and nx[n] states at stage n (x_0 is an optimization variable too: set nx[0]=0 to eliminate it).
+// The stage data is passed in arrays of N (or N+1) matrices and vectors, in the layout of the Riccati example:
+//   BAbt[n]  : (nu[n]+nx[n]+1) x nx[n+1] , [B_n^T; A_n^T; b_n^T]
+//   RSQrq[n] : (nu[n]+nx[n]+1) x (nu[n]+nx[n]) , [RSQ_n; r_n^T q_n^T] , only the lower triangular of RSQ_n is accessed
+//   b[n]     : nx[n+1]
+//   rq[n]    : nu[n]+nx[n] , [r_n; q_n]
+//   ux[n]    : nu[n]+nx[n] , solution [u_n; x_n]
+//   pi[n]    : nx[n+1] , equality constraints multipliers
+// The factorization is computed in the square-root form: at each stage the Cholesky factor of the cost-to-go
+// Hessian is propagated by one dtrmm_rlnn and one dsyrk_dpotrf_ln. These routines are wrappers of the BLASFEO API
+// calls of examples/example_d_riccati_recursion.c and do not add any kernel: the trmm is not fused with the
+// syrk+potrf, and the stage cost is the one of the example (see benchmarks/benchmark_d_riccati.c).
+// All factors and work matrices are stored in one contiguous workspace, created by blasfeo_create_driccati_ws
+// on memory of size blasfeo_memsize_driccati_ws, that can be reused for any problem with the same sizes.
+//
+
+struct blasfeo_driccati_ws
+	{
+	struct blasfeo_dmat *L; // N+1 factors, (nu[n]+nx[n]+1) x (nu[n]+nx[n])
+	struct blasfeo_dmat *AL; // work matrix, (max(nu[n]+nx[n])+1) x max(nx[n])
+	struct blasfeo_dvec *Pb; // N work vectors, nx[n+1]
+	struct blasfeo_dvec *tmp; // work vector, max(nx[n])
+	int N;
+	size_t memsize;
+	};
+
+// return the memory size (in bytes) needed for the Riccati workspace
+size_t blasfeo_memsize_driccati_ws(int N, int *nx, int *nu);
+// create the Riccati workspace by using memory passed by a pointer (pointer is not updated)
+void blasfeo_create_driccati_ws(int N, int *nx, int *nu, struct blasfeo_driccati_ws *ws, void *memory);
+
+// factorization only
+void blasfeo_driccati_trf(int N, int *nx, int *nu, struct blasfeo_dmat *BAbt, struct blasfeo_dmat *RSQrq, struct blasfeo_driccati_ws *ws);
+// solution for the vectors b and rq, using the factorization from blasfeo_driccati_trf
+void blasfeo_driccati_trs(int N, int *nx, int *nu, struct blasfeo_dmat *BAbt, struct blasfeo_dvec *b, struct blasfeo_dvec *rq, struct blasfeo_dvec *ux, struct blasfeo_dvec *pi, struct blasfeo_driccati_ws *ws);
+// factorization and solution, for the vectors b and [r q] stored in the last row of BAbt and RSQrq:
+// the backward substitution is carried out in the same kernel calls of the factorization
+void blasfeo_driccati_sv(int N, int *nx, int *nu, struct blasfeo_dmat *BAbt, struct blasfeo_dmat *RSQrq, struct blasfeo_dvec *ux, struct blasfeo_dvec *pi, struct blasfeo_driccati_ws *ws);
+
+
+
+
+//
+// Riccati recursion for the optimal control problem on a tree with Nn nodes (e.g. the scenario tree of robust MPC):
+// each node ii has nu[ii] inputs and nx[ii] states, and each node ii but the root has dynamics from its parent p=parent[ii]
+//
+//   x_ii = B_ii u_p + A_ii x_p + b_ii
+//
+// The stage data is indexed by node, in the same layout as above (the root has parent -1, and its BAbt, b, pi are not accessed):
+//   BAbt[ii] : (nu[p]+nx[p]+1) x nx[ii] , [B_ii^T; A_ii^T; b_ii^T]
+//   b[ii]    : nx[ii]
+//   pi[ii]   : nx[ii] , multipliers of the dynamics into node ii
+// while RSQrq, rq and ux are as above. The nodes are processed on the threads set by blasfeo_set_num_threads:
+// the leaves are handed out dynamically (the deepest first), and each node is processed as soon as all its children
+// are, by the thread that completes the last of them, so that no thread waits while there is work left.
+//
+
+struct blasfeo_driccati_tree_ws
+	{
+	struct blasfeo_dmat *L; // Nn factors, (nu[ii]+nx[ii]+1) x (nu[ii]+nx[ii])
+	struct blasfeo_dvec *Pb; // Nn work vectors, nx[ii]
+	struct blasfeo_dvec *tmp; // work vector, max(nx[ii])
+	int *parent; // parent of each node
+	int *kids_idx; // children of node ii are kids[kids_idx[ii]], ..., kids[kids_idx[ii+1]-1]
+	int *kids;
+	int *order; // nodes in breadth-first order from the root
+	int *leaves; // leaves, the deepest first
+	int *pending; // number of children not processed yet, updated during the recursion
+	int Nn;
+	int root;
+	int nleaves;
+	int nuxm; // max(nu[ii]+nx[ii])
+	int nxm; // max(nx[ii])
+	int next_leaf; // next leaf to process, updated during the recursion
+	size_t memsize;
+	};
+
+// return the memory size (in bytes) needed for the tree Riccati workspace
+size_t blasfeo_memsize_driccati_tree_ws(int Nn, int *nx, int *nu);
+// create the tree Riccati workspace by using memory passed by a pointer (pointer is not updated); the tree structure is copied
+void blasfeo_create_driccati_tree_ws(int Nn, int *parent, int *nx, int *nu, struct blasfeo_driccati_tree_ws *ws, void *memory);
+
+// factorization only, nodes processed in parallel
+void blasfeo_driccati_tree_trf(int Nn, int *nx, int *nu, struct blasfeo_dmat *BAbt, struct blasfeo_dmat *RSQrq, struct blasfeo_driccati_tree_ws *ws);
+// solution for the vectors b and rq, using the factorization from blasfeo_driccati_tree_trf;
+// the backward substitution is processed in parallel as the factorization, the forward substitution in breadth-first order
+void blasfeo_driccati_tree_trs(int Nn, int *nx, int *nu, struct blasfeo_dmat *BAbt, struct blasfeo_dvec *b, struct blasfeo_dvec *rq, struct blasfeo_dvec *ux, struct blasfeo_dvec *pi, struct blasfeo_driccati_tree_ws *ws);
+
+
+
+
+//
+// Parallel-in-time Riccati recursion for the problem with N stages above. The inputs of each stage are eliminated,
+// giving the conditional cost-to-go from x_n to x_{n+1} in the form
+//
+//   V_n(x, y) = max_l  1/2 x^T J x + p^T x - 1/2 l^T C l + l^T ( y - A x - b )
+//
+// (and the last stage gives the cost-to-go 1/2 x^T J x + p^T x, with no y). Two elements of consecutive stages
+// are combined into one of the same form by eliminating the state in between: the combination is associative, so
+// the cost-to-go of all stages is the suffix scan of the N+1 elements. This is evaluated on the threads set by
+// blasfeo_set_num_threads: the stages are split in one contiguous chunk per thread and each chunk is scanned
+// in parallel, then the chunk results are combined sequentially, and finally propagated back into each chunk
+// in parallel. The factors of all stages are then computed in parallel from the cost-to-go, and the forward
+// substitution is the same of blasfeo_driccati_sv.
+// A combination costs about 17 nx^3 flops and the scan about two combinations per stage, against about
+// (nu+nx)^2 nx + (nu+nx)^3/3 flops per stage of the sequential recursion: on a single thread blasfeo_driccati_pint_sv
+// is 3 to 5 times slower than blasfeo_driccati_sv (X64_INTEL_HASWELL, nx=4..16, N=100..2000), and since only the
+// combination of the chunk results is sequential, it can be faster only from about 5 threads up, on long horizons.
+// Use blasfeo_driccati_sv otherwise; benchmarks/benchmark_d_riccati_pint.c reports the crossover on the actual machine.
+// The matrices J are factorized by Cholesky, so the stage Hessians RSQ are assumed positive definite.
+//
+
+struct blasfeo_driccati_pint_ws
+	{
+	struct blasfeo_dmat *L; // N+1 factors, (nu[n]+nx[n]+1) x (nu[n]+nx[n])
+	struct blasfeo_dmat *At; // N+1 elements, (nx[n]+1) x max(nx[n]) , [A^T; b^T]
+	struct blasfeo_dmat *C; // N+1 elements, max(nx[n]) x max(nx[n])
+	struct blasfeo_dmat *Jp; // N+1 elements, (nx[n]+1) x nx[n] , [J; p^T]
+	struct blasfeo_dvec *tmp; // work vector, max(nx[n])
+	int *nx1; // size of y in each element, updated during the scan
+	int N;
+	int nuxm; // max(nu[n]+nx[n])
+	int nxm; // max(nx[n])
+	int num; // max(nu[n])
+	size_t memsize;
+	};
+
+// return the memory size (in bytes) needed for the parallel-in-time Riccati workspace
+size_t blasfeo_memsize_driccati_pint_ws(int N, int *nx, int *nu);
+// create the parallel-in-time Riccati workspace by using memory passed by a pointer (pointer is not updated)
+void blasfeo_create_driccati_pint_ws(int N, int *nx, int *nu, struct blasfeo_driccati_pint_ws *ws, void *memory);
+
+// factorization and solution, for the vectors b and [r q] stored in the last row of BAbt and RSQrq (as blasfeo_driccati_sv)
+void blasfeo_driccati_pint_sv(int N, int *nx, int *nu, struct blasfeo_dmat *BAbt, struct blasfeo_dmat *RSQrq, struct blasfeo_dvec *ux, struct blasfeo_dvec *pi, struct blasfeo_driccati_pint_ws *ws);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // BLASFEO_D_RICCATI_H_
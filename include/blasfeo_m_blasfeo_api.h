@@ -0,0 +1,77 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2019 by Gianluca Frison.                                                          *
+* Developed at IMTEK (University of Freiburg) under the supervision of Moritz Diehl.              *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+#ifndef BLASFEO_M_BLASFEO_API_H_
+#define BLASFEO_M_BLASFEO_API_H_
+
+
+
+#include <stdlib.h>
+
+#include "blasfeo_common.h"
+
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+
+//
+// mixed-precision LAPACK: factorization in single precision, iterative refinement in double precision
+//
+
+// x <= A^{-1} * b ; A is factorized by LU with row pivoting in single precision, and x is refined in double precision;
+// if the single-precision solution is not used, A (in place) and ipiv are overwritten by the double-precision LU factorization;
+// iter returns the number of refinement steps performed in double precision;
+// info returns 0 if x is the refined single-precision solution, or the reason for the double-precision fallback
+// (1: single-precision LU not usable, or not faster than the double-precision one for this n and target, 2: refinement stalled);
+// x and b must not overlap
+size_t blasfeo_dgesv_mixed_worksize(int n); // in bytes
+void blasfeo_dgesv_mixed(int n, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dvec *sb, int bi, struct blasfeo_dvec *sx, int xi, int *ipiv, int *iter, int *info, void *work);
+// x <= A^{-1} * b ; A is symmetric positive definite (only the lower triangular part is accessed), it is factorized by Cholesky in single precision, and x is refined in double precision;
+// if the single-precision solution is not used, the lower triangular part of A is overwritten (in place) by the double-precision Cholesky factorization;
+// iter and info as in blasfeo_dgesv_mixed; x and b must not overlap
+size_t blasfeo_dposv_mixed_worksize(int n); // in bytes
+void blasfeo_dposv_mixed(int n, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dvec *sb, int bi, struct blasfeo_dvec *sx, int xi, int *iter, int *info, void *work);
+
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // BLASFEO_M_BLASFEO_API_H_
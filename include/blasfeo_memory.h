@@ -43,14 +43,72 @@ extern "C" {
 
 
 
+#include <stdlib.h>
+
+
+
+// the packing buffer used by the BLAS API routines is private to the calling thread:
+// each thread running BLAS API routines concurrently has to call blasfeo_init (or blasfeo_init_buffer)
 //
 int blasfeo_is_init();
-//
+// allocate the packing buffer of the calling thread, and first touch it from the calling thread (i.e. on its NUMA node)
 void blasfeo_init();
-//
+// use the caller-provided memory (of size at least blasfeo_memsize_buffer()) as packing buffer of the calling thread
+void blasfeo_init_buffer(void *buffer);
+// size of the packing buffer in bytes
+size_t blasfeo_memsize_buffer();
+// release the packing buffer of the calling thread
 void blasfeo_quit();
 //
 void *blasfeo_get_buffer();
+// size of the workspace for the BLAS API routines with all dimensions up to n_max: it contains the packing buffer and all other internal allocations
+size_t blasfeo_memsize_workspace(int n_max);
+// use the caller-provided memory (of size at least blasfeo_memsize_workspace(n_max)) as workspace of the calling thread: routines with all dimensions up to n_max do not allocate memory
+// (the Riccati solvers and the batch routines need more, depending on the horizon and the batch size)
+void blasfeo_init_workspace(int n_max, void *work);
+
+// workspace binding of a thread, saved by blasfeo_workspace_push
+struct blasfeo_workspace_state
+	{
+	void *mem;
+	char *ws_mem;
+	char *ws_top;
+	char *ws_end;
+	char *ws_last;
+	size_t mem_size;
+	int mem_owned;
+	int initialized;
+	};
+// use work (of size at least blasfeo_memsize_workspace(n_max)) as workspace of the calling thread until the matching blasfeo_workspace_pop, saving the current binding in state
+void blasfeo_workspace_push(int n_max, void *work, struct blasfeo_workspace_state *state);
+// restore the workspace binding saved by blasfeo_workspace_push
+void blasfeo_workspace_pop(struct blasfeo_workspace_state *state);
+
+// failures of the internal allocations (bit flags)
+#define BLASFEO_WS_ERR_ALLOC 1 // an allocation did not fit in the workspace (with NO_INTERNAL_MALLOC) or the heap: the routine returned without computing
+#define BLASFEO_WS_ERR_FREE 2 // workspace blocks released out of order
+// failures of the internal allocations of the calling thread (and of the thread pool workers running its jobs) since the last call; 0 if none
+int blasfeo_get_workspace_error();
+// flag failures of the internal allocations of the calling thread (used by the thread pool to forward the failures of the workers)
+void blasfeo_set_workspace_error(int err);
+
+
+// cache sizes in bytes, detected at the first call (sysfs or cpuid, else the target defaults)
+size_t blasfeo_l1_cache_size();
+size_t blasfeo_l2_cache_size();
+size_t blasfeo_llc_cache_size();
+// double precision cache blocking of the BLAS API routines, computed at the first call from the cache sizes
+int blasfeo_d_kc();
+int blasfeo_d_nc();
+int blasfeo_d_mc();
+// read kc, nc and mc consistently, in one call
+void blasfeo_d_blocking(int *kc, int *nc, int *mc);
+// set the double precision cache blocking (0 for the value computed from the cache sizes); call it before blasfeo_init
+void blasfeo_set_d_blocking(int kc, int nc, int mc);
+// grow the packing buffer size required by blasfeo_is_init to fit the given blocking (used by blasfeo_set_d_blocking)
+void blasfeo_memsize_buffer_reserve(int kc, int nc, int mc);
+// time dgemm over candidate blockings and set the fastest one; if file_name is not NULL, the result is reused from (or saved to) that file; return 0 if not available in this build
+int blasfeo_autotune_d_blocking(char *file_name);
 
 
 
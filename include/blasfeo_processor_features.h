@@ -46,6 +46,8 @@
 //    BLASFEO_PROCESSOR_FEATURE_AVX2 = 0x0002,    /// AVX2 instruction set
 //    BLASFEO_PROCESSOR_FEATURE_FMA  = 0x0004,    /// FMA instruction set
 //    BLASFEO_PROCESSOR_FEATURE_SSE3 = 0x0008,    /// SSE3 instruction set
+//    BLASFEO_PROCESSOR_FEATURE_AVX512F = 0x0010, /// AVX-512 foundation instruction set
+//    BLASFEO_PROCESSOR_FEATURE_F16C = 0x0020,    /// half-precision conversion instructions
 //
 //    // ARM CPU features
 //    BLASFEO_PROCESSOR_FEATURE_VFPv3  = 0x0100,  /// VFPv3 instruction set
@@ -54,6 +56,15 @@
 //    BLASFEO_PROCESSOR_FEATURE_NEONv2 = 0x0100,  /// NEONv2 instruction set
 //} BLASFEO_PROCESSOR_FEATURES;
 
+/**
+ * Kernel sets that can be selected at runtime (in RUNTIME_DISPATCH builds)
+ */
+#define BLASFEO_PROCESSOR_ISA_CORE         1    /// SSE3
+#define BLASFEO_PROCESSOR_ISA_SANDY_BRIDGE 2    /// AVX
+#define BLASFEO_PROCESSOR_ISA_HASWELL      3    /// AVX2 and FMA
+#define BLASFEO_PROCESSOR_ISA_SKYLAKE_X    4    /// AVX-512F
+#define BLASFEO_PROCESSOR_ISA_ZEN5         5    /// AVX-512F, AMD processor
+
 /**
  * Test the features that this processor provides against what the library was compiled with.
  *
@@ -85,4 +96,11 @@ void blasfeo_processor_feature_string( int features, char* featureString );
  */
 void blasfeo_processor_library_string( char* featureString );
 
+/**
+ * Get the best kernel set supported by the current processor.
+ *
+ * @return One of the BLASFEO_PROCESSOR_ISA_* values
+ */
+int blasfeo_processor_isa( void );
+
 #endif  // BLASFEO_PROCESSOR_FEATURES_H_
@@ -175,6 +175,25 @@ void blasfeo_cm_create_smat(int m, int n, struct blasfeo_pm_smat *sA, void *memo
 
 
 
+/*
+* Half-precision storage matrix format
+*/
+
+// returns the memory size (in bytes) needed for a hs_smat
+size_t blasfeo_hs_memsize_smat(int m, int n);
+// create a hs_smat for a matrix of size m*n by using memory passed by a pointer (pointer is not updated)
+void blasfeo_hs_create_smat(int m, int n, struct blasfeo_hs_smat *sA, void *memory);
+// convert and pack the column-major matrix A into the matrix structure B (at row and col offsets bi and bj)
+void blasfeo_hs_pack_smat(int m, int n, float *A, int lda, struct blasfeo_hs_smat *sB, int bi, int bj);
+// convert and unpack the matrix structure A (at row and col offsets ai and aj) into the column-major matrix B
+void blasfeo_hs_unpack_smat(int m, int n, struct blasfeo_hs_smat *sA, int ai, int aj, float *B, int ldb);
+// B <= A, rounded to half precision (to nearest even)
+void blasfeo_hs_cvt_s2h_mat(int m, int n, struct blasfeo_smat *sA, int ai, int aj, struct blasfeo_hs_smat *sB, int bi, int bj);
+// B <= A
+void blasfeo_hs_cvt_h2s_mat(int m, int n, struct blasfeo_hs_smat *sA, int ai, int aj, struct blasfeo_smat *sB, int bi, int bj);
+
+
+
 #ifdef __cplusplus
 }
 #endif
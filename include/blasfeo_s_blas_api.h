@@ -40,6 +40,8 @@
 
 
 
+#include <stdlib.h>
+
 #include "blasfeo_target.h"
 
 
@@ -101,6 +103,20 @@ void strsm_(char *side, char *uplo, char *transa, char *diag, int *m, int *n, fl
 //
 void spotrf_(char *uplo, int *m, float *A, int *lda, int *info);
 
+// workspace-argument variants: the routine runs in the caller-provided work (of the size returned by the matching _worksize, in bytes) and does not allocate memory
+//
+size_t sgemm_worksize_(int *m, int *n, int *k);
+//
+void sgemm_ws_(char *ta, char *tb, int *m, int *n, int *k, float *alpha, float *A, int *lda, float *B, int *ldb, float *beta, float *C, int *ldc, void *work);
+//
+size_t strsm_worksize_(int *m, int *n);
+//
+void strsm_ws_(char *side, char *uplo, char *transa, char *diag, int *m, int *n, float *alpha, float *A, int *lda, float *B, int *ldb, void *work);
+//
+size_t spotrf_worksize_(int *m);
+//
+void spotrf_ws_(char *uplo, int *m, float *A, int *lda, int *info, void *work);
+
 
 
 #ifdef CBLAS_API
@@ -145,6 +161,20 @@ void blasfeo_blas_strsm(char *side, char *uplo, char *transa, char *diag, int *m
 //
 void blasfeo_lapack_spotrf(char *uplo, int *m, float *A, int *lda, int *info);
 
+// workspace-argument variants: the routine runs in the caller-provided work (of the size returned by the matching _worksize, in bytes) and does not allocate memory
+//
+size_t blasfeo_blas_sgemm_worksize(int *m, int *n, int *k);
+//
+void blasfeo_blas_sgemm_ws(char *ta, char *tb, int *m, int *n, int *k, float *alpha, float *A, int *lda, float *B, int *ldb, float *beta, float *C, int *ldc, void *work);
+//
+size_t blasfeo_blas_strsm_worksize(int *m, int *n);
+//
+void blasfeo_blas_strsm_ws(char *side, char *uplo, char *transa, char *diag, int *m, int *n, float *alpha, float *A, int *lda, float *B, int *ldb, void *work);
+//
+size_t blasfeo_lapack_spotrf_worksize(int *m);
+//
+void blasfeo_lapack_spotrf_ws(char *uplo, int *m, float *A, int *lda, int *info, void *work);
+
 
 
 #ifdef CBLAS_API
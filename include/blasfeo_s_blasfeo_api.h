@@ -272,6 +272,18 @@ void blasfeo_sgelqf_pd_lla(int m, int n1, struct blasfeo_smat *sL0, int l0i, int
 
 
 
+//
+// half-precision storage routines: A is stored in half precision, the computation is in single precision
+//
+
+// z <= beta * y + alpha * A * x
+void blasfeo_hs_sgemv_n(int m, int n, float alpha, struct blasfeo_hs_smat *sA, int ai, int aj, struct blasfeo_svec *sx, int xi, float beta, struct blasfeo_svec *sy, int yi, struct blasfeo_svec *sz, int zi);
+// z <= beta * y + alpha * A^T * x
+void blasfeo_hs_sgemv_t(int m, int n, float alpha, struct blasfeo_hs_smat *sA, int ai, int aj, struct blasfeo_svec *sx, int xi, float beta, struct blasfeo_svec *sy, int yi, struct blasfeo_svec *sz, int zi);
+
+
+
+
 //
 // BLAS API helper functions
 //
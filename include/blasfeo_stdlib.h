@@ -44,7 +44,11 @@ extern "C" {
 
 #include <stdlib.h>
 
-#ifdef EXT_DEP_MALLOC
+#if defined(NO_INTERNAL_MALLOC) & !defined(BLASFEO_EXPLICIT_MALLOC)
+// the computational routines take their memory from the workspace only: any heap allocation is a compile error
+#define blasfeo_malloc(ptr, size) _Static_assert(0, "heap allocation with NO_INTERNAL_MALLOC: use blasfeo_ws_malloc")
+#define blasfeo_malloc_align(ptr, size) _Static_assert(0, "heap allocation with NO_INTERNAL_MALLOC: use blasfeo_ws_malloc")
+#elif defined(EXT_DEP_MALLOC)
 //
 void blasfeo_malloc(void **ptr, size_t size);
 //
@@ -56,6 +60,12 @@ void blasfeo_free_align(void *ptr);
 #endif
 //
 void blasfeo_zero_memset(size_t memsize, void *mem);
+// allocate from the workspace of the calling thread (see blasfeo_init_workspace); fall back to the heap if it is too small;
+// on failure (always the case for a too small workspace with NO_INTERNAL_MALLOC) set *ptr to NULL and flag BLASFEO_WS_ERR_ALLOC:
+// the calling routine returns without computing
+void blasfeo_ws_malloc(void **ptr, size_t size);
+// release memory from blasfeo_ws_malloc; workspace blocks are released in reverse order of allocation (else BLASFEO_WS_ERR_FREE is flagged, and nothing released)
+void blasfeo_ws_free(void *ptr);
 
 
 
@@ -0,0 +1,115 @@
+#ifndef TARGET_X64_INTEL_HASWELL
+#define TARGET_X64_INTEL_HASWELL
+#endif
+
+#ifndef TARGET_PHANTOM
+#define TARGET_PHANTOM
+#endif
+
+#ifndef TARGET_NEED_FEATURE_AVX2
+#define TARGET_NEED_FEATURE_AVX2 1
+#endif
+
+#ifndef TARGET_NEED_FEATURE_FMA
+#define TARGET_NEED_FEATURE_FMA 1
+#endif
+
+#ifndef TARGET_NEED_FEATURE_SSE3
+/* #undef TARGET_NEED_FEATURE_SSE3 */
+#endif
+
+#ifndef TARGET_NEED_FEATURE_AVX512F
+/* #undef TARGET_NEED_FEATURE_AVX512F */
+#endif
+
+#ifndef TARGET_NEED_FEATURE_F16C
+#define TARGET_NEED_FEATURE_F16C 1
+#endif
+
+#ifndef TARGET_NEED_FEATURE_AVX
+/* #undef TARGET_NEED_FEATURE_AVX */
+#endif
+
+#ifndef TARGET_NEED_FEATURE_VFPv3
+/* #undef TARGET_NEED_FEATURE_VFPv3 */
+#endif
+
+#ifndef TARGET_NEED_FEATURE_NEON
+/* #undef TARGET_NEED_FEATURE_NEON */
+#endif
+
+#ifndef TARGET_NEED_FEATURE_VFPv4
+/* #undef TARGET_NEED_FEATURE_VFPv4 */
+#endif
+
+#ifndef TARGET_NEED_FEATURE_NEONv2
+/* #undef TARGET_NEED_FEATURE_NEONv2 */
+#endif
+
+#ifndef LA_HIGH_PERFORMANCE
+#define LA_HIGH_PERFORMANCE
+#endif
+
+#ifndef MF_PANELMAJ
+#define MF_PANELMAJ
+#endif
+
+#ifndef EXT_DEP
+#define ON 1
+#define OFF 0
+#if ON==ON
+#define EXT_DEP
+#endif
+#undef ON
+#undef OFF
+#endif
+
+#ifndef EXT_DEP_MALLOC
+#define ON 1
+#define OFF 0
+#if ON==ON
+#define EXT_DEP_MALLOC
+#endif
+#undef ON
+#undef OFF
+#endif
+
+#ifndef MULTITHREAD
+#define ON 1
+#define OFF 0
+#if OFF==ON
+#define MULTITHREAD
+#endif
+#undef ON
+#undef OFF
+#endif
+
+#ifndef RUNTIME_DISPATCH
+#define ON 1
+#define OFF 0
+#if ON==ON
+#define RUNTIME_DISPATCH
+#endif
+#undef ON
+#undef OFF
+#endif
+
+#ifndef BLAS_API
+#define ON 1
+#define OFF 0
+#if ON==ON
+#define BLAS_API
+#endif
+#undef ON
+#undef OFF
+#endif
+
+#ifndef FORTRAN_BLAS_API
+#define ON 1
+#define OFF 0
+#if OFF==ON
+#define FORTRAN_BLAS_API
+#endif
+#undef ON
+#undef OFF
+#endif
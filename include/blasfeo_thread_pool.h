@@ -0,0 +1,86 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2020 by Gianluca Frison.                                                          *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+#ifndef BLASFEO_THREAD_POOL_H_
+#define BLASFEO_THREAD_POOL_H_
+
+// the defaults can be overridden by the environment variables, read before the first use of the pool:
+// BLASFEO_NUM_THREADS=<n> : number of threads
+// BLASFEO_THREAD_AFFINITY=<cpu list, e.g. 0,2,4-7> | compact : worker pinning; compact uses the cpus available to the calling thread, in increasing order
+// BLASFEO_THREAD_SPIN=<n> : number of polling iterations before sleeping
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+
+#include <stdlib.h>
+
+
+
+// max number of threads in the pool (including the calling thread)
+#define BLASFEO_MAX_NUM_THREADS 256
+
+// default number of polling iterations before a waiting thread sleeps
+#define BLASFEO_THREAD_POOL_SPIN 10000
+
+
+
+// set the number of threads used by the multi-threaded routines (default 1, i.e. single-threaded); it has effect only if the library is compiled with MULTITHREAD
+void blasfeo_set_num_threads(int num_threads);
+// get the number of threads used by the multi-threaded routines
+int blasfeo_get_num_threads();
+// pin the worker thread tid (tid=1,...,num_threads-1) to cpus[tid%num_cpus] (Linux only); the calling thread (tid=0) is not pinned; num_cpus=0 disables pinning; the workers are re-created, and their packing buffers first touched, on the new cpus; return 1 on success
+int blasfeo_set_thread_affinity(int num_cpus, int *cpus);
+// set the number of polling iterations a waiting thread spins before sleeping (default BLASFEO_THREAD_POOL_SPIN); 0 sleeps immediately; threads never spin if they are more than the online cpus
+void blasfeo_set_thread_pool_spin(int spin);
+// size of the workspaces of the worker threads of jobs with up to num_threads threads and all dimensions up to n_max (0 if not MULTITHREAD)
+size_t blasfeo_memsize_thread_pool_workspace(int num_threads, int n_max);
+// use work (of size at least blasfeo_memsize_thread_pool_workspace(num_threads, n_max)) as workspace of the worker threads tid=1,...,num_threads-1 (see blasfeo_init_workspace);
+// the workers are re-created, and their internal allocation failures are reported to the calling thread by blasfeo_get_workspace_error; work=NULL releases it
+void blasfeo_set_thread_pool_workspace(int num_threads, int n_max, void *work);
+// execute fun(tid, num_threads, arg) for tid=0,...,num_threads-1; the calling thread executes tid=0; it falls back to serial execution (in increasing tid order) if called from within a parallel region or if the pool is in use
+void blasfeo_thread_pool_run(int num_threads, void (*fun)(int, int, void *), void *arg);
+// return 1 if called from within a parallel region, 0 otherwise
+int blasfeo_thread_pool_in_parallel();
+
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BLASFEO_THREAD_POOL_H_
@@ -0,0 +1,87 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2019 by Gianluca Frison.                                                          *
+* Developed at IMTEK (University of Freiburg) under the supervision of Moritz Diehl.              *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+#ifndef BLASFEO_Z_AUX_H_
+#define BLASFEO_Z_AUX_H_
+
+
+
+#include <stdlib.h>
+
+#include "blasfeo_common.h"
+
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+
+// complex numbers are passed as pointers to two doubles (real and imaginary part),
+// and complex arrays store them next to each other (the same layout as C99 double complex)
+
+// returns the memory size (in bytes) needed for a zmat
+size_t blasfeo_memsize_zmat(int m, int n);
+// create a zmat for a matrix of size m*n by using memory passed by a pointer (pointer is not updated)
+void blasfeo_create_zmat(int m, int n, struct blasfeo_zmat *sA, void *memory);
+// returns the memory size (in bytes) needed for a zvec
+size_t blasfeo_memsize_zvec(int m);
+// create a zvec for a vector of size m by using memory passed by a pointer (pointer is not updated)
+void blasfeo_create_zvec(int m, struct blasfeo_zvec *sa, void *memory);
+
+// pack the column-major complex matrix A (with leading dimension lda, in complex elements) into the matrix structure B (at row and col offsets bi and bj)
+void blasfeo_pack_zmat(int m, int n, double *A, int lda, struct blasfeo_zmat *sB, int bi, int bj);
+// unpack the matrix structure A (at row and col offsets ai and aj) into the column-major complex matrix B (with leading dimension ldb, in complex elements)
+void blasfeo_unpack_zmat(int m, int n, struct blasfeo_zmat *sA, int ai, int aj, double *B, int ldb);
+// pack the complex vector x (using increment incx) into the vector structure y (at offset yi)
+void blasfeo_pack_zvec(int m, double *x, int incx, struct blasfeo_zvec *sy, int yi);
+// unpack the vector structure x (at offset xi) into the complex vector y (using increment incy)
+void blasfeo_unpack_zvec(int m, struct blasfeo_zvec *sx, int xi, double *y, int incy);
+
+// B <= A
+void blasfeo_zgecp(int m, int n, struct blasfeo_zmat *sA, int ai, int aj, struct blasfeo_zmat *sB, int bi, int bj);
+// apply row permutation ipiv (as returned by blasfeo_zgetrf_rp) to the first kmax rows of A
+void blasfeo_zrowpe(int kmax, int *ipiv, struct blasfeo_zmat *sA);
+// apply permutation ipiv to the first kmax elements of x
+void blasfeo_zvecpe(int kmax, int *ipiv, struct blasfeo_zvec *sx, int xi);
+
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // BLASFEO_Z_AUX_H_
@@ -43,6 +43,7 @@
 #include "../../include/blasfeo_common.h"
 #include "../../include/blasfeo_d_aux.h"
 #include "../../include/blasfeo_d_kernel.h"
+#include "../../include/blasfeo_stdlib.h"
 
 
 
@@ -1349,7 +1350,9 @@ void kernel_dgetrf_pivot_8_vs_lib(int m, double *C, int ldc, double *pd, int* ip
 	if(m>K_MAX_STACK)
 		{
 		m4 = (m+3)/4*4;
-		tmp_pU = malloc(3*4*m4*sizeof(double)+64);
+		blasfeo_ws_malloc((void **) &tmp_pU, 3*4*m4*sizeof(double)+64);
+		if(tmp_pU==NULL)
+			return;
 		blasfeo_align_64_byte(tmp_pU, (void **) &pU);
 		sdu = m4;
 		}
@@ -1429,7 +1432,7 @@ void kernel_dgetrf_pivot_8_vs_lib(int m, double *C, int ldc, double *pd, int* ip
 	end:
 	if(m>K_MAX_STACK)
 		{
-		free(tmp_pU);
+		blasfeo_ws_free(tmp_pU);
 		}
 
 	return;
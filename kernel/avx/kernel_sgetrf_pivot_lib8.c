@@ -0,0 +1,230 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2019 by Gianluca Frison.                                                          *
+* Developed at IMTEK (University of Freiburg) under the supervision of Moritz Diehl.              *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+
+#include <mmintrin.h>
+#include <xmmintrin.h>  // SSE
+#include <emmintrin.h>  // SSE2
+#include <pmmintrin.h>  // SSE3
+#include <smmintrin.h>  // SSE4
+#include <immintrin.h>  // AVX
+
+#include "../../include/blasfeo_common.h"
+#include "../../include/blasfeo_s_kernel.h"
+
+
+
+// in-place unit lower triangular solve D <= E^{-1} * D, with E the 8x8 diagonal block
+void kernel_strsm_nn_ll_one_8x8_vs_lib8(float *E, float *D, int km, int kn)
+	{
+
+	const int bs = 8;
+
+	__m256
+		lft, msk, e_0, d_0, u_0;
+	
+	float
+		fk;
+
+	int jj, kk;
+
+	if(km>8)
+		km = 8;
+	if(kn>8)
+		kn = 8;
+
+	lft = _mm256_set_ps( 7.5, 6.5, 5.5, 4.5, 3.5, 2.5, 1.5, 0.5 );
+
+	for(kk=0; kk<km-1; kk++)
+		{
+		// rows (kk,km) of column kk of E
+		fk = kk+1;
+		msk = _mm256_cmp_ps( lft, _mm256_broadcast_ss( &fk ), 14 ); // >
+		fk = km;
+		msk = _mm256_and_ps( msk, _mm256_cmp_ps( lft, _mm256_broadcast_ss( &fk ), 1 ) ); // <
+		e_0 = _mm256_load_ps( &E[0+bs*kk] );
+		e_0 = _mm256_and_ps( e_0, msk );
+		for(jj=0; jj<kn; jj++)
+			{
+			u_0 = _mm256_broadcast_ss( &D[kk+bs*jj] );
+			d_0 = _mm256_load_ps( &D[0+bs*jj] );
+			d_0 = _mm256_sub_ps( d_0, _mm256_mul_ps( e_0, u_0 ) );
+			_mm256_store_ps( &D[0+bs*jj], d_0 );
+			}
+		}
+
+	return;
+
+	}
+
+
+
+// C numering (starting from zero) in the ipiv
+// it factorizes min(m,n) columns of the m x n (n<=8) panel-aligned block pA,
+// row exchanges and eliminations are applied to all the n columns;
+// the scaling of column jj, the update of the columns on its right and the
+// pivot search in column jj+1 are fused into a single sweep over the row panels
+void kernel_sgetrf_pivot_8_vs_lib8(int m, int n, float *pA, int sda, float *inv_diag_A, int* ipiv)
+	{
+
+	const int bs = 8;
+
+	__m256
+		lft, vna, msk, idx, max, imx, sgn,
+		a_0, c_0, scl, u_0;
+	
+	float
+		fk, tmp, amax, inv,
+		max_v[8], imx_v[8];
+
+	float
+		*pB, *pP;
+
+	int
+		ii, jj, kk, ll, ip;
+
+	if(n>8)
+		n = 8;
+	int p = m<n ? m : n;
+
+	if(p<=0)
+		return;
+
+	sgn = _mm256_set1_ps( -0.0 );
+	vna = _mm256_set1_ps( 8.0 );
+	lft = _mm256_set_ps( 7.5, 6.5, 5.5, 4.5, 3.5, 2.5, 1.5, 0.5 );
+
+	// find pivot in the first column
+	pB = pA;
+	idx = _mm256_set_ps( 7.0, 6.0, 5.0, 4.0, 3.0, 2.0, 1.0, 0.0 );
+	max = _mm256_setzero_ps();
+	imx = _mm256_setzero_ps();
+	for(ii=0; ii<m; ii+=8)
+		{
+		fk = m-ii;
+		msk = _mm256_cmp_ps( lft, _mm256_broadcast_ss( &fk ), 1 ); // <
+		a_0 = _mm256_load_ps( &pB[0] );
+		a_0 = _mm256_andnot_ps( sgn, a_0 ); // abs
+		a_0 = _mm256_and_ps( a_0, msk );
+		msk = _mm256_cmp_ps( a_0, max, 14 ); // >
+		max = _mm256_blendv_ps( max, a_0, msk );
+		imx = _mm256_blendv_ps( imx, idx, msk );
+		idx = _mm256_add_ps( idx, vna );
+		pB += bs*sda;
+		}
+
+	for(jj=0; jj<p; jj++)
+		{
+
+		// reduce pivot, lowest index in case of identical max value
+		_mm256_storeu_ps( max_v, max );
+		_mm256_storeu_ps( imx_v, imx );
+		amax = max_v[0];
+		tmp = imx_v[0];
+		for(ll=1; ll<8; ll++)
+			{
+			if(max_v[ll]>amax | (max_v[ll]==amax & imx_v[ll]<tmp))
+				{
+				amax = max_v[ll];
+				tmp = imx_v[ll];
+				}
+			}
+		ip = amax!=0.0 ? (int) tmp : jj;
+		ipiv[jj] = ip;
+
+		// swap & compute scaling
+		if(ip!=jj)
+			{
+			pP = pA + ip/bs*bs*sda + ip%bs;
+			for(kk=0; kk<n; kk++)
+				{
+				tmp = pA[jj+bs*kk];
+				pA[jj+bs*kk] = pP[bs*kk];
+				pP[bs*kk] = tmp;
+				}
+			}
+		if(amax!=0.0)
+			inv = 1.0 / pA[jj+bs*jj];
+		else
+			inv = 0.0;
+		inv_diag_A[jj] = inv;
+		scl = _mm256_broadcast_ss( &inv );
+
+		// scale, update the columns on the right, find pivot in the next column
+		pB = pA;
+		idx = _mm256_set_ps( 7.0, 6.0, 5.0, 4.0, 3.0, 2.0, 1.0, 0.0 );
+		max = _mm256_setzero_ps();
+		imx = _mm256_setzero_ps();
+		for(ii=0; ii<m; ii+=8)
+			{
+			// rows (jj,m) of the row panel
+			fk = m-ii;
+			msk = _mm256_cmp_ps( lft, _mm256_broadcast_ss( &fk ), 1 ); // <
+			if(ii==0)
+				{
+				fk = jj+1;
+				msk = _mm256_and_ps( msk, _mm256_cmp_ps( lft, _mm256_broadcast_ss( &fk ), 14 ) ); // >
+				}
+			a_0 = _mm256_load_ps( &pB[0+bs*jj] );
+			a_0 = _mm256_mul_ps( a_0, scl );
+			a_0 = _mm256_blendv_ps( _mm256_load_ps( &pB[0+bs*jj] ), a_0, msk );
+			_mm256_store_ps( &pB[0+bs*jj], a_0 );
+			a_0 = _mm256_and_ps( a_0, msk );
+			for(kk=jj+1; kk<n; kk++)
+				{
+				u_0 = _mm256_broadcast_ss( &pA[jj+bs*kk] );
+				c_0 = _mm256_load_ps( &pB[0+bs*kk] );
+				c_0 = _mm256_sub_ps( c_0, _mm256_mul_ps( a_0, u_0 ) );
+				_mm256_store_ps( &pB[0+bs*kk], c_0 );
+				}
+			if(jj+1<p)
+				{
+				// the pivot of the next column is searched in rows (jj,m)
+				c_0 = _mm256_load_ps( &pB[0+bs*(jj+1)] );
+				c_0 = _mm256_andnot_ps( sgn, c_0 ); // abs
+				c_0 = _mm256_and_ps( c_0, msk );
+				msk = _mm256_cmp_ps( c_0, max, 14 ); // >
+				max = _mm256_blendv_ps( max, c_0, msk );
+				imx = _mm256_blendv_ps( imx, idx, msk );
+				}
+			idx = _mm256_add_ps( idx, vna );
+			pB += bs*sda;
+			}
+
+		}
+
+	return;
+
+	}
@@ -0,0 +1,347 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2019 by Gianluca Frison.                                                          *
+* Developed at IMTEK (University of Freiburg) under the supervision of Moritz Diehl.              *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+#include <mmintrin.h>
+#include <xmmintrin.h>  // SSE
+#include <emmintrin.h>  // SSE2
+#include <pmmintrin.h>  // SSE3
+#include <smmintrin.h>  // SSE4
+#include <immintrin.h>  // AVX
+
+#include <blasfeo_common.h>
+#include <blasfeo_z_kernel.h>
+
+
+
+// complex numbers are stored as (real, imaginary) pairs, and a panel column holds 4 of them:
+// a 4x4 block is kept in 8 ymm accumulators, acc[2*jj+0] for rows 0-1 and acc[2*jj+1] for rows 2-3 of column jj.
+// a*b is computed as a*re(b) + swap(a)*im(b)*[-1 1], with the sign flip applied to the (swapped) A column,
+// so that each element of B costs one broadcast and one fma
+
+
+
+// D <= alpha * acc + beta * C , for the top-left m1 x n1 block
+static inline void kernel_zgemm_store_4x4_lib4(__m256d *acc, double *alpha, double *beta, double *C, double *D, int m1, int n1)
+	{
+
+	const int bs = 4;
+
+	int jj;
+
+	__m256d
+		sgn, alpha_r, alpha_i, beta_r, beta_i,
+		v0, v1, c0, c1;
+	
+	__m256i
+		mask0, mask1;
+
+	sgn = _mm256_set_pd( 0.0, -0.0, 0.0, -0.0 );
+
+	alpha_r = _mm256_broadcast_sd( &alpha[0] );
+	alpha_i = _mm256_broadcast_sd( &alpha[1] );
+
+	int use_beta = beta[0]!=0.0 | beta[1]!=0.0;
+	beta_r = _mm256_broadcast_sd( &beta[0] );
+	beta_i = _mm256_broadcast_sd( &beta[1] );
+
+	// element mask of rows 0-1 and 2-3
+	mask0 = _mm256_castpd_si256( _mm256_sub_pd( _mm256_set_pd( 1.5, 1.5, 0.5, 0.5 ), _mm256_set1_pd( (double) m1 ) ) );
+	mask1 = _mm256_castpd_si256( _mm256_sub_pd( _mm256_set_pd( 3.5, 3.5, 2.5, 2.5 ), _mm256_set1_pd( (double) m1 ) ) );
+
+	for(jj=0; jj<bs & jj<n1; jj++)
+		{
+		// alpha * acc
+		v0 = acc[2*jj+0];
+		v1 = acc[2*jj+1];
+		c0 = _mm256_xor_pd( _mm256_permute_pd( v0, 0x5 ), sgn );
+		c1 = _mm256_xor_pd( _mm256_permute_pd( v1, 0x5 ), sgn );
+		v0 = _mm256_mul_pd( v0, alpha_r );
+		v1 = _mm256_mul_pd( v1, alpha_r );
+		v0 = _mm256_fmadd_pd( c0, alpha_i, v0 );
+		v1 = _mm256_fmadd_pd( c1, alpha_i, v1 );
+		// + beta * C ; C is not accessed if beta is zero
+		if(use_beta)
+			{
+			c0 = _mm256_load_pd( &C[0+2*bs*jj] );
+			c1 = _mm256_load_pd( &C[4+2*bs*jj] );
+			v0 = _mm256_fmadd_pd( c0, beta_r, v0 );
+			v1 = _mm256_fmadd_pd( c1, beta_r, v1 );
+			c0 = _mm256_xor_pd( _mm256_permute_pd( c0, 0x5 ), sgn );
+			c1 = _mm256_xor_pd( _mm256_permute_pd( c1, 0x5 ), sgn );
+			v0 = _mm256_fmadd_pd( c0, beta_i, v0 );
+			v1 = _mm256_fmadd_pd( c1, beta_i, v1 );
+			}
+		if(m1>=bs)
+			{
+			_mm256_store_pd( &D[0+2*bs*jj], v0 );
+			_mm256_store_pd( &D[4+2*bs*jj], v1 );
+			}
+		else
+			{
+			_mm256_maskstore_pd( &D[0+2*bs*jj], mask0, v0 );
+			_mm256_maskstore_pd( &D[4+2*bs*jj], mask1, v1 );
+			}
+		}
+
+	return;
+
+	}
+
+
+
+// acc <= A * B^T , or A * B^H if conj is not zero
+static inline void kernel_zgemm_acc_nt_4x4_lib4(int kmax, double *A, double *B, int conj, __m256d *acc)
+	{
+
+	const int bs = 4;
+
+	int kk;
+
+	__m256d
+		sgn,
+		a0, a1, s0, s1, br, bi,
+		d00, d10, d01, d11, d02, d12, d03, d13;
+	
+	// the sign of the imaginary part of B is folded in the sign flip of the swapped A
+	sgn = conj ? _mm256_set_pd( -0.0, 0.0, -0.0, 0.0 ) : _mm256_set_pd( 0.0, -0.0, 0.0, -0.0 );
+
+	d00 = _mm256_setzero_pd();
+	d10 = _mm256_setzero_pd();
+	d01 = _mm256_setzero_pd();
+	d11 = _mm256_setzero_pd();
+	d02 = _mm256_setzero_pd();
+	d12 = _mm256_setzero_pd();
+	d03 = _mm256_setzero_pd();
+	d13 = _mm256_setzero_pd();
+
+	for(kk=0; kk<kmax; kk++)
+		{
+		a0 = _mm256_load_pd( &A[0] );
+		a1 = _mm256_load_pd( &A[4] );
+		s0 = _mm256_xor_pd( _mm256_permute_pd( a0, 0x5 ), sgn );
+		s1 = _mm256_xor_pd( _mm256_permute_pd( a1, 0x5 ), sgn );
+
+		br = _mm256_broadcast_sd( &B[0] );
+		bi = _mm256_broadcast_sd( &B[1] );
+		d00 = _mm256_fmadd_pd( a0, br, d00 );
+		d10 = _mm256_fmadd_pd( a1, br, d10 );
+		d00 = _mm256_fmadd_pd( s0, bi, d00 );
+		d10 = _mm256_fmadd_pd( s1, bi, d10 );
+
+		br = _mm256_broadcast_sd( &B[2] );
+		bi = _mm256_broadcast_sd( &B[3] );
+		d01 = _mm256_fmadd_pd( a0, br, d01 );
+		d11 = _mm256_fmadd_pd( a1, br, d11 );
+		d01 = _mm256_fmadd_pd( s0, bi, d01 );
+		d11 = _mm256_fmadd_pd( s1, bi, d11 );
+
+		br = _mm256_broadcast_sd( &B[4] );
+		bi = _mm256_broadcast_sd( &B[5] );
+		d02 = _mm256_fmadd_pd( a0, br, d02 );
+		d12 = _mm256_fmadd_pd( a1, br, d12 );
+		d02 = _mm256_fmadd_pd( s0, bi, d02 );
+		d12 = _mm256_fmadd_pd( s1, bi, d12 );
+
+		br = _mm256_broadcast_sd( &B[6] );
+		bi = _mm256_broadcast_sd( &B[7] );
+		d03 = _mm256_fmadd_pd( a0, br, d03 );
+		d13 = _mm256_fmadd_pd( a1, br, d13 );
+		d03 = _mm256_fmadd_pd( s0, bi, d03 );
+		d13 = _mm256_fmadd_pd( s1, bi, d13 );
+
+		A += 2*bs;
+		B += 2*bs;
+		}
+
+	acc[0] = d00;
+	acc[1] = d10;
+	acc[2] = d01;
+	acc[3] = d11;
+	acc[4] = d02;
+	acc[5] = d12;
+	acc[6] = d03;
+	acc[7] = d13;
+
+	return;
+
+	}
+
+
+
+void kernel_zgemm_nt_4x4_lib4(int kmax, double *alpha, double *A, double *B, double *beta, double *C, double *D)
+	{
+	__m256d acc[8];
+	kernel_zgemm_acc_nt_4x4_lib4(kmax, A, B, 0, acc);
+	kernel_zgemm_store_4x4_lib4(acc, alpha, beta, C, D, 4, 4);
+	return;
+	}
+
+
+
+void kernel_zgemm_nt_4x4_vs_lib4(int kmax, double *alpha, double *A, double *B, double *beta, double *C, double *D, int m1, int n1)
+	{
+	__m256d acc[8];
+	kernel_zgemm_acc_nt_4x4_lib4(kmax, A, B, 0, acc);
+	kernel_zgemm_store_4x4_lib4(acc, alpha, beta, C, D, m1, n1);
+	return;
+	}
+
+
+
+void kernel_zgemm_nc_4x4_lib4(int kmax, double *alpha, double *A, double *B, double *beta, double *C, double *D)
+	{
+	__m256d acc[8];
+	kernel_zgemm_acc_nt_4x4_lib4(kmax, A, B, 1, acc);
+	kernel_zgemm_store_4x4_lib4(acc, alpha, beta, C, D, 4, 4);
+	return;
+	}
+
+
+
+void kernel_zgemm_nc_4x4_vs_lib4(int kmax, double *alpha, double *A, double *B, double *beta, double *C, double *D, int m1, int n1)
+	{
+	__m256d acc[8];
+	kernel_zgemm_acc_nt_4x4_lib4(kmax, A, B, 1, acc);
+	kernel_zgemm_store_4x4_lib4(acc, alpha, beta, C, D, m1, n1);
+	return;
+	}
+
+
+
+// acc <= A * B , with B starting at row offsetB of its panel
+static inline void kernel_zgemm_acc_nn_4x4_lib4(int kmax, double *A, int offsetB, double *B, int sdb, __m256d *acc)
+	{
+
+	const int bs = 4;
+
+	int kk;
+
+	__m256d
+		sgn,
+		a0, a1, s0, s1, br, bi,
+		d00, d10, d01, d11, d02, d12, d03, d13;
+	
+	sgn = _mm256_set_pd( 0.0, -0.0, 0.0, -0.0 );
+
+	d00 = _mm256_setzero_pd();
+	d10 = _mm256_setzero_pd();
+	d01 = _mm256_setzero_pd();
+	d11 = _mm256_setzero_pd();
+	d02 = _mm256_setzero_pd();
+	d12 = _mm256_setzero_pd();
+	d03 = _mm256_setzero_pd();
+	d13 = _mm256_setzero_pd();
+
+	double *pB = B + 2*offsetB;
+	int offB = offsetB;
+
+	for(kk=0; kk<kmax; kk++)
+		{
+		a0 = _mm256_load_pd( &A[0] );
+		a1 = _mm256_load_pd( &A[4] );
+		s0 = _mm256_xor_pd( _mm256_permute_pd( a0, 0x5 ), sgn );
+		s1 = _mm256_xor_pd( _mm256_permute_pd( a1, 0x5 ), sgn );
+
+		br = _mm256_broadcast_sd( &pB[0+2*bs*0] );
+		bi = _mm256_broadcast_sd( &pB[1+2*bs*0] );
+		d00 = _mm256_fmadd_pd( a0, br, d00 );
+		d10 = _mm256_fmadd_pd( a1, br, d10 );
+		d00 = _mm256_fmadd_pd( s0, bi, d00 );
+		d10 = _mm256_fmadd_pd( s1, bi, d10 );
+
+		br = _mm256_broadcast_sd( &pB[0+2*bs*1] );
+		bi = _mm256_broadcast_sd( &pB[1+2*bs*1] );
+		d01 = _mm256_fmadd_pd( a0, br, d01 );
+		d11 = _mm256_fmadd_pd( a1, br, d11 );
+		d01 = _mm256_fmadd_pd( s0, bi, d01 );
+		d11 = _mm256_fmadd_pd( s1, bi, d11 );
+
+		br = _mm256_broadcast_sd( &pB[0+2*bs*2] );
+		bi = _mm256_broadcast_sd( &pB[1+2*bs*2] );
+		d02 = _mm256_fmadd_pd( a0, br, d02 );
+		d12 = _mm256_fmadd_pd( a1, br, d12 );
+		d02 = _mm256_fmadd_pd( s0, bi, d02 );
+		d12 = _mm256_fmadd_pd( s1, bi, d12 );
+
+		br = _mm256_broadcast_sd( &pB[0+2*bs*3] );
+		bi = _mm256_broadcast_sd( &pB[1+2*bs*3] );
+		d03 = _mm256_fmadd_pd( a0, br, d03 );
+		d13 = _mm256_fmadd_pd( a1, br, d13 );
+		d03 = _mm256_fmadd_pd( s0, bi, d03 );
+		d13 = _mm256_fmadd_pd( s1, bi, d13 );
+
+		A += 2*bs;
+		pB += 2;
+		offB++;
+		if(offB==bs)
+			{
+			pB += 2*bs*sdb - 2*bs;
+			offB = 0;
+			}
+		}
+
+	acc[0] = d00;
+	acc[1] = d10;
+	acc[2] = d01;
+	acc[3] = d11;
+	acc[4] = d02;
+	acc[5] = d12;
+	acc[6] = d03;
+	acc[7] = d13;
+
+	return;
+
+	}
+
+
+
+void kernel_zgemm_nn_4x4_lib4(int kmax, double *alpha, double *A, int offsetB, double *B, int sdb, double *beta, double *C, double *D)
+	{
+	__m256d acc[8];
+	kernel_zgemm_acc_nn_4x4_lib4(kmax, A, offsetB, B, sdb, acc);
+	kernel_zgemm_store_4x4_lib4(acc, alpha, beta, C, D, 4, 4);
+	return;
+	}
+
+
+
+void kernel_zgemm_nn_4x4_vs_lib4(int kmax, double *alpha, double *A, int offsetB, double *B, int sdb, double *beta, double *C, double *D, int m1, int n1)
+	{
+	__m256d acc[8];
+	kernel_zgemm_acc_nn_4x4_lib4(kmax, A, offsetB, B, sdb, acc);
+	kernel_zgemm_store_4x4_lib4(acc, alpha, beta, C, D, m1, n1);
+	return;
+	}
+
@@ -0,0 +1,286 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2019 by Gianluca Frison.                                                          *
+* Developed at IMTEK (University of Freiburg) under the supervision of Moritz Diehl.              *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+#include <mmintrin.h>
+#include <xmmintrin.h>  // SSE
+#include <emmintrin.h>  // SSE2
+#include <pmmintrin.h>  // SSE3
+#include <smmintrin.h>  // SSE4
+#include <immintrin.h>  // AVX
+
+#include <blasfeo_common.h>
+#include <blasfeo_z_kernel.h>
+
+
+
+// complex numbers are stored as (real, imaginary) pairs, and a panel column holds 4 of them:
+// a 4x4 block is kept in 4 zmm registers, one per column.
+// a*b is computed as a*re(b) + swap(a)*im(b)*[-1 1], accumulating the two terms in separate registers
+// to have 8 independent fma chains
+
+
+
+// D <= alpha * acc + beta * C , for the top-left m1 x n1 block
+static inline void kernel_zgemm_store_4x4_lib4(__m512d *acc, double *alpha, double *beta, double *C, double *D, int m1, int n1)
+	{
+
+	const int bs = 4;
+
+	int jj;
+
+	__m512d
+		sgn, alpha_r, alpha_i, beta_r, beta_i,
+		v0, c0;
+	
+	__mmask8
+		mask;
+
+	sgn = _mm512_set_pd( 0.0, -0.0, 0.0, -0.0, 0.0, -0.0, 0.0, -0.0 );
+
+	alpha_r = _mm512_set1_pd( alpha[0] );
+	alpha_i = _mm512_set1_pd( alpha[1] );
+
+	int use_beta = beta[0]!=0.0 | beta[1]!=0.0;
+	beta_r = _mm512_set1_pd( beta[0] );
+	beta_i = _mm512_set1_pd( beta[1] );
+
+	mask = m1>=bs ? 0xff : (__mmask8) ((1<<(2*m1))-1);
+
+	for(jj=0; jj<bs & jj<n1; jj++)
+		{
+		// alpha * acc
+		v0 = acc[jj];
+		c0 = _mm512_castsi512_pd( _mm512_xor_si512( _mm512_castpd_si512( _mm512_permute_pd( v0, 0x55 ) ), _mm512_castpd_si512( sgn ) ) );
+		v0 = _mm512_mul_pd( v0, alpha_r );
+		v0 = _mm512_fmadd_pd( c0, alpha_i, v0 );
+		// + beta * C ; C is not accessed if beta is zero
+		if(use_beta)
+			{
+			c0 = _mm512_load_pd( &C[2*bs*jj] );
+			v0 = _mm512_fmadd_pd( c0, beta_r, v0 );
+			c0 = _mm512_castsi512_pd( _mm512_xor_si512( _mm512_castpd_si512( _mm512_permute_pd( c0, 0x55 ) ), _mm512_castpd_si512( sgn ) ) );
+			v0 = _mm512_fmadd_pd( c0, beta_i, v0 );
+			}
+		_mm512_mask_store_pd( &D[2*bs*jj], mask, v0 );
+		}
+
+	return;
+
+	}
+
+
+
+// acc <= A * B^T , or A * B^H if conj is not zero
+static inline void kernel_zgemm_acc_nt_4x4_lib4(int kmax, double *A, double *B, int conj, __m512d *acc)
+	{
+
+	const int bs = 4;
+
+	int kk;
+
+	__m512d
+		sgn,
+		a0, s0,
+		r0, r1, r2, r3,
+		i0, i1, i2, i3;
+	
+	__m512i
+		isgn;
+
+	// the sign of the imaginary part of B is folded in the sign flip of the swapped A
+	sgn = conj ? _mm512_set_pd( -0.0, 0.0, -0.0, 0.0, -0.0, 0.0, -0.0, 0.0 ) : _mm512_set_pd( 0.0, -0.0, 0.0, -0.0, 0.0, -0.0, 0.0, -0.0 );
+	isgn = _mm512_castpd_si512( sgn );
+
+	r0 = _mm512_setzero_pd();
+	r1 = _mm512_setzero_pd();
+	r2 = _mm512_setzero_pd();
+	r3 = _mm512_setzero_pd();
+	i0 = _mm512_setzero_pd();
+	i1 = _mm512_setzero_pd();
+	i2 = _mm512_setzero_pd();
+	i3 = _mm512_setzero_pd();
+
+	for(kk=0; kk<kmax; kk++)
+		{
+		a0 = _mm512_load_pd( &A[0] );
+		s0 = _mm512_castsi512_pd( _mm512_xor_si512( _mm512_castpd_si512( _mm512_permute_pd( a0, 0x55 ) ), isgn ) );
+
+		r0 = _mm512_fmadd_pd( a0, _mm512_set1_pd( B[0] ), r0 );
+		i0 = _mm512_fmadd_pd( s0, _mm512_set1_pd( B[1] ), i0 );
+		r1 = _mm512_fmadd_pd( a0, _mm512_set1_pd( B[2] ), r1 );
+		i1 = _mm512_fmadd_pd( s0, _mm512_set1_pd( B[3] ), i1 );
+		r2 = _mm512_fmadd_pd( a0, _mm512_set1_pd( B[4] ), r2 );
+		i2 = _mm512_fmadd_pd( s0, _mm512_set1_pd( B[5] ), i2 );
+		r3 = _mm512_fmadd_pd( a0, _mm512_set1_pd( B[6] ), r3 );
+		i3 = _mm512_fmadd_pd( s0, _mm512_set1_pd( B[7] ), i3 );
+
+		A += 2*bs;
+		B += 2*bs;
+		}
+
+	acc[0] = _mm512_add_pd( r0, i0 );
+	acc[1] = _mm512_add_pd( r1, i1 );
+	acc[2] = _mm512_add_pd( r2, i2 );
+	acc[3] = _mm512_add_pd( r3, i3 );
+
+	return;
+
+	}
+
+
+
+void kernel_zgemm_nt_4x4_lib4(int kmax, double *alpha, double *A, double *B, double *beta, double *C, double *D)
+	{
+	__m512d acc[4];
+	kernel_zgemm_acc_nt_4x4_lib4(kmax, A, B, 0, acc);
+	kernel_zgemm_store_4x4_lib4(acc, alpha, beta, C, D, 4, 4);
+	return;
+	}
+
+
+
+void kernel_zgemm_nt_4x4_vs_lib4(int kmax, double *alpha, double *A, double *B, double *beta, double *C, double *D, int m1, int n1)
+	{
+	__m512d acc[4];
+	kernel_zgemm_acc_nt_4x4_lib4(kmax, A, B, 0, acc);
+	kernel_zgemm_store_4x4_lib4(acc, alpha, beta, C, D, m1, n1);
+	return;
+	}
+
+
+
+void kernel_zgemm_nc_4x4_lib4(int kmax, double *alpha, double *A, double *B, double *beta, double *C, double *D)
+	{
+	__m512d acc[4];
+	kernel_zgemm_acc_nt_4x4_lib4(kmax, A, B, 1, acc);
+	kernel_zgemm_store_4x4_lib4(acc, alpha, beta, C, D, 4, 4);
+	return;
+	}
+
+
+
+void kernel_zgemm_nc_4x4_vs_lib4(int kmax, double *alpha, double *A, double *B, double *beta, double *C, double *D, int m1, int n1)
+	{
+	__m512d acc[4];
+	kernel_zgemm_acc_nt_4x4_lib4(kmax, A, B, 1, acc);
+	kernel_zgemm_store_4x4_lib4(acc, alpha, beta, C, D, m1, n1);
+	return;
+	}
+
+
+
+// acc <= A * B , with B starting at row offsetB of its panel
+static inline void kernel_zgemm_acc_nn_4x4_lib4(int kmax, double *A, int offsetB, double *B, int sdb, __m512d *acc)
+	{
+
+	const int bs = 4;
+
+	int kk;
+
+	__m512d
+		a0, s0,
+		r0, r1, r2, r3,
+		i0, i1, i2, i3;
+	
+	__m512i
+		isgn;
+
+	isgn = _mm512_castpd_si512( _mm512_set_pd( 0.0, -0.0, 0.0, -0.0, 0.0, -0.0, 0.0, -0.0 ) );
+
+	r0 = _mm512_setzero_pd();
+	r1 = _mm512_setzero_pd();
+	r2 = _mm512_setzero_pd();
+	r3 = _mm512_setzero_pd();
+	i0 = _mm512_setzero_pd();
+	i1 = _mm512_setzero_pd();
+	i2 = _mm512_setzero_pd();
+	i3 = _mm512_setzero_pd();
+
+	double *pB = B + 2*offsetB;
+	int offB = offsetB;
+
+	for(kk=0; kk<kmax; kk++)
+		{
+		a0 = _mm512_load_pd( &A[0] );
+		s0 = _mm512_castsi512_pd( _mm512_xor_si512( _mm512_castpd_si512( _mm512_permute_pd( a0, 0x55 ) ), isgn ) );
+
+		r0 = _mm512_fmadd_pd( a0, _mm512_set1_pd( pB[0+2*bs*0] ), r0 );
+		i0 = _mm512_fmadd_pd( s0, _mm512_set1_pd( pB[1+2*bs*0] ), i0 );
+		r1 = _mm512_fmadd_pd( a0, _mm512_set1_pd( pB[0+2*bs*1] ), r1 );
+		i1 = _mm512_fmadd_pd( s0, _mm512_set1_pd( pB[1+2*bs*1] ), i1 );
+		r2 = _mm512_fmadd_pd( a0, _mm512_set1_pd( pB[0+2*bs*2] ), r2 );
+		i2 = _mm512_fmadd_pd( s0, _mm512_set1_pd( pB[1+2*bs*2] ), i2 );
+		r3 = _mm512_fmadd_pd( a0, _mm512_set1_pd( pB[0+2*bs*3] ), r3 );
+		i3 = _mm512_fmadd_pd( s0, _mm512_set1_pd( pB[1+2*bs*3] ), i3 );
+
+		A += 2*bs;
+		pB += 2;
+		offB++;
+		if(offB==bs)
+			{
+			pB += 2*bs*sdb - 2*bs;
+			offB = 0;
+			}
+		}
+
+	acc[0] = _mm512_add_pd( r0, i0 );
+	acc[1] = _mm512_add_pd( r1, i1 );
+	acc[2] = _mm512_add_pd( r2, i2 );
+	acc[3] = _mm512_add_pd( r3, i3 );
+
+	return;
+
+	}
+
+
+
+void kernel_zgemm_nn_4x4_lib4(int kmax, double *alpha, double *A, int offsetB, double *B, int sdb, double *beta, double *C, double *D)
+	{
+	__m512d acc[4];
+	kernel_zgemm_acc_nn_4x4_lib4(kmax, A, offsetB, B, sdb, acc);
+	kernel_zgemm_store_4x4_lib4(acc, alpha, beta, C, D, 4, 4);
+	return;
+	}
+
+
+
+void kernel_zgemm_nn_4x4_vs_lib4(int kmax, double *alpha, double *A, int offsetB, double *B, int sdb, double *beta, double *C, double *D, int m1, int n1)
+	{
+	__m512d acc[4];
+	kernel_zgemm_acc_nn_4x4_lib4(kmax, A, offsetB, B, sdb, acc);
+	kernel_zgemm_store_4x4_lib4(acc, alpha, beta, C, D, m1, n1);
+	return;
+	}
+
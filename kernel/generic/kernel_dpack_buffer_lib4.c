@@ -164,3 +164,225 @@ void kernel_dpack_buffer_ut(int m, double *A, int lda, double *pA, int sda)
 
 	}
 
+
+
+
+// symmetric lower: m x n block at (ii,jj) of the symmetric matrix whose lower triangle is stored in A
+void kernel_dpack_buffer_sl(int m, int n, int ii, int jj, double *A, int lda, double *pA, int sda)
+	{
+
+	const int ps = 4;
+
+	int i0, j1, j2, m1, row, col, k, l;
+	double *pA0;
+
+	for(i0=0; i0<m; i0+=ps)
+		{
+		m1 = m-i0<ps ? m-i0 : ps;
+		pA0 = pA + i0*sda;
+		// columns [0,j1) are fully in the lower triangle, columns [j2,n) fully in the upper one
+		j1 = ii+i0-jj;
+		j1 = j1<0 ? 0 : j1>n ? n : j1;
+		j2 = ii+i0+ps-jj;
+		j2 = j2<0 ? 0 : j2>n ? n : j2;
+		if(j1>0)
+			{
+			if(m1==ps)
+				kernel_dpack_nn_4_lib4(j1, A+(ii+i0)+jj*lda, lda, pA0);
+			else
+				kernel_dpack_nn_4_vs_lib4(j1, A+(ii+i0)+jj*lda, lda, pA0, m1);
+			}
+		for(k=j1; k<j2; k++)
+			{
+			col = jj+k;
+			for(l=0; l<m1; l++)
+				{
+				row = ii+i0+l;
+				pA0[l+k*ps] = row>=col ? A[row+col*lda] : A[col+row*lda];
+				}
+			}
+		if(j2<n)
+			{
+			if(m1==ps)
+				kernel_dpack_tn_4_lib4(n-j2, A+(jj+j2)+(ii+i0)*lda, lda, pA0+j2*ps);
+			else
+				kernel_dpack_tn_4_vs_lib4(n-j2, A+(jj+j2)+(ii+i0)*lda, lda, pA0+j2*ps, m1);
+			}
+		}
+
+	return;
+
+	}
+
+
+
+// symmetric upper: m x n block at (ii,jj) of the symmetric matrix whose upper triangle is stored in A
+void kernel_dpack_buffer_su(int m, int n, int ii, int jj, double *A, int lda, double *pA, int sda)
+	{
+
+	const int ps = 4;
+
+	int i0, j1, j2, m1, row, col, k, l;
+	double *pA0;
+
+	for(i0=0; i0<m; i0+=ps)
+		{
+		m1 = m-i0<ps ? m-i0 : ps;
+		pA0 = pA + i0*sda;
+		// columns [0,j1) are fully in the lower triangle, columns [j2,n) fully in the upper one
+		j1 = ii+i0-jj;
+		j1 = j1<0 ? 0 : j1>n ? n : j1;
+		j2 = ii+i0+ps-jj;
+		j2 = j2<0 ? 0 : j2>n ? n : j2;
+		if(j1>0)
+			{
+			if(m1==ps)
+				kernel_dpack_tn_4_lib4(j1, A+jj+(ii+i0)*lda, lda, pA0);
+			else
+				kernel_dpack_tn_4_vs_lib4(j1, A+jj+(ii+i0)*lda, lda, pA0, m1);
+			}
+		for(k=j1; k<j2; k++)
+			{
+			col = jj+k;
+			for(l=0; l<m1; l++)
+				{
+				row = ii+i0+l;
+				pA0[l+k*ps] = row<=col ? A[row+col*lda] : A[col+row*lda];
+				}
+			}
+		if(j2<n)
+			{
+			if(m1==ps)
+				kernel_dpack_nn_4_lib4(n-j2, A+(ii+i0)+(jj+j2)*lda, lda, pA0+j2*ps);
+			else
+				kernel_dpack_nn_4_vs_lib4(n-j2, A+(ii+i0)+(jj+j2)*lda, lda, pA0+j2*ps, m1);
+			}
+		}
+
+	return;
+
+	}
+
+
+
+// symmetric lower, panel-major source: m x n block at (ii,jj) of the symmetric matrix whose lower triangle is stored in A, starting at row offA
+void kernel_dpacp_buffer_sl(int m, int n, int ii, int jj, int offA, double *A, int sda, double *pB, int sdb)
+	{
+
+	const int ps = 4;
+
+	int i0, j1, j2, m1, row, col, k, l;
+	double *pB0;
+
+	for(i0=0; i0<m; i0+=ps)
+		{
+		m1 = m-i0<ps ? m-i0 : ps;
+		pB0 = pB + i0*sdb;
+		j1 = ii+i0-jj;
+		j1 = j1<0 ? 0 : j1>n ? n : j1;
+		j2 = ii+i0+ps-jj;
+		j2 = j2<0 ? 0 : j2>n ? n : j2;
+		if(j1>0)
+			{
+			row = offA+ii+i0;
+			if(m1==ps)
+				kernel_dpacp_nn_4_lib4(j1, row%ps, A+row/ps*ps*sda+jj*ps, sda, pB0);
+			else
+				kernel_dpacp_nn_4_vs_lib4(j1, row%ps, A+row/ps*ps*sda+jj*ps, sda, pB0, m1);
+			}
+		for(k=j1; k<j2; k++)
+			{
+			col = jj+k;
+			for(l=0; l<m1; l++)
+				{
+				row = ii+i0+l;
+				pB0[l+k*ps] = row>=col ? A[(offA+row)/ps*ps*sda+(offA+row)%ps+col*ps] : A[(offA+col)/ps*ps*sda+(offA+col)%ps+row*ps];
+				}
+			}
+		if(j2<n)
+			{
+			if(m1==ps)
+				{
+				row = offA+jj+j2;
+				kernel_dpacp_tn_4_lib4(n-j2, row%ps, A+row/ps*ps*sda+(ii+i0)*ps, sda, pB0+j2*ps);
+				}
+			else
+				{
+				// no vs transposed copy kernel: it would read past the last column
+				for(k=j2; k<n; k++)
+					{
+					col = offA+jj+k;
+					for(l=0; l<m1; l++)
+						{
+						pB0[l+k*ps] = A[col/ps*ps*sda+col%ps+(ii+i0+l)*ps];
+						}
+					}
+				}
+			}
+		}
+
+	return;
+
+	}
+
+
+
+// symmetric upper, panel-major source: m x n block at (ii,jj) of the symmetric matrix whose upper triangle is stored in A, starting at row offA
+void kernel_dpacp_buffer_su(int m, int n, int ii, int jj, int offA, double *A, int sda, double *pB, int sdb)
+	{
+
+	const int ps = 4;
+
+	int i0, j1, j2, m1, row, col, k, l;
+	double *pB0;
+
+	for(i0=0; i0<m; i0+=ps)
+		{
+		m1 = m-i0<ps ? m-i0 : ps;
+		pB0 = pB + i0*sdb;
+		j1 = ii+i0-jj;
+		j1 = j1<0 ? 0 : j1>n ? n : j1;
+		j2 = ii+i0+ps-jj;
+		j2 = j2<0 ? 0 : j2>n ? n : j2;
+		if(j1>0)
+			{
+			if(m1==ps)
+				{
+				row = offA+jj;
+				kernel_dpacp_tn_4_lib4(j1, row%ps, A+row/ps*ps*sda+(ii+i0)*ps, sda, pB0);
+				}
+			else
+				{
+				// no vs transposed copy kernel: it would read past the last column
+				for(k=0; k<j1; k++)
+					{
+					col = offA+jj+k;
+					for(l=0; l<m1; l++)
+						{
+						pB0[l+k*ps] = A[col/ps*ps*sda+col%ps+(ii+i0+l)*ps];
+						}
+					}
+				}
+			}
+		for(k=j1; k<j2; k++)
+			{
+			col = jj+k;
+			for(l=0; l<m1; l++)
+				{
+				row = ii+i0+l;
+				pB0[l+k*ps] = row<=col ? A[(offA+row)/ps*ps*sda+(offA+row)%ps+col*ps] : A[(offA+col)/ps*ps*sda+(offA+col)%ps+row*ps];
+				}
+			}
+		if(j2<n)
+			{
+			row = offA+ii+i0;
+			if(m1==ps)
+				kernel_dpacp_nn_4_lib4(n-j2, row%ps, A+row/ps*ps*sda+(jj+j2)*ps, sda, pB0+j2*ps);
+			else
+				kernel_dpacp_nn_4_vs_lib4(n-j2, row%ps, A+row/ps*ps*sda+(jj+j2)*ps, sda, pB0+j2*ps, m1);
+			}
+		}
+
+	return;
+
+	}
@@ -0,0 +1,238 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2019 by Gianluca Frison.                                                          *
+* Developed at IMTEK (University of Freiburg) under the supervision of Moritz Diehl.              *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+
+
+
+#include <blasfeo_d_kernel.h>
+
+
+
+// symmetric lower: m x n block at (ii,jj) of the symmetric matrix whose lower triangle is stored in A
+void kernel_dpack_buffer_sl_lib8(int m, int n, int ii, int jj, double *A, int lda, double *pA, int sda)
+	{
+
+	const int ps = 8;
+
+	int i0, j1, j2, m1, row, col, k, l;
+	double *pA0;
+
+	for(i0=0; i0<m; i0+=ps)
+		{
+		m1 = m-i0<ps ? m-i0 : ps;
+		pA0 = pA + i0*sda;
+		// columns [0,j1) are fully in the lower triangle, columns [j2,n) fully in the upper one
+		j1 = ii+i0-jj;
+		j1 = j1<0 ? 0 : j1>n ? n : j1;
+		j2 = ii+i0+ps-jj;
+		j2 = j2<0 ? 0 : j2>n ? n : j2;
+		if(j1>0)
+			{
+			if(m1==ps)
+				kernel_dpack_nn_8_lib8(j1, A+(ii+i0)+jj*lda, lda, pA0);
+			else
+				kernel_dpack_nn_8_vs_lib8(j1, A+(ii+i0)+jj*lda, lda, pA0, m1);
+			}
+		for(k=j1; k<j2; k++)
+			{
+			col = jj+k;
+			for(l=0; l<m1; l++)
+				{
+				row = ii+i0+l;
+				pA0[l+k*ps] = row>=col ? A[row+col*lda] : A[col+row*lda];
+				}
+			}
+		if(j2<n)
+			{
+			if(m1==ps)
+				kernel_dpack_tn_8_lib8(n-j2, A+(jj+j2)+(ii+i0)*lda, lda, pA0+j2*ps);
+			else
+				kernel_dpack_tn_8_vs_lib8(n-j2, A+(jj+j2)+(ii+i0)*lda, lda, pA0+j2*ps, m1);
+			}
+		}
+
+	return;
+
+	}
+
+
+
+// symmetric upper: m x n block at (ii,jj) of the symmetric matrix whose upper triangle is stored in A
+void kernel_dpack_buffer_su_lib8(int m, int n, int ii, int jj, double *A, int lda, double *pA, int sda)
+	{
+
+	const int ps = 8;
+
+	int i0, j1, j2, m1, row, col, k, l;
+	double *pA0;
+
+	for(i0=0; i0<m; i0+=ps)
+		{
+		m1 = m-i0<ps ? m-i0 : ps;
+		pA0 = pA + i0*sda;
+		// columns [0,j1) are fully in the lower triangle, columns [j2,n) fully in the upper one
+		j1 = ii+i0-jj;
+		j1 = j1<0 ? 0 : j1>n ? n : j1;
+		j2 = ii+i0+ps-jj;
+		j2 = j2<0 ? 0 : j2>n ? n : j2;
+		if(j1>0)
+			{
+			if(m1==ps)
+				kernel_dpack_tn_8_lib8(j1, A+jj+(ii+i0)*lda, lda, pA0);
+			else
+				kernel_dpack_tn_8_vs_lib8(j1, A+jj+(ii+i0)*lda, lda, pA0, m1);
+			}
+		for(k=j1; k<j2; k++)
+			{
+			col = jj+k;
+			for(l=0; l<m1; l++)
+				{
+				row = ii+i0+l;
+				pA0[l+k*ps] = row<=col ? A[row+col*lda] : A[col+row*lda];
+				}
+			}
+		if(j2<n)
+			{
+			if(m1==ps)
+				kernel_dpack_nn_8_lib8(n-j2, A+(ii+i0)+(jj+j2)*lda, lda, pA0+j2*ps);
+			else
+				kernel_dpack_nn_8_vs_lib8(n-j2, A+(ii+i0)+(jj+j2)*lda, lda, pA0+j2*ps, m1);
+			}
+		}
+
+	return;
+
+	}
+
+
+
+// symmetric lower, panel-major source: m x n block at (ii,jj) of the symmetric matrix whose lower triangle is stored in A, starting at row offA
+void kernel_dpacp_buffer_sl_lib8(int m, int n, int ii, int jj, int offA, double *A, int sda, double *pB, int sdb)
+	{
+
+	const int ps = 8;
+
+	int i0, j1, j2, m1, row, col, k, l;
+	double *pB0;
+
+	for(i0=0; i0<m; i0+=ps)
+		{
+		m1 = m-i0<ps ? m-i0 : ps;
+		pB0 = pB + i0*sdb;
+		j1 = ii+i0-jj;
+		j1 = j1<0 ? 0 : j1>n ? n : j1;
+		j2 = ii+i0+ps-jj;
+		j2 = j2<0 ? 0 : j2>n ? n : j2;
+		if(j1>0)
+			{
+			row = offA+ii+i0;
+			if(m1==ps)
+				kernel_dpacp_nn_8_lib8(j1, row%ps, A+row/ps*ps*sda+jj*ps, sda, pB0);
+			else
+				kernel_dpacp_nn_8_vs_lib8(j1, row%ps, A+row/ps*ps*sda+jj*ps, sda, pB0, m1);
+			}
+		for(k=j1; k<j2; k++)
+			{
+			col = jj+k;
+			for(l=0; l<m1; l++)
+				{
+				row = ii+i0+l;
+				pB0[l+k*ps] = row>=col ? A[(offA+row)/ps*ps*sda+(offA+row)%ps+col*ps] : A[(offA+col)/ps*ps*sda+(offA+col)%ps+row*ps];
+				}
+			}
+		if(j2<n)
+			{
+			row = offA+jj+j2;
+			if(m1==ps)
+				kernel_dpacp_tn_8_lib8(n-j2, row%ps, A+row/ps*ps*sda+(ii+i0)*ps, sda, pB0+j2*ps);
+			else
+				kernel_dpacp_tn_8_vs_lib8(n-j2, row%ps, A+row/ps*ps*sda+(ii+i0)*ps, sda, pB0+j2*ps, m1);
+			}
+		}
+
+	return;
+
+	}
+
+
+
+// symmetric upper, panel-major source: m x n block at (ii,jj) of the symmetric matrix whose upper triangle is stored in A, starting at row offA
+void kernel_dpacp_buffer_su_lib8(int m, int n, int ii, int jj, int offA, double *A, int sda, double *pB, int sdb)
+	{
+
+	const int ps = 8;
+
+	int i0, j1, j2, m1, row, col, k, l;
+	double *pB0;
+
+	for(i0=0; i0<m; i0+=ps)
+		{
+		m1 = m-i0<ps ? m-i0 : ps;
+		pB0 = pB + i0*sdb;
+		j1 = ii+i0-jj;
+		j1 = j1<0 ? 0 : j1>n ? n : j1;
+		j2 = ii+i0+ps-jj;
+		j2 = j2<0 ? 0 : j2>n ? n : j2;
+		if(j1>0)
+			{
+			row = offA+jj;
+			if(m1==ps)
+				kernel_dpacp_tn_8_lib8(j1, row%ps, A+row/ps*ps*sda+(ii+i0)*ps, sda, pB0);
+			else
+				kernel_dpacp_tn_8_vs_lib8(j1, row%ps, A+row/ps*ps*sda+(ii+i0)*ps, sda, pB0, m1);
+			}
+		for(k=j1; k<j2; k++)
+			{
+			col = jj+k;
+			for(l=0; l<m1; l++)
+				{
+				row = ii+i0+l;
+				pB0[l+k*ps] = row<=col ? A[(offA+row)/ps*ps*sda+(offA+row)%ps+col*ps] : A[(offA+col)/ps*ps*sda+(offA+col)%ps+row*ps];
+				}
+			}
+		if(j2<n)
+			{
+			row = offA+ii+i0;
+			if(m1==ps)
+				kernel_dpacp_nn_8_lib8(n-j2, row%ps, A+row/ps*ps*sda+(jj+j2)*ps, sda, pB0+j2*ps);
+			else
+				kernel_dpacp_nn_8_vs_lib8(n-j2, row%ps, A+row/ps*ps*sda+(jj+j2)*ps, sda, pB0+j2*ps, m1);
+			}
+		}
+
+	return;
+
+	}
+
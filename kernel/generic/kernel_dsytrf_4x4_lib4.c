@@ -0,0 +1,98 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2019 by Gianluca Frison.                                                          *
+* Developed at IMTEK (University of Freiburg) under the supervision of Moritz Diehl.              *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+
+#include <math.h>
+
+#include <blasfeo_common.h>
+#include <blasfeo_d_kernel.h>
+
+
+
+// D <= ldl( C - A * B^T ) without pivoting, with the diagonal of any sign: L unit lower triangular in the strictly lower
+// triangular of D, the diagonal in the diagonal of D, and W <= L * diag(D) in the lower triangular of W;
+// A holds rows of L and B the same rows of W; a zero pivot gives a zero column of L and inv_diag_D
+void kernel_dsytrf_nt_l_4x4_vs_lib4(int kmax, double *A, double *B, double *C, double *D, double *W, double *inv_diag_D, int km, int kn)
+	{
+
+	const int bs = 4;
+
+	double tmp;
+
+#if defined(TARGET_GENERIC)
+	double CC[16] = {0};
+#else
+	ALIGNED( double CC[16], 64 ) = {0};
+#endif
+
+	int ii, jj, kk;
+
+	double alpha1 = -1.0;
+	double beta1  = 1.0;
+
+	kernel_dgemm_nt_4x4_lib4(kmax, &alpha1, A, B, &beta1, C, CC);
+
+	// CC holds W, the column jj of L is W(:,jj) * inv_diag_D[jj]
+	for(jj=0; jj<kn; jj++)
+		{
+		tmp = CC[jj+bs*jj]!=0.0 ? 1.0/CC[jj+bs*jj] : 0.0;
+		inv_diag_D[jj] = tmp;
+		for(kk=jj+1; kk<kn; kk++)
+			for(ii=kk; ii<bs; ii++)
+				CC[ii+bs*kk] -= CC[ii+bs*jj] * (CC[kk+bs*jj] * tmp);
+		}
+
+	for(jj=0; jj<kn; jj++)
+		{
+		W[jj+bs*jj] = CC[jj+bs*jj];
+		D[jj+bs*jj] = CC[jj+bs*jj];
+		tmp = inv_diag_D[jj];
+		for(ii=jj+1; ii<km; ii++)
+			{
+			W[ii+bs*jj] = CC[ii+bs*jj];
+			D[ii+bs*jj] = CC[ii+bs*jj] * tmp;
+			}
+		}
+
+	return;
+
+	}
+
+
+
+void kernel_dsytrf_nt_l_4x4_lib4(int kmax, double *A, double *B, double *C, double *D, double *W, double *inv_diag_D)
+	{
+	kernel_dsytrf_nt_l_4x4_vs_lib4(kmax, A, B, C, D, W, inv_diag_D, 4, 4);
+	}
@@ -0,0 +1,220 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2019 by Gianluca Frison.                                                          *
+* Developed at IMTEK (University of Freiburg) under the supervision of Moritz Diehl.              *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+#include <blasfeo_common.h>
+#include <blasfeo_z_kernel.h>
+
+
+
+// complex numbers are stored as (real, imaginary) pairs, and a panel column holds 4 of them
+
+
+
+// D <= alpha * acc + beta * C , for the top-left m1 x n1 block
+static void kernel_zgemm_store_4x4_lib4(double *acc, double *alpha, double *beta, double *C, double *D, int m1, int n1)
+	{
+
+	const int bs = 4;
+
+	int ii, jj;
+	double tr, ti;
+
+	if(m1>bs)
+		m1 = bs;
+	if(n1>bs)
+		n1 = bs;
+
+	for(jj=0; jj<n1; jj++)
+		{
+		for(ii=0; ii<m1; ii++)
+			{
+			tr = alpha[0]*acc[2*ii+0+2*bs*jj] - alpha[1]*acc[2*ii+1+2*bs*jj];
+			ti = alpha[0]*acc[2*ii+1+2*bs*jj] + alpha[1]*acc[2*ii+0+2*bs*jj];
+			// C is not accessed if beta is zero
+			if(beta[0]!=0.0 | beta[1]!=0.0)
+				{
+				tr += beta[0]*C[2*ii+0+2*bs*jj] - beta[1]*C[2*ii+1+2*bs*jj];
+				ti += beta[0]*C[2*ii+1+2*bs*jj] + beta[1]*C[2*ii+0+2*bs*jj];
+				}
+			D[2*ii+0+2*bs*jj] = tr;
+			D[2*ii+1+2*bs*jj] = ti;
+			}
+		}
+
+	return;
+
+	}
+
+
+
+// acc <= A * B^T , or A * B^H if conj is not zero
+static void kernel_zgemm_acc_nt_4x4_lib4(int kmax, double *A, double *B, int conj, double *acc)
+	{
+
+	const int bs = 4;
+
+	int ii, jj, kk;
+	double ar, ai, br, bi;
+
+	for(ii=0; ii<2*bs*bs; ii++)
+		acc[ii] = 0.0;
+
+	for(kk=0; kk<kmax; kk++)
+		{
+		for(jj=0; jj<bs; jj++)
+			{
+			br = B[2*jj+0];
+			bi = conj ? -B[2*jj+1] : B[2*jj+1];
+			for(ii=0; ii<bs; ii++)
+				{
+				ar = A[2*ii+0];
+				ai = A[2*ii+1];
+				acc[2*ii+0+2*bs*jj] += ar*br - ai*bi;
+				acc[2*ii+1+2*bs*jj] += ai*br + ar*bi;
+				}
+			}
+		A += 2*bs;
+		B += 2*bs;
+		}
+
+	return;
+
+	}
+
+
+
+void kernel_zgemm_nt_4x4_lib4(int kmax, double *alpha, double *A, double *B, double *beta, double *C, double *D)
+	{
+	double acc[32];
+	kernel_zgemm_acc_nt_4x4_lib4(kmax, A, B, 0, acc);
+	kernel_zgemm_store_4x4_lib4(acc, alpha, beta, C, D, 4, 4);
+	return;
+	}
+
+
+
+void kernel_zgemm_nt_4x4_vs_lib4(int kmax, double *alpha, double *A, double *B, double *beta, double *C, double *D, int m1, int n1)
+	{
+	double acc[32];
+	kernel_zgemm_acc_nt_4x4_lib4(kmax, A, B, 0, acc);
+	kernel_zgemm_store_4x4_lib4(acc, alpha, beta, C, D, m1, n1);
+	return;
+	}
+
+
+
+void kernel_zgemm_nc_4x4_lib4(int kmax, double *alpha, double *A, double *B, double *beta, double *C, double *D)
+	{
+	double acc[32];
+	kernel_zgemm_acc_nt_4x4_lib4(kmax, A, B, 1, acc);
+	kernel_zgemm_store_4x4_lib4(acc, alpha, beta, C, D, 4, 4);
+	return;
+	}
+
+
+
+void kernel_zgemm_nc_4x4_vs_lib4(int kmax, double *alpha, double *A, double *B, double *beta, double *C, double *D, int m1, int n1)
+	{
+	double acc[32];
+	kernel_zgemm_acc_nt_4x4_lib4(kmax, A, B, 1, acc);
+	kernel_zgemm_store_4x4_lib4(acc, alpha, beta, C, D, m1, n1);
+	return;
+	}
+
+
+
+// acc <= A * B , with B starting at row offsetB of its panel
+static void kernel_zgemm_acc_nn_4x4_lib4(int kmax, double *A, int offsetB, double *B, int sdb, double *acc)
+	{
+
+	const int bs = 4;
+
+	int ii, jj, kk;
+	double ar, ai, br, bi;
+
+	for(ii=0; ii<2*bs*bs; ii++)
+		acc[ii] = 0.0;
+
+	double *pB = B + 2*offsetB;
+	int offB = offsetB;
+
+	for(kk=0; kk<kmax; kk++)
+		{
+		for(jj=0; jj<bs; jj++)
+			{
+			br = pB[0+2*bs*jj];
+			bi = pB[1+2*bs*jj];
+			for(ii=0; ii<bs; ii++)
+				{
+				ar = A[2*ii+0];
+				ai = A[2*ii+1];
+				acc[2*ii+0+2*bs*jj] += ar*br - ai*bi;
+				acc[2*ii+1+2*bs*jj] += ai*br + ar*bi;
+				}
+			}
+		A += 2*bs;
+		pB += 2;
+		offB++;
+		if(offB==bs)
+			{
+			pB += 2*bs*sdb - 2*bs;
+			offB = 0;
+			}
+		}
+
+	return;
+
+	}
+
+
+
+void kernel_zgemm_nn_4x4_lib4(int kmax, double *alpha, double *A, int offsetB, double *B, int sdb, double *beta, double *C, double *D)
+	{
+	double acc[32];
+	kernel_zgemm_acc_nn_4x4_lib4(kmax, A, offsetB, B, sdb, acc);
+	kernel_zgemm_store_4x4_lib4(acc, alpha, beta, C, D, 4, 4);
+	return;
+	}
+
+
+
+void kernel_zgemm_nn_4x4_vs_lib4(int kmax, double *alpha, double *A, int offsetB, double *B, int sdb, double *beta, double *C, double *D, int m1, int n1)
+	{
+	double acc[32];
+	kernel_zgemm_acc_nn_4x4_lib4(kmax, A, offsetB, B, sdb, acc);
+	kernel_zgemm_store_4x4_lib4(acc, alpha, beta, C, D, m1, n1);
+	return;
+	}
+
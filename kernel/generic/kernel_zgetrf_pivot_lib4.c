@@ -0,0 +1,229 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2019 by Gianluca Frison.                                                          *
+* Developed at IMTEK (University of Freiburg) under the supervision of Moritz Diehl.              *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+
+#include <math.h>
+
+#include <blasfeo_common.h>
+#include <blasfeo_z_kernel.h>
+
+
+
+// complex numbers are stored as (real, imaginary) pairs, and a panel column holds 4 of them
+
+
+
+// swap two rows
+void kernel_zrowsw_lib4(int kmax, double *pA, double *pC)
+	{
+
+	const int bs = 4;
+
+	int ii;
+	double tmp0, tmp1;
+
+	for(ii=0; ii<kmax; ii++)
+		{
+		tmp0 = pA[0];
+		tmp1 = pA[1];
+		pA[0] = pC[0];
+		pA[1] = pC[1];
+		pC[0] = tmp0;
+		pC[1] = tmp1;
+		pA += 2*bs;
+		pC += 2*bs;
+		}
+
+	return;
+
+	}
+
+
+
+// LU factorization with row pivoting of the first n<=4 columns of a m x 4 block column, starting at the top of a panel;
+// the rows are swapped only within the block column, ipiv is relative to the top of the block,
+// and inv_diag_A holds the complex inverse of the diagonal (zero if the pivot is zero)
+void kernel_zgetrf_pivot_4_vs_lib4(int m, double *pA, int sda, double *inv_diag_A, int *ipiv, int n)
+	{
+
+	const int bs = 4;
+
+	int ii, jj, ll, p_max, p_off;
+	double amax, tmp_abs, tr, ti, lr, li, dd;
+	double *pB, *pP, *pL;
+
+	int kmax = m<n ? m : n;
+
+	for(ll=0; ll<kmax; ll++)
+		{
+
+		// pivot search on the sum of the absolute values of the real and imaginary parts
+		p_max = ll;
+		amax = -1.0;
+		pB = pA + (ll-(ll&(bs-1)))*2*sda + 2*(ll&(bs-1)) + 2*bs*ll;
+		ii = ll;
+		for(; ii<m; ii++)
+			{
+			tmp_abs = fabs(pB[0]) + fabs(pB[1]);
+			if(tmp_abs>amax)
+				{
+				amax = tmp_abs;
+				p_max = ii;
+				}
+			pB += 2;
+			if((ii&(bs-1))==bs-1)
+				pB += 2*bs*sda - 2*bs;
+			}
+		ipiv[ll] = p_max;
+		if(p_max!=ll)
+			{
+			kernel_zrowsw_lib4(n, pA+(ll-(ll&(bs-1)))*2*sda+2*(ll&(bs-1)), pA+(p_max-(p_max&(bs-1)))*2*sda+2*(p_max&(bs-1)));
+			}
+
+		// inverse of the pivot
+		pP = pA + (ll-(ll&(bs-1)))*2*sda + 2*(ll&(bs-1)) + 2*bs*ll;
+		tr = pP[0];
+		ti = pP[1];
+		dd = tr*tr + ti*ti;
+		if(dd!=0.0)
+			{
+			dd = 1.0/dd;
+			lr = tr*dd;
+			li = - ti*dd;
+			}
+		else
+			{
+			lr = 0.0;
+			li = 0.0;
+			}
+		inv_diag_A[2*ll+0] = lr;
+		inv_diag_A[2*ll+1] = li;
+
+		// scale the column below the pivot, and rank-1 update of the columns on the right
+		p_off = ll+1;
+		pB = pA + (p_off-(p_off&(bs-1)))*2*sda + 2*(p_off&(bs-1));
+		for(ii=p_off; ii<m; ii++)
+			{
+			pL = pB + 2*bs*ll;
+			tr = pL[0];
+			ti = pL[1];
+			pL[0] = tr*lr - ti*li;
+			pL[1] = tr*li + ti*lr;
+			tr = pL[0];
+			ti = pL[1];
+			for(jj=ll+1; jj<n; jj++)
+				{
+				pB[0+2*bs*jj] -= tr*pP[0+2*bs*(jj-ll)] - ti*pP[1+2*bs*(jj-ll)];
+				pB[1+2*bs*jj] -= tr*pP[1+2*bs*(jj-ll)] + ti*pP[0+2*bs*(jj-ll)];
+				}
+			pB += 2;
+			if((ii&(bs-1))==bs-1)
+				pB += 2*bs*sda - 2*bs;
+			}
+
+		}
+
+	return;
+
+	}
+
+
+
+void kernel_zgetrf_pivot_4_lib4(int m, double *pA, int sda, double *inv_diag_A, int *ipiv)
+	{
+	kernel_zgetrf_pivot_4_vs_lib4(m, pA, sda, inv_diag_A, ipiv, 4);
+	return;
+	}
+
+
+
+// D <= E^{-1} * ( C - A * B ) , with E lower triangular with unit diagonal
+static inline void kernel_ztrsm_nn_ll_one_4x4_body_lib4(int kmax, double *A, double *B, int sdb, double *C, double *D, double *E, int m1, int n1)
+	{
+
+	const int bs = 4;
+
+	int ii, jj, ll;
+	double er, ei, tr, ti;
+
+	double alpha1[2] = {-1.0, 0.0};
+	double beta1[2] = {1.0, 0.0};
+
+	if(m1>bs)
+		m1 = bs;
+	if(n1>bs)
+		n1 = bs;
+
+	if(m1==bs & n1==bs)
+		kernel_zgemm_nn_4x4_lib4(kmax, alpha1, A, 0, B, sdb, beta1, C, D);
+	else
+		kernel_zgemm_nn_4x4_vs_lib4(kmax, alpha1, A, 0, B, sdb, beta1, C, D, m1, n1);
+
+	for(ll=0; ll<m1; ll++)
+		{
+		for(ii=ll+1; ii<m1; ii++)
+			{
+			er = E[2*ii+0+2*bs*ll];
+			ei = E[2*ii+1+2*bs*ll];
+			for(jj=0; jj<n1; jj++)
+				{
+				tr = D[2*ll+0+2*bs*jj];
+				ti = D[2*ll+1+2*bs*jj];
+				D[2*ii+0+2*bs*jj] -= er*tr - ei*ti;
+				D[2*ii+1+2*bs*jj] -= er*ti + ei*tr;
+				}
+			}
+		}
+
+	return;
+
+	}
+
+
+
+void kernel_ztrsm_nn_ll_one_4x4_lib4(int kmax, double *A, double *B, int sdb, double *C, double *D, double *E)
+	{
+	kernel_ztrsm_nn_ll_one_4x4_body_lib4(kmax, A, B, sdb, C, D, E, 4, 4);
+	return;
+	}
+
+
+
+void kernel_ztrsm_nn_ll_one_4x4_vs_lib4(int kmax, double *A, double *B, int sdb, double *C, double *D, double *E, int m1, int n1)
+	{
+	kernel_ztrsm_nn_ll_one_4x4_body_lib4(kmax, A, B, sdb, C, D, E, m1, n1);
+	return;
+	}
+
@@ -0,0 +1,202 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2019 by Gianluca Frison.                                                          *
+* Developed at IMTEK (University of Freiburg) under the supervision of Moritz Diehl.              *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+
+#include <math.h>
+
+#include <blasfeo_common.h>
+#include <blasfeo_z_kernel.h>
+
+
+
+// complex numbers are stored as (real, imaginary) pairs, and a panel column holds 4 of them
+
+
+
+// D <= chol( C - A * B^H ) , lower triangular part of the top-left m1 x n1 block;
+// the diagonal is real, and inv_diag_D holds its (real) inverse, zero if the matrix is not positive definite
+static inline void kernel_zpotrf_nc_l_4x4_body_lib4(int kmax, double *A, double *B, double *C, double *D, double *inv_diag_D, int m1, int n1)
+	{
+
+	const int bs = 4;
+
+	int ii, jj, ll;
+	double dr, tmp, lr, li;
+
+	ALIGNED( double CC[32], 64 );
+
+	double alpha1[2] = {-1.0, 0.0};
+	double beta1[2] = {1.0, 0.0};
+
+	if(m1>bs)
+		m1 = bs;
+	if(n1>bs)
+		n1 = bs;
+
+	if(m1==bs & n1==bs)
+		kernel_zgemm_nc_4x4_lib4(kmax, alpha1, A, B, beta1, C, CC);
+	else
+		kernel_zgemm_nc_4x4_vs_lib4(kmax, alpha1, A, B, beta1, C, CC, m1, n1);
+
+	for(ll=0; ll<n1; ll++)
+		{
+		dr = CC[2*ll+0+2*bs*ll];
+		if(dr>0.0)
+			{
+			dr = sqrt(dr);
+			tmp = 1.0/dr;
+			}
+		else
+			{
+			dr = 0.0;
+			tmp = 0.0;
+			}
+		CC[2*ll+0+2*bs*ll] = dr;
+		CC[2*ll+1+2*bs*ll] = 0.0;
+		inv_diag_D[ll] = tmp;
+		for(ii=ll+1; ii<m1; ii++)
+			{
+			CC[2*ii+0+2*bs*ll] *= tmp;
+			CC[2*ii+1+2*bs*ll] *= tmp;
+			}
+		// c_ij -= l_il * conj(l_jl)
+		for(jj=ll+1; jj<n1; jj++)
+			{
+			lr = CC[2*jj+0+2*bs*ll];
+			li = - CC[2*jj+1+2*bs*ll];
+			for(ii=jj; ii<m1; ii++)
+				{
+				CC[2*ii+0+2*bs*jj] -= CC[2*ii+0+2*bs*ll]*lr - CC[2*ii+1+2*bs*ll]*li;
+				CC[2*ii+1+2*bs*jj] -= CC[2*ii+0+2*bs*ll]*li + CC[2*ii+1+2*bs*ll]*lr;
+				}
+			}
+		}
+
+	for(jj=0; jj<n1; jj++)
+		{
+		for(ii=jj; ii<m1; ii++)
+			{
+			D[2*ii+0+2*bs*jj] = CC[2*ii+0+2*bs*jj];
+			D[2*ii+1+2*bs*jj] = CC[2*ii+1+2*bs*jj];
+			}
+		}
+
+	return;
+
+	}
+
+
+
+void kernel_zpotrf_nc_l_4x4_lib4(int kmax, double *A, double *B, double *C, double *D, double *inv_diag_D)
+	{
+	kernel_zpotrf_nc_l_4x4_body_lib4(kmax, A, B, C, D, inv_diag_D, 4, 4);
+	return;
+	}
+
+
+
+void kernel_zpotrf_nc_l_4x4_vs_lib4(int kmax, double *A, double *B, double *C, double *D, double *inv_diag_D, int m1, int n1)
+	{
+	kernel_zpotrf_nc_l_4x4_body_lib4(kmax, A, B, C, D, inv_diag_D, m1, n1);
+	return;
+	}
+
+
+
+// D <= ( C - A * B^H ) * E^{-H} , with E lower triangular with (real) inverse diagonal inv_diag_E
+static inline void kernel_ztrsm_nc_rl_inv_4x4_body_lib4(int kmax, double *A, double *B, double *C, double *D, double *E, double *inv_diag_E, int m1, int n1)
+	{
+
+	const int bs = 4;
+
+	int ii, jj, ll;
+	double tmp, er, ei, tr, ti;
+
+	double alpha1[2] = {-1.0, 0.0};
+	double beta1[2] = {1.0, 0.0};
+
+	if(m1>bs)
+		m1 = bs;
+	if(n1>bs)
+		n1 = bs;
+
+	if(m1==bs & n1==bs)
+		kernel_zgemm_nc_4x4_lib4(kmax, alpha1, A, B, beta1, C, D);
+	else
+		kernel_zgemm_nc_4x4_vs_lib4(kmax, alpha1, A, B, beta1, C, D, m1, n1);
+
+	// in place on D: x_j <= ( x_j - sum_{l<j} x_l * conj(e_jl) ) / e_jj
+	for(jj=0; jj<n1; jj++)
+		{
+		for(ll=0; ll<jj; ll++)
+			{
+			er = E[2*jj+0+2*bs*ll];
+			ei = - E[2*jj+1+2*bs*ll];
+			for(ii=0; ii<m1; ii++)
+				{
+				tr = D[2*ii+0+2*bs*ll];
+				ti = D[2*ii+1+2*bs*ll];
+				D[2*ii+0+2*bs*jj] -= tr*er - ti*ei;
+				D[2*ii+1+2*bs*jj] -= tr*ei + ti*er;
+				}
+			}
+		tmp = inv_diag_E[jj];
+		for(ii=0; ii<m1; ii++)
+			{
+			D[2*ii+0+2*bs*jj] *= tmp;
+			D[2*ii+1+2*bs*jj] *= tmp;
+			}
+		}
+
+	return;
+
+	}
+
+
+
+void kernel_ztrsm_nc_rl_inv_4x4_lib4(int kmax, double *A, double *B, double *C, double *D, double *E, double *inv_diag_E)
+	{
+	kernel_ztrsm_nc_rl_inv_4x4_body_lib4(kmax, A, B, C, D, E, inv_diag_E, 4, 4);
+	return;
+	}
+
+
+
+void kernel_ztrsm_nc_rl_inv_4x4_vs_lib4(int kmax, double *A, double *B, double *C, double *D, double *E, double *inv_diag_E, int m1, int n1)
+	{
+	kernel_ztrsm_nc_rl_inv_4x4_body_lib4(kmax, A, B, C, D, E, inv_diag_E, m1, n1);
+	return;
+	}
+
@@ -0,0 +1,84 @@
+// CLASS_SYMM
+//
+
+void call_routines(struct RoutineArgs *args)
+	{
+
+	// copy input matrix C in D
+	int ii, jj;
+	for(jj=0; jj<args->n; jj++)
+		{
+		for(ii=0; ii<args->m; ii++)
+			{
+				args->cD[ii+args->cD_lda*jj] = args->cC[ii+args->cC_lda*jj];
+			}
+		}
+	for(jj=0; jj<args->n; jj++)
+		{
+		for(ii=0; ii<args->m; ii++)
+			{
+				args->bD[ii+args->bD_lda*jj] = args->bC[ii+args->bC_lda*jj];
+			}
+		}
+
+	// routine call
+	//
+	BLASFEO_BLAS(ROUTINE)(
+		string(SIDE), string(UPLO),
+		&(args->m), &(args->n), &(args->alpha),
+		args->cA, &(args->cA_lda),
+		args->cB, &(args->cB_lda), &(args->beta),
+		args->cD, &(args->cD_lda));
+
+	BLAS(ROUTINE)(
+		string(SIDE), string(UPLO),
+		&(args->m), &(args->n), &(args->alpha),
+		args->bA, &(args->bA_lda),
+		args->bB, &(args->bB_lda), &(args->beta),
+		args->bD, &(args->bD_lda));
+
+	// D matrix is overwritten with the solution
+
+	}
+
+
+
+void print_routine(struct RoutineArgs *args)
+	{
+	printf("blas_%s(%s, %s, %d, %d, %f, A, %d, B, %d, %f, D, %d);\n", string(ROUTINE), string(SIDE), string(UPLO), args->m, args->n, args->alpha, args->cA_lda, args->cB_lda, args->beta, args->cD_lda);
+	}
+
+
+
+void print_routine_matrices(struct RoutineArgs *args)
+	{
+	printf("\nPrint A:\n");
+	if(*string(SIDE)=='l' || *string(SIDE)=='L')
+		{
+		print_xmat_debug(args->m, args->m, args->cA, args->cA_lda, 0, 0, 0, 0, 0, "HP");
+		print_xmat_debug(args->m, args->m, args->bA, args->bA_lda, 0, 0, 0, 0, 0, "REF");
+		}
+		else
+		{
+		print_xmat_debug(args->n, args->n, args->cA, args->cA_lda, 0, 0, 0, 0, 0, "HP");
+		print_xmat_debug(args->n, args->n, args->bA, args->bA_lda, 0, 0, 0, 0, 0, "REF");
+		}
+
+	printf("\nPrint B:\n");
+	print_xmat_debug(args->m, args->n, args->cB, args->cB_lda, 0, 0, 0, 0, 0, "HP");
+	print_xmat_debug(args->m, args->n, args->bB, args->bB_lda, 0, 0, 0, 0, 0, "REF");
+
+	printf("\nPrint C:\n");
+	print_xmat_debug(args->m, args->n, args->cC, args->cC_lda, 0, 0, 0, 0, 0, "HP");
+	print_xmat_debug(args->m, args->n, args->bC, args->bC_lda, 0, 0, 0, 0, 0, "REF");
+	}
+
+
+
+void set_test_args(struct TestArgs *targs)
+	{
+	targs->nis = 17;
+	targs->njs = 8;
+
+	targs->alphas = 1;
+	}
@@ -0,0 +1,76 @@
+// CLASS_SYMM
+//
+void call_routines(struct RoutineArgs *args)
+	{
+
+	// routine call
+	//
+	BLASFEO(ROUTINE)(
+		args->m, args->n, args->alpha,
+		args->sA, args->ai, args->aj,
+		args->sB, args->bi, args->bj, args->beta,
+		args->sC, args->ci, args->cj,
+		args->sD, args->di, args->dj);
+
+	BLASFEO(REF(ROUTINE))(
+		args->m, args->n, args->alpha,
+		args->rA, args->ai, args->aj,
+		args->rB, args->bi, args->bj, args->beta,
+		args->rC, args->ci, args->cj,
+		args->rD, args->di, args->dj);
+
+	}
+
+
+
+void print_routine(struct RoutineArgs *args)
+	{
+	printf("blasfeo_%s(%d, %d, %f, A, %d, %d, B, %d, %d, %f, C, %d, %d, D, %d, %d);\n", string(ROUTINE), args->m, args->n, args->alpha, args->ai, args->aj, args->bi, args->bj, args->beta, args->ci, args->cj, args->di, args->dj);
+	}
+
+
+
+void print_routine_matrices(struct RoutineArgs *args)
+	{
+	if(!strcmp(string(ROUTINE), "dsymm_ll") | !strcmp(string(ROUTINE), "dsymm_lu"))
+		{
+		printf("\nPrint A:\n");
+		blasfeo_print_xmat_debug(args->m, args->m, args->sA, args->ai, args->aj, 0, 0, 0, "HP");
+		blasfeo_print_xmat_debug(args->m, args->m, args->rA, args->ai, args->aj, 0, 0, 0, "REF");
+		}
+	else
+		{
+		printf("\nPrint A:\n");
+		blasfeo_print_xmat_debug(args->n, args->n, args->sA, args->ai, args->aj, 0, 0, 0, "HP");
+		blasfeo_print_xmat_debug(args->n, args->n, args->rA, args->ai, args->aj, 0, 0, 0, "REF");
+		}
+
+	printf("\nPrint B:\n");
+	blasfeo_print_xmat_debug(args->m, args->n, args->sB, args->bi, args->bj, 0, 0, 0, "HP");
+	blasfeo_print_xmat_debug(args->m, args->n, args->rB, args->bi, args->bj, 0, 0, 0, "REF");
+
+	printf("\nPrint C:\n");
+	blasfeo_print_xmat_debug(args->m, args->n, args->sC, args->ci, args->cj, 0, 0, 0, "HP");
+	blasfeo_print_xmat_debug(args->m, args->n, args->rC, args->ci, args->cj, 0, 0, 0, "REF");
+
+	printf("\nPrint D:\n");
+	blasfeo_print_xmat_debug(args->m, args->n, args->sD, args->di, args->dj, 0, 0, 0, "HP");
+	blasfeo_print_xmat_debug(args->m, args->n, args->rD, args->di, args->dj, 0, 0, 0, "REF");
+	}
+
+
+
+void set_test_args(struct TestArgs *targs)
+	{
+#if defined(MF_PANELMAJ)
+	targs->ais = 5;
+	targs->bis = 5;
+	targs->dis = 5;
+	targs->xjs = 2;
+#endif
+
+	targs->nis = 21;
+	targs->njs = 9;
+
+	targs->alphas = 1;
+	}
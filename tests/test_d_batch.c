@@ -0,0 +1,312 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2019 by Gianluca Frison.                                                          *
+* Developed at IMTEK (University of Freiburg) under the supervision of Moritz Diehl.              *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+
+#include "../include/blasfeo_target.h"
+#include "../include/blasfeo_common.h"
+#include "../include/blasfeo_d_aux.h"
+#include "../include/blasfeo_d_aux_ext_dep.h"
+#include "../include/blasfeo_d_blasfeo_api.h"
+#include "../include/blasfeo_memory.h"
+#include "../include/blasfeo_thread_pool.h"
+
+
+
+#define NB 5
+#define NSIZE 7
+// full and partial groups of interleaved systems
+#define NB_POSV (2*BLASFEO_CB_D_NL+3)
+#define NSIZE_POSV 9
+#define NOFF 3
+#define TOL 1e-10
+
+
+
+// fill the matrix with random values
+static void rand_dmat(int m, int n, struct blasfeo_dmat *sA)
+	{
+	int ii, jj;
+	for(jj=0; jj<n; jj++)
+		for(ii=0; ii<m; ii++)
+			BLASFEO_DMATEL(sA, ii, jj) = (double) rand() / RAND_MAX - 0.5;
+	}
+
+
+
+// maximum absolute difference between the m x n sub-matrices (lower triangle only if low)
+static double diff_dmat(int m, int n, int low, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj)
+	{
+	int ii, jj;
+	double tmp, err = 0.0;
+	for(jj=0; jj<n; jj++)
+		for(ii=low ? jj : 0; ii<m; ii++)
+			{
+			tmp = fabs(BLASFEO_DMATEL(sA, ai+ii, aj+jj) - BLASFEO_DMATEL(sB, bi+ii, bj+jj));
+			// also catches NaN
+			if(!(tmp<=err))
+				err = tmp;
+			}
+	return err;
+	}
+
+
+
+int main()
+	{
+
+	int size_list[NSIZE] = {1, 3, 4, 8, 13, 24, 37};
+	int off_list[NOFF] = {0, 1, 5};
+
+	int mmax = 37 + 8;
+
+	struct blasfeo_dmat sA[NB], sB[NB], sC[NB], sD[NB], sD_ref[NB];
+	struct blasfeo_dmat *pA[NB], *pB[NB], *pC[NB], *pD[NB];
+
+	int ii, jj;
+	for(ii=0; ii<NB; ii++)
+		{
+		blasfeo_allocate_dmat(mmax, mmax, &sA[ii]);
+		blasfeo_allocate_dmat(mmax, mmax, &sB[ii]);
+		blasfeo_allocate_dmat(mmax, mmax, &sC[ii]);
+		blasfeo_allocate_dmat(mmax, mmax, &sD[ii]);
+		blasfeo_allocate_dmat(mmax, mmax, &sD_ref[ii]);
+		rand_dmat(mmax, mmax, &sA[ii]);
+		rand_dmat(mmax, mmax, &sB[ii]);
+		// C = B * B^T + mmax * I is positive definite
+		blasfeo_dgemm_nt(mmax, mmax, mmax, 1.0, &sB[ii], 0, 0, &sB[ii], 0, 0, 0.0, &sC[ii], 0, 0, &sC[ii], 0, 0);
+		blasfeo_ddiare(mmax, (double) mmax, &sC[ii], 0, 0);
+		// A = lower factor of C, for the triangular solves
+		blasfeo_dpotrf_l(mmax, &sC[ii], 0, 0, &sA[ii], 0, 0);
+		pA[ii] = &sA[ii];
+		pB[ii] = &sB[ii];
+		pC[ii] = &sC[ii];
+		pD[ii] = &sD[ii];
+		}
+
+	// positive definite systems for dposv_l_batch, the lane LANE_NPD is made not positive definite
+	int size_posv_list[NSIZE_POSV] = {1, 3, 4, 8, 12, 13, 16, 17, 37};
+	struct blasfeo_dmat sP[NB_POSV], sL;
+	struct blasfeo_dvec sb[NB_POSV], sx[NB_POSV], sx_ref;
+	struct blasfeo_dmat *pP[NB_POSV];
+	struct blasfeo_dvec *pb[NB_POSV], *px[NB_POSV];
+	int info[NB_POSV];
+	blasfeo_allocate_dmat(mmax, mmax, &sL);
+	blasfeo_allocate_dvec(mmax, &sx_ref);
+	for(ii=0; ii<NB_POSV; ii++)
+		{
+		blasfeo_allocate_dmat(mmax, mmax, &sP[ii]);
+		blasfeo_allocate_dvec(mmax, &sb[ii]);
+		blasfeo_allocate_dvec(mmax, &sx[ii]);
+		blasfeo_dgecp(mmax, mmax, &sC[ii%NB], 0, 0, &sP[ii], 0, 0);
+		blasfeo_dvecse(mmax, 0.0, &sb[ii], 0);
+		for(jj=0; jj<mmax; jj++)
+			BLASFEO_DVECEL(&sb[ii], jj) = (double) rand() / RAND_MAX - 0.5;
+		pP[ii] = &sP[ii];
+		pb[ii] = &sb[ii];
+		px[ii] = &sx[ii];
+		}
+	int lane_npd = BLASFEO_CB_D_NL+1;
+	int k_npd, info_ref, ws_err;
+
+	int im, in, io, nt;
+	int m, n, off;
+	double tmp, err;
+	int n_test = 0;
+	int n_fail = 0;
+
+	for(nt=1; nt<=4; nt+=3)
+		{
+		blasfeo_set_num_threads(nt);
+
+		for(im=0; im<NSIZE; im++)
+		for(in=0; in<NSIZE; in++)
+		for(io=0; io<NOFF; io++)
+			{
+			m = size_list[im];
+			n = size_list[in];
+			off = off_list[io];
+
+			// dgemm_nt, with row offsets on the generic path
+			for(ii=0; ii<NB; ii++)
+				{
+				blasfeo_dgese(mmax, mmax, 0.0, &sD[ii], 0, 0);
+				blasfeo_dgemm_nt(m, n, m, 1.5, &sA[ii], off, 1, &sB[ii], 0, off, -0.5, &sC[ii], off, 2, &sD_ref[ii], off, 3);
+				}
+			blasfeo_dgemm_nt_batch(NB, m, n, m, 1.5, pA, off, 1, pB, 0, off, -0.5, pC, off, 2, pD, off, 3);
+			for(ii=0; ii<NB; ii++)
+				{
+				n_test++;
+				err = diff_dmat(m, n, 0, &sD[ii], off, 3, &sD_ref[ii], off, 3);
+				if(!(err<=TOL))
+					{
+					printf("dgemm_nt_batch FAILED: m %d n %d offset %d threads %d lane %d err %e\n", m, n, off, nt, ii, err);
+					n_fail++;
+					}
+				}
+
+			// dtrsm_rltn, with column offsets on B and D
+			for(ii=0; ii<NB; ii++)
+				{
+				blasfeo_dgese(mmax, mmax, 0.0, &sD[ii], 0, 0);
+				blasfeo_dtrsm_rltn(m, n, 1.0, &sA[ii], 0, 0, &sB[ii], 0, off, &sD_ref[ii], 0, off+1);
+				}
+			blasfeo_dtrsm_rltn_batch(NB, m, n, 1.0, pA, 0, 0, pB, 0, off, pD, 0, off+1);
+			for(ii=0; ii<NB; ii++)
+				{
+				n_test++;
+				err = diff_dmat(m, n, 0, &sD[ii], 0, off+1, &sD_ref[ii], 0, off+1);
+				if(!(err<=TOL))
+					{
+					printf("dtrsm_rltn_batch FAILED: m %d n %d offset %d threads %d lane %d err %e\n", m, n, off, nt, ii, err);
+					n_fail++;
+					}
+				}
+
+			// dpotrf_l, with column offsets on D
+			if(in==0)
+				{
+				for(ii=0; ii<NB; ii++)
+					{
+					blasfeo_dgese(mmax, mmax, 0.0, &sD[ii], 0, 0);
+					blasfeo_dpotrf_l(m, &sC[ii], 0, 0, &sD_ref[ii], 0, off);
+					}
+				blasfeo_dpotrf_l_batch(NB, m, pC, 0, 0, pD, 0, off);
+				for(ii=0; ii<NB; ii++)
+					{
+					n_test++;
+					err = diff_dmat(m, m, 1, &sD[ii], 0, off, &sD_ref[ii], 0, off);
+					if(!(err<=TOL))
+						{
+						printf("dpotrf_l_batch FAILED: m %d offset %d threads %d lane %d err %e\n", m, off, nt, ii, err);
+						n_fail++;
+						}
+					}
+				}
+			}
+
+		// dposv_l_batch vs dpotrf_l + dtrsv_lnn + dtrsv_ltn per system, with offsets on A, b and x
+		for(im=0; im<NSIZE_POSV; im++)
+		for(io=0; io<NOFF; io++)
+			{
+			m = size_posv_list[im];
+			off = off_list[io];
+			// the leading minor of order k_npd+1 of the system lane_npd is not positive definite
+			k_npd = m/2;
+			BLASFEO_DMATEL(&sP[lane_npd], off+k_npd, off+k_npd) = -1.0;
+			for(ii=0; ii<NB_POSV; ii++)
+				{
+				blasfeo_dvecse(mmax, 7.0, &sx[ii], 0);
+				info[ii] = -2;
+				}
+			blasfeo_get_workspace_error();
+			blasfeo_dposv_l_batch(NB_POSV, m, pP, off, off, pb, off, px, off+1, info);
+			ws_err = blasfeo_get_workspace_error();
+			for(ii=0; ii<NB_POSV; ii++)
+				{
+				n_test++;
+				blasfeo_dpotrf_l(m, &sP[ii], off, off, &sL, 0, 0);
+				info_ref = ii==lane_npd ? k_npd+1 : 0;
+				if(info[ii]==-1)
+					{
+					// the workspace can only be too small for the systems not interleaved on the stack
+					if(m<=16 | !(ws_err & BLASFEO_WS_ERR_ALLOC))
+						{
+						printf("dposv_l_batch FAILED: m %d offset %d threads %d lane %d info %d ws_err %d\n", m, off, nt, ii, info[ii], ws_err);
+						n_fail++;
+						}
+					continue;
+					}
+				if(info[ii]!=info_ref)
+					{
+					printf("dposv_l_batch FAILED: m %d offset %d threads %d lane %d info %d expected %d\n", m, off, nt, ii, info[ii], info_ref);
+					n_fail++;
+					continue;
+					}
+				if(info_ref==0)
+					{
+					blasfeo_dtrsv_lnn(m, &sL, 0, 0, &sb[ii], off, &sx_ref, 0);
+					blasfeo_dtrsv_ltn(m, &sL, 0, 0, &sx_ref, 0, &sx_ref, 0);
+					}
+				else
+					{
+					// not modified
+					blasfeo_dvecse(m, 7.0, &sx_ref, 0);
+					}
+				err = 0.0;
+				for(jj=0; jj<m; jj++)
+					{
+					tmp = fabs(BLASFEO_DVECEL(&sx[ii], off+1+jj) - BLASFEO_DVECEL(&sx_ref, jj));
+					// also catches NaN
+					if(!(tmp<=err))
+						err = tmp;
+					}
+				if(!(err<=TOL))
+					{
+					printf("dposv_l_batch FAILED: m %d offset %d threads %d lane %d err %e\n", m, off, nt, ii, err);
+					n_fail++;
+					}
+				}
+			BLASFEO_DMATEL(&sP[lane_npd], off+k_npd, off+k_npd) = BLASFEO_DMATEL(&sC[lane_npd%NB], off+k_npd, off+k_npd);
+			}
+		}
+	blasfeo_set_num_threads(1);
+
+	for(ii=0; ii<NB; ii++)
+		{
+		blasfeo_free_dmat(&sA[ii]);
+		blasfeo_free_dmat(&sB[ii]);
+		blasfeo_free_dmat(&sC[ii]);
+		blasfeo_free_dmat(&sD[ii]);
+		blasfeo_free_dmat(&sD_ref[ii]);
+		}
+
+	blasfeo_free_dmat(&sL);
+	blasfeo_free_dvec(&sx_ref);
+	for(ii=0; ii<NB_POSV; ii++)
+		{
+		blasfeo_free_dmat(&sP[ii]);
+		blasfeo_free_dvec(&sb[ii]);
+		blasfeo_free_dvec(&sx[ii]);
+		}
+
+	printf("\nbatch routines vs loop of single calls: %d tests, %d failed\n\n", n_test, n_fail);
+
+	return n_fail>0;
+
+	}
@@ -0,0 +1,216 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2019 by Gianluca Frison.                                                          *
+* Developed at IMTEK (University of Freiburg) under the supervision of Moritz Diehl.              *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+
+
+#if defined(__linux__)
+#define _GNU_SOURCE
+#include <sched.h>
+#endif
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "../include/blasfeo_target.h"
+#include "../include/blasfeo_common.h"
+#include "../include/blasfeo_d_aux.h"
+#include "../include/blasfeo_d_aux_ext_dep.h"
+#include "../include/blasfeo_d_blasfeo_api.h"
+#include "../include/blasfeo_thread_pool.h"
+
+
+
+#define NSIZE 6
+#define NOFF 3
+#define MAX_THREADS 8
+
+
+
+// fill the matrix with random values
+static void rand_dmat(int m, int n, struct blasfeo_dmat *sA)
+	{
+	int ii, jj;
+	for(jj=0; jj<n; jj++)
+		for(ii=0; ii<m; ii++)
+			BLASFEO_DMATEL(sA, ii, jj) = (double) rand() / RAND_MAX - 0.5;
+	}
+
+
+
+// return 1 if the m x n sub-matrices are bit-wise identical
+static int equal_dmat(int m, int n, struct blasfeo_dmat *sA, int ai, int aj, struct blasfeo_dmat *sB, int bi, int bj)
+	{
+	int ii, jj;
+	for(jj=0; jj<n; jj++)
+		for(ii=0; ii<m; ii++)
+			if(BLASFEO_DMATEL(sA, ai+ii, aj+jj)!=BLASFEO_DMATEL(sB, bi+ii, bj+jj))
+				return 0;
+	return 1;
+	}
+
+
+
+// compare the multi-threaded dgemm_nn/nt against the serial one; return the number of failures
+static int check_dgemm(const char *label, int *n_test, struct blasfeo_dmat *sA, struct blasfeo_dmat *sB, struct blasfeo_dmat *sC, struct blasfeo_dmat *sD, struct blasfeo_dmat *sD_ref, int mmax)
+	{
+
+	int size_list[NSIZE] = {1, 7, 65, 101, 203, 317};
+	int off_list[NOFF] = {0, 1, 5};
+
+	int im, in, ik, io, nt, tran;
+	int m, n, k, off;
+	int n_fail = 0;
+
+	for(tran=0; tran<2; tran++)
+	for(im=0; im<NSIZE; im++)
+	for(in=0; in<NSIZE; in++)
+	for(ik=0; ik<NSIZE; ik+=2)
+	for(io=0; io<NOFF; io++)
+		{
+		m = size_list[im];
+		n = size_list[in];
+		k = size_list[ik];
+		off = off_list[io];
+		// serial reference; the idle workers spin and then go to sleep meanwhile
+		blasfeo_set_num_threads(1);
+		if(tran)
+			blasfeo_dgemm_nt(m, n, k, 1.5, sA, off, 1, sB, off+2, 0, -0.5, sC, 3, off, sD_ref, off, 2);
+		else
+			blasfeo_dgemm_nn(m, n, k, 1.5, sA, off, 1, sB, 0, off, -0.5, sC, 3, off, sD_ref, off, 2);
+		for(nt=2; nt<=MAX_THREADS; nt++)
+			{
+			blasfeo_set_num_threads(nt);
+			blasfeo_dgese(mmax, mmax, 0.0, sD, 0, 0);
+			if(tran)
+				blasfeo_dgemm_nt(m, n, k, 1.5, sA, off, 1, sB, off+2, 0, -0.5, sC, 3, off, sD, off, 2);
+			else
+				blasfeo_dgemm_nn(m, n, k, 1.5, sA, off, 1, sB, 0, off, -0.5, sC, 3, off, sD, off, 2);
+			(*n_test)++;
+			if(!equal_dmat(m, n, sD, off, 2, sD_ref, off, 2))
+				{
+				printf("dgemm_%s FAILED (%s): m %d n %d k %d offset %d threads %d\n", tran ? "nt" : "nn", label, m, n, k, off, nt);
+				n_fail++;
+				}
+			}
+		}
+	blasfeo_set_num_threads(1);
+
+	return n_fail;
+
+	}
+
+
+
+#if defined(__linux__)
+static int worker_cpu[MAX_THREADS];
+
+static void get_cpu(int tid, int num_threads, void *arg)
+	{
+	worker_cpu[tid] = sched_getcpu();
+	}
+#endif
+
+
+
+int main()
+	{
+
+	int mmax = 317 + 8;
+
+	struct blasfeo_dmat sA, sB, sC, sD, sD_ref;
+	blasfeo_allocate_dmat(mmax, mmax, &sA);
+	blasfeo_allocate_dmat(mmax, mmax, &sB);
+	blasfeo_allocate_dmat(mmax, mmax, &sC);
+	blasfeo_allocate_dmat(mmax, mmax, &sD);
+	blasfeo_allocate_dmat(mmax, mmax, &sD_ref);
+	rand_dmat(mmax, mmax, &sA);
+	rand_dmat(mmax, mmax, &sB);
+	rand_dmat(mmax, mmax, &sC);
+
+	int n_test = 0;
+	int n_fail = 0;
+
+	// default spin-then-sleep
+	n_fail += check_dgemm("default spin", &n_test, &sA, &sB, &sC, &sD, &sD_ref, mmax);
+
+	// waiting threads go to sleep immediately
+	blasfeo_set_thread_pool_spin(0);
+	n_fail += check_dgemm("no spin", &n_test, &sA, &sB, &sC, &sD, &sD_ref, mmax);
+
+	// waiting threads go to sleep after a few polling iterations, i.e. between the jobs
+	blasfeo_set_thread_pool_spin(100);
+	n_fail += check_dgemm("short spin", &n_test, &sA, &sB, &sC, &sD, &sD_ref, mmax);
+	blasfeo_set_thread_pool_spin(BLASFEO_THREAD_POOL_SPIN);
+
+#if defined(__linux__)
+	// pin all workers to the cpu of the calling thread: the workers are re-created there,
+	// and their packing buffers first touched by the pinned threads
+	int cpu = sched_getcpu();
+	int ii;
+	if(cpu>=0)
+		{
+		if(!blasfeo_set_thread_affinity(1, &cpu))
+			{
+			printf("blasfeo_set_thread_affinity FAILED\n");
+			n_fail++;
+			}
+		for(ii=0; ii<MAX_THREADS; ii++)
+			worker_cpu[ii] = -1;
+		blasfeo_thread_pool_run(MAX_THREADS, &get_cpu, NULL);
+		n_test++;
+		for(ii=1; ii<MAX_THREADS; ii++)
+			{
+			if(worker_cpu[ii]!=cpu)
+				{
+				printf("thread affinity FAILED: worker %d on cpu %d instead of %d\n", ii, worker_cpu[ii], cpu);
+				n_fail++;
+				break;
+				}
+			}
+		n_fail += check_dgemm("pinned", &n_test, &sA, &sB, &sC, &sD, &sD_ref, mmax);
+		blasfeo_set_thread_affinity(0, NULL);
+		}
+#endif
+
+	blasfeo_free_dmat(&sA);
+	blasfeo_free_dmat(&sB);
+	blasfeo_free_dmat(&sC);
+	blasfeo_free_dmat(&sD);
+	blasfeo_free_dmat(&sD_ref);
+
+	printf("\ndgemm multi-threaded vs serial: %d tests, %d failed\n\n", n_test, n_fail);
+
+	return n_fail>0;
+
+	}
@@ -0,0 +1,177 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2019 by Gianluca Frison.                                                          *
+* Developed at IMTEK (University of Freiburg) under the supervision of Moritz Diehl.              *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+
+#include "../include/blasfeo_target.h"
+#include "../include/blasfeo_common.h"
+#include "../include/blasfeo_stdlib.h"
+#include "../include/blasfeo_memory.h"
+#include "../include/blasfeo_d_blas_api.h"
+
+
+
+#define NSIZE 6
+#define NREUSE 3
+#define TOL 1e-10
+
+
+
+// fill the array with random values
+static void rand_dvec(int n, double *x)
+	{
+	int ii;
+	for(ii=0; ii<n; ii++)
+		x[ii] = (double) rand() / RAND_MAX - 0.5;
+	}
+
+
+
+// maximum absolute difference between the m x n column-major matrices
+static double diff_dcm(int m, int n, double *A, int lda, double *B, int ldb)
+	{
+	int ii, jj;
+	double tmp, err = 0.0;
+	for(jj=0; jj<n; jj++)
+		for(ii=0; ii<m; ii++)
+			{
+			tmp = fabs(A[ii+jj*lda] - B[ii+jj*ldb]);
+			// also catches NaN
+			if(!(tmp<=err))
+				err = tmp;
+			}
+	return err;
+	}
+
+
+
+int main()
+	{
+
+	// odd sizes around the kernel heights, plus k beyond the k-blocking
+	int sizes[NSIZE] = {1, 5, 13, 27, 61, 600};
+	char trans[2] = {'n', 't'};
+
+	int n_fail = 0;
+	int n_test = 0;
+
+	int ii, im, ik, ia, ib, ir, m, n, k, lda, ldb, ldc;
+	char ta, tb;
+	double alpha, beta, err;
+	size_t size;
+	void *pA;
+	double *A, *B, *C, *D;
+
+	// run in a workspace, as required by the builds with NO_INTERNAL_MALLOC
+	void *work;
+	blasfeo_malloc_align(&work, blasfeo_memsize_workspace(sizes[NSIZE-1]));
+	blasfeo_init_workspace(sizes[NSIZE-1], work);
+
+	for(ia=0; ia<2; ia++)
+		{
+		ta = trans[ia];
+		for(im=0; im<NSIZE; im++)
+			{
+			m = sizes[im];
+			for(ik=0; ik<NSIZE; ik++)
+				{
+				k = sizes[ik];
+				if(m*k>20000)
+					continue;
+
+				lda = (ta=='n' ? m : k) + 3;
+				A = malloc(lda*(ta=='n' ? k : m)*sizeof(double));
+				rand_dvec(lda*(ta=='n' ? k : m), A);
+
+				// pack op(A) once
+				size = blasfeo_blas_dgemm_pack_get_size(&m, &k);
+				blasfeo_malloc_align(&pA, size);
+				blasfeo_blas_dgemm_pack(&ta, &m, &k, A, &lda, pA);
+
+				// and reuse it for several products with different B, alpha, beta and op(B)
+				for(ir=0; ir<NREUSE; ir++)
+					{
+					for(ib=0; ib<2; ib++)
+						{
+						tb = trans[ib];
+						n = sizes[(im+ik+ir+ib)%(NSIZE-1)];
+						alpha = 1.5 - ir;
+						beta = ir==0 ? 0.0 : 0.5*ir;
+
+						ldb = (tb=='n' ? k : n) + 1;
+						ldc = m + 2;
+						B = malloc(ldb*(tb=='n' ? n : k)*sizeof(double));
+						C = malloc(ldc*n*sizeof(double));
+						D = malloc(ldc*n*sizeof(double));
+						rand_dvec(ldb*(tb=='n' ? n : k), B);
+						rand_dvec(ldc*n, C);
+						for(ii=0; ii<ldc*n; ii++)
+							D[ii] = C[ii];
+
+						blasfeo_blas_dgemm_compute(&tb, &n, &alpha, pA, B, &ldb, &beta, C, &ldc);
+						blasfeo_blas_dgemm(&ta, &tb, &m, &n, &k, &alpha, A, &lda, B, &ldb, &beta, D, &ldc);
+
+						err = diff_dcm(m, n, C, ldc, D, ldc);
+						n_test++;
+						if(!(err<=TOL*(k+1)))
+							{
+							n_fail++;
+							printf("dgemm_compute %c%c m=%d n=%d k=%d reuse=%d: error %e\n", ta, tb, m, n, k, ir, err);
+							}
+
+						free(B);
+						free(C);
+						free(D);
+						}
+					}
+
+				blasfeo_free_align(pA);
+				free(A);
+				}
+			}
+		}
+
+	blasfeo_quit();
+	blasfeo_free_align(work);
+
+	printf("\n%d packed gemm tests, %d failed\n\n", n_test, n_fail);
+
+	return n_fail>0;
+
+	}
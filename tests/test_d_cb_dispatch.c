@@ -0,0 +1,190 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2019 by Gianluca Frison.                                                          *
+* Developed at IMTEK (University of Freiburg) under the supervision of Moritz Diehl.              *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+
+#include "../include/blasfeo_target.h"
+#include "../include/blasfeo_common.h"
+#include "../include/blasfeo_d_aux.h"
+#include "../include/blasfeo_d_blasfeo_api.h"
+#include "../include/blasfeo_processor_features.h"
+
+
+
+#define N 13
+#define NREP 5 // number of result matrices
+#define NISA 5
+
+
+
+static void cb_allocate(struct blasfeo_cb_dmat *sA)
+	{
+	blasfeo_cb_create_dmat(N, N, sA, malloc(blasfeo_cb_memsize_dmat(N, N)));
+	}
+
+
+
+// run all compact batch routines on the same input with the currently selected kernel set
+static void run_cb(struct blasfeo_cb_dmat *sA, struct blasfeo_cb_dmat *sB, struct blasfeo_cb_dmat *sD, int *ipiv)
+	{
+	// gemm_nn, gemm_nt
+	blasfeo_cb_dgemm_nn(N, N, N, 1.0, sA, 0, 0, sB, 0, 0, 0.0, sB, 0, 0, &sD[0], 0, 0);
+	// positive definite, B is the identity
+	blasfeo_cb_dgemm_nt(N, N, N, 1.0, sA, 0, 0, sA, 0, 0, 1.0, sB, 0, 0, &sD[1], 0, 0);
+	// potrf, trsm_rltn
+	blasfeo_cb_dpotrf_l(N, &sD[1], 0, 0, &sD[2], 0, 0);
+	blasfeo_cb_dtrsm_rltn(N, N, 1.0, &sD[2], 0, 0, sA, 0, 0, &sD[3], 0, 0);
+	// potrs
+	blasfeo_cb_dpotrs_l(N, N, &sD[2], 0, 0, sA, 0, 0, &sD[4], 0, 0);
+	// getrf_rp, in place on the gemm_nn result
+	blasfeo_cb_dgetrf_rp(N, N, &sD[0], 0, 0, &sD[0], 0, 0, ipiv);
+	}
+
+
+
+int main()
+	{
+
+#if !defined(RUNTIME_DISPATCH)
+	printf("\nRecompile with RUNTIME_DISPATCH=1 to run this test!\n\n");
+	return 0;
+#else
+
+	int ii, jj, ll, rr, ss;
+
+	int isa_list[NISA] = {BLASFEO_PROCESSOR_ISA_CORE, BLASFEO_PROCESSOR_ISA_SANDY_BRIDGE, BLASFEO_PROCESSOR_ISA_HASWELL, BLASFEO_PROCESSOR_ISA_SKYLAKE_X, BLASFEO_PROCESSOR_ISA_ZEN5};
+	char *isa_name[NISA] = {"CORE", "SANDY_BRIDGE", "HASWELL", "SKYLAKE_X", "ZEN5"};
+
+	char feature_string[128];
+	int features;
+	blasfeo_processor_cpu_features(&features);
+	blasfeo_processor_feature_string(features, feature_string);
+	printf("\nprocessor features:%s\n", feature_string);
+	printf("auto-selected kernel set: %d\n\n", blasfeo_cb_get_isa());
+
+	// input matrices
+	double *A = malloc(N*N*sizeof(double));
+	struct blasfeo_cb_dmat sA, sB, sD[NREP], sD_ref[NREP];
+	cb_allocate(&sA);
+	cb_allocate(&sB);
+	for(rr=0; rr<NREP; rr++)
+		{
+		cb_allocate(&sD[rr]);
+		cb_allocate(&sD_ref[rr]);
+		}
+	for(ll=0; ll<BLASFEO_CB_D_NL; ll++)
+		{
+		for(ii=0; ii<N*N; ii++)
+			A[ii] = (double) rand() / RAND_MAX - 0.5;
+		blasfeo_cb_pack_dmat(N, N, A, N, &sA, 0, 0, ll);
+		for(ii=0; ii<N; ii++)
+			for(jj=0; jj<N; jj++)
+				A[ii+N*jj] = ii==jj ? 1.0 : 0.0;
+		blasfeo_cb_pack_dmat(N, N, A, N, &sB, 0, 0, ll);
+		}
+
+	int *ipiv = malloc(N*BLASFEO_CB_D_NL*sizeof(int));
+	int *ipiv_ref = malloc(N*BLASFEO_CB_D_NL*sizeof(int));
+
+	// the scalar kernel set, available on any processor, is the reference
+	if(!blasfeo_cb_set_isa(BLASFEO_PROCESSOR_ISA_CORE))
+		{
+		printf("error: CORE kernel set not available\n");
+		return 1;
+		}
+	run_cb(&sA, &sB, sD_ref, ipiv_ref);
+
+	int n_fail = 0;
+	double err, err_max;
+
+	for(ss=0; ss<NISA; ss++)
+		{
+		if(!blasfeo_cb_set_isa(isa_list[ss]))
+			{
+			printf("%-12s skipped, not supported by this processor\n", isa_name[ss]);
+			continue;
+			}
+		if(blasfeo_cb_get_isa()!=isa_list[ss])
+			{
+			printf("%-12s FAILED, kernel set not selected\n", isa_name[ss]);
+			n_fail++;
+			continue;
+			}
+		run_cb(&sA, &sB, sD, ipiv);
+		err_max = 0.0;
+		for(rr=0; rr<NREP; rr++)
+			{
+			for(ii=0; ii<N*N*BLASFEO_CB_D_NL; ii++)
+				{
+				err = fabs(sD[rr].pA[ii]-sD_ref[rr].pA[ii]);
+				err_max = err>err_max ? err : err_max;
+				}
+			}
+		for(ii=0; ii<N*BLASFEO_CB_D_NL; ii++)
+			{
+			if(ipiv[ii]!=ipiv_ref[ii])
+				err_max = 1.0;
+			}
+		if(err_max>1e-10)
+			{
+			printf("%-12s FAILED, max error %e\n", isa_name[ss], err_max);
+			n_fail++;
+			}
+		else
+			{
+			printf("%-12s passed, max error %e\n", isa_name[ss], err_max);
+			}
+		}
+
+	free(A);
+	free(ipiv);
+	free(ipiv_ref);
+	free(sA.mem);
+	free(sB.mem);
+	for(rr=0; rr<NREP; rr++)
+		{
+		free(sD[rr].mem);
+		free(sD_ref[rr].mem);
+		}
+
+	printf("\n");
+	return n_fail>0;
+
+#endif
+
+	}
@@ -0,0 +1,325 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2019 by Gianluca Frison.                                                          *
+* Developed at IMTEK (University of Freiburg) under the supervision of Moritz Diehl.              *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+
+#include "../include/blasfeo_target.h"
+#include "../include/blasfeo_common.h"
+#include "../include/blasfeo_memory.h"
+#include "../include/blasfeo_thread_pool.h"
+#include "../include/blasfeo_d_aux.h"
+#include "../include/blasfeo_d_aux_ext_dep.h"
+#include "../include/blasfeo_d_blasfeo_api.h"
+#include "../include/blasfeo_d_riccati.h"
+
+
+
+#define NN_MAX 64
+
+
+
+// scenario tree of robust MPC: the root has nx0 states, each node branches into nr children up to depth Nr,
+// then each scenario goes on as a chain up to depth N; return the number of nodes
+static int scenario_tree(int N, int Nr, int nr, int *parent, int *depth)
+	{
+	int ii, jj, Nn = 1, n0 = 0, n1;
+	parent[0] = -1;
+	depth[0] = 0;
+	while(1)
+		{
+		n1 = Nn;
+		for(ii=n0; ii<n1; ii++)
+			{
+			if(depth[ii]==N)
+				continue;
+			int nkids = depth[ii]<Nr ? nr : 1;
+			for(jj=0; jj<nkids; jj++)
+				{
+				parent[Nn] = ii;
+				depth[Nn] = depth[ii]+1;
+				Nn++;
+				}
+			}
+		if(Nn==n1)
+			break;
+		n0 = n1;
+		}
+	return Nn;
+	}
+
+
+
+// solve the KKT system of the tree problem with a dense LU factorization:
+// the unknowns are ux of all nodes followed by pi of all nodes but the root, in node order
+static void dense_kkt_solve(int Nn, int *parent, int *nx, int *nu, struct blasfeo_dmat *BAbt, struct blasfeo_dmat *RSQrq, struct blasfeo_dvec *b, struct blasfeo_dvec *rq, struct blasfeo_dvec *ux, struct blasfeo_dvec *pi)
+	{
+	int ii, jj, kk, p;
+	int idx_ux[NN_MAX], idx_pi[NN_MAX];
+	int nz = 0;
+	for(ii=0; ii<Nn; ii++)
+		{
+		idx_ux[ii] = nz;
+		nz += nu[ii]+nx[ii];
+		}
+	int nkkt = nz;
+	for(ii=0; ii<Nn; ii++)
+		{
+		idx_pi[ii] = nkkt;
+		if(parent[ii]>=0)
+			nkkt += nx[ii];
+		}
+
+	struct blasfeo_dmat K;
+	struct blasfeo_dvec r;
+	int *ipiv = malloc(nkkt*sizeof(int));
+	blasfeo_allocate_dmat(nkkt, nkkt, &K);
+	blasfeo_allocate_dvec(nkkt, &r);
+	blasfeo_dgese(nkkt, nkkt, 0.0, &K, 0, 0);
+
+	// [H G^T; G 0] [z; l] = [-rq; -b]
+	for(ii=0; ii<Nn; ii++)
+		{
+		int nux = nu[ii]+nx[ii];
+		int i0 = idx_ux[ii];
+		for(jj=0; jj<nux; jj++)
+			{
+			for(kk=jj; kk<nux; kk++)
+				{
+				BLASFEO_DMATEL(&K, i0+kk, i0+jj) = BLASFEO_DMATEL(&RSQrq[ii], kk, jj);
+				BLASFEO_DMATEL(&K, i0+jj, i0+kk) = BLASFEO_DMATEL(&RSQrq[ii], kk, jj);
+				}
+			BLASFEO_DVECEL(&r, i0+jj) = -BLASFEO_DVECEL(&rq[ii], jj);
+			}
+		p = parent[ii];
+		if(p<0)
+			continue;
+		// dynamics: BAbt[ii]^T ux[p] - x[ii] = -b[ii]
+		int l0 = idx_pi[ii];
+		for(jj=0; jj<nx[ii]; jj++)
+			{
+			for(kk=0; kk<nu[p]+nx[p]; kk++)
+				{
+				BLASFEO_DMATEL(&K, l0+jj, idx_ux[p]+kk) = BLASFEO_DMATEL(&BAbt[ii], kk, jj);
+				BLASFEO_DMATEL(&K, idx_ux[p]+kk, l0+jj) = BLASFEO_DMATEL(&BAbt[ii], kk, jj);
+				}
+			BLASFEO_DMATEL(&K, l0+jj, i0+nu[ii]+jj) = -1.0;
+			BLASFEO_DMATEL(&K, i0+nu[ii]+jj, l0+jj) = -1.0;
+			BLASFEO_DVECEL(&r, l0+jj) = -BLASFEO_DVECEL(&b[ii], jj);
+			}
+		}
+
+	blasfeo_dgetrf_rp(nkkt, nkkt, &K, 0, 0, &K, 0, 0, ipiv);
+	blasfeo_dvecpe(nkkt, ipiv, &r, 0);
+	blasfeo_dtrsv_lnu(nkkt, &K, 0, 0, &r, 0, &r, 0);
+	blasfeo_dtrsv_unn(nkkt, &K, 0, 0, &r, 0, &r, 0);
+
+	for(ii=0; ii<Nn; ii++)
+		{
+		blasfeo_dveccp(nu[ii]+nx[ii], &r, idx_ux[ii], &ux[ii], 0);
+		if(parent[ii]>=0)
+			blasfeo_dveccp(nx[ii], &r, idx_pi[ii], &pi[ii], 0);
+		}
+
+	free(ipiv);
+	blasfeo_free_dmat(&K);
+	blasfeo_free_dvec(&r);
+	return;
+	}
+
+
+
+// max | x - y | over the first n elements
+static double dvec_dist(int n, struct blasfeo_dvec *sx, struct blasfeo_dvec *sy)
+	{
+	int ii;
+	double d, err = 0.0;
+	for(ii=0; ii<n; ii++)
+		{
+		d = fabs(BLASFEO_DVECEL(sx, ii)-BLASFEO_DVECEL(sy, ii));
+		err = d>err ? d : err;
+		}
+	return err;
+	}
+
+
+
+int main()
+	{
+
+	int ii, jj, kk, it, nt;
+
+	// N, Nr, nr: chain, binary tree, robust MPC scenario trees
+	int tree_list[][3] = {{5, 0, 1}, {3, 3, 2}, {5, 1, 3}, {4, 2, 3}, {6, 2, 2}};
+	int n_trees = sizeof(tree_list)/sizeof(tree_list[0]);
+	int nt_list[] = {1, 2, 4};
+	int n_nt = sizeof(nt_list)/sizeof(int);
+
+	int parent[NN_MAX], depth[NN_MAX], nx[NN_MAX], nu[NN_MAX];
+	struct blasfeo_dmat BAbt[NN_MAX], RSQrq[NN_MAX];
+	struct blasfeo_dvec b[NN_MAX], rq[NN_MAX], ux[NN_MAX], pi[NN_MAX], ux_ref[NN_MAX], pi_ref[NN_MAX];
+	struct blasfeo_driccati_tree_ws ws;
+
+	int n_test = 0;
+	int n_fail = 0;
+
+	// the tree recursion allocates the work matrix of each thread from its workspace
+	void *work = malloc(blasfeo_memsize_workspace(32)+64);
+	blasfeo_init_workspace(32, (void *) (((size_t) work + 63) / 64 * 64));
+	void *pool_work = malloc(blasfeo_memsize_thread_pool_workspace(4, 32));
+	blasfeo_set_thread_pool_workspace(4, 32, pool_work);
+
+	srand(1);
+
+	for(it=0; it<n_trees; it++)
+		{
+
+		int Nn = scenario_tree(tree_list[it][0], tree_list[it][1], tree_list[it][2], parent, depth);
+
+		// sizes vary across the nodes; the leaves have no inputs
+		for(ii=0; ii<Nn; ii++)
+			{
+			nx[ii] = 2+ii%3;
+			nu[ii] = depth[ii]==tree_list[it][0] ? 0 : 1+ii%2;
+			}
+
+		for(ii=0; ii<Nn; ii++)
+			{
+			int nux = nu[ii]+nx[ii];
+			blasfeo_allocate_dmat(nux+1, nux, &RSQrq[ii]);
+			blasfeo_allocate_dvec(nux, &rq[ii]);
+			blasfeo_allocate_dvec(nux, &ux[ii]);
+			blasfeo_allocate_dvec(nux, &ux_ref[ii]);
+			// positive definite by diagonal dominance
+			blasfeo_dgese(nux+1, nux, 0.0, &RSQrq[ii], 0, 0);
+			for(jj=0; jj<nux; jj++)
+				{
+				BLASFEO_DMATEL(&RSQrq[ii], jj, jj) = 1.0 + (double) rand() / RAND_MAX;
+				for(kk=jj+1; kk<nux; kk++)
+					BLASFEO_DMATEL(&RSQrq[ii], kk, jj) = 0.2 * ((double) rand() / RAND_MAX - 0.5);
+				BLASFEO_DVECEL(&rq[ii], jj) = (double) rand() / RAND_MAX - 0.5;
+				}
+			int p = parent[ii];
+			if(p<0)
+				continue;
+			blasfeo_allocate_dmat(nu[p]+nx[p]+1, nx[ii], &BAbt[ii]);
+			blasfeo_allocate_dvec(nx[ii], &b[ii]);
+			blasfeo_allocate_dvec(nx[ii], &pi[ii]);
+			blasfeo_allocate_dvec(nx[ii], &pi_ref[ii]);
+			blasfeo_dgese(nu[p]+nx[p]+1, nx[ii], 0.0, &BAbt[ii], 0, 0);
+			for(jj=0; jj<nx[ii]; jj++)
+				{
+				for(kk=0; kk<nu[p]+nx[p]; kk++)
+					BLASFEO_DMATEL(&BAbt[ii], kk, jj) = (double) rand() / RAND_MAX - 0.5;
+				BLASFEO_DVECEL(&b[ii], jj) = (double) rand() / RAND_MAX - 0.5;
+				}
+			}
+
+		dense_kkt_solve(Nn, parent, nx, nu, BAbt, RSQrq, b, rq, ux_ref, pi_ref);
+
+		void *ws_mem = malloc(blasfeo_memsize_driccati_tree_ws(Nn, nx, nu));
+		blasfeo_create_driccati_tree_ws(Nn, parent, nx, nu, &ws, ws_mem);
+
+		for(kk=0; kk<n_nt; kk++)
+			{
+			nt = nt_list[kk];
+			blasfeo_set_num_threads(nt);
+
+			for(ii=0; ii<Nn; ii++)
+				{
+				blasfeo_dvecse(nu[ii]+nx[ii], 0.0, &ux[ii], 0);
+				if(parent[ii]>=0)
+					blasfeo_dvecse(nx[ii], 0.0, &pi[ii], 0);
+				}
+
+			blasfeo_driccati_tree_trf(Nn, nx, nu, BAbt, RSQrq, &ws);
+			blasfeo_driccati_tree_trs(Nn, nx, nu, BAbt, b, rq, ux, pi, &ws);
+
+			double err = 0.0, d;
+			for(ii=0; ii<Nn; ii++)
+				{
+				d = dvec_dist(nu[ii]+nx[ii], &ux[ii], &ux_ref[ii]);
+				err = d>err ? d : err;
+				if(parent[ii]>=0)
+					{
+					d = dvec_dist(nx[ii], &pi[ii], &pi_ref[ii]);
+					err = d>err ? d : err;
+					}
+				}
+			n_test++;
+			if(!(err<1e-10))
+				{
+				printf("driccati_tree FAILED: N %d Nr %d nr %d nodes %d threads %d err %e\n", tree_list[it][0], tree_list[it][1], tree_list[it][2], Nn, nt, err);
+				n_fail++;
+				}
+			}
+		blasfeo_set_num_threads(1);
+
+		free(ws_mem);
+		for(ii=0; ii<Nn; ii++)
+			{
+			blasfeo_free_dmat(&RSQrq[ii]);
+			blasfeo_free_dvec(&rq[ii]);
+			blasfeo_free_dvec(&ux[ii]);
+			blasfeo_free_dvec(&ux_ref[ii]);
+			if(parent[ii]>=0)
+				{
+				blasfeo_free_dmat(&BAbt[ii]);
+				blasfeo_free_dvec(&b[ii]);
+				blasfeo_free_dvec(&pi[ii]);
+				blasfeo_free_dvec(&pi_ref[ii]);
+				}
+			}
+
+		}
+
+	if(blasfeo_get_workspace_error()!=0)
+		{
+		printf("workspace FAILED\n");
+		n_fail++;
+		}
+
+	printf("\ntest_d_riccati: %d tests, %d failed\n\n", n_test, n_fail);
+
+	blasfeo_set_thread_pool_workspace(4, 32, NULL);
+	free(pool_work);
+	blasfeo_quit();
+	free(work);
+
+	return n_fail>0;
+
+	}
@@ -0,0 +1,155 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2019 by Gianluca Frison.                                                          *
+* Developed at IMTEK (University of Freiburg) under the supervision of Moritz Diehl.              *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+
+#include "../include/blasfeo_target.h"
+#include "../include/blasfeo_common.h"
+#include "../include/blasfeo_d_aux.h"
+#include "../include/blasfeo_d_aux_ext_dep.h"
+#include "../include/blasfeo_d_blasfeo_api.h"
+
+
+
+#define NSIZE 9
+#define NOFF 4
+
+
+
+// max | D - (beta*C + alpha*A*B^T) | over the lower triangular of the first n columns of the m x m result
+static double dsyrk_ln_err(int m, int n, int k, double alpha, struct blasfeo_dmat *sA, int ai, struct blasfeo_dmat *sB, int bi, double beta, struct blasfeo_dmat *sC, int ci, struct blasfeo_dmat *sD, int di)
+	{
+	int ii, jj, ll;
+	double tmp, d, err = 0.0;
+	for(jj=0; jj<n; jj++)
+		{
+		for(ii=jj; ii<m; ii++)
+			{
+			tmp = 0.0;
+			for(ll=0; ll<k; ll++)
+				tmp += BLASFEO_DMATEL(sA, ai+ii, ll) * BLASFEO_DMATEL(sB, bi+jj, ll);
+			tmp = beta*BLASFEO_DMATEL(sC, ci+ii, jj) + alpha*tmp;
+			d = fabs(BLASFEO_DMATEL(sD, di+ii, jj) - tmp);
+			err = d>err ? d : err;
+			}
+		}
+	return err;
+	}
+
+
+
+int main()
+	{
+
+	int ii, jj, im, ik, ia, ib, ic;
+
+	// sizes around the 4x4 and 8x4 blocks
+	int m_list[NSIZE] = {1, 3, 4, 5, 7, 8, 9, 12, 13};
+	int k_list[] = {1, 4, 7};
+	int n_k = sizeof(k_list)/sizeof(int);
+
+	int mmax = 13+NOFF;
+	int kmax = 7;
+
+	struct blasfeo_dmat sA, sB, sC, sD;
+	blasfeo_allocate_dmat(mmax, kmax, &sA);
+	blasfeo_allocate_dmat(mmax, kmax, &sB);
+	blasfeo_allocate_dmat(mmax, mmax, &sC);
+	blasfeo_allocate_dmat(mmax, mmax, &sD);
+
+	srand(1);
+	for(jj=0; jj<kmax; jj++)
+		for(ii=0; ii<mmax; ii++)
+			{
+			BLASFEO_DMATEL(&sA, ii, jj) = (double) rand() / RAND_MAX - 0.5;
+			BLASFEO_DMATEL(&sB, ii, jj) = (double) rand() / RAND_MAX - 0.5;
+			}
+	for(jj=0; jj<mmax; jj++)
+		for(ii=0; ii<mmax; ii++)
+			BLASFEO_DMATEL(&sC, ii, jj) = (double) rand() / RAND_MAX - 0.5;
+
+	int n_test = 0;
+	int n_fail = 0;
+	double err;
+
+	// the row offsets of B select the generic kernels that store into a block shifted by the offset
+	for(im=0; im<NSIZE; im++)
+		{
+		int m = m_list[im];
+		for(ik=0; ik<n_k; ik++)
+			{
+			int k = k_list[ik];
+			for(ia=0; ia<NOFF; ia++)
+				for(ib=0; ib<NOFF; ib++)
+					for(ic=0; ic<NOFF; ic++)
+						{
+						// C and D with the same row offset, as required by the panel-major routines
+						blasfeo_dgese(mmax, mmax, 0.0, &sD, 0, 0);
+						blasfeo_dsyrk_ln(m, k, 1.5, &sA, ia, 0, &sB, ib, 0, 0.5, &sC, ic, 0, &sD, ic, 0);
+						err = dsyrk_ln_err(m, m, k, 1.5, &sA, ia, &sB, ib, 0.5, &sC, ic, &sD, ic);
+						n_test++;
+						if(!(err<1e-12))
+							{
+							printf("dsyrk_ln FAILED: m %d k %d ai %d bi %d ci %d err %e\n", m, k, ia, ib, ic, err);
+							n_fail++;
+							}
+
+						int n = (m+1)/2;
+						blasfeo_dgese(mmax, mmax, 0.0, &sD, 0, 0);
+						blasfeo_dsyrk_ln_mn(m, n, k, 1.5, &sA, ia, 0, &sB, ib, 0, 0.5, &sC, ic, 0, &sD, ic, 0);
+						err = dsyrk_ln_err(m, n, k, 1.5, &sA, ia, &sB, ib, 0.5, &sC, ic, &sD, ic);
+						n_test++;
+						if(!(err<1e-12))
+							{
+							printf("dsyrk_ln_mn FAILED: m %d n %d k %d ai %d bi %d ci %d err %e\n", m, n, k, ia, ib, ic, err);
+							n_fail++;
+							}
+						}
+			}
+		}
+
+	printf("\ntest_d_syrk: %d tests, %d failed\n\n", n_test, n_fail);
+
+	blasfeo_free_dmat(&sA);
+	blasfeo_free_dmat(&sB);
+	blasfeo_free_dmat(&sC);
+	blasfeo_free_dmat(&sD);
+
+	return n_fail>0;
+
+	}
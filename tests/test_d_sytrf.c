@@ -0,0 +1,447 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2019 by Gianluca Frison.                                                          *
+* Developed at IMTEK (University of Freiburg) under the supervision of Moritz Diehl.              *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+
+#include "../include/blasfeo_target.h"
+#include "../include/blasfeo_common.h"
+#include "../include/blasfeo_memory.h"
+#include "../include/blasfeo_d_aux.h"
+#include "../include/blasfeo_d_aux_ext_dep.h"
+#include "../include/blasfeo_d_blasfeo_api.h"
+
+
+
+#define NSIZE 10
+#define NSIZE_NOPIV 16
+#define NOFF 4
+#define NRHS 3
+
+
+
+// max | C - P^T * L * D * L^T * P | over the lower triangular, relative to max | C |, with the factors in D as returned by blasfeo_dsytrf_l;
+// returns -1 if the factors contain non-finite values
+static double dsytrf_l_err(int m, struct blasfeo_dmat *sC, int ci, struct blasfeo_dmat *sD, int di, int *ipiv)
+	{
+	int ii, jj, ll, kp;
+	double tmp, d, err, nrm;
+	double *L = malloc(m*m*sizeof(double));
+	double *LD = malloc(m*m*sizeof(double));
+	double *M = malloc(m*m*sizeof(double));
+	// L unit lower triangular, LD = L * D with D block diagonal
+	for(jj=0; jj<m; jj++)
+		for(ii=0; ii<m; ii++)
+			{
+			L[ii+m*jj] = ii>jj ? BLASFEO_DMATEL(sD, di+ii, jj) : ii==jj ? 1.0 : 0.0;
+			if(!isfinite(L[ii+m*jj]))
+				{
+				free(L);
+				free(LD);
+				free(M);
+				return -1.0;
+				}
+			}
+	for(jj=0; jj<m; jj++)
+		{
+		if(ipiv[jj]>=0)
+			{
+			d = BLASFEO_DMATEL(sD, di+jj, jj);
+			for(ii=0; ii<m; ii++)
+				LD[ii+m*jj] = L[ii+m*jj]*d;
+			}
+		else
+			{
+			// 2x2 block, with the off-diagonal element in the upper triangular
+			double d11 = BLASFEO_DMATEL(sD, di+jj, jj);
+			double d21 = BLASFEO_DMATEL(sD, di+jj, jj+1);
+			double d22 = BLASFEO_DMATEL(sD, di+jj+1, jj+1);
+			for(ii=0; ii<m; ii++)
+				{
+				LD[ii+m*jj] = L[ii+m*jj]*d11 + L[ii+m*(jj+1)]*d21;
+				LD[ii+m*(jj+1)] = L[ii+m*jj]*d21 + L[ii+m*(jj+1)]*d22;
+				}
+			jj++;
+			}
+		}
+	for(jj=0; jj<m; jj++)
+		for(ii=0; ii<m; ii++)
+			{
+			tmp = 0.0;
+			for(ll=0; ll<m; ll++)
+				tmp += LD[ii+m*ll]*L[jj+m*ll];
+			M[ii+m*jj] = tmp;
+			}
+	// M <= P^T * M * P, undoing the interchanges in reverse order
+	for(ii=m-1; ii>=0; ii--)
+		{
+		kp = ipiv[ii]>=0 ? ipiv[ii] : -ipiv[ii]-1;
+		if(kp!=ii)
+			{
+			for(ll=0; ll<m; ll++)
+				{
+				tmp = M[ii+m*ll];
+				M[ii+m*ll] = M[kp+m*ll];
+				M[kp+m*ll] = tmp;
+				}
+			for(ll=0; ll<m; ll++)
+				{
+				tmp = M[ll+m*ii];
+				M[ll+m*ii] = M[ll+m*kp];
+				M[ll+m*kp] = tmp;
+				}
+			}
+		if(ipiv[ii]<0)
+			ii--;
+		}
+	err = 0.0;
+	nrm = 0.0;
+	for(jj=0; jj<m; jj++)
+		for(ii=jj; ii<m; ii++)
+			{
+			tmp = BLASFEO_DMATEL(sC, ci+ii, jj);
+			nrm = fabs(tmp)>nrm ? fabs(tmp) : nrm;
+			d = fabs(M[ii+m*jj] - tmp);
+			err = d>err ? d : err;
+			}
+	free(L);
+	free(LD);
+	free(M);
+	return nrm>0.0 ? err/nrm : err;
+	}
+
+
+
+// max | C * X - B | relative to max | C | * max | X |, with C symmetric from its lower triangular
+static double dsytrs_l_err(int m, int n, struct blasfeo_dmat *sC, int ci, struct blasfeo_dmat *sX, int xi, struct blasfeo_dmat *sB, int bi)
+	{
+	int ii, jj, ll;
+	double tmp, d, c, err = 0.0, nrm_c = 0.0, nrm_x = 0.0;
+	for(jj=0; jj<m; jj++)
+		for(ii=jj; ii<m; ii++)
+			{
+			c = fabs(BLASFEO_DMATEL(sC, ci+ii, jj));
+			nrm_c = c>nrm_c ? c : nrm_c;
+			}
+	for(jj=0; jj<n; jj++)
+		for(ii=0; ii<m; ii++)
+			{
+			c = fabs(BLASFEO_DMATEL(sX, xi+ii, jj));
+			nrm_x = c>nrm_x ? c : nrm_x;
+			}
+	for(jj=0; jj<n; jj++)
+		for(ii=0; ii<m; ii++)
+			{
+			tmp = 0.0;
+			for(ll=0; ll<m; ll++)
+				{
+				c = ll<=ii ? BLASFEO_DMATEL(sC, ci+ii, ll) : BLASFEO_DMATEL(sC, ci+ll, ii);
+				tmp += c*BLASFEO_DMATEL(sX, xi+ll, jj);
+				}
+			d = fabs(tmp - BLASFEO_DMATEL(sB, bi+ii, jj));
+			err = d>err ? d : err;
+			}
+	return err/(nrm_c*nrm_x);
+	}
+
+
+
+// lower triangular of a random symmetric matrix; type 0: dense, type 1: zero diagonal, that forces 2x2 pivots,
+// type 2: singular, with a zero row and column in the middle, type 3: singular, of rank 2, type 4: zero
+static void d_sytrf_matrix(int m, int type, struct blasfeo_dmat *sC, int ci)
+	{
+	int ii, jj;
+	double v, w;
+	for(jj=0; jj<m; jj++)
+		for(ii=jj; ii<m; ii++)
+			BLASFEO_DMATEL(sC, ci+ii, jj) = (double) rand() / RAND_MAX - 0.5;
+	if(type==1)
+		{
+		for(ii=0; ii<m; ii++)
+			BLASFEO_DMATEL(sC, ci+ii, ii) = 0.0;
+		}
+	else if(type==2)
+		{
+		for(jj=0; jj<m; jj++)
+			{
+			BLASFEO_DMATEL(sC, ci+m/2, jj) = 0.0;
+			BLASFEO_DMATEL(sC, ci+jj, m/2) = 0.0;
+			}
+		}
+	else if(type==3)
+		{
+		// C = v * v^T - w * w^T, with integer v and w
+		for(jj=0; jj<m; jj++)
+			for(ii=jj; ii<m; ii++)
+				{
+				v = (double) (ii%5) - 2.0;
+				w = (double) (jj%3) - 1.0;
+				BLASFEO_DMATEL(sC, ci+ii, jj) = v*((double) (jj%5) - 2.0) - w*((double) (ii%3) - 1.0);
+				}
+		}
+	else if(type==4)
+		{
+		for(jj=0; jj<m; jj++)
+			for(ii=jj; ii<m; ii++)
+				BLASFEO_DMATEL(sC, ci+ii, jj) = 0.0;
+		}
+	return;
+	}
+
+
+
+// lower triangular of a random quasi-definite matrix, with the first 2/3 of the diagonal positive and the rest negative;
+// type 1: singular, with a zero row and column in the middle
+static void d_sytrf_nopiv_matrix(int m, int type, struct blasfeo_dmat *sC, int ci)
+	{
+	int ii, jj;
+	int nv = (2*m+2)/3;
+	for(jj=0; jj<m; jj++)
+		{
+		BLASFEO_DMATEL(sC, ci+jj, jj) = jj<nv ? (double) m : - (double) m;
+		for(ii=jj+1; ii<m; ii++)
+			BLASFEO_DMATEL(sC, ci+ii, jj) = (double) rand() / RAND_MAX - 0.5;
+		}
+	if(type==1)
+		{
+		for(jj=0; jj<m; jj++)
+			{
+			BLASFEO_DMATEL(sC, ci+m/2, jj) = 0.0;
+			BLASFEO_DMATEL(sC, ci+jj, m/2) = 0.0;
+			}
+		}
+	return;
+	}
+
+
+
+int main()
+	{
+
+	int ii, jj, im, ic, id, type;
+
+	// sizes around the kernel blocks, and larger than the panel width of the blocked factorization
+	int m_list[NSIZE] = {1, 2, 3, 4, 5, 8, 13, 32, 33, 70};
+	// sizes around the 12x4 and 4x4 kernels of the factorization without pivoting
+	int m_list_nopiv[NSIZE_NOPIV] = {1, 2, 3, 4, 5, 8, 9, 11, 12, 13, 23, 24, 25, 32, 33, 70};
+
+	int mmax = 70+NOFF;
+
+	struct blasfeo_dmat sC, sD, sB, sX;
+	blasfeo_allocate_dmat(mmax, mmax, &sC);
+	blasfeo_allocate_dmat(mmax, mmax, &sD);
+	blasfeo_allocate_dmat(mmax, NRHS, &sB);
+	blasfeo_allocate_dmat(mmax, NRHS, &sX);
+
+	int *ipiv = malloc(mmax*sizeof(int));
+
+	// the factorization allocates its work matrix from the workspace
+	void *work = malloc(blasfeo_memsize_workspace(mmax)+64);
+	blasfeo_init_workspace(mmax, (void *) (((size_t) work + 63) / 64 * 64));
+
+	char *type_name[5] = {"dense", "zero diagonal", "zero column", "rank 2", "zero"};
+
+	srand(1);
+
+	int n_test = 0;
+	int n_fail = 0;
+	int n_2x2, n_zero;
+	double err;
+
+	for(type=0; type<5; type++)
+		{
+		for(im=0; im<NSIZE; im++)
+			{
+			int m = m_list[im];
+			for(ic=0; ic<NOFF; ic++)
+				for(id=0; id<NOFF; id++)
+					{
+
+					d_sytrf_matrix(m, type, &sC, ic);
+
+					// factorization out of place, and in place for id==ic
+					if(id==ic)
+						{
+						blasfeo_dtrcp_l(m, &sC, ic, 0, &sD, id, 0);
+						blasfeo_dsytrf_l(m, &sD, id, 0, &sD, id, 0, ipiv);
+						}
+					else
+						{
+						blasfeo_dsytrf_l(m, &sC, ic, 0, &sD, id, 0, ipiv);
+						}
+
+					n_2x2 = 0;
+					n_zero = 0;
+					for(ii=0; ii<m; ii++)
+						{
+						if(ipiv[ii]<0)
+							{
+							n_2x2++;
+							ii++;
+							}
+						else if(BLASFEO_DMATEL(&sD, id+ii, ii)==0.0)
+							{
+							n_zero++;
+							}
+						}
+
+					err = dsytrf_l_err(m, &sC, ic, &sD, id, ipiv);
+					n_test++;
+					// the zero diagonal forces 2x2 pivots, the singular matrices zero 1x1 pivots
+					if(!(err>=0.0 & err<1e-12) | (type==1 & m>1 & n_2x2==0) | ((type==2 | type==4) & n_zero==0))
+						{
+						printf("dsytrf_l FAILED: %s m %d ci %d di %d err %e 2x2 pivots %d zero pivots %d\n", type_name[type], m, ic, id, err, n_2x2, n_zero);
+						n_fail++;
+						}
+
+					// the solution is checked on the non-singular matrices only
+					if(type==0 | (type==1 & m>1))
+						{
+						for(jj=0; jj<NRHS; jj++)
+							for(ii=0; ii<m; ii++)
+								BLASFEO_DMATEL(&sB, ic+ii, jj) = (double) rand() / RAND_MAX - 0.5;
+						// solution out of place, and in place for id==ic
+						if(id==ic)
+							{
+							blasfeo_dgecp(m, NRHS, &sB, ic, 0, &sX, id, 0);
+							blasfeo_dsytrs_l(m, NRHS, &sD, id, 0, ipiv, &sX, id, 0, &sX, id, 0);
+							}
+						else
+							{
+							blasfeo_dsytrs_l(m, NRHS, &sD, id, 0, ipiv, &sB, ic, 0, &sX, id, 0);
+							}
+						err = dsytrs_l_err(m, NRHS, &sC, ic, &sX, id, &sB, ic);
+						n_test++;
+						if(!(err<1e-12))
+							{
+							printf("dsytrs_l FAILED: %s m %d ci %d di %d err %e\n", type_name[type], m, ic, id, err);
+							n_fail++;
+							}
+						}
+
+					}
+			}
+		}
+
+	// without pivoting, the factors are checked with the identity permutation
+	for(ii=0; ii<mmax; ii++)
+		ipiv[ii] = ii;
+
+	for(type=0; type<2; type++)
+		{
+		for(im=0; im<NSIZE_NOPIV; im++)
+			{
+			int m = m_list_nopiv[im];
+			for(ic=0; ic<NOFF; ic++)
+				for(id=0; id<NOFF; id++)
+					{
+
+					d_sytrf_nopiv_matrix(m, type, &sC, ic);
+
+					// factorization out of place, and in place for id==ic
+					if(id==ic)
+						{
+						blasfeo_dtrcp_l(m, &sC, ic, 0, &sD, id, 0);
+						blasfeo_dsytrf_l_nopiv(m, &sD, id, 0, &sD, id, 0);
+						}
+					else
+						{
+						blasfeo_dsytrf_l_nopiv(m, &sC, ic, 0, &sD, id, 0);
+						}
+
+					n_zero = 0;
+					for(ii=0; ii<m; ii++)
+						if(BLASFEO_DMATEL(&sD, id+ii, ii)==0.0)
+							n_zero++;
+
+					err = dsytrf_l_err(m, &sC, ic, &sD, id, ipiv);
+					n_test++;
+					// the zero row and column give a zero pivot and a zero column of L
+					if(!(err>=0.0 & err<1e-12) | (type==1 & n_zero==0))
+						{
+						printf("dsytrf_l_nopiv FAILED: %s m %d ci %d di %d err %e zero pivots %d\n", type==0 ? "quasi-definite" : "zero column", m, ic, id, err, n_zero);
+						n_fail++;
+						}
+
+					if(type==0)
+						{
+						for(jj=0; jj<NRHS; jj++)
+							for(ii=0; ii<m; ii++)
+								BLASFEO_DMATEL(&sB, ic+ii, jj) = (double) rand() / RAND_MAX - 0.5;
+						if(id==ic)
+							{
+							blasfeo_dgecp(m, NRHS, &sB, ic, 0, &sX, id, 0);
+							blasfeo_dsytrs_l_nopiv(m, NRHS, &sD, id, 0, &sX, id, 0, &sX, id, 0);
+							}
+						else
+							{
+							blasfeo_dsytrs_l_nopiv(m, NRHS, &sD, id, 0, &sB, ic, 0, &sX, id, 0);
+							}
+						err = dsytrs_l_err(m, NRHS, &sC, ic, &sX, id, &sB, ic);
+						n_test++;
+						if(!(err<1e-12))
+							{
+							printf("dsytrs_l_nopiv FAILED: m %d ci %d di %d err %e\n", m, ic, id, err);
+							n_fail++;
+							}
+						}
+
+					}
+			}
+		}
+
+	if(blasfeo_get_workspace_error()!=0)
+		{
+		printf("workspace FAILED\n");
+		n_fail++;
+		}
+
+	printf("\ntest_d_sytrf: %d tests, %d failed\n\n", n_test, n_fail);
+
+	blasfeo_quit();
+	free(work);
+	free(ipiv);
+
+	blasfeo_free_dmat(&sC);
+	blasfeo_free_dmat(&sD);
+	blasfeo_free_dmat(&sB);
+	blasfeo_free_dmat(&sX);
+
+	return n_fail>0;
+
+	}
@@ -0,0 +1,310 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2019 by Gianluca Frison.                                                          *
+* Developed at IMTEK (University of Freiburg) under the supervision of Moritz Diehl.              *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+
+#include "../include/blasfeo_target.h"
+#include "../include/blasfeo_common.h"
+#include "../include/blasfeo_stdlib.h"
+#include "../include/blasfeo_memory.h"
+#include "../include/blasfeo_thread_pool.h"
+#include "../include/blasfeo_d_blas_api.h"
+
+
+
+#define NSIZE 5
+#define TOL 1e-10
+
+
+
+// fill the array with random values
+static void rand_dvec(int n, double *x)
+	{
+	int ii;
+	for(ii=0; ii<n; ii++)
+		x[ii] = (double) rand() / RAND_MAX - 0.5;
+	}
+
+
+
+// maximum absolute difference between the arrays
+static double diff_dvec(int n, double *x, double *y)
+	{
+	int ii;
+	double tmp, err = 0.0;
+	for(ii=0; ii<n; ii++)
+		{
+		tmp = fabs(x[ii] - y[ii]);
+		// also catches NaN
+		if(!(tmp<=err))
+			err = tmp;
+		}
+	return err;
+	}
+
+
+
+static void check(char *label, int n, int ws_err, double err, double tol, int *n_test, int *n_fail)
+	{
+	(*n_test)++;
+	if(!(err<=tol) | ws_err!=0)
+		{
+		(*n_fail)++;
+		printf("%s n=%d: error %e, workspace error %d\n", label, n, err, ws_err);
+		}
+	}
+
+
+
+int main()
+	{
+
+	// odd sizes around the kernel heights, plus sizes beyond the k-blocking
+	int sizes[NSIZE] = {1, 13, 61, 300, 700};
+
+	int n_fail = 0;
+	int n_test = 0;
+
+	int ii, is, n, nn, lda, incx, info, info_ref;
+	char c_n = 'n';
+	char c_t = 't';
+	char c_l = 'l';
+	char c_u = 'u';
+	double d_1 = 1.0;
+	double d_m1 = -1.0;
+	double d_05 = 0.5;
+	size_t size;
+	void *work;
+	double *A, *B, *C, *D, *x, *y, *y_ref;
+	int *ipiv, *ipiv_ref;
+	int err;
+
+	// the default path runs in a workspace as well, as required by the builds with NO_INTERNAL_MALLOC
+	void *ref_work;
+	blasfeo_malloc_align(&ref_work, blasfeo_memsize_workspace(sizes[NSIZE-1]));
+	blasfeo_init_workspace(sizes[NSIZE-1], ref_work);
+
+	// routines running in a workspace of the size returned by _worksize, compared with the default path
+	for(is=0; is<NSIZE; is++)
+		{
+		n = sizes[is];
+		nn = n*n;
+		lda = n;
+		incx = 2;
+
+		A = malloc(nn*sizeof(double));
+		B = malloc(nn*sizeof(double));
+		C = malloc(nn*sizeof(double));
+		D = malloc(nn*sizeof(double));
+		x = malloc(incx*n*sizeof(double));
+		y = malloc(incx*n*sizeof(double));
+		y_ref = malloc(incx*n*sizeof(double));
+		ipiv = malloc(n*sizeof(int));
+		ipiv_ref = malloc(n*sizeof(int));
+		rand_dvec(nn, A);
+		rand_dvec(nn, B);
+		rand_dvec(incx*n, x);
+		rand_dvec(incx*n, y);
+
+		// dgemm, with k beyond the k-blocking
+		size = blasfeo_blas_dgemm_worksize(&n, &n, &n);
+		blasfeo_malloc_align(&work, size);
+		for(ii=0; ii<nn; ii++)
+			C[ii] = D[ii] = B[ii];
+		blasfeo_blas_dgemm_ws(&c_t, &c_n, &n, &n, &n, &d_1, A, &lda, B, &lda, &d_05, C, &lda, work);
+		err = blasfeo_get_workspace_error();
+		blasfeo_blas_dgemm(&c_t, &c_n, &n, &n, &n, &d_1, A, &lda, B, &lda, &d_05, D, &lda);
+		check("dgemm_ws tn", n, err, diff_dvec(nn, C, D), TOL*n, &n_test, &n_fail);
+		blasfeo_free_align(work);
+
+		// dgemv and dsymv, with strided vectors (the BLAS 2 routines of the BLAS API are not built with LA=REFERENCE)
+#if ! defined(LA_REFERENCE)
+		size = blasfeo_blas_dgemv_worksize(&n, &n);
+		blasfeo_malloc_align(&work, size);
+		for(ii=0; ii<incx*n; ii++)
+			y_ref[ii] = y[ii];
+		blasfeo_blas_dgemv_ws(&c_t, &n, &n, &d_1, A, &lda, x, &incx, &d_05, y, &incx, work);
+		err = blasfeo_get_workspace_error();
+		blasfeo_blas_dgemv(&c_t, &n, &n, &d_1, A, &lda, x, &incx, &d_05, y_ref, &incx);
+		check("dgemv_ws t", n, err, diff_dvec(incx*n, y, y_ref), TOL*n, &n_test, &n_fail);
+		blasfeo_free_align(work);
+
+		size = blasfeo_blas_dsymv_worksize(&n);
+		blasfeo_malloc_align(&work, size);
+		blasfeo_blas_dsymv_ws(&c_l, &n, &d_1, A, &lda, x, &incx, &d_05, y, &incx, work);
+		err = blasfeo_get_workspace_error();
+		blasfeo_blas_dsymv(&c_l, &n, &d_1, A, &lda, x, &incx, &d_05, y_ref, &incx);
+		check("dsymv_ws l", n, err, diff_dvec(incx*n, y, y_ref), TOL*n, &n_test, &n_fail);
+		blasfeo_free_align(work);
+#endif
+
+		// dsyrk, building the positive definite matrix C = B^T * B + n * I
+		for(ii=0; ii<nn; ii++)
+			C[ii] = D[ii] = 0.0;
+		for(ii=0; ii<n; ii++)
+			C[ii*(n+1)] = D[ii*(n+1)] = n;
+		size = blasfeo_blas_dsyrk_worksize(&n, &n);
+		blasfeo_malloc_align(&work, size);
+		blasfeo_blas_dsyrk_ws(&c_l, &c_t, &n, &n, &d_1, B, &lda, &d_1, C, &lda, work);
+		err = blasfeo_get_workspace_error();
+		blasfeo_blas_dsyrk(&c_l, &c_t, &n, &n, &d_1, B, &lda, &d_1, D, &lda);
+		check("dsyrk_ws lt", n, err, diff_dvec(nn, C, D), TOL*n, &n_test, &n_fail);
+		blasfeo_free_align(work);
+
+		// dpotrf
+		size = blasfeo_lapack_dpotrf_worksize(&n);
+		blasfeo_malloc_align(&work, size);
+		blasfeo_lapack_dpotrf_ws(&c_l, &n, C, &lda, &info, work);
+		err = blasfeo_get_workspace_error();
+		blasfeo_lapack_dpotrf(&c_l, &n, D, &lda, &info_ref);
+		check("dpotrf_ws l", n, err, diff_dvec(nn, C, D) + (info!=info_ref), TOL*n, &n_test, &n_fail);
+		blasfeo_free_align(work);
+
+		// dtrsm with the factor
+		for(ii=0; ii<nn; ii++)
+			D[ii] = B[ii];
+		size = blasfeo_blas_dtrsm_worksize(&n, &n);
+		blasfeo_malloc_align(&work, size);
+		blasfeo_blas_dtrsm_ws(&c_l, &c_l, &c_n, &c_n, &n, &n, &d_m1, C, &lda, B, &lda, work);
+		err = blasfeo_get_workspace_error();
+		blasfeo_blas_dtrsm(&c_l, &c_l, &c_n, &c_n, &n, &n, &d_m1, C, &lda, D, &lda);
+		check("dtrsm_ws llnn", n, err, diff_dvec(nn, B, D), TOL*n, &n_test, &n_fail);
+		blasfeo_free_align(work);
+
+		// dgetrf
+		for(ii=0; ii<nn; ii++)
+			C[ii] = D[ii] = A[ii];
+		size = blasfeo_lapack_dgetrf_worksize(&n, &n);
+		blasfeo_malloc_align(&work, size);
+		blasfeo_lapack_dgetrf_ws(&n, &n, C, &lda, ipiv, &info, work);
+		err = blasfeo_get_workspace_error();
+		blasfeo_lapack_dgetrf(&n, &n, D, &lda, ipiv_ref, &info_ref);
+		for(ii=0; ii<n; ii++)
+			info += ipiv[ii]!=ipiv_ref[ii];
+		check("dgetrf_ws", n, err, diff_dvec(nn, C, D) + (info!=info_ref), TOL*n, &n_test, &n_fail);
+		blasfeo_free_align(work);
+
+		free(A);
+		free(B);
+		free(C);
+		free(D);
+		free(x);
+		free(y);
+		free(y_ref);
+		free(ipiv);
+		free(ipiv_ref);
+		}
+
+	// workspace bound for smaller dimensions: the routine either returns without computing and flags BLASFEO_WS_ERR_ALLOC (with NO_INTERNAL_MALLOC),
+	// or falls back to the heap and computes the right result
+	struct blasfeo_workspace_state state;
+	n = 300;
+	nn = n*n;
+	lda = n;
+	A = malloc(nn*sizeof(double));
+	C = malloc(nn*sizeof(double));
+	D = malloc(nn*sizeof(double));
+	rand_dvec(nn, A);
+	for(ii=0; ii<nn; ii++)
+		C[ii] = D[ii] = 0.0;
+	size = blasfeo_memsize_workspace(1);
+	blasfeo_malloc_align(&work, size);
+	blasfeo_workspace_push(1, work, &state);
+	blasfeo_blas_dgemm(&c_n, &c_t, &n, &n, &n, &d_1, A, &lda, A, &lda, &d_1, C, &lda);
+	err = blasfeo_get_workspace_error();
+	blasfeo_workspace_pop(&state);
+	blasfeo_blas_dgemm(&c_n, &c_t, &n, &n, &n, &d_1, A, &lda, A, &lda, &d_1, D, &lda);
+	n_test++;
+	if(err!=BLASFEO_WS_ERR_ALLOC & !(err==0 & diff_dvec(nn, C, D)<=TOL*n))
+		{
+		n_fail++;
+		printf("dgemm with too small workspace: workspace error %d\n", err);
+		}
+	blasfeo_free_align(work);
+
+	// out of order release of workspace blocks
+	void *ptr0, *ptr1;
+	size = blasfeo_memsize_workspace(16);
+	blasfeo_malloc_align(&work, size);
+	blasfeo_workspace_push(16, work, &state);
+	blasfeo_ws_malloc(&ptr0, 100);
+	blasfeo_ws_malloc(&ptr1, 100);
+	blasfeo_ws_free(ptr0);
+	err = blasfeo_get_workspace_error();
+	blasfeo_ws_free(ptr1);
+	blasfeo_ws_free(ptr0);
+	err |= blasfeo_get_workspace_error()<<4;
+	n_test++;
+	if(ptr0==NULL | ptr1==NULL | err!=BLASFEO_WS_ERR_FREE)
+		{
+		n_fail++;
+		printf("ws_free out of order: workspace error %d\n", err);
+		}
+	blasfeo_workspace_pop(&state);
+	blasfeo_free_align(work);
+
+	// workspaces of the thread pool workers (no-op if not MULTITHREAD)
+	int num_threads = 4;
+	void *pool_work;
+	blasfeo_set_num_threads(num_threads);
+	size = blasfeo_memsize_thread_pool_workspace(num_threads, n);
+	blasfeo_malloc_align(&pool_work, size>0 ? size : 64);
+	blasfeo_set_thread_pool_workspace(num_threads, n, pool_work);
+	for(ii=0; ii<nn; ii++)
+		C[ii] = D[ii] = 0.0;
+	blasfeo_blas_dgemm(&c_n, &c_t, &n, &n, &n, &d_1, A, &lda, A, &lda, &d_1, C, &lda);
+	err = blasfeo_get_workspace_error();
+	blasfeo_set_thread_pool_workspace(num_threads, n, NULL);
+	blasfeo_set_num_threads(1);
+	blasfeo_blas_dgemm(&c_n, &c_t, &n, &n, &n, &d_1, A, &lda, A, &lda, &d_1, D, &lda);
+	check("dgemm with thread pool workspaces", n, err, diff_dvec(nn, C, D), TOL*n, &n_test, &n_fail);
+	blasfeo_free_align(pool_work);
+
+	free(A);
+	free(C);
+	free(D);
+
+	blasfeo_quit();
+	blasfeo_free_align(ref_work);
+
+	printf("\n%d workspace tests, %d failed\n\n", n_test, n_fail);
+
+	return n_fail>0;
+
+	}
@@ -0,0 +1,255 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2019 by Gianluca Frison.                                                          *
+* Developed at IMTEK (University of Freiburg) under the supervision of Moritz Diehl.              *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+
+#include "../include/blasfeo_target.h"
+#include "../include/blasfeo_common.h"
+#include "../include/blasfeo_d_aux.h"
+#include "../include/blasfeo_d_aux_ext_dep.h"
+#include "../include/blasfeo_s_aux.h"
+#include "../include/blasfeo_s_aux_ext_dep.h"
+#include "../include/blasfeo_d_blasfeo_api.h"
+#include "../include/blasfeo_s_blasfeo_api.h"
+#include "../include/blasfeo_m_blasfeo_api.h"
+
+
+
+#define NSIZE 9
+#define NMIXED 5
+
+// targets on which the single-precision solution is used for large enough n
+#if defined(TARGET_X64_INTEL_HASWELL) | defined(TARGET_X64_INTEL_SANDY_BRIDGE)
+#define MIXED_USED 1
+#else
+#define MIXED_USED 0
+#endif
+
+
+
+// max | P A - L U | of the single-precision LU factorization with row pivoting of the m x n matrix A
+static double sgetrf_err(int m, int n, struct blasfeo_smat *sA, struct blasfeo_smat *sLU, int *ipiv)
+	{
+	int ii, jj, kk;
+	int p = m<n ? m : n;
+	double tmp, lu, err = 0.0;
+	// row permutation of A, as a list of row indices
+	int *perm = malloc(m*sizeof(int));
+	for(ii=0; ii<m; ii++)
+		perm[ii] = ii;
+	for(ii=0; ii<p; ii++)
+		{
+		kk = perm[ii];
+		perm[ii] = perm[ipiv[ii]];
+		perm[ipiv[ii]] = kk;
+		}
+	for(jj=0; jj<n; jj++)
+		{
+		for(ii=0; ii<m; ii++)
+			{
+			lu = 0.0;
+			for(kk=0; kk<=ii & kk<=jj & kk<p; kk++)
+				lu += (kk==ii ? 1.0 : (double) BLASFEO_SMATEL(sLU, ii, kk)) * BLASFEO_SMATEL(sLU, kk, jj);
+			tmp = fabs(BLASFEO_SMATEL(sA, perm[ii], jj) - lu);
+			// also catches NaN
+			if(!(tmp<=err))
+				err = tmp;
+			}
+		}
+	free(perm);
+	return err;
+	}
+
+
+
+// || b - A x ||_inf / ( || A ||_inf || x ||_inf )
+static double dgesv_err(int n, struct blasfeo_dmat *sA, struct blasfeo_dvec *sb, struct blasfeo_dvec *sx)
+	{
+	int ii, jj;
+	double tmp, a_nrm = 0.0, r_nrm = 0.0, x_nrm = 0.0;
+	for(ii=0; ii<n; ii++)
+		{
+		tmp = 0.0;
+		for(jj=0; jj<n; jj++)
+			tmp += fabs(BLASFEO_DMATEL(sA, ii, jj));
+		a_nrm = tmp>a_nrm ? tmp : a_nrm;
+		tmp = BLASFEO_DVECEL(sb, ii);
+		for(jj=0; jj<n; jj++)
+			tmp -= BLASFEO_DMATEL(sA, ii, jj) * BLASFEO_DVECEL(sx, jj);
+		// also catches NaN
+		if(!(fabs(tmp)<=r_nrm))
+			r_nrm = fabs(tmp);
+		tmp = fabs(BLASFEO_DVECEL(sx, ii));
+		x_nrm = tmp>x_nrm ? tmp : x_nrm;
+		}
+	return r_nrm / (a_nrm * x_nrm);
+	}
+
+
+
+int main()
+	{
+
+	int size_list[NSIZE] = {1, 3, 4, 8, 13, 24, 37, 64, 100};
+	int mixed_list[NMIXED] = {5, 50, 200, 300, 400};
+
+	int ii, jj, im, in;
+	int m, n, iter, info;
+	double err;
+	int n_test = 0;
+	int n_fail = 0;
+
+	struct blasfeo_smat sA, sLU;
+	struct blasfeo_dmat dA, dA_ref, dB;
+	struct blasfeo_dvec db, dx;
+	int *ipiv;
+	void *work;
+
+	// sgetrf_rp, square, tall and wide matrices
+	int mmax = 100 + 100/2 + 1;
+	blasfeo_allocate_smat(mmax, mmax, &sA);
+	blasfeo_allocate_smat(mmax, mmax, &sLU);
+	ipiv = malloc(mmax*sizeof(int));
+	for(jj=0; jj<mmax; jj++)
+		for(ii=0; ii<mmax; ii++)
+			BLASFEO_SMATEL(&sA, ii, jj) = (float) rand() / RAND_MAX - 0.5;
+
+	for(im=0; im<NSIZE; im++)
+	for(in=-1; in<=1; in++)
+		{
+		m = size_list[im];
+		n = m + in*(m/2+1);
+		blasfeo_sgese(mmax, mmax, 0.0, &sLU, 0, 0);
+		blasfeo_sgetrf_rp(m, n, &sA, 0, 0, &sLU, 0, 0, ipiv);
+		n_test++;
+		err = sgetrf_err(m, n, &sA, &sLU, ipiv);
+		if(!(err<=1e-5*(m+n)))
+			{
+			printf("sgetrf_rp FAILED: m %d n %d err %e\n", m, n, err);
+			n_fail++;
+			}
+		}
+
+	blasfeo_free_smat(&sA);
+	blasfeo_free_smat(&sLU);
+	free(ipiv);
+
+	// dgesv_mixed and dposv_mixed, well conditioned matrices on both sides of the single-precision crossover
+	for(in=0; in<NMIXED; in++)
+		{
+		n = mixed_list[in];
+		blasfeo_allocate_dmat(n, n, &dA);
+		blasfeo_allocate_dmat(n, n, &dA_ref);
+		blasfeo_allocate_dmat(n, n, &dB);
+		blasfeo_allocate_dvec(n, &db);
+		blasfeo_allocate_dvec(n, &dx);
+		ipiv = malloc(n*sizeof(int));
+		work = malloc(blasfeo_dgesv_mixed_worksize(n)>blasfeo_dposv_mixed_worksize(n) ? blasfeo_dgesv_mixed_worksize(n) : blasfeo_dposv_mixed_worksize(n));
+		for(jj=0; jj<n; jj++)
+			{
+			for(ii=0; ii<n; ii++)
+				BLASFEO_DMATEL(&dB, ii, jj) = (double) rand() / RAND_MAX - 0.5;
+			BLASFEO_DVECEL(&db, jj) = (double) rand() / RAND_MAX - 0.5;
+			}
+
+		// non-symmetric
+		blasfeo_dgecp(n, n, &dB, 0, 0, &dA_ref, 0, 0);
+		blasfeo_ddiare(n, 0.5*n, &dA_ref, 0, 0);
+		blasfeo_dgecp(n, n, &dA_ref, 0, 0, &dA, 0, 0);
+		blasfeo_dgesv_mixed(n, &dA, 0, 0, &db, 0, &dx, 0, ipiv, &iter, &info, work);
+		n_test++;
+		err = dgesv_err(n, &dA_ref, &db, &dx);
+		if(!(err<=1e-14) | (MIXED_USED & n>=400 & info!=0))
+			{
+			printf("dgesv_mixed FAILED: n %d iter %d info %d err %e\n", n, iter, info, err);
+			n_fail++;
+			}
+
+		// too large for single precision: fall back to the double-precision LU
+		blasfeo_dgesc(n, n, 1e40, &dA_ref, 0, 0);
+		blasfeo_dgecp(n, n, &dA_ref, 0, 0, &dA, 0, 0);
+		blasfeo_dgesv_mixed(n, &dA, 0, 0, &db, 0, &dx, 0, ipiv, &iter, &info, work);
+		n_test++;
+		err = dgesv_err(n, &dA_ref, &db, &dx);
+		if(!(err<=1e-14) | info!=1)
+			{
+			printf("dgesv_mixed fallback FAILED: n %d iter %d info %d err %e\n", n, iter, info, err);
+			n_fail++;
+			}
+
+		// symmetric positive definite, A = B * B^T + n * I
+		blasfeo_dgemm_nt(n, n, n, 1.0, &dB, 0, 0, &dB, 0, 0, 0.0, &dA_ref, 0, 0, &dA_ref, 0, 0);
+		blasfeo_ddiare(n, (double) n, &dA_ref, 0, 0);
+		blasfeo_dgecp(n, n, &dA_ref, 0, 0, &dA, 0, 0);
+		blasfeo_dposv_mixed(n, &dA, 0, 0, &db, 0, &dx, 0, &iter, &info, work);
+		n_test++;
+		err = dgesv_err(n, &dA_ref, &db, &dx);
+		if(!(err<=1e-14) | (MIXED_USED & n>=400 & info!=0))
+			{
+			printf("dposv_mixed FAILED: n %d iter %d info %d err %e\n", n, iter, info, err);
+			n_fail++;
+			}
+
+		// positive definite in double but not in single precision: fall back to the double-precision Cholesky
+		for(jj=0; jj<n; jj++)
+			for(ii=0; ii<n; ii++)
+				BLASFEO_DMATEL(&dA_ref, ii, jj) = ii==jj ? 1.0 + 1e-10 : 1.0;
+		blasfeo_dgecp(n, n, &dA_ref, 0, 0, &dA, 0, 0);
+		blasfeo_dposv_mixed(n, &dA, 0, 0, &db, 0, &dx, 0, &iter, &info, work);
+		n_test++;
+		err = dgesv_err(n, &dA_ref, &db, &dx);
+		if(!(err<=1e-14) | info!=1)
+			{
+			printf("dposv_mixed fallback FAILED: n %d iter %d info %d err %e\n", n, iter, info, err);
+			n_fail++;
+			}
+
+		blasfeo_free_dmat(&dA);
+		blasfeo_free_dmat(&dA_ref);
+		blasfeo_free_dmat(&dB);
+		blasfeo_free_dvec(&db);
+		blasfeo_free_dvec(&dx);
+		free(ipiv);
+		free(work);
+		}
+
+	printf("\ntest_m_mixed: %d tests, %d failed\n\n", n_test, n_fail);
+
+	return n_fail>0;
+
+	}
@@ -0,0 +1,245 @@
+/**************************************************************************************************
+*                                                                                                 *
+* This file is part of BLASFEO.                                                                   *
+*                                                                                                 *
+* BLASFEO -- BLAS For Embedded Optimization.                                                      *
+* Copyright (C) 2019 by Gianluca Frison.                                                          *
+* Developed at IMTEK (University of Freiburg) under the supervision of Moritz Diehl.              *
+* All rights reserved.                                                                            *
+*                                                                                                 *
+* The 2-Clause BSD License                                                                        *
+*                                                                                                 *
+* Redistribution and use in source and binary forms, with or without                              *
+* modification, are permitted provided that the following conditions are met:                     *
+*                                                                                                 *
+* 1. Redistributions of source code must retain the above copyright notice, this                  *
+*    list of conditions and the following disclaimer.                                             *
+* 2. Redistributions in binary form must reproduce the above copyright notice,                    *
+*    this list of conditions and the following disclaimer in the documentation                    *
+*    and/or other materials provided with the distribution.                                       *
+*                                                                                                 *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND                 *
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED                   *
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE                          *
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR                 *
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES                  *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;                    *
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND                     *
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT                      *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS                   *
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                    *
+*                                                                                                 *
+* Author: Gianluca Frison, gianluca.frison (at) imtek.uni-freiburg.de                             *
+*                                                                                                 *
+**************************************************************************************************/
+
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+
+#include "../include/blasfeo_target.h"
+#include "../include/blasfeo_common.h"
+#include "../include/blasfeo_memory.h"
+#include "../include/blasfeo_z_aux.h"
+#include "../include/blasfeo_z_blasfeo_api.h"
+
+
+
+#define NSIZE 10
+
+
+
+// complex column-major matrices store (real, imaginary) pairs, with leading dimension in complex elements
+#define RE(A,lda,i,j) (A)[2*((i)+(lda)*(j))+0]
+#define IM(A,lda,i,j) (A)[2*((i)+(lda)*(j))+1]
+
+
+
+// max | A - L L^H | over the lower triangle, with L the lower triangle of the m x m matrix L
+static double zpotrf_err(int m, double *A, double *L)
+	{
+	int ii, jj, kk;
+	double tr, ti, err = 0.0;
+	for(jj=0; jj<m; jj++)
+		{
+		for(ii=jj; ii<m; ii++)
+			{
+			tr = RE(A, m, ii, jj);
+			ti = ii==jj ? 0.0 : IM(A, m, ii, jj);
+			for(kk=0; kk<=jj; kk++)
+				{
+				// l_ik * conj(l_jk)
+				tr -= RE(L, m, ii, kk)*RE(L, m, jj, kk) + IM(L, m, ii, kk)*IM(L, m, jj, kk);
+				ti -= IM(L, m, ii, kk)*RE(L, m, jj, kk) - RE(L, m, ii, kk)*IM(L, m, jj, kk);
+				}
+			tr = fabs(tr) + fabs(ti);
+			// also catches NaN
+			if(!(tr<=err))
+				err = tr;
+			}
+		}
+	return err;
+	}
+
+
+
+// max | P A - L U | of the LU factorization with row pivoting of the m x n matrix A
+static double zgetrf_err(int m, int n, double *A, double *LU, int *ipiv)
+	{
+	int ii, jj, kk;
+	int p = m<n ? m : n;
+	double tr, ti, lr, li, err = 0.0;
+	// row permutation of A, as a list of row indices
+	int *perm = malloc(m*sizeof(int));
+	for(ii=0; ii<m; ii++)
+		perm[ii] = ii;
+	for(ii=0; ii<p; ii++)
+		{
+		kk = perm[ii];
+		perm[ii] = perm[ipiv[ii]];
+		perm[ipiv[ii]] = kk;
+		}
+	for(jj=0; jj<n; jj++)
+		{
+		for(ii=0; ii<m; ii++)
+			{
+			tr = RE(A, m, perm[ii], jj);
+			ti = IM(A, m, perm[ii], jj);
+			for(kk=0; kk<=ii & kk<=jj & kk<p; kk++)
+				{
+				lr = kk==ii ? 1.0 : RE(LU, m, ii, kk);
+				li = kk==ii ? 0.0 : IM(LU, m, ii, kk);
+				tr -= lr*RE(LU, m, kk, jj) - li*IM(LU, m, kk, jj);
+				ti -= lr*IM(LU, m, kk, jj) + li*RE(LU, m, kk, jj);
+				}
+			tr = fabs(tr) + fabs(ti);
+			// also catches NaN
+			if(!(tr<=err))
+				err = tr;
+			}
+		}
+	free(perm);
+	return err;
+	}
+
+
+
+int main()
+	{
+
+	int ii, jj, kk, ll, m, n, off;
+	double err;
+
+	int size_list[NSIZE] = {1, 3, 4, 5, 7, 8, 12, 13, 21, 40};
+	int off_list[2] = {0, 3};
+
+	int mmax = 40 + 3;
+	int nmax = 40 + 4 + 3;
+
+	double *A = malloc(2*mmax*nmax*sizeof(double));
+	double *B = malloc(2*mmax*nmax*sizeof(double));
+	double *L = malloc(2*mmax*nmax*sizeof(double));
+	int *ipiv = malloc(mmax*sizeof(int));
+
+	struct blasfeo_zmat sA, sD;
+	void *mem_A = malloc(blasfeo_memsize_zmat(mmax, nmax)+64);
+	void *mem_D = malloc(blasfeo_memsize_zmat(mmax, nmax)+64);
+	blasfeo_create_zmat(mmax, nmax, &sA, (void *) (((size_t) mem_A + 63) / 64 * 64));
+	blasfeo_create_zmat(mmax, nmax, &sD, (void *) (((size_t) mem_D + 63) / 64 * 64));
+
+	// the factorizations of operands not aligned to a panel run on a copy in the workspace
+	void *work = malloc(blasfeo_memsize_workspace(2*nmax)+64);
+	blasfeo_init_workspace(2*nmax, (void *) (((size_t) work + 63) / 64 * 64));
+
+	int n_test = 0;
+	int n_fail = 0;
+
+	srand(1);
+
+	for(ll=0; ll<2; ll++)
+		{
+		off = off_list[ll];
+		for(kk=0; kk<NSIZE; kk++)
+			{
+
+			// cholesky: A = B B^H + m I , with the factor in place and out of place
+			m = size_list[kk];
+			for(ii=0; ii<2*m*m; ii++)
+				B[ii] = rand()/(double) RAND_MAX - 0.5;
+			for(jj=0; jj<m; jj++)
+				{
+				for(ii=0; ii<m; ii++)
+					{
+					RE(A, m, ii, jj) = ii==jj ? m : 0.0;
+					IM(A, m, ii, jj) = 0.0;
+					for(n=0; n<m; n++)
+						{
+						// b_in * conj(b_jn)
+						RE(A, m, ii, jj) += RE(B, m, ii, n)*RE(B, m, jj, n) + IM(B, m, ii, n)*IM(B, m, jj, n);
+						IM(A, m, ii, jj) += IM(B, m, ii, n)*RE(B, m, jj, n) - RE(B, m, ii, n)*IM(B, m, jj, n);
+						}
+					}
+				}
+			blasfeo_pack_zmat(m, m, A, m, &sA, off, off);
+			blasfeo_zpotrf_l(m, &sA, off, off, &sD, off, 1);
+			blasfeo_unpack_zmat(m, m, &sD, off, 1, L, m);
+			err = zpotrf_err(m, A, L);
+			n_test++;
+			if(!(err<1e-12*m*m))
+				{
+				printf("zpotrf_l FAILED: m %d off %d err %e\n", m, off, err);
+				n_fail++;
+				}
+			blasfeo_zpotrf_l(m, &sA, off, off, &sA, off, off);
+			blasfeo_unpack_zmat(m, m, &sA, off, off, L, m);
+			err = zpotrf_err(m, A, L);
+			n_test++;
+			if(!(err<1e-12*m*m))
+				{
+				printf("zpotrf_l in place FAILED: m %d off %d err %e\n", m, off, err);
+				n_fail++;
+				}
+
+			// LU: square, tall and wide matrices
+			for(jj=0; jj<3; jj++)
+				{
+				n = jj==0 ? m : jj==1 ? (m+1)/2 : m+4;
+				for(ii=0; ii<2*m*n; ii++)
+					A[ii] = rand()/(double) RAND_MAX - 0.5;
+				blasfeo_pack_zmat(m, n, A, m, &sA, off, 0);
+				blasfeo_zgetrf_rp(m, n, &sA, off, 0, &sD, off, 0, ipiv);
+				blasfeo_unpack_zmat(m, n, &sD, off, 0, L, m);
+				err = zgetrf_err(m, n, A, L, ipiv);
+				n_test++;
+				if(!(err<1e-12*m*n))
+					{
+					printf("zgetrf_rp FAILED: m %d n %d off %d err %e\n", m, n, off, err);
+					n_fail++;
+					}
+				}
+
+			}
+		}
+
+	n_test++;
+	if(blasfeo_get_workspace_error()!=0)
+		{
+		printf("workspace FAILED\n");
+		n_fail++;
+		}
+
+	printf("\ntest_z_lapack: %d tests, %d failed\n\n", n_test, n_fail);
+
+	free(A);
+	free(B);
+	free(L);
+	free(ipiv);
+	free(mem_A);
+	free(mem_D);
+	blasfeo_quit();
+	free(work);
+
+	return n_fail>0;
+
+	}